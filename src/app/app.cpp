@@ -48,7 +48,8 @@
 
 namespace
 {
-    constexpr std::size_t g_timeout_q_timer_ms = 16;
+    //! Systems poll their own clocks with a granularity of at least one second, the events do not wait for the frame.
+    constexpr std::chrono::milliseconds g_systems_frame_period{250};
 }
 
 namespace atomic_dex
@@ -183,9 +184,38 @@ namespace atomic_dex
     {
         SPDLOG_INFO("Launch the application");
         this->system_manager_.start();
-        auto* timer = new QTimer(this);
-        connect(timer, &QTimer::timeout, this, &application::tick);
-        timer->start(g_timeout_q_timer_ms);
+        m_loop_timer = new QTimer(this);
+        m_loop_timer->setSingleShot(true);
+        m_loop_timer->setTimerType(Qt::PreciseTimer);
+        connect(m_loop_timer, &QTimer::timeout, this, &application::run_scheduler);
+
+        m_portfolio_sink = m_scheduler.add_sink("portfolio", [this]() { process_portfolio_queue(); });
+        m_actions_sink   = m_scheduler.add_sink("actions", [this]() { process_actions_queue(); });
+        m_scheduler.add_timer("systems", g_systems_frame_period, [this]() { process_systems_frame(); });
+        m_scheduler.set_wake_handler([this]() { QMetaObject::invokeMethod(this, &application::run_scheduler, Qt::QueuedConnection); });
+
+        //! Events received before the launch are already queued.
+        m_scheduler.notify(m_portfolio_sink);
+        m_scheduler.notify(m_actions_sink);
+    }
+
+    void application::run_scheduler()
+    {
+        m_scheduler.run_due();
+        arm_loop_timer();
+    }
+
+    void application::arm_loop_timer()
+    {
+        const auto deadline = m_scheduler.next_deadline();
+        if (!deadline)
+        {
+            m_loop_timer->stop();
+            return;
+        }
+        const auto now   = event_loop_scheduler::t_clock::now();
+        const auto delay = *deadline <= now ? std::chrono::milliseconds::zero() : std::chrono::ceil<std::chrono::milliseconds>(*deadline - now);
+        m_loop_timer->start(static_cast<int>(delay.count()));
     }
 
     QString atomic_dex::application::get_mnemonic()
@@ -201,7 +231,7 @@ namespace atomic_dex
         return output;
     }
 
-    void application::tick()
+    void application::process_systems_frame()
     {
         this->process_one_frame();
         if (m_event_actions[events_action::need_a_full_refresh_of_mm2])
@@ -213,15 +243,22 @@ namespace atomic_dex
             connect_signals();
             m_event_actions[events_action::need_a_full_refresh_of_mm2] = false;
         }
+
+        //! Tickers enabled while mm2 was not running yet are kept until it runs.
+        if (get_mm2().is_mm2_running() && !m_portfolio_queue.empty())
+        {
+            m_scheduler.notify(m_portfolio_sink);
+        }
+    }
+
+    void application::process_portfolio_queue()
+    {
         auto& mm2 = get_mm2();
         if (mm2.is_mm2_running())
         {
-            std::vector<std::string> to_init;
-            while (not m_portfolio_queue.empty())
+            std::vector<std::string> to_init = m_portfolio_queue.drain();
+            for (auto&& ticker: to_init)
             {
-                const char* ticker_cstr = nullptr;
-                m_portfolio_queue.pop(ticker_cstr);
-                std::string ticker(ticker_cstr);
                 if (ticker == g_primary_dex_coin)
                 {
                     this->m_primary_coin_fully_enabled = true;
@@ -230,8 +267,6 @@ namespace atomic_dex
                 {
                     this->m_secondary_coin_fully_enabled = true;
                 }
-                to_init.push_back(ticker);
-                std::free((void*)ticker_cstr);
             }
 
             if (not to_init.empty())
@@ -254,7 +289,11 @@ namespace atomic_dex
                 }
             }
         }
+    }
 
+    void application::process_actions_queue()
+    {
+        auto& mm2 = get_mm2();
         system_manager_.get_system<trading_page>().process_action();
         while (not this->m_actions_queue.empty())
         {
@@ -380,18 +419,14 @@ namespace atomic_dex
         if (not m_event_actions[events_action::about_to_exit_app])
         {
             SPDLOG_DEBUG("on_coin_fully_initialized_event");
-#if !defined(_WIN32)
-            for (auto&& ticker: evt.tickers) { m_portfolio_queue.push(strdup(ticker.c_str())); }
-#else
-            for (auto&& ticker: evt.tickers) { m_portfolio_queue.push(_strdup(ticker.c_str())); }
-#endif
+            m_portfolio_queue.push_range(evt.tickers);
+            m_scheduler.notify(m_portfolio_sink);
         }
     }
 
     bool application::do_i_have_enough_funds(const QString& ticker, const QString& amount) const
     {
-        t_float_50 amount_f = safe_float(amount.toStdString());
-        return get_mm2().do_i_have_enough_funds(ticker.toStdString(), amount_f);
+        return get_mm2().do_i_have_enough_funds(ticker.toStdString(), amount.toStdString());
     }
 
     const mm2_service& application::get_mm2() const
@@ -430,12 +465,7 @@ namespace atomic_dex
             this->m_actions_queue.pop(act);
         }
 
-        while (not this->m_portfolio_queue.empty())
-        {
-            const char* ticker = nullptr;
-            m_portfolio_queue.pop(ticker);
-            free((void*)ticker);
-        }
+        m_portfolio_queue.clear();
 
         auto* addressbook_pg = get_addressbook_page();
         addressbook_pg->clear();
@@ -466,12 +496,14 @@ namespace atomic_dex
         dispatcher_.sink<coin_fully_initialized>().disconnect<&application::on_coin_fully_initialized_event>(*this);
         dispatcher_.sink<mm2_initialized>().disconnect<&application::on_mm2_initialized_event>(*this);
         dispatcher_.sink<process_swaps_and_orders_finished>().disconnect<&application::on_process_orders_and_swaps_finished_event>(*this);
+        dispatcher_.sink<process_orderbook_finished>().disconnect<&application::on_process_orderbook_finished_event>(*this);
 
         m_event_actions[events_action::need_a_full_refresh_of_mm2] = true;
 
         //! Resets wallet name.
         auto& wallet_manager = this->system_manager_.get_system<qt_wallet_manager>();
         wallet_manager.just_set_wallet_name("");
+        wallet_manager.close_transactions_notes();
 
         this->m_secondary_coin_fully_enabled = false;
         this->m_primary_coin_fully_enabled   = false;
@@ -490,6 +522,7 @@ namespace atomic_dex
         get_dispatcher().sink<coin_fully_initialized>().connect<&application::on_coin_fully_initialized_event>(*this);
         get_dispatcher().sink<mm2_initialized>().connect<&application::on_mm2_initialized_event>(*this);
         get_dispatcher().sink<process_swaps_and_orders_finished>().connect<&application::on_process_orders_and_swaps_finished_event>(*this);
+        get_dispatcher().sink<process_orderbook_finished>().connect<&application::on_process_orderbook_finished_event>(*this);
         // get_dispatcher().sink<process_swaps_finished>().connect<&application::on_process_swaps_finished_event>(*this);
     }
 
@@ -594,6 +627,17 @@ namespace atomic_dex
         {
             this->m_actions_queue.push(
                 evt.after_manual_reset ? action::post_process_orders_and_swaps_finished_reset : action::post_process_orders_and_swaps_finished);
+            m_scheduler.notify(m_actions_sink);
+        }
+    }
+
+    void
+    application::on_process_orderbook_finished_event([[maybe_unused]] const process_orderbook_finished& evt)
+    {
+        //! The trading page queued the action in its own listener, only the loop has to wake up.
+        if (not m_event_actions[events_action::about_to_exit_app])
+        {
+            m_scheduler.notify(m_actions_sink);
         }
     }
 
@@ -24,6 +24,7 @@
 #include <QQmlApplicationEngine>
 #include <QSize>
 #include <QStringList>
+#include <QTimer>
 #include <QTranslator>
 #include <QVariantMap>
 
@@ -49,6 +50,7 @@
 #include "atomicdex/services/mm2/mm2.service.hpp"
 #include "atomicdex/services/price/global.provider.hpp"
 #include "atomicdex/services/update/update.checker.service.hpp"
+#include "atomicdex/utilities/event.loop.scheduler.hpp"
 
 namespace ag = antara::gaming;
 
@@ -77,7 +79,11 @@ namespace atomic_dex
 
         //! Private function
         void connect_signals();
-        void tick();
+        void run_scheduler();
+        void arm_loop_timer();
+        void process_systems_frame();
+        void process_portfolio_queue();
+        void process_actions_queue();
 
         enum events_action
         {
@@ -88,14 +94,18 @@ namespace atomic_dex
 
         //! Private typedefs
         using t_actions_queue                       = boost::lockfree::queue<action>;
-        using t_portfolio_coins_to_initialize_queue = boost::lockfree::queue<const char*>;
+        using t_portfolio_coins_to_initialize_queue = event_queue<std::string>;
         using t_manager_model_registry              = std::unordered_map<std::string, QObject*>;
         using t_events_actions                      = std::array<std::atomic_bool, events_action::size>;
 
         //! Private members fields
         std::shared_ptr<QApplication>         m_app;
         t_actions_queue                       m_actions_queue{g_max_actions_size};
-        t_portfolio_coins_to_initialize_queue m_portfolio_queue{g_max_actions_size};
+        t_portfolio_coins_to_initialize_queue m_portfolio_queue;
+        event_loop_scheduler                  m_scheduler;
+        QTimer*                               m_loop_timer{nullptr};
+        event_loop_scheduler::t_id            m_portfolio_sink{};
+        event_loop_scheduler::t_id            m_actions_sink{};
         t_manager_model_registry              m_manager_models;
         t_events_actions                      m_event_actions{{false}};
         std::atomic_bool                      m_secondary_coin_fully_enabled{false};
@@ -117,6 +127,7 @@ namespace atomic_dex
         void on_coin_fully_initialized_event(const coin_fully_initialized&);
         void on_mm2_initialized_event(const mm2_initialized&);
         void on_process_orders_and_swaps_finished_event(const process_swaps_and_orders_finished&);
+        void on_process_orderbook_finished_event(const process_orderbook_finished&);
 
         mm2_service&                     get_mm2();
         [[nodiscard]] const mm2_service& get_mm2() const;
@@ -22,9 +22,6 @@
 #include "atomicdex/api/coinpaprika/coinpaprika.hpp"
 #include "atomicdex/utilities/global.utilities.hpp"
 
-//! Private
-#include "atomicdex/utilities/nlohmann.json.sax.private.cpp"
-
 namespace
 {
     //! Constants
@@ -53,9 +50,6 @@ namespace atomic_dex
         void
         from_json(const nlohmann::json& j, price_converter_answer& evt)
         {
-            // utils::details::my_json_sax sx;
-            // nlohmann::json::sax_parse(j.dump(), &sx);
-
             evt.base_currency_id         = j.at("base_currency_id").get<std::string>();
             evt.base_currency_name       = j.at("base_currency_name").get<std::string>();
             evt.base_price_last_updated  = j.at("base_price_last_updated").get<std::string>();
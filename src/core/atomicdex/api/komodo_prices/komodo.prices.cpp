@@ -45,30 +45,33 @@ namespace atomic_dex::komodo_prices::api
     void
     from_json(const nlohmann::json& j, provider& x)
     {
-        if (j == "binance")
-        {
-            x = provider::binance;
-        }
-        else if (j == "coingecko")
+        x = j.is_string() ? provider_from_string(j.get_ref<const std::string&>()) : provider::unknown;
+    }
+
+    provider
+    provider_from_string(std::string_view str) noexcept
+    {
+        if (str == "binance")
         {
-            x = provider::coingecko;
+            return provider::binance;
         }
-        else if (j == "coinpaprika")
+        if (str == "coingecko")
         {
-            x = provider::coinpaprika;
+            return provider::coingecko;
         }
-        else if (j == "forex")
+        if (str == "coinpaprika")
         {
-            x = provider::forex;
+            return provider::coinpaprika;
         }
-        else if (j == "nomics")
+        if (str == "forex")
         {
-            x = provider::nomics;
+            return provider::forex;
         }
-        else
+        if (str == "nomics")
         {
-            x = provider::unknown;
+            return provider::nomics;
         }
+        return provider::unknown;
     }
 } // namespace atomic_dex::komodo_prices::api
 
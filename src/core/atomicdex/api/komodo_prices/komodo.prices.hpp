@@ -34,6 +34,7 @@ namespace atomic_dex::komodo_prices::api
 
     void from_json(const nlohmann::json& j, komodo_ticker_infos& x);
     void from_json(const nlohmann::json& j, provider& x);
+    provider provider_from_string(std::string_view str) noexcept;
 
     using t_komodo_tickers_price_registry = std::unordered_map<std::string, komodo_ticker_infos>;
 } // namespace atomic_dex::komodo_prices::api
@@ -0,0 +1,329 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! Project Headers
+#include "atomicdex/api/mm2/mm2.batch.decoder.hpp"
+#include "atomicdex/utilities/nlohmann.json.sax.hpp"
+
+namespace
+{
+    using namespace mm2::api;
+    using atomic_dex::utils::t_json_record_paths;
+
+    enum class hot_rpc
+    {
+        none,
+        orderbook,
+        my_recent_swaps,
+        my_tx_history,
+        my_balance,
+        my_orders
+    };
+
+    hot_rpc
+    to_hot_rpc(const nlohmann::json& request)
+    {
+        if (!request.is_object() || !request.contains("method") || !request.at("method").is_string())
+        {
+            return hot_rpc::none;
+        }
+        const auto& method = request.at("method").get_ref<const std::string&>();
+        if (method == "orderbook")
+        {
+            return hot_rpc::orderbook;
+        }
+        if (method == "my_recent_swaps")
+        {
+            return hot_rpc::my_recent_swaps;
+        }
+        if (method == "my_tx_history")
+        {
+            return hot_rpc::my_tx_history;
+        }
+        if (method == "my_balance")
+        {
+            return hot_rpc::my_balance;
+        }
+        if (method == "my_orders")
+        {
+            return hot_rpc::my_orders;
+        }
+        return hot_rpc::none;
+    }
+
+    const t_json_record_paths*
+    record_paths(hot_rpc kind)
+    {
+        static const t_json_record_paths orderbook_paths{{"asks"}, {"bids"}};
+        static const t_json_record_paths swaps_paths{{"result", "swaps"}};
+        static const t_json_record_paths tx_paths{{"result", "transactions"}};
+        static const t_json_record_paths orders_paths{{"result", "maker_orders"}, {"result", "taker_orders"}};
+
+        switch (kind)
+        {
+        case hot_rpc::orderbook:
+            return &orderbook_paths;
+        case hot_rpc::my_recent_swaps:
+            return &swaps_paths;
+        case hot_rpc::my_tx_history:
+            return &tx_paths;
+        case hot_rpc::my_orders:
+            return &orders_paths;
+        default:
+            return nullptr;
+        }
+    }
+
+    //! Typed records of one batch element, filled while the body is streamed.
+    struct element_accumulator
+    {
+        hot_rpc                       kind{hot_rpc::none};
+        orderbook_columns             asks;
+        orderbook_columns             bids;
+        std::vector<order_swaps_data> swaps;
+        std::vector<transaction_data> transactions;
+        my_orders_answer              orders;
+    };
+
+    bool
+    is_error_answer(const nlohmann::json& answer)
+    {
+        return !answer.is_object() || answer.contains("error");
+    }
+
+    void
+    on_record(element_accumulator& acc, std::size_t path_idx, std::string key, nlohmann::json&& record)
+    {
+        switch (acc.kind)
+        {
+        case hot_rpc::orderbook:
+        {
+            (path_idx == 0 ? acc.asks : acc.bids).append(record);
+            break;
+        }
+        case hot_rpc::my_recent_swaps:
+        {
+            if (record.is_null())
+            {
+                SPDLOG_WARN("Current swap object is null - skipping");
+                break;
+            }
+            order_swaps_data contents;
+            from_json(record, contents);
+            acc.swaps.emplace_back(std::move(contents));
+            break;
+        }
+        case hot_rpc::my_tx_history:
+        {
+            transaction_data contents;
+            from_json(record, contents);
+            acc.transactions.emplace_back(std::move(contents));
+            break;
+        }
+        case hot_rpc::my_orders:
+            append_order_from_json(key, record, path_idx == 0, acc.orders);
+            break;
+        default:
+            break;
+        }
+    }
+
+    t_batch_answer_value
+    build_answer(element_accumulator& acc, nlohmann::json&& skeleton)
+    {
+        if (acc.kind == hot_rpc::none || is_error_answer(skeleton))
+        {
+            return std::move(skeleton);
+        }
+
+        switch (acc.kind)
+        {
+        case hot_rpc::orderbook:
+        {
+            orderbook_answer answer;
+            from_json(skeleton, answer);
+            answer.asks = std::move(acc.asks);
+            answer.bids = std::move(acc.bids);
+            finalize_orderbook_answer(answer);
+            answer.rpc_result_code = 200;
+            return answer;
+        }
+        case hot_rpc::my_recent_swaps:
+        {
+            my_recent_swaps_answer answer;
+            from_json(skeleton, answer);
+            if (answer.result.has_value())
+            {
+                answer.result->swaps = std::move(acc.swaps);
+                finalize_recent_swaps(answer.result.value());
+            }
+            answer.rpc_result_code = 200;
+            return answer;
+        }
+        case hot_rpc::my_tx_history:
+        {
+            tx_history_answer answer;
+            from_json(skeleton, answer);
+            if (answer.result.has_value())
+            {
+                answer.result->transactions = std::move(acc.transactions);
+            }
+            answer.rpc_result_code = 200;
+            return answer;
+        }
+        case hot_rpc::my_balance:
+        {
+            balance_answer answer;
+            from_json(skeleton, answer);
+            answer.rpc_result_code = 200;
+            return answer;
+        }
+        case hot_rpc::my_orders:
+        {
+            //! Orders were appended while streaming, the skeleton only carries the empty containers.
+            skeleton.at("result").at("maker_orders");
+            skeleton.at("result").at("taker_orders");
+            acc.orders.rpc_result_code = 200;
+            return std::move(acc.orders);
+        }
+        default:
+            return std::move(skeleton);
+        }
+    }
+
+    std::optional<batch_answer>
+    decode_streaming(const std::string& body, const nlohmann::json& batch_request)
+    {
+        std::vector<element_accumulator> accumulators(batch_request.is_array() ? batch_request.size() : 0);
+        for (std::size_t idx = 0; idx < accumulators.size(); ++idx) { accumulators[idx].kind = to_hot_rpc(batch_request[idx]); }
+
+        batch_answer out;
+        out.answers.reserve(accumulators.size());
+        try
+        {
+            atomic_dex::utils::json_batch_sax sax(
+                [&accumulators](std::size_t element_idx) { return element_idx < accumulators.size() ? record_paths(accumulators[element_idx].kind) : nullptr; },
+                [&accumulators](std::size_t element_idx, std::size_t path_idx, std::string key, nlohmann::json&& record)
+                {
+                    if (element_idx < accumulators.size())
+                    {
+                        on_record(accumulators[element_idx], path_idx, std::move(key), std::move(record));
+                    }
+                },
+                [&accumulators, &out](std::size_t element_idx, nlohmann::json&& skeleton)
+                {
+                    if (element_idx < accumulators.size())
+                    {
+                        out.answers.emplace_back(build_answer(accumulators[element_idx], std::move(skeleton)));
+                        accumulators[element_idx] = element_accumulator{.kind = accumulators[element_idx].kind};
+                    }
+                    else
+                    {
+                        out.answers.emplace_back(std::move(skeleton));
+                    }
+                });
+            if (!nlohmann::json::sax_parse(body, &sax))
+            {
+                SPDLOG_DEBUG("streaming decode of batch answer failed: {}, falling back to json dom", sax.error());
+                return std::nullopt;
+            }
+        }
+        catch (const std::exception& error)
+        {
+            SPDLOG_WARN("exception caught while streaming batch answer: {}, falling back to json dom", error.what());
+            return std::nullopt;
+        }
+        out.streamed = true;
+        return out;
+    }
+
+    batch_answer
+    decode_with_dom(const std::string& body, const nlohmann::json& batch_request)
+    {
+        batch_answer   out;
+        nlohmann::json answers;
+        try
+        {
+            answers = nlohmann::json::parse(body);
+        }
+        catch (const nlohmann::detail::parse_error& err)
+        {
+            SPDLOG_ERROR("exception caught {}, body: {}", err.what(), body);
+            out.error = body;
+            return out;
+        }
+
+        if (!answers.is_array())
+        {
+            out.error = answers.contains("error") ? answers.at("error").dump() : body;
+            return out;
+        }
+
+        out.answers.reserve(answers.size());
+        for (std::size_t idx = 0; idx < answers.size(); ++idx)
+        {
+            auto&         answer = answers[idx];
+            const hot_rpc kind   = idx < batch_request.size() ? to_hot_rpc(batch_request[idx]) : hot_rpc::none;
+            if (kind == hot_rpc::none || is_error_answer(answer))
+            {
+                out.answers.emplace_back(std::move(answer));
+                continue;
+            }
+            switch (kind)
+            {
+            case hot_rpc::orderbook:
+                out.answers.emplace_back(rpc_process_answer_batch<orderbook_answer>(answer, "orderbook"));
+                break;
+            case hot_rpc::my_recent_swaps:
+                out.answers.emplace_back(rpc_process_answer_batch<my_recent_swaps_answer>(answer, "my_recent_swaps"));
+                break;
+            case hot_rpc::my_tx_history:
+                out.answers.emplace_back(rpc_process_answer_batch<tx_history_answer>(answer, "my_tx_history"));
+                break;
+            case hot_rpc::my_balance:
+                out.answers.emplace_back(rpc_process_answer_batch<balance_answer>(answer, "my_balance"));
+                break;
+            case hot_rpc::my_orders:
+                out.answers.emplace_back(rpc_process_answer_batch<my_orders_answer>(answer, "my_orders"));
+                break;
+            default:
+                out.answers.emplace_back(std::move(answer));
+                break;
+            }
+        }
+        return out;
+    }
+} // namespace
+
+namespace mm2::api
+{
+    batch_answer
+    decode_batch_answer(const std::string& body, const nlohmann::json& batch_request)
+    {
+        if (auto streamed = decode_streaming(body, batch_request); streamed.has_value())
+        {
+            return std::move(streamed.value());
+        }
+        return decode_with_dom(body, batch_request);
+    }
+
+    batch_answer
+    decode_batch_answer(const web::http::http_response& resp, const nlohmann::json& batch_request)
+    {
+        const std::string body = TO_STD_STR(resp.extract_string(true).get());
+        return decode_batch_answer(body, batch_request);
+    }
+} // namespace mm2::api
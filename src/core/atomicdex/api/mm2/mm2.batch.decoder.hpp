@@ -0,0 +1,50 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <optional>
+#include <variant>
+#include <vector>
+
+//! Deps
+#include <nlohmann/json.hpp>
+
+//! Project Headers
+#include "atomicdex/api/mm2/mm2.hpp"
+#include "atomicdex/api/mm2/rpc.balance.hpp"
+#include "atomicdex/api/mm2/rpc.orderbook.hpp"
+#include "atomicdex/api/mm2/rpc.tx.history.hpp"
+
+namespace mm2::api
+{
+    //! Rpc answers decoded into typed structs, any other rpc (or an error answer) stays a json value.
+    using t_batch_answer_value = std::variant<nlohmann::json, orderbook_answer, my_recent_swaps_answer, tx_history_answer, balance_answer, my_orders_answer>;
+
+    struct batch_answer
+    {
+        std::vector<t_batch_answer_value> answers;
+        std::optional<std::string>        error; ///< the whole batch failed (mm2 error object or invalid body)
+        bool                              streamed{false};
+    };
+
+    //! Decodes a batch answer in a single pass over the body, `batch_request` is the batch that was sent and gives the rpc of each answer.
+    //! The hot rpcs (orderbook, my_recent_swaps, my_tx_history, my_balance, my_orders) are built record by record without a full json dom,
+    //! if the streaming pass fails the body is decoded through the regular json dom path.
+    batch_answer decode_batch_answer(const std::string& body, const nlohmann::json& batch_request);
+    batch_answer decode_batch_answer(const web::http::http_response& resp, const nlohmann::json& batch_request);
+} // namespace mm2::api
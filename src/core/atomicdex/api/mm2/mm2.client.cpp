@@ -29,14 +29,6 @@ namespace
     template <typename T>
     using have_error_field = decltype(std::declval<T&>().error.has_value());
 
-    t_http_client generate_client()
-    {
-        web::http::client::http_client_config cfg;
-        using namespace std::chrono_literals;
-        cfg.set_timeout(30s);
-        return web::http::client::http_client(FROM_STD_STR(::mm2::api::g_endpoint), cfg);
-    }
-
     template <mm2::api::rpc Rpc>
     web::http::http_request make_request(typename Rpc::expected_request_type data_req = {})
     {
@@ -71,6 +63,10 @@ namespace
 
 namespace atomic_dex
 {
+    mm2_client::mm2_client() : m_pool(::mm2::api::g_endpoint)
+    {
+    }
+
     template <typename RpcReturnType>
     RpcReturnType
     mm2_client::rpc_process_answer(const web::http::http_response& resp, const std::string& rpc_command)
@@ -131,16 +127,23 @@ namespace atomic_dex
         web::http::http_request request;
         request.set_method(web::http::methods::POST);
         request.set_body(batch_array.dump());
-        auto resp = generate_client().request(request, m_token_source.get_token());
-        return resp;
+        return m_pool.request(std::move(request), m_token_source.get_token());
+    }
+
+    pplx::task<web::http::http_response>
+    mm2_client::async_rpc_batch_standalone(nlohmann::json batch_array, pplx::cancellation_token token)
+    {
+        web::http::http_request request;
+        request.set_method(web::http::methods::POST);
+        request.set_body(batch_array.dump());
+        return m_pool.request(std::move(request), std::move(token));
     }
 
     template <::mm2::api::rpc ApiCallType>
     void mm2_client::process_rpc_async(const std::function<void(typename ApiCallType::expected_answer_type)>& on_rpc_processed)
     {
         auto request = make_request<ApiCallType>();
-        generate_client()
-            .request(request, m_token_source.get_token())
+        m_pool.request(std::move(request), m_token_source.get_token())
             .template then([on_rpc_processed](const web::http::http_response& resp)
                            {
                                try
@@ -161,6 +164,13 @@ namespace atomic_dex
     mm2_client::stop()
     {
         m_token_source.cancel();
+        m_pool.cancel_pending();
+    }
+
+    mm2_client_pool_metrics
+    mm2_client::get_pool_metrics() const
+    {
+        return m_pool.get_metrics();
     }
 
     template <typename TRequest, typename TAnswer>
@@ -180,7 +190,7 @@ namespace atomic_dex
         web::http::http_request rpc_request(web::http::methods::POST);
         rpc_request.headers().set_content_type(FROM_STD_STR("application/json"));
         rpc_request.set_body(json_data.dump());
-        auto resp = generate_client().request(rpc_request).get();
+        auto resp = m_pool.request(std::move(rpc_request), m_token_source.get_token()).get();
         return rpc_process_answer<TAnswer>(resp, rpc_command);
     }
 
@@ -7,6 +7,7 @@
 #include <entt/core/attribute.h>
 
 // Project Headers
+#include "atomicdex/api/mm2/mm2.client.pool.hpp"
 #include "atomicdex/utilities/cpprestsdk.utilities.hpp"
 #include "rpc.disable.hpp"
 #include "rpc.recover.funds.hpp"
@@ -17,16 +18,22 @@ namespace atomic_dex
     class ENTT_API mm2_client
     {
         pplx::cancellation_token_source m_token_source;
+        mm2_client_pool                 m_pool;
 
       public:
-        mm2_client()  = default;
+        mm2_client();
         ~mm2_client() = default;
 
         //! Create the client
         void stop();
 
+        //! Connection pool metrics (hits, misses, wait time)
+        [[nodiscard]] mm2_client_pool_metrics get_pool_metrics() const;
+
         //! API
         pplx::task<web::http::http_response> async_rpc_batch_standalone(nlohmann::json batch_array);
+        //! Same as above, cancelled as well by `token` (ex: a request superseded by a newer one)
+        pplx::task<web::http::http_response> async_rpc_batch_standalone(nlohmann::json batch_array, pplx::cancellation_token token);
 
         template <mm2::api::rpc Rpc>
         void process_rpc_async(const std::function<void(typename Rpc::expected_answer_type)>& on_rpc_processed);
@@ -0,0 +1,353 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+// Std Headers
+#include <algorithm>
+#include <optional>
+
+// Project Headers
+#include "atomicdex/api/mm2/mm2.client.pool.hpp"
+
+namespace atomic_dex
+{
+    struct mm2_client_pool::state
+    {
+        using t_clock = std::chrono::steady_clock;
+
+        struct waiter
+        {
+            std::size_t                                          id;
+            pplx::task_completion_event<t_client_lease>          tce;
+            pplx::cancellation_token                             token;
+            t_clock::time_point                                  enqueued_at;
+            t_clock::time_point                                  deadline;
+            std::optional<pplx::cancellation_token_registration> registration; ///< fails the waiter as soon as the token is cancelled
+
+            //! Must be called without the mutex, the token callback may be running and waiting for it.
+            void
+            forget_token()
+            {
+                if (registration.has_value())
+                {
+                    token.deregister_callback(*registration);
+                    registration.reset();
+                }
+            }
+        };
+
+        std::string                                 endpoint;
+        std::size_t                                 capacity;
+        web::http::client::http_client_config       cfg;
+        retry_scheduler*                            timers;
+        mutable std::mutex                          mutex;
+        std::vector<std::unique_ptr<t_http_client>> idle;
+        std::deque<waiter>                          waiters;
+        std::size_t                                 nb_created{0};
+        std::size_t                                 next_waiter_id{0};
+
+        //! Must be called with the mutex held.
+        std::deque<waiter>::iterator
+        find_waiter(std::size_t waiter_id)
+        {
+            return std::find_if(waiters.begin(), waiters.end(), [waiter_id](const waiter& cur) { return cur.id == waiter_id; });
+        }
+
+        //! Metrics
+        std::atomic_size_t  hits{0};
+        std::atomic_size_t  misses{0};
+        std::atomic_size_t  waits{0};
+        std::atomic_size_t  timeouts{0};
+        std::atomic_size_t  in_flight{0};
+        std::atomic_int64_t total_wait_us{0};
+    };
+
+    mm2_client_pool::mm2_client_pool(std::string endpoint, std::size_t capacity, std::chrono::seconds timeout, retry_scheduler& timers) :
+        m_state(std::make_shared<state>())
+    {
+        m_state->endpoint = std::move(endpoint);
+        m_state->capacity = std::max<std::size_t>(capacity, 1);
+        m_state->timers   = &timers;
+        m_state->cfg.set_timeout(timeout);
+        m_state->idle.reserve(m_state->capacity);
+    }
+
+    mm2_client_pool::~mm2_client_pool()
+    {
+        cancel_pending();
+    }
+
+    void
+    mm2_client_pool::fail_waiter(const std::weak_ptr<state>& weak_state, std::size_t waiter_id, bool cancelled)
+    {
+        auto pool_state = weak_state.lock();
+        if (!pool_state)
+        {
+            return;
+        }
+
+        std::optional<state::waiter> current;
+        {
+            std::scoped_lock lock(pool_state->mutex);
+            auto             it = pool_state->find_waiter(waiter_id);
+            if (it == pool_state->waiters.end())
+            {
+                //! Already served or failed
+                return;
+            }
+            current = std::move(*it);
+            pool_state->waiters.erase(it);
+        }
+
+        if (cancelled)
+        {
+            //! Called from the token callback, which cannot deregister itself
+            current->tce.set_exception(pplx::task_canceled());
+            return;
+        }
+        current->forget_token();
+        pool_state->timeouts += 1;
+        current->tce.set_exception(web::http::http_exception("mm2 client pool: deadline exceeded while waiting for a connection"));
+    }
+
+    mm2_client_pool::t_client_lease
+    mm2_client_pool::make_lease(const std::shared_ptr<state>& pool_state, std::unique_ptr<t_http_client> client)
+    {
+        pool_state->in_flight += 1;
+        return t_client_lease(client.release(), [weak_state = std::weak_ptr<state>(pool_state)](t_http_client* ptr) { release(weak_state, ptr); });
+    }
+
+    void
+    mm2_client_pool::release(const std::weak_ptr<state>& weak_state, t_http_client* client)
+    {
+        std::unique_ptr<t_http_client> owned(client);
+        auto                           pool_state = weak_state.lock();
+        if (!pool_state)
+        {
+            return;
+        }
+        pool_state->in_flight -= 1;
+
+        std::vector<state::waiter>   expired;
+        std::optional<state::waiter> next;
+        const auto                   now = state::t_clock::now();
+        {
+            std::scoped_lock lock(pool_state->mutex);
+            while (!pool_state->waiters.empty())
+            {
+                auto current = std::move(pool_state->waiters.front());
+                pool_state->waiters.pop_front();
+                if (current.token.is_canceled() || now > current.deadline)
+                {
+                    expired.push_back(std::move(current));
+                    continue;
+                }
+                next = std::move(current);
+                break;
+            }
+            if (!next)
+            {
+                pool_state->idle.push_back(std::move(owned));
+            }
+        }
+
+        for (auto&& cur: expired)
+        {
+            cur.forget_token();
+            if (cur.token.is_canceled())
+            {
+                cur.tce.set_exception(pplx::task_canceled());
+            }
+            else
+            {
+                pool_state->timeouts += 1;
+                cur.tce.set_exception(web::http::http_exception("mm2 client pool: deadline exceeded while waiting for a connection"));
+            }
+        }
+
+        if (next)
+        {
+            next->forget_token();
+            pool_state->hits += 1;
+            pool_state->total_wait_us += std::chrono::duration_cast<std::chrono::microseconds>(now - next->enqueued_at).count();
+            next->tce.set(make_lease(pool_state, std::move(owned)));
+        }
+    }
+
+    pplx::task<mm2_client_pool::t_client_lease>
+    mm2_client_pool::acquire(pplx::cancellation_token token, std::chrono::milliseconds deadline)
+    {
+        if (token.is_canceled())
+        {
+            return pplx::task_from_exception<t_client_lease>(pplx::task_canceled());
+        }
+
+        std::unique_ptr<t_http_client>            client;
+        std::optional<pplx::task<t_client_lease>> queued;
+        std::size_t                               waiter_id = 0;
+        {
+            std::scoped_lock lock(m_state->mutex);
+            if (!m_state->idle.empty())
+            {
+                client = std::move(m_state->idle.back());
+                m_state->idle.pop_back();
+                m_state->hits += 1;
+            }
+            else if (m_state->nb_created < m_state->capacity)
+            {
+                m_state->nb_created += 1;
+                m_state->misses += 1;
+            }
+            else
+            {
+                const auto    now = state::t_clock::now();
+                state::waiter current{.id = m_state->next_waiter_id++, .token = token, .enqueued_at = now, .deadline = now + deadline};
+                waiter_id = current.id;
+                queued    = pplx::create_task(current.tce);
+                m_state->waiters.push_back(std::move(current));
+                m_state->waits += 1;
+            }
+        }
+
+        if (queued.has_value())
+        {
+            //! Registered without the mutex: the callback runs right away if the token was cancelled meanwhile.
+            std::weak_ptr<state> weak_state = m_state;
+            m_state->timers->schedule_after(deadline, [weak_state, waiter_id]() { fail_waiter(weak_state, waiter_id, false); });
+            if (token.is_cancelable())
+            {
+                auto registration = token.register_callback([weak_state, waiter_id]() { fail_waiter(weak_state, waiter_id, true); });
+                std::unique_lock lock(m_state->mutex);
+                auto             it = m_state->find_waiter(waiter_id);
+                if (it != m_state->waiters.end())
+                {
+                    it->registration = registration;
+                }
+                else
+                {
+                    //! Served or failed in between
+                    lock.unlock();
+                    token.deregister_callback(registration);
+                }
+            }
+            return *queued;
+        }
+
+        if (!client)
+        {
+            client = std::make_unique<t_http_client>(FROM_STD_STR(m_state->endpoint), m_state->cfg);
+        }
+        return pplx::task_from_result(make_lease(m_state, std::move(client)));
+    }
+
+    pplx::task<web::http::http_response>
+    mm2_client_pool::request(web::http::http_request request, pplx::cancellation_token token, std::chrono::milliseconds deadline)
+    {
+        const auto expires_at = state::t_clock::now() + deadline;
+        return acquire(token, deadline)
+            .then(
+                [request = std::move(request), token, expires_at, weak_state = std::weak_ptr<state>(m_state)](t_client_lease lease) mutable
+                {
+                    auto pool_state = weak_state.lock();
+                    if (!pool_state)
+                    {
+                        throw pplx::task_canceled();
+                    }
+
+                    //! The rest of the deadline cancels the request itself, as does the owner token
+                    pplx::cancellation_token_source request_source;
+                    auto                            expired      = std::make_shared<std::atomic_bool>(false);
+                    auto                            registration = std::make_shared<std::optional<pplx::cancellation_token_registration>>();
+                    if (token.is_cancelable())
+                    {
+                        *registration = token.register_callback([request_source]() { request_source.cancel(); });
+                    }
+                    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(expires_at - state::t_clock::now());
+                    pool_state->timers->schedule_after(
+                        std::max(remaining, std::chrono::milliseconds(1)),
+                        [request_source, expired]()
+                        {
+                            *expired = true;
+                            request_source.cancel();
+                        });
+
+                    //! The lease is captured by the continuation, it is released once the response is received or the request failed.
+                    return lease->request(request, request_source.get_token())
+                        .then(
+                            [lease, token, expired, registration, weak_state](pplx::task<web::http::http_response> previous_task) mutable
+                            {
+                                if (registration->has_value())
+                                {
+                                    token.deregister_callback(**registration);
+                                }
+                                try
+                                {
+                                    return previous_task.get();
+                                }
+                                catch (...)
+                                {
+                                    //! cpprestsdk fails a cancelled request with task_canceled or an http_exception depending on its progress
+                                    if (!*expired || token.is_canceled())
+                                    {
+                                        throw;
+                                    }
+                                    if (auto current_state = weak_state.lock())
+                                    {
+                                        current_state->timeouts += 1;
+                                    }
+                                    throw web::http::http_exception("mm2 client pool: deadline exceeded during the request");
+                                }
+                            });
+                });
+    }
+
+    void
+    mm2_client_pool::cancel_pending()
+    {
+        std::deque<state::waiter> waiters;
+        {
+            std::scoped_lock lock(m_state->mutex);
+            waiters.swap(m_state->waiters);
+        }
+        for (auto&& cur: waiters)
+        {
+            cur.forget_token();
+            cur.tce.set_exception(pplx::task_canceled());
+        }
+    }
+
+    mm2_client_pool_metrics
+    mm2_client_pool::get_metrics() const
+    {
+        mm2_client_pool_metrics out{
+            .hits            = m_state->hits.load(),
+            .misses          = m_state->misses.load(),
+            .waits           = m_state->waits.load(),
+            .timeouts        = m_state->timeouts.load(),
+            .in_flight       = m_state->in_flight.load(),
+            .total_wait_time = std::chrono::microseconds(m_state->total_wait_us.load())};
+        {
+            std::scoped_lock lock(m_state->mutex);
+            out.queued = m_state->waiters.size();
+        }
+        return out;
+    }
+
+    std::size_t
+    mm2_client_pool::capacity() const
+    {
+        return m_state->capacity;
+    }
+} // namespace atomic_dex
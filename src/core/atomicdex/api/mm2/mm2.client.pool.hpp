@@ -0,0 +1,93 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+// Std Headers
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Deps Headers
+#include <entt/core/attribute.h>
+
+// Project Headers
+#include "atomicdex/utilities/cpprestsdk.utilities.hpp"
+#include "atomicdex/utilities/http.retry.hpp"
+
+namespace atomic_dex
+{
+    //! Constants
+    inline constexpr std::size_t               g_mm2_client_pool_capacity{16};
+    inline constexpr std::chrono::seconds      g_mm2_client_timeout{30};
+    inline constexpr std::chrono::milliseconds g_mm2_client_default_deadline{30000};
+
+    struct mm2_client_pool_metrics
+    {
+        std::size_t               hits{0};     ///< request served by an already opened client
+        std::size_t               misses{0};   ///< request that had to open a new client
+        std::size_t               waits{0};    ///< request queued because every client was busy
+        std::size_t               timeouts{0}; ///< request whose deadline expired, queued or in flight
+        std::size_t               in_flight{0};
+        std::size_t               queued{0};
+        std::chrono::microseconds total_wait_time{0};
+    };
+
+    //! Long-lived, bounded set of http clients to a single endpoint.
+    //! cpprestsdk keeps the keep-alive connections per http_client instance, reusing the instances is what reuses the sockets.
+    class ENTT_API mm2_client_pool
+    {
+      public:
+        using t_client_lease = std::shared_ptr<t_http_client>;
+
+        //! The deadlines are timers of `timers`, the pool does not own a thread.
+        explicit mm2_client_pool(
+            std::string endpoint, std::size_t capacity = g_mm2_client_pool_capacity, std::chrono::seconds timeout = g_mm2_client_timeout,
+            retry_scheduler& timers = get_http_retry_scheduler());
+        ~mm2_client_pool();
+
+        mm2_client_pool(const mm2_client_pool& other) = delete;
+        mm2_client_pool& operator=(const mm2_client_pool& other) = delete;
+
+        //! Lease a client, the client goes back to the pool once every copy of the lease is destroyed.
+        //! If the pool is exhausted the lease is queued until a client is released, the deadline or the token expire.
+        //! A queued lease fails as soon as its token is cancelled or its deadline expires, even when no client is ever released.
+        pplx::task<t_client_lease> acquire(pplx::cancellation_token token, std::chrono::milliseconds deadline = g_mm2_client_default_deadline);
+
+        //! Send a request through a leased client, the lease is held until the response headers are received.
+        //! The deadline covers the whole request: the wait for a lease then the request, which is cancelled once it expires.
+        pplx::task<web::http::http_response>
+        request(web::http::http_request request, pplx::cancellation_token token, std::chrono::milliseconds deadline = g_mm2_client_default_deadline);
+
+        //! Fail every queued lease, called when the owner stops.
+        void cancel_pending();
+
+        [[nodiscard]] mm2_client_pool_metrics get_metrics() const;
+        [[nodiscard]] std::size_t             capacity() const;
+
+      private:
+        struct state;
+
+        static t_client_lease make_lease(const std::shared_ptr<state>& pool_state, std::unique_ptr<t_http_client> client);
+        static void           release(const std::weak_ptr<state>& weak_state, t_http_client* client);
+        static void           fail_waiter(const std::weak_ptr<state>& weak_state, std::size_t waiter_id, bool cancelled);
+
+        std::shared_ptr<state> m_state;
+    };
+} // namespace atomic_dex
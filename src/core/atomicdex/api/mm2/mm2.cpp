@@ -19,11 +19,13 @@
 
 //! Project Headers
 #include "atomicdex/api/mm2/mm2.hpp"
+#include "atomicdex/api/mm2/rpc.balance.hpp"
 #include "atomicdex/api/mm2/rpc.best.orders.hpp"
 #include "atomicdex/api/mm2/rpc.convertaddress.hpp"
 #include "atomicdex/api/mm2/rpc.min.volume.hpp"
 #include "atomicdex/api/mm2/rpc.orderbook.hpp"
 #include "atomicdex/api/mm2/rpc.trade.preimage.hpp"
+#include "atomicdex/api/mm2/rpc.tx.history.hpp"
 #include "atomicdex/api/mm2/rpc.validate.address.hpp"
 #include "atomicdex/api/mm2/rpc.withdraw.hpp"
 #include "atomicdex/api/mm2/rpc.recover.funds.hpp"
@@ -253,65 +255,65 @@ namespace mm2::api
     }
 
     void
-    from_json(const nlohmann::json& j, my_orders_answer& answer)
+    append_order_from_json(const std::string& key, const nlohmann::json& value, bool is_maker, my_orders_answer& answer)
     {
-        // answer.orders.reserve(j.at("result").at("maker_orders").size() + j.at("result").at("taker_orders").size());
+        using namespace date;
+        const auto time_key = value.at("created_at").get<std::size_t>();
 
-        auto filler_functor = [&answer](const std::string& key, const nlohmann::json& value, bool is_maker)
+        std::string action = "";
+        if (not is_maker)
         {
-            using namespace date;
-            const auto time_key = value.at("created_at").get<std::size_t>();
-
-            std::string action = "";
-            if (not is_maker)
-            {
-                value.at("request").at("action").get_to(action);
-            }
-            using namespace atomic_dex;
-            const auto     price       = is_maker ? atomic_dex::utils::adjust_precision(value.at("price").get<std::string>()) : "0";
-            const auto     base_coin   = is_maker ? QString::fromStdString(value.at("base").get<std::string>())
-                                                  : QString::fromStdString(value.at("request").at("base").get<std::string>());
-            const auto     rel_coin    = is_maker ? QString::fromStdString(value.at("rel").get<std::string>())
-                                                  : QString::fromStdString(value.at("request").at("rel").get<std::string>());
-            const auto     base_amount = is_maker ? QString::fromStdString(value.at("available_amount").get<std::string>())
-                                                  : QString::fromStdString(value.at("request").at("base_amount").get<std::string>());
-            const auto     rel_amount = is_maker ? QString::fromStdString((safe_float(price) * safe_float(base_amount.toStdString())).convert_to<std::string>())
-                                                 : QString::fromStdString(value.at("request").at("rel_amount").get<std::string>());
-            nlohmann::json conf_settings = is_maker ? value.at("conf_settings") : nlohmann::json();
-            order_swaps_data contents{
-                .is_maker       = is_maker,
-                .base_coin      = action == "Sell" ? base_coin : rel_coin,
-                .rel_coin       = action == "Sell" ? rel_coin : base_coin,
-                .base_amount    = action == "Sell" ? base_amount : rel_amount,
-                .rel_amount     = action == "Sell" ? rel_amount : base_amount,
-                .order_type     = is_maker ? "maker" : "taker",
-                .human_date     = QString::fromStdString(atomic_dex::utils::to_human_date<std::chrono::seconds>(time_key / 1000, "%F %T")),
-                .unix_timestamp = static_cast<unsigned long long>(time_key),
-                .order_id       = QString::fromStdString(key),
-                .order_status   = "matching",
-                .is_swap        = false,
-                .is_cancellable = value.at("cancellable").get<bool>(),
-                .is_recoverable = false,
-                .min_volume     = is_maker ? QString::fromStdString(value.at("min_base_vol").get<std::string>()) : std::optional<QString>(std::nullopt),
-                .conf_settings  = conf_settings};
-            if (action.empty() && contents.order_type == "maker")
-            {
-                contents.base_coin   = base_coin;
-                contents.rel_coin    = rel_coin;
-                contents.base_amount = base_amount;
-                contents.rel_amount  = rel_amount;
-            }
-            auto&& [base_fiat_value, rel_fiat_value] = determine_amounts_in_current_currency(
-                contents.base_coin.toStdString(), contents.base_amount.toStdString(), contents.rel_coin.toStdString(), contents.rel_amount.toStdString());
-            contents.base_amount_fiat = QString::fromStdString(base_fiat_value);
-            contents.rel_amount_fiat  = QString::fromStdString(rel_fiat_value);
-            contents.ticker_pair      = contents.base_coin + "/" + contents.rel_coin;
-            answer.orders_id.emplace(key);
-            answer.orders.emplace_back(std::move(contents));
-        };
+            value.at("request").at("action").get_to(action);
+        }
+        using namespace atomic_dex;
+        const auto     price       = is_maker ? atomic_dex::utils::adjust_precision(value.at("price").get<std::string>()) : "0";
+        const auto     base_coin   = is_maker ? QString::fromStdString(value.at("base").get<std::string>())
+                                              : QString::fromStdString(value.at("request").at("base").get<std::string>());
+        const auto     rel_coin    = is_maker ? QString::fromStdString(value.at("rel").get<std::string>())
+                                              : QString::fromStdString(value.at("request").at("rel").get<std::string>());
+        const auto     base_amount = is_maker ? QString::fromStdString(value.at("available_amount").get<std::string>())
+                                              : QString::fromStdString(value.at("request").at("base_amount").get<std::string>());
+        const auto     rel_amount = is_maker ? QString::fromStdString((safe_float(price) * safe_float(base_amount.toStdString())).convert_to<std::string>())
+                                             : QString::fromStdString(value.at("request").at("rel_amount").get<std::string>());
+        nlohmann::json conf_settings = is_maker ? value.at("conf_settings") : nlohmann::json();
+        order_swaps_data contents{
+            .is_maker       = is_maker,
+            .base_coin      = action == "Sell" ? base_coin : rel_coin,
+            .rel_coin       = action == "Sell" ? rel_coin : base_coin,
+            .base_amount    = action == "Sell" ? base_amount : rel_amount,
+            .rel_amount     = action == "Sell" ? rel_amount : base_amount,
+            .order_type     = is_maker ? "maker" : "taker",
+            .human_date     = QString::fromStdString(atomic_dex::utils::to_human_date<std::chrono::seconds>(time_key / 1000, "%F %T")),
+            .unix_timestamp = static_cast<unsigned long long>(time_key),
+            .order_id       = QString::fromStdString(key),
+            .order_status   = "matching",
+            .is_swap        = false,
+            .is_cancellable = value.at("cancellable").get<bool>(),
+            .is_recoverable = false,
+            .min_volume     = is_maker ? QString::fromStdString(value.at("min_base_vol").get<std::string>()) : std::optional<QString>(std::nullopt),
+            .conf_settings  = conf_settings};
+        if (action.empty() && contents.order_type == "maker")
+        {
+            contents.base_coin   = base_coin;
+            contents.rel_coin    = rel_coin;
+            contents.base_amount = base_amount;
+            contents.rel_amount  = rel_amount;
+        }
+        auto&& [base_fiat_value, rel_fiat_value] = determine_amounts_in_current_currency(
+            contents.base_coin.toStdString(), contents.base_amount.toStdString(), contents.rel_coin.toStdString(), contents.rel_amount.toStdString());
+        contents.base_amount_fiat = QString::fromStdString(base_fiat_value);
+        contents.rel_amount_fiat  = QString::fromStdString(rel_fiat_value);
+        contents.ticker_pair      = contents.base_coin + "/" + contents.rel_coin;
+        answer.orders_id.emplace(key);
+        answer.orders.emplace_back(std::move(contents));
+    }
 
-        for (auto&& [key, value]: j.at("result").at("maker_orders").items()) { filler_functor(key, value, true); }
-        for (auto&& [key, value]: j.at("result").at("taker_orders").items()) { filler_functor(key, value, false); }
+    void
+    from_json(const nlohmann::json& j, my_orders_answer& answer)
+    {
+        // answer.orders.reserve(j.at("result").at("maker_orders").size() + j.at("result").at("taker_orders").size());
+        for (auto&& [key, value]: j.at("result").at("maker_orders").items()) { append_order_from_json(key, value, true, answer); }
+        for (auto&& [key, value]: j.at("result").at("taker_orders").items()) { append_order_from_json(key, value, false, answer); }
     }
 
     void
@@ -511,10 +513,8 @@ namespace mm2::api
     from_json(const nlohmann::json& j, my_recent_swaps_answer_success& results)
     {
         // spdlog::stopwatch                                    stopwatch;
-        std::unordered_map<std::string, std::vector<double>> events_time_registry;
-        const auto&                                          swaps = j.at("swaps");
+        const auto& swaps = j.at("swaps");
         results.swaps.reserve(swaps.size());
-        results.swaps_id.reserve(swaps.size());
         for (auto&& cur: swaps)
         {
             if (cur.is_null())
@@ -524,7 +524,25 @@ namespace mm2::api
             }
             order_swaps_data to_add;
             from_json(cur, to_add);
-            for (auto&& cur_event: to_add.events)
+            results.swaps.emplace_back(std::move(to_add));
+        }
+        j.at("limit").get_to(results.limit);
+        j.at("skipped").get_to(results.skipped);
+        j.at("total").get_to(results.total);
+        j.at("page_number").get_to(results.page_number);
+        j.at("total_pages").get_to(results.total_pages);
+        finalize_recent_swaps(results);
+    }
+
+    void
+    finalize_recent_swaps(my_recent_swaps_answer_success& results)
+    {
+        std::unordered_map<std::string, std::vector<double>> events_time_registry;
+        results.swaps_id.clear();
+        results.swaps_id.reserve(results.swaps.size());
+        for (auto&& cur_swap: results.swaps)
+        {
+            for (auto&& cur_event: cur_swap.events)
             {
                 if (cur_event.isObject())
                 {
@@ -534,14 +552,8 @@ namespace mm2::api
                     }
                 }
             }
-            results.swaps_id.emplace(to_add.order_id.toStdString());
-            results.swaps.emplace_back(std::move(to_add));
+            results.swaps_id.emplace(cur_swap.order_id.toStdString());
         }
-        j.at("limit").get_to(results.limit);
-        j.at("skipped").get_to(results.skipped);
-        j.at("total").get_to(results.total);
-        j.at("page_number").get_to(results.page_number);
-        j.at("total_pages").get_to(results.total_pages);
         results.average_events_time = nlohmann::json::object();
 
         for (auto&& [evt_name, values]: events_time_registry)
@@ -579,12 +591,14 @@ namespace mm2::api
     }
 
     std::string
-    rpc_version()
+    rpc_version(std::chrono::milliseconds timeout)
     {
         nlohmann::json json_data = template_request("version");
         try
         {
-            auto                    client = std::make_unique<web::http::client::http_client>(FROM_STD_STR("http://127.0.0.1:7783"));
+            web::http::client::http_client_config cfg;
+            cfg.set_timeout(timeout);
+            auto                    client = std::make_unique<web::http::client::http_client>(FROM_STD_STR("http://127.0.0.1:7783"), cfg);
             web::http::http_request request;
             request.set_method(web::http::methods::POST);
             request.set_body(json_data.dump());
@@ -598,8 +612,9 @@ namespace mm2::api
 
             return "error occured during rpc_version";
         }
-        catch (const web::http::http_exception& exception)
+        catch (const std::exception& exception)
         {
+            //! http errors while mm2 is not listening yet, or an answer that is not complete
             return "error occured during rpc_version";
         }
         return "";
@@ -711,6 +726,8 @@ namespace mm2::api
     template mm2::api::validate_address_answer      rpc_process_answer_batch(nlohmann::json& json_answer, const std::string& rpc_command);
     template mm2::api::convert_address_answer       rpc_process_answer_batch(nlohmann::json& json_answer, const std::string& rpc_command);
     template mm2::api::recover_funds_of_swap_answer rpc_process_answer_batch(nlohmann::json& json_answer, const std::string& rpc_command);
+    template mm2::api::balance_answer               rpc_process_answer_batch(nlohmann::json& json_answer, const std::string& rpc_command);
+    template mm2::api::tx_history_answer            rpc_process_answer_batch(nlohmann::json& json_answer, const std::string& rpc_command);
 
     void
     set_system_manager(ag::ecs::system_manager& system_manager)
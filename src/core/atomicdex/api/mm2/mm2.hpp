@@ -17,6 +17,7 @@
 #pragma once
 
 //! STD
+#include <chrono>
 #include <unordered_set>
 
 //! Deps
@@ -43,7 +44,8 @@ namespace mm2::api
 
     nlohmann::json basic_batch_answer(const web::http::http_response& resp);
 
-    std::string rpc_version();
+    //! Answers "error occured during rpc_version" if mm2 did not answer within `timeout`
+    std::string rpc_version(std::chrono::milliseconds timeout = std::chrono::seconds(30));
 
     struct trade_fee_request
     {
@@ -144,6 +146,9 @@ namespace mm2::api
 
     void from_json(const nlohmann::json& j, my_orders_answer& answer);
 
+    //! Appends a single maker (or taker) order of a my_orders answer, `key` is the uuid of the order.
+    void append_order_from_json(const std::string& key, const nlohmann::json& value, bool is_maker, my_orders_answer& answer);
+
     struct my_recent_swaps_request
     {
         std::size_t                limit{50ull};
@@ -176,6 +181,9 @@ namespace mm2::api
 
     void from_json(const nlohmann::json& j, my_recent_swaps_answer_success& results);
 
+    //! Rebuilds the uuid registry and the average events time from the decoded swaps.
+    void finalize_recent_swaps(my_recent_swaps_answer_success& results);
+
     struct my_recent_swaps_answer
     {
         std::optional<my_recent_swaps_answer_success> result;
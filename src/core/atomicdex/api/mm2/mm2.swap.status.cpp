@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+
+//! Deps
+#include <nlohmann/json.hpp>
+
+//! Project Headers
+#include "atomicdex/api/mm2/mm2.swap.status.hpp"
+
+namespace
+{
+    bool
+    is_error_event(const nlohmann::json& event, const nlohmann::json& error_events)
+    {
+        const auto& evt = event.at("event");
+        if (!evt.contains("data") || !evt.at("data").contains("error"))
+        {
+            return false;
+        }
+        const auto& type = evt.at("type").get_ref<const std::string&>();
+        return std::any_of(error_events.begin(), error_events.end(), [&type](const nlohmann::json& cur) { return cur.is_string() && cur == type; });
+    }
+} // namespace
+
+namespace mm2::api
+{
+    std::string
+    determine_swap_status(const nlohmann::json& swap)
+    {
+        const auto& events = swap.at("events");
+        if (events.empty())
+        {
+            return "matching";
+        }
+        const auto& last_event = events.back().at("event").at("type").get_ref<const std::string&>();
+        if (last_event == "Started")
+        {
+            return "matched";
+        }
+        if (last_event == "TakerPaymentWaitRefundStarted" || last_event == "MakerPaymentWaitRefundStarted")
+        {
+            return "refunding";
+        }
+        if (last_event == "Finished")
+        {
+            return find_swap_error_event(swap).has_value() ? "failed" : "successful";
+        }
+        return "ongoing";
+    }
+
+    std::optional<std::string>
+    find_swap_error_event(const nlohmann::json& swap)
+    {
+        const auto& events       = swap.at("events");
+        const auto& error_events = swap.at("error_events");
+        const auto  it = std::find_if(events.begin(), events.end(), [&error_events](const nlohmann::json& cur) { return is_error_event(cur, error_events); });
+        if (it == events.end())
+        {
+            return std::nullopt;
+        }
+        return it->at("event").at("type").get<std::string>();
+    }
+
+    bool
+    is_final_swap_status(std::string_view status) noexcept
+    {
+        return status == "successful" || status == "failed";
+    }
+} // namespace mm2::api
@@ -0,0 +1,38 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <optional>
+#include <string>
+#include <string_view>
+
+//! Deps
+#include <nlohmann/json_fwd.hpp>
+
+namespace mm2::api
+{
+    //! Status of a raw my_recent_swaps / active_swaps entry, same states as order_swaps_data::order_status:
+    //! matching, matched, ongoing, refunding, successful, failed.
+    std::string determine_swap_status(const nlohmann::json& swap);
+
+    //! Type of the first error event carrying an error, nullopt when the swap has none.
+    std::optional<std::string> find_swap_error_event(const nlohmann::json& swap);
+
+    //! successful and failed swaps will not receive any new event.
+    bool is_final_swap_status(std::string_view status) noexcept;
+} // namespace mm2::api
@@ -0,0 +1,489 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+//! STD
+#include <algorithm>
+
+//! Deps
+#include <nlohmann/json.hpp>
+
+//! Project Headers
+#include "atomicdex/api/mm2/orderbook.columns.hpp"
+#include "atomicdex/utilities/global.utilities.hpp"
+
+namespace
+{
+    constexpr std::size_t
+    to_idx(mm2::api::order_number field) noexcept
+    {
+        return static_cast<std::size_t>(field);
+    }
+
+    constexpr std::size_t
+    to_idx(mm2::api::order_text field) noexcept
+    {
+        return static_cast<std::size_t>(field);
+    }
+
+    //! {json object, key} of every text field, in order_text order
+    constexpr std::array<std::pair<const char*, const char*>, mm2::api::g_nb_order_texts> g_text_json_keys{{
+        {nullptr, "address"},
+        {nullptr, "pubkey"},
+        {"price_fraction", "numer"},
+        {"price_fraction", "denom"},
+        {"max_volume_fraction", "numer"},
+        {"max_volume_fraction", "denom"},
+        {"base_min_volume_fraction", "numer"},
+        {"base_min_volume_fraction", "denom"},
+        {"base_max_volume_fraction", "numer"},
+        {"base_max_volume_fraction", "denom"},
+        {"rel_min_volume_fraction", "numer"},
+        {"rel_min_volume_fraction", "denom"},
+        {"rel_max_volume_fraction", "numer"},
+        {"rel_max_volume_fraction", "denom"},
+    }};
+} // namespace
+
+namespace mm2::api
+{
+    orderbook_columns::orderbook_columns(const std::vector<order_contents>& rows)
+    {
+        reserve(rows.size());
+        for (auto&& order: rows) { append(order); }
+    }
+
+    void
+    orderbook_columns::reserve(std::size_t size)
+    {
+        m_uuids.reserve(size);
+        m_coins.reserve(size);
+        m_rel_coins.reserve(size);
+        m_is_mine.reserve(size);
+        m_texts.reserve(size);
+        for (auto&& column: m_numbers) { column.reserve(size); }
+    }
+
+    void
+    orderbook_columns::clear() noexcept
+    {
+        m_uuids.clear();
+        m_coins.clear();
+        m_rel_coins.clear();
+        m_is_mine.clear();
+        m_texts.clear();
+        for (auto&& column: m_numbers) { column.clear(); }
+        m_text_buffer.clear();
+        m_dead_text_bytes = 0;
+        m_coin_names.clear();
+        m_coin_ids.clear();
+        m_out_of_range.clear();
+    }
+
+    std::uint32_t
+    orderbook_columns::intern_coin(std::string_view coin)
+    {
+        std::string key(coin);
+        if (auto it = m_coin_ids.find(key); it != m_coin_ids.end())
+        {
+            return it->second;
+        }
+        const auto id = static_cast<std::uint32_t>(m_coin_names.size());
+        m_coin_names.push_back(key);
+        m_coin_ids.emplace(std::move(key), id);
+        return id;
+    }
+
+    orderbook_columns::text_ref
+    orderbook_columns::store_text(std::string_view value)
+    {
+        text_ref ref{.offset = static_cast<std::uint32_t>(m_text_buffer.size()), .size = static_cast<std::uint32_t>(value.size())};
+        m_text_buffer.append(value);
+        return ref;
+    }
+
+    void
+    orderbook_columns::push_row(std::string uuid, std::string_view coin, std::string_view rel_coin, bool has_rel_coin, bool is_mine)
+    {
+        m_uuids.push_back(std::move(uuid));
+        m_coins.push_back(intern_coin(coin));
+        m_rel_coins.push_back(has_rel_coin ? intern_coin(rel_coin) : g_no_coin);
+        m_is_mine.push_back(is_mine ? 1 : 0);
+        m_texts.emplace_back();
+        for (auto&& column: m_numbers) { column.emplace_back(); }
+    }
+
+    void
+    orderbook_columns::append(const order_contents& order)
+    {
+        push_row(order.uuid, order.coin, order.rel_coin.value_or(""), order.rel_coin.has_value(), order.is_mine);
+        const auto row = size() - 1;
+
+        parse_number(row, order_number::price, order.price);
+        parse_number(row, order_number::max_volume, order.maxvolume);
+        parse_number(row, order_number::total, order.total);
+        parse_number(row, order_number::depth_percent, order.depth_percent);
+        parse_number(row, order_number::min_volume, order.min_volume);
+        parse_number(row, order_number::base_min_volume, order.base_min_volume);
+        parse_number(row, order_number::base_max_volume, order.base_max_volume);
+        parse_number(row, order_number::rel_min_volume, order.rel_min_volume);
+        parse_number(row, order_number::rel_max_volume, order.rel_max_volume);
+
+        const std::array<const std::string*, g_nb_order_texts> texts{
+            &order.address,
+            &order.pubkey,
+            &order.price_fraction_numer,
+            &order.price_fraction_denom,
+            &order.max_volume_fraction_numer,
+            &order.max_volume_fraction_denom,
+            &order.base_min_volume_numer,
+            &order.base_min_volume_denom,
+            &order.base_max_volume_numer,
+            &order.base_max_volume_denom,
+            &order.rel_min_volume_numer,
+            &order.rel_min_volume_denom,
+            &order.rel_max_volume_numer,
+            &order.rel_max_volume_denom};
+        for (std::size_t idx = 0; idx < g_nb_order_texts; ++idx) { m_texts[row][idx] = store_text(*texts[idx]); }
+    }
+
+    void
+    orderbook_columns::append(const nlohmann::json& order)
+    {
+        push_row(
+            order.at("uuid").get<std::string>(), order.at("coin").get_ref<const std::string&>(), {}, false, order.at("is_mine").get<bool>());
+        const auto row = size() - 1;
+
+        parse_number(row, order_number::price, order.at("price").get_ref<const std::string&>());
+        parse_number(row, order_number::max_volume, order.at("maxvolume").get_ref<const std::string&>());
+        if (order.contains("min_volume"))
+        {
+            parse_number(row, order_number::min_volume, order.at("min_volume").get_ref<const std::string&>());
+        }
+        parse_number(row, order_number::base_min_volume, order.at("base_min_volume").get_ref<const std::string&>());
+        parse_number(row, order_number::base_max_volume, order.at("base_max_volume").get_ref<const std::string&>());
+        parse_number(row, order_number::rel_min_volume, order.at("rel_min_volume").get_ref<const std::string&>());
+        parse_number(row, order_number::rel_max_volume, order.at("rel_max_volume").get_ref<const std::string&>());
+
+        for (std::size_t idx = 0; idx < g_nb_order_texts; ++idx)
+        {
+            const auto& [object, key] = g_text_json_keys[idx];
+            const auto& value         = object == nullptr ? order.at(key) : order.at(object).at(key);
+            m_texts[row][idx]         = store_text(value.get_ref<const std::string&>());
+        }
+
+        //! The total can leave the fixed_decimal range even when the price and the volume fit
+        if (out_of_range(row, order_number::price) == nullptr && out_of_range(row, order_number::max_volume) == nullptr)
+        {
+            try
+            {
+                set_number(row, order_number::total, number(row, order_number::price) * number(row, order_number::max_volume));
+                return;
+            }
+            catch (const std::overflow_error&)
+            {
+            }
+        }
+        const t_float_50 total_f = safe_float(exact(row, order_number::price)) * safe_float(exact(row, order_number::max_volume));
+        set_out_of_range(row, order_number::total, total_f.str(t_fixed_decimal::g_scale_digits, std::ios_base::fixed));
+    }
+
+    void
+    orderbook_columns::append(const orderbook_columns& other, std::size_t other_row)
+    {
+        push_row(other.uuid(other_row), other.coin(other_row), other.rel_coin(other_row), other.has_rel_coin(other_row), other.is_mine(other_row));
+        assign(size() - 1, other, other_row);
+    }
+
+    void
+    orderbook_columns::assign(std::size_t row, const orderbook_columns& other, std::size_t other_row)
+    {
+        if (!m_out_of_range.empty())
+        {
+            m_out_of_range.erase(m_uuids[row]);
+        }
+        if (auto it = other.m_out_of_range.find(other.uuid(other_row)); it != other.m_out_of_range.end())
+        {
+            m_out_of_range.insert_or_assign(other.uuid(other_row), it->second);
+        }
+        if (m_uuids[row] != other.uuid(other_row))
+        {
+            m_uuids[row] = other.uuid(other_row);
+        }
+        m_coins[row]     = intern_coin(other.coin(other_row));
+        m_rel_coins[row] = other.has_rel_coin(other_row) ? intern_coin(other.rel_coin(other_row)) : g_no_coin;
+        m_is_mine[row]   = other.m_is_mine[other_row];
+        for (std::size_t idx = 0; idx < g_nb_order_numbers; ++idx) { m_numbers[idx][row] = other.m_numbers[idx][other_row]; }
+        for (std::size_t idx = 0; idx < g_nb_order_texts; ++idx) { set_text(row, static_cast<order_text>(idx), other.text(other_row, static_cast<order_text>(idx))); }
+    }
+
+    void
+    orderbook_columns::erase(std::size_t first, std::size_t count)
+    {
+        const auto last = first + count;
+        for (std::size_t row = first; row < last; ++row)
+        {
+            for (auto&& ref: m_texts[row]) { m_dead_text_bytes += ref.size; }
+            if (!m_out_of_range.empty())
+            {
+                m_out_of_range.erase(m_uuids[row]);
+            }
+        }
+        const auto erase_range = [first, last](auto& column)
+        { column.erase(column.begin() + static_cast<std::ptrdiff_t>(first), column.begin() + static_cast<std::ptrdiff_t>(last)); };
+        erase_range(m_uuids);
+        erase_range(m_coins);
+        erase_range(m_rel_coins);
+        erase_range(m_is_mine);
+        erase_range(m_texts);
+        for (auto&& column: m_numbers) { erase_range(column); }
+        compact_texts();
+    }
+
+    void
+    orderbook_columns::compact_texts()
+    {
+        //! Rewrites the buffer once more than half of it belongs to erased / reassigned rows
+        if (m_dead_text_bytes < 4096 || m_dead_text_bytes * 2 < m_text_buffer.size())
+        {
+            return;
+        }
+        std::string buffer;
+        buffer.reserve(m_text_buffer.size() - m_dead_text_bytes);
+        for (auto&& refs: m_texts)
+        {
+            for (auto&& ref: refs)
+            {
+                const auto offset = static_cast<std::uint32_t>(buffer.size());
+                buffer.append(m_text_buffer, ref.offset, ref.size);
+                ref.offset = offset;
+            }
+        }
+        m_text_buffer     = std::move(buffer);
+        m_dead_text_bytes = 0;
+    }
+
+    const std::string&
+    orderbook_columns::coin(std::size_t row) const
+    {
+        return m_coin_names[m_coins[row]];
+    }
+
+    const std::string&
+    orderbook_columns::rel_coin(std::size_t row) const
+    {
+        static const std::string g_empty;
+        return has_rel_coin(row) ? m_coin_names[m_rel_coins[row]] : g_empty;
+    }
+
+    bool
+    orderbook_columns::has_rel_coin(std::size_t row) const
+    {
+        return m_rel_coins[row] != g_no_coin;
+    }
+
+    const t_fixed_decimal&
+    orderbook_columns::number(std::size_t row, order_number field) const
+    {
+        return m_numbers[to_idx(field)][row];
+    }
+
+    std::string_view
+    orderbook_columns::text(std::size_t row, order_text field) const
+    {
+        const auto& ref = m_texts[row][to_idx(field)];
+        return std::string_view(m_text_buffer).substr(ref.offset, ref.size);
+    }
+
+    void
+    orderbook_columns::set_number(std::size_t row, order_number field, const t_fixed_decimal& value)
+    {
+        m_numbers[to_idx(field)][row] = value;
+        if (auto it = m_out_of_range.find(m_uuids[row]); it != m_out_of_range.end())
+        {
+            it->second[to_idx(field)].clear();
+        }
+    }
+
+    void
+    orderbook_columns::parse_number(std::size_t row, order_number field, std::string_view value)
+    {
+        //! Rows built by hand (best orders, tests) leave the fields they do not know empty
+        if (value.empty())
+        {
+            set_number(row, field, t_fixed_decimal(0));
+        }
+        else if (auto decimal = t_fixed_decimal::from_string(value); decimal.has_value())
+        {
+            set_number(row, field, *decimal);
+        }
+        else
+        {
+            SPDLOG_WARN("order {}: {} does not fit a fixed_decimal, shown as received", m_uuids[row], value);
+            set_number(row, field, t_fixed_decimal(0));
+            set_out_of_range(row, field, std::string(value));
+        }
+    }
+
+    void
+    orderbook_columns::set_out_of_range(std::size_t row, order_number field, std::string value)
+    {
+        m_out_of_range[m_uuids[row]][to_idx(field)] = std::move(value);
+    }
+
+    const std::string*
+    orderbook_columns::out_of_range(std::size_t row, order_number field) const
+    {
+        if (m_out_of_range.empty())
+        {
+            return nullptr;
+        }
+        const auto it = m_out_of_range.find(m_uuids[row]);
+        return it == m_out_of_range.end() || it->second[to_idx(field)].empty() ? nullptr : &it->second[to_idx(field)];
+    }
+
+    std::string
+    orderbook_columns::exact(std::size_t row, order_number field) const
+    {
+        const auto* kept = out_of_range(row, field);
+        return kept != nullptr ? *kept : number(row, field).str(t_fixed_decimal::g_scale_digits);
+    }
+
+    void
+    orderbook_columns::set_text(std::size_t row, order_text field, std::string_view value)
+    {
+        auto& ref = m_texts[row][to_idx(field)];
+        if (text(row, field) == value)
+        {
+            return;
+        }
+        m_dead_text_bytes += ref.size;
+        if (value.data() >= m_text_buffer.data() && value.data() < m_text_buffer.data() + m_text_buffer.size())
+        {
+            //! The buffer may be reallocated by the append
+            ref = store_text(std::string(value));
+        }
+        else
+        {
+            ref = store_text(value);
+        }
+        compact_texts();
+    }
+
+    void
+    orderbook_columns::set_is_mine(std::size_t row, bool is_mine)
+    {
+        m_is_mine[row] = is_mine ? 1 : 0;
+    }
+
+    std::string
+    orderbook_columns::display(std::size_t row, order_number field) const
+    {
+        //! Trailing zeros are trimmed, a number out of the fixed_decimal range is formatted through t_float_50 as before the columns
+        if (const auto* kept = out_of_range(row, field); kept != nullptr)
+        {
+            return atomic_dex::utils::format_float(safe_float(*kept));
+        }
+        switch (field)
+        {
+        case order_number::max_volume:
+        case order_number::total:
+        case order_number::depth_percent:
+            return atomic_dex::utils::format_float(number(row, field));
+        default:
+            return atomic_dex::utils::format_float(number(row, field), t_fixed_decimal::g_scale_digits);
+        }
+    }
+
+    order_contents
+    orderbook_columns::to_order_contents(std::size_t row) const
+    {
+        order_contents out{};
+        out.uuid    = uuid(row);
+        out.coin    = coin(row);
+        out.is_mine = is_mine(row);
+        if (has_rel_coin(row))
+        {
+            out.rel_coin = rel_coin(row);
+        }
+        out.price           = display(row, order_number::price);
+        out.maxvolume       = display(row, order_number::max_volume);
+        out.total           = display(row, order_number::total);
+        out.depth_percent   = display(row, order_number::depth_percent);
+        out.min_volume      = display(row, order_number::min_volume);
+        out.base_min_volume = display(row, order_number::base_min_volume);
+        out.base_max_volume = display(row, order_number::base_max_volume);
+        out.rel_min_volume  = display(row, order_number::rel_min_volume);
+        out.rel_max_volume  = display(row, order_number::rel_max_volume);
+
+        const auto text_of             = [this, row](order_text field) { return std::string(text(row, field)); };
+        out.address                   = text_of(order_text::address);
+        out.pubkey                    = text_of(order_text::pubkey);
+        out.price_fraction_numer      = text_of(order_text::price_numer);
+        out.price_fraction_denom      = text_of(order_text::price_denom);
+        out.max_volume_fraction_numer = text_of(order_text::max_volume_numer);
+        out.max_volume_fraction_denom = text_of(order_text::max_volume_denom);
+        out.base_min_volume_numer     = text_of(order_text::base_min_volume_numer);
+        out.base_min_volume_denom     = text_of(order_text::base_min_volume_denom);
+        out.base_max_volume_numer     = text_of(order_text::base_max_volume_numer);
+        out.base_max_volume_denom     = text_of(order_text::base_max_volume_denom);
+        out.rel_min_volume_numer      = text_of(order_text::rel_min_volume_numer);
+        out.rel_min_volume_denom      = text_of(order_text::rel_min_volume_denom);
+        out.rel_max_volume_numer      = text_of(order_text::rel_max_volume_numer);
+        out.rel_max_volume_denom      = text_of(order_text::rel_max_volume_denom);
+        return out;
+    }
+
+    bool
+    orderbook_columns::same_order(std::size_t row, const orderbook_columns& other, std::size_t other_row) const
+    {
+        if (is_mine(row) != other.is_mine(other_row) || coin(row) != other.coin(other_row) || rel_coin(row) != other.rel_coin(other_row) ||
+            has_rel_coin(row) != other.has_rel_coin(other_row))
+        {
+            return false;
+        }
+        for (std::size_t idx = 0; idx < g_nb_order_numbers; ++idx)
+        {
+            const auto* kept       = out_of_range(row, static_cast<order_number>(idx));
+            const auto* other_kept = other.out_of_range(other_row, static_cast<order_number>(idx));
+            if (m_numbers[idx][row] != other.m_numbers[idx][other_row] || (kept == nullptr) != (other_kept == nullptr) ||
+                (kept != nullptr && *kept != *other_kept))
+            {
+                return false;
+            }
+        }
+        //! address and pubkey are not displayed
+        for (std::size_t idx = to_idx(order_text::price_numer); idx < g_nb_order_texts; ++idx)
+        {
+            if (text(row, static_cast<order_text>(idx)) != other.text(other_row, static_cast<order_text>(idx)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::size_t
+    orderbook_columns::memory_usage() const noexcept
+    {
+        std::size_t out = m_text_buffer.capacity() + m_coins.capacity() * sizeof(std::uint32_t) + m_rel_coins.capacity() * sizeof(std::uint32_t) +
+                          m_is_mine.capacity() + m_texts.capacity() * sizeof(m_texts[0]) + m_uuids.capacity() * sizeof(std::string);
+        for (auto&& uuid: m_uuids) { out += uuid.capacity() > 15 ? uuid.capacity() + 1 : 0; }
+        for (auto&& column: m_numbers) { out += column.capacity() * sizeof(t_fixed_decimal); }
+        for (auto&& name: m_coin_names) { out += sizeof(std::string) + name.capacity(); }
+        return out;
+    }
+} // namespace mm2::api
@@ -0,0 +1,159 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#pragma once
+
+//! STD
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//! Deps
+#include <nlohmann/json_fwd.hpp>
+
+//! Project Headers
+#include "atomicdex/api/mm2/orderbook.order.contents.hpp"
+#include "atomicdex/utilities/fixed.decimal.hpp"
+
+namespace mm2::api
+{
+    enum class order_number : std::uint8_t
+    {
+        price,
+        max_volume,
+        total,
+        depth_percent,
+        min_volume,
+        base_min_volume,
+        base_max_volume,
+        rel_min_volume,
+        rel_max_volume,
+        size
+    };
+
+    //! Fields only read when an order is selected, kept as the exact mm2 strings.
+    enum class order_text : std::uint8_t
+    {
+        address,
+        pubkey,
+        price_numer,
+        price_denom,
+        max_volume_numer,
+        max_volume_denom,
+        base_min_volume_numer,
+        base_min_volume_denom,
+        base_max_volume_numer,
+        base_max_volume_denom,
+        rel_min_volume_numer,
+        rel_min_volume_denom,
+        rel_max_volume_numer,
+        rel_max_volume_denom,
+        size
+    };
+
+    inline constexpr std::size_t g_nb_order_numbers = static_cast<std::size_t>(order_number::size);
+    inline constexpr std::size_t g_nb_order_texts   = static_cast<std::size_t>(order_text::size);
+
+    //! One side of an orderbook stored column by column.
+    //! Numbers are parsed once into fixed_decimal, coins are interned and the fraction / address strings share a single buffer,
+    //! so sorting and depth computation never parse strings and an order costs a fraction of an order_contents.
+    class orderbook_columns
+    {
+      public:
+        orderbook_columns() = default;
+        explicit orderbook_columns(const std::vector<order_contents>& rows);
+
+        void append(const order_contents& order);
+        void append(const nlohmann::json& order); ///< an order of an mm2 orderbook answer
+        void append(const orderbook_columns& other, std::size_t other_row);
+        void assign(std::size_t row, const orderbook_columns& other, std::size_t other_row);
+        void erase(std::size_t first, std::size_t count);
+        void clear() noexcept;
+        void reserve(std::size_t size);
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_uuids.size(); }
+        [[nodiscard]] bool        empty() const noexcept { return m_uuids.empty(); }
+
+        [[nodiscard]] const std::string&              uuid(std::size_t row) const { return m_uuids[row]; }
+        [[nodiscard]] const std::vector<std::string>& uuids() const noexcept { return m_uuids; }
+        [[nodiscard]] const std::string&              coin(std::size_t row) const;
+        [[nodiscard]] const std::string&              rel_coin(std::size_t row) const; ///< empty unless the order comes from best_orders
+        [[nodiscard]] bool                            has_rel_coin(std::size_t row) const;
+        [[nodiscard]] bool                            is_mine(std::size_t row) const { return m_is_mine[row] != 0; }
+        [[nodiscard]] const t_fixed_decimal&          number(std::size_t row, order_number field) const;
+        [[nodiscard]] std::string_view                text(std::size_t row, order_text field) const;
+        void                                          set_number(std::size_t row, order_number field, const t_fixed_decimal& value);
+        void                                          set_text(std::size_t row, order_text field, std::string_view value);
+        void                                          set_is_mine(std::size_t row, bool is_mine);
+
+        //! Numbers out of the fixed_decimal range are stored as 0 and shown from the decimal string kept here instead.
+        void                             set_out_of_range(std::size_t row, order_number field, std::string value);
+        [[nodiscard]] const std::string* out_of_range(std::size_t row, order_number field) const; ///< nullptr if the number fits
+        [[nodiscard]] std::string        exact(std::size_t row, order_number field) const;        ///< full precision decimal string
+
+        //! Decimal string as shown by the orderbook views (8 decimals for volumes and depth, full precision for prices and limits).
+        [[nodiscard]] std::string display(std::size_t row, order_number field) const;
+
+        //! Row rebuilt as strings, for the callers still working on order_contents (order selection, trading page).
+        [[nodiscard]] order_contents to_order_contents(std::size_t row) const;
+
+        //! Compares every field displayed by the orderbook model.
+        [[nodiscard]] bool same_order(std::size_t row, const orderbook_columns& other, std::size_t other_row) const;
+
+        //! Bytes owned by the columns, for diagnostics.
+        [[nodiscard]] std::size_t memory_usage() const noexcept;
+
+      private:
+        struct text_ref
+        {
+            std::uint32_t offset{0};
+            std::uint32_t size{0};
+        };
+
+        using t_kept_numbers = std::array<std::string, g_nb_order_numbers>; ///< empty for the numbers that fit
+
+        static constexpr std::uint32_t g_no_coin = UINT32_MAX;
+
+        std::uint32_t intern_coin(std::string_view coin);
+        text_ref      store_text(std::string_view value);
+        void          push_row(std::string uuid, std::string_view coin, std::string_view rel_coin, bool has_rel_coin, bool is_mine);
+        void          compact_texts();
+        void          parse_number(std::size_t row, order_number field, std::string_view value);
+
+        std::vector<std::string>                                     m_uuids;
+        std::vector<std::uint32_t>                                   m_coins;
+        std::vector<std::uint32_t>                                   m_rel_coins; ///< g_no_coin unless the order comes from best_orders
+        std::vector<std::uint8_t>                                    m_is_mine;
+        std::array<std::vector<t_fixed_decimal>, g_nb_order_numbers> m_numbers;
+        std::vector<std::array<text_ref, g_nb_order_texts>>          m_texts;
+        std::string                                                  m_text_buffer;
+        std::size_t                                                  m_dead_text_bytes{0}; ///< bytes of erased / reassigned rows
+        std::vector<std::string>                                     m_coin_names;
+        std::unordered_map<std::string, std::uint32_t>               m_coin_ids;
+        std::unordered_map<std::string, t_kept_numbers>              m_out_of_range; ///< uuid -> kept strings, almost always empty
+    };
+} // namespace mm2::api
+
+namespace atomic_dex
+{
+    using t_orderbook_columns = ::mm2::api::orderbook_columns;
+    using t_order_number      = ::mm2::api::order_number;
+    using t_order_text        = ::mm2::api::order_text;
+} // namespace atomic_dex
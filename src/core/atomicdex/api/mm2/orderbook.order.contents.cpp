@@ -66,9 +66,9 @@ namespace mm2::api
         j.at("base_min_volume").get_to(contents.base_min_volume);
         j.at("rel_max_volume").get_to(contents.rel_max_volume);
         j.at("rel_min_volume").get_to(contents.rel_min_volume);
-        contents.maxvolume = atomic_dex::utils::adjust_precision(contents.maxvolume);
-        t_float_50 total_f = safe_float(contents.price) * safe_float(contents.maxvolume);
-        contents.total     = atomic_dex::utils::adjust_precision(total_f.str());
+        contents.maxvolume      = atomic_dex::utils::adjust_precision(contents.maxvolume);
+        t_fixed_decimal total_f = safe_decimal(contents.price) * safe_decimal(contents.maxvolume);
+        contents.total          = atomic_dex::utils::format_float(total_f);
     }
 
     std::string
@@ -21,6 +21,19 @@
 #include "atomicdex/api/mm2/rpc.orderbook.hpp"
 #include "atomicdex/utilities/global.utilities.hpp"
 
+namespace
+{
+    std::string
+    format_total(const atomic_dex::decimal_sum& total)
+    {
+        if (total.is_wide())
+        {
+            return total.wide().str(t_fixed_decimal::g_scale_digits, std::ios_base::fixed);
+        }
+        return atomic_dex::utils::format_float(total.fixed(), t_fixed_decimal::g_scale_digits);
+    }
+} // namespace
+
 namespace mm2::api
 {
     void
@@ -32,8 +45,12 @@ namespace mm2::api
         j.at("rel").get_to(answer.rel);
         j.at("askdepth").get_to(answer.askdepth);
         j.at("biddepth").get_to(answer.biddepth);
-        j.at("bids").get_to(answer.bids);
-        j.at("asks").get_to(answer.asks);
+        answer.bids.clear();
+        answer.bids.reserve(j.at("bids").size());
+        for (auto&& order: j.at("bids")) { answer.bids.append(order); }
+        answer.asks.clear();
+        answer.asks.reserve(j.at("asks").size());
+        for (auto&& order: j.at("asks")) { answer.asks.append(order); }
         j.at("numasks").get_to(answer.numasks);
         j.at("numbids").get_to(answer.numbids);
         j.at("netid").get_to(answer.netid);
@@ -41,34 +58,81 @@ namespace mm2::api
 
         answer.human_timestamp = atomic_dex::utils::to_human_date(answer.timestamp, "%Y-%m-%d %I:%M:%S");
 
-        t_float_50 result_asks_f(0);
-        for (auto&& cur_asks: answer.asks) { result_asks_f = result_asks_f + safe_float(cur_asks.maxvolume); }
-
-        answer.asks_total_volume = result_asks_f.str();
+        finalize_orderbook_answer(answer);
+    }
 
-        t_float_50 result_bids_f(0);
-        for (auto& cur_bids: answer.bids)
+    void
+    finalize_orderbook_answer(orderbook_answer& answer)
+    {
+        //! The totals move to t_float_50 instead of throwing once they leave the fixed_decimal range
+        atomic_dex::decimal_sum result_asks_f;
+        for (std::size_t row = 0; row < answer.asks.size(); ++row)
         {
-            cur_bids.total        = cur_bids.maxvolume;
-            t_float_50 new_volume = safe_float(cur_bids.maxvolume) / safe_float(cur_bids.price);
-            cur_bids.maxvolume    = atomic_dex::utils::adjust_precision(new_volume.str());
-            result_bids_f         = result_bids_f + safe_float(cur_bids.maxvolume);
+            if (const auto* wide_volume = answer.asks.out_of_range(row, order_number::max_volume); wide_volume != nullptr)
+            {
+                result_asks_f.add(safe_float(*wide_volume));
+            }
+            else
+            {
+                result_asks_f.add(answer.asks.number(row, order_number::max_volume));
+            }
         }
+        answer.asks_total_volume = format_total(result_asks_f);
 
-        answer.bids_total_volume = result_bids_f.str();
-        for (auto&& cur_asks: answer.asks)
+        //! mm2 gives the bids volume in rel, the rel volume becomes the total and the volume is converted to base
+        atomic_dex::decimal_sum result_bids_f;
+        for (std::size_t row = 0; row < answer.bids.size(); ++row)
         {
-            t_float_50 percent_f   = safe_float(cur_asks.maxvolume) / result_asks_f;
-            cur_asks.depth_percent = atomic_dex::utils::adjust_precision(percent_f.str());
-            //SPDLOG_INFO("cur_asks: {}", cur_asks.to_string());
+            if (answer.bids.out_of_range(row, order_number::max_volume) == nullptr && answer.bids.out_of_range(row, order_number::price) == nullptr)
+            {
+                try
+                {
+                    const t_fixed_decimal rel_volume = answer.bids.number(row, order_number::max_volume);
+                    const t_fixed_decimal price_f    = answer.bids.number(row, order_number::price);
+                    const t_fixed_decimal new_volume = price_f.is_zero() ? t_fixed_decimal(0) : rel_volume / price_f;
+                    answer.bids.set_number(row, order_number::total, rel_volume);
+                    answer.bids.set_number(row, order_number::max_volume, new_volume);
+                    result_bids_f.add(new_volume);
+                    continue;
+                }
+                catch (const std::overflow_error&)
+                {
+                }
+            }
+            //! Out of the fixed_decimal range: converted with t_float_50, kept as strings and left out of the depth
+            const std::string rel_volume = answer.bids.exact(row, order_number::max_volume);
+            const t_float_50  price_f    = safe_float(answer.bids.exact(row, order_number::price));
+            const t_float_50  new_volume = price_f == 0 ? t_float_50(0) : safe_float(rel_volume) / price_f;
+            answer.bids.set_number(row, order_number::total, t_fixed_decimal(0));
+            answer.bids.set_out_of_range(row, order_number::total, rel_volume);
+            answer.bids.set_number(row, order_number::max_volume, t_fixed_decimal(0));
+            answer.bids.set_out_of_range(row, order_number::max_volume, new_volume.str(t_fixed_decimal::g_scale_digits, std::ios_base::fixed));
+            result_bids_f.add(new_volume);
         }
+        answer.bids_total_volume = format_total(result_bids_f);
 
-        for (auto&& cur_bids: answer.bids)
+        const auto compute_depth = [](orderbook_columns& side, const atomic_dex::decimal_sum& total)
         {
-            t_float_50 percent_f   = safe_float(cur_bids.maxvolume) / result_bids_f;
-            cur_bids.depth_percent = atomic_dex::utils::adjust_precision(percent_f.str());
-            //SPDLOG_INFO("cur_bids: {}", cur_bids.to_string());
-        }
+            for (std::size_t row = 0; row < side.size(); ++row)
+            {
+                t_fixed_decimal percent_f(0);
+                if (total.is_wide())
+                {
+                    //! A share of the total is at most 1, it fits back once divided with t_float_50
+                    const auto*      wide_volume = side.out_of_range(row, order_number::max_volume);
+                    const t_float_50 volume =
+                        wide_volume != nullptr ? safe_float(*wide_volume) : safe_float(side.number(row, order_number::max_volume).str());
+                    percent_f = safe_decimal((volume / total.wide()).str(t_fixed_decimal::g_scale_digits, std::ios_base::fixed));
+                }
+                else if (!total.fixed().is_zero())
+                {
+                    percent_f = side.number(row, order_number::max_volume) / total.fixed();
+                }
+                side.set_number(row, order_number::depth_percent, percent_f);
+            }
+        };
+        compute_depth(answer.asks, result_asks_f);
+        compute_depth(answer.bids, result_bids_f);
     }
 
     void
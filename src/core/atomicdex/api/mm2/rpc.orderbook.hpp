@@ -20,7 +20,7 @@
 #include <nlohmann/json_fwd.hpp>
 
 //! Project Headers
-#include "atomicdex/api/mm2/orderbook.order.contents.hpp"
+#include "atomicdex/api/mm2/orderbook.columns.hpp"
 
 namespace mm2::api
 {
@@ -36,8 +36,8 @@ namespace mm2::api
     {
         std::size_t                 askdepth;
         std::size_t                 biddepth;
-        std::vector<order_contents> asks;
-        std::vector<order_contents> bids;
+        orderbook_columns           asks;
+        orderbook_columns           bids;
         std::string                 base;
         std::string                 rel;
         std::size_t                 numasks;
@@ -54,6 +54,9 @@ namespace mm2::api
     };
 
     void from_json(const nlohmann::json& j, orderbook_answer& answer);
+
+    //! Converts the bids volumes to base, computes the total volumes and the depth percentages once asks and bids are filled.
+    void finalize_orderbook_answer(orderbook_answer& answer);
 }
 
 namespace atomic_dex
@@ -0,0 +1,330 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+
+//! Deps
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+//! Project Headers
+#include "atomicdex/config/coins.cfg.snapshot.hpp"
+#include "atomicdex/utilities/content.hash.hpp"
+#include "atomicdex/utilities/log.prerequisites.hpp"
+
+namespace
+{
+    namespace bip = boost::interprocess;
+
+    constexpr std::uint32_t g_snapshot_magic   = 0x4B584441; ///< "ADXK"
+    constexpr std::uint32_t g_snapshot_version = 1;
+
+    struct snapshot_header
+    {
+        std::uint32_t magic{g_snapshot_magic};
+        std::uint32_t version{g_snapshot_version};
+        std::uint64_t source_hash{0};
+        std::uint64_t source_size{0};
+        std::uint64_t nb_records{0};
+    };
+
+    //! Offsets are relative to the start of the snapshot
+    struct snapshot_entry
+    {
+        std::uint64_t key_offset{0};
+        std::uint64_t value_offset{0};
+        std::uint32_t key_size{0};
+        std::uint32_t value_size{0};
+    };
+
+    static_assert(sizeof(snapshot_header) == 32);
+    static_assert(sizeof(snapshot_entry) == 24);
+
+    snapshot_header
+    read_header(std::string_view bytes)
+    {
+        snapshot_header header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        return header;
+    }
+
+    snapshot_entry
+    read_entry(std::string_view bytes, std::size_t idx)
+    {
+        snapshot_entry entry;
+        std::memcpy(&entry, bytes.data() + sizeof(snapshot_header) + idx * sizeof(snapshot_entry), sizeof(entry));
+        return entry;
+    }
+
+    //! Header and index of a snapshot read from disk, every entry has to stay inside the snapshot
+    bool
+    is_valid_snapshot(std::string_view bytes)
+    {
+        if (bytes.size() < sizeof(snapshot_header))
+        {
+            return false;
+        }
+        const auto header = read_header(bytes);
+        if (header.magic != g_snapshot_magic || header.version != g_snapshot_version ||
+            header.nb_records > (bytes.size() - sizeof(snapshot_header)) / sizeof(snapshot_entry))
+        {
+            return false;
+        }
+        for (std::size_t idx = 0; idx < header.nb_records; ++idx)
+        {
+            const auto entry = read_entry(bytes, idx);
+            if (entry.key_offset > bytes.size() || entry.key_size > bytes.size() - entry.key_offset || entry.value_offset > bytes.size() ||
+                entry.value_size > bytes.size() - entry.value_offset)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string
+    build_snapshot(std::string_view json_content, atomic_dex::t_content_hash source_hash)
+    {
+        //! Sorted by key, the last record of a duplicated coin wins like in the json registries
+        std::map<std::string, std::vector<std::uint8_t>> records;
+        const auto                                       json = nlohmann::json::parse(json_content.begin(), json_content.end());
+        if (json.is_array())
+        {
+            for (auto&& coin: json) { records.insert_or_assign(coin.at("coin").get<std::string>(), nlohmann::json::to_msgpack(coin)); }
+        }
+        else if (json.is_object())
+        {
+            for (auto&& [ticker, coin]: json.items()) { records.insert_or_assign(ticker, nlohmann::json::to_msgpack(coin)); }
+        }
+        else
+        {
+            throw std::invalid_argument("a coins file is either an array of coins or an object of coins");
+        }
+
+        const snapshot_header header{.source_hash = source_hash, .source_size = json_content.size(), .nb_records = records.size()};
+        std::string           out(sizeof(snapshot_header) + records.size() * sizeof(snapshot_entry), '\0');
+        std::memcpy(out.data(), &header, sizeof(header));
+        std::size_t idx = 0;
+        for (auto&& [key, value]: records)
+        {
+            snapshot_entry entry{.key_offset = out.size(), .key_size = static_cast<std::uint32_t>(key.size())};
+            out.append(key);
+            entry.value_offset = out.size();
+            entry.value_size   = static_cast<std::uint32_t>(value.size());
+            out.append(reinterpret_cast<const char*>(value.data()), value.size());
+            std::memcpy(out.data() + sizeof(snapshot_header) + idx * sizeof(snapshot_entry), &entry, sizeof(entry));
+            ++idx;
+        }
+        return out;
+    }
+
+    bool
+    write_snapshot(const fs::path& path, std::string_view bytes)
+    {
+        //! Written next to the target then renamed over it, a torn write never replaces a valid snapshot
+        const auto tmp_path = fs::path(path).replace_extension(".tmp");
+        {
+            std::ofstream ofs(tmp_path.string(), std::ios::out | std::ios::trunc | std::ios::binary);
+            ofs.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            if (!ofs.good())
+            {
+                return false;
+            }
+        }
+        fs_error_code ec;
+        fs::rename(tmp_path, path, ec);
+        return !ec;
+    }
+} // namespace
+
+namespace atomic_dex
+{
+    struct coins_cfg_snapshot::storage
+    {
+        bip::mapped_region region; ///< snapshot read from disk
+        std::string        owned;  ///< snapshot compiled from the json
+        std::string_view   bytes;
+    };
+
+    coins_cfg_snapshot::coins_cfg_snapshot(std::shared_ptr<const storage> storage, bool is_compiled) :
+        m_storage(std::move(storage)), m_is_compiled(is_compiled)
+    {
+    }
+
+    coins_cfg_snapshot
+    coins_cfg_snapshot::compile(std::string_view json_content)
+    {
+        auto compiled   = std::make_shared<storage>();
+        compiled->owned = build_snapshot(json_content, content_hash(json_content));
+        compiled->bytes = compiled->owned;
+        return coins_cfg_snapshot(std::move(compiled), true);
+    }
+
+    coins_cfg_snapshot
+    coins_cfg_snapshot::open(const fs::path& source, const fs::path& snapshot_path)
+    {
+        fs_error_code ec;
+        const auto    source_size = fs::file_size(source, ec);
+        if (ec)
+        {
+            return {};
+        }
+        if (source_size == 0)
+        {
+            return compile(std::string_view{});
+        }
+
+        bip::file_mapping      source_mapping(source.string().c_str(), bip::read_only);
+        bip::mapped_region     source_region(source_mapping, bip::read_only);
+        const std::string_view source_content(static_cast<const char*>(source_region.get_address()), source_region.get_size());
+        const auto             source_hash = content_hash(source_content);
+
+        if (fs::file_size(snapshot_path, ec) >= sizeof(snapshot_header) && !ec)
+        {
+            try
+            {
+                bip::file_mapping mapping(snapshot_path.string().c_str(), bip::read_only);
+                auto              mapped = std::make_shared<storage>();
+                mapped->region           = bip::mapped_region(mapping, bip::read_only);
+                mapped->bytes            = std::string_view(static_cast<const char*>(mapped->region.get_address()), mapped->region.get_size());
+                if (is_valid_snapshot(mapped->bytes))
+                {
+                    const auto header = read_header(mapped->bytes);
+                    if (header.source_hash == source_hash && header.source_size == source_content.size())
+                    {
+                        return coins_cfg_snapshot(std::move(mapped), false);
+                    }
+                }
+            }
+            catch (const bip::interprocess_exception& error)
+            {
+                SPDLOG_WARN("Unable to map coins snapshot {}: {}", snapshot_path.string(), error.what());
+            }
+        }
+
+        //! The source changed since the last snapshot, or there is none yet
+        SPDLOG_INFO("compiling coins snapshot of {}", source.string());
+        auto compiled   = std::make_shared<storage>();
+        compiled->owned = build_snapshot(source_content, source_hash);
+        compiled->bytes = compiled->owned;
+        if (!write_snapshot(snapshot_path, compiled->bytes))
+        {
+            SPDLOG_WARN("Unable to write coins snapshot {}", snapshot_path.string());
+        }
+        return coins_cfg_snapshot(std::move(compiled), true);
+    }
+
+    std::size_t
+    coins_cfg_snapshot::size() const noexcept
+    {
+        return m_storage ? read_header(m_storage->bytes).nb_records : 0;
+    }
+
+    bool
+    coins_cfg_snapshot::empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    bool
+    coins_cfg_snapshot::is_compiled() const noexcept
+    {
+        return m_is_compiled;
+    }
+
+    std::string_view
+    coins_cfg_snapshot::data() const noexcept
+    {
+        return m_storage ? m_storage->bytes : std::string_view{};
+    }
+
+    std::string_view
+    coins_cfg_snapshot::key(std::size_t idx) const
+    {
+        const auto entry = read_entry(m_storage->bytes, idx);
+        return m_storage->bytes.substr(entry.key_offset, entry.key_size);
+    }
+
+    nlohmann::json
+    coins_cfg_snapshot::decode(std::size_t idx) const
+    {
+        const auto  entry = read_entry(m_storage->bytes, idx);
+        const auto* first = reinterpret_cast<const std::uint8_t*>(m_storage->bytes.data() + entry.value_offset);
+        return nlohmann::json::from_msgpack(first, first + entry.value_size);
+    }
+
+    std::optional<std::size_t>
+    coins_cfg_snapshot::find(std::string_view key) const
+    {
+        //! Binary search on the sorted index, nothing is decoded
+        std::size_t first = 0;
+        std::size_t last  = size();
+        while (first < last)
+        {
+            const std::size_t middle = first + (last - first) / 2;
+            const auto        cmp    = this->key(middle).compare(key);
+            if (cmp == 0)
+            {
+                return middle;
+            }
+            if (cmp < 0)
+            {
+                first = middle + 1;
+            }
+            else
+            {
+                last = middle;
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool
+    coins_cfg_snapshot::contains(std::string_view key) const
+    {
+        return find(key).has_value();
+    }
+
+    std::vector<std::string>
+    coins_cfg_snapshot::keys() const
+    {
+        std::vector<std::string> out;
+        out.reserve(size());
+        for (std::size_t idx = 0; idx < size(); ++idx) { out.emplace_back(key(idx)); }
+        return out;
+    }
+
+    std::optional<nlohmann::json>
+    coins_cfg_snapshot::get(std::string_view key) const
+    {
+        if (const auto idx = find(key); idx.has_value())
+        {
+            return decode(*idx);
+        }
+        return std::nullopt;
+    }
+
+    void
+    coins_cfg_snapshot::for_each(const t_record_functor& functor) const
+    {
+        for (std::size_t idx = 0; idx < size(); ++idx) { functor(key(idx), decode(idx)); }
+    }
+} // namespace atomic_dex
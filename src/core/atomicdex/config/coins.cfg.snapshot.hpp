@@ -0,0 +1,92 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//! Deps
+#include <nlohmann/json.hpp>
+
+//! Project Headers
+#include "atomicdex/utilities/fs.prerequisites.hpp"
+
+namespace atomic_dex
+{
+    //! Binary snapshot of a coins file: the mm2 `coins.json` (array of coins keyed by `coin`), or a wallet coins / custom tokens file (object keyed by ticker).
+    //! The snapshot is keyed by the content hash of the source file, the json is only parsed when the source changed since the snapshot was compiled.
+    //! A snapshot file is a fixed header, an index sorted by key, then the keys and the records encoded as MessagePack, in native byte order.
+    //! The file is memory mapped, a record is only decoded when it is asked for. Immutable once opened, safe to share between threads.
+    class coins_cfg_snapshot
+    {
+      public:
+        using t_record_functor = std::function<void(std::string_view key, nlohmann::json&& record)>;
+
+        coins_cfg_snapshot() = default;
+
+        //! Maps the snapshot of `source`, compiled again from the json when its content changed, the snapshot file is then rewritten.
+        //! Empty when `source` does not exist, throws if the json has to be parsed and is not a valid coins file.
+        static coins_cfg_snapshot open(const fs::path& source, const fs::path& snapshot_path);
+
+        //! Compiles the snapshot of a json coins file content, throws if it is not a valid coins file.
+        static coins_cfg_snapshot compile(std::string_view json_content);
+
+        [[nodiscard]] std::size_t              size() const noexcept;
+        [[nodiscard]] bool                     empty() const noexcept;
+        [[nodiscard]] bool                     contains(std::string_view key) const;
+        [[nodiscard]] std::vector<std::string> keys() const;
+        [[nodiscard]] bool                     is_compiled() const noexcept; ///< the json was parsed by open() because the source changed
+
+        //! Decodes a single record, nullopt if the key is unknown.
+        [[nodiscard]] std::optional<nlohmann::json> get(std::string_view key) const;
+
+        //! Decodes every record in key order.
+        void for_each(const t_record_functor& functor) const;
+
+        template <typename T>
+        [[nodiscard]] std::unordered_map<std::string, T>
+        decode_all() const
+        {
+            std::unordered_map<std::string, T> out;
+            out.reserve(size());
+            for_each([&out](std::string_view key, nlohmann::json&& record) { out.emplace(std::string(key), record.get<T>()); });
+            return out;
+        }
+
+        //! Raw content of the snapshot, as written on disk.
+        [[nodiscard]] std::string_view data() const noexcept;
+
+      private:
+        struct storage;
+
+        coins_cfg_snapshot(std::shared_ptr<const storage> storage, bool is_compiled);
+
+        [[nodiscard]] std::string_view           key(std::size_t idx) const;
+        [[nodiscard]] nlohmann::json             decode(std::size_t idx) const;
+        [[nodiscard]] std::optional<std::size_t> find(std::string_view key) const;
+
+        std::shared_ptr<const storage> m_storage;
+        bool                           m_is_compiled{false};
+    };
+} // namespace atomic_dex
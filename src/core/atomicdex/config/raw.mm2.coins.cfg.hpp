@@ -10,6 +10,7 @@
 
 //! Project
 #include "atomicdex/api/mm2/mm2.constants.hpp"
+#include "atomicdex/config/coins.cfg.snapshot.hpp"
 #include "atomicdex/utilities/fs.prerequisites.hpp"
 #include "atomicdex/utilities/global.utilities.hpp"
 #include "atomicdex/utilities/qt.utilities.hpp"
@@ -238,12 +239,12 @@ namespace atomic_dex
         j["protocol"] = x.protocol;
     }
 
-    inline t_mm2_raw_coins_registry
-    parse_raw_mm2_coins_file()
+    //! The json is only parsed when coins.json changed since the last start, its records are decoded on demand
+    inline coins_cfg_snapshot
+    open_raw_mm2_coins_snapshot()
     {
-        SPDLOG_INFO("parse_raw_mm2_coins_file");
-        t_mm2_raw_coins_registry out;
-        fs::path                 file_path{atomic_dex::utils::get_current_configs_path() / "coins.json"};
+        SPDLOG_INFO("open_raw_mm2_coins_snapshot");
+        fs::path file_path{atomic_dex::utils::get_current_configs_path() / "coins.json"};
         if (not fs::exists(file_path))
         {
             fs::path original_mm2_coins_path{ag::core::assets_real_path() / "tools" / "mm2" / "coins"};
@@ -253,27 +254,18 @@ namespace atomic_dex
             fs::copy_file(original_mm2_coins_path, file_path, get_override_options());
         }
 
-        QFile file;
-        file.setFileName(std_path_to_qstring(file_path));
-        file.open(QIODevice::ReadOnly | QIODevice::Text);
-        QString val = file.readAll();
-        file.close();
-
         try
         {
-            nlohmann::json j = nlohmann::json::parse(val.toStdString());
-            // ifs >> j;
-            t_mm2_raw_coins coins = j;
-            out.reserve(coins.size());
-            for (auto&& coin: coins) { out[coin.coin] = coin; }
-            LOG_PATH("successfully parsed: {}", file_path);
-            SPDLOG_INFO("coins size mm2: {}", coins.size());
+            auto snapshot = coins_cfg_snapshot::open(file_path, utils::get_atomic_dex_coins_cfg_cache_folder() / "coins.json.snapshot");
+            LOG_PATH("successfully loaded: {}", file_path);
+            SPDLOG_INFO("coins size mm2: {}, compiled: {}", snapshot.size(), snapshot.is_compiled());
+            return snapshot;
         }
         catch (const std::exception& error)
         {
             SPDLOG_ERROR("parse error: {}", error.what());
             LOG_PATH("cannot parse mm2 raw cfg file: {}", file_path);
         }
-        return out;
+        return {};
     }
 } // namespace atomic_dex
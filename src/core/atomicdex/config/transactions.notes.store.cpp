@@ -0,0 +1,172 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <cstdint>
+#include <mutex>
+
+//! Deps
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+//! Project Headers
+#include "atomicdex/config/transactions.notes.store.hpp"
+
+namespace atomic_dex
+{
+    void
+    transactions_notes_store::open(t_notes notes, fs::path journal_path)
+    {
+        std::unique_lock lock(m_mutex);
+        m_notes        = std::move(notes);
+        m_journal_path = std::move(journal_path);
+        m_journal_size = 0;
+        replay_journal();
+        if (m_journal.is_open())
+        {
+            m_journal.close();
+        }
+        m_journal.open(m_journal_path.string(), std::ios::out | std::ios::app);
+        if (!m_journal.is_open())
+        {
+            SPDLOG_ERROR("cannot open the transactions notes journal: {}", m_journal_path.string());
+        }
+    }
+
+    void
+    transactions_notes_store::close()
+    {
+        std::unique_lock lock(m_mutex);
+        if (m_journal.is_open())
+        {
+            m_journal.close();
+        }
+        m_notes.clear();
+        m_journal_size = 0;
+    }
+
+    void
+    transactions_notes_store::replay_journal()
+    {
+        std::ifstream  ifs(m_journal_path.string(), std::ios::binary);
+        std::string    line;
+        std::uintmax_t valid_bytes = 0;
+        bool           torn        = false;
+        while (std::getline(ifs, line))
+        {
+            //! The last line may be truncated if the app was killed while writing it, nothing after it can be trusted
+            auto entry = nlohmann::json::parse(line, nullptr, false);
+            if (ifs.eof() || entry.is_discarded() || !entry.contains("tx_hash") || !entry.contains("note"))
+            {
+                torn = true;
+                break;
+            }
+            valid_bytes += line.size() + 1;
+            if (!entry.at("tx_hash").is_string() || !entry.at("note").is_string())
+            {
+                //! A complete line written by something else, skipped but kept in place
+                SPDLOG_WARN("skipping a transactions notes journal entry without string fields: {}", line);
+                continue;
+            }
+            m_notes[entry.at("tx_hash").get<std::string>()].note = entry.at("note").get<std::string>();
+            m_journal_size += 1;
+        }
+        ifs.close();
+
+        if (torn)
+        {
+            //! Drop the torn tail, the next edits would be appended after it and never replayed
+            SPDLOG_WARN("invalid entry in the transactions notes journal, {} entries replayed", m_journal_size);
+            fs_error_code ec;
+            fs::resize_file(m_journal_path, valid_bytes, ec);
+        }
+    }
+
+    std::string
+    transactions_notes_store::note(const std::string& tx_hash) const
+    {
+        std::shared_lock lock(m_mutex);
+        const auto       it = m_notes.find(tx_hash);
+        return it != m_notes.cend() ? it->second.note : std::string{};
+    }
+
+    std::vector<std::string>
+    transactions_notes_store::notes(const std::vector<std::string>& tx_hashes) const
+    {
+        std::vector<std::string> out(tx_hashes.size());
+        std::shared_lock         lock(m_mutex);
+        if (m_notes.empty())
+        {
+            return out;
+        }
+        for (std::size_t idx = 0; idx < tx_hashes.size(); ++idx)
+        {
+            if (const auto it = m_notes.find(tx_hashes[idx]); it != m_notes.cend())
+            {
+                out[idx] = it->second.note;
+            }
+        }
+        return out;
+    }
+
+    bool
+    transactions_notes_store::set_note(const std::string& tx_hash, const std::string& note)
+    {
+        const std::string line = nlohmann::json{{"tx_hash", tx_hash}, {"note", note}}.dump();
+
+        std::unique_lock lock(m_mutex);
+        m_notes[tx_hash].note = note;
+        if (!m_journal.is_open())
+        {
+            return false;
+        }
+        m_journal << line << '\n';
+        m_journal.flush();
+        m_journal_size += 1;
+        return m_journal.good();
+    }
+
+    bool
+    transactions_notes_store::compact(const std::function<bool(const t_notes&)>& write)
+    {
+        std::unique_lock lock(m_mutex);
+        if (!write(m_notes))
+        {
+            return false;
+        }
+        if (m_journal.is_open())
+        {
+            m_journal.close();
+        }
+        m_journal.open(m_journal_path.string(), std::ios::out | std::ios::trunc);
+        m_journal_size = 0;
+        return true;
+    }
+
+    std::size_t
+    transactions_notes_store::journal_size() const
+    {
+        std::shared_lock lock(m_mutex);
+        return m_journal_size;
+    }
+
+    std::size_t
+    transactions_notes_store::size() const
+    {
+        std::shared_lock lock(m_mutex);
+        return m_notes.size();
+    }
+} // namespace atomic_dex
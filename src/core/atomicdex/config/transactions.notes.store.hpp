@@ -0,0 +1,73 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//! Project Headers
+#include "atomicdex/config/wallet.cfg.hpp"
+#include "atomicdex/utilities/fs.prerequisites.hpp"
+
+namespace atomic_dex
+{
+    //! Journal entries after which the owner should compact the journal into the wallet file.
+    inline constexpr std::size_t g_notes_journal_compaction_threshold{256};
+
+    //! Transactions notes of the logged wallet, readable concurrently from the mm2 threads.
+    //! Edits are appended to a journal (one json line per edit) instead of rewriting the whole wallet file,
+    //! the journal is replayed on top of the wallet file notes when the store is opened.
+    class transactions_notes_store
+    {
+      public:
+        using t_notes = wallet_cfg::t_transactions_details;
+
+        //! `notes` come from the wallet file, the journal entries not yet compacted are applied over them.
+        void open(t_notes notes, fs::path journal_path);
+        void close();
+
+        [[nodiscard]] std::string note(const std::string& tx_hash) const;
+
+        //! One lookup under a single shared lock, the result is aligned with `tx_hashes` ("" for a transaction without note).
+        [[nodiscard]] std::vector<std::string> notes(const std::vector<std::string>& tx_hashes) const;
+
+        //! Returns false if the edit could not be appended to the journal, it is kept in memory anyway.
+        bool set_note(const std::string& tx_hash, const std::string& note);
+
+        //! `write(notes)` rewrites the wallet file with every note, on success the journal is emptied.
+        //! Edits are held until it returns so none can fall between the file and the journal.
+        bool compact(const std::function<bool(const t_notes&)>& write);
+
+        [[nodiscard]] std::size_t journal_size() const; ///< edits appended since the last compaction
+        [[nodiscard]] std::size_t size() const;
+
+      private:
+        void replay_journal();
+
+        mutable std::shared_mutex m_mutex;
+        t_notes                   m_notes;
+        fs::path                  m_journal_path;
+        std::ofstream             m_journal;
+        std::size_t               m_journal_size{0};
+    };
+} // namespace atomic_dex
@@ -32,7 +32,7 @@ namespace atomic_dex
         }
         if (j.contains("transactions_details"))
         {
-            cfg.transactions_details = j.at("transactions_details").get<decltype(cfg.transactions_details)::value_type>();
+            j.at("transactions_details").get_to(cfg.transactions_details);
         }
     }
 
@@ -41,7 +41,7 @@ namespace atomic_dex
     {
         j["name"]                 = cfg.name;
         j["protection_pass"]      = cfg.protection_pass;
-        j["transactions_details"] = cfg.transactions_details.get();
+        j["transactions_details"] = cfg.transactions_details;
     }
 
     void
@@ -17,11 +17,11 @@
 #pragma once
 
 //! STD
+#include <string>
 #include <unordered_map>
 
 //! Deps
 #include <nlohmann/json_fwd.hpp>
-#include <boost/thread/synchronized_value.hpp>
 
 namespace atomic_dex
 {
@@ -36,10 +36,10 @@ namespace atomic_dex
 
     struct wallet_cfg
     {
-        using t_synchronized_transactions_details = boost::synchronized_value<std::unordered_map<std::string, transactions_contents>>;
-        std::string                         name{};
-        std::string                         protection_pass{"default_protection_pass"};
-        t_synchronized_transactions_details transactions_details;
+        using t_transactions_details = std::unordered_map<std::string, transactions_contents>;
+        std::string            name{};
+        std::string            protection_pass{"default_protection_pass"};
+        t_transactions_details transactions_details; ///< as read from the wallet file, owned by the transactions_notes_store once logged in
     };
 
     void from_json(const nlohmann::json& j, wallet_cfg& cfg);
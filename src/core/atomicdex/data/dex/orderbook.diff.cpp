@@ -0,0 +1,72 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+#include <string_view>
+#include <unordered_set>
+
+//! Project Headers
+#include "atomicdex/data/dex/orderbook.diff.hpp"
+
+namespace atomic_dex
+{
+    void
+    reset_orderbook_row_index(keyed_row_index& index, const t_orderbook_columns& rows)
+    {
+        index.reset(rows.uuids(), [](const std::string& uuid) { return uuid; });
+    }
+
+    orderbook_diff
+    compute_orderbook_diff(const t_orderbook_columns& current, const keyed_row_index& index, const t_orderbook_columns& next)
+    {
+        orderbook_diff                       out;
+        std::unordered_set<std::string_view> next_uuids;
+        next_uuids.reserve(next.size());
+
+        for (std::size_t idx = 0; idx < next.size(); ++idx)
+        {
+            const auto& uuid = next.uuid(idx);
+            if (!next_uuids.emplace(uuid).second)
+            {
+                continue; ///< duplicated uuid in the snapshot, the first one wins
+            }
+            if (const auto row = index.find(uuid); row)
+            {
+                if (!current.same_order(*row, next, idx))
+                {
+                    out.changed.push_back(idx);
+                }
+            }
+            else
+            {
+                out.inserted.push_back(idx);
+            }
+        }
+
+        std::vector<std::size_t> removed_rows;
+        for (std::size_t row = 0; row < current.size(); ++row)
+        {
+            if (!next_uuids.contains(current.uuid(row)))
+            {
+                removed_rows.push_back(row);
+            }
+        }
+        out.removed = to_row_ranges(std::move(removed_rows));
+        std::reverse(out.removed.begin(), out.removed.end());
+        return out;
+    }
+} // namespace atomic_dex
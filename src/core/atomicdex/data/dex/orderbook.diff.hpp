@@ -0,0 +1,44 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <string>
+#include <vector>
+
+//! Project Headers
+#include "atomicdex/api/mm2/orderbook.columns.hpp"
+#include "atomicdex/utilities/keyed.row.index.hpp"
+
+namespace atomic_dex
+{
+    //! Difference between the rows of an orderbook model and a new orderbook snapshot.
+    struct orderbook_diff
+    {
+        std::vector<t_row_range> removed;  ///< rows of the current snapshot to remove, highest range first
+        std::vector<std::size_t> changed;  ///< indexes in the next snapshot of orders already present with different values
+        std::vector<std::size_t> inserted; ///< indexes in the next snapshot of new orders
+
+        [[nodiscard]] bool empty() const noexcept { return removed.empty() && changed.empty() && inserted.empty(); }
+    };
+
+    //! uuid -> row
+    void reset_orderbook_row_index(keyed_row_index& index, const t_orderbook_columns& rows);
+
+    //! O(current + next), `index` must map every uuid of `current` to its row.
+    orderbook_diff compute_orderbook_diff(const t_orderbook_columns& current, const keyed_row_index& index, const t_orderbook_columns& next);
+} // namespace atomic_dex
@@ -25,6 +25,16 @@
 //! Project Headers
 #include "atomicdex/managers/qt.wallet.manager.hpp"
 
+namespace
+{
+    fs::path
+    notes_journal_path(const std::string& wallet_name)
+    {
+        using namespace std::string_literals;
+        return atomic_dex::utils::get_atomic_dex_export_folder() / (wallet_name + ".wallet.notes.journal"s);
+    }
+} // namespace
+
 namespace atomic_dex
 {
     QString
@@ -97,6 +107,13 @@ namespace atomic_dex
             wallet_object_json["name"] = wallet_name.toStdString();
             wallet_object.write(QString::fromStdString(wallet_object_json.dump(4)).toUtf8());
             wallet_object.close();
+
+            //! A journal left by a deleted wallet of the same name must not be replayed over the new one
+            if (const fs::path journal_path = notes_journal_path(wallet_name.toStdString()); fs::exists(journal_path))
+            {
+                fs_error_code ec;
+                fs::resize_file(journal_path, 0, ec);
+            }
             LOG_PATH("Successfully write file: {}", wallet_object_path);
             SPDLOG_INFO("Successfully write the data: {}", wallet_object_json.dump());
 
@@ -152,6 +169,8 @@ namespace atomic_dex
     qt_wallet_manager::delete_wallet(const QString& wallet_name)
     {
         using namespace std::string_literals;
+        fs_error_code ec;
+        fs::remove(notes_journal_path(wallet_name.toStdString()), ec);
         return fs::remove(utils::get_atomic_dex_config_folder() / (wallet_name.toStdString() + ".seed"s));
     }
 
@@ -195,16 +214,27 @@ namespace atomic_dex
             return false;
         }
         nlohmann::json j = nlohmann::json::parse(QString(ifs.readAll()).toStdString());
+        ifs.close();
         m_wallet_cfg = j;
         //SPDLOG_INFO("wallet_cfg: {}", j.dump(4));
+
+        m_notes_store.open(std::move(m_wallet_cfg.transactions_details), notes_journal_path(wallet_name));
+        m_wallet_cfg.transactions_details.clear();
+        if (m_notes_store.journal_size() > 0)
+        {
+            //! Fold the edits of the previous session into the wallet file
+            update_wallet_cfg();
+        }
         return true;
     }
 
     void
     qt_wallet_manager::update_transactions_notes(const std::string& tx_hash, const std::string& notes)
     {
-        m_wallet_cfg.transactions_details->operator[](tx_hash).note = notes;
-        this->update_wallet_cfg();
+        if (!m_notes_store.set_note(tx_hash, notes) || m_notes_store.journal_size() >= g_notes_journal_compaction_threshold)
+        {
+            this->update_wallet_cfg();
+        }
     }
 
     bool
@@ -213,20 +243,31 @@ namespace atomic_dex
         SPDLOG_INFO("update_wallet_cfg");
         using namespace std::string_literals;
         const fs::path wallet_object_path = utils::get_atomic_dex_export_folder() / (m_wallet_cfg.name + ".wallet.json"s);
-        QFile ofs;
-        ofs.setFileName(std_path_to_qstring(wallet_object_path));
-        ofs.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
+        return m_notes_store.compact(
+            [this, &wallet_object_path](const transactions_notes_store::t_notes& notes)
+            {
+                QFile ofs;
+                ofs.setFileName(std_path_to_qstring(wallet_object_path));
+                ofs.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
 
-        if (not ofs.isOpen())
-        {
-            return false;
-        }
+                if (not ofs.isOpen())
+                {
+                    return false;
+                }
 
-        nlohmann::json j;
-        atomic_dex::to_json(j, m_wallet_cfg);
-        ofs.write(QString::fromStdString(j.dump(4)).toUtf8());
-        ofs.close();
-        return true;
+                nlohmann::json j;
+                atomic_dex::to_json(j, m_wallet_cfg);
+                j["transactions_details"] = notes;
+                ofs.write(QString::fromStdString(j.dump(4)).toUtf8());
+                ofs.close();
+                return true;
+            });
+    }
+
+    void
+    qt_wallet_manager::close_transactions_notes()
+    {
+        m_notes_store.close();
     }
 
     void
@@ -258,13 +299,13 @@ namespace atomic_dex
     std::string
     qt_wallet_manager::retrieve_transactions_notes(const std::string& tx_hash) const
     {
-        std::string note     = "";
-        auto        registry = m_wallet_cfg.transactions_details.get();
-        if (registry.find(tx_hash) != registry.end())
-        {
-            note = registry.at(tx_hash).note;
-        }
-        return note;
+        return m_notes_store.note(tx_hash);
+    }
+
+    std::vector<std::string>
+    qt_wallet_manager::retrieve_transactions_notes(const std::vector<std::string>& tx_hashes) const
+    {
+        return m_notes_store.notes(tx_hashes);
     }
 
     bool
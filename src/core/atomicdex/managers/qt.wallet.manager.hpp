@@ -23,6 +23,7 @@
 #include <QVector>
 
 //! Project Headers
+#include "atomicdex/config/transactions.notes.store.hpp"
 #include "atomicdex/config/wallet.cfg.hpp"
 #include "atomicdex/services/mm2/mm2.service.hpp"
 #include "atomicdex/utilities/security.utilities.hpp"
@@ -42,6 +43,7 @@ namespace atomic_dex
         //! Private fields
         ag::ecs::system_manager& m_system_manager;
         wallet_cfg               m_wallet_cfg;
+        transactions_notes_store m_notes_store;
         QString                  m_current_default_wallet{""};
         QString                  m_current_status{"None"};
         bool                     m_login_status{false};
@@ -79,8 +81,10 @@ namespace atomic_dex
         //! API
         static bool is_there_a_default_wallet() ;
         void        just_set_wallet_name(QString wallet_name);
-        std::string retrieve_transactions_notes(const std::string& tx_hash) const;
-        void        update_transactions_notes(const std::string& tx_hash, const std::string& notes);
+        std::string              retrieve_transactions_notes(const std::string& tx_hash) const;
+        std::vector<std::string> retrieve_transactions_notes(const std::vector<std::string>& tx_hashes) const; ///< aligned with tx_hashes
+        void                     update_transactions_notes(const std::string& tx_hash, const std::string& notes);
+        void                     close_transactions_notes(); ///< on logout, the journal is released until the next login
 
         //! Override
         void update()  override;
@@ -33,6 +33,70 @@ namespace
             model.setData(idx, value, role);
         }
     }*/
+
+    using atomic_dex::orderbook_model;
+
+    std::optional<atomic_dex::t_order_number>
+    number_of(int role)
+    {
+        using atomic_dex::t_order_number;
+        switch (role)
+        {
+        case orderbook_model::PriceRole:
+            return t_order_number::price;
+        case orderbook_model::QuantityRole:
+            return t_order_number::max_volume;
+        case orderbook_model::TotalRole:
+            return t_order_number::total;
+        case orderbook_model::PercentDepthRole:
+            return t_order_number::depth_percent;
+        case orderbook_model::BaseMinVolumeRole:
+            return t_order_number::base_min_volume;
+        case orderbook_model::BaseMaxVolumeRole:
+            return t_order_number::base_max_volume;
+        case orderbook_model::RelMinVolumeRole:
+            return t_order_number::rel_min_volume;
+        case orderbook_model::RelMaxVolumeRole:
+            return t_order_number::rel_max_volume;
+        default:
+            return std::nullopt;
+        }
+    }
+
+    std::optional<atomic_dex::t_order_text>
+    text_of(int role)
+    {
+        using atomic_dex::t_order_text;
+        switch (role)
+        {
+        case orderbook_model::PriceDenomRole:
+            return t_order_text::price_denom;
+        case orderbook_model::PriceNumerRole:
+            return t_order_text::price_numer;
+        case orderbook_model::QuantityDenomRole:
+            return t_order_text::max_volume_denom;
+        case orderbook_model::QuantityNumerRole:
+            return t_order_text::max_volume_numer;
+        case orderbook_model::BaseMinVolumeDenomRole:
+            return t_order_text::base_min_volume_denom;
+        case orderbook_model::BaseMinVolumeNumerRole:
+            return t_order_text::base_min_volume_numer;
+        case orderbook_model::BaseMaxVolumeDenomRole:
+            return t_order_text::base_max_volume_denom;
+        case orderbook_model::BaseMaxVolumeNumerRole:
+            return t_order_text::base_max_volume_numer;
+        case orderbook_model::RelMinVolumeDenomRole:
+            return t_order_text::rel_min_volume_denom;
+        case orderbook_model::RelMinVolumeNumerRole:
+            return t_order_text::rel_min_volume_numer;
+        case orderbook_model::RelMaxVolumeDenomRole:
+            return t_order_text::rel_max_volume_denom;
+        case orderbook_model::RelMaxVolumeNumerRole:
+            return t_order_text::rel_max_volume_numer;
+        default:
+            return std::nullopt;
+        }
+    }
 } // namespace
 
 namespace atomic_dex
@@ -76,84 +140,50 @@ namespace atomic_dex
             return {};
         }
 
+        const auto row = static_cast<std::size_t>(index.row());
+        if (const auto field = number_of(role); field)
+        {
+            return display(row, *field);
+        }
+        if (const auto field = text_of(role); field)
+        {
+            const auto text = m_model_data.text(row, *field);
+            return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+        }
+
         switch (static_cast<OrderbookRoles>(role))
         {
-        case PriceRole:
-            return QString::fromStdString(m_model_data.at(index.row()).price);
         case CoinRole:
         {
             if (m_current_orderbook_kind == kind::best_orders)
             {
-                const auto coin = m_model_data.at(index.row()).rel_coin.value();
-                return QString::fromStdString(coin);
+                return QString::fromStdString(m_model_data.rel_coin(row));
             }
-            return QString::fromStdString(m_model_data.at(index.row()).coin);
+            return QString::fromStdString(m_model_data.coin(row));
         }
         case NameAndTicker:
         {
             if (m_current_orderbook_kind == kind::best_orders)
             {
-                const auto  coin         = m_model_data.at(index.row()).rel_coin.value();
+                const auto& coin         = m_model_data.rel_coin(row);
                 const auto& portfolio_pg = m_system_mgr.get_system<portfolio_page>();
                 const auto  cfg          = portfolio_pg.get_global_cfg()->get_coin_info(coin);
                 return QString::fromStdString(coin + cfg.name);
             }
-            return QString::fromStdString(m_model_data.at(index.row()).coin);
-        }
-        case PriceDenomRole:
-            return QString::fromStdString(m_model_data.at(index.row()).price_fraction_denom);
-        case PriceNumerRole:
-            return QString::fromStdString(m_model_data.at(index.row()).price_fraction_numer);
-        case QuantityRole:
-            return QString::fromStdString(m_model_data.at(index.row()).maxvolume);
-        case TotalRole:
-            return QString::fromStdString(m_model_data.at(index.row()).total);
+            return QString::fromStdString(m_model_data.coin(row));
+        }
         case UUIDRole:
-            return QString::fromStdString(m_model_data.at(index.row()).uuid);
+            return QString::fromStdString(m_model_data.uuid(row));
         case IsMineRole:
-            return m_model_data.at(index.row()).is_mine;
-        case PercentDepthRole:
-            return QString::fromStdString(m_model_data.at(index.row()).depth_percent);
-        case QuantityDenomRole:
-            return QString::fromStdString(m_model_data.at(index.row()).max_volume_fraction_denom);
-        case QuantityNumerRole:
-            return QString::fromStdString(m_model_data.at(index.row()).max_volume_fraction_numer);
-        case BaseMinVolumeRole:
-            return QString::fromStdString(m_model_data.at(index.row()).base_min_volume);
-        case BaseMinVolumeDenomRole:
-            return QString::fromStdString(m_model_data.at(index.row()).base_min_volume_denom);
-        case BaseMinVolumeNumerRole:
-            return QString::fromStdString(m_model_data.at(index.row()).base_min_volume_numer);
-        case BaseMaxVolumeRole:
-            return QString::fromStdString(m_model_data.at(index.row()).base_max_volume);
-        case BaseMaxVolumeDenomRole:
-            return QString::fromStdString(m_model_data.at(index.row()).base_max_volume_denom);
-        case BaseMaxVolumeNumerRole:
-            return QString::fromStdString(m_model_data.at(index.row()).base_max_volume_numer);
-        case RelMinVolumeRole:
-            return QString::fromStdString(m_model_data.at(index.row()).rel_min_volume);
-        case RelMinVolumeDenomRole:
-            return QString::fromStdString(m_model_data.at(index.row()).rel_min_volume_denom);
-        case RelMinVolumeNumerRole:
-            return QString::fromStdString(m_model_data.at(index.row()).rel_min_volume_numer);
-        case RelMaxVolumeRole:
-            return QString::fromStdString(m_model_data.at(index.row()).rel_max_volume);
-        case RelMaxVolumeDenomRole:
-            return QString::fromStdString(m_model_data.at(index.row()).rel_max_volume_denom);
-        case RelMaxVolumeNumerRole:
-            return QString::fromStdString(m_model_data.at(index.row()).rel_max_volume_numer);
+            return m_model_data.is_mine(row);
         case MinVolumeRole:
-        {
-            const bool is_asks = m_current_orderbook_kind == kind::asks;
-            return QString::fromStdString(is_asks ? m_model_data.at(index.row()).rel_min_volume : m_model_data.at(index.row()).base_min_volume);
-        }
+            return display(row, min_volume_field());
         case EnoughFundsToPayMinVolume:
         {
             bool        i_have_enough_funds = true;
-            const auto& order_model_data    = m_model_data.at(index.row());
             const auto& trading_pg          = m_system_mgr.get_system<trading_page>();
             const bool  is_asks             = m_current_orderbook_kind == kind::asks;
-            const auto  min_volume_f        = safe_float(is_asks ? order_model_data.rel_min_volume : order_model_data.base_min_volume);
+            const auto& min_volume_f        = m_model_data.number(row, min_volume_field());
             auto        taker_vol_std =
                 ((is_asks) ? trading_pg.get_orderbook_wrapper()->get_rel_max_taker_vol() : trading_pg.get_orderbook_wrapper()->get_base_max_taker_vol())
                     .toJsonObject()["decimal"]
@@ -164,8 +194,8 @@ namespace atomic_dex
                 taker_vol_std = "0";
             }
             // t_float_50 mm2_min_trade_vol = safe_float(trading_pg.get_mm2_min_trade_vol().toStdString());
-            t_float_50 taker_vol = safe_float(taker_vol_std);
-            i_have_enough_funds  = min_volume_f > 0 && taker_vol > min_volume_f;
+            const t_fixed_decimal taker_vol = safe_decimal(taker_vol_std);
+            i_have_enough_funds             = min_volume_f > t_fixed_decimal(0) && taker_vol > min_volume_f;
             return i_have_enough_funds;
         }
         case CEXRatesRole:
@@ -175,7 +205,7 @@ namespace atomic_dex
             const auto* market_selector = trading_pg.get_market_pairs_mdl();
             const auto& base            = market_selector->get_left_selected_coin().toStdString();
             const auto& rel             = data(index, CoinRole).toString().toStdString();
-            const auto& price           = m_model_data.at(index.row()).price;
+            const auto  price           = m_model_data.number(row, t_order_number::price).str();
             if (base == rel)
             {
                 return "0";
@@ -197,16 +227,15 @@ namespace atomic_dex
         {
             if (m_current_orderbook_kind == kind::best_orders)
             {
-                const auto& data         = m_model_data.at(index.row());
                 const auto& trading_pg   = m_system_mgr.get_system<trading_page>();
                 t_float_50  volume_f     = safe_float(trading_pg.get_volume().toStdString());
                 const bool  is_buy       = trading_pg.get_market_mode() == MarketMode::Buy;
                 const auto  trading_mode = trading_pg.get_current_trading_mode();
                 if (!is_buy && trading_mode == TradingMode::Simple)
                 {
-                    volume_f = safe_float(data.base_max_volume);
+                    volume_f = safe_float(m_model_data.number(row, t_order_number::base_max_volume).str());
                 }
-                t_float_50 total_amount_f = volume_f * safe_float(data.price);
+                t_float_50 total_amount_f = volume_f * safe_float(m_model_data.number(row, t_order_number::price).str());
                 const auto total_amount   = atomic_dex::utils::format_float(total_amount_f);
                 return QString::fromStdString(total_amount);
             }
@@ -244,7 +273,56 @@ namespace atomic_dex
             auto        infos      = global_cfg->get_coin_info(data(index, CoinRole).toString().toStdString());
             return infos.coingecko_id != "test-coin" || infos.coinpaprika_id != "test-coin";
         }
+        default:
+            break;
         }
+        return {};
+    }
+
+    QString
+    orderbook_model::display(std::size_t row, t_order_number field) const
+    {
+        auto& cached = m_display_cache[row][static_cast<std::size_t>(field)];
+        if (cached.isNull())
+        {
+            cached = QString::fromStdString(m_model_data.display(row, field));
+        }
+        return cached;
+    }
+
+    t_order_number
+    orderbook_model::min_volume_field() const
+    {
+        //! The taker pays the min volume in rel on the asks and in base on the bids
+        return m_current_orderbook_kind == kind::asks ? t_order_number::rel_min_volume : t_order_number::base_min_volume;
+    }
+
+    void
+    orderbook_model::store_number(std::size_t row, t_order_number field, const std::string& value)
+    {
+        if (auto value_f = t_fixed_decimal::from_string(value); value_f.has_value())
+        {
+            m_model_data.set_number(row, field, value_f.value());
+        }
+        else
+        {
+            m_model_data.set_number(row, field, t_fixed_decimal(0));
+            m_model_data.set_out_of_range(row, field, value);
+        }
+        m_display_cache[row][static_cast<std::size_t>(field)] = QString();
+    }
+
+    orderbook_model::t_computed_row
+    orderbook_model::computed_values(std::size_t row) const
+    {
+        const auto idx = index(static_cast<int>(row), 0);
+        return {data(idx, EnoughFundsToPayMinVolume), data(idx, CEXRatesRole), data(idx, SendRole), data(idx, PriceFiatRole)};
+    }
+
+    const t_fixed_decimal&
+    orderbook_model::get_price(int row) const
+    {
+        return m_model_data.number(static_cast<std::size_t>(row), t_order_number::price);
     }
 
     bool
@@ -254,93 +332,22 @@ namespace atomic_dex
         {
             return false;
         }
-        ::mm2::api::order_contents& order = m_model_data.at(index.row());
-        switch (static_cast<OrderbookRoles>(role))
+        const auto row = static_cast<std::size_t>(index.row());
+        if (const auto field = number_of(role); field)
         {
-        case PriceRole:
-            order.price = value.toString().toStdString();
-            break;
-        case PriceDenomRole:
-            order.price_fraction_denom = value.toString().toStdString();
-            break;
-        case PriceNumerRole:
-            order.price_fraction_denom = value.toString().toStdString();
-            break;
-        case IsMineRole:
-            order.is_mine = value.toBool();
-            break;
-        case QuantityRole:
-            order.maxvolume = value.toString().toStdString();
-            break;
-        case TotalRole:
-            order.total = value.toString().toStdString();
-            break;
-        case UUIDRole:
-            order.uuid = value.toString().toStdString();
-            break;
-        case PercentDepthRole:
-            order.depth_percent = value.toString().toStdString();
-            break;
-        case QuantityDenomRole:
-            order.max_volume_fraction_denom = value.toString().toStdString();
-            break;
-        case QuantityNumerRole:
-            order.max_volume_fraction_numer = value.toString().toStdString();
-            break;
-        case CoinRole:
-            order.coin = value.toString().toStdString();
-            break;
-        case MinVolumeRole:
-            order.min_volume = value.toString().toStdString();
-            break;
-        case NameAndTicker:
-            break;
-        case EnoughFundsToPayMinVolume:
-            break;
-        case CEXRatesRole:
-            break;
-        case SendRole:
-            break;
-        case PriceFiatRole:
-            break;
-        case HaveCEXIDRole:
-            break;
-        case BaseMinVolumeRole:
-            order.base_min_volume = value.toString().toStdString();
-            break;
-        case BaseMinVolumeDenomRole:
-            order.base_min_volume_denom = value.toString().toStdString();
-            break;
-        case BaseMinVolumeNumerRole:
-            order.base_min_volume_numer = value.toString().toStdString();
-            break;
-        case BaseMaxVolumeRole:
-            order.base_max_volume = value.toString().toStdString();
-            break;
-        case BaseMaxVolumeDenomRole:
-            order.base_max_volume_denom = value.toString().toStdString();
-            break;
-        case BaseMaxVolumeNumerRole:
-            order.base_max_volume_numer = value.toString().toStdString();
-            break;
-        case RelMinVolumeRole:
-            order.rel_min_volume = value.toString().toStdString();
-            break;
-        case RelMinVolumeDenomRole:
-            order.rel_min_volume_denom = value.toString().toStdString();
-            break;
-        case RelMinVolumeNumerRole:
-            order.rel_min_volume_numer = value.toString().toStdString();
-            break;
-        case RelMaxVolumeRole:
-            order.rel_max_volume = value.toString().toStdString();
-            break;
-        case RelMaxVolumeDenomRole:
-            order.rel_max_volume_denom = value.toString().toStdString();
-            break;
-        case RelMaxVolumeNumerRole:
-            order.rel_max_volume_numer = value.toString().toStdString();
-            break;
+            store_number(row, *field, value.toString().toStdString());
+        }
+        else if (const auto text_field = text_of(role); text_field)
+        {
+            m_model_data.set_text(row, *text_field, value.toString().toStdString());
+        }
+        else if (role == IsMineRole)
+        {
+            m_model_data.set_is_mine(row, value.toBool());
+        }
+        else if (role == MinVolumeRole)
+        {
+            store_number(row, min_volume_field(), value.toString().toStdString()); ///< same field as data()
         }
         // emit dataChanged(index, index, {role});
         return true;
@@ -381,7 +388,7 @@ namespace atomic_dex
     }
 
     void
-    orderbook_model::reset_orderbook(const t_orders_contents& orderbook)
+    orderbook_model::reset_orderbook(const t_orderbook_columns& orderbook)
     {
         if (!orderbook.empty())
         {
@@ -390,17 +397,19 @@ namespace atomic_dex
         }
         this->beginResetModel();
         m_model_data = orderbook;
-        m_orders_id_registry.clear();
-        for (auto&& order: m_model_data)
-        {
-            if (this->m_orders_id_registry.find(order.uuid) == m_orders_id_registry.end())
-            {
-                this->m_orders_id_registry.emplace(order.uuid);
-            }
-        }
+        m_display_cache.assign(m_model_data.size(), t_display_row{});
+        m_computed_cache.clear();
+        m_computed_cache.reserve(m_model_data.size());
+        for (std::size_t row = 0; row < m_model_data.size(); ++row) { m_computed_cache.push_back(computed_values(row)); }
+        reset_orderbook_row_index(m_orders_id_registry, m_model_data);
         this->endResetModel();
         emit lengthChanged();
-        assert(m_model_data.size() == m_orders_id_registry.size());
+    }
+
+    void
+    orderbook_model::reset_orderbook(const t_orders_contents& orderbook)
+    {
+        reset_orderbook(t_orderbook_columns(orderbook));
     }
 
     int
@@ -411,216 +420,220 @@ namespace atomic_dex
 
 
     void
-    orderbook_model::initialize_order(const ::mm2::api::order_contents& order)
+    orderbook_model::check_for_better_bid(const t_orderbook_columns& orderbook, std::size_t row, bool is_new_order)
     {
-        if (m_orders_id_registry.contains(order.uuid))
+        if (!m_system_mgr.has_system<trading_page>() || m_current_orderbook_kind != kind::bids)
+        {
+            return;
+        }
+        auto& trading_pg = m_system_mgr.get_system<trading_page>();
+        if (trading_pg.get_market_mode() != MarketMode::Sell)
+        {
+            return;
+        }
+        const auto preferred_order = trading_pg.get_preferred_order();
+        if (preferred_order.empty())
         {
-            SPDLOG_WARN("Order with uuid: {} already present...skipping.", order.uuid);
             return;
         }
 
-        assert(m_model_data.size() == m_orders_id_registry.size());
-        beginInsertRows(QModelIndex(), m_model_data.size(), m_model_data.size());
-        m_model_data.push_back(order);
-        this->m_orders_id_registry.emplace(order.uuid);
-        endInsertRows();
-        emit lengthChanged();
-        assert(m_model_data.size() == m_orders_id_registry.size());
-        if (m_system_mgr.has_system<trading_page>() && m_current_orderbook_kind == kind::bids)
+        const auto&           uuid            = orderbook.uuid(row);
+        const t_fixed_decimal price_std       = orderbook.number(row, t_order_number::price);
+        const t_fixed_decimal preferred_price = safe_decimal(preferred_order.value("price", "0").toString().toStdString());
+        if (price_std > preferred_price)
         {
-            auto& trading_pg = m_system_mgr.get_system<trading_page>();
-            if (trading_pg.get_market_mode() == MarketMode::Sell)
-            {
-                const auto preferred_order = trading_pg.get_preferred_order();
-                if (!preferred_order.empty())
-                {
-                    const t_float_50 price_std       = safe_float(order.price);
-                    t_float_50       preferred_price = safe_float(preferred_order.value("price", "0").toString().toStdString());
-                    if (price_std > preferred_price)
-                    {
-                        SPDLOG_INFO(
-                            "An order with a better price is inserted, uuid: {}, new_price: {}, current_price: {}", order.uuid, utils::format_float(price_std),
-                            utils::format_float(preferred_price));
-                        trading_pg.set_selected_order_status(SelectedOrderStatus::BetterPriceAvailable);
-                        emit betterOrderDetected(get_order_from_uuid(QString::fromStdString(order.uuid)));
-                    }
-                }
-            }
+            SPDLOG_INFO(
+                "An order with a better price is {}, uuid: {}, new_price: {}, current_price: {}", is_new_order ? "inserted" : "available", uuid,
+                utils::format_float(price_std), utils::format_float(preferred_price));
+            trading_pg.set_selected_order_status(SelectedOrderStatus::BetterPriceAvailable);
+            emit betterOrderDetected(get_order_from_uuid(QString::fromStdString(uuid)));
+        }
+        else if (auto selected_uuid = preferred_order.value("uuid", "").toString().toStdString(); !is_new_order && selected_uuid == uuid)
+        {
+            SPDLOG_INFO("The price went down with the selected order: {}", uuid);
+            check_for_better_order(trading_pg, preferred_order, selected_uuid);
         }
     }
 
     void
-    orderbook_model::update_order(const ::mm2::api::order_contents& order)
+    orderbook_model::apply_orderbook_diff(const t_orderbook_columns& orderbook, const orderbook_diff& diff)
     {
-        if (const auto res = this->match(index(0, 0), UUIDRole, QString::fromStdString(order.uuid)); not res.isEmpty())
-        {
-            //! ID Found, update !
-            const QModelIndex& idx                  = res.at(0);
-            const auto         uuid_to_be_updated   = this->data(idx, OrderbookRoles::UUIDRole).toString().toStdString();
-            auto&& [_, new_price, is_price_changed] = update_value(OrderbookRoles::PriceRole, QString::fromStdString(order.price), idx, *this);
-            update_value(OrderbookRoles::PriceNumerRole, QString::fromStdString(order.price_fraction_numer), idx, *this);
-            update_value(OrderbookRoles::PriceDenomRole, QString::fromStdString(order.price_fraction_denom), idx, *this);
-            update_value(OrderbookRoles::IsMineRole, order.is_mine, idx, *this);
-            update_value(OrderbookRoles::QuantityRole, QString::fromStdString(order.maxvolume), idx, *this);
-            update_value(OrderbookRoles::TotalRole, QString::fromStdString(order.total), idx, *this);
-            update_value(OrderbookRoles::PercentDepthRole, QString::fromStdString(order.depth_percent), idx, *this);
-            update_value(OrderbookRoles::BaseMinVolumeRole, QString::fromStdString(order.base_min_volume), idx, *this);
-            update_value(OrderbookRoles::BaseMinVolumeDenomRole, QString::fromStdString(order.base_min_volume_denom), idx, *this);
-            update_value(OrderbookRoles::BaseMinVolumeNumerRole, QString::fromStdString(order.base_min_volume_numer), idx, *this);
-            update_value(OrderbookRoles::BaseMaxVolumeRole, QString::fromStdString(order.base_max_volume), idx, *this);
-            update_value(OrderbookRoles::BaseMaxVolumeDenomRole, QString::fromStdString(order.base_max_volume_denom), idx, *this);
-            update_value(OrderbookRoles::BaseMaxVolumeNumerRole, QString::fromStdString(order.base_max_volume_numer), idx, *this);
-            update_value(OrderbookRoles::RelMinVolumeRole, QString::fromStdString(order.rel_min_volume), idx, *this);
-            update_value(OrderbookRoles::RelMinVolumeDenomRole, QString::fromStdString(order.rel_min_volume_denom), idx, *this);
-            update_value(OrderbookRoles::RelMinVolumeNumerRole, QString::fromStdString(order.rel_min_volume_numer), idx, *this);
-            update_value(OrderbookRoles::RelMaxVolumeRole, QString::fromStdString(order.rel_max_volume), idx, *this);
-            update_value(OrderbookRoles::RelMaxVolumeDenomRole, QString::fromStdString(order.rel_max_volume_denom), idx, *this);
-            update_value(OrderbookRoles::RelMaxVolumeNumerRole, QString::fromStdString(order.rel_max_volume_numer), idx, *this);
-            update_value(OrderbookRoles::MinVolumeRole, QString::fromStdString(order.min_volume), idx, *this);
-            update_value(OrderbookRoles::EnoughFundsToPayMinVolume, true, idx, *this);
-            update_value(OrderbookRoles::CEXRatesRole, "0.00", idx, *this);
-            update_value(OrderbookRoles::SendRole, "0.00", idx, *this);
-            update_value(OrderbookRoles::PriceFiatRole, "0.00", idx, *this);
-            emit dataChanged(
-                idx, idx,
-                {OrderbookRoles::UUIDRole,
-                 OrderbookRoles::PriceRole,
-                 OrderbookRoles::PriceNumerRole,
-                 OrderbookRoles::PriceDenomRole,
-                 OrderbookRoles::IsMineRole,
-                 OrderbookRoles::QuantityRole,
-                 OrderbookRoles::TotalRole,
-                 OrderbookRoles::PercentDepthRole,
-                 OrderbookRoles::BaseMinVolumeRole,
-                 OrderbookRoles::BaseMinVolumeDenomRole,
-                 OrderbookRoles::BaseMinVolumeNumerRole,
-                 OrderbookRoles::BaseMaxVolumeRole,
-                 OrderbookRoles::BaseMaxVolumeDenomRole,
-                 OrderbookRoles::BaseMaxVolumeNumerRole,
-                 OrderbookRoles::RelMinVolumeRole,
-                 OrderbookRoles::RelMinVolumeDenomRole,
-                 OrderbookRoles::RelMinVolumeNumerRole,
-                 OrderbookRoles::RelMaxVolumeRole,
-                 OrderbookRoles::RelMaxVolumeDenomRole,
-                 OrderbookRoles::RelMaxVolumeNumerRole,
-                 OrderbookRoles::MinVolumeRole,
-                 OrderbookRoles::EnoughFundsToPayMinVolume,
-                 OrderbookRoles::CEXRatesRole,
-                 OrderbookRoles::SendRole,
-                 OrderbookRoles::PriceFiatRole});
-
-            if (m_system_mgr.has_system<trading_page>() && m_current_orderbook_kind == kind::bids && is_price_changed)
+        static const QVector<int> g_order_roles{
+            UUIDRole,
+            PriceRole,
+            PriceNumerRole,
+            PriceDenomRole,
+            IsMineRole,
+            QuantityRole,
+            QuantityNumerRole,
+            QuantityDenomRole,
+            TotalRole,
+            PercentDepthRole,
+            BaseMinVolumeRole,
+            BaseMinVolumeDenomRole,
+            BaseMinVolumeNumerRole,
+            BaseMaxVolumeRole,
+            BaseMaxVolumeDenomRole,
+            BaseMaxVolumeNumerRole,
+            RelMinVolumeRole,
+            RelMinVolumeDenomRole,
+            RelMinVolumeNumerRole,
+            RelMaxVolumeRole,
+            RelMaxVolumeDenomRole,
+            RelMaxVolumeNumerRole,
+            MinVolumeRole,
+            EnoughFundsToPayMinVolume,
+            CEXRatesRole,
+            SendRole,
+            PriceFiatRole};
+        const std::size_t previous_size = m_model_data.size();
+
+        //! Deletion, one removal per contiguous range starting from the bottom so the next ranges stay valid
+        bool selected_erased = false;
+        for (auto&& [first, last]: diff.removed) { selected_erased |= erase_rows(static_cast<int>(first), static_cast<int>(last - first + 1)); }
+
+        //! Update
+        std::vector<std::size_t> changed_rows;
+        std::vector<std::size_t> repriced_orders; ///< indexes in `orderbook`
+        changed_rows.reserve(diff.changed.size());
+        for (std::size_t idx: diff.changed)
+        {
+            const auto row = m_orders_id_registry.find(orderbook.uuid(idx)).value();
+            if (m_model_data.number(row, t_order_number::price) != orderbook.number(idx, t_order_number::price))
             {
-                auto& trading_pg = m_system_mgr.get_system<trading_page>();
-                if (trading_pg.get_market_mode() == MarketMode::Sell)
-                {
-                    const auto preferred_order = trading_pg.get_preferred_order();
-                    if (!preferred_order.empty())
-                    {
-                        const t_float_50 price_std       = safe_float(new_price.toString().toStdString());
-                        t_float_50       preferred_price = safe_float(preferred_order.value("price", "0").toString().toStdString());
-                        if (price_std > preferred_price)
-                        {
-                            SPDLOG_INFO(
-                                "An order with a better price is available, uuid: {}, new_price: {}, current_price: {}", order.uuid,
-                                utils::format_float(price_std), utils::format_float(preferred_price));
-                            trading_pg.set_selected_order_status(SelectedOrderStatus::BetterPriceAvailable);
-                            emit betterOrderDetected(get_order_from_uuid(QString::fromStdString(order.uuid)));
-                        }
-                        else if (auto selected_uuid = preferred_order.value("uuid", "").toString().toStdString(); selected_uuid == order.uuid)
-                        {
-                            SPDLOG_INFO("The price went down with the selected order: {}", order.uuid);
-                            check_for_better_order(trading_pg, preferred_order, selected_uuid);
-                        }
-                    }
-                }
+                repriced_orders.push_back(idx);
+            }
+            m_model_data.assign(row, orderbook, idx);
+            m_display_cache[row]  = t_display_row{};
+            m_computed_cache[row] = computed_values(row);
+            changed_rows.push_back(row);
+        }
+        for (auto&& [first, last]: to_row_ranges(std::move(changed_rows)))
+        {
+            emit dataChanged(index(static_cast<int>(first), 0), index(static_cast<int>(last), 0), g_order_roles);
+        }
+
+        //! Insertion, a single appended range
+        if (!diff.inserted.empty())
+        {
+            const auto first = static_cast<int>(m_model_data.size());
+            beginInsertRows(QModelIndex(), first, first + static_cast<int>(diff.inserted.size()) - 1);
+            m_model_data.reserve(m_model_data.size() + diff.inserted.size());
+            for (std::size_t idx: diff.inserted)
+            {
+                m_orders_id_registry.append(orderbook.uuid(idx));
+                m_model_data.append(orderbook, idx);
             }
+            m_display_cache.resize(m_model_data.size());
+            m_computed_cache.reserve(m_model_data.size());
+            for (auto row = static_cast<std::size_t>(first); row < m_model_data.size(); ++row) { m_computed_cache.push_back(computed_values(row)); }
+            endInsertRows();
+        }
+
+        //! The computed roles of the other rows only change with the balance or the cex rates, see refresh_computed_roles
+        if (m_model_data.size() != previous_size)
+        {
+            emit lengthChanged();
+        }
+
+        //! Better orders for the selected one, checked once the model is consistent
+        for (std::size_t idx: repriced_orders) { check_for_better_bid(orderbook, idx, false); }
+        if (!diff.inserted.empty())
+        {
+            const auto best_inserted = std::max_element(
+                diff.inserted.begin(), diff.inserted.end(), [&orderbook](std::size_t lhs, std::size_t rhs)
+                { return orderbook.number(lhs, t_order_number::price) < orderbook.number(rhs, t_order_number::price); });
+            check_for_better_bid(orderbook, *best_inserted, true);
+        }
+        if (selected_erased)
+        {
+            on_selected_order_removed();
         }
     }
 
     void
-    orderbook_model::refresh_orderbook(const t_orders_contents& orderbook)
+    orderbook_model::refresh_computed_roles()
     {
-        auto refresh_functor = [this](const std::vector<::mm2::api::order_contents>& contents)
+        //! Roles computed from the balance and the cex rates, same order as t_computed_row
+        static const QVector<int> g_computed_roles{EnoughFundsToPayMinVolume, CEXRatesRole, SendRole, PriceFiatRole};
+
+        std::vector<std::size_t> recomputed_rows;
+        for (std::size_t row = 0; row < m_model_data.size(); ++row)
         {
-            // SPDLOG_INFO("refresh orderbook of size: {}", contents.size());
-            for (auto&& current_order: contents)
+            auto values = computed_values(row);
+            if (values != m_computed_cache[row])
             {
-                if (this->m_orders_id_registry.find(current_order.uuid) != this->m_orders_id_registry.end())
-                {
-                    //! Update
-                    this->update_order(current_order);
-                }
-                else
-                {
-                    //! Insertion
-                    this->initialize_order(current_order);
-                }
+                m_computed_cache[row] = std::move(values);
+                recomputed_rows.push_back(row);
             }
+        }
+        for (auto&& [first, last]: to_row_ranges(std::move(recomputed_rows)))
+        {
+            emit dataChanged(index(static_cast<int>(first), 0), index(static_cast<int>(last), 0), g_computed_roles);
+        }
+    }
 
-            // Deletion
-            std::unordered_set<std::string> to_remove;
-            for (auto&& id: this->m_orders_id_registry)
-            {
-                bool res = std::none_of(begin(contents), end(contents), [id](auto&& contents) { return contents.uuid == id; });
-                //! Need to remove the row
-                if (res)
-                {
-                    auto res_list = this->match(index(0, 0), UUIDRole, QString::fromStdString(id));
-                    if (not res_list.empty())
-                    {
-                        if (this->m_current_orderbook_kind == kind::best_orders)
-                        {
-                            // SPDLOG_INFO("Removing order with UUID: {}", id);
-                        }
-                        this->removeRow(res_list.at(0).row());
-                        to_remove.emplace(id);
-                    }
-                }
-            }
-            for (auto&& cur_to_remove: to_remove) { m_orders_id_registry.erase(cur_to_remove); }
-        };
+    void
+    orderbook_model::refresh_orderbook(const t_orderbook_columns& orderbook)
+    {
+        const auto diff = compute_orderbook_diff(m_model_data, m_orders_id_registry, orderbook);
+        apply_orderbook_diff(orderbook, diff);
+    }
 
-        refresh_functor(orderbook);
+    void
+    orderbook_model::refresh_orderbook(const t_orders_contents& orderbook)
+    {
+        refresh_orderbook(t_orderbook_columns(orderbook));
     }
 
     t_order_contents
     orderbook_model::get_order_content(const QModelIndex& index) const
     {
-        return m_model_data.at(index.row());
+        return m_model_data.to_order_contents(static_cast<std::size_t>(index.row()));
     }
 
     bool
     orderbook_model::removeRows(int position, int rows, [[maybe_unused]] const QModelIndex& parent)
     {
-        beginRemoveRows(QModelIndex(), position, position + rows - 1);
-        for (int row = 0; row < rows; ++row)
+        const bool selected_erased = erase_rows(position, rows);
+        emit lengthChanged();
+        if (selected_erased)
         {
-            auto       it                 = m_model_data.begin() + position;
-            const auto uuid_to_be_removed = it->uuid;
-            if (m_system_mgr.has_system<trading_page>() && m_current_orderbook_kind == kind::bids)
-            {
-                auto&      trading_pg      = m_system_mgr.get_system<trading_page>();
-                const auto preffered_order = trading_pg.get_preferred_order();
-                if (!preffered_order.empty())
-                {
-                    const auto selected_order_uuid = preffered_order.value("uuid", "").toString().toStdString();
-                    if (selected_order_uuid == uuid_to_be_removed)
-                    {
-                        SPDLOG_WARN(
-                            "The selected order uuid: {} is removed from the orderbook model, checking if a better order is available", uuid_to_be_removed);
-                        check_for_better_order(trading_pg, preffered_order, selected_order_uuid);
-                    }
-                }
-            }
+            on_selected_order_removed();
+        }
+        return true;
+    }
 
-            // functor(it);
-            m_model_data.erase(it);
-            emit lengthChanged();
+    bool
+    orderbook_model::erase_rows(int position, int rows)
+    {
+        std::string selected_order_uuid;
+        if (m_system_mgr.has_system<trading_page>() && m_current_orderbook_kind == kind::bids)
+        {
+            selected_order_uuid = m_system_mgr.get_system<trading_page>().get_preferred_order().value("uuid", "").toString().toStdString();
         }
+
+        const auto first           = m_model_data.uuids().begin() + position;
+        const auto last            = first + rows;
+        const bool selected_erased = !selected_order_uuid.empty() && std::find(first, last, selected_order_uuid) != last;
+
+        beginRemoveRows(QModelIndex(), position, position + rows - 1);
+        m_model_data.erase(static_cast<std::size_t>(position), static_cast<std::size_t>(rows));
+        m_display_cache.erase(m_display_cache.begin() + position, m_display_cache.begin() + position + rows);
+        m_computed_cache.erase(m_computed_cache.begin() + position, m_computed_cache.begin() + position + rows);
+        m_orders_id_registry.remove(static_cast<std::size_t>(position), static_cast<std::size_t>(rows));
         endRemoveRows();
+        return selected_erased;
+    }
 
-        return true;
+    void
+    orderbook_model::on_selected_order_removed()
+    {
+        auto&      trading_pg      = m_system_mgr.get_system<trading_page>();
+        const auto preferred_order = trading_pg.get_preferred_order();
+        const auto selected_uuid   = preferred_order.value("uuid", "").toString().toStdString();
+        SPDLOG_WARN("The selected order uuid: {} is removed from the orderbook model, checking if a better order is available", selected_uuid);
+        check_for_better_order(trading_pg, preferred_order, selected_uuid);
     }
 
     void
@@ -628,7 +641,9 @@ namespace atomic_dex
     {
         SPDLOG_INFO("clear orderbook");
         this->beginResetModel();
-        m_model_data = t_orders_contents{};
+        m_model_data.clear();
+        m_display_cache.clear();
+        m_computed_cache.clear();
         m_orders_id_registry.clear();
         this->endResetModel();
         emit lengthChanged();
@@ -650,10 +665,9 @@ namespace atomic_dex
     {
         QVariantMap out;
 
-        if (const auto res = this->match(index(0, 0), UUIDRole, uuid); not res.isEmpty())
+        if (const auto row = m_orders_id_registry.find(uuid.toStdString()); row)
         {
-            const QModelIndex& idx        = res.at(0);
-            const auto&        order      = m_model_data.at(idx.row());
+            const auto         order      = m_model_data.to_order_contents(*row);
             auto&              trading_pg = m_system_mgr.get_system<trading_page>();
             const bool         is_buy     = trading_pg.get_market_mode() == MarketMode::Buy;
             out["coin"]                   = QString::fromStdString(is_buy ? order.rel_coin.value() : order.coin);
@@ -685,19 +699,19 @@ namespace atomic_dex
     {
         if (trading_pg.get_market_mode() == MarketMode::Sell)
         {
-            t_float_50 preferred_price = safe_float(preferred_order.value("price", "0").toString().toStdString());
-            bool       hit             = false;
-            for (auto&& order: m_model_data)
+            const t_fixed_decimal preferred_price = safe_decimal(preferred_order.value("price", "0").toString().toStdString());
+            bool                  hit             = false;
+            for (std::size_t row = 0; row < m_model_data.size(); ++row)
             {
-                const t_float_50 price_std = safe_float(order.price);
+                const auto& price_std = m_model_data.number(row, t_order_number::price);
 
                 if (price_std > preferred_price)
                 {
                     SPDLOG_INFO(
-                        "An order with a better price is available, uuid: {}, new_price: {}, current_price: {}", order.uuid, utils::format_float(price_std),
-                        utils::format_float(preferred_price));
+                        "An order with a better price is available, uuid: {}, new_price: {}, current_price: {}", m_model_data.uuid(row),
+                        utils::format_float(price_std), utils::format_float(preferred_price));
                     trading_pg.set_selected_order_status(SelectedOrderStatus::BetterPriceAvailable);
-                    emit betterOrderDetected(get_order_from_uuid(QString::fromStdString(order.uuid)));
+                    emit betterOrderDetected(get_order_from_uuid(QString::fromStdString(m_model_data.uuid(row))));
                     hit = true;
                     break;
                 }
@@ -16,18 +16,19 @@
 
 #pragma once
 
+//! STD
+#include <array>
+
 //! QT
 #include <QAbstractListModel>
 #include <QVariantMap>
 
-//! STD
-#include <unordered_set>
-
 //! Deps
 #include <antara/gaming/ecs/system.manager.hpp>
 
 //! Project
 #include "atomicdex/api/mm2/rpc.orderbook.hpp"
+#include "atomicdex/data/dex/orderbook.diff.hpp"
 #include "atomicdex/models/qt.orderbook.proxy.model.hpp"
 
 namespace atomic_dex
@@ -91,12 +92,16 @@ namespace atomic_dex
         bool                                 setData(const QModelIndex& index, const QVariant& value, int role) final;
         bool                                 removeRows(int row, int count, const QModelIndex& parent) override;
 
-        void                                 reset_orderbook(const t_orders_contents& orderbook);
-        void                                 refresh_orderbook(const t_orders_contents& orderbook);
+        void                                 reset_orderbook(const t_orderbook_columns& orderbook);
+        void                                 reset_orderbook(const t_orders_contents& orderbook); ///< best orders
+        void                                 refresh_orderbook(const t_orderbook_columns& orderbook);
+        void                                 refresh_orderbook(const t_orders_contents& orderbook); ///< best orders
         void                                 clear_orderbook();
+        void                                 refresh_computed_roles(); ///< on balance or price events, the orderbook refreshes only notify their own rows
         [[nodiscard]] int                    get_length() const;
         [[nodiscard]] orderbook_proxy_model* get_orderbook_proxy() const;
         [[nodiscard]] t_order_contents       get_order_content(const QModelIndex& index) const;
+        [[nodiscard]] const t_fixed_decimal& get_price(int row) const; ///< used by the proxy to sort without parsing
         kind                                 get_orderbook_kind() const;
 
       signals:
@@ -105,17 +110,30 @@ namespace atomic_dex
         void betterOrderDetected(QVariantMap order_object);
 
       private:
-        void        initialize_order(const ::mm2::api::order_contents& order);
-        void        update_order(const ::mm2::api::order_contents& order);
-        QVariantMap get_order_from_uuid(QString uuid);
-        void        check_for_better_order(trading_page& trading_pg, const QVariantMap& preferred_order, std::string uuid);
+        //! Display strings of the numeric columns, formatted on the first paint of a row
+        using t_display_row = std::array<QString, ::mm2::api::g_nb_order_numbers>;
+        //! Last published values of the roles computed from the balance and the cex rates
+        using t_computed_row = std::array<QVariant, 4>;
+
+        [[nodiscard]] QString        display(std::size_t row, t_order_number field) const;
+        [[nodiscard]] t_order_number min_volume_field() const; ///< field behind MinVolumeRole
+        void                         store_number(std::size_t row, t_order_number field, const std::string& value);
+        [[nodiscard]] t_computed_row computed_values(std::size_t row) const;
+        void                         apply_orderbook_diff(const t_orderbook_columns& orderbook, const orderbook_diff& diff);
+        bool                         erase_rows(int position, int rows); ///< returns true if the selected order was one of the erased rows
+        void                         on_selected_order_removed();
+        void                         check_for_better_bid(const t_orderbook_columns& orderbook, std::size_t row, bool is_new_order);
+        QVariantMap                  get_order_from_uuid(QString uuid);
+        void                         check_for_better_order(trading_page& trading_pg, const QVariantMap& preferred_order, std::string uuid);
 
       private:
-        kind                            m_current_orderbook_kind{kind::asks};
-        ag::ecs::system_manager&        m_system_mgr;
-        t_orders_contents               m_model_data;
-        std::unordered_set<std::string> m_orders_id_registry;
-        orderbook_proxy_model*          m_model_proxy;
+        kind                               m_current_orderbook_kind{kind::asks};
+        ag::ecs::system_manager&           m_system_mgr;
+        t_orderbook_columns                m_model_data;
+        mutable std::vector<t_display_row> m_display_cache; ///< same rows as m_model_data
+        std::vector<t_computed_row>        m_computed_cache; ///< same rows as m_model_data
+        keyed_row_index                    m_orders_id_registry; ///< uuid -> row of m_model_data
+        orderbook_proxy_model*             m_model_proxy;
     };
 
 } // namespace atomic_dex
@@ -40,7 +40,15 @@ namespace atomic_dex
             SPDLOG_WARN("one of the index is invalid - skipping -> role: {}", this->sortRole());
             return false;
         }
-        int      role       = this->sortRole();
+        int role = this->sortRole();
+        if (role == orderbook_model::PriceRole)
+        {
+            //! Compares the parsed prices, no display string is built or parsed while sorting
+            if (const auto* orderbook = qobject_cast<const orderbook_model*>(sourceModel()); orderbook != nullptr)
+            {
+                return orderbook->get_price(source_left.row()) < orderbook->get_price(source_right.row());
+            }
+        }
         QVariant left_data  = sourceModel()->data(source_left, role);
         QVariant right_data = sourceModel()->data(source_right, role);
 
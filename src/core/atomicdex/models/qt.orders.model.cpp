@@ -26,6 +26,60 @@
 #include "atomicdex/services/mm2/mm2.service.hpp"
 #include "atomicdex/utilities/qt.utilities.hpp"
 
+namespace
+{
+    void
+    hash_qstring(atomic_dex::t_content_hash& seed, const QString& value)
+    {
+        atomic_dex::hash_combine(seed, std::u16string_view(reinterpret_cast<const char16_t*>(value.utf16()), static_cast<std::size_t>(value.size())));
+    }
+
+    //! Fields applied by update_existing_order
+    atomic_dex::t_content_hash
+    order_content_hash(const atomic_dex::t_order_swaps_data& contents)
+    {
+        atomic_dex::t_content_hash seed = 0;
+        atomic_dex::hash_combine(seed, contents.is_cancellable);
+        hash_qstring(seed, contents.order_type);
+        hash_qstring(seed, contents.base_amount);
+        hash_qstring(seed, contents.rel_amount);
+        hash_qstring(seed, contents.base_amount_fiat);
+        hash_qstring(seed, contents.rel_amount_fiat);
+        return seed;
+    }
+
+    //! Fields applied by update_swap, events are only appended so their number and the last timestamp identify them
+    atomic_dex::t_content_hash
+    swap_content_hash(const atomic_dex::t_order_swaps_data& contents)
+    {
+        atomic_dex::t_content_hash seed = 0;
+        atomic_dex::hash_combine(seed, contents.is_recoverable);
+        atomic_dex::hash_combine(seed, contents.unix_timestamp);
+        atomic_dex::hash_combine(seed, contents.events.size());
+        hash_qstring(seed, contents.order_status);
+        hash_qstring(seed, contents.maker_payment_id);
+        hash_qstring(seed, contents.taker_payment_id);
+        hash_qstring(seed, contents.order_error_state);
+        hash_qstring(seed, contents.order_error_message);
+        hash_qstring(seed, contents.base_amount_fiat);
+        hash_qstring(seed, contents.rel_amount_fiat);
+        return seed;
+    }
+
+    void
+    store_content_hash(atomic_dex::content_change_detector& detector, const atomic_dex::t_order_swaps_data& contents)
+    {
+        if (contents.is_swap)
+        {
+            detector.store("swaps", contents.order_id.toStdString(), swap_content_hash(contents));
+        }
+        else
+        {
+            detector.store("orders", contents.order_id.toStdString(), order_content_hash(contents));
+        }
+    }
+} // namespace
+
 //! Constructor
 namespace atomic_dex
 {
@@ -134,7 +188,14 @@ namespace atomic_dex
             break;
         }
 
-        emit dataChanged(index, index, {role});
+        if (m_row_changes.is_recording())
+        {
+            m_row_changes.add(static_cast<std::size_t>(index.row()), role);
+        }
+        else
+        {
+            emit dataChanged(index, index, {role});
+        }
         return true;
     }
 
@@ -207,12 +268,11 @@ namespace atomic_dex
         SPDLOG_DEBUG("(orders_model::removeRows) removing {} elements at position {}", rows, position);
 
         beginRemoveRows(QModelIndex(), position, position + rows - 1);
-        for (int row = 0; row < rows; ++row)
-        {
-            this->m_model_data.orders_and_swaps.erase(begin(m_model_data.orders_and_swaps) + position);
-            emit lengthChanged();
-        }
+        auto& data = m_model_data.orders_and_swaps;
+        data.erase(begin(data) + position, begin(data) + position + rows);
+        m_rows_registry.remove(static_cast<std::size_t>(position), static_cast<std::size_t>(rows));
         endRemoveRows();
+        emit lengthChanged();
 
         return true;
     }
@@ -388,12 +448,12 @@ namespace atomic_dex
 //! Private API
 namespace atomic_dex
 {
-    void
+    bool
     orders_model::update_existing_order(const t_order_swaps_data& contents)
     {
-        if (const auto res = this->match(index(0, 0), OrderIdRole, contents.order_id); !res.isEmpty())
+        if (const auto row = m_rows_registry.find(contents.order_id.toStdString()); row)
         {
-            const QModelIndex& idx = res.at(0);
+            const QModelIndex idx = index(static_cast<int>(*row), 0);
             update_value(OrdersRoles::CancellableRole, contents.is_cancellable, idx, *this);
             update_value(OrdersRoles::IsMakerRole, contents.order_type == "maker", idx, *this);
             update_value(OrdersRoles::OrderTypeRole, contents.order_type, idx, *this);
@@ -404,16 +464,17 @@ namespace atomic_dex
                 update_value(OrdersRoles::BaseCoinAmountRole, contents.base_amount, idx, *this);
                 update_value(OrdersRoles::RelCoinAmountRole, contents.rel_amount, idx, *this);
             }
-            emit lengthChanged();
+            return true;
         }
+        return false;
     }
 
-    void
+    bool
     orders_model::update_swap(const t_order_swaps_data& contents)
     {
-        if (const auto res = this->match(index(0, 0), OrderIdRole, contents.order_id); !res.isEmpty())
+        if (const auto row = m_rows_registry.find(contents.order_id.toStdString()); row)
         {
-            const QModelIndex& idx = res.at(0);
+            const QModelIndex idx = index(static_cast<int>(*row), 0);
             update_value(OrdersRoles::IsRecoverableRole, contents.is_recoverable, idx, *this);
             auto&& [prev_value, new_value, is_change] = update_value(OrdersRoles::OrderStatusRole, contents.order_status, idx, *this);
 
@@ -439,9 +500,9 @@ namespace atomic_dex
             //! Updates values in current currency of amounts traded.
             update_value(OrdersRoles::BaseCoinAmountCurrentCurrencyRole, contents.base_amount_fiat, idx, *this);
             update_value(OrdersRoles::RelCoinAmountCurrentCurrencyRole, contents.rel_amount_fiat, idx, *this);
-
-            emit lengthChanged();
+            return true;
         }
+        return false;
     }
 
     void
@@ -453,7 +514,9 @@ namespace atomic_dex
         SPDLOG_INFO("Full initialization, inserting {} elements, nb_elements / page {}", size, contents.limit);
         beginResetModel();
         m_model_data = contents;
+        m_rows_registry.reset(m_model_data.orders_and_swaps, [](const t_order_swaps_data& cur) { return cur.order_id.toStdString(); });
         endResetModel();
+        for (auto&& cur: m_model_data.orders_and_swaps) { store_content_hash(m_content_changes, cur); }
         m_orders_id_registry = std::move(m_model_data.orders_registry);
         m_swaps_id_registry  = std::move(m_model_data.swaps_registry);
         emit lengthChanged();
@@ -470,6 +533,11 @@ namespace atomic_dex
         auto& data = m_model_data.orders_and_swaps;
         beginInsertRows(QModelIndex(), rowCount(), rowCount() + static_cast<int>(contents.size()) - 1);
         data.insert(end(data), begin(contents), end(contents));
+        for (auto&& cur: contents)
+        {
+            m_rows_registry.append(cur.order_id.toStdString());
+            store_content_hash(m_content_changes, cur);
+        }
         if (kind == "orders")
         {
             m_model_data.nb_orders += contents.size();
@@ -489,16 +557,22 @@ namespace atomic_dex
     {
         const auto&                     data = contents.orders_and_swaps;
         std::vector<t_order_swaps_data> to_init;
+        bool                            updated = false;
+        m_row_changes.start();
         std::for_each(
             begin(data) + contents.nb_orders, end(data),
-            [this, &to_init](const auto& cur)
+            [this, &to_init, &updated](const auto& cur)
             {
                 if (cur.is_swap)
                 {
                     const auto& uuid = cur.order_id.toStdString();
                     if (this->m_swaps_id_registry.contains(uuid))
                     {
-                        this->update_swap(cur);
+                        //! Most swaps of a page are finished, they are only compared once their hash moved
+                        if (m_content_changes.changed("swaps", uuid, swap_content_hash(cur)))
+                        {
+                            updated |= this->update_swap(cur);
+                        }
                     }
                     else
                     {
@@ -507,6 +581,11 @@ namespace atomic_dex
                     }
                 }
             });
+        flush_row_changes();
+        if (updated)
+        {
+            emit lengthChanged();
+        }
         if (!to_init.empty())
         {
             this->common_insert(to_init, "swaps");
@@ -521,13 +600,18 @@ namespace atomic_dex
         if (contents.nb_orders > 0)
         {
             std::vector<t_order_swaps_data> to_init;
+            bool                            updated = false;
+            m_row_changes.start();
             std::for_each(
                 begin(data), begin(data) + contents.nb_orders,
-                [this, &to_init, &are_present](const auto& cur)
+                [this, &to_init, &are_present, &updated](const auto& cur)
                 {
                     if (this->m_orders_id_registry.contains(cur.order_id.toStdString()))
                     {
-                        this->update_existing_order(cur);
+                        if (m_content_changes.changed("orders", cur.order_id.toStdString(), order_content_hash(cur)))
+                        {
+                            updated |= this->update_existing_order(cur);
+                        }
                     }
                     else
                     {
@@ -535,6 +619,11 @@ namespace atomic_dex
                     }
                     are_present.emplace(cur.order_id.toStdString());
                 });
+            flush_row_changes();
+            if (updated)
+            {
+                emit lengthChanged();
+            }
 
             if (!to_init.empty())
             {
@@ -549,22 +638,41 @@ namespace atomic_dex
     orders_model::remove_orders(const t_orders_id_registry& are_present)
     {
         std::vector<std::string> to_remove;
+        std::vector<std::size_t> rows;
         for (auto&& id: this->m_orders_id_registry)
         {
             if (!are_present.contains(id))
             {
-                //! If it's the case retrieve the index of the row that match this id
-                auto res_list = this->match(index(0, 0), OrderIdRole, QString::fromStdString(id));
-                if (!res_list.empty())
+                //! If it's the case retrieve the row that match this id
+                if (const auto row = m_rows_registry.find(id); row)
                 {
-                    //! And then delete it
-                    this->removeRow(res_list.at(0).row());
-                    m_model_data.nb_orders -= 1;
+                    rows.push_back(*row);
                     to_remove.emplace_back(id);
                 }
             }
         }
-        for (auto&& cur_to_remove: to_remove) { m_orders_id_registry.erase(cur_to_remove); }
+
+        //! And then delete them, one removal per contiguous range starting from the bottom so the next ranges stay valid
+        const auto ranges = to_row_ranges(std::move(rows));
+        for (auto it = ranges.rbegin(); it != ranges.rend(); ++it)
+        {
+            const auto& [first, last] = *it;
+            this->removeRows(static_cast<int>(first), static_cast<int>(last - first + 1), QModelIndex());
+            m_model_data.nb_orders -= last - first + 1;
+        }
+        for (auto&& cur_to_remove: to_remove)
+        {
+            m_orders_id_registry.erase(cur_to_remove);
+            m_content_changes.forget("orders", cur_to_remove);
+        }
+    }
+
+    void
+    orders_model::flush_row_changes()
+    {
+        m_row_changes.flush(
+            [this](std::size_t first, std::size_t last, const std::vector<int>& roles)
+            { emit dataChanged(index(static_cast<int>(first), 0), index(static_cast<int>(last), 0), QVector<int>(roles.begin(), roles.end())); });
     }
 
     void
@@ -614,6 +722,8 @@ namespace atomic_dex
         const auto filtering = this->m_model_data.filtering_infos;
         this->m_swaps_id_registry.clear();
         this->m_orders_id_registry.clear();
+        this->m_rows_registry.clear();
+        this->m_content_changes.clear();
         this->m_model_data = {.limit = limit, .filtering_infos = filtering};
     }
 
@@ -692,6 +802,12 @@ namespace atomic_dex
         }
     }
 
+    t_content_change_metrics
+    orders_model::get_content_change_metrics() const
+    {
+        return m_content_changes.get_metrics();
+    }
+
     t_filtering_infos
     orders_model::get_filtering_infos() const
     {
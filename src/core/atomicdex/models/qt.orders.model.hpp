@@ -36,6 +36,8 @@
 #include "atomicdex/data/dex/orders.and.swaps.data.hpp"
 #include "atomicdex/events/events.hpp"
 #include "atomicdex/models/qt.orders.proxy.model.hpp"
+#include "atomicdex/utilities/content.hash.hpp"
+#include "atomicdex/utilities/keyed.row.index.hpp"
 
 namespace atomic_dex
 {
@@ -113,6 +115,9 @@ namespace atomic_dex
         void                              set_recover_fund_data(QVariant rpc_data);
         [[nodiscard]] int                 get_nb_pages() const;
 
+        //! Orders and swaps whose content did not move since the last refresh
+        [[nodiscard]] t_content_change_metrics get_content_change_metrics() const;
+
         //! getter
         [[nodiscard]] t_filtering_infos get_filtering_infos() const;
         void                            set_filtering_infos(t_filtering_infos infos);
@@ -143,28 +148,32 @@ namespace atomic_dex
         using t_swaps_id_registry    = std::unordered_set<std::string>;
         using t_qt_synchronized_json = boost::synchronized_value<QJsonObject>;
 
-        t_orders_id_registry   m_orders_id_registry;
-        t_swaps_id_registry    m_swaps_id_registry;
-        t_orders_datas         m_model_data;
-        QVariant               m_json_time_registry;
-        std::atomic_bool       m_fetching_busy{false};
-        std::atomic_bool       m_recover_funds_busy{false};
-        t_qt_synchronized_json m_recover_funds_data;
+        t_orders_id_registry    m_orders_id_registry;
+        t_swaps_id_registry     m_swaps_id_registry;
+        keyed_row_index         m_rows_registry;   ///< order_id -> row of m_model_data.orders_and_swaps
+        row_changes             m_row_changes;     ///< setData calls are batched while recording
+        content_change_detector m_content_changes; ///< order_id -> hash of the fields the last update applied
+        t_orders_datas          m_model_data;
+        QVariant                m_json_time_registry;
+        std::atomic_bool        m_fetching_busy{false};
+        std::atomic_bool        m_recover_funds_busy{false};
+        t_qt_synchronized_json  m_recover_funds_data;
 
         orders_proxy_model* m_model_proxy;
 
         //! Private common API
         void init_model(const orders_and_swaps& contents);
         void set_common_data(const orders_and_swaps& contents);
+        void flush_row_changes();
 
         //! Private orders API
         void update_or_insert_orders(const orders_and_swaps& contents);
         void remove_orders(const t_orders_id_registry& are_present);
-        void update_existing_order(const t_order_swaps_data& contents);
+        bool update_existing_order(const t_order_swaps_data& contents);
 
         //! Private Swaps API
         void update_or_insert_swaps(const orders_and_swaps& contents);
-        void update_swap(const t_order_swaps_data& contents);
+        bool update_swap(const t_order_swaps_data& contents);
 
         //! Events
         void on_current_currency_changed(const current_currency_changed&);
@@ -32,6 +32,24 @@
 #include "atomicdex/utilities/qt.utilities.hpp"
 #include "qt.portfolio.model.hpp"
 
+namespace
+{
+    //! Values of a portfolio row computed by the update_currency_values workers, applied to the model afterwards
+    struct currency_values
+    {
+        std::size_t                    row;
+        const atomic_dex::coin_config* coin;
+        QString                        main_currency_balance;
+        QString                        main_currency_price_for_one_unit;
+        QString                        main_fiat_price_for_one_unit;
+        QString                        price_provider;
+        int                            last_price_timestamp{0};
+        QString                        change_24h;
+        QString                        balance;
+        QJsonArray                     trend_7d;
+    };
+} // namespace
+
 namespace atomic_dex
 {
     portfolio_model::portfolio_model(ag::ecs::system_manager& system_manager, entt::dispatcher& dispatcher, QObject* parent) :
@@ -55,11 +73,13 @@ namespace atomic_dex
     void
     atomic_dex::portfolio_model::initialize_portfolio(const std::vector<std::string>& tickers)
     {
-        QVector<portfolio_data> datas;
+        QVector<portfolio_data>  datas;
+        std::vector<std::string> keys;
+        bool                     with_balance = false;
 
         for (auto&& ticker: tickers)
         {
-            if (m_ticker_registry.find(ticker) != m_ticker_registry.end())
+            if (m_ticker_registry.contains(ticker) || std::find(keys.begin(), keys.end(), ticker) != keys.end())
                 continue;
             const auto& mm2_system    = this->m_system_manager.get_system<mm2_service>();
             const auto& price_service = this->m_system_manager.get_system<global_price_service>();
@@ -67,13 +87,15 @@ namespace atomic_dex
             auto        coin          = mm2_system.get_coin_info(ticker);
 
             std::error_code ec;
+            std::error_code balance_ec;
+            const QString   balance    = QString::fromStdString(mm2_system.my_balance(coin.ticker, balance_ec));
             const QString   change_24h = retrieve_change_24h(provider, coin, *m_config, m_system_manager);
             portfolio_data  data{
                 .ticker                           = QString::fromStdString(coin.ticker),
                 .gui_ticker                       = QString::fromStdString(coin.gui_ticker),
                 .coin_type                        = QString::fromStdString(coin.type),
                 .name                             = QString::fromStdString(coin.name),
-                .balance                          = QString::fromStdString(mm2_system.my_balance(coin.ticker, ec)),
+                .balance                          = balance,
                 .main_currency_balance            = QString::fromStdString(price_service.get_price_in_fiat(m_config->current_currency, coin.ticker, ec)),
                 .change_24h                       = change_24h,
                 .main_currency_price_for_one_unit = QString::fromStdString(price_service.get_rate_conversion(m_config->current_currency, coin.ticker, true)),
@@ -87,15 +109,21 @@ namespace atomic_dex
             data.display         = QString::fromStdString(coin.gui_ticker) + " (" + data.balance + ")";
             data.ticker_and_name = QString::fromStdString(coin.gui_ticker) + data.name;
             datas.push_back(std::move(data));
-            m_ticker_registry.emplace(ticker);
+            keys.push_back(ticker);
+            with_balance = with_balance || !balance_ec;
         }
         if (not datas.isEmpty())
         {
-            beginInsertRows(QModelIndex(), this->m_model_data.count(), this->m_model_data.count() + tickers.size() - 1);
+            beginInsertRows(QModelIndex(), this->m_model_data.count(), this->m_model_data.count() + datas.count() - 1);
             this->m_model_data.append(datas);
+            for (auto&& key: keys) { m_ticker_registry.append(std::move(key)); }
             endInsertRows();
             SPDLOG_INFO("size of the portfolio after batch inserted: {}", this->get_length());
             emit lengthChanged();
+            if (with_balance)
+            {
+                m_system_manager.get_system<mm2_service>().record_startup_stage("first_portfolio_render");
+            }
         }
     }
 
@@ -109,52 +137,63 @@ namespace atomic_dex
         const auto         coins         = this->m_system_manager.get_system<portfolio_page>().get_global_cfg()->get_enabled_coins();
         const std::string& currency      = m_config->current_currency;
         const std::string& fiat          = m_config->current_fiat;
-        tf::Executor       executor;
-        tf::Taskflow       taskflow;
+
+        std::vector<currency_values> values;
+        values.reserve(coins.size());
         for (auto&& [_, coin]: coins)
         {
-            if (m_ticker_registry.find(coin.ticker) == m_ticker_registry.end())
+            const auto row = m_ticker_registry.find(coin.ticker);
+            if (!row)
             {
                 SPDLOG_WARN("ticker: {} not inserted yet in the model, skipping", coin.ticker);
                 return false;
             }
-            auto update_functor = [coin = std::move(coin), &provider, &mm2_system, &price_service, currency, fiat, this]()
-            {
-                const std::string& ticker = coin.ticker;
-                if (const auto res = this->match(this->index(0, 0), TickerRole, QString::fromStdString(ticker), 1, Qt::MatchFlag::MatchExactly);
-                    not res.isEmpty())
+            values.push_back(currency_values{.row = *row, .coin = &coin});
+        }
+
+        //! Price lookups run in parallel, the model is only touched from this thread
+        tf::Executor executor;
+        tf::Taskflow taskflow;
+        for (auto&& cur: values)
+        {
+            taskflow.emplace(
+                [&cur, &provider, &mm2_system, &price_service, &currency, &fiat, this]()
                 {
+                    const std::string& ticker = cur.coin->ticker;
                     std::error_code    ec;
-                    const QModelIndex& idx                         = res.at(0);
-                    const QString      main_currency_balance_value = QString::fromStdString(price_service.get_price_in_fiat(currency, ticker, ec));
-                    update_value(MainCurrencyBalanceRole, main_currency_balance_value, idx, *this);
-                    const QString currency_price_for_one_unit = QString::fromStdString(price_service.get_rate_conversion(currency, ticker, true));
-                    update_value(MainCurrencyPriceForOneUnit, currency_price_for_one_unit, idx, *this);
-                    const QString currency_fiat_for_one_unit = QString::fromStdString(price_service.get_rate_conversion(fiat, ticker, false));
-                    update_value(MainFiatPriceForOneUnit, currency_fiat_for_one_unit, idx, *this);
-                    const QString price_provider = QString::fromStdString(provider.get_price_provider(ticker));
-                    update_value(PriceProvider, price_provider, idx, *this);
-                    int last_price_timestamp = static_cast<int>(provider.get_last_price_timestamp(ticker));
-                    update_value(LastPriceTimestamp, last_price_timestamp, idx, *this);
-                    QString change24_h = retrieve_change_24h(provider, coin, *m_config, m_system_manager);
-                    update_value(Change24H, change24_h, idx, *this);
-                    const QString balance                           = QString::fromStdString(mm2_system.my_balance(coin.ticker, ec));
-                    auto&& [prev_balance, new_balance, is_change_b] = update_value(BalanceRole, balance, idx, *this);
-                    const QString display                           = QString::fromStdString(coin.ticker) + " (" + balance + ")";
-                    update_value(Display, display, idx, *this);
-                    // Not a good way to trigger notification, use websocket instead in the future. New was of enabling coins is not compatible.
-                    if (is_change_b)
-                    {
-                        balance_update_handler(prev_balance.toString(), new_balance.toString(), QString::fromStdString(ticker));
-                    }
-                    QJsonArray trend = nlohmann_json_array_to_qt_json_array(provider.get_ticker_historical(ticker));
-                    update_value(Trend7D, trend, idx, *this);
-                    // SPDLOG_DEBUG("updated currency values of: {}", ticker);
-                }
-            };
-            taskflow.emplace(update_functor);
+                    cur.main_currency_balance            = QString::fromStdString(price_service.get_price_in_fiat(currency, ticker, ec));
+                    cur.main_currency_price_for_one_unit = QString::fromStdString(price_service.get_rate_conversion(currency, ticker, true));
+                    cur.main_fiat_price_for_one_unit     = QString::fromStdString(price_service.get_rate_conversion(fiat, ticker, false));
+                    cur.price_provider                   = QString::fromStdString(provider.get_price_provider(ticker));
+                    cur.last_price_timestamp             = static_cast<int>(provider.get_last_price_timestamp(ticker));
+                    cur.change_24h                       = retrieve_change_24h(provider, *cur.coin, *m_config, m_system_manager);
+                    cur.balance                          = QString::fromStdString(mm2_system.my_balance(ticker, ec));
+                    cur.trend_7d                         = nlohmann_json_array_to_qt_json_array(provider.get_ticker_historical(ticker));
+                });
         }
         executor.run(taskflow).wait();
+
+        m_row_changes.start();
+        for (auto&& cur: values)
+        {
+            const QModelIndex idx = this->index(static_cast<int>(cur.row), 0);
+            update_value(MainCurrencyBalanceRole, cur.main_currency_balance, idx, *this);
+            update_value(MainCurrencyPriceForOneUnit, cur.main_currency_price_for_one_unit, idx, *this);
+            update_value(MainFiatPriceForOneUnit, cur.main_fiat_price_for_one_unit, idx, *this);
+            update_value(PriceProvider, cur.price_provider, idx, *this);
+            update_value(LastPriceTimestamp, cur.last_price_timestamp, idx, *this);
+            update_value(Change24H, cur.change_24h, idx, *this);
+            auto&& [prev_balance, new_balance, is_change_b] = update_value(BalanceRole, cur.balance, idx, *this);
+            const QString display                           = QString::fromStdString(cur.coin->ticker) + " (" + cur.balance + ")";
+            update_value(Display, display, idx, *this);
+            // Not a good way to trigger notification, use websocket instead in the future. New was of enabling coins is not compatible.
+            if (is_change_b)
+            {
+                balance_update_handler(prev_balance.toString(), new_balance.toString(), QString::fromStdString(cur.coin->ticker));
+            }
+            update_value(Trend7D, cur.trend_7d, idx, *this);
+        }
+        flush_row_changes();
         return true;
     }
 
@@ -162,57 +201,65 @@ namespace atomic_dex
     portfolio_model::update_balance_values(const std::vector<std::string>& tickers)
     {
         SPDLOG_INFO("update_balance_values");
+        const auto& mm2_system             = this->m_system_manager.get_system<mm2_service>();
+        bool        refresh_current_ticker = false;
+        m_row_changes.start();
         for (auto&& ticker: tickers)
         {
             if (ticker.empty())
             {
+                flush_row_changes();
                 return false;
             }
-            if (m_ticker_registry.find(ticker) == m_ticker_registry.end())
+            const auto row = m_ticker_registry.find(ticker);
+            if (!row)
             {
                 SPDLOG_WARN("ticker: {} not inserted yet in the model, skipping", ticker);
+                flush_row_changes();
                 return false;
             }
             // SPDLOG_DEBUG("trying updating balance values of: {}", ticker);
-            if (const auto res = this->match(this->index(0, 0), TickerRole, QString::fromStdString(ticker), 1, Qt::MatchFlag::MatchExactly); not res.isEmpty())
+            const auto*        global_cfg    = this->m_system_manager.get_system<portfolio_page>().get_global_cfg();
+            const auto         coin          = global_cfg->get_coin_info(ticker);
+            const auto&        price_service = this->m_system_manager.get_system<global_price_service>();
+            const auto&        provider      = this->m_system_manager.get_system<komodo_prices_provider>();
+            std::error_code    ec;
+            const std::string& currency                     = m_config->current_currency;
+            const std::string& fiat                         = m_config->current_fiat;
+            const QModelIndex  idx                          = this->index(static_cast<int>(*row), 0);
+            const QString      balance                      = QString::fromStdString(mm2_system.my_balance(ticker, ec));
+            auto&& [prev_balance, new_balance, is_change_b] = update_value(BalanceRole, balance, idx, *this);
+            const QString main_currency_balance_value       = QString::fromStdString(price_service.get_price_in_fiat(currency, ticker, ec));
+            auto&& [_1, _2, is_change_mc]                   = update_value(MainCurrencyBalanceRole, main_currency_balance_value, idx, *this);
+            const QString currency_price_for_one_unit       = QString::fromStdString(price_service.get_rate_conversion(currency, ticker, true));
+            auto&& [_3, _4, is_change_mcpfo]                = update_value(MainCurrencyPriceForOneUnit, currency_price_for_one_unit, idx, *this);
+            const QString currency_fiat_for_one_unit        = QString::fromStdString(price_service.get_rate_conversion(fiat, ticker, false));
+            update_value(MainFiatPriceForOneUnit, currency_fiat_for_one_unit, idx, *this);
+            const QString price_provider = QString::fromStdString(provider.get_price_provider(ticker));
+            update_value(PriceProvider, price_provider, idx, *this);
+            int last_price_timestamp = static_cast<int>(provider.get_last_price_timestamp(ticker));
+            update_value(LastPriceTimestamp, last_price_timestamp, idx, *this);
+            const QString display = QString::fromStdString(ticker) + " (" + balance + ")";
+            update_value(Display, display, idx, *this);
+            QString change24_h = retrieve_change_24h(provider, coin, *m_config, m_system_manager);
+            update_value(Change24H, change24_h, idx, *this);
+            if (is_change_b)
             {
-                const auto&        mm2_system    = this->m_system_manager.get_system<mm2_service>();
-                const auto*        global_cfg    = this->m_system_manager.get_system<portfolio_page>().get_global_cfg();
-                const auto         coin          = global_cfg->get_coin_info(ticker);
-                const auto&        price_service = this->m_system_manager.get_system<global_price_service>();
-                const auto&        provider      = this->m_system_manager.get_system<komodo_prices_provider>();
-                std::error_code    ec;
-                const std::string& currency                     = m_config->current_currency;
-                const std::string& fiat                         = m_config->current_fiat;
-                const QModelIndex& idx                          = res.at(0);
-                const QString      balance                      = QString::fromStdString(mm2_system.my_balance(ticker, ec));
-                auto&& [prev_balance, new_balance, is_change_b] = update_value(BalanceRole, balance, idx, *this);
-                const QString main_currency_balance_value       = QString::fromStdString(price_service.get_price_in_fiat(currency, ticker, ec));
-                auto&& [_1, _2, is_change_mc]                   = update_value(MainCurrencyBalanceRole, main_currency_balance_value, idx, *this);
-                const QString currency_price_for_one_unit       = QString::fromStdString(price_service.get_rate_conversion(currency, ticker, true));
-                auto&& [_3, _4, is_change_mcpfo]                = update_value(MainCurrencyPriceForOneUnit, currency_price_for_one_unit, idx, *this);
-                const QString currency_fiat_for_one_unit        = QString::fromStdString(price_service.get_rate_conversion(fiat, ticker, false));
-                update_value(MainFiatPriceForOneUnit, currency_fiat_for_one_unit, idx, *this);
-                const QString price_provider = QString::fromStdString(provider.get_price_provider(ticker));
-                update_value(PriceProvider, price_provider, idx, *this);
-                int last_price_timestamp = static_cast<int>(provider.get_last_price_timestamp(ticker));
-                update_value(LastPriceTimestamp, last_price_timestamp, idx, *this);
-                const QString display = QString::fromStdString(ticker) + " (" + balance + ")";
-                update_value(Display, display, idx, *this);
-                QString change24_h = retrieve_change_24h(provider, coin, *m_config, m_system_manager);
-                update_value(Change24H, change24_h, idx, *this);
-                if (is_change_b)
-                {
-                    balance_update_handler(prev_balance.toString(), new_balance.toString(), QString::fromStdString(ticker));
-                }
-                QJsonArray trend = nlohmann_json_array_to_qt_json_array(provider.get_ticker_historical(ticker));
-                update_value(Trend7D, trend, idx, *this);
-                if (ticker == mm2_system.get_current_ticker() && (is_change_b || is_change_mc || is_change_mcpfo))
-                {
-                    m_system_manager.get_system<wallet_page>().refresh_ticker_infos();
-                }
+                balance_update_handler(prev_balance.toString(), new_balance.toString(), QString::fromStdString(ticker));
+            }
+            QJsonArray trend = nlohmann_json_array_to_qt_json_array(provider.get_ticker_historical(ticker));
+            update_value(Trend7D, trend, idx, *this);
+            if (ticker == mm2_system.get_current_ticker() && (is_change_b || is_change_mc || is_change_mcpfo))
+            {
+                refresh_current_ticker = true;
             }
         }
+        flush_row_changes();
+        m_system_manager.get_system<mm2_service>().record_startup_stage("first_portfolio_render");
+        if (refresh_current_ticker)
+        {
+            m_system_manager.get_system<wallet_page>().refresh_ticker_infos();
+        }
         return true;
     }
 
@@ -374,7 +421,14 @@ namespace atomic_dex
             return false;
         }
 
-        emit dataChanged(index, index, {role});
+        if (m_row_changes.is_recording())
+        {
+            m_row_changes.add(static_cast<std::size_t>(index.row()), role);
+        }
+        else
+        {
+            emit dataChanged(index, index, {role});
+        }
         return true;
     }
 
@@ -382,13 +436,10 @@ namespace atomic_dex
     portfolio_model::removeRows(int position, int rows, [[maybe_unused]] const QModelIndex& parent)
     {
         beginRemoveRows(QModelIndex(), position, position + rows - 1);
-        for (int row = 0; row < rows; ++row)
-        {
-            this->m_ticker_registry.erase(this->m_model_data.at(position).ticker.toStdString());
-            this->m_model_data.removeAt(position);
-            emit lengthChanged();
-        }
+        this->m_model_data.remove(position, rows);
+        this->m_ticker_registry.remove(static_cast<std::size_t>(position), static_cast<std::size_t>(rows));
         endRemoveRows();
+        emit lengthChanged();
 
         return true;
     }
@@ -398,11 +449,9 @@ namespace atomic_dex
     {
         for (auto&& coin: coins)
         {
-            auto res = this->match(this->index(0, 0), TickerRole, coin, 1, Qt::MatchFlag::MatchExactly);
-            // assert(not res.empty());
-            if (not res.empty())
+            if (const auto row = m_ticker_registry.find(coin.toStdString()); row)
             {
-                this->removeRow(res.at(0).row());
+                this->removeRow(static_cast<int>(*row));
             }
         }
     }
@@ -486,15 +535,23 @@ namespace atomic_dex
     portfolio_model::clean_priv_keys()
     {
         const auto coins = this->m_system_manager.get_system<portfolio_page>().get_global_cfg()->get_enabled_coins();
+        m_row_changes.start();
         for (auto&& [coin, cfg]: coins)
         {
-            auto res = this->match(this->index(0, 0), TickerRole, QString::fromStdString(coin), 1, Qt::MatchFlag::MatchExactly);
-            // assert(not res.empty());
-            if (not res.empty())
+            if (const auto row = m_ticker_registry.find(coin); row)
             {
-                update_value(PortfolioRoles::PrivKey, "", res.at(0), *this);
+                update_value(PortfolioRoles::PrivKey, "", this->index(static_cast<int>(*row), 0), *this);
             }
         }
+        flush_row_changes();
+    }
+
+    void
+    portfolio_model::flush_row_changes()
+    {
+        m_row_changes.flush(
+            [this](std::size_t first, std::size_t last, const std::vector<int>& roles)
+            { emit dataChanged(this->index(static_cast<int>(first), 0), this->index(static_cast<int>(last), 0), QVector<int>(roles.begin(), roles.end())); });
     }
 } // namespace atomic_dex
 
@@ -504,17 +561,17 @@ namespace atomic_dex
     portfolio_model::balance_update_handler(const QString& prev_balance, const QString& new_balance, const QString& ticker)
     {
         using namespace std::chrono;
-        t_float_50 prev_balance_f = safe_float(prev_balance.toStdString());
-        t_float_50 new_balance_f  = safe_float(new_balance.toStdString());
-        bool       am_i_sender    = false;
+        t_fixed_decimal prev_balance_f = safe_decimal(prev_balance.toStdString());
+        t_fixed_decimal new_balance_f  = safe_decimal(new_balance.toStdString());
+        bool            am_i_sender    = false;
         if (prev_balance_f > new_balance_f)
         {
             am_i_sender = true;
         }
-        t_float_50 amount_f   = am_i_sender ? prev_balance_f - new_balance_f : new_balance_f - prev_balance_f;
-        QString    amount     = QString::fromStdString(amount_f.str(8, std::ios_base::fixed));
-        qint64     timestamp  = duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
-        QString    human_date = QString::fromStdString(utils::to_human_date<std::chrono::seconds>(timestamp, "%e %b %Y, %H:%M"));
+        t_fixed_decimal amount_f   = am_i_sender ? prev_balance_f - new_balance_f : new_balance_f - prev_balance_f;
+        QString         amount     = QString::fromStdString(amount_f.str(8));
+        qint64          timestamp  = duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+        QString         human_date = QString::fromStdString(utils::to_human_date<std::chrono::seconds>(timestamp, "%e %b %Y, %H:%M"));
         this->m_dispatcher.trigger<balance_update_notification>(am_i_sender, amount, ticker, human_date, timestamp);
         emit portfolioItemDataChanged();
     }
@@ -523,23 +580,23 @@ namespace atomic_dex
     portfolio_model::adjust_percent_current_currency(QString balance_all)
     {
         // SPDLOG_INFO("adjust_percent_current_currency");
-        const auto coins = this->m_system_manager.get_system<portfolio_page>().get_global_cfg()->get_enabled_coins();
+        const auto            coins         = this->m_system_manager.get_system<portfolio_page>().get_global_cfg()->get_enabled_coins();
+        const t_fixed_decimal balance_all_f = safe_decimal(balance_all.toStdString());
+        m_row_changes.start();
         for (auto&& [coin, cfg]: coins)
         {
-            auto res = this->match(this->index(0, 0), TickerRole, QString::fromStdString(coin), 1, Qt::MatchFlag::MatchExactly);
-            // assert(not res.empty());
-            if (not res.empty())
+            if (const auto row = m_ticker_registry.find(coin); row)
             {
-                t_float_50 balance_all_f         = safe_float(balance_all.toStdString());
-                t_float_50 main_currency_balance = safe_float(this->data(res.at(0), MainCurrencyBalanceRole).toString().toStdString());
+                const QModelIndex idx                   = this->index(static_cast<int>(*row), 0);
+                t_fixed_decimal   main_currency_balance = safe_decimal(m_model_data.at(static_cast<int>(*row)).main_currency_balance.toStdString());
                 if (balance_all_f > 0 && main_currency_balance > 0)
                 {
-                    t_float_50 res_f   = (100 * main_currency_balance) / balance_all_f;
-                    auto       percent = QString::fromStdString(res_f.str(2, std::ios::fixed));
-                    update_value(PortfolioRoles::PercentMainCurrency, percent, res.at(0), *this);
+                    t_fixed_decimal res_f   = (t_fixed_decimal(100) * main_currency_balance) / balance_all_f;
+                    auto            percent = QString::fromStdString(res_f.str(2));
+                    update_value(PortfolioRoles::PercentMainCurrency, percent, idx, *this);
                 }
-                // update_value(PortfolioRoles::PrivKey, "", res.at(0), *this);
             }
         }
+        flush_row_changes();
     }
 } // namespace atomic_dex
@@ -21,9 +21,6 @@
 #include <QString>
 #include <QVector>
 
-//! STD
-#include <unordered_set>
-
 //! Deps
 #include <entt/core/attribute.h>
 
@@ -33,6 +30,7 @@
 #include "atomicdex/events/events.hpp"
 #include "atomicdex/models/qt.portfolio.proxy.filter.model.hpp"
 #include "atomicdex/services/mm2/mm2.service.hpp"
+#include "atomicdex/utilities/keyed.row.index.hpp"
 
 namespace atomic_dex
 {
@@ -75,7 +73,7 @@ namespace atomic_dex
 
       private:
         //! Typedef
-        using t_ticker_registry = std::unordered_set<std::string>;
+        using t_ticker_registry = keyed_row_index; ///< ticker -> row
 
       public:
         using t_portfolio_datas = QVector<portfolio_data>;
@@ -118,6 +116,8 @@ namespace atomic_dex
 
       private:
         void balance_update_handler(const QString& prev_value, const QString& new_value, const QString& ticker);
+        void flush_row_changes();
+
         //! From project
         ag::ecs::system_manager& m_system_manager;
         entt::dispatcher&        m_dispatcher;
@@ -129,6 +129,7 @@ namespace atomic_dex
         //! Data holders
         t_portfolio_datas m_model_data;
         t_ticker_registry m_ticker_registry;
+        row_changes       m_row_changes; ///< setData calls are batched while recording
     };
 
 } // namespace atomic_dex
@@ -115,7 +115,14 @@ namespace atomic_dex
             break;
         }
         }
-        emit dataChanged(index, index, {role});
+        if (m_row_changes.is_recording())
+        {
+            m_row_changes.add(static_cast<std::size_t>(index.row()), role);
+        }
+        else
+        {
+            emit dataChanged(index, index, {role});
+        }
         return true;
     }
 
@@ -188,6 +195,7 @@ namespace atomic_dex
         this->m_file_count = 0;
         this->beginResetModel();
         this->m_model_data.clear();
+        this->m_tx_registry.clear();
         this->endResetModel();
         emit lengthChanged();
     }
@@ -201,6 +209,7 @@ namespace atomic_dex
             //! First time insertion
             beginResetModel();
             m_model_data = transactions;
+            m_tx_registry.reset(m_model_data, [](const tx_infos& tx) { return tx.tx_hash; });
             m_file_count = transactions.size() < g_file_count_limit ? transactions.size() : g_file_count_limit;
             endResetModel();
         }
@@ -210,14 +219,12 @@ namespace atomic_dex
             SPDLOG_DEBUG("other time insertion, from {} to {}", m_file_count, m_file_count + transactions.size());
             beginInsertRows(QModelIndex(), m_file_count, m_file_count + transactions.size() - 1);
             m_file_count += transactions.size();
-            if (m_model_data.size() < g_file_count_limit)
-            {
-                m_model_data.insert(end(m_model_data), begin(transactions), end(transactions));
-            }
-            else
-            {
-                m_model_data.insert(begin(m_model_data) + g_file_count_limit, begin(transactions), end(transactions));
-            }
+            const std::size_t position = m_model_data.size() < g_file_count_limit ? m_model_data.size() : g_file_count_limit;
+            m_model_data.insert(begin(m_model_data) + position, begin(transactions), end(transactions));
+            std::vector<std::string> keys;
+            keys.reserve(transactions.size());
+            for (auto&& tx: transactions) { keys.push_back(tx.tx_hash); }
+            m_tx_registry.insert(position, std::move(keys));
             endInsertRows();
             if (this->canFetchMore(QModelIndex()) && m_model_data.size() >= g_file_count_limit)
             {
@@ -231,15 +238,43 @@ namespace atomic_dex
     void
     atomic_dex::transactions_model::update_transaction(const tx_infos& tx)
     {
-        if (const auto res = this->match(this->index(0, 0), TxHashRole, QString::fromStdString(tx.tx_hash)); not res.isEmpty())
+        const auto row = m_tx_registry.find(tx.tx_hash);
+        if (!row)
         {
-            const QModelIndex& idx       = res.at(0);
-            quint64            timestamp = tx.timestamp;
-            update_value(TimestampRole, timestamp, idx, *this);
-            update_value(DateRole, QString::fromStdString(tx.date), idx, *this);
-            update_value(ConfirmationsRole, static_cast<quint64>(tx.confirmations), idx, *this);
-            update_value(UnconfirmedRole, tx.unconfirmed, idx, *this);
+            return;
         }
+        auto&      item = m_model_data[*row];
+        const bool unchanged =
+            item.timestamp == tx.timestamp && item.confirmations == tx.confirmations && item.unconfirmed == tx.unconfirmed && item.date == tx.date;
+        m_update_metrics.nb_checks += 1;
+        if (unchanged)
+        {
+            m_update_metrics.nb_skipped += 1;
+            return;
+        }
+        if (*row >= m_file_count)
+        {
+            //! Not fetched by the view yet, nobody to notify
+            item.timestamp     = tx.timestamp;
+            item.date          = tx.date;
+            item.confirmations = tx.confirmations;
+            item.unconfirmed   = tx.unconfirmed;
+            return;
+        }
+        const QModelIndex idx       = this->index(static_cast<int>(*row), 0);
+        quint64           timestamp = tx.timestamp;
+        update_value(TimestampRole, timestamp, idx, *this);
+        update_value(DateRole, QString::fromStdString(tx.date), idx, *this);
+        update_value(ConfirmationsRole, static_cast<quint64>(tx.confirmations), idx, *this);
+        update_value(UnconfirmedRole, tx.unconfirmed, idx, *this);
+    }
+
+    void
+    transactions_model::flush_row_changes()
+    {
+        m_row_changes.flush(
+            [this](std::size_t first, std::size_t last, const std::vector<int>& roles)
+            { emit dataChanged(this->index(static_cast<int>(first), 0), this->index(static_cast<int>(last), 0), QVector<int>(roles.begin(), roles.end())); });
     }
 
     void
@@ -263,7 +298,7 @@ namespace atomic_dex
                     break;
                 else
                 {
-                    if (const auto res = this->match(this->index(0, 0), TxHashRole, QString::fromStdString(cur_tx.tx_hash)); res.isEmpty())
+                    if (!m_tx_registry.contains(cur_tx.tx_hash))
                     {
                         to_init.push_back(cur_tx);
                     }
@@ -278,7 +313,9 @@ namespace atomic_dex
             // to_init = t_transactions(transactions.begin(), transactions.begin() + difference);
         }
 
+        m_row_changes.start();
         std::for_each(begin(transactions) + difference, end(transactions), [this](const tx_infos& tx) { this->update_transaction(tx); });
+        flush_row_changes();
         if (not to_init.empty())
         {
             this->init_transactions(to_init);
@@ -297,6 +334,12 @@ namespace atomic_dex
         return m_model_proxy;
     }
 
+    content_change_stage_metrics
+    transactions_model::get_update_metrics() const
+    {
+        return m_update_metrics;
+    }
+
     void
     atomic_dex::transactions_model::fetchMore(const QModelIndex& parent)
     {
@@ -23,6 +23,7 @@
 //! Project Headers
 #include "atomicdex/models/qt.wallet.transactions.proxy.filter.model.hpp"
 #include "atomicdex/services/mm2/mm2.service.hpp"
+#include "atomicdex/utilities/keyed.row.index.hpp"
 
 namespace atomic_dex
 {
@@ -32,10 +33,15 @@ namespace atomic_dex
         Q_PROPERTY(int length READ get_length NOTIFY lengthChanged);
         Q_PROPERTY(transactions_proxy_model* proxy_mdl READ get_transactions_proxy NOTIFY transactionsProxyMdlChanged)
 
-        ag::ecs::system_manager&  m_system_manager;
-        transactions_proxy_model* m_model_proxy;
-        t_transactions            m_model_data;
-        std::size_t               m_file_count{0};
+        ag::ecs::system_manager&     m_system_manager;
+        transactions_proxy_model*    m_model_proxy;
+        t_transactions               m_model_data;
+        keyed_row_index              m_tx_registry;    ///< tx_hash -> row of m_model_data, fetched or not
+        row_changes                  m_row_changes;    ///< setData calls are batched while recording
+        std::size_t                  m_file_count{0};
+        content_change_stage_metrics m_update_metrics; ///< unchanged transactions skip their setData calls
+
+        void flush_row_changes();
 
       public:
         enum TransactionsRoles
@@ -73,8 +79,9 @@ namespace atomic_dex
         bool                                 canFetchMore(const QModelIndex& parent) const final;
 
         //! Props
-        [[nodiscard]] int                       get_length() const ;
-        [[nodiscard]] transactions_proxy_model* get_transactions_proxy() const ;
+        [[nodiscard]] int                          get_length() const ;
+        [[nodiscard]] transactions_proxy_model*    get_transactions_proxy() const ;
+        [[nodiscard]] content_change_stage_metrics get_update_metrics() const;
 
       signals:
         void lengthChanged();
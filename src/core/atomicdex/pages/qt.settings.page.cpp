@@ -243,7 +243,7 @@ namespace atomic_dex
 
     void settings_page::set_custom_token_data(QVariant rpc_data)
     {
-        nlohmann::json out  = nlohmann::json::parse(QString(QJsonDocument(rpc_data.toJsonObject()).toJson()).toStdString());
+        nlohmann::json out  = qt_json_value_to_nlohmann_json(rpc_data.toJsonObject());
         m_custom_token_data = out;
         emit customTokenDataChanged();
     }
@@ -38,10 +38,52 @@ namespace atomic_dex
         system(registry), m_system_manager(system_manager),
         m_about_to_exit_the_app(exit_status), m_models{
                                                   {new qt_orderbook_wrapper(m_system_manager, dispatcher_, this),
-                                                   new market_pairs(m_system_manager, portfolio, this), new qt_orders_widget(m_system_manager, this)}}
+                                                   new market_pairs(m_system_manager, portfolio, this), new qt_orders_widget(m_system_manager, this)}},
+        m_fees_evaluation(
+            [this](const trade_preimage_key& key, pplx::cancellation_token token)
+            {
+                t_trade_preimage_request req{
+                    .base_coin = key.base, .rel_coin = key.rel, .swap_method = key.swap_method, .volume = key.volume, .price = key.price};
+
+                nlohmann::json batch            = nlohmann::json::array();
+                nlohmann::json preimage_request = ::mm2::api::template_request("trade_preimage");
+                ::mm2::api::to_json(preimage_request, req);
+                batch.push_back(preimage_request);
+                preimage_request["userpass"] = "******";
+                SPDLOG_INFO("request: {}", preimage_request.dump(-1));
+
+                return m_system_manager.get_system<mm2_service>()
+                    .get_mm2_client()
+                    .async_rpc_batch_standalone(batch, std::move(token))
+                    .then(
+                        [](web::http::http_response resp)
+                        {
+                            std::string body = TO_STD_STR(resp.extract_string(true).get());
+                            SPDLOG_INFO("preimage answer received: {}", body);
+                            if (resp.status_code() != web::http::status_codes::OK)
+                            {
+                                throw std::runtime_error("trade_preimage answered with status " + std::to_string(resp.status_code()));
+                            }
+                            return nlohmann::json::parse(body).at(0);
+                        });
+            },
+            [this]([[maybe_unused]] const trade_preimage_key& key, std::optional<nlohmann::json> answer) { on_preimage_answer(std::move(answer)); })
     {
         //! Sets default trading mode to the last saved one.
         set_current_trading_mode((TradingMode)entity_registry_.template ctx<QSettings>().value("DefaultTradingMode", 1).toInt());
+
+        m_fees_evaluation_timer = new QTimer(this);
+        m_fees_evaluation_timer->setSingleShot(true);
+        m_fees_evaluation_timer->setTimerType(Qt::PreciseTimer);
+        connect(m_fees_evaluation_timer, &QTimer::timeout, this, &trading_page::run_fees_evaluation);
+    }
+
+    trading_page::~trading_page()
+    {
+        const auto metrics = m_fees_evaluation.get_metrics();
+        SPDLOG_INFO(
+            "trade_preimage evaluations -> hits: {}, misses: {}, coalesced: {}, cancelled: {}, failed: {}", metrics.nb_hits, metrics.nb_misses,
+            metrics.nb_coalesced, metrics.nb_cancelled, metrics.nb_failed);
     }
 } // namespace atomic_dex
 
@@ -58,6 +100,35 @@ namespace atomic_dex
             determine_max_volume();
         }
     }
+
+    void
+    trading_page::on_ticker_balance_updated(const ticker_balance_updated& evt)
+    {
+        //! The fees and the required balances of a trade_preimage depend on the balances
+        for (auto&& ticker: evt.tickers) { m_fees_evaluation.invalidate(ticker); }
+        if (!m_about_to_exit_the_app)
+        {
+            m_actions_queue.push(trading_actions::refresh_orderbook_computed_roles);
+        }
+    }
+
+    void
+    trading_page::on_fiat_rate_updated([[maybe_unused]] const fiat_rate_updated& evt)
+    {
+        if (!m_about_to_exit_the_app)
+        {
+            m_actions_queue.push(trading_actions::refresh_orderbook_computed_roles);
+        }
+    }
+
+    void
+    trading_page::on_band_oracle_refreshed([[maybe_unused]] const band_oracle_refreshed& evt)
+    {
+        if (!m_about_to_exit_the_app)
+        {
+            m_actions_queue.push(trading_actions::refresh_orderbook_computed_roles);
+        }
+    }
 } // namespace atomic_dex
 
 //! Public QML API
@@ -450,24 +521,31 @@ namespace atomic_dex
     trading_page::connect_signals()
     {
         dispatcher_.sink<process_orderbook_finished>().connect<&trading_page::on_process_orderbook_finished_event>(*this);
+        dispatcher_.sink<ticker_balance_updated>().connect<&trading_page::on_ticker_balance_updated>(*this);
+        dispatcher_.sink<fiat_rate_updated>().connect<&trading_page::on_fiat_rate_updated>(*this);
+        dispatcher_.sink<band_oracle_refreshed>().connect<&trading_page::on_band_oracle_refreshed>(*this);
     }
 
     void
     trading_page::disconnect_signals()
     {
         dispatcher_.sink<process_orderbook_finished>().disconnect<&trading_page::on_process_orderbook_finished_event>(*this);
+        dispatcher_.sink<ticker_balance_updated>().disconnect<&trading_page::on_ticker_balance_updated>(*this);
+        dispatcher_.sink<fiat_rate_updated>().disconnect<&trading_page::on_fiat_rate_updated>(*this);
+        dispatcher_.sink<band_oracle_refreshed>().disconnect<&trading_page::on_band_oracle_refreshed>(*this);
     }
 
     void
     trading_page::process_action()
     {
-        if (m_actions_queue.empty() || m_about_to_exit_the_app)
-        {
-            return;
-        }
-        const auto&     mm2_system = m_system_manager.get_system<mm2_service>();
         trading_actions last_action;
-        this->m_actions_queue.pop(last_action);
+        while (!m_about_to_exit_the_app && this->m_actions_queue.pop(last_action)) { process_action(last_action); }
+    }
+
+    void
+    trading_page::process_action(trading_actions last_action)
+    {
+        const auto& mm2_system = m_system_manager.get_system<mm2_service>();
         if (mm2_system.is_mm2_running())
         {
             switch (last_action)
@@ -516,6 +594,9 @@ namespace atomic_dex
                 }
                 break;
             }
+            case trading_actions::refresh_orderbook_computed_roles:
+                get_orderbook_wrapper()->refresh_computed_roles();
+                break;
             default:
                 break;
             }
@@ -1028,7 +1109,7 @@ namespace atomic_dex
     void
     trading_page::set_preferred_order(const QVariantMap& price_object)
     {
-        if (auto preferred_order = nlohmann::json::parse(QString(QJsonDocument(QJsonObject::fromVariantMap(price_object)).toJson()).toStdString());
+        if (auto preferred_order = qt_json_value_to_nlohmann_json(QJsonObject::fromVariantMap(price_object));
             preferred_order != m_preferred_order)
         {
             SPDLOG_INFO("preferred_order: {}", preferred_order.dump(-1));
@@ -1133,76 +1214,101 @@ namespace atomic_dex
         }
         using namespace std::string_literals;
         const auto* market_pair = get_market_pairs_mdl();
-        auto&       mm2         = this->m_system_manager.get_system<mm2_service>();
         const auto  base        = market_pair->get_left_selected_coin().toStdString();
         const auto  rel         = market_pair->get_right_selected_coin().toStdString();
         const auto  swap_method = m_market_mode == MarketMode::Sell ? "sell"s : "buy"s;
 
-        t_trade_preimage_request req{
-            .base_coin = base, .rel_coin = rel, .swap_method = swap_method, .volume = get_volume().toStdString(), .price = get_price().toStdString()};
+        //! Sent by the evaluation timer once the edits settled, an answer already cached is applied right away
+        this->set_preimage_busy(true);
+        m_fees_evaluation.submit(
+            trade_preimage_key{.base = base, .rel = rel, .swap_method = swap_method, .volume = get_volume().toStdString(), .price = get_price().toStdString()},
+            trade_evaluation_engine::t_clock::now());
+        //! The timer lives in the Qt thread, the fees may be determined from an mm2 event.
+        QMetaObject::invokeMethod(this, &trading_page::arm_fees_evaluation_timer, Qt::AutoConnection);
+    }
 
-        nlohmann::json batch;
-        nlohmann::json preimage_request = ::mm2::api::template_request("trade_preimage");
-        ::mm2::api::to_json(preimage_request, req);
-        batch.push_back(preimage_request);
-        preimage_request["userpass"] = "******";
-        SPDLOG_INFO("request: {}", preimage_request.dump(-1));
+    void
+    trading_page::arm_fees_evaluation_timer()
+    {
+        const auto deadline = m_fees_evaluation.next_deadline();
+        if (!deadline)
+        {
+            m_fees_evaluation_timer->stop();
+            return;
+        }
+        const auto now   = trade_evaluation_engine::t_clock::now();
+        const auto delay = *deadline <= now ? std::chrono::milliseconds::zero() : std::chrono::ceil<std::chrono::milliseconds>(*deadline - now);
+        m_fees_evaluation_timer->start(static_cast<int>(delay.count()));
+    }
 
-        this->set_preimage_busy(true);
-        auto answer_functor = [this, &mm2](web::http::http_response resp)
+    void
+    trading_page::run_fees_evaluation()
+    {
+        if (m_about_to_exit_the_app || !m_system_manager.has_system<mm2_service>())
         {
-            std::string body = TO_STD_STR(resp.extract_string(true).get());
-            SPDLOG_INFO("preimage answer received: {}", body);
-            if (resp.status_code() == web::http::status_codes::OK)
+            return;
+        }
+        m_fees_evaluation.run_due(trade_evaluation_engine::t_clock::now());
+        //! A newer edit submitted meanwhile has its own deadline.
+        arm_fees_evaluation_timer();
+    }
+
+    void
+    trading_page::on_preimage_answer(std::optional<nlohmann::json> answer)
+    {
+        if (answer.has_value() && m_system_manager.has_system<mm2_service>())
+        {
+            auto& mm2                   = this->m_system_manager.get_system<mm2_service>();
+            auto  trade_preimage_answer = ::mm2::api::rpc_process_answer_batch<t_trade_preimage_answer>(answer.value(), "trade_preimage");
+            if (trade_preimage_answer.error.has_value())
             {
-                auto           answers               = nlohmann::json::parse(body);
-                nlohmann::json answer                = answers[0];
-                auto           trade_preimage_answer = ::mm2::api::rpc_process_answer_batch<t_trade_preimage_answer>(answer, "trade_preimage");
-                if (trade_preimage_answer.error.has_value())
-                {
-                    auto        error_answer = trade_preimage_answer.error.value();
-                    QVariantMap fees;
-                    fees["error"] = QString::fromStdString(error_answer);
-                    this->set_fees(fees);
-                }
-                if (trade_preimage_answer.result.has_value())
-                {
-                    auto        success_answer = trade_preimage_answer.result.value();
-                    QVariantMap fees;
+                auto        error_answer = trade_preimage_answer.error.value();
+                QVariantMap fees;
+                fees["error"] = QString::fromStdString(error_answer);
+                this->set_fees(fees);
+            }
+            if (trade_preimage_answer.result.has_value())
+            {
+                auto        success_answer = trade_preimage_answer.result.value();
+                QVariantMap fees;
 
-                    const auto trading_fee_ticker = QString::fromStdString(success_answer.taker_fee.value().coin);
+                const auto trading_fee_ticker = QString::fromStdString(success_answer.taker_fee.value().coin);
 
-                    //! Trading fee are taker_fee
-                    fees["trading_fee"]        = QString::fromStdString(utils::adjust_precision(success_answer.taker_fee.value().amount));
-                    fees["trading_fee_ticker"] = trading_fee_ticker;
+                //! Trading fee are taker_fee
+                fees["trading_fee"]        = QString::fromStdString(utils::adjust_precision(success_answer.taker_fee.value().amount));
+                fees["trading_fee_ticker"] = trading_fee_ticker;
 
-                    fees["base_transaction_fees"]        = QString::fromStdString(utils::adjust_precision(success_answer.base_coin_fee.amount));
-                    fees["base_transaction_fees_ticker"] = QString::fromStdString(success_answer.base_coin_fee.coin);
+                fees["base_transaction_fees"]        = QString::fromStdString(utils::adjust_precision(success_answer.base_coin_fee.amount));
+                fees["base_transaction_fees_ticker"] = QString::fromStdString(success_answer.base_coin_fee.coin);
 
-                    fees["rel_transaction_fees"]        = QString::fromStdString(success_answer.rel_coin_fee.amount);
-                    fees["rel_transaction_fees_ticker"] = QString::fromStdString(success_answer.rel_coin_fee.coin);
+                fees["rel_transaction_fees"]        = QString::fromStdString(success_answer.rel_coin_fee.amount);
+                fees["rel_transaction_fees_ticker"] = QString::fromStdString(success_answer.rel_coin_fee.coin);
 
-                    //! We are always in buy or sell mode, in this case show the fees
-                    fees["fee_to_send_taker_fee"]        = QString::fromStdString(utils::adjust_precision(success_answer.fee_to_send_taker_fee.value().amount));
-                    fees["fee_to_send_taker_fee_ticker"] = QString::fromStdString(success_answer.fee_to_send_taker_fee.value().coin);
+                //! We are always in buy or sell mode, in this case show the fees
+                fees["fee_to_send_taker_fee"]        = QString::fromStdString(utils::adjust_precision(success_answer.fee_to_send_taker_fee.value().amount));
+                fees["fee_to_send_taker_fee_ticker"] = QString::fromStdString(success_answer.fee_to_send_taker_fee.value().coin);
 
 
-                    for (auto&& cur: success_answer.total_fees)
+                for (auto&& cur: success_answer.total_fees)
+                {
+                    if (!mm2.do_i_have_enough_funds(cur.at("coin").get<std::string>(), cur.at("required_balance").get<std::string>()))
                     {
-                        if (!mm2.do_i_have_enough_funds(cur.at("coin").get<std::string>(), safe_float(cur.at("required_balance").get<std::string>())))
-                        {
-                            fees["error_fees"] = atomic_dex::nlohmann_json_object_to_qt_json_object(cur);
-                            break;
-                        }
+                        fees["error_fees"] = atomic_dex::nlohmann_json_object_to_qt_json_object(cur);
+                        break;
                     }
-                    fees["total_fees"] = atomic_dex::nlohmann_json_array_to_qt_json_array(success_answer.total_fees);
-
-                    this->set_fees(fees);
                 }
+                fees["total_fees"] = atomic_dex::nlohmann_json_array_to_qt_json_array(success_answer.total_fees);
+
+                this->set_fees(fees);
             }
-            this->set_preimage_busy(false);
-        };
-        mm2.get_mm2_client().async_rpc_batch_standalone(batch).then(answer_functor).then(&handle_exception_pplx_task);
+        }
+        this->set_preimage_busy(false);
+    }
+
+    trade_evaluation_metrics
+    trading_page::get_fees_evaluation_metrics() const
+    {
+        return m_fees_evaluation.get_metrics();
     }
 
     void
@@ -1377,7 +1483,7 @@ namespace atomic_dex
         if (fees.contains("error_fees"))
         {
             auto&& cur_obj = fees.value("error_fees").toJsonObject();
-            if (!mm2.do_i_have_enough_funds(cur_obj["coin"].toString().toStdString(), safe_float(cur_obj["required_balance"].toString().toStdString())))
+            if (!mm2.do_i_have_enough_funds(cur_obj["coin"].toString().toStdString(), cur_obj["required_balance"].toString().toStdString()))
             {
                 last_trading_error = TradingError::TotalFeesNotEnoughFunds;
             }
@@ -1460,6 +1566,8 @@ namespace atomic_dex
     trading_page::reset_fees()
     {
         SPDLOG_INFO("reset_fees");
+        m_fees_evaluation.cancel();
+        this->set_preimage_busy(false);
         this->set_fees(QVariantMap());
         this->determine_error_cases();
     }
@@ -21,6 +21,7 @@
 
 //! QT
 #include <QObject>
+#include <QTimer>
 
 //! Project Headers
 #include "atomicdex/constants/qt.actions.hpp"
@@ -28,6 +29,7 @@
 #include "atomicdex/events/events.hpp"
 #include "atomicdex/events/qt.events.hpp"
 #include "atomicdex/models/qt.portfolio.model.hpp"
+#include "atomicdex/services/mm2/mm2.trade.evaluation.engine.hpp"
 #include "widgets/dex/qt.market.pairs.hpp"
 #include "widgets/dex/qt.orderbook.hpp"
 #include "widgets/dex/qt.orders.widget.hpp"
@@ -88,7 +90,8 @@ namespace atomic_dex
 
         enum class trading_actions
         {
-            post_process_orderbook_finished = 0,
+            post_process_orderbook_finished  = 0,
+            refresh_orderbook_computed_roles = 1, ///< balance or price change
         };
 
         //! Private typedefs
@@ -123,6 +126,10 @@ namespace atomic_dex
         boost::synchronized_value<QVariantMap> m_fees;
         bool                                   m_skip_taker{false};
 
+        //! trade_preimage of the form, debounced and cached (fees)
+        trade_evaluation_engine m_fees_evaluation;
+        QTimer*                 m_fees_evaluation_timer{nullptr}; ///< single shot, fires when the debounce window of the pending evaluation is over
+
         //! Private function
         void                       determine_max_volume();
         void                       determine_total_amount();
@@ -131,6 +138,10 @@ namespace atomic_dex
         [[nodiscard]] t_float_50   get_max_balance_without_dust(const std::optional<QString>& trade_with = std::nullopt) const;
         [[nodiscard]] TradingError generate_fees_error(QVariantMap fees) const;
         void                       set_preferred_settings();
+        void                       on_preimage_answer(std::optional<nlohmann::json> answer);
+        void                       arm_fees_evaluation_timer();
+        void                       run_fees_evaluation();
+        void                       process_action(trading_actions action);
         static QString                    calculate_total_amount(QString price, QString volume) ;
 
       public:
@@ -138,13 +149,13 @@ namespace atomic_dex
         explicit trading_page(
             entt::registry& registry, ag::ecs::system_manager& system_manager, std::atomic_bool& exit_status, portfolio_model* portfolio,
             QObject* parent = nullptr);
-        ~trading_page() final = default;
+        ~trading_page() final;
 
         //! Public override
         void update() final;
 
         //! Public API
-        void process_action();
+        void process_action(); ///< handles every queued action, the scheduler coalesces the wakeups
         void connect_signals();
         void disconnect_signals();
         void clear_models() const;
@@ -216,8 +227,14 @@ namespace atomic_dex
         [[nodiscard]] QVariant        get_buy_sell_last_rpc_data() const;
         void                          set_buy_sell_last_rpc_data(const QVariant& rpc_data);
 
+        //! Metrics
+        [[nodiscard]] trade_evaluation_metrics get_fees_evaluation_metrics() const;
+
         //! Events Callbacks
         void on_process_orderbook_finished_event(const process_orderbook_finished& evt);
+        void on_ticker_balance_updated(const ticker_balance_updated& evt);
+        void on_fiat_rate_updated(const fiat_rate_updated& evt);
+        void on_band_oracle_refreshed(const band_oracle_refreshed& evt);
 
       signals:
         void orderbookChanged();
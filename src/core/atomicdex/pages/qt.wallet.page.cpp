@@ -482,7 +482,7 @@ namespace atomic_dex
         if (with_fees)
         {
             qDebug() << fees_data;
-            auto json_fees    = nlohmann::json::parse(QString(QJsonDocument(QVariant(fees_data).toJsonObject()).toJson()).toStdString());
+            auto json_fees    = qt_json_value_to_nlohmann_json(QVariant(fees_data).toJsonObject());
             withdraw_req.fees = t_withdraw_fees{
                 .type      = "UtxoFixed",
                 .amount    = json_fees.at("fees_amount").get<std::string>(),
@@ -870,7 +870,7 @@ namespace atomic_dex
         if (mm2_system.is_mm2_running())
         {
             QVariantMap               out         = to_address_format.value<QVariantMap>();
-            auto                      address_fmt = nlohmann::json::parse(QJsonDocument::fromVariant(out).toJson().toStdString());
+            auto                      address_fmt = qt_json_value_to_nlohmann_json(QJsonObject::fromVariantMap(out));
             t_convert_address_request req{.coin = ticker.toStdString(), .from = from.toStdString(), .to_address_format = address_fmt};
             this->set_convert_address_busy(true);
             nlohmann::json batch     = nlohmann::json::array();
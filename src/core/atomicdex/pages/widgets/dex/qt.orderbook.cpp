@@ -96,7 +96,13 @@ namespace atomic_dex
         else
         {
             m_best_orders->refresh_orderbook(data);
+            if (m_best_orders_inputs_changed)
+            {
+                //! The send amounts of every best order follow the volume
+                m_best_orders->refresh_computed_roles();
+            }
         }
+        m_best_orders_inputs_changed = false;
         this->set_both_taker_vol();
     }
 
@@ -116,6 +122,14 @@ namespace atomic_dex
         this->m_system_manager.get_system<orderbook_scanner_service>().process_best_orders(); ///< re process the model
     }
 
+    void
+    qt_orderbook_wrapper::refresh_computed_roles()
+    {
+        this->m_asks->refresh_computed_roles();
+        this->m_bids->refresh_computed_roles();
+        this->m_best_orders->refresh_computed_roles();
+    }
+
     void
     qt_orderbook_wrapper::clear_orderbook()
     {
@@ -139,7 +153,9 @@ namespace atomic_dex
     void
     atomic_dex::qt_orderbook_wrapper::set_both_taker_vol()
     {
-        auto&& [base, rel]         = m_system_manager.get_system<mm2_service>().get_taker_vol();
+        auto&& [base, rel]               = m_system_manager.get_system<mm2_service>().get_taker_vol();
+        const bool max_taker_vol_changed = m_base_max_taker_vol.value("decimal").toString().toStdString() != base.decimal ||
+                                           m_rel_max_taker_vol.value("decimal").toString().toStdString() != rel.decimal;
         this->m_base_max_taker_vol = QJsonObject{
             {"denom", QString::fromStdString(base.denom)},
             {"numer", QString::fromStdString(base.numer)},
@@ -160,6 +176,13 @@ namespace atomic_dex
         emit relMinTakerVolChanged();
 
         emit currentMinTakerVolChanged();
+
+        if (max_taker_vol_changed)
+        {
+            //! EnoughFundsToPayMinVolume of every order compares against the max taker volumes
+            this->m_asks->refresh_computed_roles();
+            this->m_bids->refresh_computed_roles();
+        }
     }
 } // namespace atomic_dex
 
@@ -169,6 +192,7 @@ namespace atomic_dex
     void
     qt_orderbook_wrapper::refresh_best_orders()
     {
+        m_best_orders_inputs_changed = true;
         if (safe_float(m_system_manager.get_system<trading_page>().get_volume().toStdString()) > 0)
         {
             // SPDLOG_INFO("refresh best orders");
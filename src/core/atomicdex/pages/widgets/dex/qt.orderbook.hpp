@@ -50,6 +50,7 @@ namespace atomic_dex
         void                           refresh_orderbook(t_orderbook_answer answer);
         void                           reset_orderbook(t_orderbook_answer answer);
         void                           clear_orderbook();
+        void                           refresh_computed_roles(); ///< balance or price change, recomputes the roles derived from them on every order
         [[nodiscard]] orderbook_model* get_asks() const;
         [[nodiscard]] orderbook_model* get_bids() const;
         [[nodiscard]] orderbook_model* get_best_orders() const;
@@ -86,5 +87,6 @@ namespace atomic_dex
         QString                                               m_base_min_taker_vol;
         QString                                               m_rel_min_taker_vol;
         boost::synchronized_value<std::optional<QVariantMap>> m_selected_best_order{std::nullopt};
+        bool                                                  m_best_orders_inputs_changed{false}; ///< volume or side changed since the last refresh
     };
 } // namespace atomic_dex
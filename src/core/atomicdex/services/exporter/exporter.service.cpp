@@ -15,10 +15,9 @@
  ******************************************************************************/
 
 //! Std
-#include <sstream>
-
-//! Qt
-#include <QFile>
+#include <algorithm>
+#include <functional>
+#include <memory>
 
 //! Deps
 #include <nlohmann/json.hpp>
@@ -29,6 +28,59 @@
 #include "atomicdex/services/mm2/mm2.service.hpp"
 #include "atomicdex/utilities/qt.utilities.hpp"
 
+namespace
+{
+    using atomic_dex::swaps_export_result;
+
+    //! One export in flight, shared by the continuations of its page requests.
+    struct export_job
+    {
+        using t_async_page_fetcher = std::function<pplx::task<std::optional<nlohmann::json>>(const std::optional<std::string>& from_uuid, std::size_t limit)>;
+
+        export_job(
+            fs::path path, atomic_dex::swaps_export_format format, const std::atomic_bool& cancelled, atomic_dex::t_swaps_progress_functor on_progress) :
+            writer(std::move(path), format),
+            pager(writer, atomic_dex::exporter_service::g_export_page_size, cancelled, std::move(on_progress))
+        {
+        }
+
+        atomic_dex::swaps_export_writer                 writer;
+        atomic_dex::swaps_export_pager                  pager;
+        t_async_page_fetcher                            fetcher;
+        std::function<void(const swaps_export_result&)> on_done;
+    };
+
+    //! The next page is requested from the continuation of the previous one, no thread waits for an answer.
+    void
+    request_export_page(std::shared_ptr<export_job> job)
+    {
+        try
+        {
+            job->fetcher(job->pager.next_from_uuid(), job->pager.page_size())
+                .then(
+                    [job](pplx::task<std::optional<nlohmann::json>> previous_task)
+                    {
+                        bool more = false;
+                        try
+                        {
+                            more = job->pager.on_page(previous_task.get());
+                        }
+                        catch (const std::exception& error)
+                        {
+                            job->pager.fail(error.what());
+                        }
+                        more ? request_export_page(job) : job->on_done(job->pager.result());
+                    });
+        }
+        catch (const std::exception& error)
+        {
+            //! The request could not even be sent, the export still has to end.
+            job->pager.fail(error.what());
+            job->on_done(job->pager.result());
+        }
+    }
+} // namespace
+
 //! Constructor
 namespace atomic_dex
 {
@@ -55,73 +107,139 @@ namespace atomic_dex
     void
     exporter_service::export_swaps_history_to_csv(const QString& path)
     {
-        std::string str_path = path.toStdString();
-        fs::path    csv_path = str_path;
+        export_swaps_history(path, "csv");
+    }
 
-        if (not csv_path.has_extension())
+    void
+    exporter_service::export_swaps_history(const QString& path, const QString& format)
+    {
+        if (m_is_exporting.exchange(true))
         {
-            SPDLOG_WARN("csv path doesn't contains file extensions adding it");
-            str_path += ".csv";
-            csv_path = str_path;
-            LOG_PATH("new csv path is: {}", csv_path);
+            SPDLOG_WARN("an export is already running, ignoring the new one");
+            return;
         }
-        nlohmann::json            batch           = nlohmann::json::array();
-        nlohmann::json            my_recent_swaps = ::mm2::api::template_request("my_recent_swaps");
-        auto&                     mm2             = m_system_manager.get_system<mm2_service>();
-        const auto                swaps_data      = mm2.get_orders_and_swaps();
-        t_my_recent_swaps_request request{
-            .limit          = swaps_data.total_finished_swaps,
-            .page_number    = 1,
-            .my_coin        = swaps_data.filtering_infos.my_coin,
-            .other_coin     = swaps_data.filtering_infos.other_coin,
-            .from_timestamp = swaps_data.filtering_infos.from_timestamp,
-            .to_timestamp   = swaps_data.filtering_infos.to_timestamp};
-        to_json(my_recent_swaps, request);
-        batch.push_back(my_recent_swaps);
-
-        auto answer_functor = [csv_path](web::http::http_response resp) {
-            auto       answers     = ::mm2::api::basic_batch_answer(resp);
-            const auto swap_answer = ::mm2::api::rpc_process_answer_batch<t_my_recent_swaps_answer>(answers[0], "my_recent_swaps");
-            if (swap_answer.result.has_value())
-            {
-                const auto result = swap_answer.result.value();
-                LOG_PATH("exporting csv with path: {}", csv_path);
-                QFile ofs;
-                ofs.setFileName(std_path_to_qstring(csv_path));
-                ofs.open(QIODevice::Text | QIODevice::WriteOnly | QIODevice::Truncate);
-                std::stringstream ss;
-                ss << "Date,BaseCoin,BaseAmount,Status,RelCoin,RelAmount,UUID,ErrorState" << std::endl;
-                for (auto&& cur_swap: result.swaps)
-                {
-                    ss << cur_swap.human_date.toStdString() << ",";
-                    ss << cur_swap.base_coin.toStdString() << ",";
-                    ss << cur_swap.base_amount.toStdString() << ",";
-                    const auto status = cur_swap.order_status.toStdString();
-                    ss << status << ",";
-                    ss << cur_swap.rel_coin.toStdString() << ",";
-                    ss << cur_swap.rel_amount.toStdString() << ",";
-                    ss << cur_swap.order_id.toStdString();
-                    if (status == "failed")
-                    {
-                        ss << "," << cur_swap.order_error_state.toStdString() << std::endl;
-                    }
-                    else
+
+        swaps_export_format export_format = swaps_export_format::csv;
+        std::string         extension     = ".csv";
+        if (format == "jsonl")
+        {
+            export_format = swaps_export_format::json_lines;
+            extension     = ".jsonl";
+        }
+        else if (format == "adxc")
+        {
+            export_format = swaps_export_format::columnar;
+            extension     = ".adxc";
+        }
+
+        std::string str_path    = path.toStdString();
+        fs::path    export_path = str_path;
+        if (not export_path.has_extension())
+        {
+            SPDLOG_WARN("export path doesn't contains file extensions adding it");
+            str_path += extension;
+            export_path = str_path;
+            LOG_PATH("new export path is: {}", export_path);
+        }
+
+        m_export_cancelled = false;
+        m_export_progress  = 0;
+        emit isExportingChanged();
+        emit exportProgressChanged();
+
+        auto&      mm2        = m_system_manager.get_system<mm2_service>();
+        const auto swaps_data = mm2.get_orders_and_swaps();
+        const auto filters    = swaps_data.filtering_infos;
+
+        const auto on_progress = [this](const swaps_export_progress& progress)
+        {
+            const auto total  = std::max(progress.total, progress.rows);
+            m_export_progress = total == 0 ? 100 : static_cast<int>(progress.rows * 100 / total);
+            emit exportProgressChanged();
+        };
+        auto job     = std::make_shared<export_job>(export_path, export_format, m_export_cancelled, on_progress);
+        job->fetcher = [&mm2, filters](const std::optional<std::string>& from_uuid, std::size_t limit)
+        {
+            nlohmann::json            batch           = nlohmann::json::array();
+            nlohmann::json            my_recent_swaps = ::mm2::api::template_request("my_recent_swaps");
+            t_my_recent_swaps_request request{
+                .limit          = limit,
+                .page_number    = from_uuid.has_value() ? std::nullopt : std::optional<std::size_t>{1},
+                .from_uuid      = from_uuid,
+                .my_coin        = filters.my_coin,
+                .other_coin     = filters.other_coin,
+                .from_timestamp = filters.from_timestamp,
+                .to_timestamp   = filters.to_timestamp};
+            to_json(my_recent_swaps, request);
+            batch.push_back(my_recent_swaps);
+
+            return mm2.get_mm2_client()
+                .async_rpc_batch_standalone(batch)
+                .then(
+                    [](web::http::http_response resp) -> std::optional<nlohmann::json>
                     {
-                        ss << ",Success" << std::endl;
-                    }
-                }
-                ofs.write(QString::fromStdString(ss.str()).toUtf8());
-                ofs.close();
+                        auto answers = ::mm2::api::basic_batch_answer(resp);
+                        if (!answers.is_array() || answers.empty() || !answers[0].contains("result"))
+                        {
+                            if (answers.is_array() && !answers.empty() && answers[0].contains("error"))
+                            {
+                                SPDLOG_ERROR("error during swap request: {}", answers[0].at("error").dump());
+                            }
+                            return std::nullopt;
+                        }
+                        return std::move(answers[0].at("result"));
+                    });
+        };
+        job->on_done = [this, export_path](const swaps_export_result& result)
+        {
+            switch (result.status)
+            {
+            case swaps_export_status::finished:
+                SPDLOG_INFO("swaps history exported: {} rows, {} bytes", result.rows, result.bytes);
+                break;
+            case swaps_export_status::cancelled:
+                SPDLOG_INFO("swaps history export cancelled after {} rows", result.rows);
+                break;
+            case swaps_export_status::failed:
+                SPDLOG_ERROR("swaps history export failed: {}", result.error);
+                break;
             }
-            else
+            m_is_exporting = false;
+            emit isExportingChanged();
+            emit exportFinished(result.status == swaps_export_status::finished, std_path_to_qstring(export_path));
+        };
+
+        pplx::create_task(
+            [job, export_path]()
             {
-                if (swap_answer.error.has_value())
+                LOG_PATH("exporting swaps history with path: {}", export_path);
+                if (job->pager.start())
                 {
-                    SPDLOG_ERROR("error during swap request: {}", swap_answer.error.value());
+                    request_export_page(job);
                 }
-            }
-        };
+                else
+                {
+                    job->on_done(job->pager.result());
+                }
+            })
+            .then(&handle_exception_pplx_task);
+    }
+
+    void
+    exporter_service::cancel_export()
+    {
+        m_export_cancelled = true;
+    }
 
-        mm2.get_mm2_client().async_rpc_batch_standalone(batch).then(answer_functor).then(&handle_exception_pplx_task);
+    bool
+    exporter_service::is_exporting() const
+    {
+        return m_is_exporting.load();
     }
-} // namespace atomic_dex
\ No newline at end of file
+
+    int
+    exporter_service::get_export_progress() const
+    {
+        return m_export_progress.load();
+    }
+} // namespace atomic_dex
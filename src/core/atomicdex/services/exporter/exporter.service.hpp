@@ -16,11 +16,15 @@
 
 #pragma once
 
+//! STD
+#include <atomic>
+
 //! Qt
 #include <QObject>
 
 //! Project Headers
 #include <antara/gaming/ecs/system.manager.hpp>
+#include "atomicdex/services/exporter/swaps.export.writer.hpp"
 
 namespace atomic_dex
 {
@@ -28,9 +32,25 @@ namespace atomic_dex
     {
         Q_OBJECT
 
+        //! Properties
+        Q_PROPERTY(bool is_exporting READ is_exporting NOTIFY isExportingChanged)
+        Q_PROPERTY(int export_progress READ get_export_progress NOTIFY exportProgressChanged)
+
+        //! Private members
         ag::ecs::system_manager& m_system_manager;
+        std::atomic_bool         m_is_exporting{false};
+        std::atomic_bool         m_export_cancelled{false};
+        std::atomic_int          m_export_progress{0}; ///< percentage of the swaps already written
+
+      signals:
+        void isExportingChanged();
+        void exportProgressChanged();
+        void exportFinished(bool success, const QString& path);
 
       public:
+        //! Swaps requested per my_recent_swaps call while exporting
+        static constexpr std::size_t g_export_page_size = 1000;
+
         //! Constructor
         explicit exporter_service(entt::registry& registry, ag::ecs::system_manager& system_manager, QObject* parent = nullptr);
 
@@ -42,6 +62,11 @@ namespace atomic_dex
 
         //! QML API
         Q_INVOKABLE void export_swaps_history_to_csv(const QString& path);
+        Q_INVOKABLE void export_swaps_history(const QString& path, const QString& format); ///< format is one of csv, jsonl, adxc
+        Q_INVOKABLE void cancel_export();
+
+        [[nodiscard]] bool is_exporting() const;
+        [[nodiscard]] int  get_export_progress() const;
     };
 } // namespace atomic_dex
 
@@ -0,0 +1,428 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+#include <chrono>
+
+//! Deps
+#include <boost/algorithm/string/case_conv.hpp>
+#include <nlohmann/json.hpp>
+
+//! Project Headers
+#include "atomicdex/api/mm2/mm2.swap.status.hpp"
+#include "atomicdex/services/exporter/swaps.export.writer.hpp"
+#include "atomicdex/utilities/global.utilities.hpp"
+
+namespace
+{
+    bool
+    needs_csv_quotes(const std::string& value)
+    {
+        return value.find_first_of(",\"\n\r") != std::string::npos;
+    }
+} // namespace
+
+namespace atomic_dex
+{
+    std::optional<swap_export_row>
+    swap_export_row::from_json(const nlohmann::json& swap)
+    {
+        if (!swap.is_object())
+        {
+            return std::nullopt;
+        }
+
+        const bool  is_maker     = boost::algorithm::to_lower_copy(swap.at("type").get<std::string>()) == "maker";
+        const auto  maker_amount = utils::adjust_precision(swap.at("maker_amount").get<std::string>());
+        const auto  taker_amount = utils::adjust_precision(swap.at("taker_amount").get<std::string>());
+        const auto& maker_coin   = swap.at("maker_coin").get_ref<const std::string&>();
+        const auto& taker_coin   = swap.at("taker_coin").get_ref<const std::string&>();
+        const auto& events       = swap.at("events");
+
+        swap_export_row row;
+        row.base_coin   = is_maker ? maker_coin : taker_coin;
+        row.rel_coin    = is_maker ? taker_coin : maker_coin;
+        row.base_amount = is_maker ? maker_amount : taker_amount;
+        row.rel_amount  = is_maker ? taker_amount : maker_amount;
+        row.uuid        = swap.at("uuid").get<std::string>();
+        row.status      = ::mm2::api::determine_swap_status(swap);
+        if (!events.empty())
+        {
+            row.date = utils::to_human_date<std::chrono::seconds>(events.back().at("timestamp").get<std::size_t>() / 1000, "%F %H:%M:%S");
+        }
+        row.error_state = row.status == "failed" ? ::mm2::api::find_swap_error_event(swap).value_or("") : "Success";
+        return row;
+    }
+
+    swaps_export_writer::swaps_export_writer(fs::path path, swaps_export_format format, std::size_t buffer_size, std::size_t row_group_size) :
+        m_path(std::move(path)), m_format(format), m_buffer_size(std::max<std::size_t>(buffer_size, 1024)),
+        m_row_group_size(std::max<std::size_t>(row_group_size, 1))
+    {
+        m_tmp_path = m_path;
+        m_tmp_path += ".part";
+    }
+
+    swaps_export_writer::~swaps_export_writer()
+    {
+        abort();
+    }
+
+    const std::vector<std::string>&
+    swaps_export_writer::column_names()
+    {
+        static const std::vector<std::string> names{"Date", "BaseCoin", "BaseAmount", "Status", "RelCoin", "RelAmount", "UUID", "ErrorState"};
+        return names;
+    }
+
+    bool
+    swaps_export_writer::open()
+    {
+        m_ofs.open(m_tmp_path.string(), std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!m_ofs.is_open())
+        {
+            return false;
+        }
+        m_is_open = true;
+        m_buffer.reserve(m_buffer_size + 1024);
+        switch (m_format)
+        {
+        case swaps_export_format::csv:
+            m_buffer += "Date,BaseCoin,BaseAmount,Status,RelCoin,RelAmount,UUID,ErrorState\n";
+            break;
+        case swaps_export_format::json_lines:
+            break;
+        case swaps_export_format::columnar:
+            m_buffer += "ADXC";
+            append_u32(m_buffer, g_columnar_version);
+            append_u32(m_buffer, static_cast<std::uint32_t>(column_names().size()));
+            for (auto&& name: column_names())
+            {
+                append_u32(m_buffer, static_cast<std::uint32_t>(name.size()));
+                m_buffer += name;
+            }
+            m_columns.assign(column_names().size(), {});
+            for (auto&& column: m_columns) { column.reserve(m_row_group_size); }
+            break;
+        }
+        return flush(false);
+    }
+
+    void
+    swaps_export_writer::append_u32(std::string& out, std::uint32_t value)
+    {
+        for (int shift = 0; shift < 32; shift += 8) { out.push_back(static_cast<char>((value >> shift) & 0xFF)); }
+    }
+
+    void
+    swaps_export_writer::append_u64(std::string& out, std::uint64_t value)
+    {
+        for (int shift = 0; shift < 64; shift += 8) { out.push_back(static_cast<char>((value >> shift) & 0xFF)); }
+    }
+
+    void
+    swaps_export_writer::append_csv(const swap_export_row& row)
+    {
+        const std::string* fields[] = {&row.date, &row.base_coin, &row.base_amount, &row.status, &row.rel_coin, &row.rel_amount, &row.uuid, &row.error_state};
+        bool               first    = true;
+        for (const auto* field: fields)
+        {
+            if (!first)
+            {
+                m_buffer.push_back(',');
+            }
+            first = false;
+            if (!needs_csv_quotes(*field))
+            {
+                m_buffer += *field;
+                continue;
+            }
+            m_buffer.push_back('"');
+            for (const char c: *field)
+            {
+                if (c == '"')
+                {
+                    m_buffer.push_back('"');
+                }
+                m_buffer.push_back(c);
+            }
+            m_buffer.push_back('"');
+        }
+        m_buffer.push_back('\n');
+    }
+
+    void
+    swaps_export_writer::append_json_line(const swap_export_row& row)
+    {
+        const nlohmann::json line{
+            {"date", row.date},         {"base_coin", row.base_coin},   {"base_amount", row.base_amount}, {"status", row.status},
+            {"rel_coin", row.rel_coin}, {"rel_amount", row.rel_amount}, {"uuid", row.uuid},               {"error_state", row.error_state}};
+        m_buffer += line.dump();
+        m_buffer.push_back('\n');
+    }
+
+    bool
+    swaps_export_writer::flush_row_group()
+    {
+        if (m_columns.empty() || m_columns.front().empty())
+        {
+            return true;
+        }
+        m_row_group_offsets.push_back(m_bytes + m_buffer.size());
+        append_u32(m_buffer, static_cast<std::uint32_t>(m_columns.front().size()));
+        for (auto&& column: m_columns)
+        {
+            std::uint64_t chunk_size = 0;
+            for (auto&& value: column) { chunk_size += sizeof(std::uint32_t) + value.size(); }
+            append_u64(m_buffer, chunk_size);
+            for (auto&& value: column)
+            {
+                append_u32(m_buffer, static_cast<std::uint32_t>(value.size()));
+                m_buffer += value;
+                if (!flush(false))
+                {
+                    return false;
+                }
+            }
+            column.clear();
+        }
+        return true;
+    }
+
+    bool
+    swaps_export_writer::flush(bool force)
+    {
+        if (m_buffer.empty() || (!force && m_buffer.size() < m_buffer_size))
+        {
+            return m_ofs.good();
+        }
+        m_ofs.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        m_bytes += m_buffer.size();
+        m_buffer.clear();
+        return m_ofs.good();
+    }
+
+    bool
+    swaps_export_writer::write(const swap_export_row& row)
+    {
+        if (!m_is_open)
+        {
+            return false;
+        }
+        switch (m_format)
+        {
+        case swaps_export_format::csv:
+            append_csv(row);
+            break;
+        case swaps_export_format::json_lines:
+            append_json_line(row);
+            break;
+        case swaps_export_format::columnar:
+        {
+            const std::string* fields[] = {&row.date, &row.base_coin, &row.base_amount, &row.status, &row.rel_coin, &row.rel_amount, &row.uuid, &row.error_state};
+            for (std::size_t idx = 0; idx < m_columns.size(); ++idx) { m_columns[idx].push_back(*fields[idx]); }
+            m_rows += 1;
+            return m_columns.front().size() < m_row_group_size || flush_row_group();
+        }
+        }
+        m_rows += 1;
+        return flush(false);
+    }
+
+    bool
+    swaps_export_writer::finish()
+    {
+        if (!m_is_open)
+        {
+            return false;
+        }
+        if (m_format == swaps_export_format::columnar)
+        {
+            if (!flush_row_group())
+            {
+                abort();
+                return false;
+            }
+            std::string footer;
+            append_u32(footer, static_cast<std::uint32_t>(m_row_group_offsets.size()));
+            for (const auto offset: m_row_group_offsets) { append_u64(footer, offset); }
+            append_u64(footer, m_rows);
+            m_buffer += footer;
+            append_u32(m_buffer, static_cast<std::uint32_t>(footer.size()));
+            m_buffer += "ADXC";
+        }
+        const bool ok = flush(true);
+        m_ofs.close();
+        m_is_open = false;
+        if (!ok || m_ofs.fail())
+        {
+            fs_error_code ec;
+            fs::remove(m_tmp_path, ec);
+            return false;
+        }
+        fs_error_code ec;
+        fs::rename(m_tmp_path, m_path, ec);
+        return !ec;
+    }
+
+    void
+    swaps_export_writer::abort()
+    {
+        if (!m_is_open)
+        {
+            return;
+        }
+        m_ofs.close();
+        m_is_open = false;
+        m_buffer.clear();
+        fs_error_code ec;
+        fs::remove(m_tmp_path, ec);
+    }
+
+    std::size_t
+    swaps_export_writer::rows_written() const noexcept
+    {
+        return m_rows;
+    }
+
+    std::size_t
+    swaps_export_writer::bytes_written() const noexcept
+    {
+        return m_bytes + m_buffer.size();
+    }
+
+    const fs::path&
+    swaps_export_writer::get_path() const noexcept
+    {
+        return m_path;
+    }
+
+    swaps_export_pager::swaps_export_pager(
+        swaps_export_writer& writer, std::size_t page_size, const std::atomic_bool& cancelled, t_swaps_progress_functor on_progress) :
+        m_writer(writer), m_page_size(page_size), m_cancelled(cancelled), m_on_progress(std::move(on_progress))
+    {
+    }
+
+    bool
+    swaps_export_pager::start()
+    {
+        if (!m_writer.open())
+        {
+            m_result.error = "unable to open " + m_writer.get_path().string();
+            return false;
+        }
+        return continue_or_cancel();
+    }
+
+    bool
+    swaps_export_pager::continue_or_cancel()
+    {
+        if (m_cancelled.load())
+        {
+            m_writer.abort();
+            m_result.status = swaps_export_status::cancelled;
+            m_result.rows   = m_writer.rows_written();
+            return false;
+        }
+        return true;
+    }
+
+    void
+    swaps_export_pager::fail(std::string error)
+    {
+        m_writer.abort();
+        m_result.status = swaps_export_status::failed;
+        m_result.error  = std::move(error);
+        m_result.rows   = m_writer.rows_written();
+    }
+
+    bool
+    swaps_export_pager::on_page(const std::optional<nlohmann::json>& page)
+    {
+        if (!page || !page->contains("swaps"))
+        {
+            fail("my_recent_swaps request failed");
+            return false;
+        }
+        if (m_progress.pages == 0)
+        {
+            m_progress.total = page->value("total", std::size_t{0});
+        }
+        m_progress.pages += 1;
+
+        const auto& swaps = page->at("swaps");
+        for (auto&& swap: swaps)
+        {
+            try
+            {
+                if (auto row = swap_export_row::from_json(swap); row && !m_writer.write(*row))
+                {
+                    fail("unable to write " + m_writer.get_path().string());
+                    return false;
+                }
+            }
+            catch (const std::exception& error)
+            {
+                SPDLOG_WARN("swap skipped from the export: {}", error.what());
+            }
+        }
+        m_progress.rows = m_writer.rows_written();
+        if (m_on_progress)
+        {
+            m_on_progress(m_progress);
+        }
+
+        //! A short page is the end of the history, otherwise the last swap holding a uuid is the anchor of the next one.
+        if (swaps.size() < m_page_size || swaps.empty())
+        {
+            return finish();
+        }
+        const auto anchor =
+            std::find_if(swaps.rbegin(), swaps.rend(), [](const nlohmann::json& swap) { return swap.contains("uuid") && swap.at("uuid").is_string(); });
+        if (anchor == swaps.rend() || anchor->at("uuid").get<std::string>() == m_from_uuid)
+        {
+            //! Without a new anchor the same page would be requested again.
+            SPDLOG_WARN("swaps export stopped at page {}: no swap uuid to continue from", m_progress.pages);
+            return finish();
+        }
+        m_from_uuid = anchor->at("uuid").get<std::string>();
+        return continue_or_cancel();
+    }
+
+    bool
+    swaps_export_pager::finish()
+    {
+        if (!m_writer.finish())
+        {
+            m_result.error = "unable to write " + m_writer.get_path().string();
+            return false;
+        }
+        m_result.status = swaps_export_status::finished;
+        m_result.rows   = m_writer.rows_written();
+        m_result.bytes  = m_writer.bytes_written();
+        return false;
+    }
+
+    swaps_export_result
+    export_swaps_pages(
+        const t_swaps_page_fetcher& fetcher, swaps_export_writer& writer, std::size_t page_size, const std::atomic_bool& cancelled,
+        const t_swaps_progress_functor& on_progress)
+    {
+        swaps_export_pager pager(writer, page_size, cancelled, on_progress);
+        for (bool more = pager.start(); more; more = pager.on_page(fetcher(pager.next_from_uuid(), page_size))) {}
+        return pager.result();
+    }
+} // namespace atomic_dex
@@ -0,0 +1,170 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+//! Deps
+#include <nlohmann/json_fwd.hpp>
+
+//! Project Headers
+#include "atomicdex/utilities/fs.prerequisites.hpp"
+
+namespace atomic_dex
+{
+    enum class swaps_export_format
+    {
+        csv,
+        json_lines,
+        columnar
+    };
+
+    //! One line of the swaps history export, decoded straight from a my_recent_swaps entry without building its events.
+    struct swap_export_row
+    {
+        std::string date;
+        std::string base_coin;
+        std::string base_amount;
+        std::string status;
+        std::string rel_coin;
+        std::string rel_amount;
+        std::string uuid;
+        std::string error_state; ///< "Success" unless the swap failed
+
+        static std::optional<swap_export_row> from_json(const nlohmann::json& swap);
+    };
+
+    //! Writes rows to `<path>.part` through a fixed size buffer, the file is renamed over `path` once finished.
+    //!
+    //! The columnar format groups `row_group_size` rows and writes them column by column:
+    //!   header:    "ADXC" u32 version, u32 nb_columns, nb_columns x (u32 size, name)
+    //!   row group: u32 nb_rows, nb_columns x (u64 chunk size, nb_rows x (u32 size, value))
+    //!   footer:    u32 nb_row_groups, nb_row_groups x u64 row group offset, u64 nb_rows, u32 footer size, "ADXC"
+    //! Integers are little endian.
+    class swaps_export_writer
+    {
+      public:
+        static constexpr std::uint32_t g_columnar_version = 1;
+
+        swaps_export_writer(fs::path path, swaps_export_format format, std::size_t buffer_size = 64 * 1024, std::size_t row_group_size = 4096);
+        swaps_export_writer(const swaps_export_writer& other) = delete;
+        swaps_export_writer& operator=(const swaps_export_writer& other) = delete;
+        ~swaps_export_writer(); ///< aborts an unfinished export
+
+        bool open();
+        bool write(const swap_export_row& row);
+        bool finish();
+        void abort(); ///< removes the partial file
+
+        [[nodiscard]] std::size_t     rows_written() const noexcept;
+        [[nodiscard]] std::size_t     bytes_written() const noexcept;
+        [[nodiscard]] const fs::path& get_path() const noexcept;
+
+        static const std::vector<std::string>& column_names();
+
+      private:
+        void append_csv(const swap_export_row& row);
+        void append_json_line(const swap_export_row& row);
+        static void append_u32(std::string& out, std::uint32_t value);
+        static void append_u64(std::string& out, std::uint64_t value);
+        bool flush_row_group();
+        bool flush(bool force);
+
+        fs::path                              m_path;
+        fs::path                              m_tmp_path;
+        swaps_export_format                   m_format;
+        std::size_t                           m_buffer_size;
+        std::size_t                           m_row_group_size;
+        std::ofstream                         m_ofs;
+        std::string                           m_buffer;
+        std::vector<std::vector<std::string>> m_columns; ///< pending row group of the columnar format
+        std::vector<std::uint64_t>            m_row_group_offsets;
+        std::size_t                           m_rows{0};
+        std::size_t                           m_bytes{0};
+        bool                                  m_is_open{false};
+    };
+
+    struct swaps_export_progress
+    {
+        std::size_t rows{0};
+        std::size_t total{0}; ///< as reported by the first page
+        std::size_t pages{0};
+    };
+
+    enum class swaps_export_status
+    {
+        finished,
+        cancelled,
+        failed
+    };
+
+    struct swaps_export_result
+    {
+        swaps_export_status status{swaps_export_status::failed};
+        std::size_t         rows{0};
+        std::size_t         bytes{0};
+        std::string         error;
+    };
+
+    //! Returns the `result` object of a my_recent_swaps request, nullopt when the request failed.
+    //! Pages are chained with `from_uuid` so swaps started during the export do not shift them.
+    using t_swaps_page_fetcher     = std::function<std::optional<nlohmann::json>(const std::optional<std::string>& from_uuid, std::size_t limit)>;
+    using t_swaps_progress_functor = std::function<void(const swaps_export_progress& progress)>;
+
+    //! Paging state of one export, fed one page at a time so that the caller can chain asynchronous my_recent_swaps requests.
+    //! Every page is written then released before the next one is requested.
+    class swaps_export_pager
+    {
+      public:
+        swaps_export_pager(swaps_export_writer& writer, std::size_t page_size, const std::atomic_bool& cancelled, t_swaps_progress_functor on_progress = {});
+
+        //! Opens the writer, returns true if a first page has to be requested.
+        bool start();
+        //! Writes a page (nullopt if its request failed), returns true if another page has to be requested.
+        bool on_page(const std::optional<nlohmann::json>& page);
+        //! Ends the export with an error, ex: the request of a page threw.
+        void fail(std::string error);
+
+        [[nodiscard]] const std::optional<std::string>& next_from_uuid() const noexcept { return m_from_uuid; }
+        [[nodiscard]] std::size_t                       page_size() const noexcept { return m_page_size; }
+        [[nodiscard]] const swaps_export_result&        result() const noexcept { return m_result; } ///< set once start or on_page returned false
+
+      private:
+        bool continue_or_cancel(); ///< false if the export was cancelled meanwhile
+        bool finish();
+
+        swaps_export_writer&       m_writer;
+        std::size_t                m_page_size;
+        const std::atomic_bool&    m_cancelled;
+        t_swaps_progress_functor   m_on_progress;
+        swaps_export_progress      m_progress;
+        std::optional<std::string> m_from_uuid;
+        swaps_export_result        m_result;
+    };
+
+    //! Pages through the swaps history with a synchronous fetcher.
+    swaps_export_result export_swaps_pages(
+        const t_swaps_page_fetcher& fetcher, swaps_export_writer& writer, std::size_t page_size, const std::atomic_bool& cancelled,
+        const t_swaps_progress_functor& on_progress = {});
+} // namespace atomic_dex
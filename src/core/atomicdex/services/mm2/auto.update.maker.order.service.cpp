@@ -27,116 +27,154 @@
 namespace atomic_dex
 {
     auto_update_maker_order_service::auto_update_maker_order_service(entt::registry& registry, ag::ecs::system_manager& system_manager) :
-        system(registry), m_system_manager(system_manager)
+        system(registry), m_system_manager(system_manager),
+        m_repricer([this](const std::string& base, const std::string& rel) { return load_pair_settings(base, rel); })
     {
         m_update_clock = std::chrono::high_resolution_clock::now();
+        dispatcher_.sink<fiat_rate_updated>().connect<&auto_update_maker_order_service::on_fiat_rate_updated>(*this);
+        dispatcher_.sink<process_swaps_and_orders_finished>().connect<&auto_update_maker_order_service::on_process_swaps_and_orders_finished>(*this);
         SPDLOG_INFO("auto_update_maker_order_service created");
     }
+
+    auto_update_maker_order_service::~auto_update_maker_order_service()
+    {
+        dispatcher_.sink<fiat_rate_updated>().disconnect<&auto_update_maker_order_service::on_fiat_rate_updated>(*this);
+        dispatcher_.sink<process_swaps_and_orders_finished>().disconnect<&auto_update_maker_order_service::on_process_swaps_and_orders_finished>(*this);
+        const auto metrics = m_repricer.get_metrics();
+        SPDLOG_INFO(
+            "maker orders repricing -> price changes: {}, batches: {}, orders sent: {}, unchanged: {}, failed: {}, max latency: {}us",
+            metrics.nb_price_changes, metrics.nb_batches, metrics.nb_orders_sent, metrics.nb_orders_unchanged, metrics.nb_orders_failed,
+            metrics.max_latency.count());
+    }
 } // namespace atomic_dex
 
 //! Private member functions
 namespace atomic_dex
 {
-    std::string
-    auto_update_maker_order_service::get_new_price_from_order(const t_order_swaps_data& data, const t_float_50& spread)
+    maker_pair_settings
+    auto_update_maker_order_service::load_pair_settings(const std::string& base, const std::string& rel)
     {
-        const auto& price_service = m_system_manager.get_system<global_price_service>();
-        const auto& base          = data.base_coin.toStdString();
-        const auto& rel           = data.rel_coin.toStdString();
-        const auto& order         = data.order_id.toStdString();
-        t_float_50  price         = safe_float(data.rel_amount.toStdString()) / safe_float(data.base_amount.toStdString());
-        t_float_50  price_diff(0);
-        t_float_50  cex_price   = safe_float(price_service.get_cex_rates(base, rel));
-        price_diff              = t_float_50(100) * (t_float_50(1) - price / cex_price) * t_float_50(1);
-        t_float_50 percent      = spread / 100;
-        t_float_50 target_price = cex_price + (cex_price * percent);
-        SPDLOG_INFO("spread of the order {} for {}/{} is: {}%", order, base, rel, utils::format_float(price_diff));
-        SPDLOG_INFO("price of the order {} is {} {}", order, utils::format_float(price), rel);
-        SPDLOG_INFO("actual cex rates is: 1 {} = {} {}", base, utils::format_float(cex_price), rel);
+        QSettings& settings = entity_registry_.ctx<QSettings>();
+        settings.beginGroup(QString::fromStdString(base + "_" + rel));
+        maker_pair_settings out{
+            .enabled            = !settings.value("Disabled", true).toBool(),
+            .spread             = settings.value("Spread", 1.0).toDouble(),
+            .max                = settings.value("Max", false).toBool(),
+            .min_volume_percent = settings.value("MinVolume", 10.0).toDouble(),
+            .reprice_threshold  = settings.value("RepriceThreshold", 0.1).toDouble()};
+        settings.endGroup();
         SPDLOG_INFO(
-            "target price for the updated order is 1 {} = {} {}, target_spread: {}", base, utils::format_float(target_price), rel, utils::format_float(spread));
-        return utils::format_float(target_price);
+            "auto update settings of {}/{} -> enabled: {}, spread: {}%, reprice threshold: {}%", base, rel, out.enabled, out.spread, out.reprice_threshold);
+        return out;
     }
 
     void
-    auto_update_maker_order_service::update_order(const t_order_swaps_data& data)
+    auto_update_maker_order_service::send_batch(maker_order_repricer::batch batch)
     {
-        const auto&   mm2               = this->m_system_manager.get_system<mm2_service>();
-        const auto    base_coin         = data.base_coin.toStdString();
-        const auto    rel_coin          = data.rel_coin.toStdString();
-        const auto    base_coin_info    = mm2.get_coin_info(base_coin);
-        const auto    rel_coin_info     = mm2.get_coin_info(rel_coin);
-        QSettings&    settings          = entity_registry_.ctx<QSettings>();
-        const auto    category_settings = data.base_coin + "_" + data.rel_coin;
-        const QString target_settings   = "Disabled";
-        settings.beginGroup(category_settings);
-        const bool is_disabled        = settings.value(target_settings, true).toBool();
-        t_float_50 spread             = settings.value("Spread", 1.0).toDouble();
-        const bool max                = settings.value("Max", false).toBool();
-        t_float_50 min_volume_percent = settings.value("MinVolume", 10.0).toDouble() / 100; ///< min volume is always 10% of the order or more
-        settings.endGroup();
-        if (base_coin_info.coingecko_id != "test-coin" && rel_coin_info.coingecko_id != "test-coin" && !is_disabled)
+        nlohmann::json json_batch = nlohmann::json::array();
+        for (auto&& update: batch.updates)
         {
-            SPDLOG_INFO("Updating maker order: {}", data.order_id.toStdString());
-            nlohmann::json               batch                   = nlohmann::json::array();
-            std::string                  new_price               = get_new_price_from_order(data, spread);
-            nlohmann::json               conf_settings           = data.conf_settings.value_or(nlohmann::json());
             nlohmann::json               update_maker_order_json = ::mm2::api::template_request("update_maker_order");
-            t_float_50                   volume                  = safe_float(data.base_amount.toStdString());
-            t_float_50                   min_volume              = volume * min_volume_percent;
             t_update_maker_order_request request{
-                .uuid         = data.order_id.toStdString(),
-                .new_price    = new_price,
-                .max          = max,
-                .min_volume   = utils::format_float(min_volume)};
-            if (!conf_settings.empty())
+                .uuid       = update.uuid,
+                .new_price  = utils::format_float(update.new_price),
+                .max        = update.max,
+                .min_volume = utils::format_float(update.min_volume)};
+            if (update.conf_settings.has_value() && !update.conf_settings->empty())
             {
-                request.base_nota  = conf_settings.at("base_nota").get<bool>();
-                request.rel_nota   = conf_settings.at("rel_nota").get<bool>();
-                request.base_confs = conf_settings.at("base_confs").get<std::size_t>();
-                request.rel_confs  = conf_settings.at("rel_confs").get<std::size_t>();
+                const auto& conf_settings = update.conf_settings.value();
+                request.base_nota         = conf_settings.at("base_nota").get<bool>();
+                request.rel_nota          = conf_settings.at("rel_nota").get<bool>();
+                request.base_confs        = conf_settings.at("base_confs").get<std::size_t>();
+                request.rel_confs         = conf_settings.at("rel_confs").get<std::size_t>();
             }
             ::mm2::api::to_json(update_maker_order_json, request);
-            batch.push_back(update_maker_order_json);
-            update_maker_order_json["userpass"] = "";
-            SPDLOG_INFO("request: {}", update_maker_order_json.dump(1));
-            auto& mm2 = this->m_system_manager.get_system<mm2_service>();
-            mm2.get_mm2_client()
-                .async_rpc_batch_standalone(batch)
-                .then(
-                    []([[maybe_unused]] web::http::http_response resp)
+            json_batch.push_back(update_maker_order_json);
+            SPDLOG_INFO("Updating maker order: {}, new price: {}", request.uuid, request.new_price);
+        }
+
+        auto& mm2 = this->m_system_manager.get_system<mm2_service>();
+        mm2.get_mm2_client()
+            .async_rpc_batch_standalone(json_batch)
+            .then(
+                [this, batch](pplx::task<web::http::http_response> previous_task)
+                {
+                    //! Every order of the batch is retried unless mm2 answered for it
+                    std::vector<std::string> failed;
+                    for (auto&& update: batch.updates) { failed.push_back(update.uuid); }
+                    try
                     {
-                        std::string body = TO_STD_STR(resp.extract_string(true).get());
-                        SPDLOG_INFO("status_code: {}", resp.status_code());
+                        auto              resp = previous_task.get();
+                        const std::string body = TO_STD_STR(resp.extract_string(true).get());
                         if (resp.status_code() == 200)
                         {
-                            SPDLOG_INFO("order resp: {}", body);
+                            const auto answers = nlohmann::json::parse(body);
+                            for (std::size_t idx = 0; idx < answers.size() && idx < batch.updates.size(); ++idx)
+                            {
+                                if (answers[idx].contains("error"))
+                                {
+                                    SPDLOG_WARN("An error occured during update_maker_order of {}: {}", batch.updates[idx].uuid, answers[idx].dump());
+                                    continue;
+                                }
+                                std::erase(failed, batch.updates[idx].uuid);
+                            }
                         }
                         else
                         {
                             SPDLOG_WARN("An error occured during update_maker_order: {}", body);
                         }
-                    })
-                .then(&handle_exception_pplx_task);
-        }
+                    }
+                    catch (const std::exception& error)
+                    {
+                        SPDLOG_ERROR("update_maker_order batch failed: {}", error.what());
+                    }
+                    m_repricer.on_batch_answered(batch, failed, maker_order_repricer::t_clock::now());
+                });
     }
 
     void
     auto_update_maker_order_service::internal_update()
     {
-        SPDLOG_INFO("update maker orders");
-        const auto&      mm2  = this->m_system_manager.get_system<mm2_service>();
-        orders_and_swaps data = mm2.get_orders_and_swaps();
-        auto             cur  = data.orders_and_swaps.cbegin();
-        auto             end  = data.orders_and_swaps.cbegin() + data.nb_orders;
-        for (; cur != end; ++cur)
+        const auto& mm2 = this->m_system_manager.get_system<mm2_service>();
+        if (m_orders_changed.exchange(false))
+        {
+            std::vector<maker_order_entry> orders;
+            for (auto&& order: mm2.get_maker_orders())
+            {
+                const auto base = order.base_coin.toStdString();
+                const auto rel  = order.rel_coin.toStdString();
+                if (mm2.get_coin_info(base).coingecko_id == "test-coin" || mm2.get_coin_info(rel).coingecko_id == "test-coin")
+                {
+                    continue;
+                }
+                const t_float_50 base_amount = safe_float(order.base_amount.toStdString());
+                orders.push_back(maker_order_entry{
+                    .uuid          = order.order_id.toStdString(),
+                    .base          = base,
+                    .rel           = rel,
+                    .price         = base_amount > 0 ? t_float_50(safe_float(order.rel_amount.toStdString()) / base_amount) : t_float_50(0),
+                    .base_amount   = base_amount,
+                    .conf_settings = order.conf_settings});
+            }
+            m_repricer.sync_orders(std::move(orders));
+        }
+
+        if (m_prices_changed.exchange(false))
         {
-            if (cur->is_maker)
+            const auto& price_service = m_system_manager.get_system<global_price_service>();
+            const auto  changed_at    = m_prices_changed_at.load();
+            for (auto&& [base, rel]: m_repricer.get_pairs())
             {
-                SPDLOG_INFO("Updating order: {}", cur->order_id.toStdString());
-                this->update_order(*cur);
+                m_repricer.on_cex_price(base, rel, safe_float(price_service.get_cex_rates(base, rel)), changed_at);
             }
         }
+
+        //! Only the orders whose target price moved, all of them in a single batch
+        if (auto batch = m_repricer.next_batch(); !batch.empty())
+        {
+            SPDLOG_INFO("repricing {} maker orders", batch.updates.size());
+            send_batch(std::move(batch));
+        }
     }
 
     void
@@ -174,15 +212,21 @@ namespace atomic_dex
     void
     auto_update_maker_order_service::update()
     {
-        //! Scan orderbook widget every 30 seconds if there is not any update
+        //! Prices are checked every 2 minutes even if no provider notified a change
         using namespace std::chrono_literals;
 
         const auto now = std::chrono::high_resolution_clock::now();
         const auto s   = std::chrono::duration_cast<std::chrono::seconds>(now - m_update_clock);
         if (s >= 2min)
+        {
+            m_prices_changed_at = maker_order_repricer::t_clock::now();
+            m_prices_changed    = true;
+            m_orders_changed    = true;
+            m_update_clock      = now;
+        }
+        if (m_prices_changed || m_orders_changed)
         {
             process_update_orders();
-            m_update_clock = std::chrono::high_resolution_clock::now();
         }
     }
 
@@ -190,7 +234,37 @@ namespace atomic_dex
     auto_update_maker_order_service::force_update()
     {
         SPDLOG_INFO("Force update");
+        m_repricer.clear_settings();
+        m_prices_changed_at = maker_order_repricer::t_clock::now();
+        m_prices_changed    = true;
+        m_orders_changed    = true;
         this->process_update_orders();
         m_update_clock = std::chrono::high_resolution_clock::now();
     }
-} // namespace atomic_dex
\ No newline at end of file
+
+    maker_repricing_metrics
+    auto_update_maker_order_service::get_metrics() const
+    {
+        return m_repricer.get_metrics();
+    }
+} // namespace atomic_dex
+
+//! Events
+namespace atomic_dex
+{
+    void
+    auto_update_maker_order_service::on_fiat_rate_updated([[maybe_unused]] const fiat_rate_updated& evt)
+    {
+        //! Triggered by the price providers threads, the repricing itself happens in update()
+        if (!m_prices_changed.exchange(true))
+        {
+            m_prices_changed_at = maker_order_repricer::t_clock::now();
+        }
+    }
+
+    void
+    auto_update_maker_order_service::on_process_swaps_and_orders_finished([[maybe_unused]] const process_swaps_and_orders_finished& evt)
+    {
+        m_orders_changed = true;
+    }
+} // namespace atomic_dex
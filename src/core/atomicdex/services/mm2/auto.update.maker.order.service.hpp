@@ -16,6 +16,9 @@
 
 #pragma once
 
+//! STD
+#include <atomic>
+
 //! Deps
 #include <antara/gaming/ecs/system.manager.hpp>
 #include <boost/thread/synchronized_value.hpp>
@@ -23,6 +26,8 @@
 
 //! Project Headers
 #include "atomicdex/data/dex/qt.orders.data.hpp"
+#include "atomicdex/events/events.hpp"
+#include "atomicdex/services/mm2/mm2.maker.order.repricer.hpp"
 #include "atomicdex/utilities/safe.float.hpp"
 
 //! Namespace declaration
@@ -35,26 +40,36 @@ namespace atomic_dex
         using t_update_time_point = std::chrono::high_resolution_clock::time_point;
 
         //! Private member fields
-        ag::ecs::system_manager& m_system_manager;
-        t_update_time_point      m_update_clock;
+        ag::ecs::system_manager&                        m_system_manager;
+        t_update_time_point                             m_update_clock;
+        maker_order_repricer                            m_repricer;
+        std::atomic_bool                                m_prices_changed{true};
+        std::atomic_bool                                m_orders_changed{true};
+        std::atomic<maker_order_repricer::t_time_point> m_prices_changed_at{maker_order_repricer::t_clock::now()};
 
         //! Private member functions
-        void        process_update_orders();
-        void        internal_update();
-        void        update_order(const t_order_swaps_data& data);
-        std::string get_new_price_from_order(const t_order_swaps_data& data, const t_float_50& spread);
+        void                process_update_orders();
+        void                internal_update();
+        void                send_batch(maker_order_repricer::batch batch);
+        maker_pair_settings load_pair_settings(const std::string& base, const std::string& rel);
 
       public:
         //! Constructor
         explicit auto_update_maker_order_service(entt::registry& registry, ag::ecs::system_manager& system_manager);
 
         //! Destructor
-        ~auto_update_maker_order_service() final = default;
+        ~auto_update_maker_order_service() final;
 
         //! Public override
         void update() final;
 
         void force_update();
+
+        [[nodiscard]] maker_repricing_metrics get_metrics() const;
+
+        //! Events
+        void on_fiat_rate_updated(const fiat_rate_updated& evt);
+        void on_process_swaps_and_orders_finished(const process_swaps_and_orders_finished& evt);
     };
 } // namespace atomic_dex
 
@@ -0,0 +1,264 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+//! STD
+#include <algorithm>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.activation.pipeline.hpp"
+
+namespace
+{
+    std::chrono::milliseconds
+    since(atomic_dex::coin_activation_pipeline::t_time_point from, atomic_dex::coin_activation_pipeline::t_time_point to)
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(to - from);
+    }
+} // namespace
+
+namespace atomic_dex
+{
+    coin_activation_pipeline::coin_activation_pipeline(activation_pipeline_cfg cfg, t_launcher launcher, t_followup followup) :
+        m_cfg(cfg), m_launcher(std::move(launcher)), m_followup(std::move(followup))
+    {
+        m_cfg.max_in_flight = std::max<std::size_t>(m_cfg.max_in_flight, 1);
+        m_cfg.max_attempts  = std::max<std::size_t>(m_cfg.max_attempts, 1);
+    }
+
+    bool
+    coin_activation_pipeline::is_idle() const noexcept
+    {
+        return m_ready.empty() && m_delayed.empty() && m_running.empty();
+    }
+
+    bool
+    coin_activation_pipeline::is_known(const std::string& ticker) const
+    {
+        const auto same_ticker = [&ticker](const pending_job& pending) { return pending.data.ticker == ticker; };
+        return m_running.contains(ticker) || std::any_of(m_delayed.begin(), m_delayed.end(), same_ticker) ||
+               std::any_of(m_ready.begin(), m_ready.end(), [&same_ticker](const auto& entry) { return same_ticker(entry.second); });
+    }
+
+    bool
+    coin_activation_pipeline::waits_for_parent(const job& cur) const
+    {
+        return !cur.fee_parent.empty() && cur.fee_parent != cur.ticker && is_known(cur.fee_parent);
+    }
+
+    void
+    coin_activation_pipeline::enqueue(std::vector<job> jobs, t_time_point now)
+    {
+        std::vector<job> launchable;
+        {
+            std::scoped_lock lock(m_mutex);
+            if (is_idle())
+            {
+                m_wave_start = now;
+                m_metrics.stages.clear();
+            }
+            for (auto&& cur: jobs)
+            {
+                if (is_known(cur.ticker))
+                {
+                    continue;
+                }
+                const auto sequence = m_sequence++;
+                const auto priority = cur.priority;
+                m_ready.emplace(t_queue_key{priority, sequence}, pending_job{.data = std::move(cur), .sequence = sequence, .ready_at = now});
+                m_metrics.nb_enqueued += 1;
+            }
+            launchable = take_launchable(now);
+        }
+        run(std::move(launchable), {});
+    }
+
+    std::vector<coin_activation_pipeline::job>
+    coin_activation_pipeline::take_launchable(t_time_point now)
+    {
+        //! Retries whose backoff expired go back in the queue at their original place
+        for (auto it = m_delayed.begin(); it != m_delayed.end();)
+        {
+            if (it->ready_at <= now)
+            {
+                const t_queue_key key{it->data.priority, it->sequence};
+                m_ready.emplace(key, std::move(*it));
+                it = m_delayed.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        //! Children whose fee parent is still pending keep their place, the next jobs are launched instead
+        std::vector<job> out;
+        for (auto it = m_ready.begin(); it != m_ready.end() && m_running.size() < m_cfg.max_in_flight;)
+        {
+            if (waits_for_parent(it->second.data))
+            {
+                ++it;
+                continue;
+            }
+            auto  node    = m_ready.extract(it++);
+            auto& pending = node.mapped();
+            m_metrics.total_queue_wait += since(pending.ready_at, now);
+            out.push_back(pending.data);
+            auto ticker = pending.data.ticker;
+            m_running.insert_or_assign(std::move(ticker), running_job{.pending = std::move(pending), .started_at = now});
+        }
+        m_metrics.max_in_flight_seen = std::max(m_metrics.max_in_flight_seen, m_running.size());
+        return out;
+    }
+
+    std::vector<std::string>
+    coin_activation_pipeline::take_followups(bool force)
+    {
+        if (m_followups.empty() || (!force && m_followups.size() < m_cfg.followup_batch_size))
+        {
+            return {};
+        }
+        m_metrics.nb_followup_batches += 1;
+        return std::exchange(m_followups, {});
+    }
+
+    void
+    coin_activation_pipeline::run(std::vector<job> launchable, std::vector<std::string> followups)
+    {
+        //! Called without the lock, the launcher may answer synchronously
+        if (!followups.empty() && m_followup)
+        {
+            m_followup(std::move(followups));
+        }
+        for (auto&& cur: launchable) { m_launcher(cur); }
+    }
+
+    bool
+    coin_activation_pipeline::on_job_done(const std::string& ticker, activation_status status, t_time_point now)
+    {
+        bool                     retried = false;
+        std::vector<job>         launchable;
+        std::vector<std::string> followups;
+        {
+            std::scoped_lock lock(m_mutex);
+            auto             it = m_running.find(ticker);
+            if (it == m_running.end())
+            {
+                return false;
+            }
+            auto running = std::move(it->second);
+            m_running.erase(it);
+            m_metrics.total_activation_time += since(running.started_at, now);
+
+            switch (status)
+            {
+            case activation_status::enabled:
+                m_metrics.nb_enabled += 1;
+                m_followups.push_back(ticker);
+                record_stage_locked("first_coin_enabled", now);
+                break;
+            case activation_status::retryable:
+                if (running.pending.data.attempt + 1 < m_cfg.max_attempts)
+                {
+                    auto& pending = running.pending;
+                    pending.ready_at = now + m_cfg.base_backoff * (std::size_t{1} << pending.data.attempt);
+                    pending.data.attempt += 1;
+                    m_metrics.nb_retries += 1;
+                    m_delayed.push_back(std::move(pending));
+                    retried = true;
+                    break;
+                }
+                [[fallthrough]];
+            case activation_status::failed:
+                m_metrics.nb_failed += 1;
+                break;
+            }
+
+            launchable = take_launchable(now);
+            const bool drained = is_idle();
+            if (drained)
+            {
+                record_stage_locked("queue_drained", now);
+            }
+            followups = take_followups(drained || m_running.empty());
+        }
+        run(std::move(launchable), std::move(followups));
+        return retried;
+    }
+
+    void
+    coin_activation_pipeline::tick(t_time_point now)
+    {
+        std::vector<job>         launchable;
+        std::vector<std::string> followups;
+        {
+            std::scoped_lock lock(m_mutex);
+            launchable = take_launchable(now);
+            followups  = take_followups(m_running.empty());
+        }
+        run(std::move(launchable), std::move(followups));
+    }
+
+    void
+    coin_activation_pipeline::record_stage_locked(const std::string& stage, t_time_point now)
+    {
+        const auto exists = std::any_of(m_metrics.stages.begin(), m_metrics.stages.end(), [&stage](const auto& cur) { return cur.first == stage; });
+        if (!exists)
+        {
+            m_metrics.stages.emplace_back(stage, since(m_wave_start, now));
+        }
+    }
+
+    void
+    coin_activation_pipeline::record_stage(const std::string& stage, t_time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        record_stage_locked(stage, now);
+    }
+
+    void
+    coin_activation_pipeline::set_max_in_flight(std::size_t max_in_flight)
+    {
+        std::vector<job> launchable;
+        {
+            std::scoped_lock lock(m_mutex);
+            m_cfg.max_in_flight = std::max<std::size_t>(max_in_flight, 1);
+            launchable          = take_launchable(t_clock::now());
+        }
+        run(std::move(launchable), {});
+    }
+
+    std::size_t
+    coin_activation_pipeline::in_flight() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_running.size();
+    }
+
+    std::size_t
+    coin_activation_pipeline::pending() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_ready.size() + m_delayed.size();
+    }
+
+    activation_pipeline_metrics
+    coin_activation_pipeline::get_metrics() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_metrics;
+    }
+} // namespace atomic_dex
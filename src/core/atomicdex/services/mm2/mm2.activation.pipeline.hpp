@@ -0,0 +1,152 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#pragma once
+
+//! STD
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//! Deps
+#include <nlohmann/json.hpp>
+
+namespace atomic_dex
+{
+    enum class activation_priority : std::uint8_t
+    {
+        default_coin   = 0, ///< g_default_coins, enabled on login
+        fee_parent     = 1, ///< coins paying the fees of other coins being enabled (ex: ETH for ERC-20)
+        current_ticker = 2,
+        portfolio      = 3, ///< portfolio order
+    };
+
+    enum class activation_status
+    {
+        enabled,
+        failed,    ///< final, not retried
+        retryable, ///< transport error or timeout
+    };
+
+    struct activation_pipeline_cfg
+    {
+        std::size_t               max_in_flight{8};
+        std::size_t               max_attempts{3};
+        std::chrono::milliseconds base_backoff{2000}; ///< doubled on every attempt
+        std::size_t               followup_batch_size{20};
+    };
+
+    struct activation_pipeline_metrics
+    {
+        std::size_t               nb_enqueued{0};
+        std::size_t               nb_enabled{0};
+        std::size_t               nb_failed{0};
+        std::size_t               nb_retries{0};
+        std::size_t               nb_followup_batches{0};
+        std::size_t               max_in_flight_seen{0};
+        std::chrono::milliseconds total_queue_wait{0};      ///< enqueue (or backoff end) -> request sent
+        std::chrono::milliseconds total_activation_time{0}; ///< request sent -> answer processed
+
+        //! Milestones of the last wave (ex: first_coin_enabled, default_coins_enabled, queue_drained), relative to its first enqueue, in order
+        std::vector<std::pair<std::string, std::chrono::milliseconds>> stages;
+    };
+
+    //! Enables coins through a bounded window of concurrent requests, highest priority first.
+    //! Failed activations are retried with an exponential backoff, enabled coins are handed to `followup` in batches
+    //! so their first balance / tx fetch is coalesced. The io is done by `launcher`, which must answer with on_job_done.
+    class coin_activation_pipeline
+    {
+      public:
+        using t_clock      = std::chrono::steady_clock;
+        using t_time_point = t_clock::time_point;
+
+        struct job
+        {
+            std::string         ticker;
+            nlohmann::json      request{}; ///< enable / electrum request
+            activation_priority priority{activation_priority::portfolio};
+            std::size_t         attempt{0};
+            std::string         fee_parent{}; ///< not launched while this ticker is queued, retried or in flight
+        };
+
+        using t_launcher = std::function<void(const job&)>;
+        using t_followup = std::function<void(std::vector<std::string>)>;
+
+        coin_activation_pipeline(activation_pipeline_cfg cfg, t_launcher launcher, t_followup followup);
+
+        //! Jobs keep their relative order inside a priority, tickers already queued or in flight are skipped.
+        //! A job waits for its fee parent to leave the pipeline (enabled or failed) before being launched.
+        void enqueue(std::vector<job> jobs, t_time_point now);
+
+        //! Returns true if the job is retried later.
+        bool on_job_done(const std::string& ticker, activation_status status, t_time_point now);
+
+        //! Launches the retries whose backoff expired.
+        void tick(t_time_point now);
+
+        //! Records a milestone of the current wave, only its first occurrence is kept.
+        void record_stage(const std::string& stage, t_time_point now);
+
+        void                                      set_max_in_flight(std::size_t max_in_flight);
+        [[nodiscard]] std::size_t                 in_flight() const;
+        [[nodiscard]] std::size_t                 pending() const; ///< queued + waiting for a retry
+        [[nodiscard]] activation_pipeline_metrics get_metrics() const;
+
+      private:
+        using t_queue_key = std::pair<activation_priority, std::size_t>; ///< priority, sequence
+
+        struct pending_job
+        {
+            job          data;
+            std::size_t  sequence{0};
+            t_time_point ready_at;
+        };
+
+        struct running_job
+        {
+            pending_job  pending;
+            t_time_point started_at;
+        };
+
+        //! Must be called with the lock held, returns what has to be launched / followed up once released.
+        std::vector<job>         take_launchable(t_time_point now);
+        std::vector<std::string> take_followups(bool force);
+        void                     record_stage_locked(const std::string& stage, t_time_point now);
+        [[nodiscard]] bool       is_idle() const noexcept;
+        [[nodiscard]] bool       is_known(const std::string& ticker) const; ///< queued, retried or in flight
+        [[nodiscard]] bool       waits_for_parent(const job& cur) const;
+        void                     run(std::vector<job> launchable, std::vector<std::string> followups);
+
+        activation_pipeline_cfg                      m_cfg;
+        t_launcher                                   m_launcher;
+        t_followup                                   m_followup;
+        mutable std::mutex                           m_mutex;
+        std::map<t_queue_key, pending_job>           m_ready;
+        std::vector<pending_job>                     m_delayed; ///< waiting for their backoff
+        std::unordered_map<std::string, running_job> m_running;
+        std::vector<std::string>                     m_followups;
+        std::size_t                                  m_sequence{0};
+        t_time_point                                 m_wave_start;
+        activation_pipeline_metrics                  m_metrics;
+    };
+} // namespace atomic_dex
@@ -0,0 +1,217 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+//! STD
+#include <algorithm>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.balance.refresh.scheduler.hpp"
+
+namespace atomic_dex
+{
+    balance_refresh_scheduler::balance_refresh_scheduler(balance_refresh_cfg cfg) : m_cfg(cfg)
+    {
+    }
+
+    void
+    balance_refresh_scheduler::sync_enabled_coins(const std::vector<std::string>& tickers)
+    {
+        std::scoped_lock                lock(m_mutex);
+        std::unordered_set<std::string> enabled(tickers.begin(), tickers.end());
+        std::erase_if(m_coins, [&enabled](const auto& cur) { return !enabled.contains(cur.first); });
+        for (auto&& ticker: tickers)
+        {
+            if (auto [it, inserted] = m_coins.try_emplace(ticker); inserted)
+            {
+                it->second.cold_interval = m_cfg.cold_min_interval;
+            }
+        }
+    }
+
+    void
+    balance_refresh_scheduler::set_current_ticker(std::string ticker)
+    {
+        std::scoped_lock lock(m_mutex);
+        m_current_ticker = std::move(ticker);
+    }
+
+    void
+    balance_refresh_scheduler::set_swap_coins(std::unordered_set<std::string> tickers)
+    {
+        std::scoped_lock lock(m_mutex);
+        m_swap_coins = std::move(tickers);
+    }
+
+    refresh_tier
+    balance_refresh_scheduler::tier_of(const std::string& ticker, const coin_state& state, t_time_point now) const
+    {
+        if (ticker == m_current_ticker || m_swap_coins.contains(ticker))
+        {
+            return refresh_tier::hot;
+        }
+        if (state.last_change.has_value() && now - *state.last_change < m_cfg.hot_change_window)
+        {
+            return refresh_tier::hot;
+        }
+        return refresh_tier::cold;
+    }
+
+    refresh_tier
+    balance_refresh_scheduler::tier_of(const std::string& ticker, t_time_point now) const
+    {
+        std::scoped_lock lock(m_mutex);
+        if (const auto it = m_coins.find(ticker); it != m_coins.end())
+        {
+            return tier_of(ticker, it->second, now);
+        }
+        return refresh_tier::cold;
+    }
+
+    bool
+    balance_refresh_scheduler::is_due(const coin_state& state, refresh_tier tier, t_time_point now) const
+    {
+        if (state.in_flight)
+        {
+            return false;
+        }
+        if (!state.last_refresh.has_value())
+        {
+            return true;
+        }
+        const auto interval = tier == refresh_tier::hot ? m_cfg.hot_interval : state.cold_interval;
+        return now - *state.last_refresh >= interval;
+    }
+
+    balance_refresh_scheduler::batch
+    balance_refresh_scheduler::next_batch(t_time_point now)
+    {
+        using t_cold_candidate = std::pair<t_time_point, decltype(m_coins)::iterator>;
+
+        std::scoped_lock              lock(m_mutex);
+        batch                         out;
+        std::vector<t_cold_candidate> cold_due;
+        for (auto it = m_coins.begin(); it != m_coins.end(); ++it)
+        {
+            auto&& [ticker, state] = *it;
+            const auto tier        = tier_of(ticker, state, now);
+            if (!is_due(state, tier, now))
+            {
+                continue;
+            }
+            if (tier == refresh_tier::hot)
+            {
+                state.in_flight = true;
+                out.hot.push_back(ticker);
+            }
+            else
+            {
+                cold_due.emplace_back(state.last_refresh.value_or(t_time_point::min()), it);
+            }
+        }
+
+        //! The stalest cold coins first, the others wait for the next tick
+        const auto nb_cold = static_cast<std::ptrdiff_t>(std::min(cold_due.size(), m_cfg.cold_batch_size));
+        std::partial_sort(
+            cold_due.begin(), cold_due.begin() + nb_cold, cold_due.end(),
+            [](const t_cold_candidate& lhs, const t_cold_candidate& rhs)
+            { return lhs.first != rhs.first ? lhs.first < rhs.first : lhs.second->first < rhs.second->first; });
+        for (auto it = cold_due.begin(); it != cold_due.begin() + nb_cold; ++it)
+        {
+            it->second->second.in_flight = true;
+            out.cold.push_back(it->second->first);
+        }
+        return out;
+    }
+
+    bool
+    balance_refresh_scheduler::on_balance(const std::string& ticker, const std::string& balance, t_time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto       it = m_coins.find(ticker);
+        if (it == m_coins.end())
+        {
+            return false;
+        }
+        auto&      state   = it->second;
+        const bool known   = state.balance.has_value();
+        const bool changed = known && *state.balance != balance;
+        const auto tier    = tier_of(ticker, state, now);
+        state.in_flight    = false;
+        state.last_refresh = now;
+        state.balance      = balance;
+        if (changed)
+        {
+            state.last_change   = now;
+            state.cold_interval = m_cfg.cold_min_interval;
+            (tier == refresh_tier::hot ? m_metrics.hot : m_metrics.cold).nb_changes += 1;
+        }
+        else if (known)
+        {
+            //! Backoff while the balance does not move, the first answer keeps the minimum interval
+            state.cold_interval = std::min(state.cold_interval * 2, m_cfg.cold_max_interval);
+        }
+        return changed;
+    }
+
+    void
+    balance_refresh_scheduler::on_batch_done(
+        refresh_tier tier, std::size_t nb_coins, std::size_t request_bytes, std::size_t answer_bytes, std::chrono::microseconds latency)
+    {
+        std::scoped_lock lock(m_mutex);
+        auto&            metrics = tier == refresh_tier::hot ? m_metrics.hot : m_metrics.cold;
+        metrics.nb_batches += 1;
+        metrics.nb_coins += nb_coins;
+        metrics.request_bytes += request_bytes;
+        metrics.answer_bytes += answer_bytes;
+        metrics.total_latency += latency;
+        metrics.last_latency = latency;
+    }
+
+    void
+    balance_refresh_scheduler::on_batch_failed(const std::vector<std::string>& tickers, t_time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        for (auto&& ticker: tickers)
+        {
+            if (auto it = m_coins.find(ticker); it != m_coins.end() && it->second.in_flight)
+            {
+                it->second.in_flight    = false;
+                it->second.last_refresh = now;
+            }
+        }
+    }
+
+    void
+    balance_refresh_scheduler::on_full_refresh(t_time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        for (auto&& [_, state]: m_coins)
+        {
+            state.in_flight     = false;
+            state.last_refresh  = now;
+            state.cold_interval = m_cfg.cold_min_interval;
+        }
+        m_metrics.nb_full_refresh += 1;
+    }
+
+    balance_refresh_metrics
+    balance_refresh_scheduler::get_metrics() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_metrics;
+    }
+} // namespace atomic_dex
@@ -0,0 +1,120 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#pragma once
+
+//! STD
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace atomic_dex
+{
+    enum class refresh_tier
+    {
+        hot,  ///< current ticker, coins in an active swap, coins whose balance moved recently
+        cold, ///< everything else, refreshed less and less often while the balance does not move
+    };
+
+    struct balance_refresh_cfg
+    {
+        std::chrono::seconds hot_interval{10};
+        std::chrono::seconds cold_min_interval{30};
+        std::chrono::seconds cold_max_interval{300};
+        std::chrono::seconds hot_change_window{300}; ///< a coin stays hot this long after a balance change
+        std::size_t          cold_batch_size{25};    ///< cold coins per batch, the stalest first
+    };
+
+    struct balance_refresh_tier_metrics
+    {
+        std::size_t               nb_batches{0};
+        std::size_t               nb_coins{0};
+        std::size_t               nb_changes{0};    ///< balances that moved
+        std::size_t               request_bytes{0};
+        std::size_t               answer_bytes{0};
+        std::chrono::microseconds total_latency{0};
+        std::chrono::microseconds last_latency{0};
+    };
+
+    struct balance_refresh_metrics
+    {
+        balance_refresh_tier_metrics hot;
+        balance_refresh_tier_metrics cold;
+        std::size_t                  nb_full_refresh{0};
+    };
+
+    //! Decides which coins need a my_balance request, so every tick sends a small batch instead of every enabled coin.
+    //! Time is passed by the caller, the scheduler does no io. Thread safe.
+    class balance_refresh_scheduler
+    {
+      public:
+        using t_clock      = std::chrono::steady_clock;
+        using t_time_point = t_clock::time_point;
+
+        struct batch
+        {
+            std::vector<std::string> hot;
+            std::vector<std::string> cold;
+
+            [[nodiscard]] bool empty() const noexcept { return hot.empty() && cold.empty(); }
+        };
+
+        explicit balance_refresh_scheduler(balance_refresh_cfg cfg = {});
+
+        //! Tracks exactly `tickers`, new ones are due immediately.
+        void sync_enabled_coins(const std::vector<std::string>& tickers);
+        void set_current_ticker(std::string ticker);
+        void set_swap_coins(std::unordered_set<std::string> tickers);
+
+        //! Coins due at `now`, marked in flight until on_balance / on_batch_failed.
+        batch next_batch(t_time_point now);
+
+        //! Returns true if the balance changed since the last answer.
+        bool on_balance(const std::string& ticker, const std::string& balance, t_time_point now);
+        void on_batch_done(refresh_tier tier, std::size_t nb_coins, std::size_t request_bytes, std::size_t answer_bytes, std::chrono::microseconds latency);
+        void on_batch_failed(const std::vector<std::string>& tickers, t_time_point now); ///< unanswered coins are retried after their interval
+        void on_full_refresh(t_time_point now); ///< every coin is refreshed by the full path, nothing is due before its interval
+
+        [[nodiscard]] refresh_tier            tier_of(const std::string& ticker, t_time_point now) const;
+        [[nodiscard]] balance_refresh_metrics get_metrics() const;
+
+      private:
+        struct coin_state
+        {
+            std::optional<std::string>  balance;
+            std::optional<t_time_point> last_refresh;
+            std::optional<t_time_point> last_change;
+            std::chrono::seconds        cold_interval{0};
+            bool                        in_flight{false};
+        };
+
+        [[nodiscard]] refresh_tier tier_of(const std::string& ticker, const coin_state& state, t_time_point now) const;
+        [[nodiscard]] bool         is_due(const coin_state& state, refresh_tier tier, t_time_point now) const;
+
+        balance_refresh_cfg                         m_cfg;
+        mutable std::mutex                          m_mutex;
+        std::unordered_map<std::string, coin_state> m_coins;
+        std::string                                 m_current_ticker;
+        std::unordered_set<std::string>             m_swap_coins;
+        balance_refresh_metrics                     m_metrics;
+    };
+} // namespace atomic_dex
@@ -0,0 +1,276 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+#include <exception>
+
+//! Deps
+#include <spdlog/spdlog.h>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.decode.queue.hpp"
+
+namespace
+{
+    std::chrono::microseconds
+    elapsed(atomic_dex::decode_queue::t_time_point from, atomic_dex::decode_queue::t_time_point to)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(to - from);
+    }
+
+    void
+    run_dropped(std::vector<atomic_dex::decode_queue::t_task>& dropped)
+    {
+        for (auto&& cur: dropped)
+        {
+            if (cur)
+            {
+                cur();
+            }
+        }
+    }
+} // namespace
+
+namespace atomic_dex
+{
+    decode_queue::decode_queue(decode_queue_cfg cfg) : m_cfg(cfg)
+    {
+        m_cfg.capacity = std::max<std::size_t>(m_cfg.capacity, 1);
+        m_workers.reserve(m_cfg.nb_workers);
+        for (std::size_t idx = 0; idx < m_cfg.nb_workers; ++idx) { m_workers.emplace_back([this]() { worker_loop(); }); }
+    }
+
+    decode_queue::~decode_queue()
+    {
+        stop();
+    }
+
+    bool
+    decode_queue::make_room(std::vector<t_task>& dropped)
+    {
+        auto it = std::find_if(m_queue.begin(), m_queue.end(), [](const entry& cur) { return cur.data.policy != decode_policy::keep_all; });
+        if (it == m_queue.end())
+        {
+            return false;
+        }
+        m_metrics.stages[it->data.rpc].nb_dropped += 1;
+        dropped.push_back(std::move(it->data.on_dropped));
+        m_queue.erase(it);
+        return true;
+    }
+
+    std::deque<decode_queue::entry>::iterator
+    decode_queue::next_runnable()
+    {
+        if (m_running.empty())
+        {
+            return m_queue.begin();
+        }
+        return std::find_if(m_queue.begin(), m_queue.end(), [this](const entry& cur) { return m_running.count(cur.data.rpc) == 0; });
+    }
+
+    decode_queue::entry
+    decode_queue::take(std::deque<entry>::iterator it)
+    {
+        entry current = std::move(*it);
+        m_queue.erase(it);
+        m_running.insert(current.data.rpc);
+        return current;
+    }
+
+    bool
+    decode_queue::push(job data)
+    {
+        std::vector<t_task> dropped;
+        bool                accepted = false;
+        {
+            std::unique_lock lock(m_mutex);
+            auto&            stage = m_metrics.stages[data.rpc];
+            stage.nb_enqueued += 1;
+            if (data.policy == decode_policy::coalesce)
+            {
+                auto it = std::find_if(
+                    m_queue.begin(), m_queue.end(), [&data](const entry& cur) { return cur.data.rpc == data.rpc && cur.data.key == data.key; });
+                if (it != m_queue.end())
+                {
+                    //! The newer snapshot takes the place of the queued one, it is not decoded sooner than its predecessor would have been.
+                    stage.nb_coalesced += 1;
+                    dropped.push_back(std::move(it->data.on_dropped));
+                    it->data        = std::move(data);
+                    it->enqueued_at = t_clock::now();
+                    accepted        = true;
+                }
+            }
+
+            if (!accepted && !m_stopped)
+            {
+                if (m_queue.size() >= m_cfg.capacity)
+                {
+                    switch (data.policy)
+                    {
+                    case decode_policy::keep_all:
+                        m_not_full.wait(lock, [this]() { return m_stopped || m_queue.size() < m_cfg.capacity; });
+                        break;
+                    case decode_policy::coalesce:
+                        make_room(dropped);
+                        break;
+                    case decode_policy::drop:
+                        break;
+                    }
+                }
+                if (!m_stopped && m_queue.size() < m_cfg.capacity)
+                {
+                    m_queue.push_back(entry{.data = std::move(data), .enqueued_at = t_clock::now()});
+                    m_metrics.max_depth = std::max(m_metrics.max_depth, m_queue.size());
+                    accepted            = true;
+                }
+            }
+
+            if (!accepted)
+            {
+                m_metrics.stages[data.rpc].nb_dropped += 1;
+                dropped.push_back(std::move(data.on_dropped));
+            }
+        }
+
+        if (accepted)
+        {
+            m_not_empty.notify_one();
+        }
+        run_dropped(dropped);
+        return accepted;
+    }
+
+    void
+    decode_queue::execute(entry current)
+    {
+        const auto started_at = t_clock::now();
+        bool       failed     = false;
+        try
+        {
+            current.data.task();
+        }
+        catch (const std::exception& error)
+        {
+            SPDLOG_ERROR("decode stage {} failed: {}", current.data.rpc, error.what());
+            failed = true;
+        }
+        const auto done_at = t_clock::now();
+
+        {
+            std::scoped_lock lock(m_mutex);
+            m_running.erase(current.data.rpc);
+            auto&      stage = m_metrics.stages[current.data.rpc];
+            const auto wait  = elapsed(current.enqueued_at, started_at);
+            const auto took  = elapsed(started_at, done_at);
+            stage.nb_processed += 1;
+            stage.nb_failed += failed ? 1 : 0;
+            stage.total_queue_wait += wait;
+            stage.max_queue_wait = std::max(stage.max_queue_wait, wait);
+            stage.total_decode_time += took;
+            stage.max_decode_time = std::max(stage.max_decode_time, took);
+        }
+        //! The next job of this rpc may wait behind the one that just finished
+        m_not_empty.notify_all();
+    }
+
+    void
+    decode_queue::worker_loop()
+    {
+        while (true)
+        {
+            entry current;
+            {
+                std::unique_lock lock(m_mutex);
+                m_not_empty.wait(lock, [this]() { return m_stopped || next_runnable() != m_queue.end(); });
+                if (m_stopped)
+                {
+                    return;
+                }
+                current = take(next_runnable());
+            }
+            m_not_full.notify_one();
+            execute(std::move(current));
+        }
+    }
+
+    std::size_t
+    decode_queue::run_pending()
+    {
+        std::size_t nb_run = 0;
+        while (true)
+        {
+            entry current;
+            {
+                std::scoped_lock lock(m_mutex);
+                const auto       it = next_runnable();
+                if (it == m_queue.end())
+                {
+                    break;
+                }
+                current = take(it);
+            }
+            m_not_full.notify_one();
+            execute(std::move(current));
+            nb_run += 1;
+        }
+        return nb_run;
+    }
+
+    void
+    decode_queue::stop()
+    {
+        std::deque<entry> remaining;
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopped = true;
+            remaining.swap(m_queue);
+            for (auto&& cur: remaining) { m_metrics.stages[cur.data.rpc].nb_dropped += 1; }
+        }
+        m_not_empty.notify_all();
+        m_not_full.notify_all();
+        for (auto&& worker: m_workers)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+        m_workers.clear();
+
+        std::vector<t_task> dropped;
+        dropped.reserve(remaining.size());
+        for (auto&& cur: remaining) { dropped.push_back(std::move(cur.data.on_dropped)); }
+        run_dropped(dropped);
+    }
+
+    std::size_t
+    decode_queue::depth() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_queue.size();
+    }
+
+    decode_queue_metrics
+    decode_queue::get_metrics() const
+    {
+        std::scoped_lock lock(m_mutex);
+        decode_queue_metrics out = m_metrics;
+        out.depth                = m_queue.size();
+        return out;
+    }
+} // namespace atomic_dex
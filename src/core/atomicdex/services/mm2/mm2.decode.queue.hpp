@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace atomic_dex
+{
+    enum class decode_policy
+    {
+        keep_all, ///< never dropped, push blocks the producer without timeout until a slot is free or the queue stops
+        coalesce, ///< a queued job with the same rpc and key is replaced, the oldest droppable job is evicted when the queue is full
+        drop,     ///< dropped when the queue is full
+    };
+
+    struct decode_queue_cfg
+    {
+        std::size_t capacity{64};
+        std::size_t nb_workers{2}; ///< 0: nothing runs until run_pending is called by the owner
+    };
+
+    struct decode_stage_metrics
+    {
+        std::size_t               nb_enqueued{0};
+        std::size_t               nb_processed{0};
+        std::size_t               nb_coalesced{0}; ///< replaced by a newer job with the same key
+        std::size_t               nb_dropped{0};   ///< evicted or rejected because the queue was full
+        std::size_t               nb_failed{0};    ///< the job threw
+        std::chrono::microseconds total_queue_wait{0};
+        std::chrono::microseconds max_queue_wait{0};
+        std::chrono::microseconds total_decode_time{0};
+        std::chrono::microseconds max_decode_time{0};
+    };
+
+    struct decode_queue_metrics
+    {
+        std::size_t                                 depth{0};
+        std::size_t                                 max_depth{0};
+        std::map<std::string, decode_stage_metrics> stages; ///< by rpc
+    };
+
+    //! Bounded multi-producer queue that moves the body extraction, json parsing and registry updates of rpc answers
+    //! off the cpprestsdk callback threads. Answers are decoded and applied by a fixed number of workers.
+    //! The jobs of one rpc never run concurrently and run in queue order, an older snapshot is never applied after a newer one.
+    class decode_queue
+    {
+      public:
+        using t_clock      = std::chrono::steady_clock;
+        using t_time_point = t_clock::time_point;
+        using t_task       = std::function<void()>;
+
+        struct job
+        {
+            std::string   rpc;                           ///< metrics stage, ex: orderbook
+            std::string   key{};                         ///< coalescing key inside the rpc, ex: the orderbook pair
+            decode_policy policy{decode_policy::keep_all};
+            t_task        task{};
+            t_task        on_dropped{};                  ///< called instead of task when the job is coalesced, dropped or the queue stops
+        };
+
+        explicit decode_queue(decode_queue_cfg cfg);
+        ~decode_queue();
+
+        decode_queue(const decode_queue& other) = delete;
+        decode_queue& operator=(const decode_queue& other) = delete;
+
+        //! Returns false if the job was rejected (queue full or stopped), its on_dropped has been called.
+        //! A keep_all job pushed on a full queue blocks the caller until a worker frees a slot: never push one from a job of this queue,
+        //! with no workers it waits for run_pending or stop() on another thread.
+        bool push(job data);
+
+        //! Runs the queued jobs on the calling thread, returns how many ran.
+        std::size_t run_pending();
+
+        //! Joins the workers, the jobs still queued are dropped.
+        void stop();
+
+        [[nodiscard]] std::size_t          depth() const;
+        [[nodiscard]] decode_queue_metrics get_metrics() const;
+
+      private:
+        struct entry
+        {
+            job          data;
+            t_time_point enqueued_at;
+        };
+
+        //! Must be called with the lock held.
+        bool make_room(std::vector<t_task>& dropped);
+        //! Must be called with the lock held, the oldest job whose rpc is not running or end().
+        std::deque<entry>::iterator next_runnable();
+        //! Must be called with the lock held, marks the rpc of the job as running.
+        entry take(std::deque<entry>::iterator it);
+
+        void worker_loop();
+        void execute(entry current);
+
+        decode_queue_cfg         m_cfg;
+        mutable std::mutex       m_mutex;
+        std::condition_variable  m_not_empty;
+        std::condition_variable  m_not_full;
+        std::deque<entry>        m_queue;
+        std::set<std::string>    m_running; ///< rpcs with a job being executed
+        std::vector<std::thread> m_workers;
+        bool                     m_stopped{false};
+        decode_queue_metrics     m_metrics;
+    };
+} // namespace atomic_dex
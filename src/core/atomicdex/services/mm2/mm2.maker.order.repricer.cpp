@@ -0,0 +1,243 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+#include <unordered_set>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.maker.order.repricer.hpp"
+
+namespace
+{
+    std::string
+    pair_key(const std::string& base, const std::string& rel)
+    {
+        return base + "/" + rel;
+    }
+
+    //! Move between `from` and `to` in percent of `from`.
+    t_float_50
+    move_percent(const t_float_50& from, const t_float_50& to)
+    {
+        return boost::multiprecision::abs(to - from) / from * 100;
+    }
+
+    //! True if mm2 reports the price we sent: it went out with 8 decimals (utils::format_float) and comes back as rel_amount / base_amount.
+    bool
+    is_sent_price(const t_float_50& sent, const t_float_50& reported)
+    {
+        //! Half of the last sent decimal for the rounding, plus a relative margin for the division of the amounts
+        const t_float_50 tolerance = t_float_50("0.000000005") + boost::multiprecision::abs(sent) * t_float_50("0.00000001");
+        return boost::multiprecision::abs(reported - sent) <= tolerance;
+    }
+} // namespace
+
+namespace atomic_dex
+{
+    maker_order_repricer::maker_order_repricer(t_settings_loader settings_loader) : m_settings_loader(std::move(settings_loader))
+    {
+    }
+
+    const maker_pair_settings&
+    maker_order_repricer::settings_of(const std::string& base, const std::string& rel)
+    {
+        const auto key = pair_key(base, rel);
+        if (auto it = m_settings.find(key); it != m_settings.end())
+        {
+            return it->second;
+        }
+        m_metrics.nb_settings_loads += 1;
+        return m_settings.emplace(key, m_settings_loader(base, rel)).first->second;
+    }
+
+    void
+    maker_order_repricer::sync_orders(std::vector<maker_order_entry> orders)
+    {
+        std::scoped_lock                             lock(m_mutex);
+        std::unordered_map<std::string, order_state> synced;
+        synced.reserve(orders.size());
+        for (auto&& entry: orders)
+        {
+            order_state state;
+            if (auto it = m_orders.find(entry.uuid); it != m_orders.end())
+            {
+                state.last_sent_price = it->second.last_sent_price;
+                state.needs_check     = it->second.needs_check;
+                if (state.last_sent_price.has_value() && !is_sent_price(*state.last_sent_price, entry.price))
+                {
+                    //! The order moved away from the price we sent (edited or not updated), check its actual price again
+                    state.last_sent_price.reset();
+                    state.needs_check = true;
+                }
+            }
+            std::string uuid = entry.uuid;
+            state.entry      = std::move(entry);
+            synced.insert_or_assign(std::move(uuid), std::move(state));
+        }
+        m_orders = std::move(synced);
+
+        std::unordered_set<std::string> pairs;
+        for (auto&& [_, state]: m_orders) { pairs.insert(pair_key(state.entry.base, state.entry.rel)); }
+        std::erase_if(m_pairs, [&pairs](const auto& cur) { return !pairs.contains(cur.first); });
+    }
+
+    std::vector<maker_order_repricer::t_pair>
+    maker_order_repricer::get_pairs()
+    {
+        std::scoped_lock                lock(m_mutex);
+        std::vector<t_pair>             out;
+        std::unordered_set<std::string> seen;
+        for (auto&& [_, state]: m_orders)
+        {
+            const auto& entry = state.entry;
+            if (seen.insert(pair_key(entry.base, entry.rel)).second && settings_of(entry.base, entry.rel).enabled)
+            {
+                out.emplace_back(entry.base, entry.rel);
+            }
+        }
+        return out;
+    }
+
+    bool
+    maker_order_repricer::on_cex_price(const std::string& base, const std::string& rel, const t_float_50& cex_price, t_time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto&      settings = settings_of(base, rel);
+        if (!settings.enabled || cex_price <= 0)
+        {
+            return false;
+        }
+
+        auto& pair = m_pairs[pair_key(base, rel)];
+        if (pair.reference_price.has_value() && move_percent(*pair.reference_price, cex_price) < settings.reprice_threshold)
+        {
+            //! Back within the threshold, nothing to reprice
+            pair.pending_price.reset();
+            pair.changed_at.reset();
+            return false;
+        }
+        if (!pair.pending_price.has_value())
+        {
+            m_metrics.nb_price_changes += 1;
+            pair.changed_at = now;
+        }
+        pair.pending_price = cex_price;
+        return true;
+    }
+
+    maker_order_repricer::batch
+    maker_order_repricer::next_batch()
+    {
+        std::scoped_lock lock(m_mutex);
+        batch            out;
+        for (auto&& [uuid, state]: m_orders)
+        {
+            const auto& entry    = state.entry;
+            const auto& settings = settings_of(entry.base, entry.rel);
+            const auto  pair_it  = m_pairs.find(pair_key(entry.base, entry.rel));
+            if (!settings.enabled || pair_it == m_pairs.end())
+            {
+                continue;
+            }
+
+            const auto& pair = pair_it->second;
+            if (!pair.pending_price.has_value() && !(state.needs_check && pair.reference_price.has_value()))
+            {
+                continue;
+            }
+            state.needs_check = false;
+
+            const t_float_50 cex_price    = pair.pending_price.value_or(pair.reference_price.value_or(0));
+            const t_float_50 target_price = cex_price + cex_price * (t_float_50(settings.spread) / 100);
+            const t_float_50 order_price  = state.last_sent_price.value_or(entry.price);
+            if (order_price > 0 && move_percent(order_price, target_price) < settings.reprice_threshold)
+            {
+                m_metrics.nb_orders_unchanged += 1;
+                continue;
+            }
+
+            out.updates.push_back(maker_order_update{
+                .uuid          = uuid,
+                .new_price     = target_price,
+                .max           = settings.max,
+                .min_volume    = entry.base_amount * (t_float_50(settings.min_volume_percent) / 100),
+                .conf_settings = entry.conf_settings});
+            state.last_sent_price = target_price;
+        }
+
+        for (auto&& [_, pair]: m_pairs)
+        {
+            if (pair.pending_price.has_value())
+            {
+                pair.reference_price = std::move(pair.pending_price);
+                pair.pending_price.reset();
+                if (pair.changed_at.has_value() && (!out.price_changed_at.has_value() || *pair.changed_at < *out.price_changed_at))
+                {
+                    out.price_changed_at = pair.changed_at;
+                }
+                pair.changed_at.reset();
+            }
+        }
+
+        if (!out.empty())
+        {
+            m_metrics.nb_batches += 1;
+            m_metrics.nb_orders_sent += out.updates.size();
+        }
+        return out;
+    }
+
+    void
+    maker_order_repricer::on_batch_answered(const batch& sent, const std::vector<std::string>& failed, t_time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        for (auto&& uuid: failed)
+        {
+            if (auto it = m_orders.find(uuid); it != m_orders.end())
+            {
+                //! Checked again with the next batch, whatever the price does
+                it->second.last_sent_price.reset();
+                it->second.needs_check = true;
+            }
+        }
+        m_metrics.nb_orders_failed += failed.size();
+
+        if (sent.price_changed_at.has_value())
+        {
+            const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - *sent.price_changed_at);
+            m_metrics.last_latency = latency;
+            m_metrics.max_latency  = std::max(m_metrics.max_latency, latency);
+            m_metrics.total_latency += latency;
+        }
+    }
+
+    void
+    maker_order_repricer::clear_settings()
+    {
+        std::scoped_lock lock(m_mutex);
+        m_settings.clear();
+        //! The spread or the threshold may have changed, every order is checked against the reference price of its pair
+        for (auto&& [_, state]: m_orders) { state.needs_check = true; }
+    }
+
+    maker_repricing_metrics
+    maker_order_repricer::get_metrics() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_metrics;
+    }
+} // namespace atomic_dex
@@ -0,0 +1,147 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//! Deps
+#include <nlohmann/json.hpp>
+
+//! Project Headers
+#include "atomicdex/utilities/safe.float.hpp"
+
+namespace atomic_dex
+{
+    //! Auto update settings of a pair, read from the "<base>_<rel>" group of the settings.
+    struct maker_pair_settings
+    {
+        bool   enabled{false};
+        double spread{1.0};              ///< percent above the cex price
+        bool   max{false};
+        double min_volume_percent{10.0}; ///< min volume is always this percent of the order or more
+        double reprice_threshold{0.1};   ///< percent the cex price or the target price must move before the orders are updated
+    };
+
+    //! What the repricer needs to know about a maker order.
+    struct maker_order_entry
+    {
+        std::string                   uuid;
+        std::string                   base;
+        std::string                   rel;
+        t_float_50                    price;
+        t_float_50                    base_amount;
+        std::optional<nlohmann::json> conf_settings;
+    };
+
+    //! One update_maker_order of a repricing batch.
+    struct maker_order_update
+    {
+        std::string                   uuid;
+        t_float_50                    new_price;
+        bool                          max{false};
+        t_float_50                    min_volume;
+        std::optional<nlohmann::json> conf_settings;
+    };
+
+    struct maker_repricing_metrics
+    {
+        std::size_t               nb_price_changes{0};    ///< cex price moves past the threshold of a pair
+        std::size_t               nb_batches{0};
+        std::size_t               nb_orders_sent{0};
+        std::size_t               nb_orders_unchanged{0}; ///< target price within the threshold of the order price, not sent
+        std::size_t               nb_orders_failed{0};
+        std::size_t               nb_settings_loads{0};
+        std::chrono::microseconds last_latency{0};        ///< from the price change to the answer of mm2
+        std::chrono::microseconds max_latency{0};
+        std::chrono::microseconds total_latency{0};
+    };
+
+    //! Decides which maker orders need an update_maker_order when the cex prices move, every update of a tick goes in one batch.
+    //! Time is passed by the caller, the repricer does no io. Thread safe.
+    class maker_order_repricer
+    {
+      public:
+        using t_clock           = std::chrono::steady_clock;
+        using t_time_point      = t_clock::time_point;
+        using t_pair            = std::pair<std::string, std::string>;
+        using t_settings_loader = std::function<maker_pair_settings(const std::string& base, const std::string& rel)>;
+
+        struct batch
+        {
+            std::vector<maker_order_update> updates;
+            std::optional<t_time_point>     price_changed_at; ///< oldest price change served by the batch
+
+            [[nodiscard]] bool empty() const noexcept { return updates.empty(); }
+        };
+
+        explicit maker_order_repricer(t_settings_loader settings_loader);
+
+        //! Tracks exactly `orders`, a new order or one whose price is not the last one sent
+        //! is checked against the last cex price of its pair in the next batch.
+        void sync_orders(std::vector<maker_order_entry> orders);
+
+        //! Pairs of the tracked orders whose auto update is enabled.
+        [[nodiscard]] std::vector<t_pair> get_pairs();
+
+        //! Returns true if the price moved past the threshold of the pair since the orders were last repriced.
+        bool on_cex_price(const std::string& base, const std::string& rel, const t_float_50& cex_price, t_time_point now);
+
+        //! Orders whose target price moved, their pairs are considered repriced.
+        batch next_batch();
+
+        //! `failed` are the uuids mm2 did not update, they are retried with the next price change.
+        void on_batch_answered(const batch& sent, const std::vector<std::string>& failed, t_time_point now);
+
+        //! The settings are loaded again the next time a pair needs them, ex: the user edited them. Every order is checked with the next batch.
+        void clear_settings();
+
+        [[nodiscard]] maker_repricing_metrics get_metrics() const;
+
+      private:
+        struct order_state
+        {
+            maker_order_entry         entry;
+            std::optional<t_float_50> last_sent_price;
+            bool                      needs_check{true}; ///< new, failed or out of sync order, compared to the last cex price of its pair
+        };
+
+        struct pair_state
+        {
+            std::optional<t_float_50>   reference_price; ///< cex price the orders were last repriced with
+            std::optional<t_float_50>   pending_price;   ///< cex price past the threshold, not served yet
+            std::optional<t_time_point> changed_at;
+        };
+
+        const maker_pair_settings& settings_of(const std::string& base, const std::string& rel);
+
+        t_settings_loader                                    m_settings_loader;
+        mutable std::mutex                                   m_mutex;
+        std::unordered_map<std::string, order_state>         m_orders;   ///< by uuid
+        std::unordered_map<std::string, pair_state>          m_pairs;    ///< by "<base>/<rel>"
+        std::unordered_map<std::string, maker_pair_settings> m_settings; ///< by "<base>/<rel>"
+        maker_repricing_metrics                              m_metrics;
+    };
+} // namespace atomic_dex
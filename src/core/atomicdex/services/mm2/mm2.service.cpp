@@ -15,6 +15,7 @@
  ******************************************************************************/
 
 //! STD
+#include <future>
 #include <unordered_set>
 
 ///! Qt
@@ -23,7 +24,9 @@
 #include <QProcess>
 
 //! Project Headers
+#include "atomicdex/api/mm2/mm2.batch.decoder.hpp"
 #include "atomicdex/api/mm2/mm2.constants.hpp"
+#include "atomicdex/api/mm2/mm2.swap.status.hpp"
 #include "atomicdex/api/mm2/rpc.electrum.hpp"
 #include "atomicdex/api/mm2/rpc.enable.hpp"
 #include "atomicdex/api/mm2/rpc.min.volume.hpp"
@@ -33,6 +36,7 @@
 #include "atomicdex/pages/qt.portfolio.page.hpp"
 #include "atomicdex/services/internet/internet.checker.service.hpp"
 #include "atomicdex/services/mm2/mm2.service.hpp"
+#include "atomicdex/services/price/global.provider.hpp"
 #include "atomicdex/utilities/kill.hpp" ///< no delete
 #include "atomicdex/utilities/qt.utilities.hpp"
 #include "atomicdex/utilities/stacktrace.prerequisites.hpp"
@@ -123,10 +127,11 @@ namespace
         }
     }
 
+    //! `disabled_tickers` lose their currently_enabled flag in the same registry update, the registry is copied once for the whole list.
     void
     update_coin_status(
-        const std::string& wallet_name, const std::vector<std::string>& tickers, bool status, atomic_dex::t_coins_registry& registry,
-        std::shared_mutex& registry_mtx, std::string field_name = "active")
+        const std::string& wallet_name, const std::vector<std::string>& tickers, bool status, atomic_dex::t_coins_rcu_registry& registry,
+        std::string field_name = "active", const std::vector<std::string>& disabled_tickers = {})
     {
         SPDLOG_INFO("Update coins status to: {} - field_name: {} - tickers: {}", status, field_name, fmt::join(tickers, ", "));
         fs::path    cfg_path               = atomic_dex::utils::get_atomic_dex_config_folder();
@@ -151,29 +156,33 @@ namespace
         }
 
         config_json_data = nlohmann::json::parse(QString(ifs.readAll()).toStdString());
-        {
-            std::shared_lock lock(registry_mtx);
-            for (auto&& ticker: tickers)
+        registry.update(
+            [&](atomic_dex::coins_registry_data& data)
             {
-                if (registry[ticker].is_custom_coin)
-                {
-                    custom_cfg_data.at(ticker)[field_name] = status;
-                }
-                else
-                {
-                    config_json_data.at(ticker)[field_name] = status;
-                }
-                if (field_name == "active")
+                for (auto&& ticker: tickers)
                 {
-                    SPDLOG_INFO("ticker: {} status active: {}", ticker, status);
-                    registry[ticker].active = status;
-                }
-                else if (field_name == "is_segwit_on")
-                {
-                    registry[ticker].is_segwit_on = status;
+                    auto& cfg = data.registry[ticker];
+                    if (cfg.is_custom_coin)
+                    {
+                        custom_cfg_data.at(ticker)[field_name] = status;
+                    }
+                    else
+                    {
+                        config_json_data.at(ticker)[field_name] = status;
+                    }
+                    if (field_name == "active")
+                    {
+                        SPDLOG_INFO("ticker: {} status active: {}", ticker, status);
+                        cfg.active = status;
+                    }
+                    else if (field_name == "is_segwit_on")
+                    {
+                        cfg.is_segwit_on = status;
+                    }
                 }
-            }
-        }
+                for (auto&& ticker: disabled_tickers) { data.registry[ticker].currently_enabled = false; }
+                data.refresh_enabled();
+            });
 
         ifs.close();
 
@@ -196,10 +205,63 @@ namespace
             ofs_custom.close();
         }
     }
+
+    //! Looks the notes of a whole history up at once instead of once per transaction.
+    void
+    attach_transactions_notes(atomic_dex::t_transactions& transactions, const atomic_dex::qt_wallet_manager& wallet_manager)
+    {
+        std::vector<std::string> tx_hashes;
+        tx_hashes.reserve(transactions.size());
+        for (auto&& cur: transactions) { tx_hashes.push_back(cur.tx_hash); }
+        auto notes = wallet_manager.retrieve_transactions_notes(tx_hashes);
+        for (std::size_t idx = 0; idx < transactions.size(); ++idx) { transactions[idx].transaction_note = std::move(notes[idx]); }
+    }
+
+    //! Network hiccups are worth a retry, a bad configuration or an already enabled coin is not.
+    bool
+    is_retryable_enable_error(const std::string& error)
+    {
+        if (error.find("already initialized") != std::string::npos)
+        {
+            return false;
+        }
+        for (const auto* pattern: {"timed out", "timeout", "Timeout", "Transport", "connection", "Connection"})
+        {
+            if (error.find(pattern) != std::string::npos)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //! Content change key of a balance / tx batch: its sorted method and coin pairs, an answer is only compared to the answer of the same batch.
+    std::string
+    batch_content_key(const nlohmann::json& batch)
+    {
+        std::vector<std::string> entries;
+        entries.reserve(batch.size());
+        for (auto&& request: batch) { entries.push_back(request.value("method", "") + ":" + request.value("coin", "")); }
+        std::sort(entries.begin(), entries.end());
+        return fmt::format("{}", fmt::join(entries, ","));
+    }
 } // namespace
 
 namespace atomic_dex
 {
+    void
+    coins_registry_data::refresh_enabled()
+    {
+        enabled.clear();
+        for (auto&& [key, value]: registry)
+        {
+            if (value.currently_enabled)
+            {
+                enabled.push_back(value);
+            }
+        }
+    }
+
     std::vector<atomic_dex::coin_config>
     mm2_service::retrieve_coins_informations()
     {
@@ -215,16 +277,9 @@ namespace atomic_dex
         LOG_PATH("Retrieving Wallet information of {}", (cfg_path / filename));
         auto retrieve_cfg_functor = [](fs::path path) -> std::unordered_map<std::string, atomic_dex::coin_config>
         {
-            if (exists(path))
-            {
-                QFile ifs;
-                ifs.setFileName(atomic_dex::std_path_to_qstring(path));
-                ifs.open(QIODevice::ReadOnly | QIODevice::Text);
-                nlohmann::json config_json_data = nlohmann::json::parse(QString(ifs.readAll()).toStdString());
-                auto           res              = config_json_data.get<std::unordered_map<std::string, atomic_dex::coin_config>>();
-                return res;
-            }
-            return {};
+            //! The json is only parsed when the file changed since the last login, otherwise its binary snapshot is mapped
+            const auto snapshot_path = utils::get_atomic_dex_coins_cfg_cache_folder() / (path.filename().string() + ".snapshot");
+            return coins_cfg_snapshot::open(path, snapshot_path).decode_all<atomic_dex::coin_config>();
         };
 
         auto official_cfg = retrieve_cfg_functor(cfg_path / filename);
@@ -232,10 +287,9 @@ namespace atomic_dex
         {
             cfg.reserve(official_cfg.size());
             for (auto&& [key, value]: official_cfg) { cfg.emplace_back(value); }
-            {
-                std::unique_lock lock(m_coin_cfg_mutex);
-                m_coins_informations = std::move(official_cfg);
-            }
+            coins_registry_data data{.registry = std::move(official_cfg)};
+            data.refresh_enabled();
+            m_coins_informations.publish(std::move(data));
         }
 
         auto custom_cfg = retrieve_cfg_functor(cfg_path / custom_tokens_filename);
@@ -243,19 +297,26 @@ namespace atomic_dex
         {
             SPDLOG_INFO("Custom coins detected, adding them to the runtime configuration");
             for (auto&& [key, value]: custom_cfg) { cfg.emplace_back(value); }
-            {
-                std::unique_lock lock(m_coin_cfg_mutex);
-                m_coins_informations.insert(custom_cfg.begin(), custom_cfg.end());
-            }
+            m_coins_informations.update(
+                [&custom_cfg](coins_registry_data& data)
+                {
+                    data.registry.insert(custom_cfg.begin(), custom_cfg.end());
+                    data.refresh_enabled();
+                });
         }
 
         return cfg;
     }
 
-    mm2_service::mm2_service(entt::registry& registry, ag::ecs::system_manager& system_manager) : system(registry), m_system_manager(system_manager)
+    mm2_service::mm2_service(entt::registry& registry, ag::ecs::system_manager& system_manager) :
+        system(registry), m_system_manager(system_manager),
+        m_activation_pipeline(
+            activation_pipeline_cfg{}, [this](const coin_activation_pipeline::job& job) { launch_coin_activation(job); },
+            [this](std::vector<std::string> tickers) { on_coins_activated(std::move(tickers)); })
     {
         m_orderbook_clock = std::chrono::high_resolution_clock::now();
         m_info_clock      = std::chrono::high_resolution_clock::now();
+        m_balance_clock   = std::chrono::high_resolution_clock::now();
         dispatcher_.sink<gui_enter_trading>().connect<&mm2_service::on_gui_enter_trading>(*this);
         dispatcher_.sink<gui_leave_trading>().connect<&mm2_service::on_gui_leave_trading>(*this);
         dispatcher_.sink<orderbook_refresh>().connect<&mm2_service::on_refresh_orderbook>(*this);
@@ -275,6 +336,7 @@ namespace atomic_dex
         const auto now    = std::chrono::high_resolution_clock::now();
         const auto s      = std::chrono::duration_cast<std::chrono::seconds>(now - m_orderbook_clock);
         const auto s_info = std::chrono::duration_cast<std::chrono::seconds>(now - m_info_clock);
+        const auto s_bal  = std::chrono::duration_cast<std::chrono::seconds>(now - m_balance_clock);
 
         if (s >= 5s)
         {
@@ -283,9 +345,17 @@ namespace atomic_dex
             m_orderbook_clock = std::chrono::high_resolution_clock::now();
         }
 
+        if (s_bal >= 1s)
+        {
+            process_due_balances();
+            m_activation_pipeline.tick(coin_activation_pipeline::t_clock::now());
+            m_balance_clock = std::chrono::high_resolution_clock::now();
+        }
+
         if (s_info >= 30s)
         {
-            fetch_infos_thread();
+            //! Balances are refreshed by process_due_balances, only the current ticker history is polled here
+            fetch_infos_thread(true, true);
             m_info_clock = std::chrono::high_resolution_clock::now();
         }
     }
@@ -297,6 +367,7 @@ namespace atomic_dex
         dispatcher_.sink<gui_leave_trading>().disconnect<&mm2_service::on_gui_leave_trading>(*this);
         dispatcher_.sink<orderbook_refresh>().disconnect<&mm2_service::on_refresh_orderbook>(*this);
         SPDLOG_INFO("mm2 signals successfully disconnected");
+        m_mm2_init_cancelled = true;
         bool mm2_stopped = false;
         if (m_mm2_running)
         {
@@ -318,6 +389,35 @@ namespace atomic_dex
         m_mm2_running = false;
         // m_token_source.cancel();
         m_mm2_client.stop();
+        m_decode_queue.stop();
+        m_swaps_history.close();
+        const auto pool_metrics = m_mm2_client.get_pool_metrics();
+        SPDLOG_INFO(
+            "mm2 client pool -> hits: {}, misses: {}, waits: {}, timeouts: {}, total wait: {}us", pool_metrics.hits, pool_metrics.misses, pool_metrics.waits,
+            pool_metrics.timeouts, pool_metrics.total_wait_time.count());
+        for (auto&& [rpc, stage]: m_decode_queue.get_metrics().stages)
+        {
+            SPDLOG_INFO(
+                "mm2 decode stage {} -> processed: {}, coalesced: {}, dropped: {}, failed: {}, max wait: {}us, max decode: {}us", rpc, stage.nb_processed,
+                stage.nb_coalesced, stage.nb_dropped, stage.nb_failed, stage.max_queue_wait.count(), stage.max_decode_time.count());
+        }
+        for (auto&& [stage, metrics]: m_content_changes.get_metrics())
+        {
+            SPDLOG_INFO(
+                "mm2 change detection {} -> checks: {}, skipped: {}, skip rate: {:.2f}", stage, metrics.nb_checks, metrics.nb_skipped, metrics.skip_rate());
+        }
+        const auto volume_metrics = m_trade_volumes.get_metrics();
+        SPDLOG_INFO(
+            "mm2 trade volumes cache -> hits: {}, misses: {}, invalidated: {}", volume_metrics.nb_hits, volume_metrics.nb_misses,
+            volume_metrics.nb_invalidated);
+        const auto balance_metrics = m_balance_refresh_scheduler.get_metrics();
+        for (auto&& [tier, metrics]: {std::pair{"hot", balance_metrics.hot}, std::pair{"cold", balance_metrics.cold}})
+        {
+            SPDLOG_INFO(
+                "mm2 balance refresh {} -> batches: {}, coins: {}, changes: {}, request bytes: {}, answer bytes: {}, total latency: {}us", tier,
+                metrics.nb_batches, metrics.nb_coins, metrics.nb_changes, metrics.request_bytes, metrics.answer_bytes, metrics.total_latency.count());
+        }
+        SPDLOG_INFO("mm2 balance refresh -> full refreshes: {}", balance_metrics.nb_full_refresh);
 
         if (!mm2_stopped)
         {
@@ -357,27 +457,33 @@ namespace atomic_dex
     t_coins
     mm2_service::get_enabled_coins() const
     {
-        t_coins destination;
+        return m_coins_informations.snapshot()->enabled;
+    }
 
-        std::shared_lock lock(m_coin_cfg_mutex);
-        for (auto&& [key, value]: m_coins_informations)
-        {
-            if (value.currently_enabled)
-            {
-                destination.push_back(value);
-            }
-        }
+    std::shared_ptr<const t_coins>
+    mm2_service::get_enabled_coins_view() const
+    {
+        auto snapshot = m_coins_informations.snapshot();
+        return std::shared_ptr<const t_coins>(snapshot, &snapshot->enabled);
+    }
 
-        return destination;
+    void
+    mm2_service::set_currently_enabled(const std::vector<std::string>& tickers, bool status)
+    {
+        m_coins_informations.update(
+            [&tickers, status](coins_registry_data& data)
+            {
+                for (auto&& ticker: tickers) { data.registry[ticker].currently_enabled = status; }
+                data.refresh_enabled();
+            });
     }
 
     t_coins
     mm2_service::get_active_coins() const
     {
-        t_coins destination;
-
-        std::shared_lock lock(m_coin_cfg_mutex);
-        for (auto&& [key, value]: m_coins_informations)
+        t_coins    destination;
+        const auto snapshot = m_coins_informations.snapshot();
+        for (auto&& [key, value]: snapshot->registry)
         {
             if (value.active)
             {
@@ -391,12 +497,24 @@ namespace atomic_dex
     bool
     mm2_service::disable_coin(const std::string& ticker, std::error_code& ec)
     {
-        coin_config coin_info = get_coin_info(ticker);
-        if (not coin_info.currently_enabled)
+        if (not get_coin_info(ticker).currently_enabled)
         {
             return true;
         }
+        if (!request_disable_coin(ticker, ec))
+        {
+            return false;
+        }
+
+        set_currently_enabled({ticker}, false);
+
+        dispatcher_.trigger<coin_disabled>(ticker);
+        return true;
+    }
 
+    bool
+    mm2_service::request_disable_coin(const std::string& ticker, std::error_code& ec)
+    {
         t_disable_coin_request request{.coin = ticker};
         auto                   answer = m_mm2_client.rpc_disable_coin(std::move(request));
 
@@ -420,14 +538,6 @@ namespace atomic_dex
             }
         }
 
-        coin_info.currently_enabled = false;
-
-        {
-            std::unique_lock lock(m_coin_cfg_mutex);
-            m_coins_informations[ticker].currently_enabled = false;
-        }
-
-        dispatcher_.trigger<coin_disabled>(ticker);
         return true;
     }
 
@@ -456,17 +566,27 @@ namespace atomic_dex
     mm2_service::disable_multiple_coins(const std::vector<std::string>& tickers)
     {
         SPDLOG_DEBUG("disable_multiple_coins");
+        std::vector<std::string> disabled_tickers;
         for (const auto& ticker: tickers)
         {
+            if (not get_coin_info(ticker).currently_enabled)
+            {
+                continue;
+            }
             std::error_code ec;
-            disable_coin(ticker, ec);
-            if (ec)
+            if (request_disable_coin(ticker, ec))
+            {
+                disabled_tickers.push_back(ticker);
+            }
+            else
             {
                 SPDLOG_WARN("{}", ec.message());
             }
         }
 
-        update_coin_status(this->m_current_wallet_name, tickers, false, m_coins_informations, m_coin_cfg_mutex);
+        //! One registry update for the active and currently_enabled flags of the whole list
+        update_coin_status(this->m_current_wallet_name, tickers, false, m_coins_informations, "active", disabled_tickers);
+        for (auto&& ticker: disabled_tickers) { dispatcher_.trigger<coin_disabled>(ticker); }
     }
 
     auto
@@ -478,44 +598,71 @@ namespace atomic_dex
         auto&& [batch_array, tickers_idx, tokens_to_fetch] = prepare_batch_balance_and_tx(only_tx);
         return m_mm2_client.async_rpc_batch_standalone(batch_array)
             .then(
-                [this, tokens_to_fetch = tokens_to_fetch, is_a_reset, tickers](web::http::http_response resp)
+                [this, batch_array = batch_array, tokens_to_fetch = tokens_to_fetch, is_a_reset](web::http::http_response resp)
                 {
-                    try
+                    auto decode_functor = [this, resp, batch_array, tokens_to_fetch, is_a_reset, batch_key = batch_content_key(batch_array)]()
                     {
-                        auto answers = ::mm2::api::basic_batch_answer(resp);
-                        if (not answers.contains("error"))
+                        try
                         {
-                            for (auto&& answer: answers)
+                            const std::string body = TO_STD_STR(resp.extract_string(true).get());
+                            const auto        hash = answer_hash(body);
+                            if (is_a_reset)
                             {
-                                if (answer.contains("balance"))
-                                {
-                                    this->process_balance_answer(answer);
-                                }
-                                else if (answer.contains("result"))
-                                {
-                                    this->process_tx_answer(answer);
-                                }
-                                else
+                                m_content_changes.store("balance_and_tx", batch_key, hash);
+                            }
+                            else if (!m_content_changes.changed("balance_and_tx", batch_key, hash))
+                            {
+                                //! Same balance and same history as the last answer, the models are already up to date
+                                touch_unchanged_balances(batch_array);
+                                for (auto&& coin: tokens_to_fetch) { process_tx_tokenscan(coin, is_a_reset); }
+                                return;
+                            }
+
+                            auto answers = ::mm2::api::decode_batch_answer(body, batch_array);
+                            if (not answers.error.has_value())
+                            {
+                                std::vector<t_balance_answer> balances;
+                                for (auto&& answer: answers.answers)
                                 {
-                                    const std::string error = answer.dump(4);
-                                    SPDLOG_ERROR("error answer for tx or my_balance: {}", error);
-                                    this->dispatcher_.trigger<tx_fetch_finished>(true);
-                                    if (error.find("future timed out") != std::string::npos)
+                                    if (auto* balance = std::get_if<t_balance_answer>(&answer); balance != nullptr && balance->rpc_result_code == 200)
                                     {
-                                        SPDLOG_WARN("Future timed out error detected, probably a connection issue");
-                                        //! Emit error for UI Change
+                                        balances.push_back(std::move(*balance));
+                                    }
+                                    else if (auto* tx = std::get_if<::mm2::api::tx_history_answer>(&answer); tx != nullptr && tx->result.has_value())
+                                    {
+                                        this->process_tx_answer(*tx);
+                                    }
+                                    else
+                                    {
+                                        const std::string error = std::holds_alternative<nlohmann::json>(answer) ? std::get<nlohmann::json>(answer).dump(4)
+                                                                                                                 : "invalid answer for tx or my_balance";
+                                        SPDLOG_ERROR("error answer for tx or my_balance: {}", error);
+                                        this->dispatcher_.trigger<tx_fetch_finished>(true);
+                                        if (error.find("future timed out") != std::string::npos)
+                                        {
+                                            SPDLOG_WARN("Future timed out error detected, probably a connection issue");
+                                            //! Emit error for UI Change
+                                        }
                                     }
                                 }
-                            }
+                                this->process_balance_answers(std::move(balances));
 
-                            for (auto&& coin: tokens_to_fetch) { process_tx_tokenscan(coin, is_a_reset); }
+                                for (auto&& coin: tokens_to_fetch) { process_tx_tokenscan(coin, is_a_reset); }
+                            }
+                            else
+                            {
+                                m_content_changes.forget("balance_and_tx", batch_key);
+                            }
                         }
-                    }
-                    catch (const std::exception& error)
-                    {
-                        SPDLOG_ERROR("exception in batch_balance_and_tx: {}", error.what());
-                        this->dispatcher_.trigger<tx_fetch_finished>(true);
-                    }
+                        catch (const std::exception& error)
+                        {
+                            m_content_changes.forget("balance_and_tx", batch_key);
+                            SPDLOG_ERROR("exception in batch_balance_and_tx: {}", error.what());
+                            this->dispatcher_.trigger<tx_fetch_finished>(true);
+                        }
+                    };
+                    //! Every balance / tx answer is applied, the producer waits if the decode queue is full.
+                    m_decode_queue.push(decode_queue::job{.rpc = "balance_and_tx", .policy = decode_policy::keep_all, .task = std::move(decode_functor)});
                 })
             .then([this, batch = batch_array](pplx::task<void> previous_task)
                   { this->handle_exception_pplx_task(previous_task, "batch_balance_and_tx", batch); });
@@ -524,7 +671,8 @@ namespace atomic_dex
     std::tuple<nlohmann::json, std::vector<std::string>, std::vector<std::string>>
     mm2_service::prepare_batch_balance_and_tx(bool only_tx) const
     {
-        const auto&              enabled_coins = get_enabled_coins();
+        const auto               enabled_coins = get_enabled_coins_view();
+        const auto               balances      = m_balance_informations.snapshot();
         nlohmann::json           batch_array   = nlohmann::json::array();
         std::vector<std::string> tickers_idx;
         std::vector<std::string> tokens_to_fetch;
@@ -543,15 +691,11 @@ namespace atomic_dex
         }
         if (not only_tx)
         {
-            for (auto&& coin: enabled_coins)
+            for (auto&& coin: *enabled_coins)
             {
-                if (is_pin_cfg_enabled())
+                if (is_pin_cfg_enabled() && balances->contains(coin.ticker))
                 {
-                    std::shared_lock lock(m_balance_mutex); ///< shared_lock
-                    if (m_balance_informations.find(coin.ticker) != m_balance_informations.cend())
-                    {
-                        continue;
-                    }
+                    continue;
                 }
                 t_balance_request balance_request{.coin = coin.ticker};
                 nlohmann::json    j = ::mm2::api::template_request("my_balance");
@@ -577,10 +721,7 @@ namespace atomic_dex
         if (answer.contains("coin"))
         {
             auto ticker = answer.at("coin").get<std::string>();
-            {
-                std::unique_lock lock(m_coin_cfg_mutex);
-                m_coins_informations[ticker].currently_enabled = true;
-            }
+            set_currently_enabled({ticker}, true);
             return {true, ""};
         }
 
@@ -591,40 +732,46 @@ namespace atomic_dex
     void
     mm2_service::batch_enable_coins(const std::vector<std::string>& tickers, bool first_time)
     {
-        nlohmann::json btc_kmd_batch = nlohmann::json::array();
         if (first_time)
         {
-            coin_config        coin_info = get_coin_info(g_second_primary_dex_coin);
-            t_electrum_request request{.coin_name = coin_info.ticker, .servers = coin_info.electrum_urls.value(), .with_tx_history = true};
-            if (coin_info.segwit && coin_info.is_segwit_on)
-            {
-                request.address_format                   = nlohmann::json::object();
-                request.address_format.value()["format"] = "segwit";
-            }
-            nlohmann::json j = ::mm2::api::template_request("electrum");
-            ::mm2::api::to_json(j, request);
-            btc_kmd_batch.push_back(j);
-            coin_info = get_coin_info(g_primary_dex_coin);
-            t_electrum_request request_kmd{.coin_name = coin_info.ticker, .servers = coin_info.electrum_urls.value(), .with_tx_history = true};
-            j = ::mm2::api::template_request("electrum");
-            ::mm2::api::to_json(j, request_kmd);
-            btc_kmd_batch.push_back(j);
+            enable_default_coins_batch();
         }
 
-        nlohmann::json batch_array = nlohmann::json::array();
-
-        std::vector<std::string> copy_tickers;
-
+        std::vector<coin_config> to_enable;
         for (const auto& ticker: tickers)
         {
             if (ticker == g_primary_dex_coin || ticker == g_second_primary_dex_coin)
                 continue;
-            copy_tickers.push_back(ticker);
             coin_config coin_info = get_coin_info(ticker);
+            if (!coin_info.currently_enabled)
+            {
+                to_enable.push_back(std::move(coin_info));
+            }
+        }
 
-            if (coin_info.currently_enabled)
+        //! Coins paying the fees of other coins of the list go first, then the current ticker, then the portfolio order
+        std::unordered_set<std::string> fee_parents;
+        for (auto&& coin_info: to_enable)
+        {
+            if (coin_info.fees_ticker != coin_info.ticker)
             {
-                continue;
+                fee_parents.insert(coin_info.fees_ticker);
+            }
+        }
+        const auto current_ticker = get_current_ticker();
+
+        std::vector<coin_activation_pipeline::job> jobs;
+        jobs.reserve(to_enable.size());
+        for (auto&& coin_info: to_enable)
+        {
+            coin_activation_pipeline::job job{.ticker = coin_info.ticker, .fee_parent = coin_info.fees_ticker};
+            if (fee_parents.contains(coin_info.ticker))
+            {
+                job.priority = activation_priority::fee_parent;
+            }
+            else if (coin_info.ticker == current_ticker)
+            {
+                job.priority = activation_priority::current_ticker;
             }
 
             if (!coin_info.is_erc_family)
@@ -640,9 +787,8 @@ namespace atomic_dex
                     request.address_format                   = nlohmann::json::object();
                     request.address_format.value()["format"] = "segwit";
                 }
-                nlohmann::json j = ::mm2::api::template_request("electrum");
-                ::mm2::api::to_json(j, request);
-                batch_array.push_back(j);
+                job.request = ::mm2::api::template_request("electrum");
+                ::mm2::api::to_json(job.request, request);
             }
             else
             {
@@ -652,11 +798,11 @@ namespace atomic_dex
                     .coin_type       = coin_info.coin_type,
                     .is_testnet      = coin_info.is_testnet.value_or(false),
                     .with_tx_history = false};
-                nlohmann::json j = ::mm2::api::template_request("enable");
-                ::mm2::api::to_json(j, request);
-                // SPDLOG_INFO("enable request: {}", j.dump(4));
-                batch_array.push_back(j);
+                job.request = ::mm2::api::template_request("enable");
+                ::mm2::api::to_json(job.request, request);
             }
+            jobs.push_back(std::move(job));
+
             //! If the coin is a custom coin and not present, then we have a config mismatch, we re-add it to the mm2 coins cfg but this need a app restart.
             if (coin_info.is_custom_coin && !this->is_this_ticker_present_in_raw_cfg(coin_info.ticker))
             {
@@ -670,95 +816,146 @@ namespace atomic_dex
             }
         }
 
-        // SPDLOG_DEBUG("{}", batch_array.dump(4));
-        auto functor = [this](nlohmann::json batch_array, std::vector<std::string> tickers)
-        {
-            m_mm2_client.async_rpc_batch_standalone(batch_array)
-                .then(
-                    [this, tickers](web::http::http_response resp) mutable
-                    {
-                        try
-                        {
-                            SPDLOG_DEBUG("Enabling coin finished");
-                            auto answers = ::mm2::api::basic_batch_answer(resp);
-                            SPDLOG_DEBUG("Enabling coin parsed");
+        SPDLOG_DEBUG("starting async enabling of {} coins", jobs.size());
+        m_activation_pipeline.enqueue(std::move(jobs), coin_activation_pipeline::t_clock::now());
+    }
 
-                            if (answers.count("error") == 0)
-                            {
-                                std::size_t                     idx = 0;
-                                std::unordered_set<std::string> to_remove;
-                                for (auto&& answer: answers)
-                                {
-                                    auto [res, error] = this->process_batch_enable_answer(answer);
-                                    if (!res)
-                                    {
-                                        SPDLOG_DEBUG(
-                                            "bad answer for: [{}] -> removing it from enabling, idx: {}, tickers size: {}, answers size: {}", tickers[idx], idx,
-                                            tickers.size(), answers.size());
-                                        this->dispatcher_.trigger<enabling_coin_failed>(tickers[idx], error);
-                                        to_remove.emplace(tickers[idx]);
-                                        if (error.find("already initialized") == std::string::npos)
-                                        {
-                                            SPDLOG_WARN("Should set to false the active field in cfg for: {} - reason: {}", tickers[idx], error);
-                                        }
-                                    }
-                                    idx += 1;
-                                    if (res)
-                                    {
-                                        this->process_balance_answer(answer);
-                                    }
-                                }
+    void
+    mm2_service::enable_default_coins_batch()
+    {
+        //! Same pipeline as the other coins, ahead of them so the portfolio and the trading page are usable first
+        std::vector<coin_activation_pipeline::job> jobs;
+        for (auto&& ticker: g_default_coins)
+        {
+            const coin_config  coin_info = get_coin_info(ticker);
+            t_electrum_request request{.coin_name = coin_info.ticker, .servers = coin_info.electrum_urls.value(), .with_tx_history = true};
+            if (coin_info.segwit && coin_info.is_segwit_on)
+            {
+                request.address_format                   = nlohmann::json::object();
+                request.address_format.value()["format"] = "segwit";
+            }
+            coin_activation_pipeline::job job{.ticker = ticker, .priority = activation_priority::default_coin};
+            job.request = ::mm2::api::template_request("electrum");
+            ::mm2::api::to_json(job.request, request);
+            jobs.push_back(std::move(job));
+        }
+        m_activation_pipeline.enqueue(std::move(jobs), coin_activation_pipeline::t_clock::now());
+    }
 
-                                for (auto&& t: to_remove) { tickers.erase(std::remove(tickers.begin(), tickers.end(), t), tickers.end()); }
+    void
+    mm2_service::on_default_coin_enabled()
+    {
+        const auto all_enabled =
+            std::all_of(g_default_coins.begin(), g_default_coins.end(), [this](const std::string& ticker) { return get_coin_info(ticker).currently_enabled; });
+        if (!all_enabled || m_default_coins_enabled.exchange(true))
+        {
+            return;
+        }
+        SPDLOG_INFO("Trigger default_coins_enabled");
+        m_activation_pipeline.record_stage("default_coins_enabled", coin_activation_pipeline::t_clock::now());
+        record_startup_stage("default_coins_enabled");
+        this->dispatcher_.trigger<default_coins_enabled>();
+        batch_balance_and_tx(false, g_default_coins, true);
+    }
 
-                                if (!tickers.empty())
-                                {
-                                    if (tickers == g_default_coins)
-                                    {
-                                        SPDLOG_INFO("Trigger default_coins_enabled");
-                                        this->dispatcher_.trigger<default_coins_enabled>();
-                                        batch_balance_and_tx(false, tickers, true);
-                                    }
-                                    dispatcher_.trigger<coin_fully_initialized>(tickers);
-                                    if (tickers.size() == 1)
-                                    {
-                                        fetch_single_balance(get_coin_info(tickers[0]));
-                                    }
-                                    // batch_balance_and_tx(false, tickers, true);
-                                }
-                            }
+    void
+    mm2_service::launch_coin_activation(const coin_activation_pipeline::job& job)
+    {
+        nlohmann::json batch_array = nlohmann::json::array();
+        batch_array.push_back(job.request);
+        m_mm2_client.async_rpc_batch_standalone(batch_array)
+            .then(
+                [this, ticker = job.ticker](web::http::http_response resp)
+                {
+                    auto        status = activation_status::failed;
+                    std::string error;
+                    try
+                    {
+                        auto answers = ::mm2::api::basic_batch_answer(resp);
+                        if (answers.count("error") != 0 || answers.empty())
+                        {
+                            status = activation_status::retryable;
+                            error  = answers.dump();
                         }
-                        catch (const std::exception& error)
+                        else
                         {
-                            SPDLOG_ERROR("exception caught in batch_enable_coins: {}", error.what());
-                            // update_coin_status(this->m_current_wallet_name, tickers, false, m_coins_informations, m_coin_cfg_mutex);
-                            //! Emit event here
+                            auto [res, answer_error] = this->process_batch_enable_answer(answers[0]);
+                            if (res)
+                            {
+                                this->process_balance_answer(answers[0]);
+                                status = activation_status::enabled;
+                            }
+                            else
+                            {
+                                error  = std::move(answer_error);
+                                status = is_retryable_enable_error(error) ? activation_status::retryable : activation_status::failed;
+                            }
                         }
-                    })
-                .then(
-                    [this, tickers, batch_array](pplx::task<void> previous_task)
+                    }
+                    catch (const std::exception& exception)
                     {
-                        this->handle_exception_pplx_task(previous_task, "batch_enable_coins", batch_array);
-                        // update_coin_status(this->m_current_wallet_name, tickers, false, m_coins_informations, m_coin_cfg_mutex);
-                    });
-        };
+                        SPDLOG_ERROR("exception caught in launch_coin_activation: {}", exception.what());
+                        error = exception.what();
+                    }
+                    on_coin_activation_done(ticker, status, error);
+                })
+            .then(
+                [this, ticker = job.ticker, batch_array](pplx::task<void> previous_task)
+                {
+                    //! Transport failures never reached the answer handler, the pipeline still has to release the slot
+                    try
+                    {
+                        previous_task.wait();
+                    }
+                    catch (const std::exception& error)
+                    {
+                        on_coin_activation_done(ticker, activation_status::retryable, error.what());
+                    }
+                    this->handle_exception_pplx_task(previous_task, "batch_enable_coins", batch_array);
+                });
+    }
 
-        SPDLOG_DEBUG("starting async enabling coin");
+    void
+    mm2_service::on_coin_activation_done(const std::string& ticker, activation_status status, const std::string& error)
+    {
+        const auto now = coin_activation_pipeline::t_clock::now();
+        if (status == activation_status::enabled)
+        {
+            if (ticker == get_current_ticker())
+            {
+                m_activation_pipeline.record_stage("current_ticker_enabled", now);
+            }
+            dispatcher_.trigger<coin_fully_initialized>(std::vector<std::string>{ticker});
+            if (std::find(g_default_coins.begin(), g_default_coins.end(), ticker) != g_default_coins.end())
+            {
+                on_default_coin_enabled();
+            }
+            m_activation_pipeline.on_job_done(ticker, status, now);
+            return;
+        }
 
-        if (not btc_kmd_batch.empty() && first_time)
+        if (m_activation_pipeline.on_job_done(ticker, status, now))
+        {
+            SPDLOG_WARN("enabling {} failed, retrying later - reason: {}", ticker, error);
+            return;
+        }
+        SPDLOG_DEBUG("bad answer for: [{}] -> removing it from enabling", ticker);
+        this->dispatcher_.trigger<enabling_coin_failed>(ticker, error);
+        if (error.find("already initialized") == std::string::npos)
         {
-            functor(btc_kmd_batch, g_default_coins);
+            SPDLOG_WARN("Should set to false the active field in cfg for: {} - reason: {}", ticker, error);
         }
+    }
 
-        if (!batch_array.empty())
+    void
+    mm2_service::on_coins_activated(std::vector<std::string> tickers)
+    {
+        //! One balance batch for every coin enabled since the last follow-up instead of one request per coin
+        const bool with_current_ticker = std::find(tickers.begin(), tickers.end(), get_current_ticker()) != tickers.end();
+        refresh_balances(std::move(tickers), refresh_tier::hot);
+        if (with_current_ticker)
         {
-            for (std::size_t idx = 0; idx < batch_array.size(); ++idx)
-            {
-                nlohmann::json single_batch = nlohmann::json::array();
-                single_batch.push_back(batch_array.at(idx));
-                functor(single_batch, {copy_tickers[idx]});
-            }
-            // functor(batch_array, copy_tickers);
+            batch_balance_and_tx(false, {}, true, true);
         }
     }
 
@@ -766,18 +963,19 @@ namespace atomic_dex
     mm2_service::enable_multiple_coins(const std::vector<std::string>& tickers)
     {
         batch_enable_coins(tickers);
-        update_coin_status(this->m_current_wallet_name, tickers, true, m_coins_informations, m_coin_cfg_mutex);
+        update_coin_status(this->m_current_wallet_name, tickers, true, m_coins_informations);
     }
 
     coin_config
     mm2_service::get_coin_info(const std::string& ticker) const
     {
-        std::shared_lock lock(m_coin_cfg_mutex);
-        if (m_coins_informations.find(ticker) == m_coins_informations.cend())
+        const auto snapshot = m_coins_informations.snapshot();
+        const auto it       = snapshot->registry.find(ticker);
+        if (it == snapshot->registry.cend())
         {
             return {};
         }
-        return m_coins_informations.at(ticker);
+        return it->second;
     }
 
     t_orderbook_answer
@@ -800,7 +998,7 @@ namespace atomic_dex
     }
 
     nlohmann::json
-    mm2_service::prepare_batch_orderbook(bool is_a_reset)
+    mm2_service::prepare_batch_orderbook(bool with_volumes)
     {
         // SPDLOG_INFO("is_a_reset: {}", is_a_reset);
         auto&& [base, rel] = m_synchronized_ticker_pair.get();
@@ -816,7 +1014,7 @@ namespace atomic_dex
         };
 
         generate_req("orderbook", t_orderbook_request{.base = base, .rel = rel});
-        if (is_a_reset)
+        if (with_volumes)
         {
             generate_req("max_taker_vol", ::mm2::api::max_taker_vol_request{.coin = base});
             generate_req("max_taker_vol", ::mm2::api::max_taker_vol_request{.coin = rel});
@@ -828,25 +1026,91 @@ namespace atomic_dex
     }
 
     void
-    mm2_service::process_orderbook(bool is_a_reset)
+    mm2_service::process_orderbook(bool is_a_reset, bool reuse_volumes)
     {
-        auto batch = prepare_batch_orderbook(is_a_reset);
+        //! Answers of max_taker_vol base / rel then min_trading_vol base / rel, as ordered in the reset batch
+        using t_volumes_answers = std::array<nlohmann::json, 4>;
+
+        std::optional<t_volumes_answers> cached_volumes;
+        if (is_a_reset && reuse_volumes)
+        {
+            const auto [cur_base, cur_rel] = m_synchronized_ticker_pair.get();
+            const auto now                 = trade_volume_cache::t_clock::now();
+            auto       base_max            = m_trade_volumes.get(trade_volume_kind::max_taker_vol, cur_base, now);
+            auto       rel_max             = m_trade_volumes.get(trade_volume_kind::max_taker_vol, cur_rel, now);
+            auto       base_min            = m_trade_volumes.get(trade_volume_kind::min_trading_vol, cur_base, now);
+            auto       rel_min             = m_trade_volumes.get(trade_volume_kind::min_trading_vol, cur_rel, now);
+            if (base_max && rel_max && base_min && rel_min)
+            {
+                cached_volumes = t_volumes_answers{std::move(*base_max), std::move(*rel_max), std::move(*base_min), std::move(*rel_min)};
+            }
+        }
+
+        auto batch = prepare_batch_orderbook(is_a_reset && !cached_volumes.has_value());
         if (batch.empty())
             return;
         // SPDLOG_DEBUG("batch request: {}", batch.dump(4));
         // auto&& [base, rel] = m_synchronized_ticker_pair.get();
 
-        auto answer_functor = [this, is_a_reset](web::http::http_response resp)
+        auto decode_functor = [this, is_a_reset, batch, cached_volumes](const web::http::http_response& resp)
         {
-            auto&& [base, rel] = m_synchronized_ticker_pair.get();
-            auto answer        = ::mm2::api::basic_batch_answer(resp);
-            if (answer.is_array())
+            auto&& [base, rel]     = m_synchronized_ticker_pair.get();
+            const std::string body = TO_STD_STR(resp.extract_string(true).get());
+            auto              hash = answer_hash(body);
+            hash_combine(hash, base);
+            hash_combine(hash, rel);
+            if (is_a_reset)
             {
-                auto orderbook_answer = ::mm2::api::rpc_process_answer_batch<t_orderbook_answer>(answer[0], "orderbook");
+                m_content_changes.store("orderbook", "", hash);
+            }
+            else if (!m_content_changes.changed("orderbook", "", hash))
+            {
+                //! Same pair, same orders and same rates, the orderbook models have nothing to apply
+                return;
+            }
+
+            auto answers = ::mm2::api::decode_batch_answer(body, batch);
+            //! One answer per request of the batch (the orderbook, then the four volumes on a reset), a shorter batch is malformed
+            if (!answers.error.has_value() && answers.answers.size() >= batch.size())
+            {
+                auto&              answer = answers.answers;
+                t_orderbook_answer orderbook_answer{};
+                if (auto* decoded = std::get_if<t_orderbook_answer>(&answer[0]))
+                {
+                    orderbook_answer = std::move(*decoded);
+                }
+                else if (auto* raw = std::get_if<nlohmann::json>(&answer[0]))
+                {
+                    orderbook_answer = ::mm2::api::rpc_process_answer_batch<t_orderbook_answer>(*raw, "orderbook");
+                }
 
                 if (is_a_reset)
                 {
-                    auto base_max_taker_vol_answer = ::mm2::api::rpc_process_answer_batch<::mm2::api::max_taker_vol_answer>(answer[1], "max_taker_vol");
+                    t_volumes_answers volumes;
+                    if (cached_volumes.has_value())
+                    {
+                        volumes = *cached_volumes;
+                    }
+                    else
+                    {
+                        const auto now = trade_volume_cache::t_clock::now();
+                        for (std::size_t idx = 0; idx < volumes.size() && idx + 1 < answer.size(); ++idx)
+                        {
+                            auto* raw = std::get_if<nlohmann::json>(&answer[idx + 1]);
+                            if (raw == nullptr)
+                            {
+                                continue;
+                            }
+                            volumes[idx] = std::move(*raw);
+                            if (volumes[idx].contains("result"))
+                            {
+                                const auto kind = idx < 2 ? trade_volume_kind::max_taker_vol : trade_volume_kind::min_trading_vol;
+                                m_trade_volumes.store(kind, idx % 2 == 0 ? base : rel, volumes[idx], now);
+                            }
+                        }
+                    }
+
+                    auto base_max_taker_vol_answer = ::mm2::api::rpc_process_answer_batch<::mm2::api::max_taker_vol_answer>(volumes[0], "max_taker_vol");
                     if (base_max_taker_vol_answer.rpc_result_code == 200)
                     {
                         if (base == base_max_taker_vol_answer.result->coin)
@@ -858,7 +1122,7 @@ namespace atomic_dex
                         // SPDLOG_INFO("max_taker_vol: {}", answer[1].dump(4));
                     }
 
-                    auto rel_max_taker_vol_answer = ::mm2::api::rpc_process_answer_batch<::mm2::api::max_taker_vol_answer>(answer[2], "max_taker_vol");
+                    auto rel_max_taker_vol_answer = ::mm2::api::rpc_process_answer_batch<::mm2::api::max_taker_vol_answer>(volumes[1], "max_taker_vol");
                     if (rel_max_taker_vol_answer.rpc_result_code == 200)
                     {
                         if (rel == rel_max_taker_vol_answer.result->coin)
@@ -869,13 +1133,13 @@ namespace atomic_dex
                         // m_balance_factor; this->m_synchronized_max_taker_vol->second.decimal = rel_res.str(8);
                     }
 
-                    auto base_min_taker_vol_answer = ::mm2::api::rpc_process_answer_batch<t_min_volume_answer>(answer[3], "min_trading_vol");
+                    auto base_min_taker_vol_answer = ::mm2::api::rpc_process_answer_batch<t_min_volume_answer>(volumes[2], "min_trading_vol");
                     if (base_min_taker_vol_answer.rpc_result_code == 200)
                     {
                         m_synchronized_min_taker_vol->first = base_min_taker_vol_answer.result.value();
                     }
 
-                    auto rel_min_taker_vol_answer = ::mm2::api::rpc_process_answer_batch<t_min_volume_answer>(answer[4], "min_trading_vol");
+                    auto rel_min_taker_vol_answer = ::mm2::api::rpc_process_answer_batch<t_min_volume_answer>(volumes[3], "min_trading_vol");
                     if (rel_min_taker_vol_answer.rpc_result_code == 200)
                     {
                         m_synchronized_min_taker_vol->second = rel_min_taker_vol_answer.result.value();
@@ -886,12 +1150,22 @@ namespace atomic_dex
                 {
                     m_orderbook = orderbook_answer;
                     this->dispatcher_.trigger<process_orderbook_finished>(is_a_reset);
+                    return;
                 }
             }
+            m_content_changes.forget("orderbook", "");
         };
 
+        //! Only the newest snapshot of a pair is decoded, a reset snapshot also carries the volumes so it is never superseded by a refresh.
+        const auto        pair = m_synchronized_ticker_pair.get();
+        const std::string key  = pair.first + "/" + pair.second + (is_a_reset ? "/reset" : "");
         m_mm2_client.async_rpc_batch_standalone(batch)
-            .then(answer_functor)
+            .then(
+                [this, decode_functor, key](web::http::http_response resp)
+                {
+                    m_decode_queue.push(decode_queue::job{
+                        .rpc = "orderbook", .key = key, .policy = decode_policy::coalesce, .task = [decode_functor, resp]() { decode_functor(resp); }});
+                })
             .then([this, batch](pplx::task<void> previous_task) { this->handle_exception_pplx_task(previous_task, "process_orderbook", batch); });
     }
 
@@ -913,26 +1187,25 @@ namespace atomic_dex
     mm2_service::fetch_single_balance(const coin_config& cfg_infos)
     {
         nlohmann::json batch_array = nlohmann::json::array();
-        if (is_pin_cfg_enabled())
+        if (is_pin_cfg_enabled() && m_balance_informations.snapshot()->contains(cfg_infos.ticker))
         {
-            std::shared_lock lock(m_balance_mutex); ///< shared_lock
-            if (m_balance_informations.find(cfg_infos.ticker) != m_balance_informations.cend())
-            {
-                return;
-            }
+            return;
         }
         t_balance_request balance_request{.coin = cfg_infos.ticker};
         nlohmann::json    j = ::mm2::api::template_request("my_balance");
         ::mm2::api::to_json(j, balance_request);
         batch_array.push_back(j);
-        auto answer_functor = [this](web::http::http_response resp)
+        auto answer_functor = [this, batch_array](web::http::http_response resp)
         {
             try
             {
-                auto answers = ::mm2::api::basic_batch_answer(resp);
-                if (!answers.contains("error") && !answers[0].contains("error"))
+                auto answers = ::mm2::api::decode_batch_answer(resp, batch_array);
+                if (!answers.error.has_value() && !answers.answers.empty())
                 {
-                    this->process_balance_answer(answers[0]);
+                    if (auto* balance = std::get_if<t_balance_answer>(&answers.answers[0]); balance != nullptr && balance->rpc_result_code == 200)
+                    {
+                        this->process_balance_answer(std::move(*balance));
+                    }
                 }
             }
             catch (const std::exception& error)
@@ -958,18 +1231,123 @@ namespace atomic_dex
             const auto& enabled_coins = get_enabled_coins();
             for (auto&& coin: enabled_coins) { fetch_single_balance(coin); }
             batch_balance_and_tx(is_a_refresh, {}, false, true);
+            m_balance_refresh_scheduler.on_full_refresh(balance_refresh_scheduler::t_clock::now());
+        }
+    }
+
+    void
+    mm2_service::process_due_balances()
+    {
+        const auto               enabled_coins = get_enabled_coins_view();
+        std::vector<std::string> tickers;
+        tickers.reserve(enabled_coins->size());
+        for (auto&& coin: *enabled_coins) { tickers.push_back(coin.ticker); }
+        m_balance_refresh_scheduler.sync_enabled_coins(tickers);
+        m_balance_refresh_scheduler.set_current_ticker(get_current_ticker());
+
+        auto batch = m_balance_refresh_scheduler.next_batch(balance_refresh_scheduler::t_clock::now());
+        if (!batch.hot.empty())
+        {
+            refresh_balances(std::move(batch.hot), refresh_tier::hot);
         }
+        if (!batch.cold.empty())
+        {
+            refresh_balances(std::move(batch.cold), refresh_tier::cold);
+        }
+    }
+
+    void
+    mm2_service::refresh_balances(std::vector<std::string> tickers, refresh_tier tier)
+    {
+        if (is_pin_cfg_enabled())
+        {
+            //! Fake balances are never fetched again once known
+            const auto balances = m_balance_informations.snapshot();
+            std::erase_if(
+                tickers,
+                [this, &balances](const std::string& ticker)
+                {
+                    const auto it = balances->find(ticker);
+                    if (it == balances->cend())
+                    {
+                        return false;
+                    }
+                    m_balance_refresh_scheduler.on_balance(ticker, it->second.balance, balance_refresh_scheduler::t_clock::now());
+                    return true;
+                });
+            if (tickers.empty())
+            {
+                return;
+            }
+        }
+
+        nlohmann::json batch_array = nlohmann::json::array();
+        for (auto&& ticker: tickers)
+        {
+            t_balance_request balance_request{.coin = ticker};
+            nlohmann::json    j = ::mm2::api::template_request("my_balance");
+            ::mm2::api::to_json(j, balance_request);
+            batch_array.push_back(j);
+        }
+        const std::size_t request_bytes = batch_array.dump().size();
+
+        auto decode_functor = [this, batch_array, tier, request_bytes, tickers, stopwatch = spdlog::stopwatch{}](const web::http::http_response& resp)
+        {
+            const auto answer_bytes = static_cast<std::size_t>(resp.headers().content_length());
+            auto       answers      = ::mm2::api::decode_batch_answer(resp, batch_array);
+            if (!answers.error.has_value())
+            {
+                std::vector<t_balance_answer> balances;
+                for (auto&& answer: answers.answers)
+                {
+                    if (auto* balance = std::get_if<t_balance_answer>(&answer); balance != nullptr && balance->rpc_result_code == 200)
+                    {
+                        balances.push_back(std::move(*balance));
+                    }
+                }
+                this->process_balance_answers(std::move(balances));
+            }
+            //! Coins without a valid answer are released, answered ones are already
+            m_balance_refresh_scheduler.on_batch_failed(tickers, balance_refresh_scheduler::t_clock::now());
+            const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(stopwatch.elapsed());
+            m_balance_refresh_scheduler.on_batch_done(tier, tickers.size(), request_bytes, answer_bytes, latency);
+            SPDLOG_DEBUG(
+                "{} balance refresh of {} coins in {} us, request: {} bytes, answer: {} bytes", tier == refresh_tier::hot ? "hot" : "cold", tickers.size(),
+                latency.count(), request_bytes, answer_bytes);
+        };
+        auto release_functor = [this, tickers]() { m_balance_refresh_scheduler.on_batch_failed(tickers, balance_refresh_scheduler::t_clock::now()); };
+        auto answer_functor  = [this, decode_functor, release_functor](web::http::http_response resp)
+        {
+            m_decode_queue.push(decode_queue::job{
+                .rpc        = "my_balance",
+                .policy     = decode_policy::keep_all,
+                .task       = [decode_functor, resp]() { decode_functor(resp); },
+                .on_dropped = release_functor});
+        };
+        auto error_functor = [this, batch = batch_array, release_functor](pplx::task<void> previous_task)
+        {
+            try
+            {
+                previous_task.wait();
+            }
+            catch (const std::exception&)
+            {
+                release_functor();
+            }
+            this->handle_exception_pplx_task(previous_task, "refresh_balances", batch);
+        };
+        m_mm2_client.async_rpc_batch_standalone(batch_array).then(answer_functor).then(error_functor);
     }
 
     void
     mm2_service::spawn_mm2_instance(std::string wallet_name, std::string passphrase, bool with_pin_cfg)
     {
+        this->m_startup_timeline.start(startup_timeline::t_clock::now());
         this->m_balance_factor = utils::determine_balance_factor(with_pin_cfg);
         SPDLOG_DEBUG("balance factor is: {}", m_balance_factor);
         SPDLOG_DEBUG("{} l{} f[{}]", __FUNCTION__, __LINE__, fs::path(__FILE__).filename().string());
         this->m_current_wallet_name = std::move(wallet_name);
-        this->dispatcher_.trigger<coin_cfg_parsed>(this->retrieve_coins_informations());
-        this->dispatcher_.trigger<force_update_providers>();
+        this->m_swaps_history.open(utils::get_atomic_dex_swaps_history_folder(), m_current_wallet_name);
         mm2_config cfg{.passphrase = std::move(passphrase), .rpc_password = atomic_dex::gen_random_password()};
         ::mm2::api::set_system_manager(m_system_manager);
         ::mm2::api::set_rpc_password(cfg.rpc_password);
@@ -985,6 +1363,7 @@ namespace atomic_dex
         ofs.write(QString::fromStdString(json_cfg.dump()).toUtf8());
         ofs.close();
 
+        //! mm2 only reads the raw coins file, it is launched before the wallet configuration is parsed
         QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
         env.insert("MM_CONF_PATH", std_path_to_qstring(mm2_cfg_path));
         env.insert("MM_LOG", std_path_to_qstring(utils::get_mm2_atomic_dex_current_log_file()));
@@ -1000,36 +1379,66 @@ namespace atomic_dex
             SPDLOG_ERROR("Couldn't start mm2");
             std::exit(EXIT_FAILURE);
         }
+        record_startup_stage("mm2_spawned");
 
+        std::promise<void> coins_cfg_promise;
         m_mm2_init_thread = std::thread(
-            [this, mm2_cfg_path]()
+            [this, mm2_cfg_path, coins_cfg_parsed = coins_cfg_promise.get_future()]() mutable
             {
-                // std::this_thread::
-                using namespace std::chrono_literals;
-                auto               check_mm2_alive = []() { return ::mm2::api::rpc_version() != "error occured during rpc_version"; };
-                static std::size_t nb_try          = 0;
-
-                while (not check_mm2_alive())
+                auto report_failure = [this](const std::string& error)
                 {
-                    nb_try += 1;
-                    if (nb_try == 30)
-                    {
-                        SPDLOG_ERROR("MM2 not started correctly");
-                        //! TODO: emit mm2_failed_initialization
-                        fs::remove(mm2_cfg_path);
-                        return;
-                    }
-                    std::this_thread::sleep_for(1s);
+                    SPDLOG_ERROR("MM2 not started correctly: {}", error);
+                    m_startup_timeline.fail(error, startup_timeline::t_clock::now());
+                    SPDLOG_ERROR("startup timeline: {}", m_startup_timeline.to_json().dump());
+                    this->dispatcher_.trigger<fatal_notification>("mm2 failed to start: " + error);
+                };
+
+                const auto readiness = wait_for_mm2_readiness(
+                    mm2_readiness_cfg{},
+                    [](std::chrono::milliseconds probe_timeout) { return ::mm2::api::rpc_version(probe_timeout) != "error occured during rpc_version"; },
+                    m_mm2_init_cancelled);
+                fs_error_code ec;
+                fs::remove(mm2_cfg_path, ec);
+                if (readiness.cancelled)
+                {
+                    return;
+                }
+                if (!readiness.ready)
+                {
+                    report_failure(readiness.error);
+                    return;
                 }
+                record_startup_stage("mm2_ready");
+                SPDLOG_INFO("mm2 is initialized after {} probes in {}ms", readiness.nb_probes, readiness.elapsed.count());
 
-                // m_mm2_client.connect_client();
-                fs::remove(mm2_cfg_path);
-                SPDLOG_INFO("mm2 is initialized");
+                //! Default coins are enabled from the wallet configuration, parsed on the main thread while mm2 was booting
+                try
+                {
+                    coins_cfg_parsed.get();
+                }
+                catch (const std::exception& error)
+                {
+                    report_failure(std::string("coins configuration could not be parsed: ") + error.what());
+                    return;
+                }
                 dispatcher_.trigger<mm2_initialized>();
                 enable_default_coins();
                 m_mm2_running = true;
                 dispatcher_.trigger<mm2_started>();
             });
+
+        try
+        {
+            this->dispatcher_.trigger<coin_cfg_parsed>(this->retrieve_coins_informations());
+            record_startup_stage("coins_cfg_parsed");
+            coins_cfg_promise.set_value();
+        }
+        catch (...)
+        {
+            coins_cfg_promise.set_exception(std::current_exception());
+            throw;
+        }
+        this->dispatcher_.trigger<force_update_providers>();
     }
 
     t_float_50
@@ -1071,9 +1480,9 @@ namespace atomic_dex
     std::string
     mm2_service::my_balance(const std::string& ticker, t_mm2_ec& ec) const
     {
-        std::shared_lock lock(m_balance_mutex); ///! read
-        auto             it = m_balance_informations.find(ticker);
-        if (it == m_balance_informations.cend())
+        const auto balances = m_balance_informations.snapshot();
+        const auto it       = balances->find(ticker);
+        if (it == balances->cend())
         {
             ec = dextop_error::balance_of_a_non_enabled_coin;
             return "0";
@@ -1089,99 +1498,95 @@ namespace atomic_dex
         nlohmann::json my_orders_request = ::mm2::api::template_request("my_orders");
         batch.push_back(my_orders_request);
 
-
-        //! Swaps preparation
-        std::size_t       total           = 0;
-        std::size_t       nb_active_swaps = 0;
-        std::size_t       current_page    = 0;
-        std::size_t       limit           = 0;
-        t_filtering_infos filter_infos;
-        {
-            auto value_ptr  = m_orders_and_swaps.synchronize();
-            total           = value_ptr->total_swaps;
-            nb_active_swaps = value_ptr->active_swaps;
-            current_page    = value_ptr->current_page;
-            limit           = value_ptr->limit;
-            filter_infos    = value_ptr->filtering_infos;
-        }
-
-        //! First time fetch or current page
-        nlohmann::json            my_swaps = ::mm2::api::template_request("my_recent_swaps");
-        t_my_recent_swaps_request request{
-            .limit          = limit,
-            .page_number    = current_page,
-            .my_coin        = filter_infos.my_coin,
-            .other_coin     = filter_infos.other_coin,
-            .from_timestamp = filter_infos.from_timestamp,
-            .to_timestamp   = filter_infos.to_timestamp,
-        };
-        to_json(my_swaps, request);
-        batch.push_back(my_swaps);
-
-        //! Active swaps
+        //! Active swaps, the finished ones come from the swaps history
         nlohmann::json         active_swaps = ::mm2::api::template_request("active_swaps");
         t_active_swaps_request active_swaps_request{.statuses = true};
         to_json(active_swaps, active_swaps_request);
         batch.push_back(active_swaps);
 
-        auto answer_functor = [this, limit, filter_infos, after_manual_reset](web::http::http_response resp)
+        std::size_t       current_page = 0;
+        std::size_t       limit        = 0;
+        t_filtering_infos filter_infos;
+        {
+            auto value_ptr = m_orders_and_swaps.synchronize();
+            current_page   = value_ptr->current_page;
+            limit          = value_ptr->limit;
+            filter_infos   = value_ptr->filtering_infos;
+        }
+
+        auto decode_functor = [this, batch, current_page, limit, filter_infos, after_manual_reset](const web::http::http_response& resp)
         {
             spdlog::stopwatch stopwatch;
 
+            //! Orders and active swaps did not move, the history page is refreshed on its own when a sync changes it
+            const std::string body = TO_STD_STR(resp.extract_string(true).get());
+            const auto        hash = answer_hash(body);
+            if (after_manual_reset)
+            {
+                m_content_changes.store("orders_and_swaps", "", hash);
+            }
+            else if (!m_content_changes.changed("orders_and_swaps", "", hash))
+            {
+                if (m_swaps_sync_needed.exchange(false))
+                {
+                    sync_swaps_history();
+                }
+                return;
+            }
+
             //! Parsing Resp
             orders_and_swaps result;
-            auto             answers = ::mm2::api::basic_batch_answer(resp);
+            auto             decoded = ::mm2::api::decode_batch_answer(body, batch);
+            if (decoded.error.has_value() || decoded.answers.size() < 2)
+            {
+                m_content_changes.forget("orders_and_swaps", "");
+                SPDLOG_ERROR("error answer for batch_fetch_orders_and_swap: {}", decoded.error.value_or("incomplete batch answer"));
+                return;
+            }
+            auto& answers = decoded.answers;
 
             //! Extract
-            const auto orders_answers      = ::mm2::api::rpc_process_answer_batch<t_my_orders_answer>(answers[0], "my_orders");
-            const auto swap_answer         = ::mm2::api::rpc_process_answer_batch<t_my_recent_swaps_answer>(answers[1], "my_recent_swaps");
-            const auto active_swaps_answer = ::mm2::api::rpc_process_answer_batch<t_active_swaps_answer>(answers[2], "active_swaps");
+            const auto orders_answers = std::holds_alternative<t_my_orders_answer>(answers[0])
+                                            ? std::move(std::get<t_my_orders_answer>(answers[0]))
+                                            : ::mm2::api::rpc_process_answer_batch<t_my_orders_answer>(std::get<nlohmann::json>(answers[0]), "my_orders");
+            const auto active_swaps_answer =
+                ::mm2::api::rpc_process_answer_batch<t_active_swaps_answer>(std::get<nlohmann::json>(answers[1]), "active_swaps");
 
-            result.orders_and_swaps.reserve(orders_answers.orders.size() + limit);
+            result.orders_and_swaps.reserve(orders_answers.orders.size() + active_swaps_answer.swaps.size() + limit);
             result.nb_orders        = orders_answers.orders.size();
             result.orders_and_swaps = std::move(orders_answers.orders);
             result.orders_registry  = std::move(orders_answers.orders_id);
+            result.current_page     = current_page;
             result.limit            = limit;
             result.filtering_infos  = filter_infos;
 
-            //! Recent swaps
+            //! Active swaps
             result.active_swaps = active_swaps_answer.uuids.size();
+            std::unordered_set<std::string> swap_coins;
             for (auto&& cur: active_swaps_answer.swaps)
             {
+                swap_coins.emplace(cur.base_coin.toStdString());
+                swap_coins.emplace(cur.rel_coin.toStdString());
                 const auto uuid = cur.order_id.toStdString();
                 result.swaps_registry.emplace(uuid);
                 result.orders_and_swaps.emplace_back(std::move(cur));
             }
+            m_balance_refresh_scheduler.set_swap_coins(std::move(swap_coins));
 
-            //! Swaps
-            if (swap_answer.result.has_value())
+            //! A swap started or finished: the history only fetches what is new or still running
+            bool active_swaps_changed = false;
             {
-                const auto& swap_success_answer = swap_answer.result.value();
-                result.total_swaps              = swap_success_answer.total;
-                result.total_finished_swaps     = result.total_swaps - active_swaps_answer.uuids.size();
-                result.current_page             = swap_success_answer.page_number;
-                result.nb_pages                 = swap_success_answer.total_pages;
-                for (auto&& cur: swap_success_answer.swaps)
-                {
-                    const auto uuid = cur.order_id.toStdString();
-                    if (!result.swaps_registry.contains(uuid))
-                    {
-                        result.swaps_registry.emplace(uuid);
-                        result.orders_and_swaps.emplace_back(std::move(cur));
-                    }
-                }
-                result.average_events_time = std::move(swap_success_answer.average_events_time);
+                auto active_ptr      = m_active_swaps_uuids.synchronize();
+                active_swaps_changed = *active_ptr != active_swaps_answer.uuids;
+                *active_ptr          = active_swaps_answer.uuids;
+            }
+            if (active_swaps_changed || m_swaps_sync_needed.exchange(false))
+            {
+                sync_swaps_history();
             }
 
-            //! Post Metrics
-            /*SPDLOG_INFO(
-                "Metrics -> [total_swaps: {}, "
-                "active_swaps: {}, "
-                "nb_orders: {}, "
-                "nb_pages: {}, "
-                "current_page: {}, "
-                "total_finished_swaps: {}]",
-                result.total_swaps, result.active_swaps, result.nb_orders, result.nb_pages, result.current_page, result.total_finished_swaps);*/
+            //! Swaps history
+            append_swaps_history_page(result, active_swaps_answer.uuids);
 
             //! Compute everything
             m_orders_and_swaps = std::move(result);
@@ -1191,11 +1596,264 @@ namespace atomic_dex
         };
 
         // SPDLOG_INFO("batch request:{}", batch.dump(4));
+        //! A newer answer replaces the whole registry, only the last one queued is decoded.
         m_mm2_client.async_rpc_batch_standalone(batch)
-            .then(answer_functor)
+            .then(
+                [this, decode_functor, after_manual_reset](web::http::http_response resp)
+                {
+                    m_decode_queue.push(decode_queue::job{
+                        .rpc    = "orders_and_swaps",
+                        .key    = after_manual_reset ? "manual_reset" : "",
+                        .policy = decode_policy::coalesce,
+                        .task   = [decode_functor, resp]() { decode_functor(resp); }});
+                })
             .then([this, batch](pplx::task<void> previous_task) { this->handle_exception_pplx_task(previous_task, "batch_fetch_orders_and_swap", batch); });
     }
 
+    void
+    mm2_service::append_swaps_history_page(orders_and_swaps& result, const std::unordered_set<std::string>& active_uuids) const
+    {
+        const auto& filters = result.filtering_infos;
+        const auto  page    = m_swaps_history.query(
+            swaps_index_query{
+                .my_coin        = filters.my_coin,
+                .other_coin     = filters.other_coin,
+                .from_timestamp = filters.from_timestamp,
+                .to_timestamp   = filters.to_timestamp,
+                .page           = result.current_page,
+                .limit          = result.limit},
+            active_uuids);
+
+        //! Only the swaps of the page are decoded, the fiat amounts follow the current rates.
+        ::mm2::api::my_recent_swaps_answer_success finished;
+        finished.swaps.reserve(page.swaps.size());
+        for (auto&& cur: page.swaps)
+        {
+            t_order_swaps_data contents;
+            ::mm2::api::from_json(cur, contents);
+            finished.swaps.emplace_back(std::move(contents));
+        }
+        ::mm2::api::finalize_recent_swaps(finished);
+
+        result.total_finished_swaps = page.total;
+        result.total_swaps          = page.total + result.active_swaps;
+        result.nb_pages             = page.nb_pages;
+        result.current_page         = page.page;
+        result.average_events_time  = std::move(finished.average_events_time);
+        for (auto&& cur: finished.swaps)
+        {
+            if (result.swaps_registry.emplace(cur.order_id.toStdString()).second)
+            {
+                result.orders_and_swaps.emplace_back(std::move(cur));
+            }
+        }
+    }
+
+    t_content_hash
+    mm2_service::answer_hash(const std::string& body) const
+    {
+        t_content_hash hash = content_hash(body);
+        if (m_system_manager.has_system<global_price_service>())
+        {
+            hash_combine(hash, m_system_manager.get_system<global_price_service>().get_conversion_generation());
+        }
+        return hash;
+    }
+
+    void
+    mm2_service::touch_unchanged_balances(const nlohmann::json& batch)
+    {
+        //! The refresh scheduler still has to see the answer, an unchanged balance backs off
+        const auto balances = m_balance_informations.snapshot();
+        const auto now      = balance_refresh_scheduler::t_clock::now();
+        for (auto&& request: batch)
+        {
+            if (request.value("method", "") != "my_balance")
+            {
+                continue;
+            }
+            const std::string ticker = request.value("coin", "");
+            if (const auto it = balances->find(ticker); it != balances->cend())
+            {
+                m_balance_refresh_scheduler.on_balance(ticker, it->second.balance, now);
+                m_content_changes.record("balance", true);
+            }
+        }
+    }
+
+    void
+    mm2_service::refresh_swaps_history_page(bool after_manual_reset)
+    {
+        //! Orders and active swaps are kept, only the history part is read again.
+        //! Updated under a single lock so a concurrent orders and swaps refresh is not overwritten with the stale copy.
+        const auto active_uuids = m_active_swaps_uuids.get();
+        {
+            auto current = m_orders_and_swaps.synchronize();
+            current->orders_and_swaps.resize(std::min(current->orders_and_swaps.size(), current->nb_orders + current->active_swaps));
+            current->swaps_registry.clear();
+            for (std::size_t idx = current->nb_orders; idx < current->orders_and_swaps.size(); ++idx)
+            {
+                current->swaps_registry.emplace(current->orders_and_swaps[idx].order_id.toStdString());
+            }
+            append_swaps_history_page(*current, active_uuids);
+        }
+        this->dispatcher_.trigger<process_swaps_and_orders_finished>(after_manual_reset);
+    }
+
+    void
+    mm2_service::sync_swaps_history()
+    {
+        if (!m_swaps_history.is_open())
+        {
+            return;
+        }
+        if (m_swaps_sync_running.exchange(true))
+        {
+            m_swaps_sync_requested = true;
+            return;
+        }
+        m_swaps_sync_requested = false;
+
+        auto       sync   = std::make_shared<swaps_history_sync>();
+        const auto active = m_active_swaps_uuids.get();
+        for (auto&& uuid: m_swaps_history.pending_uuids())
+        {
+            if (!active.contains(uuid))
+            {
+                sync->waiting.emplace(uuid);
+            }
+        }
+        fetch_swaps_history_page(std::nullopt, std::move(sync));
+    }
+
+    void
+    mm2_service::fetch_swaps_history_page(std::optional<std::string> from_uuid, std::shared_ptr<swaps_history_sync> sync)
+    {
+        nlohmann::json            batch    = nlohmann::json::array();
+        nlohmann::json            my_swaps = ::mm2::api::template_request("my_recent_swaps");
+        t_my_recent_swaps_request request{
+            .limit       = g_swaps_history_sync_limit,
+            .page_number = from_uuid.has_value() ? std::nullopt : std::optional<std::size_t>{1},
+            .from_uuid   = std::move(from_uuid)};
+        to_json(my_swaps, request);
+        batch.push_back(my_swaps);
+
+        //! The raw swaps are stored, the answer is not decoded into order_swaps_data.
+        m_mm2_client.async_rpc_batch_standalone(batch)
+            .then(
+                [this, sync](web::http::http_response resp)
+                {
+                    auto answers = ::mm2::api::basic_batch_answer(resp);
+                    if (!answers.is_array() || answers.empty() || !answers[0].contains("result"))
+                    {
+                        SPDLOG_ERROR("error answer for the swaps history sync: {}", answers.dump());
+                        finish_swaps_history_sync(*sync);
+                        return;
+                    }
+                    m_decode_queue.push(decode_queue::job{
+                        .rpc        = "swaps_history",
+                        .policy     = decode_policy::keep_all,
+                        .task       = [this, sync, swaps = std::move(answers[0].at("result").at("swaps"))]()
+                        {
+                            try
+                            {
+                                process_swaps_history_page(swaps, sync);
+                            }
+                            catch (const std::exception& error)
+                            {
+                                SPDLOG_ERROR("swaps history sync failed: {}", error.what());
+                                finish_swaps_history_sync(*sync);
+                            }
+                        },
+                        .on_dropped = [this, sync]() { finish_swaps_history_sync(*sync); }});
+                })
+            .then(
+                [this, batch, sync](pplx::task<void> previous_task)
+                {
+                    try
+                    {
+                        previous_task.wait();
+                    }
+                    catch (const std::exception&)
+                    {
+                        this->handle_exception_pplx_task(previous_task, "sync_swaps_history", batch);
+                        finish_swaps_history_sync(*sync);
+                    }
+                });
+    }
+
+    void
+    mm2_service::process_swaps_history_page(const nlohmann::json& swaps, std::shared_ptr<swaps_history_sync> sync)
+    {
+        std::optional<std::string> last_uuid;
+        for (auto&& cur: swaps)
+        {
+            if (!cur.is_object() || !cur.contains("uuid"))
+            {
+                continue;
+            }
+            last_uuid = cur.at("uuid").get<std::string>();
+            sync->waiting.erase(*last_uuid);
+            switch (m_swaps_history.upsert(cur))
+            {
+            case swaps_index_upsert::inserted:
+            case swaps_index_upsert::updated:
+                sync->nb_changed += 1;
+                break;
+            case swaps_index_upsert::unchanged:
+                sync->reached_known = sync->reached_known || ::mm2::api::is_final_swap_status(m_swaps_history.get_status(*last_uuid).value_or(""));
+                break;
+            case swaps_index_upsert::invalid:
+                break;
+            }
+        }
+
+        //! A short page holds the oldest swap of the history.
+        if (swaps.size() < g_swaps_history_sync_limit || !last_uuid.has_value())
+        {
+            m_swaps_history.set_complete(true);
+            finish_swaps_history_sync(*sync);
+            return;
+        }
+
+        std::optional<std::string> next = std::move(last_uuid);
+        if (sync->reached_known && sync->waiting.empty())
+        {
+            if (m_swaps_history.is_complete())
+            {
+                finish_swaps_history_sync(*sync);
+                return;
+            }
+            //! The new swaps are indexed, an interrupted first sync goes on from the oldest indexed swap.
+            if (!sync->jumped_to_tail)
+            {
+                sync->jumped_to_tail = true;
+                next                 = m_swaps_history.oldest_uuid();
+            }
+        }
+        if (sync->nb_changed > 0)
+        {
+            m_swaps_history.save();
+        }
+        fetch_swaps_history_page(std::move(next), std::move(sync));
+    }
+
+    void
+    mm2_service::finish_swaps_history_sync(const swaps_history_sync& sync)
+    {
+        m_swaps_history.save();
+        if (sync.nb_changed > 0)
+        {
+            SPDLOG_INFO("swaps history synced: {} swaps new or updated, {} indexed", sync.nb_changed, m_swaps_history.size());
+            refresh_swaps_history_page(false);
+        }
+        m_swaps_sync_running = false;
+        if (m_swaps_sync_requested.exchange(false))
+        {
+            sync_swaps_history();
+        }
+    }
+
     void
     mm2_service::process_tx_tokenscan(const std::string& ticker, [[maybe_unused]] bool is_a_refresh)
     {
@@ -1308,7 +1966,7 @@ namespace atomic_dex
                         const auto& transactions = answer.result.value().transactions;
                         std::for_each(
                             rbegin(transactions), rend(transactions),
-                            [&out, this](auto&& current)
+                            [&out](auto&& current)
                             {
                                 tx_infos current_info{
                                     .am_i_sender       = current.my_balance_change[0] == '-',
@@ -1325,11 +1983,9 @@ namespace atomic_dex
                                     .block_height      = current.block_height,
                                     .ec                = dextop_error::success,
                                 };
-
-                                const auto& wallet_manager    = this->m_system_manager.get_system<qt_wallet_manager>();
-                                current_info.transaction_note = wallet_manager.retrieve_transactions_notes(current_info.tx_hash);
                                 out.push_back(std::move(current_info));
                             });
+                        attach_transactions_notes(out, this->m_system_manager.get_system<qt_wallet_manager>());
 
                         //! History
                         SPDLOG_INFO("{} tx size {}", ticker, out.size());
@@ -1358,7 +2014,7 @@ namespace atomic_dex
         if (this->m_mm2_running)
         {
             SPDLOG_INFO("process_orderbook(true)");
-            process_orderbook(true);
+            process_orderbook(true, true);
         }
     }
 
@@ -1378,19 +2034,27 @@ namespace atomic_dex
     }
 
     bool
-    mm2_service::do_i_have_enough_funds(const std::string& ticker, const t_float_50& amount) const
+    mm2_service::do_i_have_enough_funds(const std::string& ticker, const std::string& amount) const
     {
-        t_float_50 funds = get_balance(ticker);
-        return funds >= amount;
+        std::error_code   ec;
+        const std::string funds    = my_balance(ticker, ec);
+        const auto        funds_f  = t_fixed_decimal::from_string(funds);
+        const auto        amount_f = t_fixed_decimal::from_string(amount);
+        if (funds_f.has_value() && amount_f.has_value())
+        {
+            return funds_f.value() >= amount_f.value();
+        }
+        //! One of them is out of the fixed_decimal range
+        return safe_float(funds) >= safe_float(amount);
     }
 
     std::string
     mm2_service::address(const std::string& ticker, t_mm2_ec& ec) const
     {
-        std::shared_lock lock(m_balance_mutex);
-        auto             it = m_balance_informations.find(ticker);
+        const auto balances = m_balance_informations.snapshot();
+        const auto it       = balances->find(ticker);
 
-        if (it == m_balance_informations.cend())
+        if (it == balances->cend())
         {
             ec = dextop_error::unknown_ticker;
             return "Invalid";
@@ -1411,16 +2075,66 @@ namespace atomic_dex
         nlohmann::json out;
 
         std::shared_lock lock(m_raw_coin_cfg_mutex);
-        const auto       it = m_mm2_raw_coins_cfg.find(ticker);
-        if (it != m_mm2_raw_coins_cfg.end())
+        if (const auto record = m_mm2_raw_coins_cfg.get(ticker); record.has_value())
         {
-            atomic_dex::coin_element element = it->second;
+            const auto element = record->get<atomic_dex::coin_element>();
             to_json(out, element);
             return out;
         }
         return nlohmann::json::object();
     }
 
+    balance_refresh_metrics
+    mm2_service::get_balance_refresh_metrics() const
+    {
+        return m_balance_refresh_scheduler.get_metrics();
+    }
+
+    activation_pipeline_metrics
+    mm2_service::get_activation_metrics() const
+    {
+        return m_activation_pipeline.get_metrics();
+    }
+
+    decode_queue_metrics
+    mm2_service::get_decode_metrics() const
+    {
+        return m_decode_queue.get_metrics();
+    }
+
+    t_content_change_metrics
+    mm2_service::get_content_change_metrics() const
+    {
+        return m_content_changes.get_metrics();
+    }
+
+    trade_volume_cache_metrics
+    mm2_service::get_trade_volume_metrics() const
+    {
+        return m_trade_volumes.get_metrics();
+    }
+
+    nlohmann::json
+    mm2_service::get_startup_timeline() const
+    {
+        return m_startup_timeline.to_json();
+    }
+
+    void
+    mm2_service::record_startup_stage(const std::string& stage)
+    {
+        if (m_startup_timeline.record(stage, startup_timeline::t_clock::now()) && stage == "first_portfolio_render")
+        {
+            SPDLOG_INFO("startup timeline: {}", m_startup_timeline.to_json().dump());
+        }
+    }
+
+    decode_queue&
+    mm2_service::get_decode_queue()
+    {
+        return m_decode_queue;
+    }
+
     mm2_service::t_pair_max_vol
     mm2_service::get_taker_vol() const
     {
@@ -1442,10 +2156,7 @@ namespace atomic_dex
     void
     mm2_service::reset_fake_balance_to_zero(const std::string& ticker)
     {
-        {
-            std::unique_lock lock(m_balance_mutex);
-            m_balance_informations.at(ticker).balance = "0";
-        }
+        m_balance_informations.update([&ticker](t_balance_registry& balances) { balances.at(ticker).balance = "0"; });
         this->dispatcher_.trigger<ticker_balance_updated>(std::vector<std::string>{ticker});
     }
 
@@ -1463,10 +2174,8 @@ namespace atomic_dex
         }
         else
         {
-            {
-                std::unique_lock lock(m_balance_mutex); //! Write
-                m_balance_informations.at(ticker).balance = result.str(8, std::ios_base::fixed);
-            }
+            m_balance_informations.update([&ticker, &result](t_balance_registry& balances)
+                                          { balances.at(ticker).balance = result.str(8, std::ios_base::fixed); });
             this->dispatcher_.trigger<ticker_balance_updated>(std::vector<std::string>{ticker});
         }
     }
@@ -1476,6 +2185,12 @@ namespace atomic_dex
     {
         ::mm2::api::tx_history_answer answer;
         ::mm2::api::from_json(answer_json, answer);
+        process_tx_answer(answer);
+    }
+
+    void
+    mm2_service::process_tx_answer(const ::mm2::api::tx_history_answer& answer)
+    {
         t_tx_state state;
         state.state             = answer.result.value().sync_status.state;
         state.current_block     = answer.result.value().current_block;
@@ -1534,11 +2249,9 @@ namespace atomic_dex
                 current_info.unconfirmed = true;
             }
 
-            const auto& wallet_manager    = this->m_system_manager.get_system<qt_wallet_manager>();
-            current_info.transaction_note = wallet_manager.retrieve_transactions_notes(current_info.tx_hash);
-
             out.push_back(std::move(current_info));
         }
+        attach_transactions_notes(out, this->m_system_manager.get_system<qt_wallet_manager>());
 
 
         //! History
@@ -1551,25 +2264,75 @@ namespace atomic_dex
     {
         t_balance_answer answer_r;
         ::mm2::api::from_json(answer, answer_r);
-        // SPDLOG_INFO("Successfully fetched ticker: {} balance: {} address: {}", answer_r.coin, answer_r.balance, answer_r.address);
+        process_balance_answer(std::move(answer_r));
+    }
+
+    void
+    mm2_service::process_balance_answer(t_balance_answer&& answer_r)
+    {
+        std::vector<t_balance_answer> answers;
+        answers.push_back(std::move(answer_r));
+        process_balance_answers(std::move(answers));
+    }
+
+    void
+    mm2_service::process_balance_answers(std::vector<t_balance_answer> answers)
+    {
         if (is_pin_cfg_enabled())
         {
-            std::shared_lock lock(m_balance_mutex);
+            //! Fake balances are never overwritten once known
+            const auto balances = m_balance_informations.snapshot();
+            std::erase_if(answers, [&balances](const t_balance_answer& answer) { return balances->contains(answer.coin); });
+        }
+        if (answers.empty())
+        {
+            return;
+        }
 
-            if (m_balance_informations.find(answer_r.coin) != m_balance_informations.end())
+        const auto now = balance_refresh_scheduler::t_clock::now();
+        for (auto&& answer_r: answers)
+        {
+            // SPDLOG_INFO("Successfully fetched ticker: {} balance: {} address: {}", answer_r.coin, answer_r.balance, answer_r.address);
+            if (auto balance_f = t_fixed_decimal::from_string(answer_r.balance); balance_f.has_value())
             {
-                return;
+                if (m_balance_factor != 1.0)
+                {
+                    balance_f.value() *= t_fixed_decimal::from_double(m_balance_factor).value_or(1);
+                }
+                answer_r.balance = balance_f->str(8);
+            }
+            else
+            {
+                //! Out of the fixed point range
+                t_float_50 result = safe_float(answer_r.balance) * m_balance_factor;
+                answer_r.balance  = result.str(8, std::ios_base::fixed);
             }
+            m_balance_refresh_scheduler.on_balance(answer_r.coin, answer_r.balance, now);
         }
 
-        t_float_50 result = t_float_50(answer_r.balance) * m_balance_factor;
-        answer_r.balance  = result.str(8, std::ios_base::fixed);
-        // auto copy_coin = answer_r.coin;
-        {
-            std::unique_lock lock(m_balance_mutex);
-            m_balance_informations[answer_r.coin] = std::move(answer_r);
+        //! A single new version is published for the whole batch
+        std::vector<std::string> changed_tickers;
+        m_balance_informations.update(
+            [&answers, &changed_tickers](t_balance_registry& balances)
+            {
+                for (auto&& answer_r: answers)
+                {
+                    if (auto it = balances.find(answer_r.coin); it == balances.end() || it->second.balance != answer_r.balance)
+                    {
+                        changed_tickers.push_back(answer_r.coin);
+                    }
+                    balances[answer_r.coin] = std::move(answer_r);
+                }
+            });
+        //! Only the tickers whose balance moved reach the portfolio model
+        const std::size_t nb_unchanged = answers.size() - changed_tickers.size();
+        for (auto&& ticker: changed_tickers) { m_trade_volumes.invalidate(ticker); }
+        for (std::size_t idx = 0; idx < answers.size(); ++idx) { m_content_changes.record("balance", idx < nb_unchanged); }
+        record_startup_stage("first_balance");
+        if (!changed_tickers.empty())
+        {
+            this->dispatcher_.trigger<ticker_balance_updated>(std::move(changed_tickers));
         }
-        // m_system_manager.get_system<portfolio_page>().get_portfolio()->update_balance_values({copy_coin});
     }
 
     mm2_client&
@@ -1661,14 +2424,13 @@ namespace atomic_dex
     mm2_service::is_this_ticker_present_in_raw_cfg(const std::string& ticker) const
     {
         std::shared_lock lock(m_raw_coin_cfg_mutex);
-        return m_mm2_raw_coins_cfg.find(ticker) != m_mm2_raw_coins_cfg.end();
+        return m_mm2_raw_coins_cfg.contains(ticker);
     }
 
     bool
     mm2_service::is_this_ticker_present_in_normal_cfg(const std::string& ticker) const
     {
-        std::shared_lock lock(m_coin_cfg_mutex);
-        return m_coins_informations.find(ticker) != m_coins_informations.end();
+        return m_coins_informations.snapshot()->registry.contains(ticker);
     }
 
     void
@@ -1692,10 +2454,12 @@ namespace atomic_dex
             //! Read Contents
             config_json_data = nlohmann::json::parse(QString(ifs.readAll()).toStdString());
 
-            {
-                std::unique_lock lock(m_coin_cfg_mutex);
-                this->m_coins_informations.erase(ticker);
-            }
+            m_coins_informations.update(
+                [&ticker](coins_registry_data& data)
+                {
+                    data.registry.erase(ticker);
+                    data.refresh_enabled();
+                });
 
             config_json_data.erase(config_json_data.find(ticker));
 
@@ -1765,13 +2529,33 @@ namespace atomic_dex
         return m_orders_and_swaps.get();
     }
 
+    std::vector<t_order_swaps_data>
+    mm2_service::get_maker_orders() const
+    {
+        //! Copies the maker orders only instead of the whole orders and swaps registry
+        std::vector<t_order_swaps_data> out;
+        auto                            data = m_orders_and_swaps.synchronize();
+        const std::size_t               end  = std::min(data->nb_orders, data->orders_and_swaps.size());
+        for (std::size_t idx = 0; idx < end; ++idx)
+        {
+            if (data->orders_and_swaps[idx].is_maker)
+            {
+                out.push_back(data->orders_and_swaps[idx]);
+            }
+        }
+        return out;
+    }
+
     void
     mm2_service::set_orders_and_swaps_pagination_infos(std::size_t current_page, std::size_t limit, t_filtering_infos filter_infos)
     {
         {
-            m_orders_and_swaps = orders_and_swaps{.current_page = current_page, .limit = limit, .filtering_infos = std::move(filter_infos)};
+            auto value_ptr             = m_orders_and_swaps.synchronize();
+            value_ptr->current_page    = current_page;
+            value_ptr->limit           = limit;
+            value_ptr->filtering_infos = std::move(filter_infos);
         }
-        this->batch_fetch_orders_and_swap(true);
+        this->refresh_swaps_history_page(true);
     }
 
     void
@@ -1810,6 +2594,6 @@ namespace atomic_dex
     void
     mm2_service::change_segwit_status(std::string ticker, bool status)
     {
-        update_coin_status(this->m_current_wallet_name, {ticker}, status, m_coins_informations, m_coin_cfg_mutex, "is_segwit_on");
+        update_coin_status(this->m_current_wallet_name, {ticker}, status, m_coins_informations, "is_segwit_on");
     }
 } // namespace atomic_dex
@@ -39,13 +39,22 @@
 #include "atomicdex/api/mm2/rpc.max.taker.vol.hpp"
 #include "atomicdex/api/mm2/rpc.min.volume.hpp"
 #include "atomicdex/api/mm2/rpc.orderbook.hpp"
+#include "atomicdex/api/mm2/rpc.tx.history.hpp"
 #include "atomicdex/config/coins.cfg.hpp"
 #include "atomicdex/config/raw.mm2.coins.cfg.hpp"
 #include "atomicdex/constants/dex.constants.hpp"
 #include "atomicdex/data/dex/orders.and.swaps.data.hpp"
 #include "atomicdex/data/wallet/tx.data.hpp"
 #include "atomicdex/events/events.hpp"
+#include "atomicdex/services/mm2/mm2.activation.pipeline.hpp"
+#include "atomicdex/services/mm2/mm2.balance.refresh.scheduler.hpp"
+#include "atomicdex/services/mm2/mm2.decode.queue.hpp"
+#include "atomicdex/services/mm2/mm2.startup.pipeline.hpp"
+#include "atomicdex/services/mm2/mm2.swaps.history.index.hpp"
+#include "atomicdex/services/mm2/mm2.trade.evaluation.engine.hpp"
+#include "atomicdex/utilities/content.hash.hpp"
 #include "atomicdex/utilities/global.utilities.hpp"
+#include "atomicdex/utilities/rcu.registry.hpp"
 
 namespace atomic_dex
 {
@@ -59,8 +68,20 @@ namespace atomic_dex
     using t_coins_registry = std::unordered_map<t_ticker, coin_config>;
     using t_coins          = std::vector<coin_config>;
 
+    //! One immutable version of the coins configuration, `enabled` mirrors the registry and is rebuilt by refresh_enabled after every edit.
+    struct coins_registry_data
+    {
+        t_coins_registry registry;
+        t_coins          enabled{};
+
+        void refresh_enabled();
+    };
+
+    using t_coins_rcu_registry = rcu_registry<coins_registry_data>;
+
     //! Constants
     inline constexpr const std::size_t g_tx_max_limit{50};
+    inline constexpr const std::size_t g_swaps_history_sync_limit{100}; ///< swaps per my_recent_swaps request of the swaps history sync
 
     class ENTT_API mm2_service final : public ag::ecs::pre_update_system<mm2_service>
     {
@@ -72,6 +93,7 @@ namespace atomic_dex
         //! Private typedefs
         using t_mm2_time_point             = std::chrono::high_resolution_clock::time_point;
         using t_balance_registry           = std::unordered_map<t_ticker, t_balance_answer>;
+        using t_balance_rcu_registry       = rcu_registry<t_balance_registry>;
         using t_tx_registry                = t_shared_synchronized_value<std::unordered_map<t_ticker, std::pair<t_transactions, t_tx_state>>>;
         using t_orderbook                  = boost::synchronized_value<t_orderbook_answer>;
         using t_orders_and_swaps           = boost::synchronized_value<orders_and_swaps>;
@@ -101,41 +123,102 @@ namespace atomic_dex
         //! Timers
         t_mm2_time_point m_orderbook_clock;
         t_mm2_time_point m_info_clock;
+        t_mm2_time_point m_balance_clock;
 
         //! Atomicity / Threads
         std::atomic_bool m_mm2_running{false};
         std::atomic_bool m_orderbook_thread_active{false};
+        std::atomic_bool m_mm2_init_cancelled{false};
         std::thread      m_mm2_init_thread;
 
+        //! Milestones of the current login, logged as json once the portfolio shows the first balances
+        startup_timeline m_startup_timeline;
+
         //! Current wallet name
         std::string m_current_wallet_name;
 
         //! Mutex
-        mutable std::shared_mutex m_balance_mutex;
-        mutable std::shared_mutex m_coin_cfg_mutex;
         mutable std::shared_mutex m_raw_coin_cfg_mutex;
 
-        //! Concurrent Registry.
-        t_coins_registry&        m_coins_informations{entity_registry_.set<t_coins_registry>()};
-        t_balance_registry       m_balance_informations;
-        t_tx_registry            m_tx_informations;
-        t_orderbook              m_orderbook{t_orderbook_answer{}};
-        t_orders_and_swaps       m_orders_and_swaps{orders_and_swaps{}};
-        t_mm2_raw_coins_registry m_mm2_raw_coins_cfg{parse_raw_mm2_coins_file()};
+        //! Concurrent Registry, balances and coins are read without locking through immutable snapshots.
+        t_coins_rcu_registry   m_coins_informations;
+        t_balance_rcu_registry m_balance_informations;
+        t_tx_registry          m_tx_informations;
+        t_orderbook            m_orderbook{t_orderbook_answer{}};
+        t_orders_and_swaps     m_orders_and_swaps{orders_and_swaps{}};
+        coins_cfg_snapshot     m_mm2_raw_coins_cfg{open_raw_mm2_coins_snapshot()}; ///< mapped, a coin is only decoded when asked for
 
         //! Balance factor
         double m_balance_factor{1.0};
 
-        //! Refresh the orderbook registry (internal)
-        nlohmann::json prepare_batch_orderbook(bool is_a_reset);
+        //! Incremental balance refresh
+        balance_refresh_scheduler m_balance_refresh_scheduler;
+
+        //! Coin activation, bounded number of enable requests in flight
+        coin_activation_pipeline m_activation_pipeline;
+        std::atomic_bool         m_default_coins_enabled{false}; ///< default_coins_enabled is triggered once per session
+
+        //! Answers of the periodic batches are decoded and applied here instead of on the cpprestsdk threads
+        decode_queue m_decode_queue{decode_queue_cfg{}};
+
+        //! Swaps history kept on disk, the history pages and filters of the orders page are served from it.
+        //! mm2 is only asked for the swaps that are new or still running, when the active swaps change.
+        swaps_history_index                                        m_swaps_history;
+        boost::synchronized_value<std::unordered_set<std::string>> m_active_swaps_uuids;
+        std::atomic_bool                                           m_swaps_sync_needed{true};
+        std::atomic_bool                                           m_swaps_sync_running{false};
+        std::atomic_bool                                           m_swaps_sync_requested{false};
+
+        //! Hashes of the last periodic answers and balances, an answer identical to the previous one is neither decoded nor notified
+        content_change_detector m_content_changes;
+
+        //! max_taker_vol / min_trading_vol answers of the recent pairs, dropped when the balance of the coin moves
+        trade_volume_cache m_trade_volumes;
+
+        //! Refresh the orderbook registry (internal), the volumes are only requested if `with_volumes`
+        nlohmann::json prepare_batch_orderbook(bool with_volumes);
 
         //! Batch balance / tx
         std::tuple<nlohmann::json, std::vector<std::string>, std::vector<std::string>> prepare_batch_balance_and_tx(bool only_tx = false) const;
         auto batch_balance_and_tx(bool is_a_reset, std::vector<std::string> tickers = {}, bool is_during_enabling = false, bool only_tx = false);
         void process_balance_answer(const nlohmann::json& answer);
+        void process_balance_answer(t_balance_answer&& answer_r);
+        void process_balance_answers(std::vector<t_balance_answer> answers);
         void process_tx_answer(const nlohmann::json& answer_json);
+        void process_tx_answer(const ::mm2::api::tx_history_answer& answer);
         void process_tx_tokenscan(const std::string& ticker, bool is_a_refresh);
         void fetch_single_balance(const coin_config& cfg_infos);
+        void set_currently_enabled(const std::vector<std::string>& tickers, bool status);
+        bool request_disable_coin(const std::string& ticker, std::error_code& ec); ///< disable rpc only, the registry is left to the caller
+        void process_due_balances();
+        void refresh_balances(std::vector<std::string> tickers, refresh_tier tier);
+
+        //! Activation pipeline callbacks
+        void enable_default_coins_batch();
+        void on_default_coin_enabled();
+        void launch_coin_activation(const coin_activation_pipeline::job& job);
+        void on_coin_activation_done(const std::string& ticker, activation_status status, const std::string& error);
+        void on_coins_activated(std::vector<std::string> tickers);
+
+        //! Swaps history
+        struct swaps_history_sync
+        {
+            std::unordered_set<std::string> waiting;              ///< running swaps that left the active swaps, fetched until seen
+            bool                            reached_known{false}; ///< a finished swap already indexed was seen
+            bool                            jumped_to_tail{false};
+            std::size_t                     nb_changed{0};
+        };
+
+        void sync_swaps_history();
+        void fetch_swaps_history_page(std::optional<std::string> from_uuid, std::shared_ptr<swaps_history_sync> sync);
+        void process_swaps_history_page(const nlohmann::json& swaps, std::shared_ptr<swaps_history_sync> sync);
+        void finish_swaps_history_sync(const swaps_history_sync& sync);
+        void append_swaps_history_page(orders_and_swaps& result, const std::unordered_set<std::string>& active_uuids) const;
+
+        //! Change detection, the fiat amounts of an answer depend on the rates it was decoded with
+        [[nodiscard]] t_content_hash answer_hash(const std::string& body) const;
+        void                         touch_unchanged_balances(const nlohmann::json& batch);
+        void refresh_swaps_history_page(bool after_manual_reset);
 
         //!
         std::pair<bool, std::string>                        process_batch_enable_answer(const nlohmann::json& answer);
@@ -168,7 +251,7 @@ namespace atomic_dex
         //! Spawn mm2 instance with given seed
         void spawn_mm2_instance(std::string wallet_name, std::string passphrase, bool with_pin_cfg = false);
 
-        //! Refresh the current info (internally call process_balance and process_tx)
+        //! Refresh the current info (internally call process_balance and process_tx), the balance of every enabled coin is fetched unless only_tx
         void fetch_infos_thread(bool is_a_fresh = true, bool only_tx = false);
 
         //! Enable coins
@@ -207,7 +290,8 @@ namespace atomic_dex
         //! Refresh the current orderbook (internally call process_orderbook)
         void fetch_current_orderbook_thread(bool is_a_reset = false);
 
-        void process_orderbook(bool is_a_reset = false);
+        //! A reset also refreshes the volumes of the pair, `reuse_volumes` serves them from the cache when they are all fresh.
+        void process_orderbook(bool is_a_reset = false, bool reuse_volumes = false);
 
         //! Last 50 transactions maximum
         [[nodiscard]] t_transactions get_tx_history(t_mm2_ec& ec) const;
@@ -218,6 +302,9 @@ namespace atomic_dex
         //! Get coins that are currently enabled
         [[nodiscard]] t_coins get_enabled_coins() const;
 
+        //! Same as get_enabled_coins without copying the configurations, the view stays valid while held.
+        [[nodiscard]] std::shared_ptr<const t_coins> get_enabled_coins_view() const;
+
         //! Get coins that are active, but may be not enabled
         [[nodiscard]] t_coins get_active_coins() const;
 
@@ -228,18 +315,29 @@ namespace atomic_dex
         [[nodiscard]] t_orderbook_answer get_orderbook(t_mm2_ec& ec) const;
 
         //! Get Swaps
-        [[nodiscard]] orders_and_swaps get_orders_and_swaps() const;
+        [[nodiscard]] orders_and_swaps                get_orders_and_swaps() const;
+        [[nodiscard]] std::vector<t_order_swaps_data> get_maker_orders() const;
 
         //! Get balance with locked funds for a given ticker as a boost::multiprecision::cpp_dec_float_50.
         [[nodiscard]] t_float_50 get_balance(const std::string& ticker) const;
 
-        //! Return true if we the balance of the `ticker` > amount, false otherwise.
-        [[nodiscard]] bool do_i_have_enough_funds(const std::string& ticker, const t_float_50& amount) const;
+        //! Return true if we the balance of the `ticker` > amount, false otherwise. Compared as t_float_50 when out of the fixed_decimal range.
+        [[nodiscard]] bool do_i_have_enough_funds(const std::string& ticker, const std::string& amount) const;
 
         [[nodiscard]] bool is_orderbook_thread_active() const;
 
         [[nodiscard]] nlohmann::json get_raw_mm2_ticker_cfg(const std::string& ticker) const;
 
+        [[nodiscard]] balance_refresh_metrics     get_balance_refresh_metrics() const;
+        [[nodiscard]] activation_pipeline_metrics get_activation_metrics() const;
+        [[nodiscard]] decode_queue_metrics        get_decode_metrics() const;
+        [[nodiscard]] t_content_change_metrics    get_content_change_metrics() const;
+        [[nodiscard]] trade_volume_cache_metrics  get_trade_volume_metrics() const;
+        [[nodiscard]] nlohmann::json              get_startup_timeline() const;
+
+        //! Records a milestone of the current login (ex: first_portfolio_render), only its first occurrence is kept
+        void record_startup_stage(const std::string& stage);
+
         [[nodiscard]] t_pair_max_vol get_taker_vol() const;
         [[nodiscard]] t_pair_min_vol get_min_vol() const;
 
@@ -251,14 +349,15 @@ namespace atomic_dex
         void               add_orders_answer(t_my_orders_answer answer);
 
         //! Async API
-        mm2_client& get_mm2_client();
+        mm2_client&   get_mm2_client();
+        decode_queue& get_decode_queue();
         //[[nodiscard]] pplx::cancellation_token get_cancellation_token() const;
 
         //! Wallet api
         [[nodiscard]] std::string get_current_ticker() const;
         bool                      set_current_ticker(const std::string& ticker);
 
-        //! Pagination
+        //! Pagination, served from the swaps history without asking mm2
         void set_orders_and_swaps_pagination_infos(std::size_t current_page = 1, std::size_t limit = 50, t_filtering_infos infos = {});
 
         void change_segwit_status(std::string ticker, bool status);
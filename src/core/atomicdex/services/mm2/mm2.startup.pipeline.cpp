@@ -0,0 +1,150 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+#include <thread>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.startup.pipeline.hpp"
+
+namespace
+{
+    std::chrono::milliseconds
+    since(atomic_dex::startup_timeline::t_time_point start, atomic_dex::startup_timeline::t_time_point now)
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(now - start);
+    }
+} // namespace
+
+namespace atomic_dex
+{
+    std::chrono::milliseconds
+    mm2_readiness_backoff(const mm2_readiness_cfg& cfg, std::size_t nb_failed_probes) noexcept
+    {
+        std::chrono::milliseconds delay = cfg.initial_delay;
+        for (std::size_t idx = 1; idx < nb_failed_probes && delay < cfg.max_delay; ++idx) { delay *= 2; }
+        return std::min(delay, cfg.max_delay);
+    }
+
+    mm2_readiness_result
+    wait_for_mm2_readiness(const mm2_readiness_cfg& cfg, const t_mm2_probe& probe, const std::atomic_bool& cancelled)
+    {
+        using t_clock = std::chrono::steady_clock;
+
+        mm2_readiness_result result;
+        const auto           start    = t_clock::now();
+        const auto           deadline = start + cfg.timeout;
+        while (!cancelled)
+        {
+            result.nb_probes += 1;
+            try
+            {
+                result.ready = probe(cfg.probe_timeout);
+                if (!result.ready)
+                {
+                    result.error = "mm2 rpc is not answering";
+                }
+            }
+            catch (const std::exception& error)
+            {
+                result.error = error.what();
+            }
+            const auto now = t_clock::now();
+            result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start);
+            if (result.ready)
+            {
+                result.error.clear();
+                return result;
+            }
+            if (now >= deadline)
+            {
+                result.error = "mm2 did not answer after " + std::to_string(result.elapsed.count()) + "ms (" + std::to_string(result.nb_probes) +
+                               " probes), last error: " + result.error;
+                return result;
+            }
+            std::this_thread::sleep_for(std::min<t_clock::duration>(mm2_readiness_backoff(cfg, result.nb_probes), deadline - now));
+        }
+        result.cancelled = true;
+        result.error     = "mm2 startup cancelled";
+        return result;
+    }
+
+    void
+    startup_timeline::start(t_time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        m_started = true;
+        m_start   = now;
+        m_stages.clear();
+        m_error.clear();
+    }
+
+    bool
+    startup_timeline::record_locked(const std::string& stage, t_time_point now)
+    {
+        if (!m_started || std::any_of(m_stages.begin(), m_stages.end(), [&stage](const auto& cur) { return cur.first == stage; }))
+        {
+            return false;
+        }
+        m_stages.emplace_back(stage, since(m_start, now));
+        return true;
+    }
+
+    bool
+    startup_timeline::record(const std::string& stage, t_time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        return record_locked(stage, now);
+    }
+
+    void
+    startup_timeline::fail(std::string error, t_time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        if (record_locked("failed", now))
+        {
+            m_error = std::move(error);
+        }
+    }
+
+    bool
+    startup_timeline::has_stage(const std::string& stage) const
+    {
+        std::scoped_lock lock(m_mutex);
+        return std::any_of(m_stages.begin(), m_stages.end(), [&stage](const auto& cur) { return cur.first == stage; });
+    }
+
+    startup_timeline::t_stages
+    startup_timeline::get_stages() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_stages;
+    }
+
+    nlohmann::json
+    startup_timeline::to_json() const
+    {
+        std::scoped_lock lock(m_mutex);
+        nlohmann::json   out = {{"stages", nlohmann::json::array()}};
+        for (auto&& [stage, elapsed]: m_stages) { out["stages"].push_back({{"stage", stage}, {"elapsed_ms", elapsed.count()}}); }
+        if (!m_error.empty())
+        {
+            out["error"] = m_error;
+        }
+        return out;
+    }
+} // namespace atomic_dex
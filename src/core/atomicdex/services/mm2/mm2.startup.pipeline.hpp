@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+//! Deps
+#include <nlohmann/json.hpp>
+
+namespace atomic_dex
+{
+    struct mm2_readiness_cfg
+    {
+        std::chrono::milliseconds initial_delay{10}; ///< between the first two probes, doubled after every failed probe
+        std::chrono::milliseconds max_delay{250};
+        std::chrono::milliseconds probe_timeout{1000}; ///< of a single version rpc
+        std::chrono::milliseconds timeout{30000};      ///< mm2 is reported as failed past this delay
+    };
+
+    struct mm2_readiness_result
+    {
+        bool                      ready{false};
+        bool                      cancelled{false};
+        std::size_t               nb_probes{0};
+        std::chrono::milliseconds elapsed{0};
+        std::string               error; ///< reason of the failure when not ready
+    };
+
+    //! Answers true once mm2 answered, may throw.
+    using t_mm2_probe = std::function<bool(std::chrono::milliseconds probe_timeout)>;
+
+    //! Wait before the probe following `nb_failed_probes` failed ones.
+    [[nodiscard]] std::chrono::milliseconds mm2_readiness_backoff(const mm2_readiness_cfg& cfg, std::size_t nb_failed_probes) noexcept;
+
+    //! Probes mm2 with an exponential backoff until it answers, the timeout elapses or `cancelled` is set.
+    [[nodiscard]] mm2_readiness_result wait_for_mm2_readiness(const mm2_readiness_cfg& cfg, const t_mm2_probe& probe, const std::atomic_bool& cancelled);
+
+    //! Milestones of a login, relative to its start, in order.
+    //! Stages recorded by the application: mm2_spawned, coins_cfg_parsed, mm2_ready, default_coins_enabled, first_balance, first_portfolio_render.
+    //! Thread safe, only the first occurrence of a stage is kept.
+    class startup_timeline
+    {
+      public:
+        using t_clock      = std::chrono::steady_clock;
+        using t_time_point = t_clock::time_point;
+        using t_stages     = std::vector<std::pair<std::string, std::chrono::milliseconds>>;
+
+        //! Starts a new timeline, the previous stages and error are dropped.
+        void start(t_time_point now);
+
+        //! Returns false if the stage is already known or the timeline is not started.
+        bool record(const std::string& stage, t_time_point now);
+
+        //! Records the `failed` stage with the reason of the failure.
+        void fail(std::string error, t_time_point now);
+
+        [[nodiscard]] bool           has_stage(const std::string& stage) const;
+        [[nodiscard]] t_stages       get_stages() const;
+        [[nodiscard]] nlohmann::json to_json() const; ///< {"stages": [{"stage": "mm2_spawned", "elapsed_ms": 12}, ...], "error": "..."}
+
+      private:
+        bool record_locked(const std::string& stage, t_time_point now);
+
+        mutable std::mutex m_mutex;
+        bool               m_started{false};
+        t_time_point       m_start;
+        t_stages           m_stages;
+        std::string        m_error;
+    };
+} // namespace atomic_dex
@@ -0,0 +1,692 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+#include <cstring>
+
+//! Deps
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <nlohmann/json.hpp>
+
+//! Project Headers
+#include "atomicdex/api/mm2/mm2.swap.status.hpp"
+#include "atomicdex/services/mm2/mm2.swaps.history.index.hpp"
+#include "atomicdex/utilities/log.prerequisites.hpp"
+
+namespace
+{
+    constexpr std::uint32_t g_index_magic = 0x48584441; ///< "ADXH"
+    constexpr std::uint32_t g_complete    = 1;          ///< header flag
+
+    //! The data file is rewritten with the live records once the replaced ones take more than half of it.
+    constexpr std::uint64_t g_compaction_min_size = 1024 * 1024;
+
+    struct index_header
+    {
+        std::uint32_t magic{g_index_magic};
+        std::uint32_t version{atomic_dex::swaps_history_index::g_version};
+        std::uint32_t flags{0};
+        std::uint32_t count{0};
+    };
+
+    //! Followed by the uuid, base coin, rel coin and status characters.
+    struct index_record
+    {
+        std::uint64_t started_at;
+        std::uint64_t offset;
+        std::uint32_t size;
+        std::uint32_t revision;
+        std::uint16_t uuid_size;
+        std::uint16_t base_size;
+        std::uint16_t rel_size;
+        std::uint16_t status_size;
+    };
+
+    static_assert(sizeof(index_header) == 16);
+    static_assert(sizeof(index_record) == 32);
+
+    //! Seconds, from the Started event like mm2 does, the first event for the swaps that did not start.
+    std::uint64_t
+    swap_started_at(const nlohmann::json& swap)
+    {
+        const auto& events = swap.at("events");
+        for (auto&& cur: events)
+        {
+            const auto& evt = cur.at("event");
+            if (evt.at("type") == "Started" && evt.contains("data") && evt.at("data").contains("started_at"))
+            {
+                return evt.at("data").at("started_at").get<std::uint64_t>();
+            }
+        }
+        return events.empty() ? 0 : events.front().at("timestamp").get<std::uint64_t>() / 1000;
+    }
+} // namespace
+
+namespace atomic_dex
+{
+    bool
+    swaps_history_index::open(const fs::path& folder, const std::string& name)
+    {
+        std::unique_lock lock(m_mutex);
+        m_index_path = folder / (name + ".swaps.idx");
+        m_data_path  = folder / (name + ".swaps.jsonl");
+        m_entries.clear();
+        m_by_uuid.clear();
+        m_by_time.clear();
+        m_by_base_coin.clear();
+        m_by_rel_coin.clear();
+        m_by_pair.clear();
+        m_by_status.clear();
+        m_is_complete = false;
+        m_is_dirty    = false;
+
+        const bool loaded = load_index();
+        auto       mode   = std::ios::out | std::ios::binary | (loaded ? std::ios::app : std::ios::trunc);
+        m_data_ofs.close();
+        m_data_ofs.open(m_data_path.string(), mode);
+        if (!m_data_ofs.is_open())
+        {
+            SPDLOG_ERROR("Unable to open the swaps history {}", m_data_path.string());
+            m_is_open = false;
+            return false;
+        }
+        fs_error_code ec;
+        m_data_size = loaded ? fs::file_size(m_data_path, ec) : 0;
+        m_is_open   = true;
+        SPDLOG_INFO("swaps history index opened: {} swaps, complete: {}", m_entries.size(), m_is_complete);
+        return true;
+    }
+
+    bool
+    swaps_history_index::load_index()
+    {
+        namespace bip = boost::interprocess;
+
+        fs_error_code ec;
+        const auto    index_size = fs::file_size(m_index_path, ec);
+        if (ec || index_size < sizeof(index_header))
+        {
+            return false;
+        }
+        const auto data_size = fs::file_size(m_data_path, ec);
+        if (ec)
+        {
+            return false;
+        }
+
+        try
+        {
+            bip::file_mapping  mapping(m_index_path.string().c_str(), bip::read_only);
+            bip::mapped_region region(mapping, bip::read_only);
+            const auto*        data = static_cast<const char*>(region.get_address());
+            const std::size_t  size = region.get_size();
+
+            index_header header;
+            std::memcpy(&header, data, sizeof(header));
+            if (header.magic != g_index_magic || header.version != g_version)
+            {
+                return false;
+            }
+            m_is_complete = (header.flags & g_complete) != 0;
+
+            std::size_t pos = sizeof(header);
+            m_entries.reserve(header.count);
+            for (std::uint32_t idx = 0; idx < header.count && pos + sizeof(index_record) <= size; ++idx)
+            {
+                index_record record;
+                std::memcpy(&record, data + pos, sizeof(record));
+                pos += sizeof(record);
+                const std::size_t strings_size = std::size_t{record.uuid_size} + record.base_size + record.rel_size + record.status_size;
+                if (pos + strings_size > size)
+                {
+                    break;
+                }
+
+                swaps_index_entry entry{
+                    .started_at = record.started_at, .revision = record.revision, .offset = record.offset, .size = record.size};
+                entry.uuid.assign(data + pos, record.uuid_size);
+                pos += record.uuid_size;
+                entry.base_coin.assign(data + pos, record.base_size);
+                pos += record.base_size;
+                entry.rel_coin.assign(data + pos, record.rel_size);
+                pos += record.rel_size;
+                entry.status.assign(data + pos, record.status_size);
+                pos += record.status_size;
+
+                //! Appended after the data file was last flushed, the swap is fetched again.
+                if (entry.offset + entry.size > data_size || m_by_uuid.contains(entry.uuid))
+                {
+                    m_is_complete = false;
+                    continue;
+                }
+                m_by_uuid.emplace(entry.uuid, static_cast<std::uint32_t>(m_entries.size()));
+                m_entries.push_back(std::move(entry));
+            }
+            index_all();
+            return true;
+        }
+        catch (const bip::interprocess_exception& error)
+        {
+            SPDLOG_WARN("Unable to map swaps history index {}: {}", m_index_path.string(), error.what());
+            m_entries.clear();
+            m_by_uuid.clear();
+            return false;
+        }
+    }
+
+    void
+    swaps_history_index::close()
+    {
+        save();
+        std::unique_lock lock(m_mutex);
+        m_data_ofs.close();
+        m_is_open = false;
+    }
+
+    bool
+    swaps_history_index::save()
+    {
+        std::unique_lock lock(m_mutex);
+        if (!m_is_open || !m_is_dirty)
+        {
+            return m_is_open;
+        }
+
+        m_data_ofs.flush();
+        std::uint64_t live_size = 0;
+        for (auto&& entry: m_entries) { live_size += entry.size + 1; }
+        if (m_data_size > g_compaction_min_size && m_data_size > 2 * live_size)
+        {
+            compact();
+        }
+
+        std::string out;
+        out.reserve(sizeof(index_header) + m_entries.size() * (sizeof(index_record) + 64));
+        const index_header header{.flags = m_is_complete ? g_complete : 0, .count = static_cast<std::uint32_t>(m_entries.size())};
+        out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (auto&& entry: m_entries)
+        {
+            const index_record record{
+                .started_at  = entry.started_at,
+                .offset      = entry.offset,
+                .size        = entry.size,
+                .revision    = entry.revision,
+                .uuid_size   = static_cast<std::uint16_t>(entry.uuid.size()),
+                .base_size   = static_cast<std::uint16_t>(entry.base_coin.size()),
+                .rel_size    = static_cast<std::uint16_t>(entry.rel_coin.size()),
+                .status_size = static_cast<std::uint16_t>(entry.status.size())};
+            out.append(reinterpret_cast<const char*>(&record), sizeof(record));
+            out.append(entry.uuid);
+            out.append(entry.base_coin);
+            out.append(entry.rel_coin);
+            out.append(entry.status);
+        }
+
+        fs::path tmp_path = m_index_path;
+        tmp_path += ".tmp";
+        {
+            std::ofstream ofs(tmp_path.string(), std::ios::out | std::ios::trunc | std::ios::binary);
+            ofs.write(out.data(), static_cast<std::streamsize>(out.size()));
+            if (!ofs.good())
+            {
+                SPDLOG_ERROR("Unable to write swaps history index {}", tmp_path.string());
+                return false;
+            }
+        }
+        fs_error_code ec;
+        fs::rename(tmp_path, m_index_path, ec);
+        if (ec)
+        {
+            SPDLOG_ERROR("Unable to replace swaps history index {}: {}", m_index_path.string(), ec.message());
+            return false;
+        }
+        m_is_dirty = false;
+        return true;
+    }
+
+    bool
+    swaps_history_index::compact()
+    {
+        fs::path tmp_path = m_data_path;
+        tmp_path += ".tmp";
+        std::vector<std::uint64_t> offsets;
+        std::uint64_t              offset = 0;
+        offsets.reserve(m_entries.size());
+        {
+            //! Both streams are closed before the rename, an open handle makes it fail on Windows.
+            std::ifstream ifs(m_data_path.string(), std::ios::in | std::ios::binary);
+            std::ofstream ofs(tmp_path.string(), std::ios::out | std::ios::trunc | std::ios::binary);
+            std::string   record;
+            for (auto&& entry: m_entries)
+            {
+                record.resize(entry.size);
+                ifs.seekg(static_cast<std::streamoff>(entry.offset));
+                ifs.read(record.data(), static_cast<std::streamsize>(entry.size));
+                ofs.write(record.data(), static_cast<std::streamsize>(entry.size));
+                ofs.put('\n');
+                offsets.push_back(offset);
+                offset += entry.size + 1;
+            }
+            ofs.flush();
+            if (!ifs.good() || !ofs.good())
+            {
+                SPDLOG_WARN("Unable to compact the swaps history {}", m_data_path.string());
+                ifs.close();
+                ofs.close();
+                fs_error_code ec;
+                fs::remove(tmp_path, ec);
+                return false;
+            }
+        }
+        m_data_ofs.close();
+
+        fs_error_code ec;
+        fs::rename(tmp_path, m_data_path, ec);
+        if (!ec)
+        {
+            for (std::size_t idx = 0; idx < m_entries.size(); ++idx) { m_entries[idx].offset = offsets[idx]; }
+            SPDLOG_INFO("swaps history compacted from {} to {} bytes", m_data_size, offset);
+            m_data_size = offset;
+        }
+        m_data_ofs.open(m_data_path.string(), std::ios::out | std::ios::binary | std::ios::app);
+        return !ec;
+    }
+
+    swaps_index_upsert
+    swaps_history_index::upsert(const nlohmann::json& swap)
+    {
+        if (!swap.is_object() || !swap.contains("uuid") || !swap.contains("events"))
+        {
+            return swaps_index_upsert::invalid;
+        }
+
+        swaps_index_entry fresh;
+        try
+        {
+            const bool is_maker = boost::algorithm::to_lower_copy(swap.at("type").get<std::string>()) == "maker";
+            fresh.uuid          = swap.at("uuid").get<std::string>();
+            fresh.base_coin     = swap.at(is_maker ? "maker_coin" : "taker_coin").get<std::string>();
+            fresh.rel_coin      = swap.at(is_maker ? "taker_coin" : "maker_coin").get<std::string>();
+            fresh.status        = ::mm2::api::determine_swap_status(swap);
+            fresh.started_at    = swap_started_at(swap);
+            fresh.revision      = static_cast<std::uint32_t>(swap.at("events").size());
+        }
+        catch (const nlohmann::json::exception& error)
+        {
+            SPDLOG_WARN("swap skipped from the history index: {}", error.what());
+            return swaps_index_upsert::invalid;
+        }
+
+        std::unique_lock lock(m_mutex);
+        if (!m_is_open)
+        {
+            return swaps_index_upsert::invalid;
+        }
+
+        const auto it = m_by_uuid.find(fresh.uuid);
+        if (it != m_by_uuid.end())
+        {
+            const auto& current = m_entries[it->second];
+            if (current.revision == fresh.revision && current.status == fresh.status)
+            {
+                return swaps_index_upsert::unchanged;
+            }
+        }
+
+        const std::string record = swap.dump();
+        m_data_ofs.write(record.data(), static_cast<std::streamsize>(record.size()));
+        m_data_ofs.put('\n');
+        m_data_ofs.flush();
+        if (!m_data_ofs.good())
+        {
+            SPDLOG_ERROR("Unable to append to the swaps history {}", m_data_path.string());
+            return swaps_index_upsert::invalid;
+        }
+        fresh.offset = m_data_size;
+        fresh.size   = static_cast<std::uint32_t>(record.size());
+        m_data_size += record.size() + 1;
+        m_is_dirty = true;
+
+        if (it != m_by_uuid.end())
+        {
+            unindex_entry(it->second);
+            m_entries[it->second] = std::move(fresh);
+            index_entry(it->second);
+            return swaps_index_upsert::updated;
+        }
+
+        const auto entry_idx = static_cast<std::uint32_t>(m_entries.size());
+        m_by_uuid.emplace(fresh.uuid, entry_idx);
+        m_entries.push_back(std::move(fresh));
+        index_entry(entry_idx);
+        return swaps_index_upsert::inserted;
+    }
+
+    bool
+    swaps_history_index::is_before(const order_key& lhs, const order_key& rhs) const
+    {
+        //! Most recent first, the last indexed swap first between swaps started during the same second.
+        return lhs.started_at != rhs.started_at ? lhs.started_at > rhs.started_at : lhs.entry > rhs.entry;
+    }
+
+    std::string
+    swaps_history_index::pair_key(const std::string& base, const std::string& rel)
+    {
+        return base + "/" + rel;
+    }
+
+    void
+    swaps_history_index::index_entry(std::uint32_t entry_idx)
+    {
+        const auto&     entry = m_entries[entry_idx];
+        const order_key key{.started_at = entry.started_at, .entry = entry_idx};
+        const auto      insert = [this, &key](t_postings& postings)
+        {
+            const auto pos = std::lower_bound(
+                postings.begin(), postings.end(), key, [this](const order_key& lhs, const order_key& rhs) { return is_before(lhs, rhs); });
+            postings.insert(pos, key);
+        };
+        insert(m_by_time);
+        insert(m_by_base_coin[entry.base_coin]);
+        insert(m_by_rel_coin[entry.rel_coin]);
+        insert(m_by_pair[pair_key(entry.base_coin, entry.rel_coin)]);
+        insert(m_by_status[entry.status]);
+    }
+
+    void
+    swaps_history_index::index_all()
+    {
+        for (std::uint32_t entry_idx = 0; entry_idx < m_entries.size(); ++entry_idx)
+        {
+            const auto&     entry = m_entries[entry_idx];
+            const order_key key{.started_at = entry.started_at, .entry = entry_idx};
+            m_by_time.push_back(key);
+            m_by_base_coin[entry.base_coin].push_back(key);
+            m_by_rel_coin[entry.rel_coin].push_back(key);
+            m_by_pair[pair_key(entry.base_coin, entry.rel_coin)].push_back(key);
+            m_by_status[entry.status].push_back(key);
+        }
+
+        const auto sort = [this](t_postings& postings)
+        { std::sort(postings.begin(), postings.end(), [this](const order_key& lhs, const order_key& rhs) { return is_before(lhs, rhs); }); };
+        sort(m_by_time);
+        for (auto* registry: {&m_by_base_coin, &m_by_rel_coin, &m_by_pair, &m_by_status})
+        {
+            for (auto&& [key, postings]: *registry) { sort(postings); }
+        }
+    }
+
+    void
+    swaps_history_index::unindex_entry(std::uint32_t entry_idx)
+    {
+        const auto&     entry = m_entries[entry_idx];
+        const order_key key{.started_at = entry.started_at, .entry = entry_idx};
+        const auto      erase = [this, &key](t_postings& postings)
+        {
+            const auto pos = std::lower_bound(
+                postings.begin(), postings.end(), key, [this](const order_key& lhs, const order_key& rhs) { return is_before(lhs, rhs); });
+            if (pos != postings.end() && pos->entry == key.entry)
+            {
+                postings.erase(pos);
+            }
+        };
+        erase(m_by_time);
+        erase(m_by_base_coin[entry.base_coin]);
+        erase(m_by_rel_coin[entry.rel_coin]);
+        erase(m_by_pair[pair_key(entry.base_coin, entry.rel_coin)]);
+        erase(m_by_status[entry.status]);
+    }
+
+    const swaps_history_index::t_postings&
+    swaps_history_index::select_postings(const swaps_index_query& query) const
+    {
+        static const t_postings empty;
+        const auto              find = [](const std::unordered_map<std::string, t_postings>& registry, const std::string& key) -> const t_postings&
+        {
+            const auto it = registry.find(key);
+            return it != registry.end() ? it->second : empty;
+        };
+
+        if (query.my_coin && query.other_coin)
+        {
+            return find(m_by_pair, pair_key(*query.my_coin, *query.other_coin));
+        }
+        if (query.my_coin)
+        {
+            return find(m_by_base_coin, *query.my_coin);
+        }
+        if (query.other_coin)
+        {
+            return find(m_by_rel_coin, *query.other_coin);
+        }
+        if (query.status)
+        {
+            return find(m_by_status, *query.status);
+        }
+        return m_by_time;
+    }
+
+    bool
+    swaps_history_index::matches(const swaps_index_entry& entry, const swaps_index_query& query) const
+    {
+        return (!query.my_coin || entry.base_coin == *query.my_coin) && (!query.other_coin || entry.rel_coin == *query.other_coin) &&
+               (!query.status || entry.status == *query.status) && (!query.from_timestamp || entry.started_at >= *query.from_timestamp) &&
+               (!query.to_timestamp || entry.started_at <= *query.to_timestamp);
+    }
+
+    std::optional<nlohmann::json>
+    swaps_history_index::read_record(std::ifstream& ifs, const swaps_index_entry& entry) const
+    {
+        std::string record(entry.size, '\0');
+        ifs.seekg(static_cast<std::streamoff>(entry.offset));
+        ifs.read(record.data(), static_cast<std::streamsize>(entry.size));
+        if (!ifs.good())
+        {
+            ifs.clear();
+            return std::nullopt;
+        }
+        auto swap = nlohmann::json::parse(record, nullptr, false);
+        if (swap.is_discarded())
+        {
+            return std::nullopt;
+        }
+        return swap;
+    }
+
+    swaps_index_page
+    swaps_history_index::query(const swaps_index_query& query, const std::unordered_set<std::string>& excluded) const
+    {
+        std::shared_lock lock(m_mutex);
+        swaps_index_page out;
+        out.page             = std::max<std::size_t>(query.page, 1);
+        const auto  limit    = std::max<std::size_t>(query.limit, 1);
+        const auto& postings = select_postings(query);
+
+        //! Postings are sorted by descending started_at, the date range is a contiguous slice of them.
+        auto first = postings.begin();
+        auto last  = postings.end();
+        if (query.to_timestamp)
+        {
+            first = std::partition_point(first, last, [&query](const order_key& key) { return key.started_at > *query.to_timestamp; });
+        }
+        if (query.from_timestamp)
+        {
+            last = std::partition_point(first, last, [&query](const order_key& key) { return key.started_at >= *query.from_timestamp; });
+        }
+
+        std::vector<std::uint32_t> page_entries;
+        page_entries.reserve(limit);
+        const std::size_t skip          = (out.page - 1) * limit;
+        const bool        fully_indexed = !query.status || (!query.my_coin && !query.other_coin);
+        if (fully_indexed)
+        {
+            //! Only the excluded swaps (the active ones, a handful) are looked up, the page is then read at its offset in the slice.
+            std::vector<std::size_t> skipped;
+            for (auto&& uuid: excluded)
+            {
+                const auto it = m_by_uuid.find(uuid);
+                if (it == m_by_uuid.end() || !matches(m_entries[it->second], query))
+                {
+                    continue;
+                }
+                const order_key key{.started_at = m_entries[it->second].started_at, .entry = it->second};
+                const auto      pos = std::lower_bound(first, last, key, [this](const order_key& lhs, const order_key& rhs) { return is_before(lhs, rhs); });
+                skipped.push_back(static_cast<std::size_t>(pos - first));
+            }
+            std::sort(skipped.begin(), skipped.end());
+
+            const auto range_size = static_cast<std::size_t>(last - first);
+            out.total             = range_size - skipped.size();
+            std::size_t pos       = skip;
+            auto        skip_it   = skipped.begin();
+            for (; skip_it != skipped.end() && *skip_it <= pos; ++skip_it) { ++pos; }
+            while (pos < range_size && page_entries.size() < limit)
+            {
+                if (skip_it != skipped.end() && *skip_it == pos)
+                {
+                    ++skip_it;
+                }
+                else
+                {
+                    page_entries.push_back(first[static_cast<std::ptrdiff_t>(pos)].entry);
+                }
+                ++pos;
+            }
+        }
+        else
+        {
+            for (auto it = first; it != last; ++it)
+            {
+                const auto& entry = m_entries[it->entry];
+                if (!matches(entry, query) || excluded.contains(entry.uuid))
+                {
+                    continue;
+                }
+                if (out.total >= skip && page_entries.size() < limit)
+                {
+                    page_entries.push_back(it->entry);
+                }
+                out.total += 1;
+            }
+        }
+        out.nb_pages = std::max<std::size_t>(1, (out.total + limit - 1) / limit);
+
+        if (!page_entries.empty())
+        {
+            std::ifstream ifs(m_data_path.string(), std::ios::in | std::ios::binary);
+            out.swaps.reserve(page_entries.size());
+            for (const auto entry_idx: page_entries)
+            {
+                if (auto swap = read_record(ifs, m_entries[entry_idx]); swap)
+                {
+                    out.swaps.push_back(std::move(*swap));
+                }
+            }
+        }
+        return out;
+    }
+
+    std::optional<nlohmann::json>
+    swaps_history_index::get(const std::string& uuid) const
+    {
+        std::shared_lock lock(m_mutex);
+        const auto       it = m_by_uuid.find(uuid);
+        if (it == m_by_uuid.end())
+        {
+            return std::nullopt;
+        }
+        std::ifstream ifs(m_data_path.string(), std::ios::in | std::ios::binary);
+        return read_record(ifs, m_entries[it->second]);
+    }
+
+    std::optional<std::string>
+    swaps_history_index::get_status(const std::string& uuid) const
+    {
+        std::shared_lock lock(m_mutex);
+        const auto       it = m_by_uuid.find(uuid);
+        return it != m_by_uuid.end() ? std::optional<std::string>{m_entries[it->second].status} : std::nullopt;
+    }
+
+    std::optional<std::string>
+    swaps_history_index::oldest_uuid() const
+    {
+        std::shared_lock lock(m_mutex);
+        return m_by_time.empty() ? std::nullopt : std::optional<std::string>{m_entries[m_by_time.back().entry].uuid};
+    }
+
+    std::vector<std::string>
+    swaps_history_index::pending_uuids() const
+    {
+        std::shared_lock         lock(m_mutex);
+        std::vector<std::string> out;
+        for (auto&& [status, postings]: m_by_status)
+        {
+            if (::mm2::api::is_final_swap_status(status))
+            {
+                continue;
+            }
+            for (auto&& key: postings) { out.push_back(m_entries[key.entry].uuid); }
+        }
+        return out;
+    }
+
+    std::size_t
+    swaps_history_index::size() const
+    {
+        std::shared_lock lock(m_mutex);
+        return m_entries.size();
+    }
+
+    bool
+    swaps_history_index::is_open() const
+    {
+        std::shared_lock lock(m_mutex);
+        return m_is_open;
+    }
+
+    bool
+    swaps_history_index::is_complete() const
+    {
+        std::shared_lock lock(m_mutex);
+        return m_is_complete;
+    }
+
+    void
+    swaps_history_index::set_complete(bool complete)
+    {
+        std::unique_lock lock(m_mutex);
+        if (m_is_complete != complete)
+        {
+            m_is_complete = complete;
+            m_is_dirty    = true;
+        }
+    }
+
+    const fs::path&
+    swaps_history_index::get_index_path() const noexcept
+    {
+        return m_index_path;
+    }
+
+    const fs::path&
+    swaps_history_index::get_data_path() const noexcept
+    {
+        return m_data_path;
+    }
+} // namespace atomic_dex
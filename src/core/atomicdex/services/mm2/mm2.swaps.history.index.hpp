@@ -0,0 +1,159 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+//! Deps
+#include <nlohmann/json_fwd.hpp>
+
+//! Project Headers
+#include "atomicdex/utilities/fs.prerequisites.hpp"
+
+namespace atomic_dex
+{
+    struct swaps_index_entry
+    {
+        std::string   uuid;
+        std::string   base_coin;     ///< my coin, the coin sent during the swap
+        std::string   rel_coin;      ///< other coin
+        std::string   status;        ///< see mm2::api::determine_swap_status
+        std::uint64_t started_at{0}; ///< seconds, the date filters and the order of the history use it like mm2
+        std::uint32_t revision{0};   ///< number of events, grows while the swap is running
+        std::uint64_t offset{0};     ///< raw swap json in the data file
+        std::uint32_t size{0};
+    };
+
+    enum class swaps_index_upsert
+    {
+        inserted,
+        updated,
+        unchanged,
+        invalid
+    };
+
+    //! Same filters as my_recent_swaps plus the status.
+    struct swaps_index_query
+    {
+        std::optional<std::string> my_coin;
+        std::optional<std::string> other_coin;
+        std::optional<std::string> status;
+        std::optional<std::size_t> from_timestamp; ///< seconds, inclusive
+        std::optional<std::size_t> to_timestamp;   ///< seconds, inclusive
+        std::size_t                page{1};
+        std::size_t                limit{50};
+    };
+
+    struct swaps_index_page
+    {
+        std::vector<nlohmann::json> swaps;    ///< raw my_recent_swaps entries, most recent first
+        std::size_t                 total{0}; ///< entries matching the filters
+        std::size_t                 nb_pages{1};
+        std::size_t                 page{1};
+    };
+
+    //! Persistent history of the swaps of a wallet, so the orders page does not go back to mm2 for every page, filter or refresh.
+    //!
+    //! Two files per wallet:
+    //!   `<name>.swaps.jsonl`: append only, one raw swap json per line, an updated swap is appended again.
+    //!   `<name>.swaps.idx`:   fixed header then one entry per swap in native byte order, rewritten through a temporary file on save.
+    //! Entries pointing past the end of the data file are the leftover of an interrupted write and are dropped on load.
+    //!
+    //! Swaps are sorted by `started_at` (most recent first) and indexed by coin, coin pair and status,
+    //! every secondary index keeps the same order so a filtered page is a slice of one of them.
+    class swaps_history_index
+    {
+      public:
+        static constexpr std::uint32_t g_version = 1;
+
+        swaps_history_index() = default;
+        swaps_history_index(const swaps_history_index& other) = delete;
+        swaps_history_index& operator=(const swaps_history_index& other) = delete;
+
+        //! Loads the index of `name` from `folder`, an unreadable index starts empty and the data file is truncated.
+        bool open(const fs::path& folder, const std::string& name);
+        void close();
+        bool save(); ///< writes the index file if it changed since the last save
+
+        //! Inserts a raw my_recent_swaps entry, or appends it again when it received new events.
+        swaps_index_upsert upsert(const nlohmann::json& swap);
+
+        [[nodiscard]] swaps_index_page              query(const swaps_index_query& query, const std::unordered_set<std::string>& excluded = {}) const;
+        [[nodiscard]] std::optional<nlohmann::json> get(const std::string& uuid) const;
+        [[nodiscard]] std::optional<std::string>    get_status(const std::string& uuid) const;
+        [[nodiscard]] std::optional<std::string>    oldest_uuid() const;
+        [[nodiscard]] std::vector<std::string>      pending_uuids() const; ///< swaps that are not successful or failed yet
+        [[nodiscard]] std::size_t                   size() const;
+        [[nodiscard]] bool                          is_open() const;
+
+        //! The history is complete once it was fetched up to the oldest swap, new swaps are then only fetched from the most recent ones.
+        [[nodiscard]] bool is_complete() const;
+        void               set_complete(bool complete);
+
+        [[nodiscard]] const fs::path& get_index_path() const noexcept;
+        [[nodiscard]] const fs::path& get_data_path() const noexcept;
+
+      private:
+        //! Position of an entry in the history order, most recent first.
+        struct order_key
+        {
+            std::uint64_t started_at;
+            std::uint32_t entry;
+        };
+
+        //! New swaps land in front and the history catch up appends older swaps at the back, both are O(1) on a deque.
+        using t_postings = std::deque<order_key>;
+
+        bool                          load_index();
+        bool                          compact(); ///< rewrites the data file with the live records only
+        void                          index_entry(std::uint32_t entry);
+        void                          index_all(); ///< rebuilds every posting list at once, used on load
+        void                          unindex_entry(std::uint32_t entry);
+        bool                          is_before(const order_key& lhs, const order_key& rhs) const;
+        const t_postings&             select_postings(const swaps_index_query& query) const;
+        bool                          matches(const swaps_index_entry& entry, const swaps_index_query& query) const;
+        std::optional<nlohmann::json> read_record(std::ifstream& ifs, const swaps_index_entry& entry) const;
+        static std::string            pair_key(const std::string& base, const std::string& rel);
+
+        fs::path      m_index_path;
+        fs::path      m_data_path;
+        std::ofstream m_data_ofs;
+        std::uint64_t m_data_size{0};
+        bool          m_is_open{false};
+        bool          m_is_complete{false};
+        bool          m_is_dirty{false};
+
+        std::vector<swaps_index_entry>                 m_entries;
+        std::unordered_map<std::string, std::uint32_t> m_by_uuid;
+        t_postings                                     m_by_time;
+        std::unordered_map<std::string, t_postings>    m_by_base_coin;
+        std::unordered_map<std::string, t_postings>    m_by_rel_coin;
+        std::unordered_map<std::string, t_postings>    m_by_pair;
+        std::unordered_map<std::string, t_postings>    m_by_status;
+
+        mutable std::shared_mutex m_mutex;
+    };
+} // namespace atomic_dex
@@ -0,0 +1,372 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+#include <exception>
+
+//! Deps
+#include <spdlog/spdlog.h>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.trade.evaluation.engine.hpp"
+
+namespace
+{
+    template <typename TMap>
+    void
+    evict_overflow(TMap& entries, std::size_t max_entries, std::chrono::steady_clock::time_point now)
+    {
+        if (entries.size() <= max_entries)
+        {
+            return;
+        }
+        std::erase_if(entries, [now](const auto& cur) { return cur.second.expires_at <= now; });
+        while (entries.size() > max_entries)
+        {
+            auto oldest = std::min_element(
+                entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) { return lhs.second.expires_at < rhs.second.expires_at; });
+            entries.erase(oldest);
+        }
+    }
+
+    std::string
+    volume_key(atomic_dex::trade_volume_kind kind, const std::string& coin)
+    {
+        return (kind == atomic_dex::trade_volume_kind::max_taker_vol ? "max_taker_vol/" : "min_trading_vol/") + coin;
+    }
+} // namespace
+
+namespace atomic_dex
+{
+    std::string
+    normalize_trade_amount(std::string amount)
+    {
+        if (amount.empty())
+        {
+            return "0";
+        }
+        if (amount.find('.') != std::string::npos)
+        {
+            amount.erase(amount.find_last_not_of('0') + 1);
+            if (amount.back() == '.')
+            {
+                amount.pop_back();
+            }
+        }
+        return amount.empty() ? "0" : amount;
+    }
+
+    std::string
+    trade_preimage_key::to_string() const
+    {
+        return base + "/" + rel + "/" + swap_method + "/" + volume + "/" + price;
+    }
+} // namespace atomic_dex
+
+//! trade_evaluation_engine
+namespace atomic_dex
+{
+    struct trade_evaluation_engine::state
+    {
+        struct cache_entry
+        {
+            trade_preimage_key key;
+            nlohmann::json     answer;
+            t_time_point       expires_at;
+        };
+
+        t_fetch_functor                              fetch;
+        t_answer_functor                             on_answer;
+        trade_evaluation_cfg                         cfg;
+        mutable std::mutex                           mutex;
+        std::optional<trade_preimage_key>            wanted; ///< last submitted evaluation, the only one whose answer is delivered
+        std::optional<trade_preimage_key>            pending;
+        t_time_point                                 pending_deadline;
+        std::optional<trade_preimage_key>            in_flight;
+        pplx::cancellation_token_source              in_flight_source;
+        std::size_t                                  generation{0}; ///< bumped by every request sent, the answers of cancelled ones are dropped
+        std::unordered_map<std::string, cache_entry> cache;
+        trade_evaluation_metrics                     metrics;
+
+        //! Must be called with the mutex held.
+        std::optional<nlohmann::json>
+        cached_answer(const std::string& key, t_time_point now)
+        {
+            const auto it = cache.find(key);
+            if (it == cache.end())
+            {
+                return std::nullopt;
+            }
+            if (it->second.expires_at <= now)
+            {
+                cache.erase(it);
+                return std::nullopt;
+            }
+            return it->second.answer;
+        }
+
+        //! Must be called with the mutex held.
+        void
+        cancel_in_flight()
+        {
+            if (in_flight.has_value())
+            {
+                in_flight_source.cancel();
+                in_flight.reset();
+                generation += 1;
+                metrics.nb_cancelled += 1;
+            }
+        }
+    };
+
+    trade_evaluation_engine::trade_evaluation_engine(t_fetch_functor fetch, t_answer_functor on_answer, trade_evaluation_cfg cfg) :
+        m_state(std::make_shared<state>())
+    {
+        m_state->fetch     = std::move(fetch);
+        m_state->on_answer = std::move(on_answer);
+        m_state->cfg       = cfg;
+    }
+
+    trade_evaluation_engine::~trade_evaluation_engine()
+    {
+        cancel();
+    }
+
+    void
+    trade_evaluation_engine::submit(trade_preimage_key key, t_time_point now)
+    {
+        key.volume = normalize_trade_amount(std::move(key.volume));
+        key.price  = normalize_trade_amount(std::move(key.price));
+
+        std::optional<nlohmann::json> answer;
+        {
+            std::scoped_lock lock(m_state->mutex);
+            if (m_state->pending == key)
+            {
+                return;
+            }
+            m_state->wanted = key;
+            if (m_state->pending.has_value())
+            {
+                m_state->metrics.nb_coalesced += 1;
+                m_state->pending.reset();
+            }
+            if (m_state->in_flight == key)
+            {
+                //! Back to the evaluation already in flight, its answer is the one wanted again.
+                return;
+            }
+
+            answer = m_state->cached_answer(key.to_string(), now);
+            if (answer.has_value())
+            {
+                m_state->metrics.nb_hits += 1;
+                m_state->cancel_in_flight();
+            }
+            else
+            {
+                //! The request in flight is only cancelled once this one is sent, the edit may still go back to it.
+                m_state->pending          = key;
+                m_state->pending_deadline = now + m_state->cfg.debounce;
+            }
+        }
+
+        if (answer.has_value())
+        {
+            m_state->on_answer(key, std::move(answer));
+        }
+    }
+
+    bool
+    trade_evaluation_engine::run_due(t_time_point now)
+    {
+        trade_preimage_key       key;
+        std::size_t              generation;
+        pplx::cancellation_token token = pplx::cancellation_token::none();
+        {
+            std::scoped_lock lock(m_state->mutex);
+            if (!m_state->pending.has_value() || m_state->pending_deadline > now)
+            {
+                return false;
+            }
+            key = std::move(*m_state->pending);
+            m_state->pending.reset();
+            m_state->cancel_in_flight();
+            m_state->metrics.nb_misses += 1;
+            m_state->generation += 1;
+            m_state->in_flight        = key;
+            m_state->in_flight_source = pplx::cancellation_token_source();
+            generation                = m_state->generation;
+            token                     = m_state->in_flight_source.get_token();
+        }
+
+        std::weak_ptr<state> weak_state = m_state;
+        m_state->fetch(key, token)
+            .then([weak_state, generation, key](pplx::task<nlohmann::json> previous_task)
+                  { on_fetched(weak_state, generation, key, std::move(previous_task)); });
+        return true;
+    }
+
+    void
+    trade_evaluation_engine::on_fetched(
+        const std::weak_ptr<state>& weak_state, std::size_t generation, const trade_preimage_key& key, pplx::task<nlohmann::json> previous_task)
+    {
+        std::optional<nlohmann::json> answer;
+        try
+        {
+            answer = previous_task.get();
+        }
+        catch (const std::exception& error)
+        {
+            SPDLOG_WARN("trade_preimage evaluation of {} failed: {}", key.to_string(), error.what());
+        }
+
+        auto engine_state = weak_state.lock();
+        if (!engine_state)
+        {
+            return;
+        }
+        {
+            std::scoped_lock lock(engine_state->mutex);
+            if (generation != engine_state->generation)
+            {
+                //! Superseded while in flight, already counted as cancelled.
+                return;
+            }
+            engine_state->in_flight.reset();
+            if (!answer.has_value())
+            {
+                engine_state->metrics.nb_failed += 1;
+            }
+            else if (answer->contains("result"))
+            {
+                //! Errors (ex: not enough balance) are not cached, the next edit asks again.
+                const auto now = t_clock::now();
+                engine_state->cache.insert_or_assign(key.to_string(), state::cache_entry{key, *answer, now + engine_state->cfg.preimage_ttl});
+                evict_overflow(engine_state->cache, engine_state->cfg.max_entries, now);
+            }
+            if (engine_state->wanted != key)
+            {
+                //! The form moved on during the debounce window, the pending evaluation will answer.
+                return;
+            }
+        }
+        engine_state->on_answer(key, std::move(answer));
+    }
+
+    std::optional<trade_evaluation_engine::t_time_point>
+    trade_evaluation_engine::next_deadline() const
+    {
+        std::scoped_lock lock(m_state->mutex);
+        if (!m_state->pending.has_value())
+        {
+            return std::nullopt;
+        }
+        return m_state->pending_deadline;
+    }
+
+    bool
+    trade_evaluation_engine::is_busy() const
+    {
+        std::scoped_lock lock(m_state->mutex);
+        return m_state->pending.has_value() || m_state->in_flight.has_value();
+    }
+
+    void
+    trade_evaluation_engine::cancel()
+    {
+        std::scoped_lock lock(m_state->mutex);
+        m_state->wanted.reset();
+        m_state->pending.reset();
+        m_state->cancel_in_flight();
+    }
+
+    void
+    trade_evaluation_engine::invalidate(const std::string& coin)
+    {
+        std::scoped_lock lock(m_state->mutex);
+        std::erase_if(m_state->cache, [&coin](const auto& cur) { return cur.second.key.base == coin || cur.second.key.rel == coin; });
+    }
+
+    void
+    trade_evaluation_engine::clear()
+    {
+        std::scoped_lock lock(m_state->mutex);
+        m_state->cache.clear();
+    }
+
+    trade_evaluation_metrics
+    trade_evaluation_engine::get_metrics() const
+    {
+        std::scoped_lock lock(m_state->mutex);
+        return m_state->metrics;
+    }
+} // namespace atomic_dex
+
+//! trade_volume_cache
+namespace atomic_dex
+{
+    trade_volume_cache::trade_volume_cache(trade_evaluation_cfg cfg) : m_cfg(cfg)
+    {
+    }
+
+    std::optional<nlohmann::json>
+    trade_volume_cache::get(trade_volume_kind kind, const std::string& coin, t_time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto       it = m_entries.find(volume_key(kind, coin));
+        if (it == m_entries.end() || it->second.expires_at <= now)
+        {
+            m_metrics.nb_misses += 1;
+            return std::nullopt;
+        }
+        m_metrics.nb_hits += 1;
+        return it->second.answer;
+    }
+
+    void
+    trade_volume_cache::store(trade_volume_kind kind, const std::string& coin, nlohmann::json answer, t_time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        m_entries.insert_or_assign(volume_key(kind, coin), entry{std::move(answer), now + m_cfg.volumes_ttl});
+        evict_overflow(m_entries, m_cfg.max_entries, now);
+    }
+
+    void
+    trade_volume_cache::invalidate(const std::string& coin)
+    {
+        std::scoped_lock lock(m_mutex);
+        for (auto kind: {trade_volume_kind::max_taker_vol, trade_volume_kind::min_trading_vol})
+        {
+            m_metrics.nb_invalidated += m_entries.erase(volume_key(kind, coin));
+        }
+    }
+
+    void
+    trade_volume_cache::clear()
+    {
+        std::scoped_lock lock(m_mutex);
+        m_entries.clear();
+    }
+
+    trade_volume_cache_metrics
+    trade_volume_cache::get_metrics() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_metrics;
+    }
+} // namespace atomic_dex
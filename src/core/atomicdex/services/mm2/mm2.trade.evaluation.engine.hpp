@@ -0,0 +1,158 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+//! Deps
+#include <nlohmann/json.hpp>
+
+//! Project Headers
+#include "atomicdex/utilities/cpprestsdk.utilities.hpp"
+
+namespace atomic_dex
+{
+    struct trade_evaluation_cfg
+    {
+        std::chrono::milliseconds debounce{300};    ///< edits closer than this are evaluated once
+        std::chrono::seconds      preimage_ttl{15}; ///< a trade_preimage answer is reused this long
+        std::chrono::seconds      volumes_ttl{30};  ///< a max_taker_vol / min_trading_vol answer is reused this long
+        std::size_t               max_entries{128}; ///< per cache, the entry closest to expiry is evicted first
+    };
+
+    //! What a trade_preimage answer depends on. `volume` is the volume bucket: the amount normalized, so "1.50" and "1.5" share an entry.
+    struct trade_preimage_key
+    {
+        std::string base;
+        std::string rel;
+        std::string swap_method; ///< buy, sell or setprice
+        std::string volume;
+        std::string price;
+
+        [[nodiscard]] std::string to_string() const;
+        bool                      operator==(const trade_preimage_key& other) const = default;
+    };
+
+    enum class trade_volume_kind
+    {
+        max_taker_vol,
+        min_trading_vol,
+    };
+
+    struct trade_evaluation_metrics
+    {
+        std::size_t nb_hits{0};      ///< evaluations answered from the cache
+        std::size_t nb_misses{0};    ///< evaluations sent to mm2
+        std::size_t nb_coalesced{0}; ///< edits replaced by a newer one inside the debounce window
+        std::size_t nb_cancelled{0}; ///< in flight requests superseded by a newer evaluation
+        std::size_t nb_failed{0};
+    };
+
+    struct trade_volume_cache_metrics
+    {
+        std::size_t nb_hits{0};
+        std::size_t nb_misses{0};
+        std::size_t nb_invalidated{0};
+    };
+
+    //! Normalized decimal used as cache key, trailing zeros and a trailing dot are dropped ("1.500" -> "1.5", "2.0" -> "2").
+    std::string normalize_trade_amount(std::string amount);
+
+    //! Evaluates the trading form: one trade_preimage per settled edit instead of one per keystroke.
+    //! Edits are debounced, a new evaluation cancels the request still in flight for an older one and answers are cached per key.
+    //! Time is passed by the caller, answers are delivered on the thread completing the fetch task (or the caller for a cache hit). Thread safe.
+    class trade_evaluation_engine
+    {
+      public:
+        using t_clock          = std::chrono::steady_clock;
+        using t_time_point     = t_clock::time_point;
+        using t_fetch_functor  = std::function<pplx::task<nlohmann::json>(const trade_preimage_key& key, pplx::cancellation_token token)>;
+        using t_answer_functor = std::function<void(const trade_preimage_key& key, std::optional<nlohmann::json> answer)>; ///< nullopt when the request failed
+
+        trade_evaluation_engine(t_fetch_functor fetch, t_answer_functor on_answer, trade_evaluation_cfg cfg = {});
+        ~trade_evaluation_engine();
+
+        trade_evaluation_engine(const trade_evaluation_engine& other) = delete;
+        trade_evaluation_engine& operator=(const trade_evaluation_engine& other) = delete;
+
+        //! Schedules an evaluation of `key` once the debounce window is over, a cached answer is delivered right away.
+        void submit(trade_preimage_key key, t_time_point now);
+
+        //! Sends the pending evaluation if its debounce window is over, returns true if a request was sent.
+        bool run_due(t_time_point now);
+
+        [[nodiscard]] std::optional<t_time_point> next_deadline() const;
+        [[nodiscard]] bool                        is_busy() const; ///< an evaluation is pending or in flight
+
+        //! Drops the pending evaluation and cancels the one in flight, ex: the form is cleared.
+        void cancel();
+
+        //! Drops the cached answers involving `coin`, ex: its balance moved.
+        void invalidate(const std::string& coin);
+        void clear();
+
+        [[nodiscard]] trade_evaluation_metrics get_metrics() const;
+
+      private:
+        struct state;
+
+        static void
+        on_fetched(const std::weak_ptr<state>& weak_state, std::size_t generation, const trade_preimage_key& key, pplx::task<nlohmann::json> previous_task);
+
+        std::shared_ptr<state> m_state; ///< shared with the fetch continuations, which may complete after the engine is gone
+    };
+
+    //! Short lived max_taker_vol / min_trading_vol answers per coin, so switching back to a recent pair does not fetch them again.
+    //! Thread safe.
+    class trade_volume_cache
+    {
+      public:
+        using t_clock      = std::chrono::steady_clock;
+        using t_time_point = t_clock::time_point;
+
+        explicit trade_volume_cache(trade_evaluation_cfg cfg = {});
+
+        [[nodiscard]] std::optional<nlohmann::json> get(trade_volume_kind kind, const std::string& coin, t_time_point now);
+        void                                        store(trade_volume_kind kind, const std::string& coin, nlohmann::json answer, t_time_point now);
+
+        //! Drops the answers of `coin`, its balance or its locked amount moved.
+        void invalidate(const std::string& coin);
+        void clear();
+
+        [[nodiscard]] trade_volume_cache_metrics get_metrics() const;
+
+      private:
+        struct entry
+        {
+            nlohmann::json answer;
+            t_time_point   expires_at;
+        };
+
+        trade_evaluation_cfg                   m_cfg;
+        mutable std::mutex                     m_mutex;
+        std::unordered_map<std::string, entry> m_entries; ///< "<kind>/<coin>"
+        trade_volume_cache_metrics             m_metrics;
+    };
+} // namespace atomic_dex
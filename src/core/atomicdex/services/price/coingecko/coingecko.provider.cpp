@@ -6,6 +6,7 @@
 #include "atomicdex/pages/qt.portfolio.page.hpp"
 #include "atomicdex/pages/qt.settings.page.hpp"
 #include "atomicdex/services/price/coingecko/coingecko.provider.hpp"
+#include "atomicdex/utilities/http.retry.hpp"
 
 namespace atomic_dex
 {
@@ -121,13 +122,11 @@ namespace atomic_dex
     coingecko_provider::internal_update(
         const std::vector<std::string>& ids, const std::unordered_map<std::string, std::string>& registry, bool should_move, std::vector<std::string> tickers)
     {
-        static std::atomic_uint16_t nb_try = 0;
-        nb_try += 1;
         if (!ids.empty())
         {
             SPDLOG_INFO("Processing internal_update");
 
-            auto error_functor = [this, ids, registry, should_move, tickers](pplx::task<void> previous_task)
+            auto error_functor = [this, tickers](pplx::task<void> previous_task)
             {
               try
               {
@@ -135,10 +134,12 @@ namespace atomic_dex
               }
               catch (const std::exception& e)
               {
-                  SPDLOG_ERROR("pplx task error from coingecko::api::async_market_infos: {} - nb_try {}", e.what(), nb_try.load());
-                  using namespace std::chrono_literals;
-                  std::this_thread::sleep_for(1s);
-                  this->internal_update(ids, registry, should_move, tickers);
+                  //! Retries are exhausted, the coins are still initialized, their market infos come with the next periodic update.
+                  SPDLOG_ERROR("pplx task error from coingecko::api::async_market_infos: {}", e.what());
+                  if (!tickers.empty())
+                  {
+                      dispatcher_.trigger<coin_fully_initialized>(tickers);
+                  }
               };
             };
             t_coingecko_market_infos_request request{.ids = std::move(ids)};
@@ -177,21 +178,31 @@ namespace atomic_dex
                     {
                         dispatcher_.trigger<fiat_rate_updated>("");
                     }
-                    SPDLOG_INFO("Coingecko rates successfully updated after nb_try: {}", nb_try.load());
-                    nb_try = 0;
+                    SPDLOG_INFO("Coingecko rates successfully updated");
                 }
                 else
                 {
                     SPDLOG_ERROR("Error during the rpc call to coingecko: {}", body);
+                    if (!tickers.empty())
+                    {
+                        dispatcher_.trigger<coin_fully_initialized>(tickers);
+                    }
                 }
             };
-            coingecko::api::async_market_infos(std::move(request)).then(answer_functor).then(error_functor);
+            retry_http(
+                g_coingecko_host,
+                [request = std::move(request)]()
+                {
+                    auto current = request;
+                    return coingecko::api::async_market_infos(std::move(current));
+                })
+                .then(answer_functor)
+                .then(error_functor);
         }
         else
         {
             //! If it's only test coin
             dispatcher_.trigger<coin_fully_initialized>(tickers);
-            nb_try = 0;
         }
     }
 
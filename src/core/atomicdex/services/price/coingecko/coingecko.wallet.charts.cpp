@@ -7,26 +7,35 @@
 #include "atomicdex/pages/qt.settings.page.hpp"
 #include "atomicdex/services/price/coingecko/coingecko.wallet.charts.hpp"
 #include "atomicdex/services/price/global.provider.hpp"
+#include "atomicdex/utilities/http.retry.hpp"
 #include "atomicdex/utilities/qt.utilities.hpp"
 
 namespace
 {
-    std::string
-    get_days_from_wallet_category(WalletChartsCategories category)
+    std::uint64_t
+    get_now_ms()
     {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    std::uint64_t
+    get_window_start_from_wallet_category(WalletChartsCategories category, std::uint64_t now_ms)
+    {
+        constexpr std::uint64_t day_ms = atomic_dex::g_daily_resolution_ms;
         switch (category)
         {
         case atomic_dex::WalletChartsCategoriesGadget::OneDay:
-            return "1";
+            return now_ms - day_ms;
         case atomic_dex::WalletChartsCategoriesGadget::OneWeek:
-            return "7";
+            return now_ms - 7 * day_ms;
         case atomic_dex::WalletChartsCategoriesGadget::OneMonth:
-            return "30";
+            return now_ms - 30 * day_ms;
         case atomic_dex::WalletChartsCategoriesGadget::Ytd:
-            return "";
         case atomic_dex::WalletChartsCategoriesGadget::Size:
-            return "";
+            break;
         }
+        date::year_month_day today = date::floor<date::days>(std::chrono::system_clock::time_point(std::chrono::milliseconds(now_ms)));
+        return std::chrono::duration_cast<std::chrono::milliseconds>(date::sys_days{today.year() / 1 / 1}.time_since_epoch()).count();
     }
 } // namespace
 
@@ -34,7 +43,7 @@ namespace
 namespace atomic_dex
 {
     coingecko_wallet_charts_service::coingecko_wallet_charts_service(entt::registry& registry, ag::ecs::system_manager& system_manager) :
-        system(registry), m_system_manager(system_manager)
+        system(registry), m_system_manager(system_manager), m_price_series_cache(utils::get_atomic_dex_charts_cache_folder())
     {
         SPDLOG_INFO("coingecko_wallet_charts_service created");
         m_update_clock = std::chrono::high_resolution_clock::now();
@@ -55,50 +64,34 @@ namespace atomic_dex
             try
             {
                 SPDLOG_INFO("Generate fiat chart");
-                const auto     fiat           = m_system_manager.get_system<settings_page>().get_current_fiat().toStdString();
-                t_float_50     rate           = safe_float(m_system_manager.get_system<global_price_service>().get_fiat_rates(fiat));
-                auto           chart_registry = this->m_chart_data_registry.get();
-                nlohmann::json out            = nlohmann::json::array();
-                const auto&    data           = chart_registry.begin()->second;
-                const auto&    mm2            = m_system_manager.get_system<mm2_service>();
-                t_float_50     first_total    = 0;
-                for (std::size_t idx = 0; idx < data.size(); idx++)
+                const auto  fiat           = m_system_manager.get_system<settings_page>().get_current_fiat().toStdString();
+                const auto  rate           = safe_float(m_system_manager.get_system<global_price_service>().get_fiat_rates(fiat)).convert_to<double>();
+                const auto  chart_registry = this->m_chart_data_registry.get();
+                const auto& mm2            = m_system_manager.get_system<mm2_service>();
+
+                wallet_valuation_engine engine;
+                engine.build(chart_registry);
+                if (engine.nb_points() == 0)
                 {
-                    nlohmann::json cur = nlohmann::json::object();
-                    cur["timestamp"]   = data[idx][0].get<std::size_t>() / 1000;
-                    // cur["human_date"]  = utils::to_human_date<std::chrono::milliseconds>(cur.at("timestamp").get<std::size_t>(), "%e %b %Y, %H:%M");
-                    t_float_50 total(0);
-                    bool       to_skip = false;
-                    for (auto&& [key, value]: chart_registry)
-                    {
-                        if (idx >= value.size())
-                        {
-                            SPDLOG_ERROR("skipping idx: {}", idx);
-                            to_skip = true;
-                            continue;
-                        }
-                        t_float_50 cur_total = (t_float_50(value[idx][1].get<float>()) * mm2.get_balance(key)) * rate;
-                        total += cur_total;
-                    }
-                    if (to_skip)
-                    {
-                        continue;
-                    }
-                    if (safe_float(m_min_value) <= 0 || total < safe_float(m_min_value))
-                    {
-                        m_min_value = utils::format_float(total);
-                    }
-                    if (total > safe_float(m_max_value))
-                    {
-                        m_max_value = utils::format_float(total);
-                    }
-                    cur["total"] = utils::format_float(total);
-                    if (idx == 0)
-                    {
-                        first_total = total;
-                    }
-                    out.push_back(cur);
+                    SPDLOG_WARN("No chart data available - skipping fiat chart");
+                    return;
+                }
+
+                //! One balance read per coin for the whole chart instead of one per coin per point.
+                wallet_valuation_engine::t_balances balances;
+                balances.reserve(chart_registry.size());
+                for (auto&& [ticker, _]: chart_registry) { balances.emplace(ticker, mm2.get_balance(ticker).convert_to<double>()); }
+
+                const auto     summary = engine.evaluate(balances, rate);
+                nlohmann::json out     = nlohmann::json::array();
+                for (std::size_t idx = 0; idx < summary.totals.size(); ++idx)
+                {
+                    out.push_back({{"timestamp", summary.timestamps[idx]}, {"total", utils::format_float(t_float_50(summary.totals[idx]))}});
                 }
+                t_float_50 first_total = summary.first_total;
+                m_min_value            = utils::format_float(t_float_50(summary.min_total));
+                m_max_value            = utils::format_float(t_float_50(summary.max_total));
+
                 auto        now                  = std::chrono::system_clock::now();
                 std::size_t timestamp            = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
                 out[out.size() - 1]["timestamp"] = timestamp;
@@ -152,54 +145,59 @@ namespace atomic_dex
     void
     coingecko_wallet_charts_service::fetch_data_of_single_coin(const coin_config& cfg)
     {
-        using namespace std::chrono_literals;
         SPDLOG_INFO("fetch charts data of {} {}", cfg.ticker, cfg.coingecko_id);
-        std::function<void(WalletChartsCategories, std::string)> market_functor;
-
-        market_functor = [this, cfg, &market_functor](WalletChartsCategories category, std::string days)
+        const auto category    = m_system_manager.get_system<portfolio_page>().get_chart_category();
+        const auto now_ms      = get_now_ms();
+        const auto window_from = get_window_start_from_wallet_category(category, now_ms);
+        const auto fetcher     = [&cfg](std::uint64_t from_ms, std::uint64_t to_ms) -> std::optional<price_series>
         {
-            //! 30 days
+            auto request_functor = [id = cfg.coingecko_id, from_ms, to_ms]()
             {
-                try
-                {
-                    web::http::http_response resp;
-                    if (days.empty() && category >= WalletChartsCategories::Ytd)
-                    {
-                        auto                 now           = std::chrono::system_clock::now();
-                        std::size_t          timestamp     = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
-                        date::year_month_day today         = date::floor<date::days>(std::chrono::system_clock::now());
-                        std::size_t          ytd_timestamp = date::sys_seconds{date::sys_days{today.year() / 1 / 1}}.time_since_epoch().count();
-                        t_coingecko_market_chart_range_request request{
-                            .id = cfg.coingecko_id, .vs_currency = "usd", .from = std::to_string(ytd_timestamp), .to = std::to_string(timestamp)};
-                        resp = atomic_dex::coingecko::api::async_market_charts_range(std::move(request)).get();
-                    }
-                    else
-                    {
-                        t_coingecko_market_chart_request request{.id = cfg.coingecko_id, .vs_currency = "usd", .days = days, .interval = "daily"};
-                        resp = atomic_dex::coingecko::api::async_market_charts(std::move(request)).get();
-                    }
-                    std::string body = TO_STD_STR(resp.extract_string(true).get());
-                    if (resp.status_code() == 200)
-                    {
-                        m_chart_data_registry->operator[](cfg.ticker) = nlohmann::json::parse(body).at("prices");
-                        SPDLOG_INFO("Successfully retrieve chart data for: {} {}", cfg.ticker, cfg.coingecko_id);
-                    }
-                    else
-                    {
-                        std::this_thread::sleep_for(1s);
-                        market_functor(category, days);
-                    }
-                }
-                catch (const std::exception& error)
+                t_coingecko_market_chart_range_request request{
+                    .id = id, .vs_currency = "usd", .from = std::to_string(from_ms / 1000), .to = std::to_string(to_ms / 1000)};
+                return atomic_dex::coingecko::api::async_market_charts_range(std::move(request));
+            };
+
+            try
+            {
+                //! The taskflow worker waits for the final answer, the retries are delayed on the retry scheduler without holding a thread.
+                web::http::http_response resp = retry_http(g_coingecko_host, std::move(request_functor)).get();
+                std::string              body = TO_STD_STR(resp.extract_string(true).get());
+                if (resp.status_code() == 200)
                 {
-                    SPDLOG_ERROR("Caught exception: {} - retrying.", error.what());
-                    std::this_thread::sleep_for(1s);
-                    market_functor(category, days);
+                    return price_series::from_json(nlohmann::json::parse(body).at("prices"));
                 }
+                SPDLOG_ERROR("Unable to retrieve chart data for: {} {}, status code {}", cfg.ticker, cfg.coingecko_id, resp.status_code());
+            }
+            catch (const std::exception& error)
+            {
+                SPDLOG_ERROR("Caught exception: {} - chart data of {} skipped.", error.what(), cfg.ticker);
             }
+            return std::nullopt;
         };
-        auto current_category = m_system_manager.get_system<portfolio_page>().get_chart_category();
-        market_functor(current_category, get_days_from_wallet_category(current_category));
+
+        //! Only the range missing from the on-disk cache is requested, the daily samples of the window are then read from it.
+        if (auto series = m_price_series_cache.fetch_window(cfg.coingecko_id, g_daily_resolution_ms, window_from, now_ms, fetcher); series)
+        {
+            m_chart_data_registry->insert_or_assign(cfg.ticker, std::move(*series));
+            SPDLOG_INFO("Successfully retrieve chart data for: {} {}", cfg.ticker, cfg.coingecko_id);
+        }
+    }
+
+    bool
+    coingecko_wallet_charts_service::load_cached_charts_data(const std::vector<coin_config>& coins)
+    {
+        const auto window_from = get_window_start_from_wallet_category(m_system_manager.get_system<portfolio_page>().get_chart_category(), get_now_ms());
+        bool       loaded      = false;
+        for (auto&& cfg: coins)
+        {
+            if (auto series = m_price_series_cache.load_window(cfg.coingecko_id, g_daily_resolution_ms, window_from); series)
+            {
+                m_chart_data_registry->insert_or_assign(cfg.ticker, std::move(*series));
+                loaded = true;
+            }
+        }
+        return loaded;
     }
 
     void
@@ -221,6 +219,7 @@ namespace atomic_dex
             QJsonObject worst_performer;
             std::string best_change_24h("");
             std::string worst_change_24h("");
+            std::vector<coin_config> charted_coins;
             for (auto&& [coin, cfg]: coins)
             {
                 if (cfg.coingecko_id == "test-coin")
@@ -252,6 +251,7 @@ namespace atomic_dex
                             best_performer["percent"] = QString::fromStdString(best_change_24h);
                         }
                         final_task.succeed(m_taskflow.emplace([this, cfg = cfg]() { fetch_data_of_single_coin(cfg); }).name(cfg.ticker));
+                        charted_coins.push_back(cfg);
                     }
                 }
             }
@@ -266,6 +266,13 @@ namespace atomic_dex
             {
                 m_wallet_performance->insert("best_performance", best_performer);
                 m_wallet_performance->insert("worst_performance", worst_performer);
+                //! The cached series are drawn right away, the chart is generated again once the missing ranges are fetched.
+                if (load_cached_charts_data(charted_coins))
+                {
+                    generate_fiat_chart();
+                    this->m_is_busy = true;
+                    emit m_system_manager.get_system<portfolio_page>().chartBusyChanged();
+                }
                 SPDLOG_INFO("taskflow: {}", m_taskflow.dump());
                 m_executor.run(m_taskflow);
             }
@@ -15,6 +15,8 @@
 //! Project Headers
 #include "atomicdex/config/coins.cfg.hpp"
 #include "atomicdex/constants/qt.wallet.enums.hpp"
+#include "atomicdex/services/price/coingecko/price.series.cache.hpp"
+#include "atomicdex/services/price/coingecko/wallet.valuation.engine.hpp"
 
 namespace atomic_dex
 {
@@ -23,7 +25,7 @@ namespace atomic_dex
         //! Private typedefs
         using t_update_time_point   = std::chrono::high_resolution_clock::time_point;
         using t_array_chart_data    = nlohmann::json;
-        using t_chart_data_registry = boost::synchronized_value<std::unordered_map<std::string, t_array_chart_data>>;
+        using t_chart_data_registry = boost::synchronized_value<t_price_series_registry>;
         using t_fiat_charts         = boost::synchronized_value<t_array_chart_data>;
 
         //! Private member functions
@@ -37,9 +39,11 @@ namespace atomic_dex
         std::string                            m_min_value{"0"};
         std::string                            m_max_value{"0"};
         boost::synchronized_value<QJsonObject> m_wallet_performance;
+        price_series_cache                     m_price_series_cache;
 
         //! Private member functions
         void fetch_data_of_single_coin(const coin_config& cfg);
+        bool load_cached_charts_data(const std::vector<coin_config>& coins);
         void fetch_all_charts_data();
         void generate_fiat_chart();
 
@@ -0,0 +1,291 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+
+//! Deps
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+//! Project Headers
+#include "atomicdex/services/price/coingecko/price.series.cache.hpp"
+#include "atomicdex/utilities/log.prerequisites.hpp"
+
+namespace
+{
+    constexpr std::uint32_t g_series_magic   = 0x53584441; ///< "ADXS"
+    constexpr std::uint32_t g_series_version = 1;
+
+    struct series_header
+    {
+        std::uint32_t magic{g_series_magic};
+        std::uint32_t version{g_series_version};
+        std::uint64_t resolution_ms{0};
+        std::uint64_t count{0};
+    };
+
+    struct series_record
+    {
+        std::uint64_t timestamp_ms;
+        double        price;
+    };
+
+    static_assert(sizeof(series_header) == 24);
+    static_assert(sizeof(series_record) == 16);
+
+    bool
+    write_records(std::fstream& ofs, const atomic_dex::price_series& series, std::size_t from)
+    {
+        for (std::size_t idx = from; idx < series.timestamps.size(); ++idx)
+        {
+            const series_record record{.timestamp_ms = series.timestamps[idx], .price = series.prices[idx]};
+            ofs.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+        return ofs.good();
+    }
+
+    bool
+    write_count(std::fstream& ofs, std::uint64_t count)
+    {
+        ofs.seekp(offsetof(series_header, count));
+        ofs.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        ofs.flush();
+        return ofs.good();
+    }
+} // namespace
+
+namespace atomic_dex
+{
+    price_series_cache::price_series_cache(fs::path folder) : m_folder(std::move(folder))
+    {
+    }
+
+    fs::path
+    price_series_cache::get_path(const std::string& coingecko_id, std::uint64_t resolution_ms) const
+    {
+        return m_folder / (coingecko_id + "." + std::to_string(resolution_ms) + ".bin");
+    }
+
+    std::optional<price_series>
+    price_series_cache::load(const std::string& coingecko_id, std::uint64_t resolution_ms) const
+    {
+        namespace bip = boost::interprocess;
+
+        std::scoped_lock lock(m_mutex);
+        const auto       path = get_path(coingecko_id, resolution_ms);
+        fs_error_code    ec;
+        const auto       size = fs::file_size(path, ec);
+        if (ec || size < sizeof(series_header))
+        {
+            return std::nullopt;
+        }
+
+        try
+        {
+            bip::file_mapping  mapping(path.string().c_str(), bip::read_only);
+            bip::mapped_region region(mapping, bip::read_only);
+            const auto*        data = static_cast<const char*>(region.get_address());
+
+            series_header header;
+            std::memcpy(&header, data, sizeof(header));
+            if (header.magic != g_series_magic || header.version != g_series_version || header.resolution_ms != resolution_ms)
+            {
+                return std::nullopt;
+            }
+
+            //! Records past the end of the file are the leftover of an interrupted write.
+            const std::uint64_t nb_records = std::min<std::uint64_t>(header.count, (region.get_size() - sizeof(header)) / sizeof(series_record));
+            price_series        out;
+            out.timestamps.reserve(nb_records);
+            out.prices.reserve(nb_records);
+            for (std::uint64_t idx = 0; idx < nb_records; ++idx)
+            {
+                series_record record;
+                std::memcpy(&record, data + sizeof(header) + idx * sizeof(series_record), sizeof(record));
+                if (!out.timestamps.empty() && record.timestamp_ms <= out.timestamps.back())
+                {
+                    break;
+                }
+                out.timestamps.push_back(record.timestamp_ms);
+                out.prices.push_back(record.price);
+            }
+            return out;
+        }
+        catch (const bip::interprocess_exception& error)
+        {
+            SPDLOG_WARN("Unable to map price series {}: {}", path.string(), error.what());
+            return std::nullopt;
+        }
+    }
+
+    price_series
+    price_series_cache::merge(const std::string& coingecko_id, std::uint64_t resolution_ms, const price_series& fresh)
+    {
+        const auto  bucketed = bucket(fresh, resolution_ms);
+        auto        cached   = load(coingecko_id, resolution_ms);
+        std::size_t kept     = 0;
+        if (cached && !bucketed.timestamps.empty())
+        {
+            kept = std::lower_bound(cached->timestamps.begin(), cached->timestamps.end(), bucketed.timestamps.front()) - cached->timestamps.begin();
+        }
+        else if (cached)
+        {
+            return *cached;
+        }
+
+        price_series merged;
+        merged.timestamps.reserve(kept + bucketed.timestamps.size());
+        merged.prices.reserve(kept + bucketed.prices.size());
+        if (cached)
+        {
+            merged.timestamps.assign(cached->timestamps.begin(), cached->timestamps.begin() + kept);
+            merged.prices.assign(cached->prices.begin(), cached->prices.begin() + kept);
+        }
+        merged.timestamps.insert(merged.timestamps.end(), bucketed.timestamps.begin(), bucketed.timestamps.end());
+        merged.prices.insert(merged.prices.end(), bucketed.prices.begin(), bucketed.prices.end());
+
+        std::scoped_lock lock(m_mutex);
+        const auto       path = get_path(coingecko_id, resolution_ms);
+        if (cached)
+        {
+            //! The count shrinks to the kept prefix before the tail is overwritten, then grows once the new records are on disk.
+            fs_error_code ec;
+            fs::resize_file(path, sizeof(series_header) + kept * sizeof(series_record), ec);
+            std::fstream ofs(path.string(), std::ios::in | std::ios::out | std::ios::binary);
+            if (!ec && ofs.is_open() && write_count(ofs, kept))
+            {
+                ofs.seekp(0, std::ios::end);
+                if (write_records(ofs, merged, kept) && write_count(ofs, merged.timestamps.size()))
+                {
+                    return merged;
+                }
+            }
+            SPDLOG_WARN("Unable to append to price series {}, rewriting it", path.string());
+        }
+
+        //! New file or failed append: the whole series is written next to the target then renamed over it.
+        const auto   tmp_path = fs::path(path).replace_extension(".tmp");
+        std::fstream ofs(tmp_path.string(), std::ios::out | std::ios::trunc | std::ios::binary);
+        series_header header{.resolution_ms = resolution_ms, .count = 0};
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (ofs.good() && write_records(ofs, merged, 0) && write_count(ofs, merged.timestamps.size()))
+        {
+            ofs.close();
+            fs_error_code ec;
+            fs::rename(tmp_path, path, ec);
+            if (ec)
+            {
+                SPDLOG_WARN("Unable to write price series {}: {}", path.string(), ec.message());
+            }
+        }
+        else
+        {
+            SPDLOG_WARN("Unable to write price series {}", tmp_path.string());
+        }
+        return merged;
+    }
+
+    std::optional<price_series>
+    price_series_cache::load_window(const std::string& coingecko_id, std::uint64_t resolution_ms, std::uint64_t window_from_ms) const
+    {
+        auto cached = load(coingecko_id, resolution_ms);
+        if (!cached)
+        {
+            return std::nullopt;
+        }
+        auto out = slice(*cached, window_from_ms);
+        if (out.timestamps.empty())
+        {
+            return std::nullopt;
+        }
+        return out;
+    }
+
+    std::optional<price_series>
+    price_series_cache::fetch_window(
+        const std::string& coingecko_id, std::uint64_t resolution_ms, std::uint64_t window_from_ms, std::uint64_t now_ms, const t_range_fetcher& fetcher)
+    {
+        const auto cached = load(coingecko_id, resolution_ms);
+        const auto from   = cached ? tail_start(*cached, window_from_ms, resolution_ms) : std::nullopt;
+        if (auto fresh = fetcher(from.value_or(window_from_ms), now_ms); fresh && !fresh->timestamps.empty())
+        {
+            return slice(merge(coingecko_id, resolution_ms, *fresh), window_from_ms);
+        }
+        if (cached)
+        {
+            SPDLOG_WARN("Provider unavailable for {}, using the cached price series", coingecko_id);
+            auto out = slice(*cached, window_from_ms);
+            if (!out.timestamps.empty())
+            {
+                return out;
+            }
+        }
+        return std::nullopt;
+    }
+
+    price_series
+    price_series_cache::bucket(const price_series& series, std::uint64_t resolution_ms)
+    {
+        price_series out;
+        if (series.timestamps.empty() || resolution_ms == 0)
+        {
+            return series;
+        }
+
+        std::uint64_t current_bucket = series.timestamps.front() / resolution_ms;
+        out.timestamps.push_back(series.timestamps.front());
+        out.prices.push_back(series.prices.front());
+        for (std::size_t idx = 1; idx < series.timestamps.size(); ++idx)
+        {
+            if (series.timestamps[idx] <= out.timestamps.back())
+            {
+                continue;
+            }
+            const bool is_last = idx + 1 == series.timestamps.size();
+            if (const auto cur = series.timestamps[idx] / resolution_ms; cur != current_bucket || is_last)
+            {
+                current_bucket = cur;
+                out.timestamps.push_back(series.timestamps[idx]);
+                out.prices.push_back(series.prices[idx]);
+            }
+        }
+        return out;
+    }
+
+    price_series
+    price_series_cache::slice(const price_series& series, std::uint64_t from_ms)
+    {
+        const auto   first = std::lower_bound(series.timestamps.begin(), series.timestamps.end(), from_ms) - series.timestamps.begin();
+        price_series out;
+        out.timestamps.assign(series.timestamps.begin() + first, series.timestamps.end());
+        out.prices.assign(series.prices.begin() + first, series.prices.end());
+        return out;
+    }
+
+    std::optional<std::uint64_t>
+    price_series_cache::tail_start(const price_series& cached, std::uint64_t window_from_ms, std::uint64_t resolution_ms)
+    {
+        if (cached.timestamps.empty() || resolution_ms == 0 || cached.timestamps.front() > window_from_ms + resolution_ms)
+        {
+            return std::nullopt;
+        }
+        return (cached.timestamps.back() / resolution_ms) * resolution_ms;
+    }
+} // namespace atomic_dex
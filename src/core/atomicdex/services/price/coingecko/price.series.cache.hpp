@@ -0,0 +1,76 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+
+//! Project Headers
+#include "atomicdex/services/price/coingecko/wallet.valuation.engine.hpp"
+#include "atomicdex/utilities/fs.prerequisites.hpp"
+
+namespace atomic_dex
+{
+    inline constexpr std::uint64_t g_daily_resolution_ms = 24ULL * 60 * 60 * 1000;
+
+    //! Historical prices kept on disk between sessions, one file per coin and resolution: `<coingecko_id>.<resolution_ms>.bin`.
+    //! A file is a fixed header followed by (timestamp_ms, price) records in native byte order, ascending timestamps.
+    //! The header count is written last, a torn write leaves the previous samples readable.
+    class price_series_cache
+    {
+      public:
+        //! Asks the provider for the samples of [from_ms, to_ms], nullopt when the request failed.
+        using t_range_fetcher = std::function<std::optional<price_series>(std::uint64_t from_ms, std::uint64_t to_ms)>;
+
+        explicit price_series_cache(fs::path folder);
+
+        //! Memory maps the file, nullopt when it is missing or not a valid series file.
+        [[nodiscard]] std::optional<price_series> load(const std::string& coingecko_id, std::uint64_t resolution_ms) const;
+
+        //! Keeps the cached samples older than the first fresh one and appends the fresh samples bucketed on `resolution_ms`.
+        //! Only the replaced tail of the file is rewritten. Returns the merged series.
+        price_series merge(const std::string& coingecko_id, std::uint64_t resolution_ms, const price_series& fresh);
+
+        //! Cached samples of the window, used to draw the chart before the provider answers.
+        [[nodiscard]] std::optional<price_series> load_window(const std::string& coingecko_id, std::uint64_t resolution_ms, std::uint64_t window_from_ms) const;
+
+        //! Samples of [window_from_ms, now_ms]: only the range missing from the cache is fetched, then merged into it.
+        //! Falls back on the cached samples when the provider fails, nullopt when there is nothing to show.
+        std::optional<price_series> fetch_window(
+            const std::string& coingecko_id, std::uint64_t resolution_ms, std::uint64_t window_from_ms, std::uint64_t now_ms, const t_range_fetcher& fetcher);
+
+        [[nodiscard]] fs::path get_path(const std::string& coingecko_id, std::uint64_t resolution_ms) const;
+
+        //! First sample of every bucket plus the latest sample, which is the live price of the running bucket.
+        static price_series bucket(const price_series& series, std::uint64_t resolution_ms);
+
+        //! Samples at or after `from_ms`.
+        static price_series slice(const price_series& series, std::uint64_t from_ms);
+
+        //! Start of the range still to fetch, the bucket of the latest cached sample, that bucket is refreshed with the tail.
+        //! nullopt when the cache does not reach back to `window_from_ms` and the whole window has to be fetched.
+        static std::optional<std::uint64_t> tail_start(const price_series& cached, std::uint64_t window_from_ms, std::uint64_t resolution_ms);
+
+      private:
+        fs::path           m_folder;
+        mutable std::mutex m_mutex;
+    };
+} // namespace atomic_dex
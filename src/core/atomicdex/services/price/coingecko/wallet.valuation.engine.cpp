@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+
+//! Deps
+#include <nlohmann/json.hpp>
+
+//! Project Headers
+#include "atomicdex/services/price/coingecko/wallet.valuation.engine.hpp"
+
+namespace atomic_dex
+{
+    price_series
+    price_series::from_json(const nlohmann::json& prices)
+    {
+        price_series out;
+        out.timestamps.reserve(prices.size());
+        out.prices.reserve(prices.size());
+        for (auto&& sample: prices)
+        {
+            if (!sample.is_array() || sample.size() < 2 || !sample[0].is_number() || !sample[1].is_number())
+            {
+                continue;
+            }
+            out.timestamps.push_back(sample[0].get<std::uint64_t>());
+            out.prices.push_back(sample[1].get<double>());
+        }
+        return out;
+    }
+
+    void
+    wallet_valuation_engine::build(const t_price_series_registry& registry)
+    {
+        m_grid.clear();
+        m_tickers.clear();
+        m_columns.clear();
+
+        const auto reference = std::max_element(
+            registry.begin(), registry.end(), [](const auto& lhs, const auto& rhs) { return lhs.second.timestamps.size() < rhs.second.timestamps.size(); });
+        if (reference == registry.end() || reference->second.timestamps.empty())
+        {
+            return;
+        }
+        m_grid = reference->second.timestamps;
+
+        const std::size_t nb_points = m_grid.size();
+        m_tickers.reserve(registry.size());
+        m_columns.reserve(registry.size() * nb_points);
+        for (auto&& [ticker, series]: registry)
+        {
+            if (series.timestamps.empty())
+            {
+                continue;
+            }
+            m_tickers.push_back(ticker);
+            std::size_t sample = 0;
+            for (const auto timestamp: m_grid)
+            {
+                while (sample + 1 < series.timestamps.size() && series.timestamps[sample + 1] <= timestamp) { ++sample; }
+                m_columns.push_back(series.prices[sample]);
+            }
+        }
+    }
+
+    valuation_summary
+    wallet_valuation_engine::evaluate(const t_balances& balances, double rate) const
+    {
+        const std::size_t nb_points = m_grid.size();
+        valuation_summary out;
+        out.totals.assign(nb_points, 0.0);
+        out.timestamps.reserve(nb_points);
+        for (const auto timestamp: m_grid) { out.timestamps.push_back(timestamp / 1000); }
+        if (nb_points == 0)
+        {
+            return out;
+        }
+
+        double* totals = out.totals.data();
+        for (std::size_t coin = 0; coin < m_tickers.size(); ++coin)
+        {
+            const auto it = balances.find(m_tickers[coin]);
+            if (it == balances.end() || it->second == 0)
+            {
+                continue;
+            }
+            const double  weight = it->second * rate;
+            const double* column = m_columns.data() + coin * nb_points;
+            for (std::size_t idx = 0; idx < nb_points; ++idx) { totals[idx] += weight * column[idx]; }
+        }
+
+        double min_total = 0;
+        double max_total = totals[0];
+        for (std::size_t idx = 0; idx < nb_points; ++idx)
+        {
+            max_total = std::max(max_total, totals[idx]);
+            if (totals[idx] > 0 && (min_total == 0 || totals[idx] < min_total))
+            {
+                min_total = totals[idx];
+            }
+        }
+        out.min_total   = min_total;
+        out.max_total   = max_total;
+        out.first_total = totals[0];
+        return out;
+    }
+
+    std::size_t
+    wallet_valuation_engine::nb_coins() const
+    {
+        return m_tickers.size();
+    }
+
+    std::size_t
+    wallet_valuation_engine::nb_points() const
+    {
+        return m_grid.size();
+    }
+} // namespace atomic_dex
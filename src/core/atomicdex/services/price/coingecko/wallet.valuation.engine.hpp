@@ -0,0 +1,74 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//! Deps
+#include <nlohmann/json_fwd.hpp>
+
+namespace atomic_dex
+{
+    //! Price history of one coin, parsed once when the provider answers.
+    struct price_series
+    {
+        std::vector<std::uint64_t> timestamps; ///< milliseconds, ascending
+        std::vector<double>        prices;
+
+        //! coingecko `prices` array: [[timestamp_ms, price], ...]
+        static price_series from_json(const nlohmann::json& prices);
+    };
+
+    using t_price_series_registry = std::unordered_map<std::string, price_series>;
+
+    struct valuation_summary
+    {
+        std::vector<std::uint64_t> timestamps; ///< seconds
+        std::vector<double>        totals;
+        double                     min_total{0}; ///< lowest strictly positive total, 0 when there is none
+        double                     max_total{0};
+        double                     first_total{0};
+    };
+
+    //! Portfolio value over time.
+    //! The prices are stored as one contiguous column of doubles per coin, every column aligned on the same timestamp grid,
+    //! a valuation is then a weighted sum of columns that the compiler vectorizes.
+    class wallet_valuation_engine
+    {
+      public:
+        using t_balances = std::unordered_map<std::string, double>;
+
+        //! The grid is the timestamps of the longest series. Every other series is aligned on it with its latest sample at or before
+        //! the grid point, or its first sample when it starts later.
+        void build(const t_price_series_registry& registry);
+
+        //! `balances` is a snapshot taken once for the whole chart, coins missing from it are worth 0.
+        [[nodiscard]] valuation_summary evaluate(const t_balances& balances, double rate) const;
+
+        [[nodiscard]] std::size_t nb_coins() const;
+        [[nodiscard]] std::size_t nb_points() const;
+
+      private:
+        std::vector<std::uint64_t> m_grid;
+        std::vector<std::string>   m_tickers;
+        std::vector<double>        m_columns; ///< nb_coins columns of nb_points prices
+    };
+} // namespace atomic_dex
@@ -20,6 +20,7 @@
 // Project Headers
 #include "atomicdex/pages/qt.portfolio.page.hpp"
 #include "atomicdex/services/price/coinpaprika/coinpaprika.provider.hpp"
+#include "atomicdex/utilities/http.retry.hpp"
 
 namespace
 {
@@ -107,13 +108,13 @@ namespace atomic_dex
         const TRequest& request, std::string ticker, std::shared_mutex& mtx, std::unordered_map<std::string, TAnswer>& container, TExecutorFunctor&& functor,
         Args... args)
     {
-        const auto answer_functor = [this, &mtx, &container, functor = std::forward<TExecutorFunctor>(functor), request, ticker = std::move(ticker),
-                                     ... args = std::move(args)](web::http::http_response resp) mutable {
-            const auto answer = process_generic_resp<TAnswer>(resp);
+        const auto answer_functor = [this, &mtx, &container, ticker = std::move(ticker), ... args = std::move(args)](web::http::http_response resp) mutable {
+            auto answer = process_generic_resp<TAnswer>(resp);
             if (answer.rpc_result_code == static_cast<web::http::status_code>(antara::app::http_code::too_many_requests))
             {
-                std::this_thread::sleep_for(1s);
-                generic_rpc_paprika_process<TAnswer>(request, std::move(ticker), mtx, container, std::forward<TExecutorFunctor>(functor), std::move(args)...);
+                //! Retries are exhausted, keep the previous answer but still account the task.
+                SPDLOG_WARN("too many requests - retries exhausted for {}", ticker);
+                verify_idx(std::move(args)...);
             }
             else
             {
@@ -121,7 +122,9 @@ namespace atomic_dex
             }
         };
 
-        functor(request).then(answer_functor).then(&handle_exception_pplx_task);
+        retry_http(g_coinpaprika_host, [functor = std::forward<TExecutorFunctor>(functor), request]() { return functor(request); })
+            .then(answer_functor)
+            .then(&handle_exception_pplx_task);
     }
 } // namespace atomic_dex
 
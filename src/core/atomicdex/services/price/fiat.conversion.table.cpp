@@ -0,0 +1,137 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <mutex>
+
+//! Project Headers
+#include "atomicdex/services/price/fiat.conversion.table.hpp"
+
+namespace atomic_dex
+{
+    std::optional<fiat_conversion_entry>
+    fiat_conversion_table::find(const std::string& fiat, const std::string& ticker) const
+    {
+        {
+            std::shared_lock lock(m_mutex);
+            if (const auto fiat_it = m_entries.find(fiat); fiat_it != m_entries.end())
+            {
+                if (const auto it = fiat_it->second.find(ticker); it != fiat_it->second.end())
+                {
+                    m_hits += 1;
+                    return it->second;
+                }
+            }
+        }
+        m_misses += 1;
+        return std::nullopt;
+    }
+
+    void
+    fiat_conversion_table::store(const std::string& fiat, const std::string& ticker, fiat_conversion_entry entry, std::uint64_t generation)
+    {
+        std::unique_lock lock(m_mutex);
+        if (generation != m_generation.load())
+        {
+            m_stale_stores += 1;
+            return;
+        }
+        m_entries[fiat].insert_or_assign(ticker, std::move(entry));
+    }
+
+    std::optional<t_fixed_decimal>
+    fiat_conversion_table::find_total(const std::string& fiat) const
+    {
+        {
+            std::shared_lock lock(m_mutex);
+            if (const auto it = m_totals.find(fiat); it != m_totals.end())
+            {
+                m_total_hits += 1;
+                return it->second;
+            }
+        }
+        m_total_misses += 1;
+        return std::nullopt;
+    }
+
+    void
+    fiat_conversion_table::store_total(const std::string& fiat, const t_fixed_decimal& total, std::uint64_t generation)
+    {
+        std::unique_lock lock(m_mutex);
+        if (generation != m_generation.load())
+        {
+            m_stale_stores += 1;
+            return;
+        }
+        m_totals.insert_or_assign(fiat, total);
+    }
+
+    std::uint64_t
+    fiat_conversion_table::generation() const noexcept
+    {
+        return m_generation.load();
+    }
+
+    void
+    fiat_conversion_table::bump_generation()
+    {
+        m_generation += 1;
+        m_invalidations += 1;
+    }
+
+    void
+    fiat_conversion_table::invalidate_tickers(const std::vector<std::string>& tickers)
+    {
+        std::unique_lock lock(m_mutex);
+        for (auto&& [fiat, entries]: m_entries)
+        {
+            for (auto&& ticker: tickers) { entries.erase(ticker); }
+        }
+        m_totals.clear();
+        bump_generation();
+    }
+
+    void
+    fiat_conversion_table::invalidate_all()
+    {
+        std::unique_lock lock(m_mutex);
+        m_entries.clear();
+        m_totals.clear();
+        bump_generation();
+    }
+
+    void
+    fiat_conversion_table::retain_fiat(const std::string& fiat)
+    {
+        std::unique_lock lock(m_mutex);
+        std::erase_if(m_entries, [&fiat](const auto& cur) { return cur.first != fiat; });
+        std::erase_if(m_totals, [&fiat](const auto& cur) { return cur.first != fiat; });
+        //! Nothing cached is wrong, but what was converted to the previous fiat has to be converted again
+        bump_generation();
+    }
+
+    fiat_conversion_metrics
+    fiat_conversion_table::get_metrics() const
+    {
+        return {
+            .hits          = m_hits.load(),
+            .misses        = m_misses.load(),
+            .total_hits    = m_total_hits.load(),
+            .total_misses  = m_total_misses.load(),
+            .invalidations = m_invalidations.load(),
+            .stale_stores  = m_stale_stores.load()};
+    }
+} // namespace atomic_dex
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//! Project Headers
+#include "atomicdex/utilities/fixed.decimal.hpp"
+
+namespace atomic_dex
+{
+    //! Fiat value of the balance of one coin.
+    struct fiat_conversion_entry
+    {
+        t_fixed_decimal            value;                ///< price * balance
+        std::string                display;              ///< formatted for the given fiat precision
+        bool                       is_zero_price{false}; ///< no price known for this coin
+        std::optional<std::string> out_of_range;         ///< price * balance as a t_float_50 string when it does not fit in value
+    };
+
+    struct fiat_conversion_metrics
+    {
+        std::size_t hits{0};
+        std::size_t misses{0};
+        std::size_t total_hits{0};
+        std::size_t total_misses{0};
+        std::size_t invalidations{0};
+        std::size_t stale_stores{0}; ///< computed values dropped because an invalidation happened meanwhile
+    };
+
+    //! Memoized (ticker, fiat) conversions and per fiat portfolio totals.
+    //! Entries are dropped by the price, balance and currency events instead of being recomputed on every read.
+    //! A value is only stored if no invalidation happened since `generation()` was read before computing it.
+    class fiat_conversion_table
+    {
+      public:
+        [[nodiscard]] std::optional<fiat_conversion_entry> find(const std::string& fiat, const std::string& ticker) const;
+        void store(const std::string& fiat, const std::string& ticker, fiat_conversion_entry entry, std::uint64_t generation);
+
+        [[nodiscard]] std::optional<t_fixed_decimal> find_total(const std::string& fiat) const;
+        void                                         store_total(const std::string& fiat, const t_fixed_decimal& total, std::uint64_t generation);
+
+        [[nodiscard]] std::uint64_t generation() const noexcept;
+
+        void invalidate_tickers(const std::vector<std::string>& tickers); ///< balances changed
+        void invalidate_all();                                            ///< prices or rates changed
+        void retain_fiat(const std::string& fiat);                        ///< current currency changed, other fiats are not displayed anymore
+
+        [[nodiscard]] fiat_conversion_metrics get_metrics() const;
+
+      private:
+        using t_fiat_entries = std::unordered_map<std::string, fiat_conversion_entry>;
+
+        void bump_generation();
+
+        mutable std::shared_mutex                        m_mutex;
+        std::unordered_map<std::string, t_fiat_entries>  m_entries; ///< fiat -> ticker -> entry
+        std::unordered_map<std::string, t_fixed_decimal> m_totals;  ///< fiat -> sum of the enabled coins
+        std::atomic_uint64_t                             m_generation{0};
+
+        mutable std::atomic_size_t m_hits{0};
+        mutable std::atomic_size_t m_misses{0};
+        mutable std::atomic_size_t m_total_hits{0};
+        mutable std::atomic_size_t m_total_misses{0};
+        std::atomic_size_t         m_invalidations{0};
+        std::atomic_size_t         m_stale_stores{0};
+    };
+} // namespace atomic_dex
@@ -20,6 +20,7 @@
 #include "atomicdex/pages/qt.settings.page.hpp"
 #include "atomicdex/services/price/komodo_prices/komodo.prices.provider.hpp"
 #include "atomicdex/services/price/oracle/band.provider.hpp"
+#include "atomicdex/utilities/http.retry.hpp"
 
 namespace
 {
@@ -60,26 +61,20 @@ namespace
 
 namespace
 {
+    //! t_float_50 formatting, for the amounts out of the fixed_decimal range.
     std::string
-    compute_result(const std::string& amount, const std::string& price, const std::string& currency, atomic_dex::cfg& cfg)
+    compute_wide_result(const t_float_50& final_price, std::size_t default_precision)
     {
-        const t_float_50 amount_f(amount);
-        const t_float_50 current_price_f(price);
-        const t_float_50 final_price       = amount_f * current_price_f;
-        std::size_t      default_precision = atomic_dex::is_this_currency_a_fiat(cfg, currency) ? 2 : 8;
-        std::string      result;
-
+        std::string result;
         if (auto final_price_str = final_price.str(default_precision, std::ios_base::fixed); final_price_str == "0.00" && final_price > 0.00000000)
         {
-            const auto retry = [&result, &final_price, &default_precision]() { result = final_price.str(default_precision, std::ios_base::fixed); };
-
             result = final_price.str(default_precision);
             if (result.find("e") != std::string::npos)
             {
                 //! We have scientific notations lets get ride of that
                 do {
                     default_precision += 1;
-                    retry();
+                    result = final_price.str(default_precision, std::ios_base::fixed);
                 } while (t_float_50(result) <= 0);
             }
         }
@@ -87,6 +82,45 @@ namespace
         {
             result = final_price.str(default_precision, std::ios_base::fixed);
         }
+        return result;
+    }
+
+    //! Price times a rate formatted with every decimal, through t_float_50 when it is out of the fixed_decimal range.
+    std::string
+    multiply_price(const t_fixed_decimal& price, const std::string& rate)
+    {
+        if (const auto result = atomic_dex::checked_product(price, rate); result.has_value())
+        {
+            return atomic_dex::utils::format_float(result.value(), t_fixed_decimal::g_scale_digits);
+        }
+        std::string result = (t_float_50(price.str()) * safe_float(rate)).str(t_fixed_decimal::g_scale_digits, std::ios_base::fixed);
+        boost::trim_right_if(result, boost::is_any_of("0"));
+        boost::trim_right_if(result, boost::is_any_of("."));
+        return result;
+    }
+
+    std::string
+    compute_result(const std::string& amount, const std::string& price, const std::string& currency, atomic_dex::cfg& cfg)
+    {
+        int         default_precision = atomic_dex::is_this_currency_a_fiat(cfg, currency) ? 2 : 8;
+        std::string result;
+        if (const auto final_price = atomic_dex::checked_product(amount, price); final_price.has_value())
+        {
+            result = final_price->str(default_precision);
+            if (result == "0.00" && *final_price > 0)
+            {
+                //! Tiny amount, extend the precision up to the first significant digit
+                while (default_precision < t_fixed_decimal::g_scale_digits && t_fixed_decimal::from_string(result).value_or(0).is_zero())
+                {
+                    default_precision += 1;
+                    result = final_price->str(default_precision);
+                }
+            }
+        }
+        else
+        {
+            result = compute_wide_result(safe_float(amount) * safe_float(price), static_cast<std::size_t>(default_precision));
+        }
 
         boost::trim_right_if(result, boost::is_any_of("0"));
         boost::trim_right_if(result, boost::is_any_of("."));
@@ -98,19 +132,11 @@ namespace
 namespace atomic_dex
 {
     void
-    global_price_service::refresh_other_coins_rates(
-        const std::string& quote_id, const std::string& ticker, bool with_update_providers, std::atomic_uint16_t nb_try)
+    global_price_service::refresh_other_coins_rates(const std::string& quote_id, const std::string& ticker, bool with_update_providers)
     {
-        nb_try += 1;
-        SPDLOG_INFO("refresh_other_coins_rates - try {}", nb_try.load());
-        if (nb_try == 10)
-        {
-            SPDLOG_WARN("refresh other coins rates max try reached, skipping");
-            return;
-        }
-        using namespace std::chrono_literals;
+        SPDLOG_INFO("refresh_other_coins_rates - {}", ticker);
         coinpaprika::api::price_converter_request request{.base_currency_id = "usd-us-dollars", .quote_currency_id = quote_id};
-        auto error_functor = [this, quote_id, ticker, with_update_providers, nb_try_load = nb_try.load()](pplx::task<void> previous_task)
+        auto error_functor = [ticker](pplx::task<void> previous_task)
         {
             try
             {
@@ -118,26 +144,21 @@ namespace atomic_dex
             }
             catch (const std::exception& e)
             {
-                SPDLOG_ERROR("pplx task error from refresh_other_coins_rates: {} - nb_try {}", e.what(), nb_try_load);
-                using namespace std::chrono_literals;
-                std::this_thread::sleep_for(1s);
-                this->refresh_other_coins_rates(quote_id, ticker, with_update_providers, nb_try_load);
+                SPDLOG_ERROR("pplx task error from refresh_other_coins_rates: {} - ticker {}, retries exhausted", e.what(), ticker);
             };
         };
-        coinpaprika::api::async_price_converter(request)
+        retry_http(g_coinpaprika_host, [request]() { return coinpaprika::api::async_price_converter(request); })
             .then(
-                [this, quote_id, ticker, with_update_providers, nb_try_cap = nb_try.load()](web::http::http_response resp)
+                [this, ticker, with_update_providers](web::http::http_response resp)
                 {
                     auto answer = coinpaprika::api::process_generic_resp<t_price_converter_answer>(resp);
                     if (answer.rpc_result_code == static_cast<web::http::status_code>(antara::app::http_code::too_many_requests))
                     {
-                        std::this_thread::sleep_for(1s);
-                        SPDLOG_WARN("too many request - retrying");
-                        this->refresh_other_coins_rates(quote_id, ticker, with_update_providers, nb_try_cap);
+                        SPDLOG_WARN("too many request - retries exhausted for {}, skipping", ticker);
                     }
                     else
                     {
-                        SPDLOG_INFO("Successfully get the coinpaprika::api::async_price_converter answer after {} try", nb_try_cap);
+                        SPDLOG_INFO("Successfully get the coinpaprika::api::async_price_converter answer for {}", ticker);
                         if (answer.raw_result.find("error") == std::string::npos)
                         {
                             if (not answer.price.empty())
@@ -151,6 +172,8 @@ namespace atomic_dex
                             std::unique_lock lock(m_coin_rate_mutex);
                             this->m_coin_rate_providers[ticker] = "0.00";
                         }
+                        //! Every conversion to this coin as a currency changed
+                        m_conversion_table.invalidate_all();
                     }
                     if (with_update_providers)
                     {
@@ -165,6 +188,12 @@ namespace atomic_dex
     {
         m_update_clock = std::chrono::high_resolution_clock::now();
         this->dispatcher_.sink<force_update_providers>().connect<&global_price_service::on_force_update_providers>(*this);
+        this->dispatcher_.sink<fiat_rate_updated>().connect<&global_price_service::on_fiat_rate_updated>(*this);
+        this->dispatcher_.sink<band_oracle_refreshed>().connect<&global_price_service::on_band_oracle_refreshed>(*this);
+        this->dispatcher_.sink<ticker_balance_updated>().connect<&global_price_service::on_ticker_balance_updated>(*this);
+        this->dispatcher_.sink<current_currency_changed>().connect<&global_price_service::on_current_currency_changed>(*this);
+        this->dispatcher_.sink<coin_enabled>().connect<&global_price_service::on_coin_enabled>(*this);
+        this->dispatcher_.sink<coin_disabled>().connect<&global_price_service::on_coin_disabled>(*this);
     }
 } // namespace atomic_dex
 
@@ -180,6 +209,10 @@ namespace atomic_dex
         if (s >= 2min)
         {
             SPDLOG_INFO("2min spend - refreshing provider");
+            const auto metrics = m_conversion_table.get_metrics();
+            SPDLOG_INFO(
+                "fiat conversions - hits: {} misses: {} totals hits: {} totals misses: {} invalidations: {}", metrics.hits, metrics.misses,
+                metrics.total_hits, metrics.total_misses, metrics.invalidations);
             this->on_force_update_providers({});
             m_update_clock = std::chrono::high_resolution_clock::now();
         }
@@ -205,21 +238,25 @@ namespace atomic_dex
 
             if (current_price.empty())
             {
-                current_price = provider.get_rate_conversion(ticker);
+                //! Pre-parsed price, the registry entry is neither copied nor formatted before the conversion.
+                const t_fixed_decimal last_price = provider.get_last_price(ticker);
                 if (!is_this_currency_a_fiat(m_cfg, fiat))
                 {
-                    t_float_50 rate(1);
+                    std::string rate;
                     {
                         std::shared_lock lock(m_coin_rate_mutex);
-                        rate = t_float_50(m_coin_rate_providers.at(fiat)); ///< Retrieve BTC or KMD rate let's say for USD
+                        rate = m_coin_rate_providers.at(fiat); ///< Retrieve BTC or KMD rate let's say for USD
                     }
-                    t_float_50 tmp_current_price = t_float_50(current_price) * rate;
-                    current_price                = tmp_current_price.str();
+                    current_price = multiply_price(last_price, rate);
                 }
                 else if (fiat != "USD")
                 {
-                    t_float_50 tmp_current_price = t_float_50(current_price) * m_other_fiats_rates->at("rates").at(fiat).get<double>();
-                    current_price                = tmp_current_price.str();
+                    const auto fiat_rate = t_fixed_decimal::from_double(m_other_fiats_rates->at("rates").at(fiat).get<double>()).value_or(0);
+                    current_price        = multiply_price(last_price, fiat_rate.str(t_fixed_decimal::g_scale_digits));
+                }
+                else
+                {
+                    current_price = utils::format_float(last_price, t_fixed_decimal::g_scale_digits);
                 }
             }
             else
@@ -227,8 +264,8 @@ namespace atomic_dex
                 //! We use oracle
                 if (is_this_currency_a_fiat(m_cfg, fiat) && fiat != "USD")
                 {
-                    t_float_50 tmp_current_price = t_float_50(current_price) * m_other_fiats_rates->at("rates").at(fiat).get<double>();
-                    current_price                = tmp_current_price.str();
+                    const auto fiat_rate = t_fixed_decimal::from_double(m_other_fiats_rates->at("rates").at(fiat).get<double>()).value_or(0);
+                    current_price        = multiply_price(fiat_rate, current_price);
                 }
 
                 else if (!is_this_currency_a_fiat(m_cfg, fiat) && is_oracle_ready)
@@ -281,39 +318,46 @@ namespace atomic_dex
     std::string
     global_price_service::get_price_in_fiat_all(const std::string& fiat, std::error_code& ec) const
     {
-        auto&   mm2_instance = m_system_manager.get_system<mm2_service>();
-        t_coins coins        = mm2_instance.get_enabled_coins();
         try
         {
-            t_float_50        final_price_f = 0;
-            std::string       current_price = "0.00";
-            std::stringstream ss;
-
-            for (auto&& current_coin: coins)
+            const int default_precision = is_this_currency_a_fiat(m_cfg, fiat) ? 2 : 8;
+            if (auto total = m_conversion_table.find_total(fiat); total)
             {
-                current_price = get_price_in_fiat(fiat, current_coin.ticker, ec, true);
+                return utils::format_float(*total, default_precision);
+            }
 
+            auto&       mm2_instance = m_system_manager.get_system<mm2_service>();
+            const auto  generation   = m_conversion_table.generation();
+            const auto  coins        = mm2_instance.get_enabled_coins_view();
+            decimal_sum final_price_f;
+            for (auto&& current_coin: *coins)
+            {
+                const auto conversion = get_fiat_conversion(fiat, current_coin.ticker, ec);
                 if (ec)
                 {
                     // SPDLOG_WARN("error when converting {} to {}, err: {}", current_coin.ticker, fiat, ec.message());
                     ec.clear(); //! Reset
                     continue;
                 }
-
-                if (not current_price.empty())
+                if (conversion && conversion->out_of_range.has_value())
+                {
+                    final_price_f.add(safe_float(*conversion->out_of_range));
+                }
+                else if (conversion)
                 {
-                    const auto current_price_f = t_float_50(current_price);
-                    final_price_f += current_price_f;
+                    final_price_f.add(conversion->value);
                 }
             }
-
-            std::size_t default_precision = is_this_currency_a_fiat(m_cfg, fiat) ? 2 : 8;
-            ss.precision(default_precision);
-            ss << std::fixed << final_price_f;
-            std::string result = ss.str();
-            boost::trim_right_if(result, boost::is_any_of("0"));
-            boost::trim_right_if(result, boost::is_any_of("."));
-            return result;
+            if (final_price_f.is_wide())
+            {
+                //! Out of the fixed_decimal range, not memoized
+                std::string result = final_price_f.str(default_precision);
+                boost::trim_right_if(result, boost::is_any_of("0"));
+                boost::trim_right_if(result, boost::is_any_of("."));
+                return result;
+            }
+            m_conversion_table.store_total(fiat, final_price_f.fixed(), generation);
+            return utils::format_float(final_price_f.fixed(), default_precision);
         }
         catch (const std::exception& error)
         {
@@ -346,49 +390,66 @@ namespace atomic_dex
         }
     }
 
-    std::string
-    global_price_service::get_price_in_fiat(const std::string& fiat, const std::string& ticker, std::error_code& ec, bool skip_precision) const
+    std::optional<fiat_conversion_entry>
+    global_price_service::get_fiat_conversion(const std::string& fiat, const std::string& ticker, std::error_code& ec) const
     {
-        try
+        if (m_supported_fiat_registry.count(fiat) == 0u)
         {
-            auto& mm2_instance = m_system_manager.get_system<mm2_service>();
-
-            if (m_supported_fiat_registry.count(fiat) == 0u)
-            {
-                ec = dextop_error::invalid_fiat_for_rate_conversion;
-                return "0.00";
-            }
+            ec = dextop_error::invalid_fiat_for_rate_conversion;
+            return std::nullopt;
+        }
+        if (auto cached = m_conversion_table.find(fiat, ticker); cached)
+        {
+            return cached;
+        }
 
-            const auto price = get_rate_conversion(fiat, ticker);
+        //! Read before computing, a price or balance event received meanwhile discards the result instead of caching a stale value.
+        const auto generation = m_conversion_table.generation();
+        const auto price      = get_rate_conversion(fiat, ticker);
+        if (price == "0.00")
+        {
+            fiat_conversion_entry entry{.value = t_fixed_decimal{}, .display = "0.00", .is_zero_price = true};
+            m_conversion_table.store(fiat, ticker, entry, generation);
+            return entry;
+        }
 
-            if (price == "0.00")
-            {
-                return "0.00";
-            }
+        std::error_code t_ec;
+        const auto      amount = m_system_manager.get_system<mm2_service>().my_balance(ticker, t_ec);
+        if (t_ec)
+        {
+            ec = t_ec;
+            //SPDLOG_ERROR("my_balance error: {} {}", t_ec.message(), ticker);
+            return std::nullopt;
+        }
 
-            std::error_code t_ec;
-            const auto      amount = mm2_instance.my_balance(ticker, t_ec);
+        fiat_conversion_entry entry{.display = compute_result(amount, price, fiat, this->m_cfg)};
+        if (auto value = checked_product(price, amount); value.has_value())
+        {
+            entry.value = value.value();
+        }
+        else
+        {
+            entry.out_of_range = (safe_float(price) * safe_float(amount)).str(t_fixed_decimal::g_scale_digits, std::ios_base::fixed);
+        }
+        m_conversion_table.store(fiat, ticker, entry, generation);
+        return entry;
+    }
 
-            if (t_ec)
+    std::string
+    global_price_service::get_price_in_fiat(const std::string& fiat, const std::string& ticker, std::error_code& ec, bool skip_precision) const
+    {
+        try
+        {
+            const auto conversion = get_fiat_conversion(fiat, ticker, ec);
+            if (!conversion || conversion->is_zero_price)
             {
-                ec = t_ec;
-                //SPDLOG_ERROR("my_balance error: {} {}", t_ec.message(), ticker);
                 return "0.00";
             }
-
-            if (not skip_precision)
+            if (skip_precision && conversion->out_of_range.has_value())
             {
-                return compute_result(amount, price, fiat, this->m_cfg);
+                return safe_float(*conversion->out_of_range).str(6, std::ios_base::fixed);
             }
-
-            const t_float_50  price_f(price);
-            const t_float_50  amount_f(amount);
-            const t_float_50  final_price = price_f * amount_f;
-            std::stringstream ss;
-
-            ss << std::fixed << final_price;
-
-            return ss.str() == "0" ? "0.00" : ss.str();
+            return skip_precision ? conversion->value.str(6) : conversion->display; ///< same output as streaming with std::fixed
         }
         catch (const std::exception& error)
         {
@@ -405,18 +466,32 @@ namespace atomic_dex
             const std::string base_rate_str = get_rate_conversion("USD", base, false);
             const std::string rel_rate_str  = get_rate_conversion("USD", rel, false);
 
-            if (safe_float(rel_rate_str) <= 0 || safe_float(base_rate_str) <= 0)
+            const auto base_rate_f = t_fixed_decimal::from_string(base_rate_str);
+            const auto rel_rate_f  = t_fixed_decimal::from_string(rel_rate_str);
+            if (base_rate_f.has_value() && rel_rate_f.has_value())
             {
-                return "0.00";
+                if (*rel_rate_f <= 0 || *base_rate_f <= 0)
+                {
+                    return "0.00";
+                }
+                try
+                {
+                    return utils::format_float(*base_rate_f / *rel_rate_f);
+                }
+                catch (const std::overflow_error&)
+                {
+                    //! The quotient is out of the fixed_decimal range, computed again below with t_float_50
+                }
             }
 
-            t_float_50  base_rate_f(base_rate_str);
-            t_float_50  rel_rate_f(rel_rate_str);
-            t_float_50  result     = base_rate_f / rel_rate_f;
-            std::string result_str = result.str(8, std::ios_base::fixed);
-            boost::trim_right_if(result_str, boost::is_any_of("0"));
-            boost::trim_right_if(result_str, boost::is_any_of("."));
-            return result_str;
+            //! Out of the fixed_decimal range
+            const t_float_50 base_rate_wide = safe_float(base_rate_str);
+            const t_float_50 rel_rate_wide  = safe_float(rel_rate_str);
+            if (rel_rate_wide <= 0 || base_rate_wide <= 0)
+            {
+                return "0.00";
+            }
+            return utils::format_float(base_rate_wide / rel_rate_wide);
         }
         catch (const std::exception& error)
         {
@@ -428,10 +503,8 @@ namespace atomic_dex
     void
     global_price_service::on_force_update_providers([[maybe_unused]] const force_update_providers& evt)
     {
-        static std::atomic_size_t nb_try = 0;
-        nb_try += 1;
         SPDLOG_INFO("Forcing update providers");
-        auto error_functor = [this, evt](pplx::task<void> previous_task)
+        auto error_functor = [](pplx::task<void> previous_task)
         {
             try
             {
@@ -439,17 +512,16 @@ namespace atomic_dex
             }
             catch (const std::exception& e)
             {
-                SPDLOG_ERROR("pplx task error from async_fetch_fiat_rates: {} - nb_try {}", e.what(), nb_try);
-                using namespace std::chrono_literals;
-                std::this_thread::sleep_for(1s);
-                this->on_force_update_providers(evt);
+                //! Retries are exhausted, the next periodic update tries again.
+                SPDLOG_ERROR("pplx task error from async_fetch_fiat_rates: {}", e.what());
             };
         };
-        async_fetch_fiat_rates()
+        retry_http(g_komodo_rates_host, []() { return async_fetch_fiat_rates(); })
             .then(
                 [this](web::http::http_response resp)
                 {
                     this->m_other_fiats_rates = process_fetch_fiat_answer(resp);
+                    m_conversion_table.invalidate_all();
                     const auto& mm2           = this->m_system_manager.get_system<mm2_service>();
                     const bool  with_update   = mm2.is_mm2_running();
                     bool        already_send  = false;
@@ -457,24 +529,71 @@ namespace atomic_dex
                     const auto  second_id     = mm2.get_coin_info(g_second_primary_dex_coin).coinpaprika_id;
                     if (!first_id.empty())
                     {
-                        refresh_other_coins_rates(first_id, g_primary_dex_coin, false, 0);
+                        refresh_other_coins_rates(first_id, g_primary_dex_coin, false);
                     }
                     if (!second_id.empty())
                     {
-                        refresh_other_coins_rates(second_id, g_second_primary_dex_coin, with_update, 0);
+                        refresh_other_coins_rates(second_id, g_second_primary_dex_coin, with_update);
                         already_send = true;
                     }
                     if (g_primary_dex_coin != "BTC" && g_second_primary_dex_coin != "BTC")
                     {
                         const auto third_id = mm2.get_coin_info("BTC").coinpaprika_id;
-                        refresh_other_coins_rates(third_id, "BTC", !already_send, 0);
+                        refresh_other_coins_rates(third_id, "BTC", !already_send);
                     }
-                    SPDLOG_INFO("Successfully retrieving rate after {} try", nb_try);
-                    nb_try = 0;
+                    SPDLOG_INFO("Successfully retrieving fiat rates");
                 })
             .then(error_functor);
     }
 
+    void
+    global_price_service::on_fiat_rate_updated([[maybe_unused]] const fiat_rate_updated& evt)
+    {
+        m_conversion_table.invalidate_all();
+    }
+
+    void
+    global_price_service::on_band_oracle_refreshed([[maybe_unused]] const band_oracle_refreshed& evt)
+    {
+        m_conversion_table.invalidate_all();
+    }
+
+    void
+    global_price_service::on_ticker_balance_updated(const ticker_balance_updated& evt)
+    {
+        m_conversion_table.invalidate_tickers(evt.tickers);
+    }
+
+    void
+    global_price_service::on_current_currency_changed([[maybe_unused]] const current_currency_changed& evt)
+    {
+        m_conversion_table.retain_fiat(m_cfg.current_currency);
+    }
+
+    void
+    global_price_service::on_coin_enabled(const coin_enabled& evt)
+    {
+        m_conversion_table.invalidate_tickers(evt.tickers);
+    }
+
+    void
+    global_price_service::on_coin_disabled(const coin_disabled& evt)
+    {
+        m_conversion_table.invalidate_tickers({evt.ticker});
+    }
+
+    fiat_conversion_metrics
+    global_price_service::get_conversion_metrics() const
+    {
+        return m_conversion_table.get_metrics();
+    }
+
+    std::uint64_t
+    global_price_service::get_conversion_generation() const noexcept
+    {
+        return m_conversion_table.generation();
+    }
+
     std::string
     global_price_service::get_fiat_rates(const std::string& fiat) const
     {
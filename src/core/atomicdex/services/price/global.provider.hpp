@@ -21,6 +21,7 @@
 
 #include "atomicdex/config/app.cfg.hpp"
 #include "atomicdex/services/mm2/mm2.service.hpp"
+#include "atomicdex/services/price/fiat.conversion.table.hpp"
 
 namespace atomic_dex
 {
@@ -31,17 +32,19 @@ namespace atomic_dex
         using t_providers_registry      = std::unordered_map<std::string, std::string>;
         using t_update_time_point       = std::chrono::high_resolution_clock::time_point;
 
-        ag::ecs::system_manager&  m_system_manager;
-        atomic_dex::cfg&          m_cfg;
-        t_supported_fiat_registry m_supported_fiat_registry{"USD", "EUR", "BTC", "KMD", "GBP", "HKD", "IDR", "ILS", "DKK", "INR", "CHF", "MXN",
-                                                            "CZK", "SGD", "THB", "HRK", "MYR", "NOK", "CNY", "BGN", "PHP", "PLN", "ZAR", "CAD",
-                                                            "ISK", "BRL", "RON", "NZD", "TRY", "JPY", "RUB", "KRW", "AUD", "HUF", "SEK", "LTC", "DOGE"};
-        t_providers_registry      m_coin_rate_providers{};
-        t_json_synchronized       m_other_fiats_rates;
-        t_update_time_point       m_update_clock;
-        mutable std::shared_mutex m_coin_rate_mutex;
+        ag::ecs::system_manager&      m_system_manager;
+        atomic_dex::cfg&              m_cfg;
+        t_supported_fiat_registry     m_supported_fiat_registry{"USD", "EUR", "BTC", "KMD", "GBP", "HKD", "IDR", "ILS", "DKK", "INR", "CHF", "MXN",
+                                                                "CZK", "SGD", "THB", "HRK", "MYR", "NOK", "CNY", "BGN", "PHP", "PLN", "ZAR", "CAD",
+                                                                "ISK", "BRL", "RON", "NZD", "TRY", "JPY", "RUB", "KRW", "AUD", "HUF", "SEK", "LTC", "DOGE"};
+        t_providers_registry          m_coin_rate_providers{};
+        t_json_synchronized           m_other_fiats_rates;
+        t_update_time_point           m_update_clock;
+        mutable std::shared_mutex     m_coin_rate_mutex;
+        mutable fiat_conversion_table m_conversion_table;
 
-        void refresh_other_coins_rates(const std::string& quote_id, const std::string& ticker, bool with_update_providers = false, std::atomic_uint16_t idx = 0);
+        void                                 refresh_other_coins_rates(const std::string& quote_id, const std::string& ticker, bool with_update_providers = false);
+        std::optional<fiat_conversion_entry> get_fiat_conversion(const std::string& fiat, const std::string& ticker, std::error_code& ec) const;
 
       public:
         explicit global_price_service(entt::registry& registry, ag::ecs::system_manager& system_manager, atomic_dex::cfg& cfg);
@@ -62,8 +65,19 @@ namespace atomic_dex
         bool is_fiat_available(const std::string& fiat) const;
         bool is_currency_available(const std::string& currency) const;
 
+        [[nodiscard]] fiat_conversion_metrics get_conversion_metrics() const;
+
+        //! Moves every time a rate, a balance or the current fiat changes, values converted before are stale.
+        [[nodiscard]] std::uint64_t get_conversion_generation() const noexcept;
+
         //! Events
         void on_force_update_providers([[maybe_unused]] const force_update_providers& evt);
+        void on_fiat_rate_updated(const fiat_rate_updated& evt);
+        void on_band_oracle_refreshed([[maybe_unused]] const band_oracle_refreshed& evt);
+        void on_ticker_balance_updated(const ticker_balance_updated& evt);
+        void on_current_currency_changed([[maybe_unused]] const current_currency_changed& evt);
+        void on_coin_enabled(const coin_enabled& evt);
+        void on_coin_disabled(const coin_disabled& evt);
     };
 } // namespace atomic_dex
 
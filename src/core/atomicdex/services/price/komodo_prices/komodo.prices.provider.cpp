@@ -1,3 +1,6 @@
+//! STD
+#include <cmath>
+
 //! Deps
 #include <nlohmann/json.hpp>
 
@@ -20,15 +23,6 @@ namespace atomic_dex
 //! Private functions
 namespace atomic_dex
 {
-    komodo_prices::api::komodo_ticker_infos
-    komodo_prices_provider::get_info_answer(const std::string& ticker) const
-    {
-        std::shared_lock lock(m_market_mutex);
-        // SPDLOG_INFO("Looking for ticker: {}", ticker);
-        const auto it = m_market_registry.find(ticker);
-        return it != m_market_registry.cend() ? it->second : komodo_prices::api::komodo_ticker_infos{.ticker = ticker};
-    }
-
     void
     komodo_prices_provider::process_update(bool fallback)
     {
@@ -39,13 +33,15 @@ namespace atomic_dex
             std::string body = TO_STD_STR(resp.extract_string(true).get());
             if (resp.status_code() == 200)
             {
-                nlohmann::json    j = nlohmann::json::parse(body);
-                t_market_registry answer;
-                answer = j.get<t_market_registry>();
+                std::string error;
+                if (auto answer = komodo_prices_snapshot::parse(body, &error); answer)
                 {
-                    std::unique_lock lock(m_market_mutex);
-                    m_market_registry = std::move(answer);
-                    SPDLOG_INFO("komodo price registry size: {}", m_market_registry.size());
+                    SPDLOG_INFO("komodo price registry size: {}", answer->size());
+                    m_market_registry.publish(std::move(*answer));
+                }
+                else
+                {
+                    SPDLOG_ERROR("Unable to parse komodo price provider answer: {}", error);
                 }
             }
             else
@@ -98,19 +94,38 @@ namespace atomic_dex
         }
     }
 
+    komodo_prices_provider::t_snapshot
+    komodo_prices_provider::get_snapshot() const noexcept
+    {
+        return m_market_registry.snapshot();
+    }
+
     std::string
     komodo_prices_provider::get_total_volume(const std::string& ticker) const
     {
-        return get_info_answer(ticker).volume24_h;
+        const auto  snapshot = m_market_registry.snapshot();
+        const auto* entry    = snapshot->find(ticker);
+        return entry != nullptr ? utils::format_float(entry->volume_24h, t_fixed_decimal::g_scale_digits) : "0.00";
     }
 
     nlohmann::json
     komodo_prices_provider::get_ticker_historical(const std::string& ticker) const
     {
-        nlohmann::json j = get_info_answer(ticker).sparkline_7_d;
-        if (j.is_null())
+        nlohmann::json j        = nlohmann::json::array();
+        const auto     snapshot = m_market_registry.snapshot();
+        if (const auto* entry = snapshot->find(ticker); entry != nullptr)
         {
-            j = nlohmann::json::array();
+            for (const double sample: snapshot->sparkline(*entry))
+            {
+                if (std::isnan(sample))
+                {
+                    j.push_back(nullptr);
+                }
+                else
+                {
+                    j.push_back(sample);
+                }
+            }
         }
         return j;
     }
@@ -118,20 +133,33 @@ namespace atomic_dex
     std::string
     komodo_prices_provider::get_change_24h(const std::string& ticker) const
     {
-        return get_info_answer(ticker).change_24_h;
+        const auto  snapshot = m_market_registry.snapshot();
+        const auto* entry    = snapshot->find(ticker);
+        return entry != nullptr ? utils::format_float(entry->change_24h, t_fixed_decimal::g_scale_digits) : "0.00";
     }
 
     std::string
     komodo_prices_provider::get_rate_conversion(const std::string& ticker) const
     {
-        return get_info_answer(ticker).last_price;
+        const auto  snapshot = m_market_registry.snapshot();
+        const auto* entry    = snapshot->find(ticker);
+        return entry != nullptr ? utils::format_float(entry->last_price, t_fixed_decimal::g_scale_digits) : "0.00";
+    }
+
+    t_fixed_decimal
+    komodo_prices_provider::get_last_price(const std::string& ticker) const
+    {
+        const auto  snapshot = m_market_registry.snapshot();
+        const auto* entry    = snapshot->find(ticker);
+        return entry != nullptr ? entry->last_price : t_fixed_decimal{};
     }
 
     std::string
     komodo_prices_provider::get_price_provider(const std::string& ticker) const
     {
-        auto provider = get_info_answer(utils::retrieve_main_ticker(ticker)).price_provider;
-        switch (provider)
+        const auto  snapshot = m_market_registry.snapshot();
+        const auto* entry    = snapshot->find(utils::retrieve_main_ticker(ticker));
+        switch (entry != nullptr ? entry->price_provider : komodo_prices::api::provider::unknown)
         {
         case komodo_prices::api::provider::binance:
             return "binance";
@@ -151,6 +179,8 @@ namespace atomic_dex
     int64_t
     komodo_prices_provider::get_last_price_timestamp(const std::string& ticker) const
     {
-        return get_info_answer(ticker).last_updated_timestamp;
+        const auto  snapshot = m_market_registry.snapshot();
+        const auto* entry    = snapshot->find(ticker);
+        return entry != nullptr ? entry->last_updated_timestamp : 0;
     }
 } // namespace atomic_dex
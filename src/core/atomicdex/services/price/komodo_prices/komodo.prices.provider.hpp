@@ -1,32 +1,31 @@
 #pragma once
 
-//! STD
-#include <shared_mutex>
-
 //! Deps
 #include <antara/gaming/ecs/system.manager.hpp>
 
 //! Project Headers
 #include "atomicdex/api/komodo_prices/komodo.prices.hpp"
+#include "atomicdex/services/price/komodo_prices/komodo.prices.registry.hpp"
+#include "atomicdex/utilities/rcu.registry.hpp"
 
 namespace atomic_dex
 {
     class komodo_prices_provider final : public ag::ecs::pre_update_system<komodo_prices_provider>
     {
         //! private type definition
-        using t_market_registry          = komodo_prices::api::t_komodo_tickers_price_registry;
+        using t_market_registry          = rcu_registry<komodo_prices_snapshot>;
         using t_komodo_prices_time_point = std::chrono::high_resolution_clock::time_point;
 
         //! private fields
         t_market_registry          m_market_registry;
-        mutable std::shared_mutex  m_market_mutex;
         t_komodo_prices_time_point m_clock;
 
         //! private functions
-        void                                    process_update(bool fallback = false);
-        komodo_prices::api::komodo_ticker_infos get_info_answer(const std::string& ticker) const;
+        void process_update(bool fallback = false);
 
       public:
+        using t_snapshot = t_market_registry::t_snapshot;
+
         //! Constructor
         komodo_prices_provider(entt::registry& registry);
 
@@ -36,9 +35,14 @@ namespace atomic_dex
         //! Override ag::system functions
         void update() final;
 
+        //! Current registry, to read several tickers or fields from the same answer without copying them.
+        [[nodiscard]] t_snapshot get_snapshot() const noexcept;
+
         //! Get the rate conversion for the given ticker.
         [[nodiscard]] std::string get_rate_conversion(const std::string& ticker) const;
-        ;
+
+        //! Get the last price in USD for the given ticker, 0 when it is unknown.
+        [[nodiscard]] t_fixed_decimal get_last_price(const std::string& ticker) const;
 
         //! Get the ticker informations.
         [[nodiscard]] std::string get_change_24h(const std::string& ticker) const;
@@ -0,0 +1,326 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <cmath>
+#include <limits>
+
+//! Deps
+#include <nlohmann/json.hpp>
+
+//! Project Headers
+#include "atomicdex/services/price/komodo_prices/komodo.prices.registry.hpp"
+
+namespace atomic_dex
+{
+    //! SAX handler for {"<ticker>": {"last_price": "...", "sparkline_7d": [...], ...}, ...}.
+    //! Fields are written straight into the snapshot, no dom and no per ticker string is built.
+    class komodo_prices_sax final : public nlohmann::json_sax<nlohmann::json>
+    {
+      public:
+        explicit komodo_prices_sax(komodo_prices_snapshot& snapshot) : m_snapshot(snapshot) {}
+
+        bool
+        null() override
+        {
+            if (m_depth == 3 && m_field == field::sparkline)
+            {
+                push_sample(std::numeric_limits<double>::quiet_NaN());
+            }
+            return true;
+        }
+
+        bool
+        boolean([[maybe_unused]] bool val) override
+        {
+            return true;
+        }
+
+        bool
+        number_integer(number_integer_t val) override
+        {
+            return on_number(static_cast<double>(val), val);
+        }
+
+        bool
+        number_unsigned(number_unsigned_t val) override
+        {
+            return on_number(static_cast<double>(val), static_cast<std::int64_t>(val));
+        }
+
+        bool
+        number_float(number_float_t val, [[maybe_unused]] const string_t& s) override
+        {
+            const bool is_integral = std::isfinite(val) && std::fabs(val) < 9e18;
+            return on_number(val, is_integral ? static_cast<std::int64_t>(val) : 0);
+        }
+
+        bool
+        string(string_t& val) override
+        {
+            if (m_depth != 2)
+            {
+                return true;
+            }
+            switch (m_field)
+            {
+            case field::last_price:
+                current().last_price = t_fixed_decimal::from_string(val).value_or(t_fixed_decimal{});
+                break;
+            case field::volume_24h:
+                current().volume_24h = t_fixed_decimal::from_string(val).value_or(t_fixed_decimal{});
+                break;
+            case field::change_24h:
+                current().change_24h = t_fixed_decimal::from_string(val).value_or(t_fixed_decimal{});
+                break;
+            case field::price_provider:
+                current().price_provider = komodo_prices::api::provider_from_string(val);
+                break;
+            default:
+                break;
+            }
+            return true;
+        }
+
+        bool
+        binary([[maybe_unused]] binary_t& val) override
+        {
+            return true;
+        }
+
+        bool
+        start_object([[maybe_unused]] std::size_t elements) override
+        {
+            m_depth += 1;
+            if (m_depth == 1)
+            {
+                m_is_object = true;
+            }
+            else if (m_depth == 2)
+            {
+                komodo_price_entry entry;
+                entry.ticker_offset = static_cast<std::uint32_t>(m_snapshot.m_tickers.size());
+                entry.ticker_size   = static_cast<std::uint32_t>(m_key.size());
+                m_snapshot.m_tickers.insert(m_snapshot.m_tickers.end(), m_key.begin(), m_key.end());
+                m_snapshot.m_entries.push_back(entry);
+            }
+            return true;
+        }
+
+        bool
+        key(string_t& val) override
+        {
+            if (m_depth == 1)
+            {
+                m_key = std::move(val);
+            }
+            else if (m_depth == 2)
+            {
+                m_field = field_from_key(val);
+            }
+            return true;
+        }
+
+        bool
+        end_object() override
+        {
+            m_depth -= 1;
+            return true;
+        }
+
+        bool
+        start_array([[maybe_unused]] std::size_t elements) override
+        {
+            m_depth += 1;
+            if (m_depth == 1)
+            {
+                m_error = "komodo prices answer is not a json object";
+                return false;
+            }
+            if (m_depth == 3 && m_field == field::sparkline)
+            {
+                current().sparkline_offset = static_cast<std::uint32_t>(m_snapshot.m_sparklines.size());
+            }
+            return true;
+        }
+
+        bool
+        end_array() override
+        {
+            m_depth -= 1;
+            return true;
+        }
+
+        bool
+        parse_error([[maybe_unused]] std::size_t position, [[maybe_unused]] const std::string& last_token, const nlohmann::detail::exception& ex) override
+        {
+            m_error = ex.what();
+            return false;
+        }
+
+        [[nodiscard]] const std::string&
+        error() const
+        {
+            return m_error;
+        }
+
+        [[nodiscard]] bool
+        is_object() const
+        {
+            return m_is_object;
+        }
+
+      private:
+        enum class field
+        {
+            last_price,
+            volume_24h,
+            change_24h,
+            price_provider,
+            last_updated_timestamp,
+            sparkline,
+            other
+        };
+
+        static field
+        field_from_key(std::string_view key) noexcept
+        {
+            if (key == "last_price")
+            {
+                return field::last_price;
+            }
+            if (key == "volume24h")
+            {
+                return field::volume_24h;
+            }
+            if (key == "change_24h")
+            {
+                return field::change_24h;
+            }
+            if (key == "price_provider")
+            {
+                return field::price_provider;
+            }
+            if (key == "last_updated_timestamp")
+            {
+                return field::last_updated_timestamp;
+            }
+            if (key == "sparkline_7d")
+            {
+                return field::sparkline;
+            }
+            return field::other;
+        }
+
+        komodo_price_entry&
+        current()
+        {
+            return m_snapshot.m_entries.back();
+        }
+
+        void
+        push_sample(double sample)
+        {
+            m_snapshot.m_sparklines.push_back(sample);
+            current().sparkline_size += 1;
+        }
+
+        bool
+        on_number(double val, std::int64_t integer)
+        {
+            if (m_depth == 3 && m_field == field::sparkline)
+            {
+                push_sample(val);
+            }
+            else if (m_depth == 2)
+            {
+                switch (m_field)
+                {
+                case field::last_price:
+                    current().last_price = t_fixed_decimal::from_double(val).value_or(t_fixed_decimal{});
+                    break;
+                case field::volume_24h:
+                    current().volume_24h = t_fixed_decimal::from_double(val).value_or(t_fixed_decimal{});
+                    break;
+                case field::change_24h:
+                    current().change_24h = t_fixed_decimal::from_double(val).value_or(t_fixed_decimal{});
+                    break;
+                case field::last_updated_timestamp:
+                    current().last_updated_timestamp = integer;
+                    break;
+                default:
+                    break;
+                }
+            }
+            return true;
+        }
+
+        komodo_prices_snapshot& m_snapshot;
+        std::size_t             m_depth{0};
+        std::string             m_key;
+        field                   m_field{field::other};
+        std::string             m_error;
+        bool                    m_is_object{false};
+    };
+
+    std::optional<komodo_prices_snapshot>
+    komodo_prices_snapshot::parse(std::string_view body, std::string* error)
+    {
+        komodo_prices_snapshot snapshot;
+        komodo_prices_sax      handler(snapshot);
+        if (!nlohmann::json::sax_parse(body, &handler) || !handler.is_object())
+        {
+            if (error != nullptr)
+            {
+                *error = handler.error().empty() ? "komodo prices answer is not a json object" : handler.error();
+            }
+            return std::nullopt;
+        }
+
+        //! The ticker buffer does not move anymore, the index can point into it.
+        snapshot.m_index.reserve(snapshot.m_entries.size());
+        for (std::uint32_t idx = 0; idx < snapshot.m_entries.size(); ++idx)
+        {
+            snapshot.m_index.insert_or_assign(snapshot.ticker(snapshot.m_entries[idx]), idx);
+        }
+        return snapshot;
+    }
+
+    const komodo_price_entry*
+    komodo_prices_snapshot::find(std::string_view ticker) const noexcept
+    {
+        const auto it = m_index.find(ticker);
+        return it != m_index.end() ? &m_entries[it->second] : nullptr;
+    }
+
+    std::string_view
+    komodo_prices_snapshot::ticker(const komodo_price_entry& entry) const noexcept
+    {
+        return {m_tickers.data() + entry.ticker_offset, entry.ticker_size};
+    }
+
+    std::span<const double>
+    komodo_prices_snapshot::sparkline(const komodo_price_entry& entry) const noexcept
+    {
+        return {m_sparklines.data() + entry.sparkline_offset, entry.sparkline_size};
+    }
+
+    std::size_t
+    komodo_prices_snapshot::size() const noexcept
+    {
+        return m_index.size();
+    }
+} // namespace atomic_dex
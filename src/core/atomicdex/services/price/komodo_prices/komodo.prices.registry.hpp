@@ -0,0 +1,76 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//! Project Headers
+#include "atomicdex/api/komodo_prices/komodo.prices.hpp"
+#include "atomicdex/utilities/fixed.decimal.hpp"
+
+namespace atomic_dex
+{
+    //! One ticker of the komodo prices answer, numbers are parsed once when the answer is received.
+    struct komodo_price_entry
+    {
+        t_fixed_decimal                last_price;
+        t_fixed_decimal                volume_24h;
+        t_fixed_decimal                change_24h;
+        std::int64_t                   last_updated_timestamp{0};
+        komodo_prices::api::provider   price_provider{komodo_prices::api::provider::unknown};
+        std::uint32_t                  ticker_offset{0};
+        std::uint32_t                  ticker_size{0};
+        std::uint32_t                  sparkline_offset{0};
+        std::uint32_t                  sparkline_size{0};
+    };
+
+    //! Immutable registry built from one komodo prices answer.
+    //! Tickers are interned in a single buffer, the 7 days sparklines of every ticker share one array of doubles
+    //! (a null sample of the answer is stored as NaN). Views returned by the lookups live as long as the snapshot.
+    class komodo_prices_snapshot
+    {
+      public:
+        komodo_prices_snapshot() = default;
+        komodo_prices_snapshot(komodo_prices_snapshot&& other) noexcept = default;
+        komodo_prices_snapshot& operator=(komodo_prices_snapshot&& other) noexcept = default;
+        komodo_prices_snapshot(const komodo_prices_snapshot& other)                 = delete; ///< the index points into m_tickers
+        komodo_prices_snapshot& operator=(const komodo_prices_snapshot& other) = delete;
+
+        //! Streams the answer of /api/v2/tickers, nullopt when it is not a valid json object.
+        static std::optional<komodo_prices_snapshot> parse(std::string_view body, std::string* error = nullptr);
+
+        [[nodiscard]] const komodo_price_entry* find(std::string_view ticker) const noexcept;
+        [[nodiscard]] std::string_view         ticker(const komodo_price_entry& entry) const noexcept;
+        [[nodiscard]] std::span<const double>  sparkline(const komodo_price_entry& entry) const noexcept;
+        [[nodiscard]] std::size_t              size() const noexcept;
+
+      private:
+        friend class komodo_prices_sax;
+
+        std::vector<komodo_price_entry>                      m_entries;
+        std::vector<char>                                    m_tickers;
+        std::vector<double>                                  m_sparklines;
+        std::unordered_map<std::string_view, std::uint32_t> m_index;
+    };
+} // namespace atomic_dex
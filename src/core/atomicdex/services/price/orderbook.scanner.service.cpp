@@ -69,7 +69,7 @@ namespace atomic_dex
                 this->m_rpc_busy = true;
                 emit trading_pg.get_orderbook_wrapper()->bestOrdersBusyChanged();
                 //! Treat answer
-                auto answer_functor = [this, &trading_pg](web::http::http_response resp) {
+                auto decode_functor = [this, &trading_pg](const web::http::http_response& resp) {
                     std::string body = TO_STD_STR(resp.extract_string(true).get());
                     if (resp.status_code() == 200)
                     {
@@ -84,6 +84,17 @@ namespace atomic_dex
                     this->dispatcher_.trigger<process_orderbook_finished>(false);
                     emit trading_pg.get_orderbook_wrapper()->bestOrdersBusyChanged();
                 };
+                auto dropped_functor = [this, &trading_pg]() {
+                    this->m_rpc_busy = false;
+                    emit trading_pg.get_orderbook_wrapper()->bestOrdersBusyChanged();
+                };
+                auto answer_functor = [&mm2_system, decode_functor, dropped_functor](web::http::http_response resp) {
+                    mm2_system.get_decode_queue().push(decode_queue::job{
+                        .rpc        = "best_orders",
+                        .policy     = decode_policy::coalesce,
+                        .task       = [decode_functor, resp]() { decode_functor(resp); },
+                        .on_dropped = dropped_functor});
+                };
 
                 mm2_system.get_mm2_client().async_rpc_batch_standalone(batch)
                     .then(answer_functor)
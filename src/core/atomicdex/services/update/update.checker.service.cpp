@@ -16,7 +16,6 @@
 
 #include "atomicdex/pch.hpp"
 
-#include <QJsonDocument>
 #include <QTranslator>
 
 #include <boost/algorithm/string/replace.hpp>
@@ -25,6 +24,7 @@
 #include "atomicdex/events/events.hpp"
 #include "atomicdex/services/update/update.checker.service.hpp"
 #include "atomicdex/utilities/cpprestsdk.utilities.hpp"
+#include "atomicdex/utilities/qt.utilities.hpp"
 #include "atomicdex/version/version.hpp"
 
 namespace
@@ -113,7 +113,6 @@ namespace atomic_dex
     QVariant update_checker_service::get_update_info() const 
     {
         nlohmann::json info = *m_update_info;
-        QJsonDocument  doc  = QJsonDocument::fromJson(QString::fromStdString(info.dump()).toUtf8());
-        return doc.toVariant();
+        return nlohmann_json_to_qt_json_value(info).toVariant();
     }
 } // namespace atomic_dex
@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! Project Headers
+#include "atomicdex/utilities/content.hash.hpp"
+
+namespace atomic_dex
+{
+    t_content_hash
+    content_hash(std::string_view payload) noexcept
+    {
+        return static_cast<t_content_hash>(std::hash<std::string_view>{}(payload));
+    }
+
+    double
+    content_change_stage_metrics::skip_rate() const noexcept
+    {
+        return nb_checks == 0 ? 0.0 : static_cast<double>(nb_skipped) / static_cast<double>(nb_checks);
+    }
+
+    bool
+    content_change_detector::changed(const std::string& stage, const std::string& key, t_content_hash hash)
+    {
+        std::scoped_lock lock(m_mutex);
+        auto&            state = m_stages[stage];
+        auto [it, inserted]    = state.hashes.try_emplace(key, hash);
+        const bool has_changed = inserted || it->second != hash;
+        it->second             = hash;
+        state.metrics.nb_checks += 1;
+        state.metrics.nb_skipped += has_changed ? 0 : 1;
+        return has_changed;
+    }
+
+    void
+    content_change_detector::store(const std::string& stage, const std::string& key, t_content_hash hash)
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stages[stage].hashes.insert_or_assign(key, hash);
+    }
+
+    void
+    content_change_detector::record(const std::string& stage, bool skipped)
+    {
+        std::scoped_lock lock(m_mutex);
+        auto&            metrics = m_stages[stage].metrics;
+        metrics.nb_checks += 1;
+        metrics.nb_skipped += skipped ? 1 : 0;
+    }
+
+    void
+    content_change_detector::forget(const std::string& stage, const std::string& key)
+    {
+        std::scoped_lock lock(m_mutex);
+        if (auto it = m_stages.find(stage); it != m_stages.end())
+        {
+            it->second.hashes.erase(key);
+        }
+    }
+
+    void
+    content_change_detector::clear(const std::string& stage)
+    {
+        std::scoped_lock lock(m_mutex);
+        if (auto it = m_stages.find(stage); it != m_stages.end())
+        {
+            it->second.hashes.clear();
+        }
+    }
+
+    void
+    content_change_detector::clear()
+    {
+        std::scoped_lock lock(m_mutex);
+        for (auto&& [_, state]: m_stages) { state.hashes.clear(); }
+    }
+
+    t_content_change_metrics
+    content_change_detector::get_metrics() const
+    {
+        std::scoped_lock         lock(m_mutex);
+        t_content_change_metrics out;
+        for (auto&& [stage, state]: m_stages) { out.emplace(stage, state.metrics); }
+        return out;
+    }
+} // namespace atomic_dex
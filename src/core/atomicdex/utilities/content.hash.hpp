@@ -0,0 +1,84 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace atomic_dex
+{
+    using t_content_hash = std::uint64_t;
+
+    //! Hash of a raw payload, ex: the body of an mm2 batch answer.
+    t_content_hash content_hash(std::string_view payload) noexcept;
+
+    //! Folds `value` into `seed`, used to hash the fields of a decoded record.
+    template <typename T>
+    void
+    hash_combine(t_content_hash& seed, const T& value)
+    {
+        seed ^= static_cast<t_content_hash>(std::hash<T>{}(value)) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+
+    struct content_change_stage_metrics
+    {
+        std::size_t nb_checks{0};
+        std::size_t nb_skipped{0}; ///< unchanged content, its decoding or model update was skipped
+
+        [[nodiscard]] double skip_rate() const noexcept;
+    };
+
+    using t_content_change_metrics = std::map<std::string, content_change_stage_metrics>; ///< by stage
+
+    //! Last content hash seen for every key of a stage (rpc answer slot, uuid, tx_hash...).
+    //! A payload or a record is only decoded / applied when its hash moved since the last time it was.
+    class content_change_detector
+    {
+      public:
+        //! Returns true and remembers `hash` if it differs from the last hash of `key`, false if the content is unchanged.
+        bool changed(const std::string& stage, const std::string& key, t_content_hash hash);
+
+        //! Remembers `hash` without counting a check, for payloads that are always applied (ex: a manual reset).
+        void store(const std::string& stage, const std::string& key, t_content_hash hash);
+
+        //! Counts a check done by comparing the values themselves instead of their hash.
+        void record(const std::string& stage, bool skipped);
+
+        //! The next payload of `key` is applied whatever its hash.
+        void forget(const std::string& stage, const std::string& key);
+        void clear(const std::string& stage);
+        void clear();
+
+        [[nodiscard]] t_content_change_metrics get_metrics() const;
+
+      private:
+        struct stage_state
+        {
+            std::unordered_map<std::string, t_content_hash> hashes;
+            content_change_stage_metrics                    metrics;
+        };
+
+        mutable std::mutex                           m_mutex;
+        std::unordered_map<std::string, stage_state> m_stages;
+    };
+} // namespace atomic_dex
@@ -0,0 +1,176 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+
+//! Project Headers
+#include "atomicdex/utilities/event.loop.scheduler.hpp"
+
+namespace atomic_dex
+{
+    void
+    event_loop_scheduler::set_wake_handler(t_wake_handler handler)
+    {
+        std::scoped_lock lock(m_mutex);
+        m_wake_handler = std::move(handler);
+    }
+
+    event_loop_scheduler::t_id
+    event_loop_scheduler::add_timer(std::string name, t_clock::duration period, t_task task)
+    {
+        std::scoped_lock lock(m_mutex);
+        const t_id       id = m_next_id++;
+        m_entries.push_back(entry{.id = id, .name = std::move(name), .period = period, .deadline = t_clock::now() + period, .task = std::move(task)});
+        return id;
+    }
+
+    event_loop_scheduler::t_id
+    event_loop_scheduler::add_sink(std::string name, t_task task)
+    {
+        std::scoped_lock lock(m_mutex);
+        const t_id       id = m_next_id++;
+        m_entries.push_back(entry{.id = id, .name = std::move(name), .task = std::move(task)});
+        return id;
+    }
+
+    void
+    event_loop_scheduler::remove(t_id id)
+    {
+        std::scoped_lock lock(m_mutex);
+        std::erase_if(m_entries, [id](const entry& cur) { return cur.id == id; });
+    }
+
+    void
+    event_loop_scheduler::notify(t_id id)
+    {
+        t_wake_handler handler;
+        {
+            std::scoped_lock lock(m_mutex);
+            auto it = std::find_if(m_entries.begin(), m_entries.end(), [id](const entry& cur) { return cur.id == id; });
+            if (it == m_entries.end() || m_stopped)
+            {
+                return;
+            }
+            it->pending = true;
+            m_metrics.notifications += 1;
+            if (m_wake_requested)
+            {
+                return;
+            }
+            m_wake_requested = true;
+            handler          = m_wake_handler;
+        }
+        m_cv.notify_one();
+        if (handler)
+        {
+            handler();
+        }
+    }
+
+    std::size_t
+    event_loop_scheduler::run_due(t_clock::time_point now)
+    {
+        std::vector<t_task> tasks;
+        {
+            std::scoped_lock lock(m_mutex);
+            m_wake_requested = false;
+            m_metrics.wakeups += 1;
+            for (auto&& cur: m_entries)
+            {
+                const bool is_timer = cur.period != t_clock::duration::zero();
+                if (cur.pending)
+                {
+                    cur.pending = false;
+                    if (is_timer)
+                    {
+                        m_metrics.timers_fired += 1;
+                        cur.deadline = now + cur.period;
+                    }
+                    else
+                    {
+                        m_metrics.sinks_fired += 1;
+                    }
+                    tasks.push_back(cur.task);
+                }
+                else if (is_timer && cur.deadline <= now)
+                {
+                    m_metrics.timers_fired += 1;
+                    cur.deadline += cur.period;
+                    if (cur.deadline <= now)
+                    {
+                        //! The loop was late by more than a period, skip the missed deadlines instead of bursting.
+                        cur.deadline = now + cur.period;
+                    }
+                    tasks.push_back(cur.task);
+                }
+            }
+            if (tasks.empty())
+            {
+                m_metrics.idle_wakeups += 1;
+            }
+        }
+
+        //! Tasks run unlocked, they are allowed to notify, add or remove entries.
+        for (auto&& task: tasks) { task(); }
+        return tasks.size();
+    }
+
+    std::optional<event_loop_scheduler::t_clock::time_point>
+    event_loop_scheduler::next_deadline() const
+    {
+        std::scoped_lock                   lock(m_mutex);
+        std::optional<t_clock::time_point> out;
+        for (auto&& cur: m_entries)
+        {
+            if (cur.pending)
+            {
+                return t_clock::time_point::min();
+            }
+            if (cur.period != t_clock::duration::zero() && (!out || cur.deadline < *out))
+            {
+                out = cur.deadline;
+            }
+        }
+        return out;
+    }
+
+    bool
+    event_loop_scheduler::wait(t_clock::time_point max_deadline)
+    {
+        const auto       deadline = std::min(next_deadline().value_or(max_deadline), max_deadline);
+        std::unique_lock lock(m_mutex);
+        m_cv.wait_until(lock, deadline, [this]() { return m_wake_requested || m_stopped; });
+        return !m_stopped;
+    }
+
+    void
+    event_loop_scheduler::stop()
+    {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopped = true;
+        }
+        m_cv.notify_all();
+    }
+
+    event_scheduler_metrics
+    event_loop_scheduler::get_metrics() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_metrics;
+    }
+} // namespace atomic_dex
@@ -0,0 +1,145 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace atomic_dex
+{
+    struct event_scheduler_metrics
+    {
+        std::size_t wakeups{0};        ///< calls to run_due
+        std::size_t idle_wakeups{0};   ///< run_due calls that found nothing to do
+        std::size_t notifications{0};  ///< notify calls, coalesced or not
+        std::size_t timers_fired{0};
+        std::size_t sinks_fired{0};
+    };
+
+    //! Single consumer loop scheduler: runs periodic deadline timers and wake-on-event sinks.
+    //! The owner sleeps until `next_deadline()` or until the wake handler is called, then calls `run_due()` from the loop thread.
+    //! `notify()` is thread safe and coalesced: a sink notified several times before the loop wakes up runs once.
+    class event_loop_scheduler
+    {
+      public:
+        using t_clock        = std::chrono::steady_clock;
+        using t_task         = std::function<void()>;
+        using t_id           = std::size_t;
+        using t_wake_handler = std::function<void()>;
+
+        event_loop_scheduler() = default;
+
+        event_loop_scheduler(const event_loop_scheduler& other) = delete;
+        event_loop_scheduler& operator=(const event_loop_scheduler& other) = delete;
+
+        //! Called from the notifying thread when the loop has to wake up before its next deadline, the Qt owner posts a queued call there.
+        void set_wake_handler(t_wake_handler handler);
+
+        //! The first deadline is one period from now, following deadlines do not drift with the time spent in the task.
+        t_id add_timer(std::string name, t_clock::duration period, t_task task);
+        t_id add_sink(std::string name, t_task task);
+        void remove(t_id id);
+
+        //! Mark a sink (or a timer, which then runs ahead of its deadline) as pending and wake the loop.
+        void notify(t_id id);
+
+        //! Runs the pending sinks then the expired timers, returns the number of tasks run.
+        std::size_t run_due(t_clock::time_point now = t_clock::now());
+
+        [[nodiscard]] std::optional<t_clock::time_point> next_deadline() const;
+
+        //! Standalone loop helper: blocks until the next deadline, a notification or `stop()`, returns false once stopped.
+        bool wait(t_clock::time_point max_deadline);
+        void stop();
+
+        [[nodiscard]] event_scheduler_metrics get_metrics() const;
+
+      private:
+        struct entry
+        {
+            t_id                id;
+            std::string         name;
+            t_clock::duration   period{t_clock::duration::zero()}; ///< zero for sinks
+            t_clock::time_point deadline{t_clock::time_point::max()};
+            t_task              task;
+            bool                pending{false};
+        };
+
+        mutable std::mutex      m_mutex;
+        std::condition_variable m_cv;
+        std::vector<entry>      m_entries;
+        t_wake_handler          m_wake_handler;
+        t_id                    m_next_id{0};
+        bool                    m_wake_requested{false};
+        bool                    m_stopped{false};
+        event_scheduler_metrics m_metrics;
+    };
+
+    //! Multi producer, single consumer queue of owned payloads, drained in one swap by the loop.
+    template <typename TValue>
+    class event_queue
+    {
+      public:
+        void
+        push(TValue value)
+        {
+            std::scoped_lock lock(m_mutex);
+            m_values.push_back(std::move(value));
+        }
+
+        template <typename TRange>
+        void
+        push_range(const TRange& values)
+        {
+            std::scoped_lock lock(m_mutex);
+            m_values.insert(m_values.end(), std::begin(values), std::end(values));
+        }
+
+        [[nodiscard]] std::vector<TValue>
+        drain()
+        {
+            std::vector<TValue> out;
+            std::scoped_lock    lock(m_mutex);
+            out.swap(m_values);
+            return out;
+        }
+
+        void
+        clear()
+        {
+            std::scoped_lock lock(m_mutex);
+            m_values.clear();
+        }
+
+        [[nodiscard]] bool
+        empty() const
+        {
+            std::scoped_lock lock(m_mutex);
+            return m_values.empty();
+        }
+
+      private:
+        mutable std::mutex  m_mutex;
+        std::vector<TValue> m_values;
+    };
+} // namespace atomic_dex
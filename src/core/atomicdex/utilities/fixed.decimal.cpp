@@ -0,0 +1,479 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+
+//! Project Headers
+#include "atomicdex/utilities/fixed.decimal.hpp"
+
+namespace
+{
+    using t_raw  = atomic_dex::fixed_decimal::t_raw;
+    using t_wide = atomic_dex::fixed_decimal::t_wide;
+
+    constexpr int           g_scale_digits{atomic_dex::fixed_decimal::g_scale_digits};
+    constexpr int           g_max_pow10{76}; ///< 10^76 is the largest power of ten that fits in a signed 256-bit integer
+    constexpr std::uint64_t g_scale_u64{1'000'000'000'000'000'000ULL};
+
+    constexpr std::array<std::uint64_t, g_scale_digits + 1> g_pow10_u64 = []
+    {
+        std::array<std::uint64_t, g_scale_digits + 1> out{};
+        out[0] = 1;
+        for (std::size_t idx = 1; idx < out.size(); ++idx) { out[idx] = out[idx - 1] * 10; }
+        return out;
+    }();
+
+    const t_wide&
+    pow10_wide(int exponent)
+    {
+        static const std::array<t_wide, g_max_pow10 + 1> table = []
+        {
+            std::array<t_wide, g_max_pow10 + 1> out;
+            out[0] = 1;
+            for (int idx = 1; idx <= g_max_pow10; ++idx) { out[idx] = out[idx - 1] * 10; }
+            return out;
+        }();
+        return table[exponent];
+    }
+
+    const t_wide&
+    raw_max()
+    {
+        static const t_wide max{std::numeric_limits<t_raw>::max()};
+        return max;
+    }
+
+    //! Digits are accumulated below this cap so that the next `* 10` can never overflow the 256-bit mantissa.
+    const t_wide&
+    mantissa_cap()
+    {
+        return pow10_wide(60);
+    }
+
+    bool
+    fits(const t_wide& value)
+    {
+        return value <= raw_max() && value >= -raw_max();
+    }
+
+    t_raw
+    narrow(const t_wide& value)
+    {
+        if (!fits(value))
+        {
+            throw std::overflow_error("fixed_decimal: result out of range");
+        }
+        return static_cast<t_raw>(value);
+    }
+
+    std::string_view
+    trim(std::string_view str)
+    {
+        while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) { str.remove_prefix(1); }
+        while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) { str.remove_suffix(1); }
+        return str;
+    }
+
+    std::optional<t_wide>
+    parse_integer(std::string_view str)
+    {
+        str           = trim(str);
+        bool negative = false;
+        if (!str.empty() && (str.front() == '-' || str.front() == '+'))
+        {
+            negative = str.front() == '-';
+            str.remove_prefix(1);
+        }
+        if (str.empty())
+        {
+            return std::nullopt;
+        }
+        t_wide out{0};
+        for (char c: str)
+        {
+            if (c < '0' || c > '9' || out >= mantissa_cap())
+            {
+                return std::nullopt;
+            }
+            out = out * 10 + (c - '0');
+        }
+        return negative ? t_wide(-out) : out;
+    }
+
+    char*
+    write_padded(char* out, std::uint64_t value, int width)
+    {
+        char  digits[20];
+        auto  result = std::to_chars(digits, digits + sizeof(digits), value);
+        auto  len    = static_cast<int>(result.ptr - digits);
+        for (int idx = len; idx < width; ++idx) { *out++ = '0'; }
+        return std::copy(digits, result.ptr, out);
+    }
+} // namespace
+
+namespace atomic_dex
+{
+    const fixed_decimal::t_raw&
+    fixed_decimal::raw_scale() noexcept
+    {
+        static const t_raw scale{g_scale_u64};
+        return scale;
+    }
+
+    std::optional<fixed_decimal>
+    fixed_decimal::from_string(std::string_view str) noexcept
+    {
+        str = trim(str);
+        std::size_t pos      = 0;
+        bool        negative = false;
+        if (pos < str.size() && (str[pos] == '-' || str[pos] == '+'))
+        {
+            negative = str[pos] == '-';
+            ++pos;
+        }
+
+        //! Digits are accumulated in 64 bits first, most mm2 amounts never need the wide mantissa
+        std::uint64_t small{0};
+        bool          is_small = true;
+        t_wide        mantissa{0};
+        int           nb_digits   = 0;
+        int           frac_digits = 0;
+        int           int_dropped = 0; ///< integer digits that did not fit under the mantissa cap
+        bool          in_fraction = false;
+        for (; pos < str.size(); ++pos)
+        {
+            const char c = str[pos];
+            if (c >= '0' && c <= '9')
+            {
+                ++nb_digits;
+                if (is_small && small < g_scale_u64)
+                {
+                    small = small * 10 + static_cast<std::uint64_t>(c - '0');
+                    frac_digits += in_fraction ? 1 : 0;
+                    continue;
+                }
+                if (is_small)
+                {
+                    mantissa = small;
+                    is_small = false;
+                }
+                if (mantissa < mantissa_cap())
+                {
+                    mantissa = mantissa * 10 + (c - '0');
+                    frac_digits += in_fraction ? 1 : 0;
+                }
+                else if (!in_fraction)
+                {
+                    ++int_dropped;
+                }
+            }
+            else if (c == '.' && !in_fraction)
+            {
+                in_fraction = true;
+            }
+            else
+            {
+                break;
+            }
+        }
+        if (nb_digits == 0)
+        {
+            return std::nullopt;
+        }
+
+        int exponent = 0;
+        if (pos < str.size() && (str[pos] == 'e' || str[pos] == 'E'))
+        {
+            ++pos;
+            bool negative_exponent = false;
+            if (pos < str.size() && (str[pos] == '-' || str[pos] == '+'))
+            {
+                negative_exponent = str[pos] == '-';
+                ++pos;
+            }
+            const auto [ptr, ec] = std::from_chars(str.data() + pos, str.data() + str.size(), exponent);
+            if (ec != std::errc() || exponent > 10000)
+            {
+                return std::nullopt;
+            }
+            pos      = static_cast<std::size_t>(ptr - str.data());
+            exponent = negative_exponent ? -exponent : exponent;
+        }
+        if (pos != str.size())
+        {
+            return std::nullopt;
+        }
+
+        const int shift = g_scale_digits - frac_digits + exponent + int_dropped;
+        if (is_small && shift >= 0 && shift <= g_scale_digits)
+        {
+            const t_raw raw = t_raw(small) * t_raw(g_pow10_u64[shift]);
+            return from_raw(negative ? t_raw(-raw) : raw);
+        }
+        if (is_small)
+        {
+            mantissa = small;
+        }
+        if (mantissa == 0)
+        {
+            return fixed_decimal{};
+        }
+        if (shift > 0)
+        {
+            if (shift > 38 || mantissa > raw_max() / pow10_wide(shift))
+            {
+                return std::nullopt;
+            }
+            mantissa *= pow10_wide(shift);
+        }
+        else if (shift < 0)
+        {
+            if (-shift > g_max_pow10)
+            {
+                return fixed_decimal{};
+            }
+            mantissa /= pow10_wide(-shift);
+        }
+        if (mantissa > raw_max())
+        {
+            return std::nullopt;
+        }
+        const auto raw = static_cast<t_raw>(mantissa);
+        return from_raw(negative ? t_raw(-raw) : raw);
+    }
+
+    std::optional<fixed_decimal>
+    fixed_decimal::from_fraction(std::string_view numer, std::string_view denom) noexcept
+    {
+        const auto numer_w = parse_integer(numer);
+        const auto denom_w = parse_integer(denom);
+        if (!numer_w.has_value() || !denom_w.has_value() || denom_w.value() == 0)
+        {
+            return std::nullopt;
+        }
+        if (numer_w.value() > pow10_wide(58) || numer_w.value() < -pow10_wide(58))
+        {
+            return std::nullopt;
+        }
+        const t_wide result = numer_w.value() * pow10_wide(g_scale_digits) / denom_w.value();
+        if (!fits(result))
+        {
+            return std::nullopt;
+        }
+        return from_raw(static_cast<t_raw>(result));
+    }
+
+    std::optional<fixed_decimal>
+    fixed_decimal::from_double(double value) noexcept
+    {
+        if (!std::isfinite(value) || std::fabs(value) >= 1.7e20)
+        {
+            return std::nullopt;
+        }
+        char buffer[64];
+        const int len = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+        if (len <= 0 || len >= static_cast<int>(sizeof(buffer)))
+        {
+            return std::nullopt;
+        }
+        return from_string(std::string_view(buffer, static_cast<std::size_t>(len)));
+    }
+
+    fixed_decimal
+    fixed_decimal::from_raw(t_raw raw) noexcept
+    {
+        fixed_decimal out;
+        out.m_raw = std::move(raw);
+        return out;
+    }
+
+    std::string
+    fixed_decimal::str(int precision) const
+    {
+        precision                = std::clamp(precision, 0, g_scale_digits);
+        const bool  negative     = m_raw < 0;
+        const t_raw magnitude    = negative ? t_raw(-m_raw) : m_raw;
+        t_raw       integer_part = magnitude / raw_scale();
+        auto        fraction     = static_cast<std::uint64_t>(magnitude % raw_scale());
+
+        //! Round half to even to `precision` decimals, as cpp_dec_float does
+        const std::uint64_t divisor   = g_pow10_u64[g_scale_digits - precision];
+        const std::uint64_t remainder = fraction % divisor;
+        std::uint64_t       decimals  = fraction / divisor;
+        const std::uint64_t last      = precision > 0 ? decimals : static_cast<std::uint64_t>(integer_part % 10);
+        if (remainder * 2 > divisor || (remainder * 2 == divisor && last % 2 == 1))
+        {
+            ++decimals;
+        }
+        if (decimals == g_pow10_u64[precision])
+        {
+            decimals = 0;
+            integer_part += 1;
+        }
+
+        char  buffer[64];
+        char* out = buffer;
+        if (negative && (integer_part != 0 || decimals != 0))
+        {
+            *out++ = '-';
+        }
+        if (integer_part >= raw_scale())
+        {
+            out = write_padded(out, static_cast<std::uint64_t>(integer_part / raw_scale()), 0);
+            out = write_padded(out, static_cast<std::uint64_t>(integer_part % raw_scale()), g_scale_digits);
+        }
+        else
+        {
+            out = write_padded(out, static_cast<std::uint64_t>(integer_part), 0);
+        }
+        if (precision > 0)
+        {
+            *out++ = '.';
+            out    = write_padded(out, decimals, precision);
+        }
+        return std::string(buffer, out);
+    }
+
+    double
+    fixed_decimal::to_double() const
+    {
+        return m_raw.convert_to<double>() / static_cast<double>(g_scale_u64);
+    }
+
+    fixed_decimal&
+    fixed_decimal::operator+=(const fixed_decimal& other)
+    {
+        m_raw = narrow(t_wide(m_raw) + t_wide(other.m_raw));
+        return *this;
+    }
+
+    fixed_decimal&
+    fixed_decimal::operator-=(const fixed_decimal& other)
+    {
+        m_raw = narrow(t_wide(m_raw) - t_wide(other.m_raw));
+        return *this;
+    }
+
+    fixed_decimal&
+    fixed_decimal::operator*=(const fixed_decimal& other)
+    {
+        m_raw = narrow(t_wide(m_raw) * t_wide(other.m_raw) / pow10_wide(g_scale_digits));
+        return *this;
+    }
+
+    fixed_decimal&
+    fixed_decimal::operator/=(const fixed_decimal& other)
+    {
+        if (other.m_raw == 0)
+        {
+            throw std::domain_error("fixed_decimal: division by zero");
+        }
+        m_raw = narrow(t_wide(m_raw) * pow10_wide(g_scale_digits) / t_wide(other.m_raw));
+        return *this;
+    }
+
+    fixed_decimal
+    fixed_decimal::operator-() const
+    {
+        return from_raw(t_raw(-m_raw));
+    }
+
+    std::optional<fixed_decimal>
+    checked_product(std::string_view lhs, std::string_view rhs) noexcept
+    {
+        if (auto lhs_f = fixed_decimal::from_string(lhs); lhs_f.has_value())
+        {
+            return checked_product(lhs_f.value(), rhs);
+        }
+        return std::nullopt;
+    }
+
+    std::optional<fixed_decimal>
+    checked_product(const fixed_decimal& lhs, std::string_view rhs) noexcept
+    {
+        const auto rhs_f = fixed_decimal::from_string(rhs);
+        if (!rhs_f.has_value())
+        {
+            return std::nullopt;
+        }
+        const t_wide result = t_wide(lhs.raw()) * t_wide(rhs_f->raw()) / pow10_wide(g_scale_digits);
+        if (!fits(result))
+        {
+            return std::nullopt;
+        }
+        return fixed_decimal::from_raw(static_cast<t_raw>(result));
+    }
+
+    void
+    decimal_sum::add(const fixed_decimal& value)
+    {
+        if (!m_wide.has_value())
+        {
+            const t_wide result = t_wide(m_fixed.raw()) + t_wide(value.raw());
+            if (fits(result))
+            {
+                m_fixed = fixed_decimal::from_raw(static_cast<t_raw>(result));
+                return;
+            }
+            m_wide = t_float_50(m_fixed.str());
+        }
+        *m_wide += t_float_50(value.str());
+    }
+
+    void
+    decimal_sum::add(const t_float_50& value)
+    {
+        if (!m_wide.has_value())
+        {
+            m_wide = t_float_50(m_fixed.str());
+        }
+        *m_wide += value;
+    }
+
+    t_float_50
+    decimal_sum::wide() const
+    {
+        return m_wide.has_value() ? m_wide.value() : t_float_50(m_fixed.str());
+    }
+
+    std::string
+    decimal_sum::str(int precision) const
+    {
+        if (m_wide.has_value())
+        {
+            return m_wide->str(std::clamp(precision, 0, g_scale_digits), std::ios_base::fixed);
+        }
+        return m_fixed.str(precision);
+    }
+} // namespace atomic_dex
+
+t_fixed_decimal
+safe_decimal(std::string_view from)
+{
+    if (auto out = t_fixed_decimal::from_string(from); out.has_value())
+    {
+        return out.value();
+    }
+    SPDLOG_ERROR("invalid or out of range decimal number: {}", from);
+    return t_fixed_decimal(0);
+}
@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+//! Boost
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-parameter"
+#include <boost/multiprecision/cpp_int.hpp>
+#pragma clang diagnostic pop
+
+//! Project Headers
+#include "atomicdex/utilities/safe.float.hpp"
+
+namespace atomic_dex
+{
+    //! Signed decimal with 18 fractional digits (the finest precision mm2 uses, ex: wei for ETH) stored in a 128-bit integer.
+    //! Parsing, formatting, add, sub and compare do not allocate, mul and div use a 256-bit intermediate and truncate towards zero.
+    //! Range is +/- 3.4e20, operations leaving it throw std::overflow_error.
+    class fixed_decimal
+    {
+      public:
+        using t_raw                         = boost::multiprecision::int128_t;
+        using t_wide                        = boost::multiprecision::int256_t;
+        static constexpr int g_scale_digits = 18;
+
+        fixed_decimal() = default;
+        template <std::integral T>
+        fixed_decimal(T value) : m_raw(static_cast<t_raw>(value) * raw_scale())
+        {
+        }
+        fixed_decimal(double value) = delete; ///< use from_double, a double is not exact
+
+        //! Accepts mm2 decimal strings: optional sign, '.' separator (',' is rejected), optional exponent. Digits past the 18th decimal are truncated.
+        static std::optional<fixed_decimal> from_string(std::string_view str) noexcept;
+        //! Accepts mm2 fractions (numer / denom integer strings).
+        static std::optional<fixed_decimal> from_fraction(std::string_view numer, std::string_view denom) noexcept;
+        static std::optional<fixed_decimal> from_double(double value) noexcept;
+        static fixed_decimal                from_raw(t_raw raw) noexcept;
+
+        //! Fixed notation with `precision` decimals rounded half to even, same output as t_float_50::str(precision, std::ios_base::fixed).
+        [[nodiscard]] std::string str(int precision = g_scale_digits) const;
+        [[nodiscard]] double      to_double() const;
+        [[nodiscard]] const t_raw& raw() const noexcept { return m_raw; }
+        [[nodiscard]] bool         is_zero() const noexcept { return m_raw == 0; }
+
+        fixed_decimal& operator+=(const fixed_decimal& other);
+        fixed_decimal& operator-=(const fixed_decimal& other);
+        fixed_decimal& operator*=(const fixed_decimal& other);
+        fixed_decimal& operator/=(const fixed_decimal& other); ///< throws std::domain_error on a zero divisor
+
+        fixed_decimal operator-() const;
+
+        friend fixed_decimal operator+(fixed_decimal lhs, const fixed_decimal& rhs) { return lhs += rhs; }
+        friend fixed_decimal operator-(fixed_decimal lhs, const fixed_decimal& rhs) { return lhs -= rhs; }
+        friend fixed_decimal operator*(fixed_decimal lhs, const fixed_decimal& rhs) { return lhs *= rhs; }
+        friend fixed_decimal operator/(fixed_decimal lhs, const fixed_decimal& rhs) { return lhs /= rhs; }
+
+        friend bool operator==(const fixed_decimal& lhs, const fixed_decimal& rhs) noexcept { return lhs.m_raw == rhs.m_raw; }
+        friend bool operator!=(const fixed_decimal& lhs, const fixed_decimal& rhs) noexcept { return lhs.m_raw != rhs.m_raw; }
+        friend bool operator<(const fixed_decimal& lhs, const fixed_decimal& rhs) noexcept { return lhs.m_raw < rhs.m_raw; }
+        friend bool operator<=(const fixed_decimal& lhs, const fixed_decimal& rhs) noexcept { return lhs.m_raw <= rhs.m_raw; }
+        friend bool operator>(const fixed_decimal& lhs, const fixed_decimal& rhs) noexcept { return lhs.m_raw > rhs.m_raw; }
+        friend bool operator>=(const fixed_decimal& lhs, const fixed_decimal& rhs) noexcept { return lhs.m_raw >= rhs.m_raw; }
+
+      private:
+        static const t_raw& raw_scale() noexcept;
+
+        t_raw m_raw{0};
+    };
+} // namespace atomic_dex
+
+using t_fixed_decimal = atomic_dex::fixed_decimal;
+
+namespace atomic_dex
+{
+    //! Product of two decimal strings, nullopt when one of them is not a decimal, is out of range or when the product overflows.
+    //! The caller falls back on t_float_50, ex: a price or a balance out of the fixed_decimal range.
+    std::optional<fixed_decimal> checked_product(std::string_view lhs, std::string_view rhs) noexcept;
+    std::optional<fixed_decimal> checked_product(const fixed_decimal& lhs, std::string_view rhs) noexcept;
+
+    //! Running total which moves to a t_float_50 once it leaves the fixed_decimal range, instead of throwing from the accumulation.
+    class decimal_sum
+    {
+      public:
+        void add(const fixed_decimal& value);
+        void add(const t_float_50& value);
+
+        [[nodiscard]] bool                 is_wide() const noexcept { return m_wide.has_value(); }
+        [[nodiscard]] const fixed_decimal& fixed() const noexcept { return m_fixed; } ///< only the total while not wide
+        [[nodiscard]] t_float_50           wide() const;
+        [[nodiscard]] std::string          str(int precision) const; ///< same output as fixed_decimal::str in both cases
+
+      private:
+        fixed_decimal             m_fixed;
+        std::optional<t_float_50> m_wide;
+    };
+} // namespace atomic_dex
+
+//! Same contract as safe_float: logs and returns 0 when the string is not a valid decimal or is out of the fixed_decimal range.
+//! Only for values bounded by design, use from_string or checked_product and fall back on t_float_50 otherwise.
+t_fixed_decimal safe_decimal(std::string_view from);
@@ -51,13 +51,26 @@ namespace atomic_dex::utils
     }
 
     std::string
-    adjust_precision(const std::string& current)
+    format_float(const t_fixed_decimal& value, int precision)
     {
-        std::string       result;
-        std::stringstream ss;
-        t_float_50        current_f(safe_float(current));
+        std::string result = value.str(precision);
+        if (precision > 0)
+        {
+            boost::trim_right_if(result, boost::is_any_of("0"));
+            boost::trim_right_if(result, boost::is_any_of("."));
+        }
+        return result;
+    }
 
-        return format_float(current_f);
+    std::string
+    adjust_precision(const std::string& current)
+    {
+        if (auto current_f = t_fixed_decimal::from_string(current); current_f.has_value())
+        {
+            return format_float(current_f.value());
+        }
+        //! Out of the fixed point range, keep the arbitrary precision path
+        return format_float(safe_float(current));
     }
 
     bool
@@ -188,6 +201,30 @@ namespace atomic_dex::utils
         return fs_export_folder;
     }
 
+    fs::path
+    get_atomic_dex_charts_cache_folder()
+    {
+        const auto fs_charts_cache_folder = get_atomic_dex_data_folder() / "charts_cache";
+        create_if_doesnt_exist(fs_charts_cache_folder);
+        return fs_charts_cache_folder;
+    }
+
+    fs::path
+    get_atomic_dex_swaps_history_folder()
+    {
+        const auto fs_swaps_history_folder = get_atomic_dex_data_folder() / "swaps_history";
+        create_if_doesnt_exist(fs_swaps_history_folder);
+        return fs_swaps_history_folder;
+    }
+
+    fs::path
+    get_atomic_dex_coins_cfg_cache_folder()
+    {
+        const auto fs_coins_cfg_cache_folder = get_atomic_dex_data_folder() / "coins_cfg_cache";
+        create_if_doesnt_exist(fs_coins_cfg_cache_folder);
+        return fs_coins_cfg_cache_folder;
+    }
+
     fs::path
     get_atomic_dex_current_export_recent_swaps_file()
     {
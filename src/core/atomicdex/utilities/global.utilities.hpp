@@ -24,6 +24,7 @@
 #include <date/tz.h>             ///< date::make_zoned
 #include <entt/core/attribute.h> ///< ENTT_API
 
+#include "fixed.decimal.hpp"
 #include "fs.prerequisites.hpp"
 #include "safe.float.hpp"
 #include "atomicdex/config/coins.cfg.hpp"
@@ -35,6 +36,7 @@ namespace atomic_dex::utils
     std::string get_formated_float(t_float_50 value);
     std::string adjust_precision(const std::string& current);
     std::string format_float(t_float_50 value);
+    std::string format_float(const t_fixed_decimal& value, int precision = 8);
     std::string extract_large_float(const std::string& current);
 
     //! Fs helpers
@@ -90,6 +92,12 @@ namespace atomic_dex::utils
 
     fs::path get_atomic_dex_export_folder();
 
+    fs::path get_atomic_dex_charts_cache_folder();
+
+    fs::path get_atomic_dex_swaps_history_folder();
+
+    fs::path get_atomic_dex_coins_cfg_cache_folder();
+
     fs::path get_atomic_dex_current_export_recent_swaps_file();
 
     ENTT_API fs::path get_themes_path();
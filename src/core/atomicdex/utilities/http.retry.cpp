@@ -0,0 +1,146 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <exception>
+#include <mutex>
+#include <optional>
+
+//! Deps
+#include <antara/app/net/http.code.hpp>
+
+//! Project Headers
+#include "atomicdex/utilities/http.retry.hpp"
+
+namespace
+{
+    struct retry_http_state
+    {
+        pplx::task_completion_event<web::http::http_response> tce;
+        std::mutex                                            mutex;
+        std::optional<web::http::http_response>               last_answer;
+        std::exception_ptr                                    last_error;
+    };
+
+    std::chrono::milliseconds
+    retry_after(const web::http::http_response& resp)
+    {
+        const auto& headers = resp.headers();
+        if (auto it = headers.find(FROM_STD_STR("Retry-After")); it != headers.end())
+        {
+            try
+            {
+                return std::chrono::seconds(std::stoi(TO_STD_STR(it->second)));
+            }
+            catch (const std::exception&)
+            {
+                //! http-date form, fallback on the backoff
+            }
+        }
+        return std::chrono::milliseconds::zero();
+    }
+} // namespace
+
+namespace atomic_dex
+{
+    retry_scheduler&
+    get_http_retry_scheduler()
+    {
+        static retry_scheduler scheduler;
+        static std::once_flag  limits_flag;
+        std::call_once(
+            limits_flag,
+            []()
+            {
+                scheduler.set_host_limits(g_coinpaprika_host, {.capacity = 10, .refill_per_second = 10});
+                scheduler.set_host_limits(g_coingecko_host, {.capacity = 8, .refill_per_second = 1});
+                scheduler.set_host_limits(g_komodo_rates_host, {.capacity = 5, .refill_per_second = 2});
+            });
+        return scheduler;
+    }
+
+    bool
+    is_retryable_status(web::http::status_code code)
+    {
+        return code == static_cast<web::http::status_code>(antara::app::http_code::too_many_requests) || code >= 500;
+    }
+
+    pplx::task<web::http::http_response>
+    retry_http(retry_scheduler& scheduler, std::string host, t_http_request_functor functor, retry_policy policy)
+    {
+        auto state   = std::make_shared<retry_http_state>();
+        auto attempt = [functor = std::move(functor), state](std::size_t, const retry_scheduler::t_report& report)
+        {
+            pplx::task<web::http::http_response> request_task;
+            try
+            {
+                request_task = functor();
+            }
+            catch (const std::exception&)
+            {
+                //! Never let a throwing request builder escape on the wheel thread.
+                request_task = pplx::task_from_exception<web::http::http_response>(std::current_exception());
+            }
+            request_task.then(
+                [state, report](pplx::task<web::http::http_response> previous_task)
+                {
+                    try
+                    {
+                        auto resp = previous_task.get();
+                        if (is_retryable_status(resp.status_code()))
+                        {
+                            const auto delay = retry_after(resp);
+                            {
+                                std::scoped_lock lock(state->mutex);
+                                state->last_answer = std::move(resp);
+                            }
+                            report({.verdict = retry_verdict::retry, .retry_after = delay});
+                            return;
+                        }
+                        report({.verdict = retry_verdict::done});
+                        state->tce.set(std::move(resp));
+                    }
+                    catch (const std::exception&)
+                    {
+                        {
+                            std::scoped_lock lock(state->mutex);
+                            state->last_error = std::current_exception();
+                        }
+                        report({.verdict = retry_verdict::retry});
+                    }
+                });
+        };
+        auto give_up = [state](std::exception_ptr reason)
+        {
+            std::scoped_lock lock(state->mutex);
+            if (reason)
+            {
+                //! Stopped scheduler: the request is cancelled, even when a retryable answer was received.
+                state->tce.set_exception(reason);
+            }
+            else if (state->last_answer)
+            {
+                state->tce.set(*state->last_answer);
+            }
+            else
+            {
+                state->tce.set_exception(state->last_error);
+            }
+        };
+        scheduler.run(std::move(host), std::move(attempt), std::move(give_up), policy);
+        return pplx::create_task(state->tce);
+    }
+} // namespace atomic_dex
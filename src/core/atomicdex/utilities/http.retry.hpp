@@ -0,0 +1,53 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <functional>
+#include <string>
+
+//! Project Headers
+#include "atomicdex/utilities/cpprestsdk.utilities.hpp"
+#include "atomicdex/utilities/retry.scheduler.hpp"
+
+namespace atomic_dex
+{
+    //! Token bucket keys of the http providers.
+    inline constexpr const char* g_coinpaprika_host  = "api.coinpaprika.com";
+    inline constexpr const char* g_coingecko_host    = "api.coingecko.com";
+    inline constexpr const char* g_komodo_rates_host = "rates.komodo.live";
+
+    using t_http_request_functor = std::function<pplx::task<web::http::http_response>()>;
+
+    //! Process wide scheduler shared by every http provider, the hosts above are registered with their rate limits.
+    retry_scheduler& get_http_retry_scheduler();
+
+    //! 429 and 5xx answers.
+    [[nodiscard]] bool is_retryable_status(web::http::status_code code);
+
+    //! Sends the request built by `functor` through the scheduler, retrying transport errors and retryable answers.
+    //! The task holds the first non retryable answer, the last retryable one once the retries are exhausted,
+    //! or the last transport error when no answer was ever received.
+    pplx::task<web::http::http_response>
+    retry_http(retry_scheduler& scheduler, std::string host, t_http_request_functor functor, retry_policy policy = {});
+
+    inline pplx::task<web::http::http_response>
+    retry_http(std::string host, t_http_request_functor functor, retry_policy policy = {})
+    {
+        return retry_http(get_http_retry_scheduler(), std::move(host), std::move(functor), policy);
+    }
+} // namespace atomic_dex
@@ -0,0 +1,181 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+//! STD
+#include <algorithm>
+
+//! Project Headers
+#include "atomicdex/utilities/keyed.row.index.hpp"
+
+namespace atomic_dex
+{
+    std::vector<t_row_range>
+    to_row_ranges(std::vector<std::size_t> rows)
+    {
+        std::vector<t_row_range> out;
+        std::sort(rows.begin(), rows.end());
+        for (std::size_t row: rows)
+        {
+            if (!out.empty() && (out.back().second == row || out.back().second + 1 == row))
+            {
+                out.back().second = row;
+            }
+            else
+            {
+                out.emplace_back(row, row);
+            }
+        }
+        return out;
+    }
+
+    void
+    keyed_row_index::clear() noexcept
+    {
+        m_keys.clear();
+        m_rows.clear();
+    }
+
+    void
+    keyed_row_index::append(std::string key)
+    {
+        m_rows.emplace(key, m_keys.size());
+        m_keys.push_back(std::move(key));
+    }
+
+    void
+    keyed_row_index::insert(std::size_t row, std::vector<std::string> keys)
+    {
+        row                  = std::min(row, m_keys.size());
+        const std::size_t nb = keys.size();
+        m_keys.insert(m_keys.begin() + static_cast<std::ptrdiff_t>(row), std::make_move_iterator(keys.begin()), std::make_move_iterator(keys.end()));
+
+        //! Shift the registered rows that moved, their new position is `cur`, the old one `cur - nb`.
+        //! Walking backward keeps a shifted first row from being mistaken for the old position of a later duplicate.
+        for (std::size_t cur = m_keys.size(); cur-- > row + nb;)
+        {
+            if (auto it = m_rows.find(m_keys[cur]); it != m_rows.end() && it->second == cur - nb)
+            {
+                it->second = cur;
+            }
+        }
+        for (std::size_t cur = row; cur < row + nb; ++cur)
+        {
+            if (auto [it, inserted] = m_rows.emplace(m_keys[cur], cur); !inserted && it->second > cur)
+            {
+                it->second = cur;
+            }
+        }
+    }
+
+    void
+    keyed_row_index::remove(std::size_t first, std::size_t count)
+    {
+        if (first >= m_keys.size() || count == 0)
+        {
+            return;
+        }
+        count = std::min(count, m_keys.size() - first);
+        for (std::size_t cur = first; cur < first + count; ++cur)
+        {
+            if (auto it = m_rows.find(m_keys[cur]); it != m_rows.end() && it->second == cur)
+            {
+                m_rows.erase(it);
+            }
+        }
+        const auto begin = m_keys.begin() + static_cast<std::ptrdiff_t>(first);
+        m_keys.erase(begin, begin + static_cast<std::ptrdiff_t>(count));
+
+        //! Shift the rows after the removed range, a key whose first row was removed moves to its next occurrence
+        for (std::size_t cur = first; cur < m_keys.size(); ++cur)
+        {
+            if (auto [it, inserted] = m_rows.emplace(m_keys[cur], cur); !inserted && it->second == cur + count)
+            {
+                it->second = cur;
+            }
+        }
+    }
+
+    std::optional<std::size_t>
+    keyed_row_index::find(const std::string& key) const
+    {
+        if (const auto it = m_rows.find(key); it != m_rows.end())
+        {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    bool
+    keyed_row_index::contains(const std::string& key) const
+    {
+        return m_rows.contains(key);
+    }
+
+    const std::string&
+    keyed_row_index::key_at(std::size_t row) const
+    {
+        return m_keys.at(row);
+    }
+
+    std::size_t
+    keyed_row_index::size() const noexcept
+    {
+        return m_keys.size();
+    }
+
+    void
+    row_changes::start() noexcept
+    {
+        m_recording = true;
+    }
+
+    void
+    row_changes::add(std::size_t row, int role)
+    {
+        m_changes.emplace_back(row, role);
+    }
+
+    bool
+    row_changes::is_recording() const noexcept
+    {
+        return m_recording;
+    }
+
+    std::vector<std::pair<t_row_range, std::vector<int>>>
+    row_changes::group(std::vector<t_change> changes)
+    {
+        std::vector<std::pair<t_row_range, std::vector<int>>> out;
+        std::sort(changes.begin(), changes.end());
+        changes.erase(std::unique(changes.begin(), changes.end()), changes.end());
+        for (auto&& [row, role]: changes)
+        {
+            if (out.empty() || out.back().first.second + 1 < row)
+            {
+                out.push_back({{row, row}, {}});
+            }
+            auto& [range, roles] = out.back();
+            range.second         = row;
+            roles.push_back(role);
+        }
+        for (auto&& [_, roles]: out)
+        {
+            std::sort(roles.begin(), roles.end());
+            roles.erase(std::unique(roles.begin(), roles.end()), roles.end());
+        }
+        return out;
+    }
+} // namespace atomic_dex
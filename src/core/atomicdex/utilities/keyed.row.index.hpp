@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#pragma once
+
+//! STD
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace atomic_dex
+{
+    using t_row_range = std::pair<std::size_t, std::size_t>; ///< [first, last] rows
+
+    //! Groups rows into contiguous ranges, sorted ascending.
+    std::vector<t_row_range> to_row_ranges(std::vector<std::size_t> rows);
+
+    //! key (ticker, uuid, tx_hash...) -> row registry mirroring the rows of a list model.
+    //! The owner calls reset/insert/remove next to its begin/end{Reset,Insert,Remove}Rows so lookups stay O(1) instead of a QAbstractItemModel::match scan.
+    //! If several rows share a key the first one is returned, like match(..., 1).
+    class keyed_row_index
+    {
+      public:
+        template <typename TRows, typename TKeyFunctor>
+        void
+        reset(const TRows& rows, TKeyFunctor&& key_of)
+        {
+            clear();
+            m_keys.reserve(rows.size());
+            m_rows.reserve(rows.size());
+            for (auto&& row: rows) { m_keys.emplace_back(key_of(row)); }
+            for (std::size_t row = 0; row < m_keys.size(); ++row) { m_rows.emplace(m_keys[row], row); }
+        }
+
+        void clear() noexcept;
+        void append(std::string key);
+        void insert(std::size_t row, std::vector<std::string> keys); ///< shifts the rows at and after `row`
+        void remove(std::size_t first, std::size_t count);           ///< shifts the rows after the removed range
+
+        [[nodiscard]] std::optional<std::size_t> find(const std::string& key) const;
+        [[nodiscard]] bool                       contains(const std::string& key) const;
+        [[nodiscard]] const std::string&         key_at(std::size_t row) const;
+        [[nodiscard]] std::size_t                size() const noexcept;
+
+      private:
+        std::vector<std::string>                     m_keys; ///< row -> key
+        std::unordered_map<std::string, std::size_t> m_rows; ///< key -> first row
+    };
+
+    //! Rows and roles touched by a batch of updates, so a model emits one dataChanged per contiguous range instead of one per row and role.
+    class row_changes
+    {
+      public:
+        void               start() noexcept;
+        void               add(std::size_t row, int role);
+        [[nodiscard]] bool is_recording() const noexcept;
+
+        //! Stops recording and calls functor(first, last, roles) for every contiguous range, roles being the sorted union of the range roles.
+        template <typename TFunctor>
+        void
+        flush(TFunctor&& functor)
+        {
+            m_recording  = false;
+            auto changes = std::move(m_changes);
+            m_changes.clear();
+            for (auto&& [range, roles]: group(std::move(changes))) { functor(range.first, range.second, roles); }
+        }
+
+      private:
+        using t_change = std::pair<std::size_t, int>; ///< row, role
+
+        static std::vector<std::pair<t_row_range, std::vector<int>>> group(std::vector<t_change> changes);
+
+        std::vector<t_change> m_changes;
+        bool                  m_recording{false};
+    };
+} // namespace atomic_dex
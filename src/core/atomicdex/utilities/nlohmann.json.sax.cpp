@@ -0,0 +1,255 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! Project Headers
+#include "atomicdex/utilities/nlohmann.json.sax.hpp"
+
+namespace atomic_dex::utils
+{
+    json_batch_sax::json_batch_sax(t_paths_functor paths, t_record_functor on_record, t_element_functor on_element) :
+        m_paths(std::move(paths)), m_on_record(std::move(on_record)), m_on_element(std::move(on_element))
+    {
+    }
+
+    int
+    json_batch_sax::match_record_path(const std::string& segment) const
+    {
+        const t_json_record_paths* paths = m_paths ? m_paths(m_element_idx) : nullptr;
+        if (paths == nullptr || paths->empty())
+        {
+            return -1;
+        }
+
+        //! m_stack[0] is the batch array, m_stack[1] the element root, the path starts after them and ends with the new container.
+        const std::size_t depth = m_stack.size() - 1;
+        for (std::size_t idx = 0; idx < paths->size(); ++idx)
+        {
+            const auto& path = (*paths)[idx];
+            if (path.size() != depth || path.back() != segment)
+            {
+                continue;
+            }
+            bool match = true;
+            for (std::size_t level = 0; level + 1 < path.size() && match; ++level) { match = path[level] == m_stack[level + 2].segment; }
+            if (match)
+            {
+                return static_cast<int>(idx);
+            }
+        }
+        return -1;
+    }
+
+    nlohmann::json*
+    json_batch_sax::place(nlohmann::json&& value)
+    {
+        if (m_stack.empty())
+        {
+            return nullptr;
+        }
+
+        if (m_stack.size() == 1)
+        {
+            m_element = std::move(value);
+            return &m_element;
+        }
+
+        auto& parent = m_stack.back();
+        if (!m_in_record && parent.record_path >= 0)
+        {
+            m_record      = std::move(value);
+            m_record_key  = parent.value->is_object() ? parent.last_key : std::string{};
+            m_record_path = static_cast<std::size_t>(parent.record_path);
+            m_in_record   = true;
+            return &m_record;
+        }
+
+        if (parent.value->is_array())
+        {
+            parent.value->push_back(std::move(value));
+            return &parent.value->back();
+        }
+        auto& slot = (*parent.value)[parent.last_key];
+        slot       = std::move(value);
+        return &slot;
+    }
+
+    bool
+    json_batch_sax::on_scalar(nlohmann::json&& value)
+    {
+        nlohmann::json* ptr = place(std::move(value));
+        if (ptr == nullptr)
+        {
+            m_error = "mm2 batch answer is not a json array";
+            return false;
+        }
+        if (ptr == &m_record)
+        {
+            m_in_record = false;
+            m_on_record(m_element_idx, m_record_path, std::move(m_record_key), std::move(m_record));
+        }
+        else if (ptr == &m_element)
+        {
+            m_on_element(m_element_idx++, std::move(m_element));
+        }
+        return true;
+    }
+
+    bool
+    json_batch_sax::on_container_start(nlohmann::json&& value)
+    {
+        if (m_stack.empty())
+        {
+            if (!value.is_array())
+            {
+                m_error = "mm2 batch answer is not a json array";
+                return false;
+            }
+            m_stack.push_back(frame{});
+            return true;
+        }
+
+        const bool        is_element_root = m_stack.size() == 1;
+        const bool        was_in_record   = m_in_record;
+        const std::string segment         = (is_element_root || m_stack.back().value->is_array()) ? std::string{} : m_stack.back().last_key;
+
+        frame current;
+        current.value          = place(std::move(value));
+        current.segment        = segment;
+        current.is_record_root = !was_in_record && current.value == &m_record;
+        if (!m_in_record && !is_element_root)
+        {
+            current.record_path = match_record_path(segment);
+        }
+        m_stack.push_back(std::move(current));
+        return true;
+    }
+
+    bool
+    json_batch_sax::on_container_end()
+    {
+        if (m_stack.empty())
+        {
+            return false;
+        }
+
+        frame current = std::move(m_stack.back());
+        m_stack.pop_back();
+        if (current.value == nullptr)
+        {
+            return true;
+        }
+        if (current.is_record_root)
+        {
+            m_in_record = false;
+            m_on_record(m_element_idx, m_record_path, std::move(m_record_key), std::move(m_record));
+        }
+        else if (m_stack.size() == 1)
+        {
+            m_on_element(m_element_idx++, std::move(m_element));
+        }
+        return true;
+    }
+
+    bool
+    json_batch_sax::null()
+    {
+        return on_scalar(nlohmann::json(nullptr));
+    }
+
+    bool
+    json_batch_sax::boolean(bool val)
+    {
+        return on_scalar(nlohmann::json(val));
+    }
+
+    bool
+    json_batch_sax::number_integer(number_integer_t val)
+    {
+        return on_scalar(nlohmann::json(val));
+    }
+
+    bool
+    json_batch_sax::number_unsigned(number_unsigned_t val)
+    {
+        return on_scalar(nlohmann::json(val));
+    }
+
+    bool
+    json_batch_sax::number_float(number_float_t val, [[maybe_unused]] const string_t& s)
+    {
+        return on_scalar(nlohmann::json(val));
+    }
+
+    bool
+    json_batch_sax::string(string_t& val)
+    {
+        return on_scalar(nlohmann::json(std::move(val)));
+    }
+
+    bool
+    json_batch_sax::binary(binary_t& val)
+    {
+        return on_scalar(nlohmann::json::binary(std::move(val)));
+    }
+
+    bool
+    json_batch_sax::start_object([[maybe_unused]] std::size_t elements)
+    {
+        return on_container_start(nlohmann::json::object());
+    }
+
+    bool
+    json_batch_sax::key(string_t& val)
+    {
+        if (m_stack.empty())
+        {
+            return false;
+        }
+        m_stack.back().last_key = std::move(val);
+        return true;
+    }
+
+    bool
+    json_batch_sax::end_object()
+    {
+        return on_container_end();
+    }
+
+    bool
+    json_batch_sax::start_array([[maybe_unused]] std::size_t elements)
+    {
+        return on_container_start(nlohmann::json::array());
+    }
+
+    bool
+    json_batch_sax::end_array()
+    {
+        return on_container_end();
+    }
+
+    bool
+    json_batch_sax::parse_error([[maybe_unused]] std::size_t position, [[maybe_unused]] const std::string& last_token, const nlohmann::detail::exception& ex)
+    {
+        m_error = ex.what();
+        return false;
+    }
+
+    const std::string&
+    json_batch_sax::error() const
+    {
+        return m_error;
+    }
+} // namespace atomic_dex::utils
@@ -0,0 +1,92 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <functional>
+#include <string>
+#include <vector>
+
+//! Deps
+#include <nlohmann/json.hpp>
+
+namespace atomic_dex::utils
+{
+    //! Path of object keys, from the root of a batch element, to a container whose children are streamed as records.
+    //! ex: {"result", "transactions"} streams every transaction of a my_tx_history answer one by one.
+    using t_json_record_path  = std::vector<std::string>;
+    using t_json_record_paths = std::vector<t_json_record_path>;
+
+    //! SAX handler for mm2 batch answers (a top-level json array).
+    //! Every element of the batch is rebuilt as a skeleton dom where the record containers are left empty,
+    //! records are materialized one at a time and handed to `on_record` before being discarded.
+    //! Peak memory is one record plus the skeletons instead of the whole answer dom.
+    class json_batch_sax final : public nlohmann::json_sax<nlohmann::json>
+    {
+      public:
+        using t_record_functor  = std::function<void(std::size_t element_idx, std::size_t path_idx, std::string key, nlohmann::json&& record)>;
+        using t_element_functor = std::function<void(std::size_t element_idx, nlohmann::json&& skeleton)>;
+        using t_paths_functor   = std::function<const t_json_record_paths*(std::size_t element_idx)>;
+
+        json_batch_sax(t_paths_functor paths, t_record_functor on_record, t_element_functor on_element);
+
+        bool null() override;
+        bool boolean(bool val) override;
+        bool number_integer(number_integer_t val) override;
+        bool number_unsigned(number_unsigned_t val) override;
+        bool number_float(number_float_t val, const string_t& s) override;
+        bool string(string_t& val) override;
+        bool binary(binary_t& val) override;
+        bool start_object(std::size_t elements) override;
+        bool key(string_t& val) override;
+        bool end_object() override;
+        bool start_array(std::size_t elements) override;
+        bool end_array() override;
+        bool parse_error(std::size_t position, const std::string& last_token, const nlohmann::detail::exception& ex) override;
+
+        [[nodiscard]] const std::string& error() const;
+
+      private:
+        struct frame
+        {
+            nlohmann::json* value{nullptr}; ///< nullptr for the batch array itself
+            std::string     last_key;
+            std::string     segment;         ///< key used to reach this container from its parent ("" for array items)
+            int             record_path{-1}; ///< >= 0 when the children of this container are records
+            bool            is_record_root{false};
+        };
+
+        nlohmann::json* place(nlohmann::json&& value);
+        bool            on_scalar(nlohmann::json&& value);
+        bool            on_container_start(nlohmann::json&& value);
+        bool            on_container_end();
+        int             match_record_path(const std::string& segment) const;
+
+        t_paths_functor   m_paths;
+        t_record_functor  m_on_record;
+        t_element_functor m_on_element;
+
+        std::vector<frame> m_stack;
+        nlohmann::json     m_element;
+        nlohmann::json     m_record;
+        std::string        m_record_key;
+        std::size_t        m_record_path{0};
+        bool               m_in_record{false};
+        std::size_t        m_element_idx{0};
+        std::string        m_error;
+    };
+} // namespace atomic_dex::utils
@@ -14,6 +14,9 @@
  *                                                                            *
  ******************************************************************************/
 
+//! STD
+#include <cmath>
+
 //! QT Headers
 #include <QClipboard>
 #include <QGuiApplication>
@@ -30,22 +33,96 @@
 
 namespace atomic_dex
 {
+    QJsonValue
+    nlohmann_json_to_qt_json_value(const nlohmann::json& j)
+    {
+        switch (j.type())
+        {
+        case nlohmann::json::value_t::object:
+        {
+            QJsonObject out;
+            for (auto it = j.begin(); it != j.end(); ++it) { out.insert(QString::fromStdString(it.key()), nlohmann_json_to_qt_json_value(it.value())); }
+            return out;
+        }
+        case nlohmann::json::value_t::array:
+        {
+            QJsonArray out;
+            for (auto&& value: j) { out.append(nlohmann_json_to_qt_json_value(value)); }
+            return out;
+        }
+        case nlohmann::json::value_t::string:
+            return QString::fromStdString(j.get_ref<const std::string&>());
+        case nlohmann::json::value_t::boolean:
+            return j.get<bool>();
+        case nlohmann::json::value_t::number_integer:
+            return static_cast<qint64>(j.get<std::int64_t>());
+        case nlohmann::json::value_t::number_unsigned:
+            return static_cast<double>(j.get<std::uint64_t>());
+        case nlohmann::json::value_t::number_float:
+            //! dump() writes a non finite number as null
+            return std::isfinite(j.get<double>()) ? QJsonValue(j.get<double>()) : QJsonValue(QJsonValue::Null);
+        default:
+            return QJsonValue(QJsonValue::Null);
+        }
+    }
+
+    nlohmann::json
+    qt_json_value_to_nlohmann_json(const QJsonValue& value)
+    {
+        switch (value.type())
+        {
+        case QJsonValue::Object:
+        {
+            const QJsonObject obj = value.toObject();
+            nlohmann::json    out = nlohmann::json::object();
+            for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) { out.emplace(it.key().toStdString(), qt_json_value_to_nlohmann_json(it.value())); }
+            return out;
+        }
+        case QJsonValue::Array:
+        {
+            const QJsonArray arr = value.toArray();
+            nlohmann::json   out = nlohmann::json::array();
+            out.get_ref<nlohmann::json::array_t&>().reserve(static_cast<std::size_t>(arr.size()));
+            for (auto&& cur: arr) { out.push_back(qt_json_value_to_nlohmann_json(cur)); }
+            return out;
+        }
+        case QJsonValue::String:
+            return value.toString().toStdString();
+        case QJsonValue::Bool:
+            return value.toBool();
+        case QJsonValue::Double:
+        {
+            //! Same types as QJsonDocument::toJson followed by nlohmann::json::parse: integral values below 2^53 are written as integers
+            const double number = value.toDouble();
+            if (!std::isfinite(number))
+            {
+                return nullptr;
+            }
+            if (std::trunc(number) == number && std::fabs(number) < 9007199254740992.0)
+            {
+                if (number >= 0)
+                {
+                    return static_cast<std::uint64_t>(number);
+                }
+                return static_cast<std::int64_t>(number);
+            }
+            return number;
+        }
+        default:
+            return nullptr;
+        }
+    }
+
     QJsonArray
     nlohmann_json_array_to_qt_json_array(const nlohmann::json& j)
     {
-        QJsonArray    out;
-        QJsonDocument q_json = QJsonDocument::fromJson(QString::fromStdString(j.dump()).toUtf8());
-        out                  = q_json.array();
-        return out;
+        return j.is_array() ? nlohmann_json_to_qt_json_value(j).toArray() : QJsonArray{};
     }
 
     QJsonObject
     nlohmann_json_object_to_qt_json_object(const nlohmann::json& j)
     {
-        QJsonObject   obj;
-        QJsonDocument q_json = QJsonDocument::fromJson(QString::fromStdString(j.dump()).toUtf8());
-        obj                  = q_json.object();
-        return obj;
+        return j.is_object() ? nlohmann_json_to_qt_json_value(j).toObject() : QJsonObject{};
     }
 
     QString
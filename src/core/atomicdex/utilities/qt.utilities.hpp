@@ -17,7 +17,9 @@
 #pragma once
 
 //! QT Headers
+#include <QJsonArray>
 #include <QJsonObject>
+#include <QJsonValue>
 #include <QModelIndex>
 #include <QString>
 #include <QStringList>
@@ -50,6 +52,11 @@ namespace atomic_dex
     ENTT_API QStringList qt_variant_list_to_qt_string_list(const QVariantList& variant_list);
     QJsonArray           nlohmann_json_array_to_qt_json_array(const nlohmann::json& j);
     QJsonObject          nlohmann_json_object_to_qt_json_object(const nlohmann::json& j);
+
+    //! One pass conversions between the two json trees, without serializing to text and parsing it back.
+    QJsonValue     nlohmann_json_to_qt_json_value(const nlohmann::json& j);
+    nlohmann::json qt_json_value_to_nlohmann_json(const QJsonValue& value);
+
     QString              retrieve_change_24h(
                      const atomic_dex::komodo_prices_provider& provider, const atomic_dex::coin_config& coin, const atomic_dex::cfg& config,
                      const ag::ecs::system_manager& system_manager);
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+namespace atomic_dex
+{
+    //! Read-copy-update holder for registries read far more often than written (balances, coins configuration).
+    //! Readers grab a refcounted immutable snapshot, a snapshot stays valid as long as it is held.
+    //! Reads are not lock-free: the atomic shared_ptr load may take a short internal lock (std::atomic<std::shared_ptr> in libstdc++ spins on a lock bit of
+    //! its pointer, the pre C++20 free functions hash it to a pooled mutex), but a reader never waits for a writer copying or editing the registry.
+    //! Writers are serialized, they edit a private copy of the current version and publish it atomically.
+    template <typename TValue>
+    class rcu_registry
+    {
+      public:
+        using t_snapshot = std::shared_ptr<const TValue>;
+
+        rcu_registry() : m_current(std::make_shared<const TValue>()) {}
+        explicit rcu_registry(TValue initial) : m_current(std::make_shared<const TValue>(std::move(initial))) {}
+
+        rcu_registry(const rcu_registry& other) = delete;
+        rcu_registry& operator=(const rcu_registry& other) = delete;
+
+        [[nodiscard]] t_snapshot
+        snapshot() const noexcept
+        {
+#if defined(__cpp_lib_atomic_shared_ptr)
+            return m_current.load(std::memory_order_acquire);
+#else
+            return std::atomic_load_explicit(&m_current, std::memory_order_acquire);
+#endif
+        }
+
+        //! `functor(TValue&)` edits a copy of the current version, the copy is published once it returns.
+        //! Returns whatever the functor returns.
+        template <typename TFunctor>
+        decltype(auto)
+        update(TFunctor&& functor)
+        {
+            std::scoped_lock lock(m_writer_mutex);
+            auto             next = std::make_shared<TValue>(*snapshot());
+            if constexpr (std::is_void_v<decltype(functor(*next))>)
+            {
+                functor(*next);
+                publish_locked(std::move(next));
+            }
+            else
+            {
+                auto result = functor(*next);
+                publish_locked(std::move(next));
+                return result;
+            }
+        }
+
+        //! Replaces the whole registry.
+        void
+        publish(TValue value)
+        {
+            std::scoped_lock lock(m_writer_mutex);
+            publish_locked(std::make_shared<TValue>(std::move(value)));
+        }
+
+        [[nodiscard]] std::uint64_t
+        version() const noexcept
+        {
+            return m_version.load(std::memory_order_acquire);
+        }
+
+      private:
+        void
+        publish_locked(std::shared_ptr<TValue> next)
+        {
+#if defined(__cpp_lib_atomic_shared_ptr)
+            m_current.store(t_snapshot(std::move(next)), std::memory_order_release);
+#else
+            std::atomic_store_explicit(&m_current, t_snapshot(std::move(next)), std::memory_order_release);
+#endif
+            m_version.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+        std::atomic<t_snapshot> m_current;
+#else
+        t_snapshot m_current; ///< the std::atomic_load / atomic_store free functions, deprecated in C++20
+#endif
+        std::mutex           m_writer_mutex;
+        std::atomic_uint64_t m_version{0};
+    };
+} // namespace atomic_dex
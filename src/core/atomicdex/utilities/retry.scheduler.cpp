@@ -0,0 +1,301 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+//! STD
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+//! Project Headers
+#include "atomicdex/utilities/retry.scheduler.hpp"
+
+namespace atomic_dex
+{
+    struct retry_scheduler::job
+    {
+        std::string  host;
+        t_attempt    attempt;
+        t_give_up    on_give_up;
+        retry_policy policy;
+        std::size_t  attempt_no{0};
+    };
+
+    retry_scheduler::retry_scheduler(retry_scheduler_cfg cfg) :
+        m_cfg(std::move(cfg)), m_slots(std::max<std::size_t>(m_cfg.nb_slots, 1)), m_next_tick(t_clock::now()), m_window_start(t_clock::now())
+    {
+        m_cfg.tick = std::max(m_cfg.tick, std::chrono::milliseconds(1));
+        m_thread     = std::thread([this]() { process_wheel(); });
+    }
+
+    retry_scheduler::~retry_scheduler()
+    {
+        stop();
+    }
+
+    void
+    retry_scheduler::stop()
+    {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopped = true;
+        }
+        m_cv.notify_all();
+        if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id())
+        {
+            m_thread.join();
+        }
+
+        //! Nothing is scheduled anymore once stopped, the pending tasks are cancelled so their owners are not left waiting.
+        std::vector<t_task> dropped;
+        {
+            std::scoped_lock lock(m_mutex);
+            for (auto&& slot: m_slots)
+            {
+                for (auto&& current: slot)
+                {
+                    if (current.on_drop)
+                    {
+                        dropped.push_back(std::move(current.on_drop));
+                    }
+                }
+                slot.clear();
+            }
+            m_metrics.dropped += m_pending;
+            m_pending = 0;
+        }
+        for (auto&& on_drop: dropped) { on_drop(); }
+    }
+
+    void
+    retry_scheduler::set_host_limits(const std::string& host, token_bucket_cfg cfg)
+    {
+        std::scoped_lock lock(m_mutex);
+        m_buckets.insert_or_assign(host, bucket{.cfg = cfg, .tokens = cfg.capacity, .last_refill = t_clock::now()});
+    }
+
+    std::chrono::milliseconds
+    retry_scheduler::take_token(const std::string& host, t_clock::time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        auto             it = m_buckets.find(host);
+        if (it == m_buckets.end())
+        {
+            it = m_buckets.emplace(host, bucket{.cfg = m_cfg.default_bucket, .tokens = m_cfg.default_bucket.capacity, .last_refill = now}).first;
+        }
+
+        auto&        current = it->second;
+        const double elapsed = std::chrono::duration<double>(std::max(now - current.last_refill, t_clock::duration::zero())).count();
+        current.tokens       = std::min(current.cfg.capacity, current.tokens + elapsed * current.cfg.refill_per_second);
+        current.last_refill  = std::max(now, current.last_refill);
+
+        //! The balance may go negative: waiting callers hold a reservation and are spaced by the refill rate.
+        current.tokens -= 1;
+        if (current.tokens >= 0 || current.cfg.refill_per_second <= 0)
+        {
+            return std::chrono::milliseconds::zero();
+        }
+        m_metrics.throttled += 1;
+        return std::chrono::milliseconds(static_cast<std::int64_t>(std::ceil(-current.tokens / current.cfg.refill_per_second * 1000.0)));
+    }
+
+    std::chrono::milliseconds
+    retry_scheduler::backoff(const retry_policy& policy, std::size_t attempt)
+    {
+        const auto   exponent = static_cast<double>(std::min<std::size_t>(attempt > 0 ? attempt - 1 : 0, 32));
+        const double capped   = std::min(static_cast<double>(policy.base_delay.count()) * std::pow(2.0, exponent), static_cast<double>(policy.max_delay.count()));
+
+        std::scoped_lock                       lock(m_mutex);
+        std::uniform_real_distribution<double> dist(0.0, std::clamp(policy.jitter, 0.0, 1.0));
+        return std::chrono::milliseconds(static_cast<std::int64_t>(capped * (1.0 - dist(m_rng))));
+    }
+
+    void
+    retry_scheduler::run(std::string host, t_attempt attempt, t_give_up on_give_up, retry_policy policy)
+    {
+        auto current = std::make_shared<job>(job{.host = std::move(host), .attempt = std::move(attempt), .on_give_up = std::move(on_give_up), .policy = policy});
+        {
+            std::scoped_lock lock(m_mutex);
+            const auto       now = t_clock::now();
+            if (now - m_window_start >= m_cfg.budget.window)
+            {
+                m_window_start    = now;
+                m_window_requests = 0;
+                m_window_retries  = 0;
+            }
+            m_window_requests += 1;
+            m_metrics.requests += 1;
+        }
+        dispatch(current);
+    }
+
+    void
+    retry_scheduler::dispatch(const std::shared_ptr<job>& current)
+    {
+        auto fire = [this, current]()
+        {
+            {
+                std::scoped_lock lock(m_mutex);
+                m_metrics.attempts += 1;
+            }
+            current->attempt(current->attempt_no, [this, current](attempt_result result) { on_report(current, result); });
+        };
+
+        if (const auto wait = take_token(current->host); wait > std::chrono::milliseconds::zero())
+        {
+            schedule_after(wait, std::move(fire), [this, current]() { drop(current); });
+        }
+        else
+        {
+            fire();
+        }
+    }
+
+    bool
+    retry_scheduler::allow_retry(t_clock::time_point now)
+    {
+        std::scoped_lock lock(m_mutex);
+        if (now - m_window_start >= m_cfg.budget.window)
+        {
+            m_window_start    = now;
+            m_window_requests = 0;
+            m_window_retries  = 0;
+        }
+        const auto allowed = std::max(m_cfg.budget.min_retries, static_cast<std::size_t>(m_cfg.budget.ratio * static_cast<double>(m_window_requests)));
+        if (m_window_retries >= allowed)
+        {
+            m_metrics.budget_exhausted += 1;
+            return false;
+        }
+        m_window_retries += 1;
+        m_metrics.retries += 1;
+        return true;
+    }
+
+    void
+    retry_scheduler::on_report(const std::shared_ptr<job>& current, attempt_result result)
+    {
+        if (result.verdict == retry_verdict::done)
+        {
+            std::scoped_lock lock(m_mutex);
+            m_metrics.succeeded += 1;
+            return;
+        }
+
+        current->attempt_no += 1;
+        if (current->attempt_no >= current->policy.max_attempts || !allow_retry(t_clock::now()))
+        {
+            {
+                std::scoped_lock lock(m_mutex);
+                m_metrics.gave_up += 1;
+            }
+            if (current->on_give_up)
+            {
+                current->on_give_up(nullptr);
+            }
+            return;
+        }
+
+        const auto delay = std::max(backoff(current->policy, current->attempt_no), std::min(result.retry_after, current->policy.max_delay));
+        schedule_after(delay, [this, current]() { dispatch(current); }, [this, current]() { drop(current); });
+    }
+
+    void
+    retry_scheduler::drop(const std::shared_ptr<job>& current)
+    {
+        if (current->on_give_up)
+        {
+            current->on_give_up(std::make_exception_ptr(retry_scheduler_stopped{}));
+        }
+    }
+
+    void
+    retry_scheduler::schedule_after(std::chrono::milliseconds delay, t_task task, t_task on_drop)
+    {
+        {
+            std::unique_lock lock(m_mutex);
+            if (m_stopped)
+            {
+                m_metrics.dropped += 1;
+                lock.unlock();
+                if (on_drop)
+                {
+                    on_drop();
+                }
+                return;
+            }
+            if (m_pending == 0)
+            {
+                //! The wheel thread sleeps while there is nothing scheduled, restart the ticks from now.
+                m_next_tick = t_clock::now() + m_cfg.tick;
+            }
+            const std::size_t nb_slots = m_slots.size();
+            const std::size_t ticks    = std::max<std::size_t>(1, static_cast<std::size_t>((delay + m_cfg.tick - std::chrono::milliseconds(1)) / m_cfg.tick));
+            m_slots[(m_cursor + ticks) % nb_slots].push_back(timer{.rounds = (ticks - 1) / nb_slots, .task = std::move(task), .on_drop = std::move(on_drop)});
+            m_pending += 1;
+            m_metrics.timers += 1;
+            m_metrics.max_pending = std::max(m_metrics.max_pending, m_pending);
+        }
+        m_cv.notify_all();
+    }
+
+    void
+    retry_scheduler::process_wheel()
+    {
+        std::unique_lock lock(m_mutex);
+        while (!m_stopped)
+        {
+            if (m_pending == 0)
+            {
+                m_cv.wait(lock, [this]() { return m_pending > 0 || m_stopped; });
+                continue;
+            }
+            if (m_cv.wait_until(lock, m_next_tick, [this]() { return m_stopped; }))
+            {
+                break;
+            }
+
+            m_next_tick += m_cfg.tick;
+            m_cursor = (m_cursor + 1) % m_slots.size();
+            std::vector<t_task> due;
+            auto&               slot = m_slots[m_cursor];
+            for (auto it = slot.begin(); it != slot.end();)
+            {
+                if (it->rounds == 0)
+                {
+                    due.push_back(std::move(it->task));
+                    it = slot.erase(it);
+                }
+                else
+                {
+                    it->rounds -= 1;
+                    ++it;
+                }
+            }
+            m_pending -= due.size();
+
+            lock.unlock();
+            for (auto&& task: due) { task(); }
+            lock.lock();
+        }
+    }
+
+    retry_scheduler_metrics
+    retry_scheduler::get_metrics() const
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_metrics;
+    }
+} // namespace atomic_dex
@@ -0,0 +1,172 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#pragma once
+
+//! STD
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace atomic_dex
+{
+    struct retry_policy
+    {
+        std::size_t               max_attempts{10};
+        std::chrono::milliseconds base_delay{500};
+        std::chrono::milliseconds max_delay{30000};
+        double                    jitter{0.5}; ///< fraction of the exponential delay that is randomized away
+    };
+
+    struct token_bucket_cfg
+    {
+        double capacity{10};         ///< burst size
+        double refill_per_second{5}; ///< sustained requests per second
+    };
+
+    //! Retries are allowed while they stay under `ratio` of the first attempts of the window, with a floor of `min_retries`.
+    struct retry_budget_cfg
+    {
+        double               ratio{0.2};
+        std::size_t          min_retries{10};
+        std::chrono::seconds window{10};
+    };
+
+    struct retry_scheduler_cfg
+    {
+        std::chrono::milliseconds tick{50};
+        std::size_t               nb_slots{512};
+        token_bucket_cfg          default_bucket{};
+        retry_budget_cfg          budget{};
+    };
+
+    struct retry_scheduler_metrics
+    {
+        std::size_t requests{0};         ///< jobs started with run
+        std::size_t attempts{0};         ///< first attempts and retries
+        std::size_t retries{0};
+        std::size_t throttled{0};        ///< attempts delayed by the host token bucket
+        std::size_t budget_exhausted{0}; ///< retries denied by the budget
+        std::size_t succeeded{0};
+        std::size_t gave_up{0};
+        std::size_t dropped{0};          ///< jobs and tasks cancelled by stop
+        std::size_t timers{0};           ///< tasks scheduled on the wheel
+        std::size_t max_pending{0};
+    };
+
+    enum class retry_verdict
+    {
+        done,
+        retry
+    };
+
+    struct attempt_result
+    {
+        retry_verdict             verdict{retry_verdict::done};
+        std::chrono::milliseconds retry_after{0}; ///< lower bound of the next delay, ex: a Retry-After header
+    };
+
+    //! Reason given to the give up callbacks of the jobs cancelled by stop.
+    struct retry_scheduler_stopped : std::runtime_error
+    {
+        retry_scheduler_stopped() : std::runtime_error("retry scheduler stopped") {}
+    };
+
+    //! Shared retry scheduler for the http providers.
+    //! Delays live on a hashed timer wheel served by a single thread, no pool thread ever sleeps waiting for a retry.
+    //! Every attempt takes a token of its host bucket, retries use an exponential backoff with jitter and are capped by a global budget.
+    class retry_scheduler
+    {
+      public:
+        using t_clock   = std::chrono::steady_clock;
+        using t_task    = std::function<void()>;
+        using t_report  = std::function<void(attempt_result)>;
+        using t_attempt = std::function<void(std::size_t attempt, t_report report)>;
+        using t_give_up = std::function<void(std::exception_ptr reason)>; ///< reason is null when the attempts or the budget are exhausted
+
+        explicit retry_scheduler(retry_scheduler_cfg cfg = {});
+        ~retry_scheduler();
+
+        retry_scheduler(const retry_scheduler& other) = delete;
+        retry_scheduler& operator=(const retry_scheduler& other) = delete;
+
+        void set_host_limits(const std::string& host, token_bucket_cfg cfg);
+
+        //! Calls `attempt` until it reports done, `on_give_up` is called once the attempts or the budget are exhausted,
+        //! or with a retry_scheduler_stopped reason when the scheduler is stopped before the job is over.
+        //! The first attempt runs in the caller thread when a token is available, the following ones on the wheel thread.
+        void run(std::string host, t_attempt attempt, t_give_up on_give_up, retry_policy policy = {});
+
+        //! Runs `task` on the wheel thread once `delay` is elapsed, rounded up to the wheel tick.
+        //! `on_drop` runs instead when the scheduler is stopped before the deadline, or is already stopped.
+        void schedule_after(std::chrono::milliseconds delay, t_task task, t_task on_drop = {});
+
+        //! Reserves a token of the host bucket, returns how long the caller has to wait before using it.
+        std::chrono::milliseconds take_token(const std::string& host, t_clock::time_point now = t_clock::now());
+
+        [[nodiscard]] std::chrono::milliseconds backoff(const retry_policy& policy, std::size_t attempt);
+        [[nodiscard]] retry_scheduler_metrics   get_metrics() const;
+
+        //! Joins the wheel thread, then runs the `on_drop` of every pending task.
+        void stop();
+
+      private:
+        struct job;
+        struct timer
+        {
+            std::size_t rounds;
+            t_task      task;
+            t_task      on_drop;
+        };
+        struct bucket
+        {
+            token_bucket_cfg    cfg;
+            double              tokens;
+            t_clock::time_point last_refill;
+        };
+
+        void dispatch(const std::shared_ptr<job>& current);
+        void on_report(const std::shared_ptr<job>& current, attempt_result result);
+        void drop(const std::shared_ptr<job>& current);
+        bool allow_retry(t_clock::time_point now);
+        void process_wheel();
+
+        retry_scheduler_cfg                     m_cfg;
+        mutable std::mutex                      m_mutex;
+        std::condition_variable                 m_cv;
+        std::vector<std::vector<timer>>         m_slots;
+        std::size_t                             m_cursor{0};
+        std::size_t                             m_pending{0};
+        t_clock::time_point                     m_next_tick;
+        std::unordered_map<std::string, bucket> m_buckets;
+        t_clock::time_point                     m_window_start;
+        std::size_t                             m_window_requests{0};
+        std::size_t                             m_window_retries{0};
+        std::mt19937                            m_rng{std::random_device{}()};
+        retry_scheduler_metrics                 m_metrics;
+        bool                                    m_stopped{false};
+        std::thread                             m_thread;
+    };
+} // namespace atomic_dex
@@ -0,0 +1,210 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! Deps
+#include <doctest/doctest.h>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/api/mm2/mm2.batch.decoder.hpp"
+
+namespace
+{
+    nlohmann::json
+    make_fraction(const std::string& numer, const std::string& denom)
+    {
+        return nlohmann::json{{"numer", numer}, {"denom", denom}};
+    }
+
+    nlohmann::json
+    make_order(std::size_t idx, const std::string& coin)
+    {
+        const std::string price  = std::to_string(1 + idx % 7) + ".5";
+        const std::string volume = std::to_string(10 + idx % 13);
+        return nlohmann::json{
+            {"coin", coin},
+            {"address", "RAddress" + std::to_string(idx)},
+            {"price", price},
+            {"price_fraction", make_fraction("3", "2")},
+            {"max_volume_fraction", make_fraction(volume, "1")},
+            {"base_min_volume_fraction", make_fraction("1", "100")},
+            {"base_max_volume_fraction", make_fraction(volume, "1")},
+            {"rel_min_volume_fraction", make_fraction("1", "100")},
+            {"rel_max_volume_fraction", make_fraction(volume, "1")},
+            {"maxvolume", volume},
+            {"pubkey", "03pubkey" + std::to_string(idx)},
+            {"age", idx},
+            {"zcredits", 0},
+            {"uuid", "uuid-" + coin + "-" + std::to_string(idx)},
+            {"is_mine", false},
+            {"base_max_volume", volume},
+            {"base_min_volume", "0.01"},
+            {"rel_max_volume", volume},
+            {"rel_min_volume", "0.01"}};
+    }
+
+    nlohmann::json
+    make_transaction(std::size_t idx)
+    {
+        return nlohmann::json{
+            {"block_height", 1000 + idx},
+            {"coin", "KMD"},
+            {"fee_details", {{"amount", "0.0001"}}},
+            {"from", {"RFrom" + std::to_string(idx)}},
+            {"internal_id", "internal" + std::to_string(idx)},
+            {"my_balance_change", idx % 2 == 0 ? "-1.5" : "2.5"},
+            {"received_by_me", "2.5"},
+            {"spent_by_me", "1.5"},
+            {"timestamp", 1600000000 + idx},
+            {"to", {"RTo" + std::to_string(idx)}},
+            {"total_amount", "4"},
+            {"tx_hash", "hash" + std::to_string(idx)},
+            {"tx_hex", "0400008085202f89"}};
+    }
+
+    //! Synthetic batch: orderbook, my_tx_history, my_balance and a rpc that is not decoded by the streaming pass.
+    std::pair<nlohmann::json, std::string>
+    make_batch(std::size_t nb_orders, std::size_t nb_transactions)
+    {
+        nlohmann::json request = nlohmann::json::array();
+        request.push_back({{"method", "orderbook"}, {"base", "KMD"}, {"rel", "BTC"}});
+        request.push_back({{"method", "my_tx_history"}, {"coin", "KMD"}});
+        request.push_back({{"method", "my_balance"}, {"coin", "KMD"}});
+        request.push_back({{"method", "version"}});
+
+        nlohmann::json orderbook{
+            {"base", "KMD"}, {"rel", "BTC"}, {"askdepth", 0}, {"biddepth", 0}, {"numasks", nb_orders}, {"numbids", nb_orders},
+            {"netid", 7777}, {"timestamp", 1600000000}, {"asks", nlohmann::json::array()}, {"bids", nlohmann::json::array()}};
+        for (std::size_t idx = 0; idx < nb_orders; ++idx)
+        {
+            orderbook["asks"].push_back(make_order(idx, "KMD"));
+            orderbook["bids"].push_back(make_order(idx, "BTC"));
+        }
+
+        nlohmann::json history{
+            {"result",
+             {{"current_block", 2000},
+              {"from_id", nullptr},
+              {"limit", nb_transactions},
+              {"skipped", 0},
+              {"sync_status", {{"state", "Finished"}}},
+              {"total", nb_transactions},
+              {"transactions", nlohmann::json::array()}}}};
+        for (std::size_t idx = 0; idx < nb_transactions; ++idx) { history["result"]["transactions"].push_back(make_transaction(idx)); }
+
+        nlohmann::json answers = nlohmann::json::array();
+        answers.push_back(orderbook);
+        answers.push_back(history);
+        answers.push_back({{"address", "RAddress"}, {"balance", "12.5"}, {"coin", "KMD"}});
+        answers.push_back({{"result", "2.1.0"}});
+        return {request, answers.dump()};
+    }
+} // namespace
+
+TEST_CASE("mm2::api::decode_batch_answer streaming matches the json dom decoding")
+{
+    auto&& [request, body] = make_batch(25, 40);
+    auto decoded           = mm2::api::decode_batch_answer(body, request);
+    REQUIRE_FALSE(decoded.error.has_value());
+    CHECK(decoded.streamed);
+    REQUIRE_EQ(decoded.answers.size(), 4);
+
+    auto dom = nlohmann::json::parse(body);
+
+    //! Orderbook
+    REQUIRE(std::holds_alternative<mm2::api::orderbook_answer>(decoded.answers[0]));
+    const auto& streamed_book = std::get<mm2::api::orderbook_answer>(decoded.answers[0]);
+    const auto  dom_book      = mm2::api::rpc_process_answer_batch<mm2::api::orderbook_answer>(dom[0], "orderbook");
+    CHECK_EQ(streamed_book.rpc_result_code, dom_book.rpc_result_code);
+    CHECK_EQ(streamed_book.asks.size(), dom_book.asks.size());
+    CHECK_EQ(streamed_book.bids.size(), dom_book.bids.size());
+    CHECK_EQ(streamed_book.asks_total_volume, dom_book.asks_total_volume);
+    CHECK_EQ(streamed_book.bids_total_volume, dom_book.bids_total_volume);
+    for (std::size_t idx = 0; idx < dom_book.bids.size(); ++idx)
+    {
+        CHECK_EQ(streamed_book.bids.uuid(idx), dom_book.bids.uuid(idx));
+        CHECK_EQ(streamed_book.bids.number(idx, mm2::api::order_number::max_volume), dom_book.bids.number(idx, mm2::api::order_number::max_volume));
+        CHECK_EQ(streamed_book.bids.number(idx, mm2::api::order_number::depth_percent), dom_book.bids.number(idx, mm2::api::order_number::depth_percent));
+    }
+
+    //! Transactions
+    REQUIRE(std::holds_alternative<mm2::api::tx_history_answer>(decoded.answers[1]));
+    const auto& streamed_history = std::get<mm2::api::tx_history_answer>(decoded.answers[1]);
+    const auto  dom_history      = mm2::api::rpc_process_answer_batch<mm2::api::tx_history_answer>(dom[1], "my_tx_history");
+    REQUIRE(streamed_history.result.has_value());
+    REQUIRE(dom_history.result.has_value());
+    CHECK_EQ(streamed_history.result->total, dom_history.result->total);
+    REQUIRE_EQ(streamed_history.result->transactions.size(), dom_history.result->transactions.size());
+    for (std::size_t idx = 0; idx < dom_history.result->transactions.size(); ++idx)
+    {
+        CHECK_EQ(streamed_history.result->transactions[idx].tx_hash, dom_history.result->transactions[idx].tx_hash);
+        CHECK_EQ(streamed_history.result->transactions[idx].my_balance_change, dom_history.result->transactions[idx].my_balance_change);
+    }
+
+    //! Balance and passthrough rpc
+    REQUIRE(std::holds_alternative<mm2::api::balance_answer>(decoded.answers[2]));
+    CHECK_EQ(std::get<mm2::api::balance_answer>(decoded.answers[2]).balance, "12.5");
+    REQUIRE(std::holds_alternative<nlohmann::json>(decoded.answers[3]));
+    CHECK_EQ(std::get<nlohmann::json>(decoded.answers[3]), dom[3]);
+}
+
+TEST_CASE("mm2::api::decode_batch_answer reports errors")
+{
+    nlohmann::json request = nlohmann::json::array({{{"method", "my_balance"}, {"coin", "KMD"}}});
+
+    auto whole_batch = mm2::api::decode_batch_answer(R"({"error":"rpc is not available"})", request);
+    CHECK(whole_batch.error.has_value());
+
+    auto element = mm2::api::decode_batch_answer(R"([{"error":"No such coin KMD"}])", request);
+    CHECK_FALSE(element.error.has_value());
+    REQUIRE_EQ(element.answers.size(), 1);
+    CHECK(std::holds_alternative<nlohmann::json>(element.answers[0]));
+
+    auto truncated = mm2::api::decode_batch_answer(R"([{"address":"RAddress","bal)", request);
+    CHECK(truncated.error.has_value());
+    CHECK_FALSE(truncated.streamed);
+}
+
+TEST_CASE("mm2::api::decode_batch_answer benchmark" * doctest::skip(true))
+{
+    auto&& [request, body] = make_batch(5000, 5000);
+    constexpr int nb_iterations = 20;
+
+    spdlog::stopwatch dom_stopwatch;
+    for (int idx = 0; idx < nb_iterations; ++idx)
+    {
+        auto dom     = nlohmann::json::parse(body);
+        auto book    = mm2::api::rpc_process_answer_batch<mm2::api::orderbook_answer>(dom[0], "orderbook");
+        auto history = mm2::api::rpc_process_answer_batch<mm2::api::tx_history_answer>(dom[1], "my_tx_history");
+        CHECK_EQ(book.asks.size(), 5000);
+        CHECK_EQ(history.result->transactions.size(), 5000);
+    }
+    const auto dom_elapsed = dom_stopwatch.elapsed();
+
+    spdlog::stopwatch streaming_stopwatch;
+    for (int idx = 0; idx < nb_iterations; ++idx)
+    {
+        auto decoded = mm2::api::decode_batch_answer(body, request);
+        CHECK(decoded.streamed);
+    }
+    const auto streaming_elapsed = streaming_stopwatch.elapsed();
+
+    SPDLOG_INFO(
+        "decode_batch_answer: body {} bytes, json dom {:.3f}s, streaming {:.3f}s over {} iterations", body.size(), dom_elapsed.count(),
+        streaming_elapsed.count(), nb_iterations);
+}
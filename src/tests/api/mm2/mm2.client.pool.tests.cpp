@@ -0,0 +1,156 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! Deps
+#include <cpprest/http_listener.h>
+#include <doctest/doctest.h>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/api/mm2/mm2.client.pool.hpp"
+
+namespace
+{
+    constexpr const char* g_stub_endpoint = "http://127.0.0.1:17783";
+
+    //! Minimal mm2 stand-in answering every batch with a static body.
+    struct stub_mm2_server
+    {
+        web::http::experimental::listener::http_listener listener{FROM_STD_STR(g_stub_endpoint)};
+
+        stub_mm2_server()
+        {
+            listener.support(
+                web::http::methods::POST, [](web::http::http_request req) { req.reply(web::http::status_codes::OK, FROM_STD_STR(R"([{"result":"success"}])")); });
+            listener.open().wait();
+        }
+
+        ~stub_mm2_server() { listener.close().wait(); }
+    };
+
+    web::http::http_request
+    make_stub_request()
+    {
+        web::http::http_request request;
+        request.set_method(web::http::methods::POST);
+        request.set_body(R"([{"method":"version"}])");
+        return request;
+    }
+} // namespace
+
+TEST_CASE("atomic_dex::mm2_client_pool reuses released clients")
+{
+    atomic_dex::mm2_client_pool     pool(g_stub_endpoint, 1);
+    pplx::cancellation_token_source token_source;
+
+    auto first = pool.acquire(token_source.get_token()).get();
+    CHECK_EQ(pool.get_metrics().misses, 1);
+    CHECK_EQ(pool.get_metrics().in_flight, 1);
+
+    auto second_task = pool.acquire(token_source.get_token());
+    CHECK_FALSE(second_task.is_done());
+    CHECK_EQ(pool.get_metrics().queued, 1);
+
+    first.reset();
+    auto second = second_task.get();
+    CHECK_NE(second, nullptr);
+
+    const auto metrics = pool.get_metrics();
+    CHECK_EQ(metrics.hits, 1);
+    CHECK_EQ(metrics.misses, 1);
+    CHECK_EQ(metrics.waits, 1);
+    CHECK_EQ(metrics.queued, 0);
+}
+
+TEST_CASE("atomic_dex::mm2_client_pool fails queued leases on cancellation")
+{
+    atomic_dex::mm2_client_pool     pool(g_stub_endpoint, 1);
+    pplx::cancellation_token_source token_source;
+
+    auto first   = pool.acquire(token_source.get_token()).get();
+    auto pending = pool.acquire(token_source.get_token());
+    pool.cancel_pending();
+    CHECK_THROWS_AS(pending.get(), pplx::task_canceled);
+    CHECK_NE(first, nullptr);
+}
+
+TEST_CASE("atomic_dex::mm2_client_pool fails a queued lease as soon as its token is cancelled")
+{
+    atomic_dex::mm2_client_pool     pool(g_stub_endpoint, 1);
+    pplx::cancellation_token_source owner_source;
+    pplx::cancellation_token_source request_source;
+
+    //! The only client is never released, only the token can end the wait
+    auto first   = pool.acquire(owner_source.get_token()).get();
+    auto pending = pool.acquire(request_source.get_token());
+    auto other   = pool.acquire(owner_source.get_token());
+    request_source.cancel();
+    CHECK_THROWS_AS(pending.get(), pplx::task_canceled);
+    CHECK_FALSE(other.is_done());
+    CHECK_EQ(pool.get_metrics().queued, 1);
+    CHECK_NE(first, nullptr);
+}
+
+TEST_CASE("atomic_dex::mm2_client_pool fails queued leases once their deadline expired")
+{
+    using namespace std::chrono_literals;
+    atomic_dex::mm2_client_pool     pool(g_stub_endpoint, 1);
+    pplx::cancellation_token_source token_source;
+
+    //! The only client is never released
+    auto              first = pool.acquire(token_source.get_token()).get();
+    spdlog::stopwatch sw;
+    auto              pending = pool.acquire(token_source.get_token(), 50ms);
+    CHECK_THROWS_AS(pending.get(), web::http::http_exception);
+    CHECK_LT(sw.elapsed(), 5s);
+    CHECK_EQ(pool.get_metrics().timeouts, 1);
+    CHECK_EQ(pool.get_metrics().queued, 0);
+    CHECK_NE(first, nullptr);
+}
+
+TEST_CASE("benchmark mm2_client_pool against a fresh http_client per call" * doctest::skip())
+{
+    stub_mm2_server             server;
+    constexpr std::size_t       nb_requests = 2000;
+    atomic_dex::mm2_client_pool pool(g_stub_endpoint);
+
+    spdlog::stopwatch fresh_sw;
+    for (std::size_t idx = 0; idx < nb_requests; ++idx)
+    {
+        web::http::client::http_client_config cfg;
+        cfg.set_timeout(atomic_dex::g_mm2_client_timeout);
+        t_http_client client(FROM_STD_STR(g_stub_endpoint), cfg);
+        client.request(make_stub_request()).get().extract_string(true).get();
+    }
+    const auto fresh_elapsed = fresh_sw.elapsed();
+
+    pplx::cancellation_token_source token_source;
+    spdlog::stopwatch               pool_sw;
+    for (std::size_t idx = 0; idx < nb_requests; ++idx)
+    {
+        pool.request(make_stub_request(), token_source.get_token()).get().extract_string(true).get();
+    }
+    const auto pool_elapsed = pool_sw.elapsed();
+
+    const auto metrics = pool.get_metrics();
+    SPDLOG_INFO(
+        "{} sequential requests -> fresh client: {:.3f}s, pool: {:.3f}s (hits: {}, misses: {}, waits: {}, wait time: {}us)", nb_requests,
+        fresh_elapsed.count(), pool_elapsed.count(), metrics.hits, metrics.misses, metrics.waits, metrics.total_wait_time.count());
+    CHECK_EQ(metrics.misses, 1);
+    CHECK_EQ(metrics.hits, nb_requests - 1);
+}
@@ -0,0 +1,205 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <numeric>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/api/mm2/orderbook.columns.hpp"
+
+namespace
+{
+    using mm2::api::order_number;
+    using mm2::api::order_text;
+
+    nlohmann::json
+    make_columns_fraction(const std::string& numer, const std::string& denom)
+    {
+        return nlohmann::json{{"numer", numer}, {"denom", denom}};
+    }
+
+    nlohmann::json
+    make_columns_order(std::size_t idx)
+    {
+        const std::string price  = std::to_string(1 + idx % 7) + ".25";
+        const std::string volume = std::to_string(10 + idx % 13);
+        return nlohmann::json{
+            {"coin", "KMD"},
+            {"address", "RAddress" + std::to_string(idx)},
+            {"price", price},
+            {"price_fraction", make_columns_fraction(std::to_string(4 + (idx % 7) * 4 + 1), "4")},
+            {"max_volume_fraction", make_columns_fraction(volume, "1")},
+            {"base_min_volume_fraction", make_columns_fraction("1", "100")},
+            {"base_max_volume_fraction", make_columns_fraction(volume, "1")},
+            {"rel_min_volume_fraction", make_columns_fraction("1", "100")},
+            {"rel_max_volume_fraction", make_columns_fraction(volume, "1")},
+            {"maxvolume", volume},
+            {"pubkey", "03pubkey" + std::to_string(idx)},
+            {"age", idx},
+            {"zcredits", 0},
+            {"uuid", "uuid-" + std::to_string(idx)},
+            {"is_mine", idx == 0},
+            {"base_max_volume", volume},
+            {"base_min_volume", "0.01"},
+            {"rel_max_volume", volume},
+            {"rel_min_volume", "0.01"}};
+    }
+
+    mm2::api::orderbook_columns
+    make_columns(std::size_t nb_orders)
+    {
+        mm2::api::orderbook_columns out;
+        out.reserve(nb_orders);
+        for (std::size_t idx = 0; idx < nb_orders; ++idx) { out.append(make_columns_order(idx)); }
+        return out;
+    }
+} // namespace
+
+TEST_CASE("orderbook_columns parses the mm2 orders once")
+{
+    const auto columns = make_columns(3);
+    REQUIRE_EQ(columns.size(), 3);
+    CHECK_EQ(columns.uuid(1), "uuid-1");
+    CHECK_EQ(columns.coin(1), "KMD");
+    CHECK_FALSE(columns.has_rel_coin(1));
+    CHECK(columns.is_mine(0));
+    CHECK_FALSE(columns.is_mine(1));
+    CHECK_EQ(columns.number(1, order_number::price), safe_decimal("2.25"));
+    CHECK_EQ(columns.number(1, order_number::total), safe_decimal("24.75"));
+    CHECK_EQ(columns.display(1, order_number::price), "2.25");
+    CHECK_EQ(columns.display(1, order_number::base_min_volume), "0.01");
+    CHECK_EQ(columns.text(1, order_text::price_numer), "9");
+    CHECK_EQ(columns.text(1, order_text::price_denom), "4");
+    CHECK_EQ(columns.text(2, order_text::pubkey), "03pubkey2");
+}
+
+TEST_CASE("orderbook_columns trims the displayed numbers and keeps the ones out of range as strings")
+{
+    auto order         = make_columns_order(0);
+    order["price"]     = "2.50000000";
+    order["maxvolume"] = "500000000000000000000";
+    mm2::api::orderbook_columns columns;
+    columns.append(order);
+    columns.append(make_columns_order(1));
+
+    CHECK_EQ(columns.display(0, order_number::price), "2.5");
+    CHECK_EQ(columns.display(1, order_number::max_volume), "11");
+    REQUIRE(columns.out_of_range(0, order_number::max_volume) != nullptr);
+    CHECK(columns.number(0, order_number::max_volume).is_zero());
+    CHECK_EQ(columns.display(0, order_number::max_volume), "500000000000000000000");
+    CHECK_EQ(columns.display(0, order_number::total), "1250000000000000000000");
+    CHECK(columns.out_of_range(1, order_number::max_volume) == nullptr);
+
+    mm2::api::orderbook_columns copy;
+    copy.append(columns, 0);
+    CHECK(copy.same_order(0, columns, 0));
+    CHECK_EQ(copy.display(0, order_number::max_volume), "500000000000000000000");
+    copy.set_number(0, order_number::max_volume, t_fixed_decimal(1));
+    CHECK_FALSE(copy.same_order(0, columns, 0));
+    CHECK_EQ(copy.display(0, order_number::max_volume), "1");
+
+    columns.erase(0, 1);
+    CHECK(columns.out_of_range(0, order_number::max_volume) == nullptr);
+}
+
+TEST_CASE("orderbook_columns round trips through order_contents")
+{
+    const auto columns = make_columns(2);
+    auto       order   = columns.to_order_contents(1);
+    CHECK_EQ(order.uuid, "uuid-1");
+    CHECK_EQ(order.price, "2.25");
+    CHECK_EQ(order.maxvolume, "11");
+    CHECK_EQ(order.rel_max_volume_numer, "11");
+    CHECK_FALSE(order.rel_coin.has_value());
+
+    order.rel_coin = "BTC";
+    const mm2::api::orderbook_columns rebuilt(std::vector<mm2::api::order_contents>{columns.to_order_contents(0), order});
+    CHECK(rebuilt.same_order(0, columns, 0));
+    CHECK_FALSE(rebuilt.same_order(1, columns, 1)); ///< rel_coin differs
+    CHECK_EQ(rebuilt.rel_coin(1), "BTC");
+    CHECK_EQ(rebuilt.display(1, order_number::total), columns.display(1, order_number::total));
+}
+
+TEST_CASE("orderbook_columns keeps its texts consistent through erase and assign")
+{
+    auto       columns = make_columns(400);
+    const auto next    = make_columns(800);
+
+    //! Enough reassigned and erased bytes to compact the text buffer several times
+    for (std::size_t row = 0; row < columns.size(); ++row) { columns.assign(row, next, 799 - row); }
+    columns.erase(10, 300);
+    for (std::size_t row = 400; row < 800; ++row) { columns.append(next, row); }
+
+    REQUIRE_EQ(columns.size(), 500);
+    for (std::size_t row = 0; row < 100; ++row)
+    {
+        const auto source = row < 10 ? 799 - row : 799 - (row + 300);
+        CHECK_EQ(columns.uuid(row), next.uuid(source));
+        CHECK_EQ(columns.text(row, order_text::address), next.text(source, order_text::address));
+        CHECK(columns.same_order(row, next, source));
+    }
+    for (std::size_t row = 100; row < 500; ++row) { CHECK(columns.same_order(row, next, row + 300)); }
+}
+
+TEST_CASE("orderbook_columns memory and sort benchmark" * doctest::skip(true))
+{
+    constexpr std::size_t nb_orders = 5000;
+    const auto            columns   = make_columns(nb_orders);
+
+    std::vector<mm2::api::order_contents> rows;
+    rows.reserve(nb_orders);
+    for (std::size_t row = 0; row < nb_orders; ++row) { rows.push_back(columns.to_order_contents(row)); }
+    std::size_t rows_bytes = rows.capacity() * sizeof(mm2::api::order_contents);
+    for (auto&& order: rows)
+    {
+        for (const auto* str: {&order.coin, &order.address, &order.price, &order.price_fraction_numer, &order.price_fraction_denom, &order.maxvolume,
+                               &order.pubkey, &order.total, &order.uuid, &order.depth_percent})
+        {
+            rows_bytes += str->capacity() > 15 ? str->capacity() + 1 : 0;
+        }
+    }
+    SPDLOG_INFO("{} orders: {} bytes as order_contents, {} bytes as columns", nb_orders, rows_bytes, columns.memory_usage());
+    CHECK_LT(columns.memory_usage(), rows_bytes);
+
+    std::vector<std::size_t> order(nb_orders);
+    std::iota(order.begin(), order.end(), 0);
+    spdlog::stopwatch rows_sw;
+    for (int round = 0; round < 10; ++round)
+    {
+        auto copy = order;
+        std::sort(
+            copy.begin(), copy.end(), [&rows](std::size_t lhs, std::size_t rhs) { return safe_decimal(rows[lhs].price) < safe_decimal(rows[rhs].price); });
+    }
+    const auto rows_elapsed = rows_sw.elapsed();
+
+    spdlog::stopwatch columns_sw;
+    for (int round = 0; round < 10; ++round)
+    {
+        auto copy = order;
+        std::sort(
+            copy.begin(), copy.end(),
+            [&columns](std::size_t lhs, std::size_t rhs) { return columns.number(lhs, order_number::price) < columns.number(rhs, order_number::price); });
+    }
+    SPDLOG_INFO("10 sorts of {} orders by price: {} parsing the strings, {} on the columns", nb_orders, rows_elapsed, columns_sw);
+}
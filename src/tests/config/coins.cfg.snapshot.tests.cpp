@@ -0,0 +1,201 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <fstream>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/config/coins.cfg.snapshot.hpp"
+
+namespace
+{
+    struct coins_snapshot_files
+    {
+        fs::path source{fs::temp_directory_path() / "atomicdex.tests.coins.json"};
+        fs::path snapshot{fs::temp_directory_path() / "atomicdex.tests.coins.json.snapshot"};
+
+        coins_snapshot_files() { clear(); }
+        ~coins_snapshot_files() { clear(); }
+
+        void
+        clear() const
+        {
+            fs::remove(source);
+            fs::remove(snapshot);
+        }
+
+        void
+        write_source(const std::string& content) const
+        {
+            std::ofstream ofs(source.string(), std::ios::trunc | std::ios::binary);
+            ofs << content;
+        }
+    };
+
+    nlohmann::json
+    make_raw_coins(std::size_t nb_coins)
+    {
+        nlohmann::json out = nlohmann::json::array();
+        for (std::size_t idx = 0; idx < nb_coins; ++idx)
+        {
+            const std::string ticker = "COIN" + std::to_string(idx);
+            out.push_back(
+                {{"coin", ticker},
+                 {"name", "coin number " + std::to_string(idx)},
+                 {"fname", ticker + " Coin"},
+                 {"rpcport", 7000 + idx},
+                 {"pubtype", 60},
+                 {"p2shtype", 85},
+                 {"wiftype", 188},
+                 {"txfee", 10000},
+                 {"mm2", 1},
+                 {"required_confirmations", 2},
+                 {"avg_blocktime", 1.5},
+                 {"protocol", {{"type", "UTXO"}, {"protocol_data", {{"platform", "KMD"}, {"contract_address", std::string(40, 'a')}}}}}});
+        }
+        return out;
+    }
+} // namespace
+
+TEST_CASE("coins_cfg_snapshot indexes the mm2 coins array by coin")
+{
+    nlohmann::json coins = make_raw_coins(3);
+    coins.push_back({{"coin", "COIN1"}, {"name", "duplicated"}, {"protocol", {{"type", "UTXO"}}}});
+
+    const auto snapshot = atomic_dex::coins_cfg_snapshot::compile(coins.dump());
+    CHECK(snapshot.is_compiled());
+    CHECK_EQ(snapshot.size(), 3);
+    CHECK_EQ(snapshot.keys(), std::vector<std::string>{"COIN0", "COIN1", "COIN2"});
+    CHECK(snapshot.contains("COIN2"));
+    CHECK_FALSE(snapshot.contains("COIN3"));
+    CHECK_FALSE(snapshot.get("KMD").has_value());
+
+    const auto coin = snapshot.get("COIN0");
+    REQUIRE(coin.has_value());
+    CHECK_EQ(coin.value(), coins[0]);
+
+    //! The last entry of a duplicated coin wins
+    CHECK_EQ(snapshot.get("COIN1")->at("name").get<std::string>(), "duplicated");
+}
+
+TEST_CASE("coins_cfg_snapshot indexes a wallet coins file by ticker")
+{
+    const nlohmann::json wallet_cfg = {{"KMD", {{"coin", "KMD"}, {"active", true}}}, {"BTC", {{"coin", "BTC"}, {"active", false}}}};
+    const auto           snapshot   = atomic_dex::coins_cfg_snapshot::compile(wallet_cfg.dump());
+    CHECK_EQ(snapshot.keys(), std::vector<std::string>{"BTC", "KMD"});
+
+    const auto decoded = snapshot.decode_all<nlohmann::json>();
+    REQUIRE_EQ(decoded.size(), 2);
+    CHECK(decoded.at("KMD").at("active").get<bool>());
+    CHECK_FALSE(decoded.at("BTC").at("active").get<bool>());
+
+    CHECK(atomic_dex::coins_cfg_snapshot::compile("{}").empty());
+    CHECK_THROWS(atomic_dex::coins_cfg_snapshot::compile("{\"KMD\": "));
+    CHECK_THROWS(atomic_dex::coins_cfg_snapshot::compile("42"));
+    CHECK_THROWS(atomic_dex::coins_cfg_snapshot::compile("[{\"name\": \"no coin field\"}]"));
+}
+
+TEST_CASE("coins_cfg_snapshot only parses the json when the source changed")
+{
+    coins_snapshot_files files;
+    CHECK(atomic_dex::coins_cfg_snapshot::open(files.source, files.snapshot).empty());
+    CHECK_FALSE(fs::exists(files.snapshot));
+
+    files.write_source(make_raw_coins(10).dump());
+    const auto cold = atomic_dex::coins_cfg_snapshot::open(files.source, files.snapshot);
+    CHECK(cold.is_compiled());
+    CHECK_EQ(cold.size(), 10);
+    REQUIRE(fs::exists(files.snapshot));
+
+    const auto warm = atomic_dex::coins_cfg_snapshot::open(files.source, files.snapshot);
+    CHECK_FALSE(warm.is_compiled());
+    CHECK_EQ(warm.data(), cold.data());
+    CHECK_EQ(warm.get("COIN7"), cold.get("COIN7"));
+
+    //! Same size, different content
+    auto coins          = make_raw_coins(10);
+    coins[7]["rpcport"] = 8007;
+    files.write_source(coins.dump());
+    const auto changed = atomic_dex::coins_cfg_snapshot::open(files.source, files.snapshot);
+    CHECK(changed.is_compiled());
+    CHECK_EQ(changed.get("COIN7")->at("rpcport").get<int>(), 8007);
+    CHECK_FALSE(atomic_dex::coins_cfg_snapshot::open(files.source, files.snapshot).is_compiled());
+}
+
+TEST_CASE("coins_cfg_snapshot compiles a damaged snapshot again")
+{
+    coins_snapshot_files files;
+    files.write_source(make_raw_coins(5).dump());
+    const auto cold = atomic_dex::coins_cfg_snapshot::open(files.source, files.snapshot);
+
+    //! Truncated in the middle of the records
+    fs::resize_file(files.snapshot, cold.data().size() / 2);
+    const auto truncated = atomic_dex::coins_cfg_snapshot::open(files.source, files.snapshot);
+    CHECK(truncated.is_compiled());
+    CHECK_EQ(truncated.data(), cold.data());
+
+    {
+        std::ofstream ofs(files.snapshot.string(), std::ios::trunc | std::ios::binary);
+        ofs << std::string(64, 'x');
+    }
+    const auto garbage = atomic_dex::coins_cfg_snapshot::open(files.source, files.snapshot);
+    CHECK(garbage.is_compiled());
+    CHECK_EQ(garbage.size(), 5);
+    CHECK_FALSE(atomic_dex::coins_cfg_snapshot::open(files.source, files.snapshot).is_compiled());
+}
+
+TEST_CASE("coins_cfg_snapshot cold and warm start benchmark with 2000 coins" * doctest::skip(true))
+{
+    coins_snapshot_files files;
+    files.write_source(make_raw_coins(2000).dump());
+    const std::vector<std::string> tickers{"COIN0", "COIN42", "COIN1999"};
+
+    //! Previous behaviour: the whole file is parsed and every coin is materialized on every start
+    spdlog::stopwatch                               json_sw;
+    std::ifstream                                   ifs(files.source.string(), std::ios::binary);
+    const std::string                               content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    std::unordered_map<std::string, nlohmann::json> registry;
+    for (auto&& coin: nlohmann::json::parse(content)) { registry[coin.at("coin").get<std::string>()] = coin; }
+    for (auto&& ticker: tickers) { CHECK(registry.contains(ticker)); }
+    const auto json_elapsed = json_sw.elapsed();
+
+    spdlog::stopwatch cold_sw;
+    const auto        cold = atomic_dex::coins_cfg_snapshot::open(files.source, files.snapshot);
+    for (auto&& ticker: tickers) { CHECK(cold.get(ticker).has_value()); }
+    const auto cold_elapsed = cold_sw.elapsed();
+    CHECK(cold.is_compiled());
+
+    spdlog::stopwatch warm_sw;
+    const auto        warm = atomic_dex::coins_cfg_snapshot::open(files.source, files.snapshot);
+    for (auto&& ticker: tickers) { CHECK(warm.get(ticker).has_value()); }
+    const auto warm_elapsed = warm_sw.elapsed();
+    CHECK_FALSE(warm.is_compiled());
+
+    spdlog::stopwatch decode_all_sw;
+    CHECK_EQ(warm.decode_all<nlohmann::json>().size(), 2000);
+    const auto decode_all_elapsed = decode_all_sw.elapsed();
+
+    SPDLOG_INFO(
+        "2000 coins ({} bytes): json parse {}, cold start (parse + compile) {}, warm start (map + hash + 3 lookups) {}, warm decode of every coin {}",
+        content.size(), json_elapsed, cold_elapsed, warm_elapsed, decode_all_elapsed);
+}
@@ -0,0 +1,177 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <fstream>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/config/transactions.notes.store.hpp"
+
+namespace
+{
+    using t_notes = atomic_dex::transactions_notes_store::t_notes;
+
+    struct journal_file
+    {
+        fs::path path{fs::temp_directory_path() / "atomicdex.tests.wallet.notes.journal"};
+
+        journal_file() { fs::remove(path); }
+        ~journal_file() { fs::remove(path); }
+    };
+
+    std::string
+    tx_hash(std::size_t idx)
+    {
+        return fmt::format("{:064x}", idx);
+    }
+} // namespace
+
+TEST_CASE("transactions_notes_store answers single and batch lookups")
+{
+    journal_file                         journal;
+    atomic_dex::transactions_notes_store store;
+    store.open(t_notes{{tx_hash(1), {.note = "rent", .category = ""}}}, journal.path);
+
+    CHECK(store.set_note(tx_hash(2), "coffee"));
+    CHECK_EQ(store.note(tx_hash(1)), "rent");
+    CHECK_EQ(store.note(tx_hash(3)), "");
+    CHECK_EQ(store.note(tx_hash(5)), "");
+
+    const auto                     notes = store.notes({tx_hash(3), tx_hash(2), tx_hash(1)});
+    const std::vector<std::string> expected{"", "coffee", "rent"};
+    CHECK_EQ(notes, expected);
+    CHECK_EQ(store.size(), 2);
+    CHECK_EQ(store.journal_size(), 1);
+}
+
+TEST_CASE("transactions_notes_store replays its journal and stops at a torn entry")
+{
+    journal_file journal;
+    {
+        atomic_dex::transactions_notes_store store;
+        store.open(t_notes{}, journal.path);
+        store.set_note(tx_hash(1), "first");
+        store.set_note(tx_hash(2), "second");
+        store.set_note(tx_hash(1), "edited");
+    }
+    {
+        std::ofstream ofs(journal.path.string(), std::ios::app);
+        ofs << R"({"tx_hash": ")" << tx_hash(5) << R"(", "note": null})" << '\n';
+        ofs << R"({"tx_hash": ")" << tx_hash(3) << R"(", "no)";
+    }
+
+    atomic_dex::transactions_notes_store store;
+    store.open(t_notes{{tx_hash(2), {.note = "from the wallet file", .category = ""}}}, journal.path);
+    CHECK_EQ(store.journal_size(), 3);
+    CHECK_EQ(store.note(tx_hash(1)), "edited");
+    CHECK_EQ(store.note(tx_hash(2)), "second");
+    CHECK_EQ(store.note(tx_hash(3)), "");
+    CHECK_EQ(store.note(tx_hash(5)), "");
+
+    //! The torn entry is cut so the next edits are replayed
+    store.set_note(tx_hash(4), "after the crash");
+    atomic_dex::transactions_notes_store reopened;
+    reopened.open(t_notes{}, journal.path);
+    CHECK_EQ(reopened.journal_size(), 4);
+    CHECK_EQ(reopened.note(tx_hash(4)), "after the crash");
+}
+
+TEST_CASE("transactions_notes_store empties its journal only once the wallet file is written")
+{
+    journal_file                         journal;
+    atomic_dex::transactions_notes_store store;
+    store.open(t_notes{}, journal.path);
+    store.set_note(tx_hash(1), "kept");
+
+    CHECK_FALSE(store.compact([](const t_notes&) { return false; }));
+    CHECK_EQ(store.journal_size(), 1);
+
+    t_notes written;
+    CHECK(store.compact(
+        [&written](const t_notes& notes)
+        {
+            written = notes;
+            return true;
+        }));
+    CHECK_EQ(store.journal_size(), 0);
+    CHECK_EQ(written.at(tx_hash(1)).note, "kept");
+
+    //! Edits after a compaction go to the fresh journal
+    store.set_note(tx_hash(2), "after");
+    atomic_dex::transactions_notes_store reopened;
+    reopened.open(std::move(written), journal.path);
+    CHECK_EQ(reopened.journal_size(), 1);
+    CHECK_EQ(reopened.note(tx_hash(1)), "kept");
+    CHECK_EQ(reopened.note(tx_hash(2)), "after");
+}
+
+TEST_CASE("transactions_notes_store benchmark with 10k transactions and 1k notes" * doctest::skip(true))
+{
+    constexpr std::size_t nb_transactions = 10000;
+    constexpr std::size_t nb_notes        = 1000;
+
+    journal_file journal;
+    t_notes      notes;
+    for (std::size_t idx = 0; idx < nb_notes; ++idx) { notes[tx_hash(idx * 10)] = {.note = "note " + std::to_string(idx), .category = ""}; }
+    std::vector<std::string> tx_hashes;
+    for (std::size_t idx = 0; idx < nb_transactions; ++idx) { tx_hashes.push_back(tx_hash(idx)); }
+
+    //! Previous behaviour: the whole notes map was copied for every transaction
+    spdlog::stopwatch        copy_sw;
+    std::vector<std::string> copied(nb_transactions);
+    for (std::size_t idx = 0; idx < nb_transactions; ++idx)
+    {
+        const auto registry = notes;
+        if (const auto it = registry.find(tx_hashes[idx]); it != registry.end())
+        {
+            copied[idx] = it->second.note;
+        }
+    }
+    const auto copy_elapsed = copy_sw.elapsed();
+
+    atomic_dex::transactions_notes_store store;
+    store.open(notes, journal.path);
+    spdlog::stopwatch batch_sw;
+    const auto        batched       = store.notes(tx_hashes);
+    const auto        batch_elapsed = batch_sw.elapsed();
+    CHECK_EQ(batched, copied);
+
+    //! Previous behaviour: every edit rewrote the whole wallet file
+    spdlog::stopwatch rewrite_sw;
+    for (std::size_t idx = 0; idx < 100; ++idx)
+    {
+        notes[tx_hash(idx)].note = "edited";
+        nlohmann::json j;
+        j["transactions_details"] = notes;
+        std::ofstream ofs(journal.path.string() + ".json", std::ios::trunc);
+        ofs << j.dump(4);
+    }
+    const auto rewrite_elapsed = rewrite_sw.elapsed();
+    fs::remove(journal.path.string() + ".json");
+
+    spdlog::stopwatch journal_sw;
+    for (std::size_t idx = 0; idx < 100; ++idx) { store.set_note(tx_hash(idx), "edited"); }
+    SPDLOG_INFO(
+        "{} transactions / {} notes -> lookups: {} copying the registry, {} batched; 100 edits: {} rewriting the file, {} journaled", nb_transactions,
+        nb_notes, copy_elapsed, batch_elapsed, rewrite_elapsed, journal_sw);
+}
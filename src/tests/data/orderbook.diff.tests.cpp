@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! Deps
+#include <doctest/doctest.h>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/data/dex/orderbook.diff.hpp"
+
+namespace
+{
+    atomic_dex::t_order_contents
+    make_order(const std::string& uuid, const std::string& price, const std::string& volume = "1")
+    {
+        atomic_dex::t_order_contents order{};
+        order.uuid      = uuid;
+        order.price     = price;
+        order.maxvolume = volume;
+        order.coin      = "KMD";
+        return order;
+    }
+
+    atomic_dex::t_orders_contents
+    make_book(std::size_t nb_orders, std::size_t first_id = 0)
+    {
+        atomic_dex::t_orders_contents out;
+        out.reserve(nb_orders);
+        for (std::size_t idx = first_id; idx < first_id + nb_orders; ++idx) { out.push_back(make_order("uuid-" + std::to_string(idx), std::to_string(idx))); }
+        return out;
+    }
+} // namespace
+
+TEST_CASE("compute_orderbook_diff of an identical snapshot is empty")
+{
+    const atomic_dex::t_orderbook_columns current(make_book(10));
+    atomic_dex::keyed_row_index index;
+    atomic_dex::reset_orderbook_row_index(index, current);
+    CHECK(atomic_dex::compute_orderbook_diff(current, index, current).empty());
+}
+
+TEST_CASE("compute_orderbook_diff detects inserted, changed and removed orders")
+{
+    const auto                            rows = make_book(6);
+    const atomic_dex::t_orderbook_columns current(rows);
+    atomic_dex::keyed_row_index           index;
+    atomic_dex::reset_orderbook_row_index(index, current);
+
+    auto next_rows = rows;
+    next_rows.erase(next_rows.begin() + 4);                        ///< uuid-4 removed
+    next_rows.erase(next_rows.begin() + 1, next_rows.begin() + 3); ///< uuid-1 and uuid-2 removed
+    next_rows[0].maxvolume = "42";                                 ///< uuid-0 changed
+    next_rows[1].price_fraction_numer = "7";                       ///< uuid-3 changed, only its fraction differs
+    next_rows.push_back(make_order("uuid-new", "0.5"));
+    const atomic_dex::t_orderbook_columns next(next_rows);
+
+    const auto diff = atomic_dex::compute_orderbook_diff(current, index, next);
+    REQUIRE_EQ(diff.removed.size(), 2);
+    CHECK_EQ(diff.removed[0], atomic_dex::t_row_range{4, 4});
+    CHECK_EQ(diff.removed[1], atomic_dex::t_row_range{1, 2});
+    REQUIRE_EQ(diff.changed.size(), 2);
+    CHECK_EQ(next.uuid(diff.changed[0]), "uuid-0");
+    CHECK_EQ(next.uuid(diff.changed[1]), "uuid-3");
+    REQUIRE_EQ(diff.inserted.size(), 1);
+    CHECK_EQ(next.uuid(diff.inserted[0]), "uuid-new");
+}
+
+TEST_CASE("compute_orderbook_diff keeps the first occurrence of a duplicated uuid")
+{
+    const auto                            rows = make_book(2);
+    const atomic_dex::t_orderbook_columns current(rows);
+    atomic_dex::keyed_row_index           index;
+    atomic_dex::reset_orderbook_row_index(index, current);
+
+    auto next_rows = rows;
+    next_rows.push_back(make_order("uuid-1", "100"));
+    next_rows.push_back(make_order("uuid-2", "2"));
+    next_rows.push_back(make_order("uuid-2", "3"));
+    const atomic_dex::t_orderbook_columns next(next_rows);
+
+    const auto diff = atomic_dex::compute_orderbook_diff(current, index, next);
+    CHECK(diff.removed.empty());
+    CHECK(diff.changed.empty());
+    REQUIRE_EQ(diff.inserted.size(), 1);
+    CHECK_EQ(next.display(diff.inserted[0], atomic_dex::t_order_number::price), "2");
+}
+
+TEST_CASE("compute_orderbook_diff deep book benchmark" * doctest::skip(true))
+{
+    constexpr std::size_t nb_orders = 5000;
+    auto                  next_rows = make_book(nb_orders, nb_orders / 10); ///< 10% of the book is replaced
+    for (std::size_t idx = 0; idx < next_rows.size(); idx += 20) { next_rows[idx].maxvolume = "2"; }
+    const atomic_dex::t_orderbook_columns current(make_book(nb_orders));
+    const atomic_dex::t_orderbook_columns next(next_rows);
+    atomic_dex::keyed_row_index           index;
+    atomic_dex::reset_orderbook_row_index(index, current);
+
+    spdlog::stopwatch sw;
+    std::size_t       nb_rows = 0;
+    for (int round = 0; round < 100; ++round)
+    {
+        const auto diff = atomic_dex::compute_orderbook_diff(current, index, next);
+        nb_rows += diff.changed.size() + diff.inserted.size() + diff.removed.size();
+    }
+    SPDLOG_INFO("compute_orderbook_diff: 100 diffs of {} orders in {} ({} rows touched)", nb_orders, sw, nb_rows);
+    CHECK_GT(nb_rows, 0);
+}
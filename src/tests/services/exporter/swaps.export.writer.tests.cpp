@@ -0,0 +1,315 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <fstream>
+#include <sstream>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/services/exporter/swaps.export.writer.hpp"
+
+namespace
+{
+    nlohmann::json
+    make_swap(std::size_t idx)
+    {
+        const bool     failed = idx % 7 == 0;
+        nlohmann::json events = nlohmann::json::array();
+        events.push_back({{"timestamp", 1600000000000 + idx * 1000}, {"event", {{"type", "Started"}, {"data", nlohmann::json::object()}}}});
+        if (failed)
+        {
+            events.push_back({{"timestamp", 1600000000500 + idx * 1000}, {"event", {{"type", "TakerPaymentValidateFailed"}, {"data", {{"error", "bad payment"}}}}}});
+        }
+        events.push_back({{"timestamp", 1600000000900 + idx * 1000}, {"event", {{"type", "Finished"}}}});
+        return {
+            {"uuid", "uuid-" + std::to_string(idx)},
+            {"type", idx % 2 == 0 ? "Maker" : "Taker"},
+            {"maker_coin", "KMD"},
+            {"taker_coin", "BTC"},
+            {"maker_amount", std::to_string(idx + 1) + ".50000000"},
+            {"taker_amount", "0.001"},
+            {"events", events},
+            {"error_events", {"TakerPaymentValidateFailed", "MakerPaymentValidateFailed"}},
+            {"success_events", {"Started", "Finished"}}};
+    }
+
+    //! In memory my_recent_swaps, pages are anchored on `from_uuid` like mm2 does.
+    struct stub_mm2
+    {
+        std::size_t nb_swaps;
+        std::size_t nb_requests{0};
+
+        std::optional<nlohmann::json>
+        operator()(const std::optional<std::string>& from_uuid, std::size_t limit)
+        {
+            nb_requests += 1;
+            std::size_t start = 0;
+            if (from_uuid)
+            {
+                start = std::stoul(from_uuid->substr(5)) + 1;
+            }
+            nlohmann::json swaps = nlohmann::json::array();
+            for (std::size_t idx = start; idx < std::min(nb_swaps, start + limit); ++idx) { swaps.push_back(make_swap(idx)); }
+            return nlohmann::json{{"total", nb_swaps}, {"swaps", std::move(swaps)}};
+        }
+    };
+
+    struct export_fixture
+    {
+        fs::path folder{fs::temp_directory_path() / "atomicdex.tests.swaps.export"};
+
+        export_fixture()
+        {
+            fs::remove_all(folder);
+            fs::create_directories(folder);
+        }
+
+        ~export_fixture() { fs::remove_all(folder); }
+    };
+
+    std::vector<std::string>
+    read_lines(const fs::path& path)
+    {
+        std::ifstream            ifs(path.string());
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(ifs, line);) { lines.push_back(line); }
+        return lines;
+    }
+
+    std::uint64_t
+    read_le(const std::string& data, std::size_t offset, std::size_t size)
+    {
+        std::uint64_t value = 0;
+        for (std::size_t idx = 0; idx < size; ++idx) { value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[offset + idx])) << (8 * idx); }
+        return value;
+    }
+} // namespace
+
+TEST_CASE("swap_export_row decodes a my_recent_swaps entry like the orders model")
+{
+    const auto maker = atomic_dex::swap_export_row::from_json(make_swap(2));
+    REQUIRE(maker.has_value());
+    CHECK_EQ(maker->base_coin, "KMD");
+    CHECK_EQ(maker->rel_coin, "BTC");
+    CHECK_EQ(maker->base_amount, "3.5");
+    CHECK_EQ(maker->status, "successful");
+    CHECK_EQ(maker->error_state, "Success");
+
+    const auto taker_failed = atomic_dex::swap_export_row::from_json(make_swap(7));
+    REQUIRE(taker_failed.has_value());
+    CHECK_EQ(taker_failed->base_coin, "BTC");
+    CHECK_EQ(taker_failed->rel_amount, "8.5");
+    CHECK_EQ(taker_failed->status, "failed");
+    CHECK_EQ(taker_failed->error_state, "TakerPaymentValidateFailed");
+
+    CHECK_FALSE(atomic_dex::swap_export_row::from_json(nlohmann::json(nullptr)).has_value());
+}
+
+TEST_CASE("export_swaps_pages streams every page of the history to csv and json lines")
+{
+    export_fixture fixture;
+    stub_mm2       mm2{.nb_swaps = 2500};
+    const auto     fetcher = [&mm2](const std::optional<std::string>& from_uuid, std::size_t limit) { return mm2(from_uuid, limit); };
+
+    std::atomic_bool                               cancelled{false};
+    std::vector<atomic_dex::swaps_export_progress> steps;
+    atomic_dex::swaps_export_writer                csv(fixture.folder / "swaps.csv", atomic_dex::swaps_export_format::csv, 4096);
+    const auto                                     result = atomic_dex::export_swaps_pages(fetcher, csv, 1000, cancelled, [&steps](const auto& progress) { steps.push_back(progress); });
+
+    CHECK(result.status == atomic_dex::swaps_export_status::finished);
+    CHECK_EQ(result.rows, 2500);
+    CHECK_EQ(mm2.nb_requests, 3);
+    REQUIRE_EQ(steps.size(), 3);
+    CHECK_EQ(steps.back().rows, 2500);
+    CHECK_EQ(steps.back().total, 2500);
+    CHECK_FALSE(fs::exists(fixture.folder / "swaps.csv.part"));
+
+    const auto lines = read_lines(fixture.folder / "swaps.csv");
+    REQUIRE_EQ(lines.size(), 2501);
+    CHECK_EQ(lines[0], "Date,BaseCoin,BaseAmount,Status,RelCoin,RelAmount,UUID,ErrorState");
+    CHECK_NE(lines[1].find(",KMD,1.5,failed,BTC,0.001,uuid-0,TakerPaymentValidateFailed"), std::string::npos);
+    CHECK_NE(lines[3].find(",KMD,3.5,successful,BTC,0.001,uuid-2,Success"), std::string::npos);
+    CHECK_NE(lines.back().find(",uuid-2499,"), std::string::npos);
+    CHECK_EQ(fs::file_size(fixture.folder / "swaps.csv"), result.bytes);
+
+    atomic_dex::swaps_export_writer jsonl(fixture.folder / "swaps.jsonl", atomic_dex::swaps_export_format::json_lines);
+    CHECK(atomic_dex::export_swaps_pages(fetcher, jsonl, 1000, cancelled).status == atomic_dex::swaps_export_status::finished);
+    const auto json_lines = read_lines(fixture.folder / "swaps.jsonl");
+    REQUIRE_EQ(json_lines.size(), 2500);
+    const auto failed = nlohmann::json::parse(json_lines[7]);
+    CHECK_EQ(failed.at("status").get<std::string>(), "failed");
+    CHECK_EQ(failed.at("error_state").get<std::string>(), "TakerPaymentValidateFailed");
+}
+
+TEST_CASE("export_swaps_pages continues from the last swap holding a uuid")
+{
+    export_fixture fixture;
+    stub_mm2       mm2{.nb_swaps = 2500};
+    const auto     fetcher = [&mm2](const std::optional<std::string>& from_uuid, std::size_t limit)
+    {
+        auto page = mm2(from_uuid, limit);
+        if (auto& swaps = page->at("swaps"); swaps.size() == limit)
+        {
+            swaps.back().erase("uuid");
+        }
+        return page;
+    };
+
+    std::atomic_bool                cancelled{false};
+    atomic_dex::swaps_export_writer csv(fixture.folder / "swaps.csv", atomic_dex::swaps_export_format::csv, 4096);
+    const auto                      result = atomic_dex::export_swaps_pages(fetcher, csv, 1000, cancelled);
+
+    //! The swap without uuid is skipped then requested again with the next page, only a short page ends the export.
+    CHECK(result.status == atomic_dex::swaps_export_status::finished);
+    CHECK_EQ(mm2.nb_requests, 3);
+    CHECK_EQ(result.rows, 2500);
+    CHECK_NE(read_lines(fixture.folder / "swaps.csv").back().find(",uuid-2499,"), std::string::npos);
+}
+
+TEST_CASE("swaps_export_pager is fed one page at a time")
+{
+    export_fixture                  fixture;
+    stub_mm2                        mm2{.nb_swaps = 250};
+    std::atomic_bool                cancelled{false};
+    atomic_dex::swaps_export_writer writer(fixture.folder / "swaps.csv", atomic_dex::swaps_export_format::csv, 1024);
+    atomic_dex::swaps_export_pager  pager(writer, 100, cancelled);
+
+    REQUIRE(pager.start());
+    CHECK_FALSE(pager.next_from_uuid().has_value());
+    CHECK(pager.on_page(mm2(pager.next_from_uuid(), pager.page_size())));
+    CHECK_EQ(pager.next_from_uuid().value_or(""), "uuid-99");
+    CHECK(pager.on_page(mm2(pager.next_from_uuid(), pager.page_size())));
+    CHECK_FALSE(pager.on_page(mm2(pager.next_from_uuid(), pager.page_size())));
+    CHECK(pager.result().status == atomic_dex::swaps_export_status::finished);
+    CHECK_EQ(pager.result().rows, 250);
+}
+
+TEST_CASE("swaps_export_pager removes the partial file when a page request fails")
+{
+    export_fixture                  fixture;
+    stub_mm2                        mm2{.nb_swaps = 250};
+    std::atomic_bool                cancelled{false};
+    atomic_dex::swaps_export_writer writer(fixture.folder / "swaps.csv", atomic_dex::swaps_export_format::csv, 1024);
+    atomic_dex::swaps_export_pager  pager(writer, 100, cancelled);
+
+    REQUIRE(pager.start());
+    CHECK(pager.on_page(mm2(pager.next_from_uuid(), pager.page_size())));
+    pager.fail("connection reset");
+    CHECK(pager.result().status == atomic_dex::swaps_export_status::failed);
+    CHECK_EQ(pager.result().error, "connection reset");
+    CHECK_EQ(pager.result().rows, 100);
+    CHECK_FALSE(fs::exists(fixture.folder / "swaps.csv"));
+    CHECK_FALSE(fs::exists(fixture.folder / "swaps.csv.part"));
+}
+
+TEST_CASE("columnar export writes row groups column by column")
+{
+    export_fixture                  fixture;
+    stub_mm2                        mm2{.nb_swaps = 250};
+    std::atomic_bool                cancelled{false};
+    atomic_dex::swaps_export_writer writer(fixture.folder / "swaps.adxc", atomic_dex::swaps_export_format::columnar, 1024, 100);
+    const auto result = atomic_dex::export_swaps_pages([&mm2](const auto& from_uuid, std::size_t limit) { return mm2(from_uuid, limit); }, writer, 64, cancelled);
+    REQUIRE(result.status == atomic_dex::swaps_export_status::finished);
+
+    std::ifstream     ifs((fixture.folder / "swaps.adxc").string(), std::ios::binary);
+    const std::string data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    REQUIRE_GT(data.size(), 16);
+    CHECK_EQ(data.substr(0, 4), "ADXC");
+    CHECK_EQ(data.substr(data.size() - 4), "ADXC");
+
+    const auto footer_size   = read_le(data, data.size() - 8, 4);
+    const auto footer_offset = data.size() - 8 - footer_size;
+    const auto nb_groups     = read_le(data, footer_offset, 4);
+    REQUIRE_EQ(nb_groups, 3);
+    CHECK_EQ(read_le(data, footer_offset + 4 + nb_groups * 8, 8), 250);
+
+    //! Third row group: 50 rows, skip the first columns through their chunk sizes and read the uuids.
+    auto offset = read_le(data, footer_offset + 4 + 2 * 8, 8);
+    CHECK_EQ(read_le(data, offset, 4), 50);
+    offset += 4;
+    for (std::size_t column = 0; column < 6; ++column) { offset += 8 + read_le(data, offset, 8); }
+    offset += 8;
+    const auto uuid_size = read_le(data, offset, 4);
+    CHECK_EQ(data.substr(offset + 4, uuid_size), "uuid-200");
+}
+
+TEST_CASE("cancelled export removes the partial file")
+{
+    export_fixture                  fixture;
+    stub_mm2                        mm2{.nb_swaps = 5000};
+    std::atomic_bool                cancelled{false};
+    atomic_dex::swaps_export_writer writer(fixture.folder / "swaps.csv", atomic_dex::swaps_export_format::csv, 1024);
+    const auto                      result = atomic_dex::export_swaps_pages(
+        [&mm2](const auto& from_uuid, std::size_t limit) { return mm2(from_uuid, limit); }, writer, 500, cancelled,
+        [&cancelled](const atomic_dex::swaps_export_progress& progress)
+        {
+            if (progress.pages == 2)
+            {
+                cancelled = true;
+            }
+        });
+
+    CHECK(result.status == atomic_dex::swaps_export_status::cancelled);
+    CHECK_EQ(result.rows, 1000);
+    CHECK_EQ(mm2.nb_requests, 2);
+    CHECK_FALSE(fs::exists(fixture.folder / "swaps.csv"));
+    CHECK_FALSE(fs::exists(fixture.folder / "swaps.csv.part"));
+}
+
+TEST_CASE("benchmark paged streaming export against the single request export" * doctest::skip(true))
+{
+    constexpr std::size_t nb_swaps = 50000;
+    export_fixture        fixture;
+
+    //! Former path: the whole history in one answer, every row in a stringstream, then one write.
+    spdlog::stopwatch legacy_sw;
+    {
+        stub_mm2          mm2{.nb_swaps = nb_swaps};
+        const auto        answer = mm2(std::nullopt, nb_swaps);
+        std::stringstream ss;
+        ss << "Date,BaseCoin,BaseAmount,Status,RelCoin,RelAmount,UUID,ErrorState" << std::endl;
+        for (auto&& swap: answer->at("swaps"))
+        {
+            const auto row = atomic_dex::swap_export_row::from_json(swap);
+            ss << row->date << "," << row->base_coin << "," << row->base_amount << "," << row->status << "," << row->rel_coin << "," << row->rel_amount
+               << "," << row->uuid << "," << row->error_state << std::endl;
+        }
+        std::ofstream ofs((fixture.folder / "legacy.csv").string());
+        ofs << ss.str();
+    }
+    const auto legacy_elapsed = legacy_sw.elapsed();
+
+    spdlog::stopwatch               streaming_sw;
+    stub_mm2                        mm2{.nb_swaps = nb_swaps};
+    std::atomic_bool                cancelled{false};
+    atomic_dex::swaps_export_writer writer(fixture.folder / "streaming.csv", atomic_dex::swaps_export_format::csv);
+    const auto                      result =
+        atomic_dex::export_swaps_pages([&mm2](const auto& from_uuid, std::size_t limit) { return mm2(from_uuid, limit); }, writer, 1000, cancelled);
+    const auto streaming_elapsed = streaming_sw.elapsed();
+
+    CHECK_EQ(result.rows, nb_swaps);
+    CHECK_EQ(fs::file_size(fixture.folder / "legacy.csv"), fs::file_size(fixture.folder / "streaming.csv"));
+    SPDLOG_INFO(
+        "{} swaps exported: single request {:.3f}s ({:.0f} rows/s), paged streaming {:.3f}s ({:.0f} rows/s)", nb_swaps, legacy_elapsed.count(),
+        nb_swaps / legacy_elapsed.count(), streaming_elapsed.count(), nb_swaps / streaming_elapsed.count());
+}
@@ -0,0 +1,179 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#include "atomicdex/pch.hpp"
+
+//! Deps
+#include <doctest/doctest.h>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.activation.pipeline.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+    using t_pipeline = atomic_dex::coin_activation_pipeline;
+
+    struct recorder
+    {
+        std::vector<std::string>              launched;
+        std::vector<std::vector<std::string>> followups;
+
+        t_pipeline
+        make_pipeline(atomic_dex::activation_pipeline_cfg cfg)
+        {
+            return t_pipeline(
+                cfg, [this](const t_pipeline::job& job) { launched.push_back(job.ticker); },
+                [this](std::vector<std::string> tickers) { followups.push_back(std::move(tickers)); });
+        }
+    };
+
+    std::vector<t_pipeline::job>
+    make_jobs(std::size_t nb_coins)
+    {
+        std::vector<t_pipeline::job> out;
+        for (std::size_t idx = 0; idx < nb_coins; ++idx) { out.push_back(t_pipeline::job{.ticker = "COIN" + std::to_string(idx)}); }
+        return out;
+    }
+} // namespace
+
+TEST_CASE("coin_activation_pipeline never exceeds its concurrency window")
+{
+    recorder   rec;
+    auto       pipeline = rec.make_pipeline(atomic_dex::activation_pipeline_cfg{.max_in_flight = 4, .followup_batch_size = 100});
+    const auto now      = t_pipeline::t_clock::now();
+
+    pipeline.enqueue(make_jobs(10), now);
+    CHECK_EQ(rec.launched.size(), 4);
+    CHECK_EQ(pipeline.in_flight(), 4);
+    CHECK_EQ(pipeline.pending(), 6);
+
+    std::size_t answered = 0;
+    while (answered < rec.launched.size())
+    {
+        pipeline.on_job_done(rec.launched[answered++], atomic_dex::activation_status::enabled, now + 10ms);
+        CHECK_LE(pipeline.in_flight(), 4);
+    }
+    CHECK_EQ(rec.launched.size(), 10);
+
+    const auto metrics = pipeline.get_metrics();
+    CHECK_EQ(metrics.nb_enabled, 10);
+    CHECK_EQ(metrics.max_in_flight_seen, 4);
+    //! Every follow-up is coalesced in a single batch once the queue is drained
+    REQUIRE_EQ(rec.followups.size(), 1);
+    CHECK_EQ(rec.followups[0].size(), 10);
+    CHECK_EQ(metrics.nb_followup_batches, 1);
+}
+
+TEST_CASE("coin_activation_pipeline launches fee parents, then the current ticker, then the portfolio order")
+{
+    recorder rec;
+    auto     pipeline = rec.make_pipeline(atomic_dex::activation_pipeline_cfg{.max_in_flight = 1});
+
+    std::vector<t_pipeline::job> jobs{
+        {.ticker = "USDT-ERC20"},
+        {.ticker = "LTC"},
+        {.ticker = "DOGE", .priority = atomic_dex::activation_priority::current_ticker},
+        {.ticker = "ETH", .priority = atomic_dex::activation_priority::fee_parent},
+        {.ticker = "BNB", .priority = atomic_dex::activation_priority::fee_parent}};
+    const auto now = t_pipeline::t_clock::now();
+    pipeline.enqueue(std::move(jobs), now);
+    for (std::size_t idx = 0; idx < 5; ++idx) { pipeline.on_job_done(rec.launched.back(), atomic_dex::activation_status::enabled, now); }
+    const std::vector<std::string> expected{"ETH", "BNB", "DOGE", "USDT-ERC20", "LTC"};
+    CHECK_EQ(rec.launched, expected);
+}
+
+TEST_CASE("coin_activation_pipeline launches tokens once their fee parent left the pipeline")
+{
+    recorder   rec;
+    auto       pipeline = rec.make_pipeline(atomic_dex::activation_pipeline_cfg{.max_in_flight = 4, .base_backoff = 1000ms});
+    const auto start    = t_pipeline::t_clock::now();
+
+    pipeline.enqueue(
+        {t_pipeline::job{.ticker = "ETH", .priority = atomic_dex::activation_priority::fee_parent}, t_pipeline::job{.ticker = "USDT-ERC20", .fee_parent = "ETH"},
+         t_pipeline::job{.ticker = "LTC"}},
+        start);
+    CHECK_EQ(rec.launched, std::vector<std::string>{"ETH", "LTC"});
+
+    //! A parent waiting for its retry still holds its children
+    CHECK(pipeline.on_job_done("ETH", atomic_dex::activation_status::retryable, start));
+    pipeline.tick(start + 1000ms);
+    CHECK_EQ(rec.launched, std::vector<std::string>{"ETH", "LTC", "ETH"});
+    pipeline.on_job_done("ETH", atomic_dex::activation_status::enabled, start + 1100ms);
+    CHECK_EQ(rec.launched, std::vector<std::string>{"ETH", "LTC", "ETH", "USDT-ERC20"});
+
+    //! Parents enabled earlier do not block
+    pipeline.enqueue({t_pipeline::job{.ticker = "BUSD-ERC20", .fee_parent = "ETH"}}, start + 1200ms);
+    CHECK_EQ(rec.launched.back(), "BUSD-ERC20");
+}
+
+TEST_CASE("coin_activation_pipeline retries transient failures with an exponential backoff")
+{
+    recorder   rec;
+    auto       pipeline = rec.make_pipeline(atomic_dex::activation_pipeline_cfg{.max_attempts = 3, .base_backoff = 1000ms});
+    const auto start    = t_pipeline::t_clock::now();
+
+    pipeline.enqueue({t_pipeline::job{.ticker = "KMD"}, t_pipeline::job{.ticker = "DOGE"}}, start);
+    CHECK(pipeline.on_job_done("KMD", atomic_dex::activation_status::retryable, start));
+    CHECK_FALSE(pipeline.on_job_done("DOGE", atomic_dex::activation_status::failed, start));
+    CHECK_EQ(pipeline.pending(), 1);
+
+    pipeline.tick(start + 500ms);
+    CHECK_EQ(rec.launched.size(), 2);
+    pipeline.tick(start + 1000ms);
+    REQUIRE_EQ(rec.launched.size(), 3);
+    CHECK_EQ(rec.launched.back(), "KMD");
+
+    //! Second failure waits twice as long, the third one is final
+    CHECK(pipeline.on_job_done("KMD", atomic_dex::activation_status::retryable, start + 1000ms));
+    pipeline.tick(start + 2500ms);
+    CHECK_EQ(rec.launched.size(), 3);
+    pipeline.tick(start + 3000ms);
+    CHECK_EQ(rec.launched.size(), 4);
+    CHECK_FALSE(pipeline.on_job_done("KMD", atomic_dex::activation_status::retryable, start + 3000ms));
+
+    const auto metrics = pipeline.get_metrics();
+    CHECK_EQ(metrics.nb_retries, 2);
+    CHECK_EQ(metrics.nb_failed, 2);
+    CHECK_EQ(pipeline.pending(), 0);
+    CHECK_EQ(pipeline.in_flight(), 0);
+    CHECK(rec.followups.empty());
+}
+
+TEST_CASE("coin_activation_pipeline skips duplicated tickers and records the stages of a wave")
+{
+    recorder   rec;
+    auto       pipeline = rec.make_pipeline(atomic_dex::activation_pipeline_cfg{.max_in_flight = 2});
+    const auto start    = t_pipeline::t_clock::now();
+
+    pipeline.enqueue(make_jobs(3), start);
+    pipeline.enqueue(make_jobs(3), start);
+    CHECK_EQ(pipeline.get_metrics().nb_enqueued, 3);
+
+    pipeline.on_job_done("COIN0", atomic_dex::activation_status::enabled, start + 100ms);
+    pipeline.record_stage("current_ticker_enabled", start + 150ms);
+    pipeline.on_job_done("COIN1", atomic_dex::activation_status::enabled, start + 200ms);
+    pipeline.on_job_done("COIN2", atomic_dex::activation_status::enabled, start + 300ms);
+
+    const auto stages = pipeline.get_metrics().stages;
+    REQUIRE_EQ(stages.size(), 3);
+    CHECK_EQ(stages[0].first, "first_coin_enabled");
+    CHECK_EQ(stages[0].second, 100ms);
+    CHECK_EQ(stages[1].first, "current_ticker_enabled");
+    CHECK_EQ(stages[2].first, "queue_drained");
+    CHECK_EQ(stages[2].second, 300ms);
+}
@@ -0,0 +1,140 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#include "atomicdex/pch.hpp"
+
+//! Deps
+#include <doctest/doctest.h>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.balance.refresh.scheduler.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+    using t_scheduler = atomic_dex::balance_refresh_scheduler;
+
+    std::vector<std::string>
+    make_tickers(std::size_t nb_coins)
+    {
+        std::vector<std::string> out;
+        for (std::size_t idx = 0; idx < nb_coins; ++idx) { out.push_back("COIN" + std::to_string(idx)); }
+        return out;
+    }
+
+    void
+    answer_all(t_scheduler& scheduler, const t_scheduler::batch& batch, t_scheduler::t_time_point now, const std::string& balance = "1")
+    {
+        for (auto&& ticker: batch.hot) { scheduler.on_balance(ticker, balance, now); }
+        for (auto&& ticker: batch.cold) { scheduler.on_balance(ticker, balance, now); }
+    }
+} // namespace
+
+TEST_CASE("balance_refresh_scheduler sends small cold batches, the stalest first")
+{
+    t_scheduler scheduler(atomic_dex::balance_refresh_cfg{.cold_batch_size = 10});
+    scheduler.sync_enabled_coins(make_tickers(25));
+    const auto start = t_scheduler::t_clock::now();
+
+    auto first = scheduler.next_batch(start);
+    CHECK(first.hot.empty());
+    CHECK_EQ(first.cold.size(), 10);
+    answer_all(scheduler, first, start);
+
+    auto second = scheduler.next_batch(start + 1s);
+    CHECK_EQ(second.cold.size(), 10);
+    for (auto&& ticker: second.cold) { CHECK(std::find(first.cold.begin(), first.cold.end(), ticker) == first.cold.end()); }
+
+    //! In flight coins are not sent again
+    auto third = scheduler.next_batch(start + 2s);
+    CHECK_EQ(third.cold.size(), 5);
+    CHECK(scheduler.next_batch(start + 3s).empty());
+}
+
+TEST_CASE("balance_refresh_scheduler backs off cold coins whose balance does not move")
+{
+    t_scheduler scheduler(atomic_dex::balance_refresh_cfg{.cold_min_interval = 30s, .cold_max_interval = 120s});
+    scheduler.sync_enabled_coins({"KMD", "BTC"});
+    scheduler.set_current_ticker("KMD");
+    auto now = t_scheduler::t_clock::now();
+
+    auto batch = scheduler.next_batch(now);
+    CHECK_EQ(batch.hot, std::vector<std::string>{"KMD"});
+    CHECK_EQ(batch.cold, std::vector<std::string>{"BTC"});
+    answer_all(scheduler, batch, now);
+
+    //! Hot coins every 10s, BTC unchanged: 30s, 60s then 120s (capped)
+    CHECK_EQ(scheduler.next_batch(now + 10s).hot, std::vector<std::string>{"KMD"});
+    CHECK(scheduler.next_batch(now + 29s).cold.empty());
+    now += 30s;
+    batch = scheduler.next_batch(now);
+    CHECK_EQ(batch.cold, std::vector<std::string>{"BTC"});
+    CHECK_FALSE(scheduler.on_balance("BTC", "1", now));
+    CHECK(scheduler.next_batch(now + 59s).cold.empty());
+    now += 60s;
+    batch = scheduler.next_batch(now);
+    CHECK_EQ(batch.cold, std::vector<std::string>{"BTC"});
+    CHECK_FALSE(scheduler.on_balance("BTC", "1", now));
+    CHECK(scheduler.next_batch(now + 119s).cold.empty());
+    CHECK_EQ(scheduler.next_batch(now + 120s).cold, std::vector<std::string>{"BTC"});
+}
+
+TEST_CASE("balance_refresh_scheduler promotes moving balances and swap coins to the hot tier")
+{
+    t_scheduler scheduler(atomic_dex::balance_refresh_cfg{.hot_change_window = 60s});
+    scheduler.sync_enabled_coins({"KMD", "BTC", "LTC"});
+    const auto now = t_scheduler::t_clock::now();
+    answer_all(scheduler, scheduler.next_batch(now), now);
+
+    CHECK_EQ(scheduler.tier_of("BTC", now), atomic_dex::refresh_tier::cold);
+    CHECK(scheduler.on_balance("BTC", "2", now + 1s));
+    CHECK_EQ(scheduler.tier_of("BTC", now + 30s), atomic_dex::refresh_tier::hot);
+    CHECK_EQ(scheduler.tier_of("BTC", now + 62s), atomic_dex::refresh_tier::cold);
+
+    scheduler.set_swap_coins({"LTC"});
+    CHECK_EQ(scheduler.tier_of("LTC", now), atomic_dex::refresh_tier::hot);
+
+    const auto metrics = scheduler.get_metrics();
+    CHECK_EQ(metrics.cold.nb_changes, 1);
+}
+
+TEST_CASE("balance_refresh_scheduler releases failed coins and forgets disabled ones")
+{
+    t_scheduler scheduler;
+    scheduler.sync_enabled_coins({"KMD", "BTC"});
+    const auto now   = t_scheduler::t_clock::now();
+    const auto batch = scheduler.next_batch(now);
+    REQUIRE_EQ(batch.cold.size(), 2);
+
+    scheduler.on_balance("KMD", "1", now);
+    scheduler.on_batch_failed(batch.cold, now);
+    CHECK(scheduler.next_batch(now + 1s).empty());
+    CHECK_EQ(scheduler.next_batch(now + 30s).cold, std::vector<std::string>{"BTC", "KMD"}); ///< failed or answered once, both wait the minimum interval
+
+    scheduler.sync_enabled_coins({"KMD"});
+    CHECK_FALSE(scheduler.on_balance("BTC", "3", now));
+
+    scheduler.on_batch_done(atomic_dex::refresh_tier::cold, 2, 200, 400, 1500us);
+    scheduler.on_full_refresh(now);
+    const auto metrics = scheduler.get_metrics();
+    CHECK_EQ(metrics.cold.nb_batches, 1);
+    CHECK_EQ(metrics.cold.nb_coins, 2);
+    CHECK_EQ(metrics.cold.request_bytes, 200);
+    CHECK_EQ(metrics.cold.answer_bytes, 400);
+    CHECK_EQ(metrics.cold.last_latency, 1500us);
+    CHECK_EQ(metrics.nb_full_refresh, 1);
+}
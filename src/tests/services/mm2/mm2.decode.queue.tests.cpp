@@ -0,0 +1,196 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+//! Deps
+#include <doctest/doctest.h>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.decode.queue.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+    using t_queue = atomic_dex::decode_queue;
+    using atomic_dex::decode_policy;
+} // namespace
+
+TEST_CASE("decode_queue keeps only the newest snapshot of a coalesced key")
+{
+    t_queue                  queue(atomic_dex::decode_queue_cfg{.capacity = 8, .nb_workers = 0});
+    std::vector<std::string> applied;
+    std::size_t              nb_superseded = 0;
+
+    auto push_snapshot = [&](const std::string& pair, const std::string& snapshot)
+    {
+        return queue.push(t_queue::job{
+            .rpc        = "orderbook",
+            .key        = pair,
+            .policy     = decode_policy::coalesce,
+            .task       = [&applied, snapshot]() { applied.push_back(snapshot); },
+            .on_dropped = [&nb_superseded]() { nb_superseded += 1; }});
+    };
+    CHECK(push_snapshot("KMD/BTC", "kmd-btc-1"));
+    CHECK(push_snapshot("KMD/LTC", "kmd-ltc-1"));
+    CHECK(push_snapshot("KMD/BTC", "kmd-btc-2"));
+    CHECK(push_snapshot("KMD/BTC", "kmd-btc-3"));
+    CHECK_EQ(queue.depth(), 2);
+
+    CHECK_EQ(queue.run_pending(), 2);
+    const std::vector<std::string> expected{"kmd-btc-3", "kmd-ltc-1"};
+    CHECK_EQ(applied, expected);
+    CHECK_EQ(nb_superseded, 2);
+
+    const auto metrics = queue.get_metrics();
+    CHECK_EQ(metrics.depth, 0);
+    CHECK_EQ(metrics.max_depth, 2);
+    CHECK_EQ(metrics.stages.at("orderbook").nb_enqueued, 4);
+    CHECK_EQ(metrics.stages.at("orderbook").nb_coalesced, 2);
+    CHECK_EQ(metrics.stages.at("orderbook").nb_processed, 2);
+}
+
+TEST_CASE("decode_queue evicts droppable jobs when full and never drops keep_all jobs")
+{
+    t_queue     queue(atomic_dex::decode_queue_cfg{.capacity = 2, .nb_workers = 0});
+    std::size_t nb_run     = 0;
+    std::size_t nb_dropped = 0;
+
+    auto make_job = [&](std::string rpc, std::string key, decode_policy policy)
+    {
+        return t_queue::job{
+            .rpc        = std::move(rpc),
+            .key        = std::move(key),
+            .policy     = policy,
+            .task       = [&nb_run]() { nb_run += 1; },
+            .on_dropped = [&nb_dropped]() { nb_dropped += 1; }};
+    };
+
+    CHECK(queue.push(make_job("orderbook", "KMD/BTC", decode_policy::coalesce)));
+    CHECK(queue.push(make_job("my_balance", "", decode_policy::keep_all)));
+
+    //! Full: a droppable job is rejected, a coalesced one evicts the oldest droppable job
+    CHECK_FALSE(queue.push(make_job("best_orders", "", decode_policy::drop)));
+    CHECK(queue.push(make_job("orderbook", "KMD/LTC", decode_policy::coalesce)));
+    CHECK_EQ(nb_dropped, 2);
+    CHECK_EQ(queue.depth(), 2);
+
+    //! Only keep_all jobs left: an incoming droppable job has nowhere to go
+    CHECK(queue.run_pending() == 2);
+    CHECK(queue.push(make_job("my_balance", "", decode_policy::keep_all)));
+    CHECK(queue.push(make_job("my_balance", "", decode_policy::keep_all)));
+    CHECK_FALSE(queue.push(make_job("orderbook", "KMD/DGB", decode_policy::coalesce)));
+    CHECK_EQ(queue.run_pending(), 2);
+    CHECK_EQ(nb_run, 4);
+    CHECK_EQ(nb_dropped, 3);
+
+    const auto metrics = queue.get_metrics();
+    CHECK_EQ(metrics.stages.at("orderbook").nb_dropped, 2);
+    CHECK_EQ(metrics.stages.at("best_orders").nb_dropped, 1);
+    CHECK_EQ(metrics.stages.at("my_balance").nb_processed, 3);
+    CHECK_EQ(metrics.stages.at("my_balance").nb_dropped, 0);
+}
+
+TEST_CASE("decode_queue workers apply every keep_all job under producer pressure")
+{
+    std::atomic_size_t nb_applied{0};
+    std::atomic_size_t nb_failed{0};
+    {
+        t_queue                  queue(atomic_dex::decode_queue_cfg{.capacity = 4, .nb_workers = 3});
+        std::vector<std::thread> producers;
+        for (std::size_t producer = 0; producer < 4; ++producer)
+        {
+            producers.emplace_back(
+                [&queue, &nb_applied, &nb_failed, producer]()
+                {
+                    for (std::size_t idx = 0; idx < 50; ++idx)
+                    {
+                        queue.push(t_queue::job{
+                            .rpc    = "my_balance",
+                            .policy = decode_policy::keep_all,
+                            .task =
+                                [&nb_applied, idx, producer]()
+                            {
+                                if (producer == 0 && idx == 0)
+                                {
+                                    throw std::runtime_error("invalid answer");
+                                }
+                                std::this_thread::sleep_for(50us);
+                                nb_applied += 1;
+                            },
+                            .on_dropped = [&nb_failed]() { nb_failed += 1; }});
+                    }
+                });
+        }
+        for (auto&& cur: producers) { cur.join(); }
+        while (queue.depth() > 0) { std::this_thread::sleep_for(1ms); }
+
+        const auto metrics = queue.get_metrics();
+        CHECK_LE(metrics.max_depth, 4);
+        CHECK_EQ(metrics.stages.at("my_balance").nb_enqueued, 200);
+        CHECK_EQ(metrics.stages.at("my_balance").nb_dropped, 0);
+    }
+    //! The queue joined its workers, every job ran (one of them threw)
+    CHECK_EQ(nb_applied.load(), 199);
+    CHECK_EQ(nb_failed.load(), 0);
+}
+
+TEST_CASE("decode_queue runs the snapshots of one rpc one at a time and in order")
+{
+    std::mutex               applied_mutex;
+    std::vector<std::string> applied;
+    std::atomic_size_t       nb_running{0};
+    std::atomic_size_t       max_running{0};
+    std::atomic_bool         other_rpc_done{false};
+    std::atomic_bool         other_rpc_ran_meanwhile{false};
+    {
+        t_queue queue(atomic_dex::decode_queue_cfg{.capacity = 8, .nb_workers = 2});
+        auto    push_snapshot = [&](const std::string& snapshot, std::chrono::milliseconds decode_time)
+        {
+            queue.push(t_queue::job{
+                .rpc    = "orders_and_swaps",
+                .policy = decode_policy::keep_all,
+                .task =
+                    [&, snapshot, decode_time]()
+                {
+                    const auto running = ++nb_running;
+                    max_running        = std::max(max_running.load(), running);
+                    std::this_thread::sleep_for(decode_time);
+                    other_rpc_ran_meanwhile = other_rpc_ran_meanwhile || other_rpc_done;
+                    {
+                        std::scoped_lock lock(applied_mutex);
+                        applied.push_back(snapshot);
+                    }
+                    --nb_running;
+                }});
+        };
+        push_snapshot("snapshot-1", 50ms);
+        push_snapshot("snapshot-2", 0ms);
+        queue.push(t_queue::job{.rpc = "my_balance", .policy = decode_policy::keep_all, .task = [&other_rpc_done]() { other_rpc_done = true; }});
+        push_snapshot("snapshot-3", 0ms);
+        while (queue.depth() > 0 || nb_running > 0) { std::this_thread::sleep_for(1ms); }
+    }
+    const std::vector<std::string> expected{"snapshot-1", "snapshot-2", "snapshot-3"};
+    CHECK_EQ(applied, expected);
+    CHECK_EQ(max_running.load(), 1);
+    //! The second worker does not wait behind the busy rpc
+    CHECK(other_rpc_ran_meanwhile.load());
+}
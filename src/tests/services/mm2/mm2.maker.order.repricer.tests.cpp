@@ -0,0 +1,238 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! Deps
+#include <doctest/doctest.h>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.maker.order.repricer.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+    using t_repricer = atomic_dex::maker_order_repricer;
+
+    atomic_dex::maker_order_entry
+    make_order(std::string uuid, std::string base, std::string rel, const char* price, const char* base_amount = "100")
+    {
+        return atomic_dex::maker_order_entry{
+            .uuid          = std::move(uuid),
+            .base          = std::move(base),
+            .rel           = std::move(rel),
+            .price         = t_float_50(price),
+            .base_amount   = t_float_50(base_amount),
+            .conf_settings = std::nullopt};
+    }
+
+    //! KMD/BTC is auto updated with a 1% spread and a 0.5% threshold, every other pair is disabled.
+    struct settings_stub
+    {
+        std::size_t nb_loads{0};
+        double      spread{1.0};
+
+        t_repricer::t_settings_loader
+        loader()
+        {
+            return [this](const std::string& base, const std::string& rel)
+            {
+                nb_loads += 1;
+                if (base == "KMD" && rel == "BTC")
+                {
+                    return atomic_dex::maker_pair_settings{.enabled = true, .spread = spread, .min_volume_percent = 10.0, .reprice_threshold = 0.5};
+                }
+                return atomic_dex::maker_pair_settings{};
+            };
+        }
+    };
+
+    const atomic_dex::maker_order_update*
+    find_update(const t_repricer::batch& batch, const std::string& uuid)
+    {
+        const auto it = std::find_if(batch.updates.begin(), batch.updates.end(), [&uuid](const auto& cur) { return cur.uuid == uuid; });
+        return it == batch.updates.end() ? nullptr : &*it;
+    }
+} // namespace
+
+TEST_CASE("maker_order_repricer reprices every order of a pair in one batch")
+{
+    settings_stub settings;
+    t_repricer    repricer(settings.loader());
+    const auto    start = t_repricer::t_clock::now();
+    repricer.sync_orders({make_order("a", "KMD", "BTC", "0.0001"), make_order("b", "KMD", "BTC", "0.0001", "50"), make_order("c", "DOC", "MARTY", "1")});
+
+    const auto pairs = repricer.get_pairs();
+    REQUIRE_EQ(pairs.size(), 1);
+    CHECK_EQ(pairs[0].first, "KMD");
+
+    CHECK(repricer.on_cex_price("KMD", "BTC", t_float_50("0.0002"), start));
+    CHECK_FALSE(repricer.on_cex_price("DOC", "MARTY", t_float_50("2"), start));
+    const auto batch = repricer.next_batch();
+    REQUIRE_EQ(batch.updates.size(), 2);
+    REQUIRE(batch.price_changed_at.has_value());
+    CHECK(*batch.price_changed_at == start);
+
+    const auto* update = find_update(batch, "b");
+    REQUIRE(update != nullptr);
+    CHECK(update->new_price == t_float_50("0.000202"));
+    CHECK(update->min_volume == t_float_50("5"));
+
+    repricer.on_batch_answered(batch, {}, start + 200ms);
+    const auto metrics = repricer.get_metrics();
+    CHECK_EQ(metrics.nb_batches, 1);
+    CHECK_EQ(metrics.nb_orders_sent, 2);
+    CHECK(metrics.last_latency == std::chrono::microseconds(200ms));
+    CHECK_EQ(settings.nb_loads, 2);
+}
+
+TEST_CASE("maker_order_repricer ignores price moves within the threshold")
+{
+    settings_stub settings;
+    t_repricer    repricer(settings.loader());
+    const auto    start = t_repricer::t_clock::now();
+    repricer.sync_orders({make_order("a", "KMD", "BTC", "0.0001")});
+
+    repricer.on_cex_price("KMD", "BTC", t_float_50("0.0002"), start);
+    CHECK_EQ(repricer.next_batch().updates.size(), 1);
+
+    CHECK_FALSE(repricer.on_cex_price("KMD", "BTC", t_float_50("0.000200"), start + 1s));
+    CHECK_FALSE(repricer.on_cex_price("KMD", "BTC", t_float_50("0.0002008"), start + 2s)); ///< 0.4%
+    CHECK(repricer.next_batch().empty());
+
+    CHECK(repricer.on_cex_price("KMD", "BTC", t_float_50("0.000202"), start + 3s)); ///< 1%
+    CHECK_EQ(repricer.next_batch().updates.size(), 1);
+    CHECK_EQ(repricer.get_metrics().nb_price_changes, 2);
+}
+
+TEST_CASE("maker_order_repricer does not send orders already at their target price")
+{
+    settings_stub settings;
+    t_repricer    repricer(settings.loader());
+    const auto    start = t_repricer::t_clock::now();
+    repricer.sync_orders({make_order("at_target", "KMD", "BTC", "0.000202"), make_order("stale", "KMD", "BTC", "0.00015")});
+
+    repricer.on_cex_price("KMD", "BTC", t_float_50("0.0002"), start);
+    const auto batch = repricer.next_batch();
+    REQUIRE_EQ(batch.updates.size(), 1);
+    CHECK_EQ(batch.updates[0].uuid, "stale");
+    CHECK_EQ(repricer.get_metrics().nb_orders_unchanged, 1);
+}
+
+TEST_CASE("maker_order_repricer checks new orders against the last price of their pair")
+{
+    settings_stub settings;
+    t_repricer    repricer(settings.loader());
+    const auto    start = t_repricer::t_clock::now();
+    repricer.sync_orders({make_order("a", "KMD", "BTC", "0.0001")});
+    repricer.on_cex_price("KMD", "BTC", t_float_50("0.0002"), start);
+    repricer.next_batch();
+
+    repricer.sync_orders({make_order("a", "KMD", "BTC", "0.000202"), make_order("new", "KMD", "BTC", "0.0003")});
+    const auto batch = repricer.next_batch();
+    REQUIRE_EQ(batch.updates.size(), 1);
+    CHECK_EQ(batch.updates[0].uuid, "new");
+    CHECK_FALSE(batch.price_changed_at.has_value());
+    CHECK(repricer.next_batch().empty());
+}
+
+TEST_CASE("maker_order_repricer checks again the orders whose price is not the one sent")
+{
+    settings_stub settings;
+    t_repricer    repricer(settings.loader());
+    const auto    start = t_repricer::t_clock::now();
+    repricer.sync_orders({make_order("a", "KMD", "BTC", "0.0001"), make_order("b", "KMD", "BTC", "0.0001")});
+    repricer.on_cex_price("KMD", "BTC", t_float_50("0.0002"), start);
+    REQUIRE_EQ(repricer.next_batch().updates.size(), 2);
+
+    //! "b" was edited back to its old price after the update
+    repricer.sync_orders({make_order("a", "KMD", "BTC", "0.000202"), make_order("b", "KMD", "BTC", "0.0001")});
+    const auto batch = repricer.next_batch();
+    REQUIRE_EQ(batch.updates.size(), 1);
+    CHECK_EQ(batch.updates[0].uuid, "b");
+    CHECK(batch.updates[0].new_price == t_float_50("0.000202"));
+    CHECK(repricer.next_batch().empty());
+}
+
+TEST_CASE("maker_order_repricer recognizes the sent price in the amounts reported by mm2")
+{
+    settings_stub settings;
+    t_repricer    repricer(settings.loader());
+    const auto    start = t_repricer::t_clock::now();
+    repricer.sync_orders({make_order("a", "KMD", "BTC", "0.0001"), make_order("b", "KMD", "BTC", "0.0001")});
+    repricer.on_cex_price("KMD", "BTC", t_float_50("0.000123456789"), start);
+    REQUIRE_EQ(repricer.next_batch().updates.size(), 2);
+
+    //! "a" went out as "0.00012469" and comes back as rel_amount / base_amount, "b" was edited to a close but different price
+    auto reported  = make_order("a", "KMD", "BTC", "0", "3");
+    reported.price = t_float_50("0.00037407") / reported.base_amount;
+    repricer.sync_orders({reported, make_order("b", "KMD", "BTC", "0.0001246")});
+    CHECK(repricer.next_batch().empty());
+    CHECK_EQ(repricer.get_metrics().nb_orders_unchanged, 1);
+}
+
+TEST_CASE("maker_order_repricer retries the orders mm2 did not update")
+{
+    settings_stub settings;
+    t_repricer    repricer(settings.loader());
+    const auto    start = t_repricer::t_clock::now();
+    repricer.sync_orders({make_order("a", "KMD", "BTC", "0.0001"), make_order("b", "KMD", "BTC", "0.0001")});
+    repricer.on_cex_price("KMD", "BTC", t_float_50("0.0002"), start);
+
+    const auto batch = repricer.next_batch();
+    repricer.on_batch_answered(batch, {"b"}, start + 1s);
+    const auto retry = repricer.next_batch();
+    REQUIRE_EQ(retry.updates.size(), 1);
+    CHECK_EQ(retry.updates[0].uuid, "b");
+    CHECK_EQ(repricer.get_metrics().nb_orders_failed, 1);
+}
+
+TEST_CASE("maker_order_repricer caches the settings of a pair until they are cleared")
+{
+    settings_stub settings;
+    t_repricer    repricer(settings.loader());
+    const auto    start = t_repricer::t_clock::now();
+    repricer.sync_orders({make_order("a", "KMD", "BTC", "0.0001")});
+
+    for (int idx = 0; idx < 10; ++idx)
+    {
+        repricer.on_cex_price("KMD", "BTC", t_float_50("0.0002") * (idx + 1), start + std::chrono::seconds(idx));
+        repricer.next_batch();
+    }
+    CHECK_EQ(settings.nb_loads, 1);
+
+    repricer.clear_settings();
+    CHECK_EQ(repricer.get_pairs().size(), 1);
+    CHECK_EQ(settings.nb_loads, 2);
+    CHECK_EQ(repricer.get_metrics().nb_settings_loads, 2);
+}
+
+TEST_CASE("maker_order_repricer applies the edited settings without waiting for a price move")
+{
+    settings_stub settings;
+    t_repricer    repricer(settings.loader());
+    const auto    start = t_repricer::t_clock::now();
+    repricer.sync_orders({make_order("a", "KMD", "BTC", "0.0001")});
+    repricer.on_cex_price("KMD", "BTC", t_float_50("0.0002"), start);
+    REQUIRE_EQ(repricer.next_batch().updates.size(), 1);
+
+    settings.spread = 2.0;
+    repricer.clear_settings();
+    const auto batch = repricer.next_batch();
+    REQUIRE_EQ(batch.updates.size(), 1);
+    CHECK(batch.updates[0].new_price == t_float_50("0.000204"));
+    CHECK(repricer.next_batch().empty());
+}
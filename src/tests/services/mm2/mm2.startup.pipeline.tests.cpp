@@ -0,0 +1,137 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! Deps
+#include <doctest/doctest.h>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.startup.pipeline.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+    using t_timeline = atomic_dex::startup_timeline;
+
+    atomic_dex::mm2_readiness_cfg
+    make_fast_readiness_cfg(std::chrono::milliseconds timeout)
+    {
+        return atomic_dex::mm2_readiness_cfg{.initial_delay = 1ms, .max_delay = 4ms, .probe_timeout = 10ms, .timeout = timeout};
+    }
+} // namespace
+
+TEST_CASE("mm2_readiness_backoff doubles the delay up to its maximum")
+{
+    const atomic_dex::mm2_readiness_cfg cfg{.initial_delay = 10ms, .max_delay = 250ms};
+    CHECK_EQ(atomic_dex::mm2_readiness_backoff(cfg, 1), 10ms);
+    CHECK_EQ(atomic_dex::mm2_readiness_backoff(cfg, 2), 20ms);
+    CHECK_EQ(atomic_dex::mm2_readiness_backoff(cfg, 3), 40ms);
+    CHECK_EQ(atomic_dex::mm2_readiness_backoff(cfg, 5), 160ms);
+    CHECK_EQ(atomic_dex::mm2_readiness_backoff(cfg, 6), 250ms);
+    CHECK_EQ(atomic_dex::mm2_readiness_backoff(cfg, 100), 250ms);
+}
+
+TEST_CASE("wait_for_mm2_readiness returns as soon as mm2 answers")
+{
+    std::atomic_bool cancelled{false};
+    std::size_t      nb_calls = 0;
+    const auto       result   = atomic_dex::wait_for_mm2_readiness(
+        make_fast_readiness_cfg(5s),
+        [&nb_calls](std::chrono::milliseconds probe_timeout)
+        {
+            CHECK_EQ(probe_timeout, 10ms);
+            return ++nb_calls == 4;
+        },
+        cancelled);
+    CHECK(result.ready);
+    CHECK_FALSE(result.cancelled);
+    CHECK_EQ(result.nb_probes, 4);
+    CHECK(result.error.empty());
+    CHECK_LT(result.elapsed, 1s);
+}
+
+TEST_CASE("wait_for_mm2_readiness reports a timeout with the last probe error")
+{
+    std::atomic_bool cancelled{false};
+    const auto       result = atomic_dex::wait_for_mm2_readiness(
+        make_fast_readiness_cfg(30ms), []([[maybe_unused]] std::chrono::milliseconds probe_timeout) -> bool { throw std::runtime_error("connection refused"); },
+        cancelled);
+    CHECK_FALSE(result.ready);
+    CHECK_FALSE(result.cancelled);
+    CHECK_GT(result.nb_probes, 1);
+    CHECK_GE(result.elapsed, 30ms);
+    CHECK_NE(result.error.find("connection refused"), std::string::npos);
+}
+
+TEST_CASE("wait_for_mm2_readiness stops probing once cancelled")
+{
+    std::atomic_bool cancelled{false};
+    const auto       result = atomic_dex::wait_for_mm2_readiness(
+        make_fast_readiness_cfg(5s),
+        [&cancelled]([[maybe_unused]] std::chrono::milliseconds probe_timeout)
+        {
+            cancelled = true;
+            return false;
+        },
+        cancelled);
+    CHECK_FALSE(result.ready);
+    CHECK(result.cancelled);
+    CHECK_EQ(result.nb_probes, 1);
+}
+
+TEST_CASE("startup_timeline keeps the first occurrence of every stage")
+{
+    t_timeline timeline;
+    const auto start = t_timeline::t_clock::now();
+    CHECK_FALSE(timeline.record("mm2_spawned", start));
+
+    timeline.start(start);
+    CHECK(timeline.record("mm2_spawned", start + 5ms));
+    CHECK(timeline.record("mm2_ready", start + 120ms));
+    CHECK_FALSE(timeline.record("mm2_spawned", start + 200ms));
+    CHECK(timeline.has_stage("mm2_ready"));
+    CHECK_FALSE(timeline.has_stage("first_balance"));
+
+    const auto stages = timeline.get_stages();
+    REQUIRE_EQ(stages.size(), 2);
+    CHECK_EQ(stages[0].first, "mm2_spawned");
+    CHECK_EQ(stages[0].second, 5ms);
+    CHECK_EQ(stages[1].second, 120ms);
+
+    const auto json = timeline.to_json();
+    CHECK_EQ(json.at("stages").size(), 2);
+    CHECK_EQ(json.at("stages")[1].at("stage").get<std::string>(), "mm2_ready");
+    CHECK_EQ(json.at("stages")[1].at("elapsed_ms").get<long long>(), 120);
+    CHECK_FALSE(json.contains("error"));
+
+    //! A new login starts from scratch
+    timeline.start(start + 1s);
+    CHECK(timeline.get_stages().empty());
+}
+
+TEST_CASE("startup_timeline records the reason of a failed startup")
+{
+    t_timeline timeline;
+    const auto start = t_timeline::t_clock::now();
+    timeline.start(start);
+    timeline.fail("mm2 did not answer", start + 30s);
+    timeline.fail("another error", start + 31s);
+    CHECK(timeline.has_stage("failed"));
+    const auto json = timeline.to_json();
+    CHECK_EQ(json.at("error").get<std::string>(), "mm2 did not answer");
+    CHECK_EQ(json.at("stages")[0].at("elapsed_ms").get<long long>(), 30000);
+}
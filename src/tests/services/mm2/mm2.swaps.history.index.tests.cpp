@@ -0,0 +1,235 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! Deps
+#include <doctest/doctest.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.swaps.history.index.hpp"
+
+namespace
+{
+    const std::vector<std::string> g_coins{"KMD", "BTC", "LTC", "DOGE", "RICK", "MORTY"};
+
+    //! Swap `idx` started at `1600000000 + idx * 60`, finished unless `finished` is false.
+    nlohmann::json
+    make_swap(std::size_t idx, bool finished = true)
+    {
+        const std::uint64_t started_at = 1600000000 + idx * 60;
+        nlohmann::json      events     = nlohmann::json::array();
+        events.push_back({{"timestamp", started_at * 1000 + 500}, {"event", {{"type", "Started"}, {"data", {{"started_at", started_at}}}}}});
+        if (finished)
+        {
+            events.push_back({{"timestamp", started_at * 1000 + 900}, {"event", {{"type", "Finished"}}}});
+        }
+        return {
+            {"uuid", "uuid-" + std::to_string(idx)},
+            {"type", idx % 2 == 0 ? "Maker" : "Taker"},
+            {"maker_coin", g_coins[idx % g_coins.size()]},
+            {"taker_coin", g_coins[(idx + 1) % g_coins.size()]},
+            {"maker_amount", "1"},
+            {"taker_amount", "2"},
+            {"events", events},
+            {"error_events", nlohmann::json::array()},
+            {"success_events", {"Started", "Finished"}}};
+    }
+
+    struct index_fixture
+    {
+        fs::path folder{fs::temp_directory_path() / "atomicdex.tests.swaps.index"};
+
+        index_fixture()
+        {
+            fs::remove_all(folder);
+            fs::create_directories(folder);
+        }
+
+        ~index_fixture() { fs::remove_all(folder); }
+    };
+
+    std::vector<std::string>
+    uuids_of(const atomic_dex::swaps_index_page& page)
+    {
+        std::vector<std::string> out;
+        for (auto&& swap: page.swaps) { out.push_back(swap.at("uuid").get<std::string>()); }
+        return out;
+    }
+} // namespace
+
+TEST_CASE("swaps_history_index pages the history most recent first")
+{
+    index_fixture                   fixture;
+    atomic_dex::swaps_history_index index;
+    REQUIRE(index.open(fixture.folder, "wallet"));
+    for (std::size_t idx = 0; idx < 120; ++idx) { CHECK(index.upsert(make_swap(idx)) == atomic_dex::swaps_index_upsert::inserted); }
+    CHECK(index.upsert(make_swap(3)) == atomic_dex::swaps_index_upsert::unchanged);
+
+    const auto first = index.query({.page = 1, .limit = 50});
+    CHECK_EQ(first.total, 120);
+    CHECK_EQ(first.nb_pages, 3);
+    REQUIRE_EQ(first.swaps.size(), 50);
+    CHECK_EQ(uuids_of(first).front(), "uuid-119");
+
+    const auto last = index.query({.page = 3, .limit = 50});
+    REQUIRE_EQ(last.swaps.size(), 20);
+    CHECK_EQ(uuids_of(last).back(), "uuid-0");
+    CHECK_EQ(index.oldest_uuid().value_or(""), "uuid-0");
+
+    //! The active swaps are shown apart, they are skipped without shifting the pages.
+    const auto without_active = index.query({.page = 1, .limit = 50}, {"uuid-119", "uuid-100"});
+    CHECK_EQ(without_active.total, 118);
+    const auto uuids = uuids_of(without_active);
+    CHECK_EQ(uuids.front(), "uuid-118");
+    CHECK(std::find(uuids.begin(), uuids.end(), "uuid-100") == uuids.end());
+    CHECK_EQ(uuids.back(), "uuid-68");
+}
+
+TEST_CASE("swaps_history_index filters through its secondary indices")
+{
+    index_fixture                   fixture;
+    atomic_dex::swaps_history_index index;
+    REQUIRE(index.open(fixture.folder, "wallet"));
+    for (std::size_t idx = 0; idx < 600; ++idx) { index.upsert(make_swap(idx, idx % 10 != 0)); }
+
+    //! My coin is the maker coin of maker swaps (0, 6, 12...) and the taker coin of taker swaps (5, 11, 17...).
+    const auto kmd = index.query({.my_coin = "KMD", .limit = 1000});
+    CHECK_EQ(kmd.total, 200);
+    for (auto&& swap: kmd.swaps)
+    {
+        const bool is_maker = swap.at("type") == "Maker";
+        CHECK_EQ(swap.at(is_maker ? "maker_coin" : "taker_coin").get<std::string>(), "KMD");
+    }
+
+    const auto pair = index.query({.my_coin = "KMD", .other_coin = "BTC", .limit = 1000});
+    CHECK_EQ(pair.total, 100);
+    CHECK_EQ(index.query({.my_coin = "KMD", .other_coin = "MORTY"}).total, 100);
+    CHECK_EQ(index.query({.my_coin = "KMD", .other_coin = "LTC"}).total, 0);
+
+    const auto ongoing = index.query({.status = "matched", .limit = 1000});
+    CHECK_EQ(ongoing.total, 60);
+    CHECK_EQ(index.pending_uuids().size(), 60);
+
+    const auto kmd_ongoing = index.query({.my_coin = "KMD", .status = "matched", .limit = 1000});
+    CHECK_EQ(kmd_ongoing.total, 20);
+
+    //! Swaps 100 to 199 included.
+    const auto range = index.query({.from_timestamp = 1600000000 + 100 * 60, .to_timestamp = 1600000000 + 199 * 60, .limit = 30});
+    CHECK_EQ(range.total, 100);
+    CHECK_EQ(range.nb_pages, 4);
+    CHECK_EQ(uuids_of(range).front(), "uuid-199");
+
+    //! A running swap that received new events is appended again and moves to its new status.
+    CHECK(index.upsert(make_swap(10)) == atomic_dex::swaps_index_upsert::updated);
+    CHECK_EQ(index.get_status("uuid-10").value_or(""), "successful");
+    CHECK_EQ(index.query({.status = "matched"}).total, 59);
+    CHECK_EQ(index.get("uuid-10")->at("events").size(), 2);
+}
+
+TEST_CASE("swaps_history_index is restored from disk")
+{
+    index_fixture fixture;
+    {
+        atomic_dex::swaps_history_index index;
+        REQUIRE(index.open(fixture.folder, "wallet"));
+        for (std::size_t idx = 0; idx < 40; ++idx) { index.upsert(make_swap(idx, idx != 5)); }
+        index.set_complete(true);
+        CHECK(index.save());
+        //! Appended after the save: not in the saved index, fetched again next session.
+        index.upsert(make_swap(40));
+    }
+
+    atomic_dex::swaps_history_index index;
+    REQUIRE(index.open(fixture.folder, "wallet"));
+    CHECK_EQ(index.size(), 40);
+    CHECK(index.is_complete());
+    CHECK_EQ(index.get_status("uuid-5").value_or(""), "matched");
+    CHECK_EQ(uuids_of(index.query({.limit = 1})).front(), "uuid-39");
+    CHECK(index.upsert(make_swap(5)) == atomic_dex::swaps_index_upsert::updated);
+    CHECK(index.upsert(make_swap(40)) == atomic_dex::swaps_index_upsert::inserted);
+    CHECK_EQ(index.get("uuid-40")->at("uuid").get<std::string>(), "uuid-40");
+
+    //! A truncated data file drops the entries it no longer holds.
+    CHECK(index.save());
+    index.close();
+    fs::resize_file(index.get_data_path(), fs::file_size(index.get_data_path()) / 2);
+    atomic_dex::swaps_history_index truncated;
+    REQUIRE(truncated.open(fixture.folder, "wallet"));
+    CHECK_LT(truncated.size(), 41);
+    CHECK_FALSE(truncated.is_complete());
+}
+
+TEST_CASE("benchmark swaps history index with 50k swaps" * doctest::skip(true))
+{
+    constexpr std::size_t nb_swaps   = 50000;
+    constexpr std::size_t nb_queries = 1000;
+    index_fixture         fixture;
+
+    std::vector<nlohmann::json> swaps;
+    swaps.reserve(nb_swaps);
+    for (std::size_t idx = 0; idx < nb_swaps; ++idx) { swaps.push_back(make_swap(idx)); }
+
+    spdlog::stopwatch build_sw;
+    {
+        atomic_dex::swaps_history_index index;
+        index.open(fixture.folder, "wallet");
+        for (auto&& swap: swaps) { index.upsert(swap); }
+        index.set_complete(true);
+        index.save();
+    }
+    const auto build_elapsed = build_sw.elapsed();
+
+    spdlog::stopwatch               load_sw;
+    atomic_dex::swaps_history_index index;
+    index.open(fixture.folder, "wallet");
+    const auto load_elapsed = load_sw.elapsed();
+    CHECK_EQ(index.size(), nb_swaps);
+
+    const std::unordered_set<std::string> active{"uuid-49999", "uuid-49000"};
+    spdlog::stopwatch                     query_sw;
+    std::size_t                           nb_rows = 0;
+    for (std::size_t idx = 0; idx < nb_queries; ++idx)
+    {
+        const auto page = index.query({.my_coin = g_coins[(idx % 3) * 2], .page = idx % 20 + 1, .limit = 50}, active);
+        nb_rows += page.swaps.size();
+    }
+    const auto query_elapsed = query_sw.elapsed();
+
+    //! Filtering the raw history without the secondary indices, what a local filter over the decoded swaps would do.
+    spdlog::stopwatch scan_sw;
+    std::size_t       nb_scanned = 0;
+    for (std::size_t idx = 0; idx < nb_queries / 10; ++idx)
+    {
+        const auto& coin  = g_coins[(idx % 3) * 2];
+        std::size_t total = 0;
+        for (auto&& swap: swaps)
+        {
+            const bool is_maker = swap.at("type") == "Maker";
+            total += swap.at(is_maker ? "maker_coin" : "taker_coin") == coin ? 1 : 0;
+        }
+        nb_scanned += total;
+    }
+    const auto scan_elapsed = scan_sw.elapsed() * 10;
+
+    CHECK_EQ(nb_rows, nb_queries * 50);
+    CHECK_GT(nb_scanned, 0);
+    SPDLOG_INFO(
+        "{} swaps: build {:.3f}s, load {:.3f}s, {} filtered pages {:.3f}s, same filters by scanning {:.3f}s", nb_swaps, build_elapsed.count(),
+        load_elapsed.count(), nb_queries, query_elapsed.count(), scan_elapsed.count());
+}
@@ -0,0 +1,272 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! Deps
+#include <doctest/doctest.h>
+
+//! Project Headers
+#include "atomicdex/services/mm2/mm2.trade.evaluation.engine.hpp"
+
+namespace
+{
+    using namespace std::chrono_literals;
+    using t_engine = atomic_dex::trade_evaluation_engine;
+
+    //! Minimal mm2 stand-in, every trade_preimage stays in flight until the test answers it.
+    struct stub_mm2
+    {
+        struct request
+        {
+            atomic_dex::trade_preimage_key              key;
+            pplx::cancellation_token                    token;
+            pplx::task_completion_event<nlohmann::json> tce;
+        };
+
+        std::vector<request> requests;
+
+        t_engine::t_fetch_functor
+        fetcher()
+        {
+            return [this](const atomic_dex::trade_preimage_key& key, pplx::cancellation_token token)
+            {
+                requests.push_back(request{.key = key, .token = token, .tce = {}});
+                return pplx::create_task(requests.back().tce);
+            };
+        }
+
+        void
+        answer(std::size_t idx, const nlohmann::json& answer = {{"result", {{"total_fees", nlohmann::json::array()}}}})
+        {
+            requests[idx].tce.set(answer);
+        }
+    };
+
+    struct answers_log
+    {
+        std::vector<std::pair<atomic_dex::trade_preimage_key, std::optional<nlohmann::json>>> answers;
+
+        t_engine::t_answer_functor
+        functor()
+        {
+            return [this](const atomic_dex::trade_preimage_key& key, std::optional<nlohmann::json> answer) { answers.emplace_back(key, std::move(answer)); };
+        }
+    };
+
+    atomic_dex::trade_preimage_key
+    make_key(std::string volume, std::string base = "KMD")
+    {
+        return atomic_dex::trade_preimage_key{.base = std::move(base), .rel = "BTC", .swap_method = "sell", .volume = std::move(volume), .price = "0.0001"};
+    }
+} // namespace
+
+TEST_CASE("normalize_trade_amount")
+{
+    CHECK_EQ(atomic_dex::normalize_trade_amount("1.500"), "1.5");
+    CHECK_EQ(atomic_dex::normalize_trade_amount("2.0"), "2");
+    CHECK_EQ(atomic_dex::normalize_trade_amount("0.000"), "0");
+    CHECK_EQ(atomic_dex::normalize_trade_amount("100"), "100");
+    CHECK_EQ(atomic_dex::normalize_trade_amount(""), "0");
+}
+
+TEST_CASE("trade_evaluation_engine sends one trade_preimage for edits inside the debounce window")
+{
+    stub_mm2    mm2;
+    answers_log log;
+    t_engine    engine(mm2.fetcher(), log.functor(), atomic_dex::trade_evaluation_cfg{.debounce = 300ms});
+    const auto  start = t_engine::t_clock::now();
+
+    //! Typing "12.5" one key at a time
+    engine.submit(make_key("1"), start);
+    engine.submit(make_key("12"), start + 50ms);
+    engine.submit(make_key("12."), start + 100ms);
+    engine.submit(make_key("12.5"), start + 150ms);
+
+    CHECK(engine.is_busy());
+    CHECK_FALSE(engine.run_due(start + 200ms));
+    REQUIRE(engine.next_deadline().has_value());
+    CHECK(engine.run_due(*engine.next_deadline()));
+    REQUIRE_EQ(mm2.requests.size(), 1);
+    CHECK_EQ(mm2.requests[0].key.volume, "12.5");
+
+    mm2.answer(0);
+    REQUIRE_EQ(log.answers.size(), 1);
+    CHECK(log.answers[0].second.has_value());
+    CHECK_FALSE(engine.is_busy());
+
+    const auto metrics = engine.get_metrics();
+    CHECK_EQ(metrics.nb_coalesced, 2); ///< "12." normalizes to "12", the same evaluation as the pending one
+    CHECK_EQ(metrics.nb_misses, 1);
+    CHECK_EQ(metrics.nb_hits, 0);
+}
+
+TEST_CASE("trade_evaluation_engine cancels the superseded request in flight")
+{
+    stub_mm2    mm2;
+    answers_log log;
+    t_engine    engine(mm2.fetcher(), log.functor());
+    const auto  start = t_engine::t_clock::now();
+
+    engine.submit(make_key("1"), start);
+    engine.run_due(start + 1s);
+    engine.submit(make_key("2"), start + 2s);
+    CHECK_FALSE(mm2.requests[0].token.is_canceled());
+    engine.run_due(start + 3s);
+    REQUIRE_EQ(mm2.requests.size(), 2);
+    CHECK(mm2.requests[0].token.is_canceled());
+
+    //! The answer of the superseded request arrives last, it is dropped
+    mm2.answer(1);
+    mm2.answer(0);
+    REQUIRE_EQ(log.answers.size(), 1);
+    CHECK_EQ(log.answers[0].first.volume, "2");
+    CHECK_EQ(engine.get_metrics().nb_cancelled, 1);
+}
+
+TEST_CASE("trade_evaluation_engine keeps the request in flight when the edit goes back to it")
+{
+    stub_mm2    mm2;
+    answers_log log;
+    t_engine    engine(mm2.fetcher(), log.functor());
+    const auto  start = t_engine::t_clock::now();
+
+    engine.submit(make_key("1"), start);
+    engine.run_due(start + 1s);
+    engine.submit(make_key("10"), start + 2s);
+    engine.submit(make_key("1"), start + 2s + 10ms);
+    CHECK_FALSE(engine.run_due(start + 3s));
+
+    mm2.answer(0);
+    REQUIRE_EQ(mm2.requests.size(), 1);
+    REQUIRE_EQ(log.answers.size(), 1);
+    CHECK_EQ(log.answers[0].first.volume, "1");
+}
+
+TEST_CASE("trade_evaluation_engine answers from the cache until the entry expires")
+{
+    stub_mm2    mm2;
+    answers_log log;
+    t_engine    engine(mm2.fetcher(), log.functor(), atomic_dex::trade_evaluation_cfg{.preimage_ttl = 10s});
+    const auto  start = t_engine::t_clock::now();
+
+    engine.submit(make_key("1.5"), start);
+    engine.run_due(start + 1s);
+    mm2.answer(0);
+
+    //! Same volume bucket, answered right away without a request
+    engine.submit(make_key("1.50"), start + 2s);
+    CHECK_EQ(log.answers.size(), 2);
+    CHECK_FALSE(engine.is_busy());
+    CHECK_EQ(mm2.requests.size(), 1);
+
+    //! Expired, asked again
+    engine.submit(make_key("1.5"), start + 20s);
+    CHECK(engine.run_due(start + 21s));
+    CHECK_EQ(mm2.requests.size(), 2);
+
+    const auto metrics = engine.get_metrics();
+    CHECK_EQ(metrics.nb_hits, 1);
+    CHECK_EQ(metrics.nb_misses, 2);
+}
+
+TEST_CASE("trade_evaluation_engine does not cache errors and reports failures")
+{
+    stub_mm2    mm2;
+    answers_log log;
+    t_engine    engine(mm2.fetcher(), log.functor());
+    const auto  start = t_engine::t_clock::now();
+
+    engine.submit(make_key("1"), start);
+    engine.run_due(start + 1s);
+    mm2.answer(0, {{"error", "not enough balance"}});
+
+    engine.submit(make_key("2"), start + 2s);
+    engine.run_due(start + 3s);
+    mm2.requests[1].tce.set_exception(std::runtime_error("connection refused"));
+
+    engine.submit(make_key("1"), start + 4s);
+    CHECK(engine.run_due(start + 5s));
+    CHECK_EQ(mm2.requests.size(), 3);
+
+    REQUIRE_EQ(log.answers.size(), 2);
+    CHECK_FALSE(log.answers[1].second.has_value());
+    CHECK_EQ(engine.get_metrics().nb_failed, 1);
+    CHECK_EQ(engine.get_metrics().nb_hits, 0);
+}
+
+TEST_CASE("trade_evaluation_engine invalidates the answers of a coin")
+{
+    stub_mm2    mm2;
+    answers_log log;
+    t_engine    engine(mm2.fetcher(), log.functor());
+    const auto  start = t_engine::t_clock::now();
+
+    engine.submit(make_key("1"), start);
+    engine.run_due(start + 1s);
+    mm2.answer(0);
+    engine.submit(make_key("1", "LTC"), start + 2s);
+    engine.run_due(start + 3s);
+    mm2.answer(1);
+
+    engine.invalidate("KMD");
+    engine.submit(make_key("1", "LTC"), start + 4s);
+    CHECK_EQ(engine.get_metrics().nb_hits, 1);
+    engine.submit(make_key("1"), start + 5s);
+    CHECK(engine.run_due(start + 6s));
+    CHECK_EQ(mm2.requests.size(), 3);
+}
+
+TEST_CASE("trade_evaluation_engine drops everything on cancel")
+{
+    stub_mm2    mm2;
+    answers_log log;
+    t_engine    engine(mm2.fetcher(), log.functor());
+    const auto  start = t_engine::t_clock::now();
+
+    engine.submit(make_key("1"), start);
+    engine.run_due(start + 1s);
+    engine.submit(make_key("2"), start + 2s);
+    engine.cancel();
+
+    CHECK_FALSE(engine.is_busy());
+    CHECK_FALSE(engine.next_deadline().has_value());
+    CHECK_FALSE(engine.run_due(start + 3s));
+    mm2.answer(0);
+    CHECK(log.answers.empty());
+}
+
+TEST_CASE("trade_volume_cache")
+{
+    atomic_dex::trade_volume_cache cache(atomic_dex::trade_evaluation_cfg{.volumes_ttl = 30s});
+    const auto                     start = atomic_dex::trade_volume_cache::t_clock::now();
+    const nlohmann::json           answer{{"result", {{"coin", "KMD"}, {"decimal", "10"}}}};
+
+    CHECK_FALSE(cache.get(atomic_dex::trade_volume_kind::max_taker_vol, "KMD", start).has_value());
+    cache.store(atomic_dex::trade_volume_kind::max_taker_vol, "KMD", answer, start);
+    CHECK_EQ(cache.get(atomic_dex::trade_volume_kind::max_taker_vol, "KMD", start + 10s), answer);
+    CHECK_FALSE(cache.get(atomic_dex::trade_volume_kind::min_trading_vol, "KMD", start + 10s).has_value());
+    CHECK_FALSE(cache.get(atomic_dex::trade_volume_kind::max_taker_vol, "KMD", start + 31s).has_value());
+
+    cache.store(atomic_dex::trade_volume_kind::min_trading_vol, "KMD", answer, start);
+    cache.invalidate("KMD");
+    CHECK_FALSE(cache.get(atomic_dex::trade_volume_kind::min_trading_vol, "KMD", start).has_value());
+
+    const auto metrics = cache.get_metrics();
+    CHECK_EQ(metrics.nb_hits, 1);
+    CHECK_EQ(metrics.nb_misses, 4);
+    CHECK_EQ(metrics.nb_invalidated, 2);
+}
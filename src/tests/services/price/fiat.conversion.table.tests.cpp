@@ -0,0 +1,179 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <shared_mutex>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/services/price/fiat.conversion.table.hpp"
+
+namespace
+{
+    atomic_dex::fiat_conversion_entry
+    make_entry(std::string_view value)
+    {
+        return {.value = t_fixed_decimal::from_string(value).value(), .display = std::string(value)};
+    }
+} // namespace
+
+TEST_CASE("fiat_conversion_table caches conversions per ticker and fiat")
+{
+    atomic_dex::fiat_conversion_table table;
+    CHECK_FALSE(table.find("USD", "KMD").has_value());
+
+    table.store("USD", "KMD", make_entry("12.5"), table.generation());
+    table.store("EUR", "KMD", make_entry("11.25"), table.generation());
+    table.store("USD", "BTC", make_entry("20000"), table.generation());
+
+    const auto kmd_usd = table.find("USD", "KMD");
+    REQUIRE(kmd_usd.has_value());
+    CHECK_EQ(kmd_usd->display, "12.5");
+    CHECK_EQ(table.find("EUR", "KMD")->display, "11.25");
+    CHECK_FALSE(table.find("EUR", "BTC").has_value());
+
+    const auto metrics = table.get_metrics();
+    CHECK_EQ(metrics.hits, 2);
+    CHECK_EQ(metrics.misses, 2);
+}
+
+TEST_CASE("fiat_conversion_table drops the entries of the updated balances and every total")
+{
+    atomic_dex::fiat_conversion_table table;
+    table.store("USD", "KMD", make_entry("12.5"), table.generation());
+    table.store("USD", "BTC", make_entry("20000"), table.generation());
+    table.store_total("USD", t_fixed_decimal::from_string("20012.5").value(), table.generation());
+    CHECK(table.find_total("USD").has_value());
+
+    table.invalidate_tickers({"KMD"});
+    CHECK_FALSE(table.find("USD", "KMD").has_value());
+    CHECK(table.find("USD", "BTC").has_value());
+    CHECK_FALSE(table.find_total("USD").has_value());
+
+    table.invalidate_all();
+    CHECK_FALSE(table.find("USD", "BTC").has_value());
+    CHECK_EQ(table.get_metrics().invalidations, 2);
+}
+
+TEST_CASE("fiat_conversion_table does not store a value computed before an invalidation")
+{
+    atomic_dex::fiat_conversion_table table;
+
+    //! A price event arrives while the conversion is being computed with the previous price.
+    const auto generation = table.generation();
+    table.invalidate_all();
+    table.store("USD", "KMD", make_entry("12.5"), generation);
+    table.store_total("USD", t_fixed_decimal(12), generation);
+    CHECK_FALSE(table.find("USD", "KMD").has_value());
+    CHECK_FALSE(table.find_total("USD").has_value());
+    CHECK_EQ(table.get_metrics().stale_stores, 2);
+
+    table.store("USD", "KMD", make_entry("13"), table.generation());
+    CHECK_EQ(table.find("USD", "KMD")->display, "13");
+}
+
+TEST_CASE("fiat_conversion_table keeps only the current currency")
+{
+    atomic_dex::fiat_conversion_table table;
+    table.store("USD", "KMD", make_entry("12.5"), table.generation());
+    table.store("EUR", "KMD", make_entry("11.25"), table.generation());
+    table.store_total("EUR", t_fixed_decimal(11), table.generation());
+
+    table.retain_fiat("USD");
+    CHECK(table.find("USD", "KMD").has_value());
+    CHECK_FALSE(table.find("EUR", "KMD").has_value());
+    CHECK_FALSE(table.find_total("EUR").has_value());
+}
+
+TEST_CASE("benchmark portfolio total from the conversion table against the former recomputation" * doctest::skip(true))
+{
+    constexpr std::size_t nb_coins  = 300;
+    constexpr std::size_t nb_rounds = 2000;
+
+    std::vector<std::string> tickers;
+    std::vector<std::string> prices;
+    std::vector<std::string> balances;
+    for (std::size_t idx = 0; idx < nb_coins; ++idx)
+    {
+        tickers.push_back("COIN" + std::to_string(idx));
+        prices.push_back(std::to_string(idx + 1) + ".123456");
+        balances.push_back(std::to_string(idx % 11) + ".5");
+    }
+
+    //! Former path: every read takes the rate lock, parses price and balance, prints the product then parses it back to sum it.
+    std::shared_mutex rate_mutex;
+    std::string       legacy_total;
+    spdlog::stopwatch legacy_sw;
+    for (std::size_t round = 0; round < nb_rounds; ++round)
+    {
+        t_fixed_decimal total(0);
+        for (std::size_t idx = 0; idx < nb_coins; ++idx)
+        {
+            std::string price;
+            {
+                std::shared_lock lock(rate_mutex);
+                price = prices[idx];
+            }
+            total += safe_decimal((safe_decimal(price) * safe_decimal(balances[idx])).str(6));
+        }
+        legacy_total = total.str(2);
+    }
+    const auto legacy_elapsed = legacy_sw.elapsed();
+
+    //! Table: one miss per coin after a balance event, then the cached total is served.
+    atomic_dex::fiat_conversion_table table;
+    std::string                       table_total;
+    spdlog::stopwatch                 table_sw;
+    for (std::size_t round = 0; round < nb_rounds; ++round)
+    {
+        if (round % 100 == 0)
+        {
+            table.invalidate_tickers({tickers[round % nb_coins]});
+        }
+        if (auto total = table.find_total("USD"); total)
+        {
+            table_total = total->str(2);
+            continue;
+        }
+        const auto      generation = table.generation();
+        t_fixed_decimal total(0);
+        for (std::size_t idx = 0; idx < nb_coins; ++idx)
+        {
+            auto entry = table.find("USD", tickers[idx]);
+            if (!entry)
+            {
+                const auto value = safe_decimal(prices[idx]) * safe_decimal(balances[idx]);
+                entry            = atomic_dex::fiat_conversion_entry{.value = value, .display = value.str(2)};
+                table.store("USD", tickers[idx], *entry, generation);
+            }
+            total += entry->value;
+        }
+        table.store_total("USD", total, generation);
+        table_total = total.str(2);
+    }
+    const auto table_elapsed = table_sw.elapsed();
+
+    const auto metrics = table.get_metrics();
+    SPDLOG_INFO(
+        "{} coins x {} totals: former {:.4f}s table {:.4f}s (hits {} misses {} totals hits {} totals misses {})", nb_coins, nb_rounds,
+        legacy_elapsed.count(), table_elapsed.count(), metrics.hits, metrics.misses, metrics.total_hits, metrics.total_misses);
+    CHECK_EQ(legacy_total, table_total);
+}
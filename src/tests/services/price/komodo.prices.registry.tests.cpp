@@ -0,0 +1,168 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <cmath>
+#include <shared_mutex>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/api/komodo_prices/komodo.prices.hpp"
+#include "atomicdex/services/price/komodo_prices/komodo.prices.registry.hpp"
+
+namespace
+{
+    //! Shape of one ticker of the /api/v2/tickers answer.
+    constexpr const char* g_recorded_entry = R"({
+        "ticker": "KMD",
+        "last_price": "0.2937431000",
+        "last_updated": "2022-09-20T09:02:08",
+        "last_updated_timestamp": 1663664528,
+        "volume24h": "2194872.5430000000",
+        "price_provider": "binance",
+        "volume_provider": "coingecko",
+        "sparkline_7d": [0.2951, 0.2948, 0.2939, null, 0.2941],
+        "sparkline_provider": "coingecko",
+        "change_24h": "-1.1560000000",
+        "change_24h_provider": "coingecko"
+    })";
+
+    //! Recorded entry replicated for `nb_tickers` tickers with a 168 hours sparkline, the size of a real answer.
+    std::string
+    make_payload(std::size_t nb_tickers)
+    {
+        nlohmann::json entry     = nlohmann::json::parse(g_recorded_entry);
+        nlohmann::json sparkline = nlohmann::json::array();
+        for (std::size_t hour = 0; hour < 168; ++hour) { sparkline.push_back(0.29 + static_cast<double>(hour % 13) / 1000.0); }
+        entry["sparkline_7d"] = sparkline;
+
+        nlohmann::json payload = nlohmann::json::object();
+        for (std::size_t idx = 0; idx < nb_tickers; ++idx)
+        {
+            const auto ticker     = "COIN" + std::to_string(idx);
+            entry["ticker"]       = ticker;
+            entry["last_price"]   = std::to_string(idx + 1) + ".25";
+            payload[ticker]       = entry;
+        }
+        return payload.dump();
+    }
+} // namespace
+
+TEST_CASE("komodo_prices_snapshot parses a recorded answer")
+{
+    const auto body     = nlohmann::json{{"KMD", nlohmann::json::parse(g_recorded_entry)}, {"NOSPARK", {{"last_price", 2.5}, {"sparkline_7d", nullptr}}}}.dump();
+    const auto snapshot = atomic_dex::komodo_prices_snapshot::parse(body);
+    REQUIRE(snapshot.has_value());
+    CHECK_EQ(snapshot->size(), 2);
+
+    const auto* kmd = snapshot->find("KMD");
+    REQUIRE(kmd != nullptr);
+    CHECK_EQ(snapshot->ticker(*kmd), "KMD");
+    CHECK_EQ(kmd->last_price, t_fixed_decimal::from_string("0.2937431").value());
+    CHECK_EQ(kmd->volume_24h, t_fixed_decimal::from_string("2194872.543").value());
+    CHECK_EQ(kmd->change_24h, t_fixed_decimal::from_string("-1.156").value());
+    CHECK_EQ(kmd->last_updated_timestamp, 1663664528);
+    CHECK(kmd->price_provider == atomic_dex::komodo_prices::api::provider::binance);
+
+    const auto sparkline = snapshot->sparkline(*kmd);
+    REQUIRE_EQ(sparkline.size(), 5);
+    CHECK_EQ(sparkline[0], 0.2951);
+    CHECK(std::isnan(sparkline[3]));
+
+    const auto* nospark = snapshot->find("NOSPARK");
+    REQUIRE(nospark != nullptr);
+    CHECK_EQ(nospark->last_price, t_fixed_decimal::from_string("2.5").value());
+    CHECK(snapshot->sparkline(*nospark).empty());
+    CHECK(nospark->price_provider == atomic_dex::komodo_prices::api::provider::unknown);
+
+    CHECK(snapshot->find("BTC") == nullptr);
+}
+
+TEST_CASE("komodo_prices_snapshot rejects invalid answers")
+{
+    std::string error;
+    CHECK_FALSE(atomic_dex::komodo_prices_snapshot::parse("[1, 2]", &error).has_value());
+    CHECK_FALSE(error.empty());
+    CHECK_FALSE(atomic_dex::komodo_prices_snapshot::parse(R"({"KMD": {"last_price": )").has_value());
+    CHECK_FALSE(atomic_dex::komodo_prices_snapshot::parse("42").has_value());
+
+    const auto empty = atomic_dex::komodo_prices_snapshot::parse("{}");
+    REQUIRE(empty.has_value());
+    CHECK_EQ(empty->size(), 0);
+}
+
+TEST_CASE("komodo_prices_snapshot views stay valid after the snapshot is moved")
+{
+    auto parsed = atomic_dex::komodo_prices_snapshot::parse(make_payload(64));
+    REQUIRE(parsed.has_value());
+    const auto  moved = std::move(*parsed);
+    const auto* entry = moved.find("COIN42");
+    REQUIRE(entry != nullptr);
+    CHECK_EQ(moved.ticker(*entry), "COIN42");
+    CHECK_EQ(entry->last_price, t_fixed_decimal::from_string("43.25").value());
+    CHECK_EQ(moved.sparkline(*entry).size(), 168);
+}
+
+TEST_CASE("benchmark komodo prices parse and lookups against the former registry" * doctest::skip(true))
+{
+    constexpr std::size_t nb_tickers = 800;
+    constexpr std::size_t nb_lookups = 200000;
+    const auto            body       = make_payload(nb_tickers);
+
+    spdlog::stopwatch legacy_parse_sw;
+    const auto        legacy = nlohmann::json::parse(body).get<atomic_dex::komodo_prices::api::t_komodo_tickers_price_registry>();
+    const auto        legacy_parse_elapsed = legacy_parse_sw.elapsed();
+
+    spdlog::stopwatch snapshot_parse_sw;
+    const auto        snapshot               = atomic_dex::komodo_prices_snapshot::parse(body);
+    const auto        snapshot_parse_elapsed = snapshot_parse_sw.elapsed();
+    REQUIRE(snapshot.has_value());
+    REQUIRE_EQ(snapshot->size(), legacy.size());
+
+    std::vector<std::string> tickers;
+    for (std::size_t idx = 0; idx < nb_tickers; ++idx) { tickers.push_back("COIN" + std::to_string(idx)); }
+
+    //! Former lookup: the whole entry, sparkline included, copied under a shared lock then converted.
+    std::shared_mutex legacy_mutex;
+    t_fixed_decimal   legacy_sum;
+    spdlog::stopwatch legacy_lookup_sw;
+    for (std::size_t idx = 0; idx < nb_lookups; ++idx)
+    {
+        atomic_dex::komodo_prices::api::komodo_ticker_infos infos;
+        {
+            std::shared_lock lock(legacy_mutex);
+            infos = legacy.at(tickers[idx % nb_tickers]);
+        }
+        legacy_sum += safe_decimal(infos.last_price);
+    }
+    const auto legacy_lookup_elapsed = legacy_lookup_sw.elapsed();
+
+    t_fixed_decimal   snapshot_sum;
+    spdlog::stopwatch snapshot_lookup_sw;
+    for (std::size_t idx = 0; idx < nb_lookups; ++idx) { snapshot_sum += snapshot->find(tickers[idx % nb_tickers])->last_price; }
+    const auto snapshot_lookup_elapsed = snapshot_lookup_sw.elapsed();
+
+    SPDLOG_INFO(
+        "{} tickers: parse former {:.4f}s snapshot {:.4f}s, {} lookups former {:.4f}s snapshot {:.4f}s", nb_tickers, legacy_parse_elapsed.count(),
+        snapshot_parse_elapsed.count(), nb_lookups, legacy_lookup_elapsed.count(), snapshot_lookup_elapsed.count());
+    CHECK_EQ(legacy_sum, snapshot_sum);
+}
@@ -0,0 +1,200 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <fstream>
+
+//! Deps
+#include <doctest/doctest.h>
+
+//! Project Headers
+#include "atomicdex/services/price/coingecko/price.series.cache.hpp"
+
+namespace
+{
+    constexpr std::uint64_t g_day_ms  = atomic_dex::g_daily_resolution_ms;
+    constexpr std::uint64_t g_hour_ms = g_day_ms / 24;
+
+    atomic_dex::price_series
+    make_series(std::uint64_t from_ms, std::uint64_t to_ms, std::uint64_t step_ms, double base)
+    {
+        atomic_dex::price_series out;
+        for (std::uint64_t ts = from_ms; ts <= to_ms; ts += step_ms)
+        {
+            out.timestamps.push_back(ts);
+            out.prices.push_back(base + static_cast<double>(ts / g_hour_ms));
+        }
+        return out;
+    }
+
+    struct cache_fixture
+    {
+        fs::path folder{fs::temp_directory_path() / "atomicdex.tests.charts.cache"};
+
+        cache_fixture()
+        {
+            fs::remove_all(folder);
+            fs::create_directories(folder);
+        }
+
+        ~cache_fixture() { fs::remove_all(folder); }
+    };
+} // namespace
+
+TEST_CASE("price_series_cache keeps the first sample of every day and the live price")
+{
+    //! One week of hourly samples, the last one is the live price of the running day.
+    const auto hourly   = make_series(0, 7 * g_day_ms + 5 * g_hour_ms, g_hour_ms, 1.0);
+    const auto bucketed = atomic_dex::price_series_cache::bucket(hourly, g_day_ms);
+
+    CHECK_EQ(bucketed.timestamps.size(), 9);
+    for (std::size_t day = 0; day < 8; ++day) { CHECK_EQ(bucketed.timestamps[day], day * g_day_ms); }
+    CHECK_EQ(bucketed.timestamps.back(), hourly.timestamps.back());
+    CHECK_EQ(bucketed.prices.back(), hourly.prices.back());
+}
+
+TEST_CASE("price_series_cache round trip and tail merge")
+{
+    cache_fixture                  fixture;
+    atomic_dex::price_series_cache cache(fixture.folder);
+
+    CHECK_FALSE(cache.load("komodo", g_day_ms).has_value());
+
+    //! First session: nothing cached, the whole 30 days window is fetched.
+    const std::uint64_t first_now = 30 * g_day_ms + 10 * g_hour_ms;
+    const std::uint64_t window    = first_now - 30 * g_day_ms;
+    CHECK_FALSE(atomic_dex::price_series_cache::tail_start(atomic_dex::price_series{}, window, g_day_ms).has_value());
+    const auto first = cache.merge("komodo", g_day_ms, make_series(0, first_now, g_hour_ms, 1.0));
+
+    auto loaded = cache.load("komodo", g_day_ms);
+    REQUIRE(loaded.has_value());
+    CHECK_EQ(loaded->timestamps, first.timestamps);
+    CHECK_EQ(loaded->prices, first.prices);
+    const auto size_after_first = fs::file_size(cache.get_path("komodo", g_day_ms));
+
+    //! Second session two days later: only the range from the running day of the last session is requested.
+    const std::uint64_t second_now    = first_now + 2 * g_day_ms;
+    const auto          second_window = second_now - 30 * g_day_ms;
+    const auto          from          = atomic_dex::price_series_cache::tail_start(*loaded, second_window, g_day_ms);
+    REQUIRE(from.has_value());
+    CHECK_EQ(*from, 30 * g_day_ms);
+
+    const auto merged = cache.merge("komodo", g_day_ms, make_series(*from, second_now, g_hour_ms, 1.0));
+    CHECK_EQ(merged.timestamps.size(), 34);
+    CHECK_EQ(merged.timestamps[30], 30 * g_day_ms);
+    CHECK_EQ(merged.timestamps[32], 32 * g_day_ms);
+    CHECK_EQ(merged.timestamps.back(), second_now);
+    CHECK(std::is_sorted(merged.timestamps.begin(), merged.timestamps.end()));
+
+    loaded = cache.load("komodo", g_day_ms);
+    REQUIRE(loaded.has_value());
+    CHECK_EQ(loaded->timestamps, merged.timestamps);
+    CHECK_GT(fs::file_size(cache.get_path("komodo", g_day_ms)), size_after_first);
+
+    const auto window_slice = atomic_dex::price_series_cache::slice(*loaded, second_window);
+    CHECK_EQ(window_slice.timestamps.front(), 3 * g_day_ms);
+    CHECK_EQ(window_slice.timestamps.back(), second_now);
+}
+
+TEST_CASE("price_series_cache ignores torn and foreign files")
+{
+    cache_fixture                  fixture;
+    atomic_dex::price_series_cache cache(fixture.folder);
+
+    const auto series = cache.merge("bitcoin", g_day_ms, make_series(0, 10 * g_day_ms, g_day_ms, 100.0));
+    const auto path   = cache.get_path("bitcoin", g_day_ms);
+
+    //! Interrupted append: half a record after the last complete one.
+    {
+        std::ofstream ofs(path.string(), std::ios::binary | std::ios::app);
+        const char    garbage[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+        ofs.write(garbage, sizeof(garbage));
+    }
+    auto loaded = cache.load("bitcoin", g_day_ms);
+    REQUIRE(loaded.has_value());
+    CHECK_EQ(loaded->timestamps, series.timestamps);
+
+    //! Truncated below the header count: only the complete records are returned.
+    fs::resize_file(path, fs::file_size(path) - 8 - 16 * 3);
+    loaded = cache.load("bitcoin", g_day_ms);
+    REQUIRE(loaded.has_value());
+    CHECK_EQ(loaded->timestamps.size(), series.timestamps.size() - 3);
+
+    //! Another resolution or a file that is not a series.
+    CHECK_FALSE(cache.load("bitcoin", g_hour_ms).has_value());
+    {
+        std::ofstream ofs(cache.get_path("garbage", g_day_ms).string(), std::ios::binary);
+        ofs << "this is not a price series file";
+    }
+    CHECK_FALSE(cache.load("garbage", g_day_ms).has_value());
+
+    //! A rewrite after the torn file keeps the file consistent.
+    const auto merged = cache.merge("bitcoin", g_day_ms, make_series(5 * g_day_ms, 12 * g_day_ms, g_day_ms, 100.0));
+    loaded            = cache.load("bitcoin", g_day_ms);
+    REQUIRE(loaded.has_value());
+    CHECK_EQ(loaded->timestamps, merged.timestamps);
+    CHECK_EQ(merged.timestamps.size(), 13);
+}
+
+TEST_CASE("price_series_cache only requests the missing tail from the provider")
+{
+    cache_fixture                  fixture;
+    atomic_dex::price_series_cache cache(fixture.folder);
+
+    //! Stub of coins/{id}/market_chart/range: hourly samples of the requested range, the requested bounds are recorded.
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> requests;
+    bool                                                 offline = false;
+    const auto stub = [&](std::uint64_t from_ms, std::uint64_t to_ms) -> std::optional<atomic_dex::price_series>
+    {
+        requests.emplace_back(from_ms, to_ms);
+        if (offline)
+        {
+            return std::nullopt;
+        }
+        return make_series((from_ms + g_hour_ms - 1) / g_hour_ms * g_hour_ms, to_ms, g_hour_ms, 1.0);
+    };
+
+    const std::uint64_t first_now = 60 * g_day_ms + 7 * g_hour_ms;
+    auto                first     = cache.fetch_window("komodo", g_day_ms, first_now - 30 * g_day_ms, first_now, stub);
+    REQUIRE(first.has_value());
+    REQUIRE_EQ(requests.size(), 1);
+    CHECK_EQ(requests[0].first, first_now - 30 * g_day_ms);
+    CHECK_EQ(first->timestamps.back(), first_now);
+
+    //! Next session, a few hours later: the request starts at the running day instead of 30 days back.
+    const std::uint64_t second_now = first_now + 5 * g_hour_ms;
+    auto                second     = cache.fetch_window("komodo", g_day_ms, second_now - 30 * g_day_ms, second_now, stub);
+    REQUIRE(second.has_value());
+    REQUIRE_EQ(requests.size(), 2);
+    CHECK_EQ(requests[1].first, 60 * g_day_ms);
+    CHECK_EQ(second->timestamps.back(), second_now);
+    CHECK_EQ(second->timestamps.front(), 31 * g_day_ms);
+
+    //! The startup preview reads the same window without any request.
+    auto preview = cache.load_window("komodo", g_day_ms, second_now - 30 * g_day_ms);
+    REQUIRE(preview.has_value());
+    CHECK_EQ(preview->timestamps, second->timestamps);
+    CHECK_EQ(requests.size(), 2);
+
+    //! Provider down: the cached window is still served.
+    offline     = true;
+    auto cached = cache.fetch_window("komodo", g_day_ms, second_now - 30 * g_day_ms, second_now + g_hour_ms, stub);
+    REQUIRE(cached.has_value());
+    CHECK_EQ(cached->timestamps, second->timestamps);
+    CHECK_FALSE(cache.fetch_window("bitcoin", g_day_ms, 0, second_now, stub).has_value());
+}
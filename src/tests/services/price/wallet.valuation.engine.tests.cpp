@@ -0,0 +1,158 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <cmath>
+#include <map>
+#include <shared_mutex>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/services/price/coingecko/wallet.valuation.engine.hpp"
+#include "atomicdex/utilities/global.utilities.hpp"
+#include "atomicdex/utilities/safe.float.hpp"
+
+namespace
+{
+    constexpr std::uint64_t g_day_ms = 86400000;
+
+    nlohmann::json
+    make_prices(std::size_t nb_days, double base, std::uint64_t first_day = 0)
+    {
+        nlohmann::json out = nlohmann::json::array();
+        for (std::size_t day = 0; day < nb_days; ++day)
+        {
+            out.push_back({(first_day + day) * g_day_ms, base + static_cast<double>(day % 17)});
+        }
+        return out;
+    }
+
+    //! Former generate_fiat_chart loop: json reads, a locked balance parse per coin per point and min/max kept as strings.
+    std::string
+    legacy_fiat_chart(const std::map<std::string, nlohmann::json>& registry, const std::map<std::string, std::string>& balances, std::shared_mutex& mutex)
+    {
+        const auto get_balance = [&](const std::string& ticker)
+        {
+            std::shared_lock lock(mutex);
+            return safe_float(balances.at(ticker));
+        };
+        const t_float_50 rate(1);
+        std::string      min_value = "0";
+        std::string      max_value = "0";
+        const auto&      data      = registry.begin()->second;
+        for (std::size_t idx = 0; idx < data.size(); idx++)
+        {
+            t_float_50 total(0);
+            for (auto&& [key, value]: registry) { total += (t_float_50(value[idx][1].get<float>()) * get_balance(key)) * rate; }
+            if (safe_float(min_value) <= 0 || total < safe_float(min_value))
+            {
+                min_value = atomic_dex::utils::format_float(total);
+            }
+            if (total > safe_float(max_value))
+            {
+                max_value = atomic_dex::utils::format_float(total);
+            }
+        }
+        return max_value;
+    }
+} // namespace
+
+TEST_CASE("price_series parses the coingecko prices array and skips malformed samples")
+{
+    const auto series = atomic_dex::price_series::from_json(nlohmann::json::parse(R"([[1000, 1.5], [2000, 2], ["bad", 3], [3000]])"));
+    CHECK_EQ(series.timestamps, std::vector<std::uint64_t>{1000, 2000});
+    CHECK_EQ(series.prices, std::vector<double>{1.5, 2.0});
+}
+
+TEST_CASE("wallet_valuation_engine aligns every series on the timestamps of the longest one")
+{
+    atomic_dex::t_price_series_registry registry;
+    registry["KMD"] = atomic_dex::price_series::from_json(make_prices(4, 1.0));
+    //! Starts a day later: the first grid point takes its first sample.
+    registry["BTC"]   = atomic_dex::price_series::from_json(make_prices(2, 100.0, 1));
+    registry["EMPTY"] = {};
+
+    atomic_dex::wallet_valuation_engine engine;
+    engine.build(registry);
+    CHECK_EQ(engine.nb_points(), 4);
+    CHECK_EQ(engine.nb_coins(), 2);
+
+    const auto summary = engine.evaluate({{"KMD", 10}, {"BTC", 0.5}, {"DOGE", 1000}}, 2.0);
+    REQUIRE_EQ(summary.totals.size(), 4);
+    CHECK_EQ(summary.timestamps[3], 3 * g_day_ms / 1000);
+    //! day 0: KMD 1, BTC 100 (first sample) / day 3: KMD 4, BTC 101 (carried forward)
+    CHECK_EQ(summary.totals[0], doctest::Approx((10 * 1.0 + 0.5 * 100.0) * 2));
+    CHECK_EQ(summary.totals[3], doctest::Approx((10 * 4.0 + 0.5 * 101.0) * 2));
+    CHECK_EQ(summary.first_total, summary.totals[0]);
+    CHECK_EQ(summary.min_total, summary.totals[0]);
+    CHECK_EQ(summary.max_total, summary.totals[3]);
+}
+
+TEST_CASE("wallet_valuation_engine without data or balances")
+{
+    atomic_dex::wallet_valuation_engine engine;
+    engine.build({});
+    CHECK_EQ(engine.nb_points(), 0);
+    CHECK(engine.evaluate({}, 1.0).totals.empty());
+
+    engine.build({{"KMD", atomic_dex::price_series::from_json(make_prices(3, 1.0))}});
+    const auto summary = engine.evaluate({}, 1.0);
+    CHECK_EQ(summary.totals, std::vector<double>(3, 0.0));
+    CHECK_EQ(summary.min_total, 0);
+    CHECK_EQ(summary.max_total, 0);
+}
+
+TEST_CASE("benchmark wallet_valuation_engine against the former fiat chart loop, 300 coins x 365 days" * doctest::skip(true))
+{
+    constexpr std::size_t nb_coins = 300;
+    constexpr std::size_t nb_days  = 365;
+
+    std::map<std::string, nlohmann::json>           json_registry;
+    std::map<std::string, std::string>              string_balances;
+    atomic_dex::t_price_series_registry             registry;
+    atomic_dex::wallet_valuation_engine::t_balances balances;
+    for (std::size_t idx = 0; idx < nb_coins; ++idx)
+    {
+        const auto ticker       = "COIN" + std::to_string(idx);
+        json_registry[ticker]   = make_prices(nb_days, static_cast<double>(idx + 1));
+        string_balances[ticker] = std::to_string(idx % 7);
+        registry[ticker]        = atomic_dex::price_series::from_json(json_registry[ticker]);
+        balances[ticker]        = static_cast<double>(idx % 7);
+    }
+
+    std::shared_mutex balance_mutex;
+    spdlog::stopwatch legacy_sw;
+    const auto        legacy_max     = legacy_fiat_chart(json_registry, string_balances, balance_mutex);
+    const auto        legacy_elapsed = legacy_sw.elapsed();
+
+    spdlog::stopwatch                   engine_sw;
+    atomic_dex::wallet_valuation_engine engine;
+    engine.build(registry);
+    const auto build_elapsed = engine_sw.elapsed();
+    const auto summary       = engine.evaluate(balances, 1.0);
+    const auto total_elapsed = engine_sw.elapsed();
+
+    SPDLOG_INFO(
+        "{} coins x {} days: former loop {:.3f}s, engine {:.6f}s (build {:.6f}s)", nb_coins, nb_days, legacy_elapsed.count(), total_elapsed.count(),
+        build_elapsed.count());
+    CHECK_EQ(summary.max_total, doctest::Approx(safe_float(legacy_max).convert_to<double>()).epsilon(1e-6));
+}
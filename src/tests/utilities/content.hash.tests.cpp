@@ -0,0 +1,148 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <string>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/utilities/content.hash.hpp"
+
+namespace
+{
+    //! Batch answer shaped like the my_orders / active_swaps one, `nb_swaps` swaps of 10 events each
+    std::string
+    make_swaps_body(std::size_t nb_swaps)
+    {
+        nlohmann::json swaps = nlohmann::json::array();
+        for (std::size_t idx = 0; idx < nb_swaps; ++idx)
+        {
+            nlohmann::json events = nlohmann::json::array();
+            for (std::size_t evt = 0; evt < 10; ++evt)
+            {
+                nlohmann::json event = {{"type", "Event" + std::to_string(evt)}, {"data", {{"tx_hex", std::string(256, 'a')}}}};
+                events.push_back({{"timestamp", 1650000000000 + idx * 1000 + evt}, {"event", std::move(event)}});
+            }
+            swaps.push_back(
+                {{"uuid", "uuid-" + std::to_string(idx)}, {"type", "Maker"}, {"maker_coin", "KMD"}, {"taker_coin", "BTC"}, {"events", std::move(events)}});
+        }
+        nlohmann::json orders = {{"result", {{"maker_orders", nlohmann::json::object()}, {"taker_orders", nlohmann::json::object()}}}};
+        return nlohmann::json::array({std::move(orders), {{"result", {{"swaps", std::move(swaps)}}}}}).dump();
+    }
+} // namespace
+
+TEST_CASE("content_change_detector reports a key as changed only when its hash moved")
+{
+    atomic_dex::content_change_detector detector;
+
+    CHECK(detector.changed("orderbook", "", 1));
+    CHECK_FALSE(detector.changed("orderbook", "", 1));
+    CHECK(detector.changed("orderbook", "", 2));
+    CHECK_FALSE(detector.changed("orderbook", "", 2));
+
+    //! Stages and keys are independent
+    CHECK(detector.changed("swaps", "", 2));
+    CHECK(detector.changed("swaps", "uuid", 2));
+    CHECK_FALSE(detector.changed("swaps", "uuid", 2));
+
+    const auto metrics = detector.get_metrics();
+    REQUIRE_EQ(metrics.size(), 2);
+    CHECK_EQ(metrics.at("orderbook").nb_checks, 4);
+    CHECK_EQ(metrics.at("orderbook").nb_skipped, 2);
+    CHECK_EQ(metrics.at("orderbook").skip_rate(), doctest::Approx(0.5));
+    CHECK_EQ(metrics.at("swaps").nb_checks, 3);
+    CHECK_EQ(metrics.at("swaps").nb_skipped, 1);
+}
+
+TEST_CASE("content_change_detector store, forget and clear")
+{
+    atomic_dex::content_change_detector detector;
+
+    //! A forced payload is remembered without being counted
+    detector.store("orders_and_swaps", "", 42);
+    CHECK_FALSE(detector.changed("orders_and_swaps", "", 42));
+    CHECK_EQ(detector.get_metrics().at("orders_and_swaps").nb_checks, 1);
+
+    //! A failed decode must not hide the next identical answer
+    detector.forget("orders_and_swaps", "");
+    CHECK(detector.changed("orders_and_swaps", "", 42));
+
+    detector.store("orders", "a", 1);
+    detector.store("swaps", "a", 1);
+    detector.clear("orders");
+    CHECK(detector.changed("orders", "a", 1));
+    CHECK_FALSE(detector.changed("swaps", "a", 1));
+
+    detector.clear();
+    CHECK(detector.changed("swaps", "a", 1));
+    CHECK_EQ(detector.get_metrics().at("swaps").nb_checks, 2);
+
+    detector.record("balance", true);
+    detector.record("balance", false);
+    CHECK_EQ(detector.get_metrics().at("balance").skip_rate(), doctest::Approx(0.5));
+    CHECK_EQ(atomic_dex::content_change_stage_metrics{}.skip_rate(), doctest::Approx(0.0));
+}
+
+TEST_CASE("content_hash and hash_combine")
+{
+    const std::string body = make_swaps_body(3);
+    CHECK_EQ(atomic_dex::content_hash(body), atomic_dex::content_hash(std::string(body)));
+    CHECK_NE(atomic_dex::content_hash(body), atomic_dex::content_hash(body.substr(1)));
+
+    //! The same answer decoded with other rates is another content
+    atomic_dex::t_content_hash lhs = atomic_dex::content_hash(body);
+    atomic_dex::t_content_hash rhs = lhs;
+    atomic_dex::hash_combine(lhs, std::uint64_t{1});
+    atomic_dex::hash_combine(rhs, std::uint64_t{2});
+    CHECK_NE(lhs, rhs);
+
+    //! Combining is order sensitive
+    atomic_dex::t_content_hash ab = 0;
+    atomic_dex::t_content_hash ba = 0;
+    atomic_dex::hash_combine(ab, std::string("KMD"));
+    atomic_dex::hash_combine(ab, std::string("BTC"));
+    atomic_dex::hash_combine(ba, std::string("BTC"));
+    atomic_dex::hash_combine(ba, std::string("KMD"));
+    CHECK_NE(ab, ba);
+}
+
+TEST_CASE("benchmark unchanged orders and swaps answer, hash check against a full parse" * doctest::skip(true))
+{
+    const std::string body          = make_swaps_body(500);
+    constexpr int     nb_iterations = 200;
+
+    spdlog::stopwatch parse_stopwatch;
+    std::size_t       nb_swaps = 0;
+    for (int idx = 0; idx < nb_iterations; ++idx) { nb_swaps += nlohmann::json::parse(body)[1]["result"]["swaps"].size(); }
+    const auto parse_elapsed = parse_stopwatch.elapsed();
+    CHECK_EQ(nb_swaps, 500 * nb_iterations);
+
+    atomic_dex::content_change_detector detector;
+    spdlog::stopwatch                   hash_stopwatch;
+    for (int idx = 0; idx < nb_iterations; ++idx) { detector.changed("orders_and_swaps", "", atomic_dex::content_hash(body)); }
+    const auto hash_elapsed = hash_stopwatch.elapsed();
+    CHECK_EQ(detector.get_metrics().at("orders_and_swaps").nb_skipped, nb_iterations - 1);
+
+    SPDLOG_INFO(
+        "unchanged answer of {} bytes: parse {:.3f}s, hash check {:.3f}s over {} iterations", body.size(), parse_elapsed.count(), hash_elapsed.count(),
+        nb_iterations);
+}
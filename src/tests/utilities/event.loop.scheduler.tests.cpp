@@ -0,0 +1,165 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <ctime>
+#include <string>
+#include <thread>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/utilities/event.loop.scheduler.hpp"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    using t_clock = atomic_dex::event_loop_scheduler::t_clock;
+
+    struct idle_loop_result
+    {
+        std::size_t wakeups{0};
+        std::size_t frames{0};
+        double      cpu_ms{0};
+    };
+
+    //! Former application loop: a frame every `tick`, whether there is something to do or not.
+    idle_loop_result
+    run_polling_loop(std::chrono::milliseconds duration, std::chrono::milliseconds tick)
+    {
+        idle_loop_result out;
+        const auto       cpu_start = std::clock();
+        const auto       end       = t_clock::now() + duration;
+        while (t_clock::now() < end)
+        {
+            std::this_thread::sleep_for(tick);
+            out.wakeups += 1;
+            out.frames += 1;
+        }
+        out.cpu_ms = 1000.0 * static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+        return out;
+    }
+
+    idle_loop_result
+    run_scheduled_loop(std::chrono::milliseconds duration, std::chrono::milliseconds frame_period)
+    {
+        idle_loop_result                 out;
+        atomic_dex::event_loop_scheduler scheduler;
+        scheduler.add_timer("systems", frame_period, [&out]() { out.frames += 1; });
+        const auto cpu_start = std::clock();
+        const auto end       = t_clock::now() + duration;
+        while (t_clock::now() < end && scheduler.wait(end)) { scheduler.run_due(); }
+        out.wakeups = scheduler.get_metrics().wakeups;
+        out.cpu_ms  = 1000.0 * static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+        return out;
+    }
+} // namespace
+
+TEST_CASE("event_loop_scheduler fires timers at their deadline without drifting")
+{
+    atomic_dex::event_loop_scheduler scheduler;
+    std::size_t                      nb_fast = 0;
+    std::size_t                      nb_slow = 0;
+    scheduler.add_timer("fast", 100ms, [&nb_fast]() { nb_fast += 1; });
+    scheduler.add_timer("slow", 250ms, [&nb_slow]() { nb_slow += 1; });
+    const auto start = t_clock::now();
+
+    CHECK_EQ(scheduler.run_due(start), 0);
+    REQUIRE(scheduler.next_deadline().has_value());
+    CHECK_LE(*scheduler.next_deadline(), t_clock::now() + 100ms);
+
+    for (auto now = start + 50ms; now <= start + 1s; now += 50ms) { scheduler.run_due(now); }
+    CHECK_EQ(nb_fast, 10);
+    CHECK_EQ(nb_slow, 4);
+
+    //! A loop late by several periods runs the timer once, not once per missed deadline.
+    CHECK_EQ(scheduler.run_due(start + 5s), 2);
+    CHECK_EQ(nb_fast, 11);
+    CHECK_EQ(scheduler.get_metrics().timers_fired, 16);
+}
+
+TEST_CASE("event_loop_scheduler coalesces notifications and wakes the loop once")
+{
+    atomic_dex::event_loop_scheduler scheduler;
+    std::size_t                      nb_wake_calls = 0;
+    std::size_t                      nb_runs       = 0;
+    scheduler.set_wake_handler([&nb_wake_calls]() { nb_wake_calls += 1; });
+    const auto sink = scheduler.add_sink("portfolio", [&nb_runs]() { nb_runs += 1; });
+
+    CHECK_FALSE(scheduler.next_deadline().has_value());
+    for (int idx = 0; idx < 5; ++idx) { scheduler.notify(sink); }
+    CHECK_EQ(nb_wake_calls, 1);
+    CHECK_EQ(scheduler.next_deadline(), t_clock::time_point::min());
+
+    CHECK_EQ(scheduler.run_due(), 1);
+    CHECK_EQ(nb_runs, 1);
+    CHECK_EQ(scheduler.run_due(), 0);
+
+    scheduler.notify(sink);
+    CHECK_EQ(nb_wake_calls, 2);
+    scheduler.remove(sink);
+    CHECK_EQ(scheduler.run_due(), 0);
+    CHECK_EQ(nb_runs, 1);
+
+    const auto metrics = scheduler.get_metrics();
+    CHECK_EQ(metrics.notifications, 6);
+    CHECK_EQ(metrics.sinks_fired, 1);
+    CHECK_EQ(metrics.idle_wakeups, 2);
+}
+
+TEST_CASE("event_loop_scheduler wait returns on a notification from another thread")
+{
+    atomic_dex::event_loop_scheduler      scheduler;
+    atomic_dex::event_queue<std::string> queue;
+    std::vector<std::string>              received;
+    const auto sink = scheduler.add_sink("portfolio", [&]() { for (auto&& cur: queue.drain()) { received.push_back(std::move(cur)); } });
+
+    std::thread producer(
+        [&]()
+        {
+            std::this_thread::sleep_for(20ms);
+            queue.push_range(std::vector<std::string>{"KMD", "BTC"});
+            scheduler.notify(sink);
+        });
+
+    spdlog::stopwatch sw;
+    CHECK(scheduler.wait(t_clock::now() + 10s));
+    CHECK_LT(sw.elapsed(), 5s);
+    producer.join();
+    scheduler.run_due();
+    CHECK_EQ(received, std::vector<std::string>{"KMD", "BTC"});
+    CHECK(queue.empty());
+
+    scheduler.stop();
+    CHECK_FALSE(scheduler.wait(t_clock::now() + 10s));
+}
+
+TEST_CASE("event_loop_scheduler idle cpu and wakeups against a 16ms polling tick" * doctest::skip(true))
+{
+    constexpr auto duration = 5000ms;
+    const auto     polling  = run_polling_loop(duration, 16ms);
+    const auto     schedule = run_scheduled_loop(duration, 250ms);
+
+    SPDLOG_INFO(
+        "idle {}: polling 16ms {} wakeups {} frames {:.2f}ms cpu, scheduler 250ms {} wakeups {} frames {:.2f}ms cpu", duration, polling.wakeups, polling.frames,
+        polling.cpu_ms, schedule.wakeups, schedule.frames, schedule.cpu_ms);
+    CHECK_LT(schedule.wakeups, polling.wakeups);
+}
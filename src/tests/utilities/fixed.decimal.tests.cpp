@@ -0,0 +1,154 @@
+/******************************************************************************
+ * Copyright © 2013-2021 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <random>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/utilities/fixed.decimal.hpp"
+#include "atomicdex/utilities/global.utilities.hpp"
+#include "atomicdex/utilities/safe.float.hpp"
+
+namespace
+{
+    std::vector<std::string>
+    make_amounts(std::size_t count, std::uint64_t seed)
+    {
+        std::mt19937_64          gen(seed);
+        std::vector<std::string> out;
+        out.reserve(count);
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            std::string amount = std::to_string(gen() % 1000000) + ".";
+            const auto  digits = gen() % 19;
+            for (std::size_t digit = 0; digit < digits; ++digit) { amount += static_cast<char>('0' + gen() % 10); }
+            out.push_back(std::move(amount));
+        }
+        return out;
+    }
+} // namespace
+
+TEST_CASE("atomic_dex::fixed_decimal::from_string()")
+{
+    CHECK_EQ(t_fixed_decimal::from_string("1.5")->str(2), "1.50");
+    CHECK_EQ(t_fixed_decimal::from_string("-.5")->str(1), "-0.5");
+    CHECK_EQ(t_fixed_decimal::from_string("1e-8")->str(8), "0.00000001");
+    CHECK_EQ(t_fixed_decimal::from_string("1.5E+3")->str(0), "1500");
+    CHECK_EQ(t_fixed_decimal::from_string("0.1234567890123456789999")->str(18), "0.123456789012345678");
+    CHECK_FALSE(t_fixed_decimal::from_string("").has_value());
+    CHECK_FALSE(t_fixed_decimal::from_string("abc").has_value());
+    CHECK_FALSE(t_fixed_decimal::from_string("1e30").has_value());
+    CHECK_FALSE(t_fixed_decimal::from_string("12,5").has_value());
+    CHECK_FALSE(t_fixed_decimal::from_string("1,000").has_value());
+    CHECK_FALSE(t_fixed_decimal::from_string("1,000.5").has_value());
+    CHECK_EQ(safe_decimal("not a number"), t_fixed_decimal(0));
+}
+
+TEST_CASE("atomic_dex::fixed_decimal::from_fraction()")
+{
+    CHECK_EQ(t_fixed_decimal::from_fraction("1", "3")->str(18), "0.333333333333333333");
+    CHECK_EQ(t_fixed_decimal::from_fraction("15", "10")->str(1), "1.5");
+    CHECK_FALSE(t_fixed_decimal::from_fraction("1", "0").has_value());
+}
+
+TEST_CASE("atomic_dex::fixed_decimal arithmetic")
+{
+    const auto price  = safe_decimal("0.00012345");
+    const auto volume = safe_decimal("1234.5678");
+    CHECK_EQ((price * volume).str(8), "0.15240739");
+    CHECK_EQ((volume / price).str(8), "10000549.21020656");
+    CHECK_EQ((volume - volume).str(2), "0.00");
+    CHECK(price < volume);
+    CHECK(price > 0);
+    CHECK_THROWS_AS(volume / t_fixed_decimal(0), std::domain_error);
+}
+
+TEST_CASE("atomic_dex::fixed_decimal formats like t_float_50")
+{
+    const auto lhs = make_amounts(2000, 7);
+    const auto rhs = make_amounts(2000, 11);
+    for (std::size_t idx = 0; idx < lhs.size(); ++idx)
+    {
+        const t_fixed_decimal fixed_lhs = safe_decimal(lhs[idx]);
+        const t_fixed_decimal fixed_rhs = safe_decimal(rhs[idx]);
+        const t_float_50      float_lhs = safe_float(lhs[idx]);
+        const t_float_50      float_rhs = safe_float(rhs[idx]);
+
+        CHECK_EQ(fixed_lhs.str(8), float_lhs.str(8, std::ios_base::fixed));
+        const t_float_50 sum     = float_lhs + float_rhs;
+        const t_float_50 product = float_lhs * float_rhs;
+        CHECK_EQ((fixed_lhs + fixed_rhs).str(8), sum.str(8, std::ios_base::fixed));
+        CHECK_EQ((fixed_lhs * fixed_rhs).str(8), product.str(8, std::ios_base::fixed));
+        CHECK_EQ(atomic_dex::utils::format_float(fixed_lhs), atomic_dex::utils::format_float(float_lhs));
+    }
+}
+
+TEST_CASE("atomic_dex::checked_product()")
+{
+    CHECK_EQ(atomic_dex::checked_product("0.5", "12.25").value().str(4), "6.1250");
+    CHECK_FALSE(atomic_dex::checked_product("1e15", "1e10").has_value());
+    CHECK_FALSE(atomic_dex::checked_product("1e25", "0.000001").has_value());
+    CHECK_FALSE(atomic_dex::checked_product(t_fixed_decimal(2), "abc").has_value());
+}
+
+TEST_CASE("atomic_dex::decimal_sum moves to t_float_50 out of range")
+{
+    atomic_dex::decimal_sum sum;
+    sum.add(safe_decimal("2e20"));
+    sum.add(safe_decimal("0.5"));
+    CHECK_FALSE(sum.is_wide());
+    CHECK_EQ(sum.str(2), "200000000000000000000.50");
+
+    sum.add(safe_decimal("2e20"));
+    CHECK(sum.is_wide());
+    CHECK_EQ(sum.str(2), "400000000000000000000.50");
+
+    sum.add(safe_float("1e30"));
+    CHECK_EQ(sum.wide(), safe_float("1000000000400000000000000000000.5"));
+}
+
+TEST_CASE("atomic_dex::fixed_decimal benchmark against cpp_dec_float_50" * doctest::skip(true))
+{
+    const auto  prices  = make_amounts(200000, 3);
+    const auto  volumes = make_amounts(200000, 5);
+    std::size_t sink    = 0;
+
+    spdlog::stopwatch float_stopwatch;
+    for (std::size_t idx = 0; idx < prices.size(); ++idx)
+    {
+        const t_float_50 total = safe_float(prices[idx]) * safe_float(volumes[idx]);
+        sink += atomic_dex::utils::format_float(total).size();
+    }
+    const auto float_elapsed = float_stopwatch.elapsed();
+
+    spdlog::stopwatch fixed_stopwatch;
+    for (std::size_t idx = 0; idx < prices.size(); ++idx)
+    {
+        const t_fixed_decimal total = safe_decimal(prices[idx]) * safe_decimal(volumes[idx]);
+        sink += atomic_dex::utils::format_float(total).size();
+    }
+    const auto fixed_elapsed = fixed_stopwatch.elapsed();
+
+    SPDLOG_INFO(
+        "parse + multiply + format of {} orders: cpp_dec_float_50 {:.3f}s, fixed_decimal {:.3f}s ({} chars)", prices.size(), float_elapsed.count(),
+        fixed_elapsed.count(), sink);
+}
@@ -0,0 +1,134 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <atomic>
+
+//! Deps
+#include <cpprest/http_listener.h>
+#include <doctest/doctest.h>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/utilities/http.retry.hpp"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    constexpr const char* g_stub_endpoint = "http://127.0.0.1:17784";
+    constexpr const char* g_stub_host     = "127.0.0.1";
+
+    //! Rate limited provider stand-in: only one request out of `accept_every` is answered with 200, the others get a 429.
+    struct stub_rate_limited_server
+    {
+        web::http::experimental::listener::http_listener listener{FROM_STD_STR(g_stub_endpoint)};
+        std::atomic_size_t                               nb_hits{0};
+        std::size_t                                      accept_every;
+
+        explicit stub_rate_limited_server(std::size_t accept_every_) : accept_every(accept_every_)
+        {
+            listener.support(
+                web::http::methods::GET,
+                [this](web::http::http_request req)
+                {
+                    const auto hit = nb_hits.fetch_add(1) + 1;
+                    if (accept_every == 0 || hit % accept_every != 0)
+                    {
+                        web::http::http_response resp(static_cast<web::http::status_code>(429));
+                        resp.headers().add(FROM_STD_STR("Retry-After"), FROM_STD_STR("0"));
+                        req.reply(resp);
+                        return;
+                    }
+                    req.reply(web::http::status_codes::OK, FROM_STD_STR(R"({"price":"1"})"));
+                });
+            listener.open().wait();
+        }
+
+        ~stub_rate_limited_server() { listener.close().wait(); }
+    };
+
+    atomic_dex::t_http_request_functor
+    make_stub_functor(const std::shared_ptr<t_http_client>& client)
+    {
+        return [client]() { return client->request(web::http::methods::GET, FROM_STD_STR("/price")); };
+    }
+
+    constexpr atomic_dex::retry_policy g_stress_policy{.max_attempts = 20, .base_delay = 5ms, .max_delay = 50ms, .jitter = 0.5};
+} // namespace
+
+TEST_CASE("retry_http recovers every request from a provider answering mostly 429")
+{
+    stub_rate_limited_server    server(3);
+    atomic_dex::retry_scheduler scheduler(atomic_dex::retry_scheduler_cfg{.tick = 5ms, .budget = {.ratio = 10, .min_retries = 100}});
+    scheduler.set_host_limits(g_stub_host, {.capacity = 50, .refill_per_second = 1000});
+    auto client = std::make_shared<t_http_client>(FROM_STD_STR(g_stub_endpoint));
+
+    constexpr std::size_t                             nb_requests = 200;
+    std::vector<pplx::task<web::http::http_response>> tasks;
+    tasks.reserve(nb_requests);
+    for (std::size_t idx = 0; idx < nb_requests; ++idx) { tasks.push_back(atomic_dex::retry_http(scheduler, g_stub_host, make_stub_functor(client), g_stress_policy)); }
+
+    //! No pool thread is parked in a sleep while the retries are pending: unrelated continuations keep their latency.
+    spdlog::stopwatch probe_sw;
+    for (int idx = 0; idx < 20; ++idx) { pplx::create_task([]() { return 0; }).get(); }
+    CHECK_LT(probe_sw.elapsed(), 1s);
+
+    std::size_t nb_ok = 0;
+    for (auto&& task: tasks) { nb_ok += task.get().status_code() == web::http::status_codes::OK ? 1 : 0; }
+
+    const auto metrics = scheduler.get_metrics();
+    CHECK_EQ(nb_ok, nb_requests);
+    CHECK_EQ(metrics.succeeded, nb_requests);
+    CHECK_EQ(metrics.gave_up, 0);
+    CHECK_EQ(metrics.attempts, server.nb_hits.load());
+    CHECK_GE(metrics.retries, nb_requests);
+}
+
+TEST_CASE("retry_http returns the last 429 once the retry budget is spent")
+{
+    stub_rate_limited_server    server(0);
+    atomic_dex::retry_scheduler scheduler(atomic_dex::retry_scheduler_cfg{.tick = 5ms, .budget = {.ratio = 0.5, .min_retries = 10}});
+    scheduler.set_host_limits(g_stub_host, {.capacity = 50, .refill_per_second = 1000});
+    auto                        client = std::make_shared<t_http_client>(FROM_STD_STR(g_stub_endpoint));
+
+    constexpr std::size_t                             nb_requests = 40;
+    std::vector<pplx::task<web::http::http_response>> tasks;
+    for (std::size_t idx = 0; idx < nb_requests; ++idx) { tasks.push_back(atomic_dex::retry_http(scheduler, g_stub_host, make_stub_functor(client), g_stress_policy)); }
+    for (auto&& task: tasks) { CHECK_EQ(task.get().status_code(), 429); }
+
+    //! At most ratio * requests retries in the window, instead of 19 retries per request.
+    const auto metrics = scheduler.get_metrics();
+    CHECK_EQ(metrics.gave_up, nb_requests);
+    CHECK_LE(metrics.retries, nb_requests / 2);
+    CHECK_LE(server.nb_hits.load(), nb_requests + nb_requests / 2);
+}
+
+TEST_CASE("retry_http fails the requests still waiting for a retry when the scheduler stops")
+{
+    stub_rate_limited_server    server(0);
+    atomic_dex::retry_scheduler scheduler(atomic_dex::retry_scheduler_cfg{.tick = 5ms});
+    auto                        client = std::make_shared<t_http_client>(FROM_STD_STR(g_stub_endpoint));
+
+    auto task =
+        atomic_dex::retry_http(scheduler, g_stub_host, make_stub_functor(client), atomic_dex::retry_policy{.base_delay = 10s, .max_delay = 10s, .jitter = 0});
+    while (scheduler.get_metrics().timers == 0) { std::this_thread::sleep_for(1ms); }
+    scheduler.stop();
+    CHECK_THROWS_AS(task.get(), atomic_dex::retry_scheduler_stopped);
+    CHECK_EQ(scheduler.get_metrics().dropped, 1);
+}
@@ -0,0 +1,165 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <algorithm>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/utilities/keyed.row.index.hpp"
+
+namespace
+{
+    std::vector<std::string>
+    make_keys(std::size_t nb_rows)
+    {
+        std::vector<std::string> out;
+        out.reserve(nb_rows);
+        for (std::size_t idx = 0; idx < nb_rows; ++idx) { out.push_back("tx-hash-" + std::to_string(idx)); }
+        return out;
+    }
+
+    void
+    check_consistency(const atomic_dex::keyed_row_index& index, const std::vector<std::string>& rows)
+    {
+        REQUIRE_EQ(index.size(), rows.size());
+        for (std::size_t row = 0; row < rows.size(); ++row)
+        {
+            const auto first_row = static_cast<std::size_t>(std::find(rows.begin(), rows.end(), rows[row]) - rows.begin());
+            CHECK_EQ(index.key_at(row), rows[row]);
+            CHECK_EQ(index.find(rows[row]), first_row);
+        }
+    }
+} // namespace
+
+TEST_CASE("to_row_ranges groups contiguous rows")
+{
+    CHECK(atomic_dex::to_row_ranges({}).empty());
+    const auto ranges = atomic_dex::to_row_ranges({7, 1, 2, 3, 9, 8, 5, 3});
+    REQUIRE_EQ(ranges.size(), 3);
+    CHECK_EQ(ranges[0], atomic_dex::t_row_range{1, 3});
+    CHECK_EQ(ranges[1], atomic_dex::t_row_range{5, 5});
+    CHECK_EQ(ranges[2], atomic_dex::t_row_range{7, 9});
+}
+
+TEST_CASE("keyed_row_index stays consistent across reset, insert and remove")
+{
+    std::vector<std::string>    rows = {"KMD", "BTC", "ETH", "LTC"};
+    atomic_dex::keyed_row_index index;
+    index.reset(rows, [](const std::string& key) { return key; });
+    check_consistency(index, rows);
+    CHECK_FALSE(index.find("DOGE").has_value());
+
+    SUBCASE("append")
+    {
+        rows.push_back("DOGE");
+        index.append("DOGE");
+        check_consistency(index, rows);
+    }
+    SUBCASE("insert in the middle shifts the next rows")
+    {
+        rows.insert(rows.begin() + 1, {"DOGE", "RICK"});
+        index.insert(1, {"DOGE", "RICK"});
+        check_consistency(index, rows);
+    }
+    SUBCASE("remove a range shifts the next rows")
+    {
+        rows.erase(rows.begin() + 1, rows.begin() + 3);
+        index.remove(1, 2);
+        check_consistency(index, rows);
+        CHECK_FALSE(index.contains("BTC"));
+        CHECK_FALSE(index.contains("ETH"));
+    }
+    SUBCASE("clear")
+    {
+        index.clear();
+        CHECK_EQ(index.size(), 0);
+        CHECK_FALSE(index.contains("KMD"));
+    }
+}
+
+TEST_CASE("keyed_row_index returns the first row of a duplicated key")
+{
+    std::vector<std::string>    rows = {"uuid-1", "uuid-2", "uuid-1", "uuid-3", "uuid-2"};
+    atomic_dex::keyed_row_index index;
+    index.reset(rows, [](const std::string& key) { return key; });
+    check_consistency(index, rows);
+
+    rows.insert(rows.begin() + 1, "uuid-3");
+    index.insert(1, {"uuid-3"});
+    check_consistency(index, rows);
+
+    rows.erase(rows.begin(), rows.begin() + 2);
+    index.remove(0, 2);
+    check_consistency(index, rows);
+}
+
+TEST_CASE("row_changes merges rows and roles into contiguous ranges")
+{
+    atomic_dex::row_changes changes;
+    CHECK_FALSE(changes.is_recording());
+    changes.start();
+    CHECK(changes.is_recording());
+    changes.add(5, 2);
+    changes.add(3, 1);
+    changes.add(4, 1);
+    changes.add(9, 3);
+    changes.add(5, 2);
+
+    std::vector<std::pair<atomic_dex::t_row_range, std::vector<int>>> flushed;
+    changes.flush([&flushed](std::size_t first, std::size_t last, const std::vector<int>& roles) { flushed.push_back({{first, last}, roles}); });
+    CHECK_FALSE(changes.is_recording());
+    REQUIRE_EQ(flushed.size(), 2);
+    CHECK_EQ(flushed[0].first, atomic_dex::t_row_range{3, 5});
+    CHECK_EQ(flushed[0].second, std::vector<int>{1, 2});
+    CHECK_EQ(flushed[1].first, atomic_dex::t_row_range{9, 9});
+    CHECK_EQ(flushed[1].second, std::vector<int>{3});
+
+    flushed.clear();
+    changes.flush([&flushed](std::size_t first, std::size_t last, const std::vector<int>& roles) { flushed.push_back({{first, last}, roles}); });
+    CHECK(flushed.empty());
+}
+
+TEST_CASE("keyed_row_index refresh benchmark" * doctest::skip(true))
+{
+    //! A model refresh looks up every key once, a match() scan makes it quadratic in the number of rows
+    for (std::size_t nb_rows: {100, 1000, 5000, 20000})
+    {
+        const auto keys = make_keys(nb_rows);
+
+        spdlog::stopwatch sw_scan;
+        std::size_t       found_scan = 0;
+        for (auto&& key: keys) { found_scan += static_cast<std::size_t>(std::find(keys.begin(), keys.end(), key) - keys.begin()); }
+        const auto scan_elapsed = sw_scan.elapsed();
+
+        spdlog::stopwatch           sw_index;
+        atomic_dex::keyed_row_index index;
+        index.reset(keys, [](const std::string& key) { return key; });
+        std::size_t found_index = 0;
+        for (auto&& key: keys) { found_index += index.find(key).value(); }
+        const auto index_elapsed = sw_index.elapsed();
+
+        CHECK_EQ(found_scan, found_index);
+        SPDLOG_INFO(
+            "refresh of {} rows: linear scan {:.6f}s, keyed index (build included) {:.6f}s", nb_rows, scan_elapsed.count(), index_elapsed.count());
+    }
+}
@@ -16,11 +16,97 @@
 
 #include "atomicdex/pch.hpp"
 
+//! Qt
+#include <QJsonDocument>
+
 //! Deps
 #include <doctest/doctest.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/stopwatch.h>
 
 #include "atomicdex/utilities/qt.utilities.hpp"
 
+namespace
+{
+    //! Former conversions, the tree is written to text and parsed back
+    QJsonValue
+    text_nlohmann_to_qt(const nlohmann::json& j)
+    {
+        const QJsonDocument doc = QJsonDocument::fromJson(QString::fromStdString(j.dump()).toUtf8());
+        return doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object());
+    }
+
+    nlohmann::json
+    text_qt_to_nlohmann(const QJsonObject& obj)
+    {
+        return nlohmann::json::parse(QString(QJsonDocument(obj).toJson()).toStdString());
+    }
+
+    nlohmann::json
+    make_withdraw_answer()
+    {
+        return {
+            {"tx_hex", std::string(1200, 'f')},
+            {"tx_hash", std::string(64, 'a')},
+            {"from", {"RDbAXLCmQ2EN7daEon6ftWmfhJtMcAtJ9H"}},
+            {"to", {"RVNbfcVHHLePyyrBoBZDd3ad2vKzGq8b1k"}},
+            {"total_amount", "60.10253836"},
+            {"spent_by_me", "60.10253836"},
+            {"received_by_me", "50.10243836"},
+            {"my_balance_change", "-10.00010000"},
+            {"block_height", 0},
+            {"timestamp", 1650000000},
+            {"fee_details", {{"type", "Utxo"}, {"coin", "KMD"}, {"amount", "0.0001"}}},
+            {"coin", "KMD"},
+            {"internal_id", ""},
+            {"kmd_rewards", {{"amount", "0.00012"}, {"claimed_by_me", true}}}};
+    }
+
+    nlohmann::json
+    make_preimage_answer()
+    {
+        auto fee = [](const std::string& coin, const std::string& amount)
+        {
+            return nlohmann::json{
+                {"coin", coin},
+                {"amount", amount},
+                {"amount_fraction", {{"numer", "1"}, {"denom", "100000"}}},
+                {"amount_rat", {{1, {1}}, {1, {100000}}}},
+                {"paid_from_trading_vol", false}};
+        };
+        nlohmann::json total_fees = nlohmann::json::array();
+        for (auto&& coin: {"KMD", "BTC"})
+        {
+            auto cur                = fee(coin, "0.00001");
+            cur["required_balance"] = "0.00001";
+            total_fees.push_back(std::move(cur));
+        }
+        return {
+            {"base_coin_fee", fee("KMD", "0.00001")},
+            {"rel_coin_fee", fee("BTC", "0.0000274")},
+            {"taker_fee", fee("KMD", "0.0012987")},
+            {"fee_to_send_taker_fee", fee("KMD", "0.00001")},
+            {"total_fees", std::move(total_fees)}};
+    }
+
+    nlohmann::json
+    make_swap_events()
+    {
+        nlohmann::json events = nlohmann::json::array();
+        for (std::int64_t idx = 0; idx < 14; ++idx)
+        {
+            events.push_back(
+                {{"state", "Event" + std::to_string(idx)},
+                 {"human_timestamp", "2022-04-15 10:00:00"},
+                 {"timestamp", 1650016800000 + idx * 1000},
+                 {"started_at", 1650016800000 + (idx - 1) * 1000},
+                 {"time_diff", 1000.0},
+                 {"data", {{"tx_hex", std::string(500, 'e')}, {"tx_hash", std::string(64, 'b')}}}});
+        }
+        return events;
+    }
+} // namespace
+
 TEST_CASE("qt_variant_list_to_qt_string_list")
 {
     QVariantList variant_list;
@@ -35,4 +121,81 @@ TEST_CASE("qt_variant_list_to_qt_string_list")
     CHECK(result[0] == "one");
     CHECK(result[1] == "two");
     CHECK(result[2] == "three");
-}
\ No newline at end of file
+}
+
+TEST_CASE("nlohmann_json_to_qt_json_value gives the same tree as the text conversion")
+{
+    for (auto&& payload: {make_withdraw_answer(), make_preimage_answer(), make_swap_events()})
+    {
+        CHECK_EQ(atomic_dex::nlohmann_json_to_qt_json_value(payload), text_nlohmann_to_qt(payload));
+    }
+
+    const nlohmann::json scalars = {
+        {"null", nullptr}, {"bool", true}, {"int", -42}, {"uint", 42u}, {"float", 0.5}, {"utf8", "\u00e9\u00e8"}, {"empty", nlohmann::json::object()}};
+    const QJsonObject obj = atomic_dex::nlohmann_json_object_to_qt_json_object(scalars);
+    CHECK(obj["null"].isNull());
+    CHECK_EQ(obj["bool"].toBool(), true);
+    CHECK_EQ(obj["int"].toInt(), -42);
+    CHECK_EQ(obj["uint"].toInt(), 42);
+    CHECK_EQ(obj["float"].toDouble(), doctest::Approx(0.5));
+    CHECK_EQ(obj["utf8"].toString(), QString::fromUtf8("\u00e9\u00e8"));
+    CHECK(obj["empty"].toObject().isEmpty());
+
+    //! Kind mismatch gives an empty container like the former conversion
+    CHECK(atomic_dex::nlohmann_json_object_to_qt_json_object(nlohmann::json::array({1, 2})).isEmpty());
+    CHECK(atomic_dex::nlohmann_json_array_to_qt_json_array(scalars).isEmpty());
+    CHECK_EQ(atomic_dex::nlohmann_json_array_to_qt_json_array(nlohmann::json::array({1, "two"})).size(), 2);
+}
+
+TEST_CASE("qt_json_value_to_nlohmann_json gives the same tree as the text conversion")
+{
+    for (auto&& payload: {make_withdraw_answer(), make_preimage_answer()})
+    {
+        const QJsonObject obj = atomic_dex::nlohmann_json_object_to_qt_json_object(payload);
+        CHECK_EQ(atomic_dex::qt_json_value_to_nlohmann_json(obj), text_qt_to_nlohmann(obj));
+        CHECK_EQ(atomic_dex::qt_json_value_to_nlohmann_json(obj), payload);
+    }
+
+    //! Qt keeps numbers as double, integral ones come back as integers so get<int> keeps working
+    QJsonObject fees;
+    fees["gas_limit"] = 55000.0;
+    fees["offset"]    = -3.0;
+    fees["ratio"]     = 0.25;
+    const auto out    = atomic_dex::qt_json_value_to_nlohmann_json(fees);
+    CHECK(out.at("gas_limit").is_number_unsigned());
+    CHECK_EQ(out.at("gas_limit").get<int>(), 55000);
+    CHECK(out.at("offset").is_number_integer());
+    CHECK_EQ(out.at("offset").get<int>(), -3);
+    CHECK(out.at("ratio").is_number_float());
+    CHECK_EQ(out, text_qt_to_nlohmann(fees));
+}
+
+TEST_CASE("benchmark direct json conversions against the text round trip" * doctest::skip(true))
+{
+    constexpr int nb_iterations = 20000;
+
+    const std::vector<std::pair<std::string, nlohmann::json>> payloads = {
+        {"withdraw", make_withdraw_answer()}, {"preimage", make_preimage_answer()}, {"swap events", make_swap_events()}};
+    for (auto&& [name, payload]: payloads)
+    {
+        spdlog::stopwatch text_stopwatch;
+        for (int idx = 0; idx < nb_iterations; ++idx) { CHECK_FALSE(text_nlohmann_to_qt(payload).isNull()); }
+        const auto text_elapsed = text_stopwatch.elapsed();
+
+        spdlog::stopwatch direct_stopwatch;
+        for (int idx = 0; idx < nb_iterations; ++idx) { CHECK_FALSE(atomic_dex::nlohmann_json_to_qt_json_value(payload).isNull()); }
+        const auto direct_elapsed = direct_stopwatch.elapsed();
+
+        SPDLOG_INFO(
+            "nlohmann -> qt {}: text {:.3f}s, direct {:.3f}s over {} iterations", name, text_elapsed.count(), direct_elapsed.count(), nb_iterations);
+    }
+
+    const QJsonObject withdraw = atomic_dex::nlohmann_json_object_to_qt_json_object(make_withdraw_answer());
+    spdlog::stopwatch text_stopwatch;
+    for (int idx = 0; idx < nb_iterations; ++idx) { CHECK(text_qt_to_nlohmann(withdraw).is_object()); }
+    const auto        text_elapsed = text_stopwatch.elapsed();
+    spdlog::stopwatch direct_stopwatch;
+    for (int idx = 0; idx < nb_iterations; ++idx) { CHECK(atomic_dex::qt_json_value_to_nlohmann_json(withdraw).is_object()); }
+    const auto direct_elapsed = direct_stopwatch.elapsed();
+    SPDLOG_INFO("qt -> nlohmann withdraw: text {:.3f}s, direct {:.3f}s over {} iterations", text_elapsed.count(), direct_elapsed.count(), nb_iterations);
+}
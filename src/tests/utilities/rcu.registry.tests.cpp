@@ -0,0 +1,180 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <algorithm>
+#include <atomic>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/utilities/rcu.registry.hpp"
+
+namespace
+{
+    using t_balances = std::unordered_map<std::string, std::string>;
+
+    t_balances
+    make_balances(std::size_t nb_coins, std::size_t generation)
+    {
+        t_balances out;
+        for (std::size_t idx = 0; idx < nb_coins; ++idx) { out.emplace("COIN" + std::to_string(idx), std::to_string(generation)); }
+        return out;
+    }
+
+    //! Every coin of a consistent snapshot carries the same generation.
+    bool
+    is_consistent(const t_balances& balances)
+    {
+        const auto& first = balances.begin()->second;
+        return std::all_of(balances.begin(), balances.end(), [&first](const auto& cur) { return cur.second == first; });
+    }
+
+    constexpr std::size_t g_rcu_min_reads_per_reader{64};
+
+    //! Runs `nb_readers` threads calling `read` while one thread calls `write` `nb_writes` times, returns the number of reads.
+    //! The writer starts once every reader is running and each reader does at least g_rcu_min_reads_per_reader reads.
+    template <typename TRead, typename TWrite>
+    std::size_t
+    contend(std::size_t nb_readers, std::size_t nb_writes, TRead&& read, TWrite&& write)
+    {
+        std::atomic_bool         done{false};
+        std::atomic_size_t       nb_started{0};
+        std::atomic_size_t       nb_reads{0};
+        std::vector<std::thread> readers;
+        for (std::size_t idx = 0; idx < nb_readers; ++idx)
+        {
+            readers.emplace_back(
+                [&]()
+                {
+                    nb_started += 1;
+                    std::size_t local = 0;
+                    while (local < g_rcu_min_reads_per_reader || !done.load(std::memory_order_relaxed))
+                    {
+                        read();
+                        local += 1;
+                    }
+                    nb_reads += local;
+                });
+        }
+        while (nb_started.load() < nb_readers) { std::this_thread::yield(); }
+        for (std::size_t generation = 1; generation <= nb_writes; ++generation) { write(generation); }
+        done = true;
+        for (auto&& cur: readers) { cur.join(); }
+        return nb_reads.load();
+    }
+} // namespace
+
+TEST_CASE("rcu_registry snapshots are immutable once taken")
+{
+    atomic_dex::rcu_registry<t_balances> registry(make_balances(3, 0));
+    const auto                           before = registry.snapshot();
+    CHECK_EQ(registry.version(), 0);
+
+    registry.update([](t_balances& balances) { balances["COIN0"] = "42"; });
+    const auto erased = registry.update([](t_balances& balances) { return balances.erase("COIN2"); });
+
+    CHECK_EQ(erased, 1);
+    CHECK_EQ(registry.version(), 2);
+    CHECK_EQ(before->size(), 3);
+    CHECK_EQ(before->at("COIN0"), "0");
+
+    const auto after = registry.snapshot();
+    CHECK_EQ(after->size(), 2);
+    CHECK_EQ(after->at("COIN0"), "42");
+    CHECK_FALSE(after->contains("COIN2"));
+
+    registry.publish(make_balances(1, 7));
+    CHECK_EQ(registry.version(), 3);
+    CHECK_EQ(registry.snapshot()->at("COIN0"), "7");
+    CHECK_EQ(after->at("COIN0"), "42");
+}
+
+TEST_CASE("rcu_registry readers never observe a partial update")
+{
+    atomic_dex::rcu_registry<t_balances> registry(make_balances(64, 0));
+    std::atomic_size_t                   nb_inconsistent{0};
+
+    const auto nb_reads = contend(
+        4, 500,
+        [&]()
+        {
+            if (!is_consistent(*registry.snapshot()))
+            {
+                nb_inconsistent += 1;
+            }
+        },
+        [&](std::size_t generation)
+        {
+            registry.update(
+                [generation](t_balances& balances)
+                {
+                    for (auto&& [_, balance]: balances) { balance = std::to_string(generation); }
+                });
+        });
+
+    CHECK_GE(nb_reads, 4 * g_rcu_min_reads_per_reader);
+    CHECK_EQ(nb_inconsistent.load(), 0);
+    CHECK_EQ(registry.snapshot()->at("COIN0"), "500");
+}
+
+TEST_CASE("rcu_registry contention benchmark against a shared_mutex" * doctest::skip(true))
+{
+    constexpr std::size_t nb_coins   = 200;
+    constexpr std::size_t nb_writes  = 2000;
+    const auto            nb_readers = std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1;
+
+    t_balances        locked_balances = make_balances(nb_coins, 0);
+    std::shared_mutex balances_mutex;
+    spdlog::stopwatch locked_sw;
+    const auto        locked_reads = contend(
+        nb_readers, nb_writes,
+        [&]()
+        {
+            std::shared_lock lock(balances_mutex);
+            [[maybe_unused]] volatile auto size = locked_balances.at("COIN42").size();
+        },
+        [&](std::size_t generation)
+        {
+            std::unique_lock lock(balances_mutex);
+            for (auto&& [_, balance]: locked_balances) { balance = std::to_string(generation); }
+        });
+    const auto locked_elapsed = locked_sw.elapsed();
+
+    atomic_dex::rcu_registry<t_balances> registry(make_balances(nb_coins, 0));
+    spdlog::stopwatch                    rcu_sw;
+    const auto                           rcu_reads = contend(
+        nb_readers, nb_writes, [&]() { [[maybe_unused]] volatile auto size = registry.snapshot()->at("COIN42").size(); },
+        [&](std::size_t generation)
+        {
+            registry.update(
+                [generation](t_balances& balances)
+                {
+                    for (auto&& [_, balance]: balances) { balance = std::to_string(generation); }
+                });
+        });
+
+    SPDLOG_INFO(
+        "{} readers against 1 writer ({} writes of {} coins): shared_mutex {} reads in {}, rcu {} reads in {}", nb_readers, nb_writes, nb_coins, locked_reads,
+        locked_elapsed, rcu_reads, rcu_sw);
+}
@@ -0,0 +1,186 @@
+/******************************************************************************
+ * Copyright © 2013-2022 The Komodo Platform Developers.                      *
+ *                                                                            *
+ * See the AUTHORS, DEVELOPER-AGREEMENT and LICENSE files at                  *
+ * the top-level directory of this distribution for the individual copyright  *
+ * holder information and the developer policies on copyright and licensing.  *
+ *                                                                            *
+ * Unless otherwise agreed in a custom licensing agreement, no part of the    *
+ * Komodo Platform software, including this file may be copied, modified,     *
+ * propagated or distributed except according to the terms contained in the   *
+ * LICENSE file                                                               *
+ *                                                                            *
+ * Removal or modification of this copyright notice is prohibited.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "atomicdex/pch.hpp"
+
+//! STD
+#include <atomic>
+#include <future>
+
+//! Deps
+#include <doctest/doctest.h>
+#include <spdlog/stopwatch.h>
+
+//! Project Headers
+#include "atomicdex/utilities/retry.scheduler.hpp"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    //! Attempt functor failing `nb_failures` times before succeeding, `done` is fulfilled with the number of attempts or 0 on give up.
+    struct flaky_attempt
+    {
+        std::size_t                        nb_failures;
+        std::shared_ptr<std::promise<int>> done{std::make_shared<std::promise<int>>()};
+
+        atomic_dex::retry_scheduler::t_attempt
+        attempt() const
+        {
+            return [nb_failures = nb_failures, done = done](std::size_t attempt, const atomic_dex::retry_scheduler::t_report& report)
+            {
+                if (attempt < nb_failures)
+                {
+                    report({.verdict = atomic_dex::retry_verdict::retry});
+                    return;
+                }
+                done->set_value(static_cast<int>(attempt + 1));
+                report({.verdict = atomic_dex::retry_verdict::done});
+            };
+        }
+
+        atomic_dex::retry_scheduler::t_give_up
+        give_up() const
+        {
+            return [done = done](std::exception_ptr) { done->set_value(0); };
+        }
+    };
+
+    constexpr atomic_dex::retry_policy g_fast_policy{.max_attempts = 5, .base_delay = 10ms, .max_delay = 40ms, .jitter = 0.5};
+} // namespace
+
+TEST_CASE("retry_scheduler backoff grows exponentially within the jitter and the cap")
+{
+    atomic_dex::retry_scheduler scheduler;
+    const atomic_dex::retry_policy policy{.base_delay = 100ms, .max_delay = 1000ms, .jitter = 0.5};
+    for (int idx = 0; idx < 50; ++idx)
+    {
+        const auto first  = scheduler.backoff(policy, 1);
+        const auto third  = scheduler.backoff(policy, 3);
+        const auto capped = scheduler.backoff(policy, 20);
+        CHECK((first >= 50ms && first <= 100ms));
+        CHECK((third >= 200ms && third <= 400ms));
+        CHECK((capped >= 500ms && capped <= 1000ms));
+    }
+    CHECK_EQ(scheduler.backoff(atomic_dex::retry_policy{.base_delay = 100ms, .jitter = 0}, 2), 200ms);
+}
+
+TEST_CASE("retry_scheduler token buckets space out the requests of a host")
+{
+    atomic_dex::retry_scheduler scheduler;
+    scheduler.set_host_limits("api.example.com", {.capacity = 2, .refill_per_second = 10});
+    const auto now = atomic_dex::retry_scheduler::t_clock::now();
+
+    CHECK_EQ(scheduler.take_token("api.example.com", now), 0ms);
+    CHECK_EQ(scheduler.take_token("api.example.com", now), 0ms);
+    CHECK_EQ(scheduler.take_token("api.example.com", now), 100ms);
+    CHECK_EQ(scheduler.take_token("api.example.com", now), 200ms);
+    CHECK_EQ(scheduler.take_token("api.example.com", now + 1s), 0ms);
+    CHECK_EQ(scheduler.take_token("other.example.com", now), 0ms);
+    CHECK_EQ(scheduler.get_metrics().throttled, 2);
+}
+
+TEST_CASE("retry_scheduler retries on the wheel until the attempt succeeds")
+{
+    atomic_dex::retry_scheduler scheduler;
+    flaky_attempt               flaky{.nb_failures = 3};
+    auto                        result = flaky.done->get_future();
+
+    spdlog::stopwatch sw;
+    scheduler.run("api.example.com", flaky.attempt(), flaky.give_up(), g_fast_policy);
+    REQUIRE_EQ(result.wait_for(5s), std::future_status::ready);
+    CHECK_EQ(result.get(), 4);
+    CHECK_GE(sw.elapsed(), 5ms + 10ms + 20ms);
+
+    const auto metrics = scheduler.get_metrics();
+    CHECK_EQ(metrics.attempts, 4);
+    CHECK_EQ(metrics.retries, 3);
+    CHECK_EQ(metrics.succeeded, 1);
+    CHECK_EQ(metrics.gave_up, 0);
+}
+
+TEST_CASE("retry_scheduler gives up on the attempts limit and on the retry budget")
+{
+    SUBCASE("attempts limit")
+    {
+        atomic_dex::retry_scheduler scheduler;
+        flaky_attempt               flaky{.nb_failures = 100};
+        auto                        result = flaky.done->get_future();
+        scheduler.run("api.example.com", flaky.attempt(), flaky.give_up(), g_fast_policy);
+        REQUIRE_EQ(result.wait_for(5s), std::future_status::ready);
+        CHECK_EQ(result.get(), 0);
+        CHECK_EQ(scheduler.get_metrics().attempts, g_fast_policy.max_attempts);
+    }
+
+    SUBCASE("retry budget")
+    {
+        atomic_dex::retry_scheduler scheduler(atomic_dex::retry_scheduler_cfg{.budget = {.ratio = 0, .min_retries = 2}});
+        flaky_attempt               flaky{.nb_failures = 100};
+        auto                        result = flaky.done->get_future();
+        scheduler.run("api.example.com", flaky.attempt(), flaky.give_up(), g_fast_policy);
+        REQUIRE_EQ(result.wait_for(5s), std::future_status::ready);
+        CHECK_EQ(result.get(), 0);
+        const auto metrics = scheduler.get_metrics();
+        CHECK_EQ(metrics.attempts, 3);
+        CHECK_EQ(metrics.budget_exhausted, 1);
+    }
+}
+
+TEST_CASE("retry_scheduler wheel runs delayed tasks in deadline order, including past a full turn")
+{
+    atomic_dex::retry_scheduler scheduler(atomic_dex::retry_scheduler_cfg{.tick = 5ms, .nb_slots = 8});
+    std::mutex                  order_mutex;
+    std::vector<int>            order;
+    std::promise<void>          done;
+    auto                        finished = done.get_future();
+    const auto                  push     = [&](int value)
+    {
+        std::scoped_lock lock(order_mutex);
+        order.push_back(value);
+        if (order.size() == 3)
+        {
+            done.set_value();
+        }
+    };
+
+    spdlog::stopwatch sw;
+    scheduler.schedule_after(90ms, [&]() { push(3); });
+    scheduler.schedule_after(10ms, [&]() { push(1); });
+    scheduler.schedule_after(45ms, [&]() { push(2); });
+    REQUIRE_EQ(finished.wait_for(5s), std::future_status::ready);
+    CHECK_GE(sw.elapsed(), 85ms);
+    CHECK_EQ(order, std::vector<int>{1, 2, 3});
+    CHECK_EQ(scheduler.get_metrics().max_pending, 3);
+}
+
+TEST_CASE("retry_scheduler cancels the pending jobs on stop")
+{
+    atomic_dex::retry_scheduler      scheduler;
+    std::promise<std::exception_ptr> given_up;
+    auto                             reason = given_up.get_future();
+    scheduler.run(
+        "api.example.com", [](std::size_t, const atomic_dex::retry_scheduler::t_report& report) { report({.verdict = atomic_dex::retry_verdict::retry}); },
+        [&given_up](std::exception_ptr current) { given_up.set_value(current); }, atomic_dex::retry_policy{.base_delay = 10s, .max_delay = 10s, .jitter = 0});
+    scheduler.stop();
+    REQUIRE_EQ(reason.wait_for(1s), std::future_status::ready);
+    CHECK_THROWS_AS(std::rethrow_exception(reason.get()), atomic_dex::retry_scheduler_stopped);
+
+    //! Once stopped the drop callback runs right away instead of being scheduled.
+    bool dropped = false;
+    scheduler.schedule_after(1ms, []() {}, [&dropped]() { dropped = true; });
+    CHECK(dropped);
+    CHECK_EQ(scheduler.get_metrics().dropped, 2);
+}